@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBucketQueue_h
+#define itkBucketQueue_h
+
+#include "itkIntTypes.h"
+#include "itkMacro.h"
+#include "itkNumericTraits.h"
+#include "itkStaticAssert.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class BucketQueue
+ * \brief Priority queue of elements with small integer keys.
+ *
+ * The queue holds one bucket per key of the range given to SetKeyRange(),
+ * and the elements of a bucket are kept in first in, first out order:
+ * Front() is the oldest element with the smallest key. Pushing and
+ * popping an element take a constant time, plus the scan of the empty
+ * buckets above the key popped, which is bounded by the size of the key
+ * range when the keys pushed never decrease below the key popped, as in
+ * the flooding of an image. The buckets keep their memory when they are
+ * emptied, so a queue used for a whole image stops allocating once its
+ * buckets have grown.
+ *
+ * This is the hierarchical queue of the morphological algorithms. It is
+ * meant for keys of 8 or 16 bits, since the size of the key range sets
+ * the number of buckets; use IndexedDAryHeap for other keys.
+ *
+ * \tparam TElement The elements, copied into the queue.
+ * \tparam TKey An integer type.
+ *
+ * \sa IndexedDAryHeap
+ * \ingroup ITKCommon
+ */
+template< typename TElement, typename TKey >
+class BucketQueue
+{
+public:
+  typedef BucketQueue Self;
+  typedef TElement    ElementType;
+  typedef TKey        KeyType;
+
+  BucketQueue();
+
+  /** Set the range [minimum, maximum] of the keys and clear the queue. */
+  void SetKeyRange( KeyType minimum, KeyType maximum );
+
+  /** Remove all the elements. The memory is kept for reuse. */
+  void Clear();
+
+  bool Empty() const
+  {
+    return m_Size == 0;
+  }
+
+  SizeValueType Size() const
+  {
+    return m_Size;
+  }
+
+  /** Append the element to the bucket of the key, which must be in the key
+   * range. */
+  void Push( KeyType key, const ElementType & element )
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro( key >= m_Minimum && key <= m_Maximum );
+    const SizeValueType bucket = this->GetBucket( key );
+    m_Buckets[bucket].m_Elements.push_back( element );
+    if ( bucket < m_Current )
+      {
+      m_Current = bucket;
+      }
+    ++m_Size;
+  }
+
+  /** The oldest element with the smallest key, the queue must not be
+   * empty. */
+  const ElementType & Front() const
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro( !this->Empty() );
+    const BucketType & bucket = m_Buckets[m_Current];
+    return bucket.m_Elements[bucket.m_Head];
+  }
+
+  /** The smallest key in the queue, which must not be empty. */
+  KeyType FrontKey() const
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro( !this->Empty() );
+    return static_cast< KeyType >( static_cast< OffsetValueType >( m_Minimum )
+                                  + static_cast< OffsetValueType >( m_Current ) );
+  }
+
+  /** Remove the front element, the queue must not be empty. */
+  void Pop();
+
+private:
+  struct BucketType
+    {
+    BucketType() : m_Head( 0 ) {}
+
+    std::vector< ElementType > m_Elements;
+    SizeValueType              m_Head;
+    };
+
+  SizeValueType GetBucket( KeyType key ) const
+  {
+    return static_cast< SizeValueType >( static_cast< OffsetValueType >( key )
+                                         - static_cast< OffsetValueType >( m_Minimum ) );
+  }
+
+  std::vector< BucketType > m_Buckets;
+  KeyType                   m_Minimum;
+  KeyType                   m_Maximum;
+  SizeValueType             m_Current;
+  SizeValueType             m_Size;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBucketQueue.hxx"
+#endif
+
+#endif
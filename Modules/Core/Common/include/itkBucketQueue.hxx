@@ -0,0 +1,99 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBucketQueue_hxx
+#define itkBucketQueue_hxx
+
+#include "itkBucketQueue.h"
+
+namespace itk
+{
+template< typename TElement, typename TKey >
+BucketQueue< TElement, TKey >
+::BucketQueue() :
+  m_Minimum( NumericTraits< KeyType >::ZeroValue() ),
+  m_Maximum( NumericTraits< KeyType >::ZeroValue() ),
+  m_Current( 1 ),
+  m_Size( 0 )
+{
+  itkStaticAssert( NumericTraits< TKey >::IsInteger, "The keys of a bucket queue must be integers." );
+  m_Buckets.resize( 1 );
+}
+
+template< typename TElement, typename TKey >
+void
+BucketQueue< TElement, TKey >
+::SetKeyRange( KeyType minimum, KeyType maximum )
+{
+  if ( maximum < minimum )
+    {
+    itkGenericExceptionMacro( << "Invalid key range [" << static_cast< OffsetValueType >( minimum )
+                              << ", " << static_cast< OffsetValueType >( maximum ) << "]." );
+    }
+
+  this->Clear();
+  m_Minimum = minimum;
+  m_Maximum = maximum;
+  m_Buckets.resize( this->GetBucket( maximum ) + 1 );
+  m_Current = m_Buckets.size();
+}
+
+template< typename TElement, typename TKey >
+void
+BucketQueue< TElement, TKey >
+::Clear()
+{
+  for ( typename std::vector< BucketType >::iterator it = m_Buckets.begin(); it != m_Buckets.end(); ++it )
+    {
+    it->m_Elements.clear();
+    it->m_Head = 0;
+    }
+  m_Current = m_Buckets.size();
+  m_Size = 0;
+}
+
+template< typename TElement, typename TKey >
+void
+BucketQueue< TElement, TKey >
+::Pop()
+{
+  itkAssertInDebugAndIgnoreInReleaseMacro( !this->Empty() );
+
+  BucketType & bucket = m_Buckets[m_Current];
+  --m_Size;
+  if ( ++bucket.m_Head < bucket.m_Elements.size() )
+    {
+    return;
+    }
+
+  // the bucket is empty, find the next one
+  bucket.m_Elements.clear();
+  bucket.m_Head = 0;
+  if ( m_Size == 0 )
+    {
+    m_Current = m_Buckets.size();
+    return;
+    }
+  do
+    {
+    ++m_Current;
+    }
+  while ( m_Buckets[m_Current].m_Elements.empty() );
+}
+} // end namespace itk
+
+#endif
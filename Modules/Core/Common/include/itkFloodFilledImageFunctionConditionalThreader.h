@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFloodFilledImageFunctionConditionalThreader_h
+#define itkFloodFilledImageFunctionConditionalThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+#include "itkProcessObject.h"
+#include "itkProgressReporter.h"
+#include "itkImage.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class FloodFilledImageFunctionConditionalThreader
+ * \brief Threaded flood fill of the pixels where an image function is true.
+ *
+ * Fill() sets the pixels of an image which are connected to the seeds
+ * through pixels where the function is true: the pixels visited by
+ * FloodFilledImageFunctionConditionalIterator, or by
+ * ShapedFloodFilledImageFunctionConditionalIterator when FullyConnected is
+ * on. It can replace the iterators in the filters which only set the
+ * visited pixels.
+ *
+ * The pixels are filled breadth first, a front of pixels at a time. The
+ * neighbors of a front are examined in parallel once the front is large
+ * enough; smaller fronts are examined by the calling thread. A neighbor
+ * reached by two threads at once may be evaluated and filled twice, but
+ * it gets the same status both times, so the filled pixels do not depend
+ * on the number of threads, and it is kept once in the next front. The
+ * function must be safe to evaluate from several threads, as the image
+ * functions are.
+ *
+ * GetNumberOfFilledPixels() and GetFilledRegion() give the number and
+ * the bounding region of the filled pixels, so that they can be found
+ * again without scanning the whole image.
+ *
+ * When IncludeSeeds is on, the seeds are filled whether the function is
+ * true at them or not, as by the iterators used without GoToBegin().
+ *
+ * \sa FloodFilledImageFunctionConditionalIterator
+ * \sa ShapedFloodFilledImageFunctionConditionalIterator
+ * \ingroup ITKCommon
+ */
+template< typename TImage, typename TFunction >
+class FloodFilledImageFunctionConditionalThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, ProcessObject >
+{
+public:
+  /** Standard class typedefs. */
+  typedef FloodFilledImageFunctionConditionalThreader                          Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, ProcessObject > Superclass;
+  typedef SmartPointer< Self >                                                 Pointer;
+  typedef SmartPointer< const Self >                                           ConstPointer;
+
+  itkTypeMacro( FloodFilledImageFunctionConditionalThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType DomainType;
+  typedef DomainType                      IndexRangeType;
+
+  typedef TImage                          ImageType;
+  typedef typename ImageType::PixelType   PixelType;
+  typedef typename ImageType::IndexType   IndexType;
+  typedef typename ImageType::OffsetType  OffsetType;
+  typedef typename ImageType::RegionType  RegionType;
+  typedef TFunction                       FunctionType;
+  typedef std::vector< IndexType >        SeedContainerType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, ImageType::ImageDimension);
+
+  /** Whether the pixels are connected to their 3^n-1 neighbors, or only
+   * to the 2*n neighbors which share a face with them. */
+  itkSetMacro(FullyConnected, bool);
+  itkGetConstReferenceMacro(FullyConnected, bool);
+  itkBooleanMacro(FullyConnected);
+
+  /** Whether the seeds are filled without evaluating the function at
+   * them. */
+  itkSetMacro(IncludeSeeds, bool);
+  itkGetConstReferenceMacro(IncludeSeeds, bool);
+  itkBooleanMacro(IncludeSeeds);
+
+  /** Set to \c value the pixels of the buffered region of \c image reached
+   * from \c seeds through the pixels where \c function is true, with the
+   * threads of \c filter, or the default number of threads if it is null.
+   * A pixel is completed in \c progress, if any, for each filled pixel. */
+  void Fill( ProcessObject * filter,
+             ImageType * image,
+             const FunctionType * function,
+             const SeedContainerType & seeds,
+             const PixelType & value,
+             ProgressReporter * progress = ITK_NULLPTR );
+
+  /** The number of pixels filled by the last call to Fill(). */
+  itkGetConstMacro(NumberOfFilledPixels, SizeValueType);
+
+  /** The smallest region containing the pixels filled by the last call to
+   * Fill(). Its size is zero if no pixel was filled. */
+  itkGetConstReferenceMacro(FilledRegion, RegionType);
+
+protected:
+  FloodFilledImageFunctionConditionalThreader();
+  virtual ~FloodFilledImageFunctionConditionalThreader() {}
+
+  /** Clear the next fronts of the threads. */
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  /** Examine the neighbors of a range of the front. */
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  virtual void PrintSelf( std::ostream & os, Indent indent ) const ITK_OVERRIDE;
+
+private:
+  FloodFilledImageFunctionConditionalThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  typedef Image< unsigned char, ImageDimension > StatusImageType;
+  typedef std::vector< IndexType >               FrontType;
+
+  /** Status of the pixels, as in the temporary image of the iterators.
+   * Merged marks the inside pixels already moved from the next fronts of
+   * the threads to the front. */
+  enum { Unvisited = 0, Outside = 1, Inside = 2, Merged = 3 };
+
+  /** The smallest number of pixels of the front examined by each thread. */
+  enum { MinimumPixelsPerThread = 1 << 10 };
+
+  /** Examine the neighbors of the pixels of the front from \c begin to
+   * \c end, and append the filled ones to \c next. */
+  void ExamineRange( SizeValueType begin, SizeValueType end, FrontType & next );
+
+  /** Set the status of the pixel at \c index, and fill it if it is
+   * inside. */
+  void Visit( const IndexType & index, OffsetValueType offset, bool inside, FrontType & next );
+
+  bool m_FullyConnected;
+  bool m_IncludeSeeds;
+
+  ImageType *                       m_Image;
+  const FunctionType *              m_Function;
+  PixelType                         m_Value;
+  RegionType                        m_Region;
+  SizeValueType                     m_NumberOfFilledPixels;
+  RegionType                        m_FilledRegion;
+  typename StatusImageType::Pointer m_StatusImage;
+  unsigned char *                   m_Status;
+  std::vector< OffsetType >         m_NeighborIndexOffsets;
+  std::vector< OffsetValueType >    m_NeighborOffsets;
+
+  FrontType                m_Front;
+  std::vector< FrontType > m_NextFronts;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFloodFilledImageFunctionConditionalThreader.hxx"
+#endif
+
+#endif
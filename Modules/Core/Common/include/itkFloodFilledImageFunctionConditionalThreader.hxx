@@ -0,0 +1,273 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFloodFilledImageFunctionConditionalThreader_hxx
+#define itkFloodFilledImageFunctionConditionalThreader_hxx
+
+#include "itkFloodFilledImageFunctionConditionalThreader.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template< typename TImage, typename TFunction >
+FloodFilledImageFunctionConditionalThreader< TImage, TFunction >
+::FloodFilledImageFunctionConditionalThreader() :
+  m_FullyConnected( false ),
+  m_IncludeSeeds( false ),
+  m_Image( ITK_NULLPTR ),
+  m_Function( ITK_NULLPTR ),
+  m_Value( NumericTraits< PixelType >::ZeroValue() ),
+  m_NumberOfFilledPixels( 0 ),
+  m_Status( ITK_NULLPTR )
+{
+}
+
+template< typename TImage, typename TFunction >
+void
+FloodFilledImageFunctionConditionalThreader< TImage, TFunction >
+::Fill( ProcessObject * filter,
+        ImageType * image,
+        const FunctionType * function,
+        const SeedContainerType & seeds,
+        const PixelType & value,
+        ProgressReporter * progress )
+{
+  m_Image = image;
+  m_Function = function;
+  m_Value = value;
+  m_Region = image->GetBufferedRegion();
+
+  // the status of the pixels, kept between the calls
+  if ( m_StatusImage.IsNull() || m_StatusImage->GetBufferedRegion() != m_Region )
+    {
+    m_StatusImage = StatusImageType::New();
+    m_StatusImage->SetRegions( m_Region );
+    m_StatusImage->Allocate();
+    }
+  m_StatusImage->FillBuffer( Unvisited );
+  m_Status = m_StatusImage->GetBufferPointer();
+
+  // the offsets of the neighbors, in the order of a raster scan
+  m_NeighborIndexOffsets.clear();
+  m_NeighborOffsets.clear();
+  const OffsetValueType *offsetTable = m_StatusImage->GetOffsetTable();
+  OffsetType neighbor;
+  neighbor.Fill( -1 );
+  for ( ;; )
+    {
+    unsigned int nonZero = 0;
+    OffsetValueType offset = 0;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      nonZero += ( neighbor[d] != 0 );
+      offset += neighbor[d] * offsetTable[d];
+      }
+    if ( nonZero == 1 || ( m_FullyConnected && nonZero > 1 ) )
+      {
+      m_NeighborIndexOffsets.push_back( neighbor );
+      m_NeighborOffsets.push_back( offset );
+      }
+    unsigned int d = 0;
+    while ( d < ImageDimension && neighbor[d] == 1 )
+      {
+      neighbor[d++] = -1;
+      }
+    if ( d == ImageDimension )
+      {
+      break;
+      }
+    ++neighbor[d];
+    }
+
+  const ThreadIdType maximumNumberOfThreads = filter ? filter->GetNumberOfThreads()
+                                                    : MultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  // the seeds are the first front
+  m_Front.clear();
+  for ( typename SeedContainerType::const_iterator it = seeds.begin(); it != seeds.end(); ++it )
+    {
+    if ( m_Region.IsInside( *it ) )
+      {
+      const OffsetValueType offset = m_StatusImage->ComputeOffset( *it );
+      if ( m_Status[offset] == Unvisited )
+        {
+        this->Visit( *it, offset, m_IncludeSeeds || m_Function->EvaluateAtIndex( *it ), m_Front );
+        }
+      }
+    }
+
+  // the bounds of the filled pixels, each of which is in one front
+  IndexType filledMinimum = m_Region.GetUpperIndex();
+  IndexType filledMaximum = m_Region.GetIndex();
+  m_NumberOfFilledPixels = 0;
+
+  FrontType next;
+  while ( !m_Front.empty() )
+    {
+    m_NumberOfFilledPixels += m_Front.size();
+    for ( SizeValueType i = 0; i < m_Front.size(); ++i )
+      {
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        filledMinimum[d] = std::min( filledMinimum[d], m_Front[i][d] );
+        filledMaximum[d] = std::max( filledMaximum[d], m_Front[i][d] );
+        }
+      if ( progress )
+        {
+        progress->CompletedPixel();
+        }
+      }
+
+    const SizeValueType frontSize = m_Front.size();
+    const ThreadIdType  numberOfThreads = static_cast< ThreadIdType >(
+      std::min< SizeValueType >( maximumNumberOfThreads, frontSize / MinimumPixelsPerThread ) );
+    if ( numberOfThreads > 1 )
+      {
+      this->SetMaximumNumberOfThreads( numberOfThreads );
+      IndexRangeType range;
+      range[0] = 0;
+      range[1] = frontSize - 1;
+      this->Execute( filter, range );
+
+      // a pixel reached by several threads is in several next fronts,
+      // only its first copy is kept
+      m_Front.clear();
+      for ( ThreadIdType i = 0; i < m_NextFronts.size(); ++i )
+        {
+        const FrontType & threadNext = m_NextFronts[i];
+        for ( SizeValueType j = 0; j < threadNext.size(); ++j )
+          {
+          unsigned char & status = m_Status[m_StatusImage->ComputeOffset( threadNext[j] )];
+          if ( status == Inside )
+            {
+            status = Merged;
+            m_Front.push_back( threadNext[j] );
+            }
+          }
+        }
+      }
+    else
+      {
+      next.clear();
+      this->ExamineRange( 0, frontSize, next );
+      m_Front.swap( next );
+      }
+    }
+
+  if ( m_NumberOfFilledPixels > 0 )
+    {
+    m_FilledRegion.SetIndex( filledMinimum );
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      m_FilledRegion.SetSize( d, static_cast< SizeValueType >( filledMaximum[d] - filledMinimum[d] + 1 ) );
+      }
+    }
+  else
+    {
+    typename RegionType::SizeType zeroSize;
+    zeroSize.Fill( 0 );
+    m_FilledRegion.SetIndex( m_Region.GetIndex() );
+    m_FilledRegion.SetSize( zeroSize );
+    }
+
+  FrontType().swap( m_Front );
+  m_NextFronts.clear();
+  m_Image = ITK_NULLPTR;
+  m_Function = ITK_NULLPTR;
+  m_Status = ITK_NULLPTR;
+}
+
+template< typename TImage, typename TFunction >
+void
+FloodFilledImageFunctionConditionalThreader< TImage, TFunction >
+::BeforeThreadedExecution()
+{
+  m_NextFronts.resize( this->GetNumberOfThreadsUsed() );
+  for ( ThreadIdType i = 0; i < m_NextFronts.size(); ++i )
+    {
+    m_NextFronts[i].clear();
+    }
+}
+
+template< typename TImage, typename TFunction >
+void
+FloodFilledImageFunctionConditionalThreader< TImage, TFunction >
+::ThreadedExecution( const IndexRangeType & subrange, const ThreadIdType threadId )
+{
+  this->ExamineRange( subrange[0], subrange[1] + 1, m_NextFronts[threadId] );
+}
+
+template< typename TImage, typename TFunction >
+void
+FloodFilledImageFunctionConditionalThreader< TImage, TFunction >
+::ExamineRange( SizeValueType begin, SizeValueType end, FrontType & next )
+{
+  const SizeValueType numberOfNeighbors = m_NeighborOffsets.size();
+  for ( SizeValueType i = begin; i < end; ++i )
+    {
+    const IndexType &     index = m_Front[i];
+    const OffsetValueType offset = m_StatusImage->ComputeOffset( index );
+    for ( SizeValueType k = 0; k < numberOfNeighbors; ++k )
+      {
+      const IndexType neighbor = index + m_NeighborIndexOffsets[k];
+      if ( m_Region.IsInside( neighbor ) )
+        {
+        const OffsetValueType neighborOffset = offset + m_NeighborOffsets[k];
+        if ( m_Status[neighborOffset] == Unvisited )
+          {
+          this->Visit( neighbor, neighborOffset, m_Function->EvaluateAtIndex( neighbor ), next );
+          }
+        }
+      }
+    }
+}
+
+template< typename TImage, typename TFunction >
+void
+FloodFilledImageFunctionConditionalThreader< TImage, TFunction >
+::Visit( const IndexType & index, OffsetValueType offset, bool inside, FrontType & next )
+{
+  if ( inside )
+    {
+    m_Status[offset] = Inside;
+    m_Image->SetPixel( index, m_Value );
+    next.push_back( index );
+    }
+  else
+    {
+    m_Status[offset] = Outside;
+    }
+}
+
+template< typename TImage, typename TFunction >
+void
+FloodFilledImageFunctionConditionalThreader< TImage, TFunction >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "FullyConnected: " << m_FullyConnected << std::endl;
+  os << indent << "IncludeSeeds: " << m_IncludeSeeds << std::endl;
+  os << indent << "NumberOfFilledPixels: " << m_NumberOfFilledPixels << std::endl;
+  os << indent << "FilledRegion: " << m_FilledRegion << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,214 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkIndexedDAryHeap_h
+#define itkIndexedDAryHeap_h
+
+#include "itkIntTypes.h"
+#include "itkMacro.h"
+#include "itkNumericTraits.h"
+#include "itkStaticAssert.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace itk
+{
+/** \class IndexedDAryHeap
+ * \brief Priority queue of identified elements with decrease-key.
+ *
+ * Each element of the heap is associated with an identifier, an integer
+ * such as the offset of a pixel or the identifier of a mesh point. An
+ * identifier is in the heap at most once: pushing an element with an
+ * identifier already in the heap replaces the element and restores the
+ * heap order, which implements decrease-key (and increase-key) without
+ * the stale duplicates left by std::priority_queue. An element can also
+ * be removed from the heap before it reaches the top.
+ *
+ * The heap is stored in a single array with VArity children per node.
+ * The default arity of 4 halves the depth of the heap, and the children
+ * of a node share a cache line, which makes the heap faster than a binary
+ * heap when elements are mostly pushed and popped. The position of each
+ * element in the array is found from its identifier with an open
+ * addressing hash table. The table grows with the number of elements in
+ * the heap, not with the range of the identifiers: a heap of pixels keyed
+ * by their offsets uses memory in proportion to the front it holds, not
+ * to the image.
+ *
+ * The element at the top is the smallest for TCompare: with the default
+ * std::less, the heap is a min-heap, unlike std::priority_queue.
+ *
+ * \tparam TElement The elements, copied into the heap.
+ * \tparam TCompare Strict weak ordering of the elements.
+ * \tparam VArity Number of children of each node, at least 2.
+ * \tparam TElementIdentifier Unsigned integer type of the identifiers.
+ *
+ * \sa PriorityQueueContainer
+ * \sa BucketQueue
+ * \ingroup ITKCommon
+ */
+template< typename TElement,
+          typename TCompare = std::less< TElement >,
+          unsigned int VArity = 4,
+          typename TElementIdentifier = IdentifierType >
+class IndexedDAryHeap
+{
+public:
+  typedef IndexedDAryHeap    Self;
+  typedef TElement           ElementType;
+  typedef TCompare           CompareType;
+  typedef TElementIdentifier ElementIdentifierType;
+
+  itkStaticConstMacro(Arity, unsigned int, VArity);
+
+  IndexedDAryHeap();
+  explicit IndexedDAryHeap( const CompareType & compare );
+
+  /** Allocate the memory for \c numberOfElements elements in the heap. */
+  void Reserve( SizeValueType numberOfElements );
+
+  /** Remove all the elements. The memory is kept for reuse. */
+  void Clear();
+
+  /** Exchange the contents of two heaps. Swapping with an empty heap
+   * releases the memory. */
+  void Swap( Self & other )
+  {
+    m_Heap.swap( other.m_Heap );
+    m_Entries.swap( other.m_Entries );
+    std::swap( m_Shift, other.m_Shift );
+    std::swap( m_Compare, other.m_Compare );
+  }
+
+  bool Empty() const
+  {
+    return m_Heap.empty();
+  }
+
+  SizeValueType Size() const
+  {
+    return static_cast< SizeValueType >( m_Heap.size() );
+  }
+
+  /** Whether an element with this identifier is in the heap. */
+  bool Contains( ElementIdentifierType identifier ) const
+  {
+    return !m_Entries.empty() && m_Entries[this->FindEntry( identifier )].m_Identifier != NotInHeap;
+  }
+
+  /** The element with this identifier, which must be in the heap. */
+  const ElementType & Get( ElementIdentifierType identifier ) const
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro( this->Contains( identifier ) );
+    return m_Heap[m_Entries[this->FindEntry( identifier )].m_Position].m_Element;
+  }
+
+  /** Insert the element with this identifier, or replace the element with
+   * this identifier if it is already in the heap. */
+  void Push( ElementIdentifierType identifier, const ElementType & element );
+
+  /** The smallest element, the heap must not be empty. */
+  const ElementType & Top() const
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro( !this->Empty() );
+    return m_Heap.front().m_Element;
+  }
+
+  /** The identifier of the smallest element, the heap must not be empty. */
+  ElementIdentifierType TopIdentifier() const
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro( !this->Empty() );
+    return m_Heap.front().m_Identifier;
+  }
+
+  /** Remove the smallest element, the heap must not be empty. */
+  void Pop();
+
+  /** Remove the element with this identifier.
+   * \return true if the element was in the heap
+   * \return false else */
+  bool Remove( ElementIdentifierType identifier );
+
+private:
+  struct NodeType
+    {
+    ElementIdentifierType m_Identifier;
+    ElementType           m_Element;
+    };
+
+  /** Entry of the hash table: the position of an identifier in m_Heap. */
+  struct EntryType
+    {
+    ElementIdentifierType m_Identifier;
+    ElementIdentifierType m_Position;
+    };
+
+  /** Identifier of the empty entries. */
+  static const ElementIdentifierType NotInHeap;
+
+  /** Move the node up from \c position, then store it there. */
+  void SiftUp( ElementIdentifierType position, const NodeType & node );
+
+  /** Move the node down from \c position, then store it there. */
+  void SiftDown( ElementIdentifierType position, const NodeType & node );
+
+  void Store( ElementIdentifierType position, const NodeType & node )
+  {
+    m_Heap[position] = node;
+    m_Entries[this->FindEntry( node.m_Identifier )].m_Position = position;
+  }
+
+  /** Fibonacci hashing of the identifier to the first entry to probe. */
+  SizeValueType Hash( ElementIdentifierType identifier ) const
+  {
+    const uint64_t multiplier = ( static_cast< uint64_t >( 0x9E3779B9u ) << 32 ) | 0x7F4A7C15u;
+    return static_cast< SizeValueType >( ( static_cast< uint64_t >( identifier ) * multiplier ) >> m_Shift );
+  }
+
+  /** Index of the entry of the identifier, or of the empty entry where it
+   * would be inserted. The table must not be empty. */
+  SizeValueType FindEntry( ElementIdentifierType identifier ) const
+  {
+    const SizeValueType mask = m_Entries.size() - 1;
+    SizeValueType       entry = this->Hash( identifier );
+    while ( m_Entries[entry].m_Identifier != identifier && m_Entries[entry].m_Identifier != NotInHeap )
+      {
+      entry = ( entry + 1 ) & mask;
+      }
+    return entry;
+  }
+
+  /** Empty the entry, moving back the entries probed after it. */
+  void EraseEntry( SizeValueType entry );
+
+  /** Grow the table so that it holds \c numberOfElements with a load
+   * factor of at most one half. */
+  void ReserveEntries( SizeValueType numberOfElements );
+
+  std::vector< NodeType >  m_Heap;
+  std::vector< EntryType > m_Entries;
+  unsigned int             m_Shift;
+  CompareType              m_Compare;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkIndexedDAryHeap.hxx"
+#endif
+
+#endif
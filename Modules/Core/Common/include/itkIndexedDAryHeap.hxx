@@ -0,0 +1,264 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkIndexedDAryHeap_hxx
+#define itkIndexedDAryHeap_hxx
+
+#include "itkIndexedDAryHeap.h"
+
+namespace itk
+{
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+const typename IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >::ElementIdentifierType
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >::NotInHeap =
+  NumericTraits< TElementIdentifier >::max();
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::IndexedDAryHeap() :
+  m_Shift( 64 ),
+  m_Compare()
+{
+  itkStaticAssert( VArity >= 2, "The arity of the heap must be at least 2." );
+}
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::IndexedDAryHeap( const CompareType & compare ) :
+  m_Shift( 64 ),
+  m_Compare( compare )
+{
+  itkStaticAssert( VArity >= 2, "The arity of the heap must be at least 2." );
+}
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+void
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::Reserve( SizeValueType numberOfElements )
+{
+  m_Heap.reserve( numberOfElements );
+  this->ReserveEntries( numberOfElements );
+}
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+void
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::ReserveEntries( SizeValueType numberOfElements )
+{
+  if ( 2 * numberOfElements <= m_Entries.size() )
+    {
+    return;
+    }
+
+  SizeValueType size = 16;
+  unsigned int  shift = 60;
+  while ( size < 2 * numberOfElements )
+    {
+    size *= 2;
+    --shift;
+    }
+  std::vector< EntryType > entries( size );
+  for ( typename std::vector< EntryType >::iterator it = entries.begin(); it != entries.end(); ++it )
+    {
+    it->m_Identifier = NotInHeap;
+    }
+  entries.swap( m_Entries );
+  m_Shift = shift;
+
+  // the positions are those of the heap, only the entries move
+  for ( typename std::vector< EntryType >::const_iterator it = entries.begin(); it != entries.end(); ++it )
+    {
+    if ( it->m_Identifier != NotInHeap )
+      {
+      m_Entries[this->FindEntry( it->m_Identifier )] = *it;
+      }
+    }
+}
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+void
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::EraseEntry( SizeValueType entry )
+{
+  // Backward shift deletion: an entry probed after the hole moves into it
+  // when the hole lies between the entry's first probe and the entry.
+  const SizeValueType mask = m_Entries.size() - 1;
+  SizeValueType       hole = entry;
+  for ( SizeValueType next = ( hole + 1 ) & mask;
+        m_Entries[next].m_Identifier != NotInHeap;
+        next = ( next + 1 ) & mask )
+    {
+    const SizeValueType first = this->Hash( m_Entries[next].m_Identifier );
+    if ( ( ( next - first ) & mask ) >= ( ( next - hole ) & mask ) )
+      {
+      m_Entries[hole] = m_Entries[next];
+      hole = next;
+      }
+    }
+  m_Entries[hole].m_Identifier = NotInHeap;
+}
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+void
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::Clear()
+{
+  for ( typename std::vector< EntryType >::iterator it = m_Entries.begin(); it != m_Entries.end(); ++it )
+    {
+    it->m_Identifier = NotInHeap;
+    }
+  m_Heap.clear();
+}
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+void
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::Push( ElementIdentifierType identifier, const ElementType & element )
+{
+  itkAssertInDebugAndIgnoreInReleaseMacro( identifier != NotInHeap );
+
+  NodeType node;
+  node.m_Identifier = identifier;
+  node.m_Element = element;
+
+  this->ReserveEntries( m_Heap.size() + 1 );
+
+  EntryType & entry = m_Entries[this->FindEntry( identifier )];
+  if ( entry.m_Identifier == NotInHeap )
+    {
+    entry.m_Identifier = identifier;
+    m_Heap.push_back( node );
+    this->SiftUp( static_cast< ElementIdentifierType >( m_Heap.size() - 1 ), node );
+    }
+  else if ( m_Compare( element, m_Heap[entry.m_Position].m_Element ) )
+    {
+    this->SiftUp( entry.m_Position, node );
+    }
+  else
+    {
+    this->SiftDown( entry.m_Position, node );
+    }
+}
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+void
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::Pop()
+{
+  itkAssertInDebugAndIgnoreInReleaseMacro( !this->Empty() );
+
+  this->EraseEntry( this->FindEntry( m_Heap.front().m_Identifier ) );
+
+  const NodeType last = m_Heap.back();
+  m_Heap.pop_back();
+  if ( !m_Heap.empty() )
+    {
+    this->SiftDown( 0, last );
+    }
+}
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+bool
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::Remove( ElementIdentifierType identifier )
+{
+  if ( m_Entries.empty() )
+    {
+    return false;
+    }
+  const SizeValueType entry = this->FindEntry( identifier );
+  if ( m_Entries[entry].m_Identifier == NotInHeap )
+    {
+    return false;
+    }
+
+  const ElementIdentifierType position = m_Entries[entry].m_Position;
+  this->EraseEntry( entry );
+
+  const NodeType last = m_Heap.back();
+  m_Heap.pop_back();
+  if ( position < m_Heap.size() )
+    {
+    // the last node takes the place of the removed one
+    if ( m_Compare( last.m_Element, m_Heap[position].m_Element ) )
+      {
+      this->SiftUp( position, last );
+      }
+    else
+      {
+      this->SiftDown( position, last );
+      }
+    }
+  return true;
+}
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+void
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::SiftUp( ElementIdentifierType position, const NodeType & node )
+{
+  while ( position > 0 )
+    {
+    const ElementIdentifierType parent = ( position - 1 ) / VArity;
+    if ( !m_Compare( node.m_Element, m_Heap[parent].m_Element ) )
+      {
+      break;
+      }
+    this->Store( position, m_Heap[parent] );
+    position = parent;
+    }
+  this->Store( position, node );
+}
+
+template< typename TElement, typename TCompare, unsigned int VArity, typename TElementIdentifier >
+void
+IndexedDAryHeap< TElement, TCompare, VArity, TElementIdentifier >
+::SiftDown( ElementIdentifierType position, const NodeType & node )
+{
+  const ElementIdentifierType size = static_cast< ElementIdentifierType >( m_Heap.size() );
+
+  for (;; )
+    {
+    const ElementIdentifierType first = position * VArity + 1;
+    if ( first >= size )
+      {
+      break;
+      }
+
+    // the smallest child
+    const ElementIdentifierType last = std::min( first + VArity, size );
+    ElementIdentifierType       child = first;
+    for ( ElementIdentifierType c = first + 1; c < last; ++c )
+      {
+      if ( m_Compare( m_Heap[c].m_Element, m_Heap[child].m_Element ) )
+        {
+        child = c;
+        }
+      }
+
+    if ( !m_Compare( m_Heap[child].m_Element, node.m_Element ) )
+      {
+      break;
+      }
+    this->Store( position, m_Heap[child] );
+    position = child;
+    }
+  this->Store( position, node );
+}
+} // end namespace itk
+
+#endif
@@ -169,7 +169,7 @@ PeriodicBoundaryCondition< TInputImage, TOutputImage >
     else
       {
       // Remap the requested portion in this dimension into the image region.
-      inputRequestedIndex[i] = lowIndex;
+      inputRequestedIndex[i] = imageIndex[i] + lowIndex;
       inputRequestedSize[i]  = outputSize[i];
       }
     }
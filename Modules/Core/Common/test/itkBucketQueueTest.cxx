@@ -0,0 +1,157 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBucketQueue.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <iostream>
+#include <map>
+#include <queue>
+
+namespace
+{
+
+// Flood-like use of the queue: the keys pushed are never below the key
+// popped, and the elements with the same key come out in order.
+template< typename TKey >
+bool
+TestFlooding( TKey minimum, TKey maximum )
+{
+  typedef itk::BucketQueue< unsigned int, TKey >       QueueType;
+  typedef std::map< TKey, std::queue< unsigned int > > ReferenceType;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 7 );
+
+  const unsigned int range = static_cast< unsigned int >( maximum - minimum );
+
+  QueueType queue;
+  queue.SetKeyRange( minimum, maximum );
+  ReferenceType reference;
+
+  unsigned int element = 0;
+  for ( unsigned int i = 0; i < 100; ++i )
+    {
+    const TKey key = static_cast< TKey >( minimum + static_cast< TKey >( generator->GetIntegerVariate( range ) ) );
+    queue.Push( key, element );
+    reference[key].push( element++ );
+    }
+
+  while ( !queue.Empty() )
+    {
+    const TKey         key = reference.begin()->first;
+    const unsigned int expected = reference.begin()->second.front();
+    if ( queue.FrontKey() != key || queue.Front() != expected )
+      {
+      std::cerr << "Front() is " << queue.Front() << " instead of " << expected << std::endl;
+      return false;
+      }
+    queue.Pop();
+    reference.begin()->second.pop();
+    if ( reference.begin()->second.empty() )
+      {
+      reference.erase( reference.begin() );
+      }
+
+    // push a few elements at or above the current key
+    if ( element < 5000 )
+      {
+      const unsigned int numberOfPushes = generator->GetIntegerVariate( 2 );
+      for ( unsigned int p = 0; p < numberOfPushes; ++p )
+        {
+        const TKey pushed = static_cast< TKey >(
+          key + static_cast< TKey >( generator->GetIntegerVariate( static_cast< unsigned int >( maximum - key ) ) ) );
+        queue.Push( pushed, element );
+        reference[pushed].push( element++ );
+        }
+      }
+
+    itk::SizeValueType size = 0;
+    for ( typename ReferenceType::const_iterator it = reference.begin(); it != reference.end(); ++it )
+      {
+      size += it->second.size();
+      }
+    if ( queue.Size() != size )
+      {
+      std::cerr << "The queue has " << queue.Size() << " elements instead of " << size << std::endl;
+      return false;
+      }
+    }
+  return reference.empty();
+}
+
+}
+
+int itkBucketQueueTest( int, char * [] )
+{
+  bool passed = true;
+
+  passed &= TestFlooding< unsigned char >( 0, 255 );
+  passed &= TestFlooding< short >( -300, 1000 );
+  passed &= TestFlooding< int >( 10, 12 );
+
+  // a push below the front key
+  itk::BucketQueue< int, unsigned char > queue;
+  queue.SetKeyRange( 10, 20 );
+  queue.Push( 15, 1 );
+  queue.Push( 12, 2 );
+  queue.Push( 15, 3 );
+  if ( queue.FrontKey() != 12 || queue.Front() != 2 )
+    {
+    std::cerr << "A push below the front key failed." << std::endl;
+    passed = false;
+    }
+  queue.Pop();
+  queue.Push( 11, 4 );
+  if ( queue.FrontKey() != 11 || queue.Front() != 4 || queue.Size() != 3 )
+    {
+    std::cerr << "A push below the front key failed." << std::endl;
+    passed = false;
+    }
+  queue.Clear();
+  if ( !queue.Empty() )
+    {
+    std::cerr << "Clear() failed." << std::endl;
+    passed = false;
+    }
+
+  bool caught = false;
+  try
+    {
+    queue.SetKeyRange( 20, 10 );
+    }
+  catch ( itk::ExceptionObject & excp )
+    {
+    std::cout << "Caught expected exception: " << excp.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "An invalid key range was accepted." << std::endl;
+    passed = false;
+    }
+
+  if ( !passed )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
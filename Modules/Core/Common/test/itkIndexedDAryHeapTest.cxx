@@ -0,0 +1,165 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkIndexedDAryHeap.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <iostream>
+#include <map>
+
+namespace
+{
+
+// Push, update, remove and pop random elements, and check the heap
+// against the smallest element of a map. The identifiers are multiples of
+// identifierStride.
+template< unsigned int VArity >
+bool
+TestRandomOperations( itk::IdentifierType identifierStride )
+{
+  typedef itk::IndexedDAryHeap< double, std::less< double >, VArity > HeapType;
+  typedef std::map< typename HeapType::ElementIdentifierType, double > ReferenceType;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 42 );
+
+  HeapType      heap;
+  ReferenceType reference;
+
+  const itk::IdentifierType numberOfIdentifiers = 200;
+  for ( unsigned int i = 0; i < 20000; ++i )
+    {
+    const itk::IdentifierType identifier = generator->GetIntegerVariate( numberOfIdentifiers - 1 ) * identifierStride;
+    const double              value = generator->GetUniformVariate( -1.0, 1.0 );
+    switch ( generator->GetIntegerVariate( 3 ) )
+      {
+      case 0:
+      case 1:
+        heap.Push( identifier, value );
+        reference[identifier] = value;
+        break;
+      case 2:
+        if ( heap.Remove( identifier ) != ( reference.erase( identifier ) == 1 ) )
+          {
+          std::cerr << "Remove( " << identifier << " ) returned a wrong value." << std::endl;
+          return false;
+          }
+        break;
+      default:
+        if ( !heap.Empty() )
+          {
+          typename ReferenceType::iterator smallest = reference.begin();
+          for ( typename ReferenceType::iterator it = reference.begin(); it != reference.end(); ++it )
+            {
+            if ( it->second < smallest->second )
+              {
+              smallest = it;
+              }
+            }
+          if ( heap.Top() != smallest->second || heap.Get( heap.TopIdentifier() ) != smallest->second )
+            {
+            std::cerr << "Top() is " << heap.Top() << " instead of " << smallest->second << std::endl;
+            return false;
+            }
+          reference.erase( heap.TopIdentifier() );
+          heap.Pop();
+          }
+      }
+
+    if ( heap.Size() != reference.size() || heap.Contains( identifier ) != ( reference.count( identifier ) == 1 ) )
+      {
+      std::cerr << "The heap has " << heap.Size() << " elements instead of " << reference.size() << std::endl;
+      return false;
+      }
+    }
+
+  // the remaining elements come out in order
+  double previous = -2.0;
+  while ( !heap.Empty() )
+    {
+    if ( heap.Top() < previous )
+      {
+      std::cerr << "The elements are not popped in order." << std::endl;
+      return false;
+      }
+    previous = heap.Top();
+    heap.Pop();
+    }
+  return true;
+}
+
+}
+
+int itkIndexedDAryHeapTest( int, char * [] )
+{
+  bool passed = true;
+
+  passed &= TestRandomOperations< 2 >( 1 );
+  passed &= TestRandomOperations< 4 >( 1 );
+  passed &= TestRandomOperations< 7 >( 1 );
+  // identifiers spread over a range much larger than the heap
+  passed &= TestRandomOperations< 4 >( 1000003 );
+
+  // a max-heap with the identifiers of a bounded set
+  typedef itk::IndexedDAryHeap< int, std::greater< int > > MaxHeapType;
+  MaxHeapType heap;
+  heap.Reserve( 10 );
+  for ( int i = 0; i < 10; ++i )
+    {
+    heap.Push( i, i );
+    }
+  heap.Push( 3, 20 );
+  heap.Push( 9, -1 );
+  if ( heap.TopIdentifier() != 3 || heap.Top() != 20 )
+    {
+    std::cerr << "Increasing a key failed." << std::endl;
+    passed = false;
+    }
+  heap.Pop();
+  if ( heap.TopIdentifier() != 8 || heap.Contains( 3 ) )
+    {
+    std::cerr << "Decreasing a key failed." << std::endl;
+    passed = false;
+    }
+  heap.Clear();
+  if ( !heap.Empty() || heap.Contains( 0 ) )
+    {
+    std::cerr << "Clear() failed." << std::endl;
+    passed = false;
+    }
+
+  // the memory does not depend on the values of the identifiers
+  const itk::IdentifierType largeIdentifier = itk::NumericTraits< itk::IdentifierType >::max() - 1;
+  heap.Push( largeIdentifier, 5 );
+  heap.Push( 0, 4 );
+  if ( heap.TopIdentifier() != largeIdentifier || !heap.Remove( largeIdentifier ) || heap.Contains( largeIdentifier )
+       || heap.TopIdentifier() != 0 )
+    {
+    std::cerr << "Using a large identifier failed." << std::endl;
+    passed = false;
+    }
+
+  if ( !passed )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
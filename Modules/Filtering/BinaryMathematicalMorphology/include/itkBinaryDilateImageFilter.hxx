@@ -44,6 +44,12 @@ BinaryDilateImageFilter< TInputImage, TOutputImage, TKernel >
 {
   this->AllocateOutputs();
 
+  if ( this->GetUseRunLengthEncoding() )
+    {
+    this->RunLengthEncodedGenerateData(true);
+    return;
+    }
+
   unsigned int i, j;
 
   // Retrieve input and output pointers
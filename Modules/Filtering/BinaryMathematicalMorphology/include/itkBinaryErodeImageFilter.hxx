@@ -44,6 +44,12 @@ BinaryErodeImageFilter< TInputImage, TOutputImage, TKernel >
 {
   this->AllocateOutputs();
 
+  if ( this->GetUseRunLengthEncoding() )
+    {
+    this->RunLengthEncodedGenerateData(false);
+    return;
+    }
+
   unsigned int i, j;
 
   // Retrieve input and output pointers
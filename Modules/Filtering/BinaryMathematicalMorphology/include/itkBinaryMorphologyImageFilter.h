@@ -25,6 +25,8 @@
 #include "itkImageBoundaryCondition.h"
 #include "itkImageRegionIterator.h"
 #include "itkConceptChecking.h"
+#include "itkLabelObject.h"
+#include "itkRunLengthBinaryMorphologyThreader.h"
 
 namespace itk
 {
@@ -89,6 +91,13 @@ namespace itk
  * Where SYM(B) is the symmetric of the structuring element relatively
  * to its center.
  *
+ * When UseRunLengthEncoding is on, the foreground is instead converted
+ * to runs of pixels, which are dilated or eroded directly by
+ * RunLengthBinaryMorphologyThreader with several threads, and painted in
+ * the output. The result is the same; the cost depends on the number of
+ * runs instead of the number of pixels, which is much faster for sparse
+ * foregrounds.
+ *
  * This code was contributed by Jerome Schmid from the University of
  * Strasbourg who provided a fast dilation implementation. Gaetan
  * Lehmann from INRA de Jouy-en-Josas then provided a fast erosion
@@ -181,6 +190,13 @@ public:
   itkGetConstReferenceMacro(BoundaryToForeground, bool);
   itkBooleanMacro(BoundaryToForeground);
 
+  /** Get/Set whether the dilation or the erosion is computed on the runs
+   * of foreground pixels along the first dimension, with several threads,
+   * instead of the border of the foreground. Defaults to false. */
+  itkSetMacro(UseRunLengthEncoding, bool);
+  itkGetConstReferenceMacro(UseRunLengthEncoding, bool);
+  itkBooleanMacro(UseRunLengthEncoding);
+
   /** Set kernel (structuring element). */
   void SetKernel(const KernelType & kernel) ITK_OVERRIDE;
 
@@ -221,12 +237,20 @@ protected:
   ComponentVectorConstIterator KernelCCVectorEnd()
   { return m_KernelCCVector.end(); }
 
+  /** Compute the dilation, or the erosion if \c dilate is false, of the
+   * runs of foreground pixels of the input, and paint them in the
+   * output. The output must be allocated. */
+  void RunLengthEncodedGenerateData(bool dilate);
+
   bool m_BoundaryToForeground;
 
 private:
   BinaryMorphologyImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
+  typedef LabelObject< InputPixelType, itkGetStaticConstMacro(InputImageDimension) > LabelObjectType;
+  typedef RunLengthBinaryMorphologyThreader< LabelObjectType, Self >                RunLengthThreaderType;
+
   /** Pixel value to dilate */
   InputPixelType m_ForegroundValue;
 
@@ -240,6 +264,10 @@ private:
    * store the position of one element, arbitrary chosen, which belongs
    * to the CC */
   std::vector< OffsetType > m_KernelCCVector;
+
+  bool m_UseRunLengthEncoding;
+
+  typename RunLengthThreaderType::Pointer m_RunLengthThreader;
 };
 } // end namespace itk
 
@@ -25,7 +25,9 @@
 #include "itkConstantBoundaryCondition.h"
 #include "itkOffset.h"
 #include "itkProgressReporter.h"
+#include "itkImageScanlineIterator.h"
 #include "itkBinaryMorphologyImageFilter.h"
+#include "itkMath.h"
 
 namespace itk
 {
@@ -35,6 +37,8 @@ BinaryMorphologyImageFilter< TInputImage, TOutputImage, TKernel >
 {
   m_ForegroundValue = NumericTraits< InputPixelType >::max();
   m_BackgroundValue = NumericTraits< OutputPixelType >::NonpositiveMin();
+  m_UseRunLengthEncoding = false;
+  m_RunLengthThreader = RunLengthThreaderType::New();
   //this->SetNumberOfThreads(1);
   this->AnalyzeKernel();
 }
@@ -330,6 +334,105 @@ BinaryMorphologyImageFilter< TInputImage, TOutputImage, TKernel >
     }
 }
 
+template< typename TInputImage, typename TOutputImage, typename TKernel >
+void
+BinaryMorphologyImageFilter< TInputImage, TOutputImage, TKernel >
+::RunLengthEncodedGenerateData(bool dilate)
+{
+  OutputImageType *      output = this->GetOutput();
+  const InputImageType * input = this->GetInput();
+
+  const OutputImageRegionType outputRegion = output->GetBufferedRegion();
+  if ( outputRegion.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  // the pixels outside of this region are boundary pixels, as for the
+  // translations of the input in GenerateData()
+  InputImageRegionType inputRegion = outputRegion;
+  inputRegion.PadByRadius( this->GetKernel().GetRadius() );
+  inputRegion.Crop( input->GetBufferedRegion() );
+
+  // the progress is reported once per line
+  ProgressReporter progress( this, 0, inputRegion.GetNumberOfPixels() / inputRegion.GetSize(0)
+                             + outputRegion.GetNumberOfPixels() / outputRegion.GetSize(0) );
+
+  // the runs of foreground pixels
+  typename LabelObjectType::Pointer foreground = LabelObjectType::New();
+  ImageScanlineConstIterator< InputImageType > inIt(input, inputRegion);
+  while ( !inIt.IsAtEnd() )
+    {
+    while ( !inIt.IsAtEndOfLine() )
+      {
+      if ( Math::ExactlyEquals(inIt.Get(), m_ForegroundValue) )
+        {
+        const IndexType start = inIt.GetIndex();
+        SizeValueType   length = 0;
+        while ( !inIt.IsAtEndOfLine() && Math::ExactlyEquals(inIt.Get(), m_ForegroundValue) )
+          {
+          ++length;
+          ++inIt;
+          }
+        foreground->AddLine(start, length);
+        }
+      else
+        {
+        ++inIt;
+        }
+      }
+    inIt.NextLine();
+    progress.CompletedPixel();
+    }
+
+  typename LabelObjectType::Pointer result = LabelObjectType::New();
+  m_RunLengthThreader->SetKernel( this->GetKernel() );
+  m_RunLengthThreader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+  if ( dilate )
+    {
+    m_RunLengthThreader->Dilate(this, foreground, result, inputRegion, outputRegion,
+                                m_BoundaryToForeground);
+    }
+  else
+    {
+    m_RunLengthThreader->Erode(this, foreground, result, inputRegion, outputRegion,
+                               m_BoundaryToForeground);
+    }
+
+  // the input with its foreground replaced by the background, then the
+  // result painted over it
+  ImageScanlineConstIterator< InputImageType > copyIt(input, outputRegion);
+  ImageScanlineIterator< OutputImageType >     outIt(output, outputRegion);
+  while ( !outIt.IsAtEnd() )
+    {
+    while ( !outIt.IsAtEndOfLine() )
+      {
+      const InputPixelType value = copyIt.Get();
+      if ( Math::ExactlyEquals(value, m_ForegroundValue) )
+        {
+        outIt.Set(m_BackgroundValue);
+        }
+      else
+        {
+        outIt.Set( static_cast< OutputPixelType >( value ) );
+        }
+      ++copyIt;
+      ++outIt;
+      }
+    copyIt.NextLine();
+    outIt.NextLine();
+    progress.CompletedPixel();
+    }
+  for ( typename LabelObjectType::ConstLineIterator lit(result); !lit.IsAtEnd(); ++lit )
+    {
+    IndexType idx = lit.GetLine().GetIndex();
+    for ( SizeValueType i = 0; i < lit.GetLine().GetLength(); i++, idx[0]++ )
+      {
+      output->SetPixel( idx, static_cast< OutputPixelType >( m_ForegroundValue ) );
+      }
+    }
+}
+
 /**
  * Standard "PrintSelf" method
  */
@@ -344,6 +447,7 @@ BinaryMorphologyImageFilter< TInputImage, TOutput, TKernel >
   os << indent << "Background Value: "
      << static_cast< typename NumericTraits< OutputPixelType >::PrintType >( m_BackgroundValue ) << std::endl;
   os << indent << "BoundaryToForeground: " << m_BoundaryToForeground << std::endl;
+  os << indent << "UseRunLengthEncoding: " << m_UseRunLengthEncoding << std::endl;
 }
 } // end namespace itk
 
@@ -0,0 +1,198 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRunLengthBinaryMorphologyThreader_h
+#define itkRunLengthBinaryMorphologyThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+#include "itkImageRegion.h"
+
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+
+/** \class RunLengthBinaryMorphologyThreader
+ * \brief Dilates or erodes the lines of a LabelObject without going
+ * through an image.
+ *
+ * The structuring element is stored as a set of runs along the first
+ * dimension, grouped by rows (the other dimensions). For an output row,
+ * the dilation translates the runs of the input rows reached by the
+ * structuring element rows and grows them by the runs of the structuring
+ * element, then merges them; the erosion shrinks the input runs by the
+ * runs of the structuring element and intersects them. The cost depends
+ * on the number of runs of the object instead of its number of pixels,
+ * which makes sparse masks cheap to process. The output rows are
+ * processed in parallel.
+ *
+ * The set operations follow BinaryDilateImageFilter and
+ * BinaryErodeImageFilter: the dilation of X by B is the union of the
+ * translations of X by the elements of B, and the erosion is the set of
+ * the pixels x such that x - b is in X for all the elements b of B. The
+ * pixels outside of the input region are foreground if
+ * BoundaryToForeground is true, and background otherwise.
+ *
+ * The lines of the output object are added in raster order, without
+ * overlap, and are restricted to the output region.
+ *
+ * \sa BinaryDilateImageFilter BinaryErodeImageFilter LabelObject
+ * \ingroup ITKBinaryMathematicalMorphology
+ */
+template< typename TLabelObject, typename TAssociate >
+class RunLengthBinaryMorphologyThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate >
+{
+public:
+  /** Standard class typedefs. */
+  typedef RunLengthBinaryMorphologyThreader                                 Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate > Superclass;
+  typedef SmartPointer< Self >                                              Pointer;
+  typedef SmartPointer< const Self >                                        ConstPointer;
+
+  itkTypeMacro( RunLengthBinaryMorphologyThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+  typedef DomainType                         IndexRangeType;
+
+  typedef TLabelObject                         LabelObjectType;
+  typedef typename LabelObjectType::IndexType  IndexType;
+  typedef typename LabelObjectType::OffsetType OffsetType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, LabelObjectType::ImageDimension);
+
+  typedef ImageRegion< itkGetStaticConstMacro(ImageDimension) > RegionType;
+
+  /** Set the structuring element from the elements of \c kernel which
+   * are on. */
+  template< typename TKernel >
+  void SetKernel( const TKernel & kernel );
+
+  /** Set the structuring element from its offsets. */
+  void SetKernelOffsets( const std::vector< OffsetType > & offsets );
+
+  /** Add to \c output the dilation of the lines of \c input which are in
+   * \c inputRegion, restricted to \c outputRegion. */
+  void Dilate( AssociateType * associate, const LabelObjectType * input, LabelObjectType * output,
+               const RegionType & inputRegion, const RegionType & outputRegion,
+               bool boundaryToForeground );
+
+  /** Add to \c output the erosion of the lines of \c input which are in
+   * \c inputRegion, restricted to \c outputRegion. */
+  void Erode( AssociateType * associate, const LabelObjectType * input, LabelObjectType * output,
+              const RegionType & inputRegion, const RegionType & outputRegion,
+              bool boundaryToForeground );
+
+protected:
+  RunLengthBinaryMorphologyThreader();
+  virtual ~RunLengthBinaryMorphologyThreader() {}
+
+  /** Allocate the output runs of the threads. */
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  /** Compute the output rows of \c subrange. */
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  /** Add the output runs of the threads to the output object. */
+  virtual void AfterThreadedExecution() ITK_OVERRIDE;
+
+private:
+  RunLengthBinaryMorphologyThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  /** A run [first, second] of a row, bounds included. */
+  typedef std::pair< IndexValueType, IndexValueType > RunType;
+  typedef std::vector< RunType >                      RunListType;
+
+  /** The runs of the structuring element with the same position in the
+   * dimensions other than the first. */
+  struct KernelRowType
+    {
+    OffsetType      m_Offset;
+    OffsetValueType m_RowShift;
+    RunListType     m_Runs;
+    };
+
+  /** The output runs of a thread, with the rows in which they are. */
+  struct ThreadDataType
+    {
+    std::vector< OffsetValueType > m_Rows;
+    std::vector< SizeValueType >   m_RowEnds;
+    RunListType                    m_Runs;
+    RunListType                    m_Row;
+    RunListType                    m_Work;
+    RunListType                    m_Source;
+    };
+
+  /** Raster order of the offsets, the last dimension being the slowest. */
+  static bool RasterOrder( const OffsetType & a, const OffsetType & b );
+
+  /** Store the rows of \c input and select the output rows. */
+  void Initialize( const LabelObjectType * input, LabelObjectType * output,
+                   const RegionType & inputRegion, const RegionType & outputRegion,
+                   bool boundaryToForeground, bool dilate );
+
+  /** The position of the row \c row in the row grid. */
+  OffsetValueType GetRowNumber( const IndexType & row ) const;
+
+  /** The first index of the row at \c rowNumber in the row grid. */
+  IndexType GetRowIndex( OffsetValueType rowNumber ) const;
+
+  /** Put in \c runs the runs of the input in the row at \c rowNumber,
+   * including the pixels outside of the input region when they are
+   * foreground. Return false if the whole row is outside of the input
+   * region. */
+  bool GetSourceRuns( OffsetValueType rowNumber, RunListType & runs ) const;
+
+  void DilateRow( OffsetValueType rowNumber, ThreadDataType & data ) const;
+
+  void ErodeRow( OffsetValueType rowNumber, ThreadDataType & data ) const;
+
+  std::vector< KernelRowType > m_KernelRows;
+  OffsetType                   m_KernelRadius;
+
+  // the grid of the rows covers the output region padded twice by the
+  // radius of the structuring element, in the dimensions other than the
+  // first
+  RegionType                     m_RowGrid;
+  OffsetValueType                m_RowStrides[ImageDimension];
+  std::vector< SizeValueType >   m_InputRowStarts;
+  RunListType                    m_InputRuns;
+  std::vector< OffsetValueType > m_OutputRows;
+
+  RegionType        m_InputRegion;
+  RegionType        m_OutputRegion;
+  bool              m_BoundaryToForeground;
+  bool              m_Dilate;
+  LabelObjectType * m_Output;
+
+  std::vector< ThreadDataType > m_ThreadData;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkRunLengthBinaryMorphologyThreader.hxx"
+#endif
+
+#endif
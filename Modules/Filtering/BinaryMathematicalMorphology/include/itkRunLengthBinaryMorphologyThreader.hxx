@@ -0,0 +1,552 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRunLengthBinaryMorphologyThreader_hxx
+#define itkRunLengthBinaryMorphologyThreader_hxx
+
+#include "itkRunLengthBinaryMorphologyThreader.h"
+#include "itkMath.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template< typename TLabelObject, typename TAssociate >
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::RunLengthBinaryMorphologyThreader() :
+  m_BoundaryToForeground( false ),
+  m_Dilate( true ),
+  m_Output( ITK_NULLPTR )
+{
+  m_KernelRadius.Fill(0);
+  for ( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    m_RowStrides[d] = 0;
+    }
+}
+
+template< typename TLabelObject, typename TAssociate >
+template< typename TKernel >
+void
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::SetKernel( const TKernel & kernel )
+{
+  std::vector< OffsetType > offsets;
+  for ( unsigned int i = 0; i < kernel.Size(); i++ )
+    {
+    if ( kernel[i] )
+      {
+      const typename TKernel::OffsetType kernelOffset = kernel.GetOffset(i);
+      OffsetType                         offset;
+      for ( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        offset[d] = kernelOffset[d];
+        }
+      offsets.push_back(offset);
+      }
+    }
+  this->SetKernelOffsets(offsets);
+}
+
+template< typename TLabelObject, typename TAssociate >
+bool
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::RasterOrder( const OffsetType & a, const OffsetType & b )
+{
+  for ( unsigned int d = ImageDimension; d-- > 0; )
+    {
+    if ( a[d] != b[d] )
+      {
+      return a[d] < b[d];
+      }
+    }
+  return false;
+}
+
+template< typename TLabelObject, typename TAssociate >
+void
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::SetKernelOffsets( const std::vector< OffsetType > & offsets )
+{
+  std::vector< OffsetType > sorted = offsets;
+  std::sort( sorted.begin(), sorted.end(), RasterOrder );
+
+  m_KernelRows.clear();
+  m_KernelRadius.Fill(0);
+  for ( SizeValueType i = 0; i < sorted.size(); i++ )
+    {
+    const OffsetType & offset = sorted[i];
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      m_KernelRadius[d] = std::max( m_KernelRadius[d], static_cast< OffsetValueType >( Math::abs( offset[d] ) ) );
+      }
+
+    OffsetType rowOffset = offset;
+    rowOffset[0] = 0;
+    if ( m_KernelRows.empty() || m_KernelRows.back().m_Offset != rowOffset )
+      {
+      KernelRowType row;
+      row.m_Offset = rowOffset;
+      row.m_RowShift = 0;
+      m_KernelRows.push_back(row);
+      }
+    RunListType & runs = m_KernelRows.back().m_Runs;
+    if ( !runs.empty() && offset[0] <= runs.back().second + 1 )
+      {
+      runs.back().second = std::max( runs.back().second, static_cast< IndexValueType >( offset[0] ) );
+      }
+    else
+      {
+      runs.push_back( RunType(offset[0], offset[0]) );
+      }
+    }
+}
+
+template< typename TLabelObject, typename TAssociate >
+OffsetValueType
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::GetRowNumber( const IndexType & row ) const
+{
+  OffsetValueType rowNumber = 0;
+  for ( unsigned int d = 1; d < ImageDimension; d++ )
+    {
+    rowNumber += ( row[d] - m_RowGrid.GetIndex(d) ) * m_RowStrides[d];
+    }
+  return rowNumber;
+}
+
+template< typename TLabelObject, typename TAssociate >
+typename RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >::IndexType
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::GetRowIndex( OffsetValueType rowNumber ) const
+{
+  IndexType row;
+  row[0] = 0;
+  for ( unsigned int d = 1; d < ImageDimension; d++ )
+    {
+    row[d] = m_RowGrid.GetIndex(d)
+             + static_cast< IndexValueType >( ( rowNumber / m_RowStrides[d] ) % m_RowGrid.GetSize(d) );
+    }
+  return row;
+}
+
+template< typename TLabelObject, typename TAssociate >
+void
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::Initialize( const LabelObjectType * input, LabelObjectType * output,
+              const RegionType & inputRegion, const RegionType & outputRegion,
+              bool boundaryToForeground, bool dilate )
+{
+  m_InputRegion = inputRegion;
+  m_OutputRegion = outputRegion;
+  m_BoundaryToForeground = boundaryToForeground;
+  m_Dilate = dilate;
+  m_Output = output;
+  m_OutputRows.clear();
+  m_InputRuns.clear();
+  m_InputRowStarts.clear();
+  if ( outputRegion.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  // the rows reached from the output region
+  typename RegionType::SizeType gridPadding;
+  gridPadding[0] = 0;
+  for ( unsigned int d = 1; d < ImageDimension; d++ )
+    {
+    gridPadding[d] = 2 * m_KernelRadius[d];
+    }
+  m_RowGrid = outputRegion;
+  m_RowGrid.PadByRadius(gridPadding);
+  m_RowGrid.SetIndex(0, 0);
+  m_RowGrid.SetSize(0, 1);
+  OffsetValueType numberOfRows = 1;
+  for ( unsigned int d = 1; d < ImageDimension; d++ )
+    {
+    m_RowStrides[d] = numberOfRows;
+    numberOfRows *= m_RowGrid.GetSize(d);
+    }
+  for ( SizeValueType k = 0; k < m_KernelRows.size(); k++ )
+    {
+    m_KernelRows[k].m_RowShift = GetRowNumber( m_RowGrid.GetIndex() + m_KernelRows[k].m_Offset )
+                                 - GetRowNumber( m_RowGrid.GetIndex() );
+    }
+
+  // the runs of the input in the grid, sorted by row and merged
+  RegionType inputRows = inputRegion;
+  inputRows.SetIndex(0, 0);
+  inputRows.SetSize(0, 1);
+  const IndexValueType inputBegin = inputRegion.GetIndex(0);
+  const IndexValueType inputEnd = inputBegin + static_cast< IndexValueType >( inputRegion.GetSize(0) ) - 1;
+
+  typedef std::pair< OffsetValueType, RunType > RowRunType;
+  std::vector< RowRunType > rowRuns;
+  rowRuns.reserve( input->GetNumberOfLines() );
+  for ( typename LabelObjectType::ConstLineIterator lit(input); !lit.IsAtEnd(); ++lit )
+    {
+    IndexType row = lit.GetLine().GetIndex();
+    const IndexValueType start = std::max( row[0], inputBegin );
+    const IndexValueType end =
+      std::min( row[0] + static_cast< IndexValueType >( lit.GetLine().GetLength() ) - 1, inputEnd );
+    row[0] = 0;
+    if ( start <= end && inputRows.IsInside(row) && m_RowGrid.IsInside(row) )
+      {
+      rowRuns.push_back( RowRunType( GetRowNumber(row), RunType(start, end) ) );
+      }
+    }
+  std::sort( rowRuns.begin(), rowRuns.end() );
+
+  m_InputRowStarts.assign(numberOfRows + 1, 0);
+  for ( SizeValueType i = 0; i < rowRuns.size(); i++ )
+    {
+    const RunType & run = rowRuns[i].second;
+    if ( i > 0 && rowRuns[i - 1].first == rowRuns[i].first && run.first <= m_InputRuns.back().second + 1 )
+      {
+      m_InputRuns.back().second = std::max( m_InputRuns.back().second, run.second );
+      }
+    else
+      {
+      m_InputRuns.push_back(run);
+      ++m_InputRowStarts[rowRuns[i].first + 1];
+      }
+    }
+  for ( OffsetValueType r = 0; r < numberOfRows; r++ )
+    {
+    m_InputRowStarts[r + 1] += m_InputRowStarts[r];
+    }
+
+  RegionType outputRows = outputRegion;
+  outputRows.SetIndex(0, 0);
+  outputRows.SetSize(0, 1);
+  if ( m_KernelRows.empty() )
+    {
+    // an empty structuring element erodes to the output region and
+    // dilates to nothing
+    if ( dilate )
+      {
+      return;
+      }
+    boundaryToForeground = true;
+    }
+
+  if ( boundaryToForeground )
+    {
+    // the pixels outside of the input region may reach any row
+    for ( OffsetValueType r = 0; r < numberOfRows; r++ )
+      {
+      if ( outputRows.IsInside( GetRowIndex(r) ) )
+        {
+        m_OutputRows.push_back(r);
+        }
+      }
+    }
+  else if ( dilate )
+    {
+    // the rows reached by the rows with runs
+    std::vector< unsigned char > reached(numberOfRows, 0);
+    for ( OffsetValueType q = 0; q < numberOfRows; q++ )
+      {
+      if ( m_InputRowStarts[q] == m_InputRowStarts[q + 1] )
+        {
+        continue;
+        }
+      const IndexType row = GetRowIndex(q);
+      for ( SizeValueType k = 0; k < m_KernelRows.size(); k++ )
+        {
+        if ( outputRows.IsInside( row + m_KernelRows[k].m_Offset ) )
+          {
+          reached[q + m_KernelRows[k].m_RowShift] = 1;
+          }
+        }
+      }
+    for ( OffsetValueType r = 0; r < numberOfRows; r++ )
+      {
+      if ( reached[r] )
+        {
+        m_OutputRows.push_back(r);
+        }
+      }
+    }
+  else
+    {
+    // the eroded rows need runs in the row reached by any row of the
+    // structuring element
+    const KernelRowType & kernelRow = m_KernelRows[0];
+    for ( OffsetValueType q = 0; q < numberOfRows; q++ )
+      {
+      if ( m_InputRowStarts[q] != m_InputRowStarts[q + 1]
+           && outputRows.IsInside( GetRowIndex(q) + kernelRow.m_Offset ) )
+        {
+        m_OutputRows.push_back(q + kernelRow.m_RowShift);
+        }
+      }
+    }
+}
+
+template< typename TLabelObject, typename TAssociate >
+void
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::Dilate( AssociateType * associate, const LabelObjectType * input, LabelObjectType * output,
+          const RegionType & inputRegion, const RegionType & outputRegion,
+          bool boundaryToForeground )
+{
+  this->Initialize(input, output, inputRegion, outputRegion, boundaryToForeground, true);
+  if ( !m_OutputRows.empty() )
+    {
+    DomainType rowRange;
+    rowRange[0] = 0;
+    rowRange[1] = static_cast< IndexValueType >( m_OutputRows.size() ) - 1;
+    this->Execute(associate, rowRange);
+    }
+}
+
+template< typename TLabelObject, typename TAssociate >
+void
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::Erode( AssociateType * associate, const LabelObjectType * input, LabelObjectType * output,
+         const RegionType & inputRegion, const RegionType & outputRegion,
+         bool boundaryToForeground )
+{
+  this->Initialize(input, output, inputRegion, outputRegion, boundaryToForeground, false);
+  if ( !m_OutputRows.empty() )
+    {
+    DomainType rowRange;
+    rowRange[0] = 0;
+    rowRange[1] = static_cast< IndexValueType >( m_OutputRows.size() ) - 1;
+    this->Execute(associate, rowRange);
+    }
+}
+
+template< typename TLabelObject, typename TAssociate >
+void
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::BeforeThreadedExecution()
+{
+  m_ThreadData.resize( this->GetNumberOfThreadsUsed() );
+  for ( ThreadIdType t = 0; t < m_ThreadData.size(); t++ )
+    {
+    m_ThreadData[t].m_Rows.clear();
+    m_ThreadData[t].m_RowEnds.clear();
+    m_ThreadData[t].m_Runs.clear();
+    }
+}
+
+template< typename TLabelObject, typename TAssociate >
+void
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::ThreadedExecution( const IndexRangeType & subrange,
+                     const ThreadIdType threadId )
+{
+  ThreadDataType & data = m_ThreadData[threadId];
+  for ( IndexValueType i = subrange[0]; i <= subrange[1]; i++ )
+    {
+    if ( m_Dilate )
+      {
+      this->DilateRow(m_OutputRows[i], data);
+      }
+    else
+      {
+      this->ErodeRow(m_OutputRows[i], data);
+      }
+    if ( !data.m_Row.empty() )
+      {
+      data.m_Rows.push_back(m_OutputRows[i]);
+      data.m_Runs.insert( data.m_Runs.end(), data.m_Row.begin(), data.m_Row.end() );
+      data.m_RowEnds.push_back( data.m_Runs.size() );
+      }
+    }
+}
+
+template< typename TLabelObject, typename TAssociate >
+void
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::AfterThreadedExecution()
+{
+  // the threads have contiguous ranges of rows, in order
+  for ( ThreadIdType t = 0; t < m_ThreadData.size(); t++ )
+    {
+    const ThreadDataType & data = m_ThreadData[t];
+    SizeValueType          begin = 0;
+    for ( SizeValueType i = 0; i < data.m_Rows.size(); i++ )
+      {
+      IndexType idx = GetRowIndex(data.m_Rows[i]);
+      for ( SizeValueType j = begin; j < data.m_RowEnds[i]; j++ )
+        {
+        idx[0] = data.m_Runs[j].first;
+        m_Output->AddLine( idx, data.m_Runs[j].second - data.m_Runs[j].first + 1 );
+        }
+      begin = data.m_RowEnds[i];
+      }
+    }
+}
+
+template< typename TLabelObject, typename TAssociate >
+bool
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::GetSourceRuns( OffsetValueType rowNumber, RunListType & runs ) const
+{
+  runs.assign( m_InputRuns.begin() + m_InputRowStarts[rowNumber],
+               m_InputRuns.begin() + m_InputRowStarts[rowNumber + 1] );
+  if ( !m_BoundaryToForeground )
+    {
+    return true;
+    }
+
+  RegionType inputRows = m_InputRegion;
+  inputRows.SetIndex(0, 0);
+  inputRows.SetSize(0, 1);
+  if ( !inputRows.IsInside( GetRowIndex(rowNumber) ) )
+    {
+    return false;
+    }
+
+  // the foreground outside of the input region, far enough to be
+  // seen as infinite from the output region
+  const IndexValueType inputBegin = m_InputRegion.GetIndex(0);
+  const IndexValueType inputEnd = inputBegin + static_cast< IndexValueType >( m_InputRegion.GetSize(0) ) - 1;
+  const IndexValueType margin = 2 * m_KernelRadius[0] + 2;
+  const IndexValueType outside = std::max( m_OutputRegion.GetIndex(0) - inputBegin,
+                                           inputEnd - m_OutputRegion.GetIndex(0)
+                                           - static_cast< IndexValueType >( m_OutputRegion.GetSize(0) ) + 1 );
+  const IndexValueType farAway = std::max( outside, IndexValueType(0) ) + margin
+                                 + static_cast< IndexValueType >( m_OutputRegion.GetSize(0) );
+  if ( !runs.empty() && runs.front().first == inputBegin )
+    {
+    runs.front().first = inputBegin - farAway;
+    }
+  else
+    {
+    runs.insert( runs.begin(), RunType(inputBegin - farAway, inputBegin - 1) );
+    }
+  if ( runs.back().second == inputEnd )
+    {
+    runs.back().second = inputEnd + farAway;
+    }
+  else
+    {
+    runs.push_back( RunType(inputEnd + 1, inputEnd + farAway) );
+    }
+  return true;
+}
+
+template< typename TLabelObject, typename TAssociate >
+void
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::DilateRow( OffsetValueType rowNumber, ThreadDataType & data ) const
+{
+  const IndexValueType outputBegin = m_OutputRegion.GetIndex(0);
+  const IndexValueType outputEnd = outputBegin + static_cast< IndexValueType >( m_OutputRegion.GetSize(0) ) - 1;
+
+  // the input runs grown by the runs of the structuring element
+  RunListType & grown = data.m_Work;
+  grown.clear();
+  data.m_Row.clear();
+  for ( SizeValueType k = 0; k < m_KernelRows.size(); k++ )
+    {
+    const KernelRowType & kernelRow = m_KernelRows[k];
+    if ( !this->GetSourceRuns(rowNumber - kernelRow.m_RowShift, data.m_Source) )
+      {
+      // the row is outside of the input region and foreground
+      data.m_Row.push_back( RunType(outputBegin, outputEnd) );
+      return;
+      }
+    for ( SizeValueType i = 0; i < data.m_Source.size(); i++ )
+      {
+      for ( SizeValueType j = 0; j < kernelRow.m_Runs.size(); j++ )
+        {
+        grown.push_back( RunType( data.m_Source[i].first + kernelRow.m_Runs[j].first,
+                                  data.m_Source[i].second + kernelRow.m_Runs[j].second ) );
+        }
+      }
+    }
+
+  // their union in the output region
+  std::sort( grown.begin(), grown.end() );
+  for ( SizeValueType i = 0; i < grown.size(); i++ )
+    {
+    const IndexValueType start = std::max( grown[i].first, outputBegin );
+    const IndexValueType end = std::min( grown[i].second, outputEnd );
+    if ( start > end )
+      {
+      continue;
+      }
+    if ( !data.m_Row.empty() && start <= data.m_Row.back().second + 1 )
+      {
+      data.m_Row.back().second = std::max( data.m_Row.back().second, end );
+      }
+    else
+      {
+      data.m_Row.push_back( RunType(start, end) );
+      }
+    }
+}
+
+template< typename TLabelObject, typename TAssociate >
+void
+RunLengthBinaryMorphologyThreader< TLabelObject, TAssociate >
+::ErodeRow( OffsetValueType rowNumber, ThreadDataType & data ) const
+{
+  const IndexValueType outputBegin = m_OutputRegion.GetIndex(0);
+  const IndexValueType outputEnd = outputBegin + static_cast< IndexValueType >( m_OutputRegion.GetSize(0) ) - 1;
+
+  RunListType & current = data.m_Row;
+  current.assign( 1, RunType(outputBegin, outputEnd) );
+  for ( SizeValueType k = 0; k < m_KernelRows.size() && !current.empty(); k++ )
+    {
+    const KernelRowType & kernelRow = m_KernelRows[k];
+    if ( !this->GetSourceRuns(rowNumber - kernelRow.m_RowShift, data.m_Source) )
+      {
+      // the row is outside of the input region and foreground
+      continue;
+      }
+    for ( SizeValueType j = 0; j < kernelRow.m_Runs.size() && !current.empty(); j++ )
+      {
+      // the input runs shrunk by the run of the structuring element,
+      // intersected with the current runs
+      const IndexValueType a = kernelRow.m_Runs[j].first;
+      const IndexValueType b = kernelRow.m_Runs[j].second;
+      RunListType &        intersection = data.m_Work;
+      intersection.clear();
+      SizeValueType c = 0;
+      for ( SizeValueType i = 0; i < data.m_Source.size() && c < current.size(); i++ )
+        {
+        const IndexValueType start = data.m_Source[i].first + b;
+        const IndexValueType end = data.m_Source[i].second + a;
+        if ( start > end )
+          {
+          continue;
+          }
+        while ( c < current.size() && current[c].second < start )
+          {
+          ++c;
+          }
+        for ( SizeValueType cc = c; cc < current.size() && current[cc].first <= end; cc++ )
+          {
+          intersection.push_back( RunType( std::max( start, current[cc].first ),
+                                           std::min( end, current[cc].second ) ) );
+          }
+        }
+      current.swap(intersection);
+      }
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,229 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBinaryDilateImageFilter.h"
+#include "itkBinaryErodeImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+/* Check that the dilation and the erosion computed on the runs of
+ * foreground pixels, and the default algorithm, give the result computed
+ * pixel by pixel from the definition, with balls and arbitrary
+ * structuring elements, both boundary conditions, requested regions
+ * inside the image and several threads. */
+namespace
+{
+
+/* A pixel is in the dilation if one of the offsets of the kernel brings a
+ * foreground pixel on it, and in the erosion if all of them do. The pixels
+ * which are not in the result keep their background value, and the
+ * foreground pixels which are not in the result get the BackgroundValue. */
+template< typename TImage, typename TKernel >
+typename TImage::Pointer
+Morphology( const TImage * image, const TKernel & kernel, bool dilate, bool boundaryToForeground )
+{
+  typedef typename TImage::RegionType RegionType;
+  typedef typename TImage::IndexType  IndexType;
+
+  const RegionType region = image->GetLargestPossibleRegion();
+  typename TImage::Pointer output = TImage::New();
+  output->SetRegions( region );
+  output->Allocate();
+
+  itk::ImageRegionConstIteratorWithIndex< TImage > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    // the number of offsets bringing a foreground pixel
+    unsigned int hits = 0;
+    unsigned int numberOfOffsets = 0;
+    for ( unsigned int i = 0; i < kernel.Size(); ++i )
+      {
+      if ( !kernel[i] )
+        {
+        continue;
+        }
+      ++numberOfOffsets;
+      const IndexType index = it.GetIndex() - kernel.GetOffset( i );
+      if ( region.IsInside( index ) ? image->GetPixel( index ) == 255 : boundaryToForeground )
+        {
+        ++hits;
+        }
+      }
+    const bool inResult = dilate ? hits > 0 : hits == numberOfOffsets;
+    output->SetPixel( it.GetIndex(), inResult ? 255 : ( it.Get() == 255 ? 7 : it.Get() ) );
+    }
+  return output;
+}
+
+template< typename TFilter >
+int
+CompareWithDefinition( typename TFilter::InputImageType * image,
+                       const typename TFilter::KernelType & kernel,
+                       const typename TFilter::InputImageType::RegionType & region,
+                       const char * name, bool dilate )
+{
+  typedef typename TFilter::InputImageType ImageType;
+
+  int status = EXIT_SUCCESS;
+  for ( unsigned int boundaryToForeground = 0; boundaryToForeground < 2; ++boundaryToForeground )
+    {
+    typename ImageType::Pointer reference = Morphology( image, kernel, dilate, boundaryToForeground );
+
+    for ( unsigned int runLength = 0; runLength < 2; ++runLength )
+      {
+      for ( itk::ThreadIdType threads = 1; threads <= 4; threads += 3 )
+        {
+        typename TFilter::Pointer filter = TFilter::New();
+        filter->SetInput( image );
+        filter->SetKernel( kernel );
+        filter->SetForegroundValue( 255 );
+        filter->SetBackgroundValue( 7 );
+        filter->SetBoundaryToForeground( boundaryToForeground );
+        filter->SetUseRunLengthEncoding( runLength );
+        filter->SetNumberOfThreads( threads );
+        filter->GetOutput()->SetRequestedRegion( region );
+        TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+        itk::ImageRegionConstIterator< ImageType > it( filter->GetOutput(), region );
+        itk::ImageRegionConstIterator< ImageType > rit( reference, region );
+        unsigned int mismatches = 0;
+        for ( ; !it.IsAtEnd(); ++it, ++rit )
+          {
+          if ( it.Get() != rit.Get() )
+            {
+            ++mismatches;
+            }
+          }
+        if ( mismatches != 0 )
+          {
+          std::cerr << name << ( runLength ? " on the runs" : " with the default algorithm" )
+                    << " with " << threads << " thread(s), BoundaryToForeground "
+                    << boundaryToForeground << " on the requested region " << region.GetIndex()
+                    << region.GetSize() << ": " << mismatches
+                    << " pixels differ from the definition" << std::endl;
+          status = EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  return status;
+}
+
+template< unsigned int VDimension >
+int
+CompareAlgorithms( const itk::Size< VDimension > & size )
+{
+  typedef itk::Image< unsigned char, VDimension >                            ImageType;
+  typedef itk::FlatStructuringElement< VDimension >                          KernelType;
+  typedef itk::BinaryDilateImageFilter< ImageType, ImageType, KernelType > DilateType;
+  typedef itk::BinaryErodeImageFilter< ImageType, ImageType, KernelType >  ErodeType;
+
+  typename ImageType::IndexType index;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    index[d] = static_cast< typename ImageType::IndexValueType >( d ) - 1;
+    }
+  typename ImageType::RegionType region( index, size );
+
+  // a foreground with all kinds of runs, and background pixels with
+  // several values which must be kept
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 17 );
+
+  itk::ImageRegionIterator< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const unsigned int value = generator->GetIntegerVariate( 99 );
+    it.Set( value < 40 ? 255 : value % 3 );
+    }
+
+  typename KernelType::RadiusType radius;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    radius[d] = d + 1;
+    }
+  const KernelType ball = KernelType::Ball( radius );
+
+  // an arbitrary structuring element, not centered and with holes
+  KernelType arbitrary;
+  radius.Fill( 2 );
+  arbitrary.SetRadius( radius );
+  for ( unsigned int i = 0; i < arbitrary.Size(); ++i )
+    {
+    arbitrary[i] = generator->GetIntegerVariate( 2 ) == 0;
+    }
+
+  typename ImageType::RegionType subRegion = region;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    subRegion.SetIndex( d, region.GetIndex( d ) + 3 );
+    subRegion.SetSize( d, region.GetSize( d ) / 2 );
+    }
+
+  int status = EXIT_SUCCESS;
+  const typename ImageType::RegionType regions[] = { region, subRegion };
+  for ( unsigned int r = 0; r < 2; ++r )
+    {
+    if ( CompareWithDefinition< DilateType >( image, ball, regions[r], "ball dilation", true ) != EXIT_SUCCESS
+         || CompareWithDefinition< ErodeType >( image, ball, regions[r], "ball erosion", false ) != EXIT_SUCCESS
+         || CompareWithDefinition< DilateType >( image, arbitrary, regions[r], "dilation", true ) != EXIT_SUCCESS
+         || CompareWithDefinition< ErodeType >( image, arbitrary, regions[r], "erosion", false ) != EXIT_SUCCESS )
+      {
+      status = EXIT_FAILURE;
+      }
+    }
+  return status;
+}
+
+} // end anonymous namespace
+
+int itkRunLengthBinaryMorphologyThreaderTest( int, char *[] )
+{
+  int status = EXIT_SUCCESS;
+
+  itk::Size< 2 > size2D;
+  size2D[0] = 53;
+  size2D[1] = 41;
+  if ( CompareAlgorithms< 2 >( size2D ) != EXIT_SUCCESS )
+    {
+    std::cerr << "2D test failed" << std::endl;
+    status = EXIT_FAILURE;
+    }
+
+  itk::Size< 3 > size3D;
+  size3D[0] = 23;
+  size3D[1] = 19;
+  size3D[2] = 17;
+  if ( CompareAlgorithms< 3 >( size3D ) != EXIT_SUCCESS )
+    {
+    std::cerr << "3D test failed" << std::endl;
+    status = EXIT_FAILURE;
+    }
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test finished." << std::endl;
+    }
+  return status;
+}
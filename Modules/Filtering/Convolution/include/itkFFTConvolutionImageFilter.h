@@ -20,6 +20,8 @@
 
 #include "itkConvolutionImageFilterBase.h"
 
+#include "itkFFTConvolutionImageFilterTileThreader.h"
+#include "itkFFTConvolutionKernelSpectrum.h"
 #include "itkProgressAccumulator.h"
 #include "itkHalfHermitianToRealInverseFFTImageFilter.h"
 #include "itkRealToHalfHermitianForwardFFTImageFilter.h"
@@ -36,6 +38,26 @@ namespace itk
  * convolution theorem to accelerate the convolution computation when
  * the kernel is large.
  *
+ * The Fourier transform of the prepared kernel is kept in a
+ * FFTConvolutionKernelSpectrum, and reused as long as the kernel, the
+ * normalization and the padded region are unchanged. Updating the
+ * filter with a new input of the same size thus only transforms the
+ * input. A kernel spectrum may be shared between several filters using
+ * the same kernel with SetKernelSpectrum(); setting it to ITK_NULLPTR
+ * disables the reuse.
+ *
+ * By default, the whole input is padded and transformed at once, so
+ * the padded input and its spectrum must fit in memory. When a
+ * non-zero TileSize is set, the output requested region is instead
+ * computed tile by tile with the overlap-save method: each tile is
+ * read with a margin of the kernel size, convolved in the Fourier
+ * domain and cropped. Only the input region needed by the output
+ * requested region is requested, so the filter can be streamed with
+ * StreamingImageFilter, and the tiles are convolved in parallel. The
+ * padded tile size is chosen so that its greatest prime factor is not
+ * larger than SizeGreatestPrimeFactor. The result is the same as the
+ * monolithic convolution, up to floating point rounding.
+ *
  * \warning This filter ignores the spacing, origin, and orientation
  * of the kernel image and treats them as identical to those in the
  * input image.
@@ -74,26 +96,30 @@ public:
   itkStaticConstMacro(ImageDimension, unsigned int,
                       TInputImage::ImageDimension);
 
-  typedef TInputImage                           InputImageType;
-  typedef TOutputImage                          OutputImageType;
-  typedef TKernelImage                          KernelImageType;
-  typedef typename InputImageType::PixelType    InputPixelType;
-  typedef typename OutputImageType::PixelType   OutputPixelType;
-  typedef typename KernelImageType::PixelType   KernelPixelType;
-  typedef typename InputImageType::IndexType    InputIndexType;
-  typedef typename OutputImageType::IndexType   OutputIndexType;
-  typedef typename KernelImageType::IndexType   KernelIndexType;
-  typedef typename InputImageType::SizeType     InputSizeType;
-  typedef typename OutputImageType::SizeType    OutputSizeType;
-  typedef typename KernelImageType::SizeType    KernelSizeType;
-  typedef typename InputSizeType::SizeValueType SizeValueType;
-  typedef typename InputImageType::RegionType   InputRegionType;
-  typedef typename OutputImageType::RegionType  OutputRegionType;
-  typedef typename KernelImageType::RegionType  KernelRegionType;
+  typedef TInputImage                               InputImageType;
+  typedef TOutputImage                              OutputImageType;
+  typedef TKernelImage                              KernelImageType;
+  typedef typename InputImageType::PixelType        InputPixelType;
+  typedef typename OutputImageType::PixelType       OutputPixelType;
+  typedef typename KernelImageType::PixelType       KernelPixelType;
+  typedef typename InputImageType::IndexType        InputIndexType;
+  typedef typename InputImageType::OffsetType       InputOffsetType;
+  typedef typename InputIndexType::IndexValueType   IndexValueType;
+  typedef typename InputOffsetType::OffsetValueType OffsetValueType;
+  typedef typename OutputImageType::IndexType       OutputIndexType;
+  typedef typename KernelImageType::IndexType       KernelIndexType;
+  typedef typename InputImageType::SizeType         InputSizeType;
+  typedef typename OutputImageType::SizeType        OutputSizeType;
+  typedef typename KernelImageType::SizeType        KernelSizeType;
+  typedef typename InputSizeType::SizeValueType     SizeValueType;
+  typedef typename InputImageType::RegionType       InputRegionType;
+  typedef typename OutputImageType::RegionType      OutputRegionType;
+  typedef typename KernelImageType::RegionType      KernelRegionType;
 
   /** Internal types used by the FFT filters. */
   typedef Image< TInternalPrecision, TInputImage::ImageDimension >  InternalImageType;
   typedef typename InternalImageType::Pointer                       InternalImagePointerType;
+  typedef typename InternalImageType::RegionType                    InternalRegionType;
   typedef std::complex< TInternalPrecision >                        InternalComplexType;
   typedef Image< InternalComplexType, TInputImage::ImageDimension > InternalComplexImageType;
   typedef typename InternalComplexImageType::Pointer                InternalComplexImagePointerType;
@@ -105,6 +131,19 @@ public:
   itkSetMacro(SizeGreatestPrimeFactor, SizeValueType);
   itkGetMacro(SizeGreatestPrimeFactor, SizeValueType);
 
+  /** Set/Get the size of the tiles of the output requested region
+   * convolved independently. Tiles are limited to the output requested
+   * region along the dimensions where the size is 0. A zero size in all
+   * the dimensions, the default, disables the tiling. Setting a non-zero
+   * size throws an exception in the subclasses which can't use tiles. */
+  virtual void SetTileSize(const InputSizeType & tileSize);
+  itkGetConstReferenceMacro(TileSize, InputSizeType);
+
+  /** Set/Get the object keeping the transformed kernel between updates. */
+  typedef FFTConvolutionKernelSpectrum< InternalComplexImageType > KernelSpectrumType;
+  itkSetObjectMacro(KernelSpectrum, KernelSpectrumType);
+  itkGetModifiableObjectMacro(KernelSpectrum, KernelSpectrumType);
+
 protected:
   FFTConvolutionImageFilter();
   ~FFTConvolutionImageFilter() {}
@@ -130,6 +169,26 @@ protected:
   /** This filter uses a minipipeline to compute the output. */
   void GenerateData() ITK_OVERRIDE;
 
+  /** Return whether the output can be computed tile by tile. Subclasses
+   * which reimplement GenerateData() with the whole image return false. */
+  virtual bool CanUseTiles() const
+  {
+    return true;
+  }
+
+  /** Return whether the output is computed tile by tile. */
+  bool GetUseTiles() const;
+
+  /** Compute the output requested region tile by tile. */
+  void GenerateDataWithTiles();
+
+  /** Convolve one tile of the output with the kernel spectrum
+   * transformed with the padded tile size. */
+  void ConvolveTile(const OutputRegionType & tile,
+                    const InputSizeType & paddedTileSize,
+                    const InternalComplexImageType * kernelSpectrum,
+                    ThreadIdType numberOfFFTThreads);
+
   /** Prepare the input images for operations in the Fourier
    * domain. This includes resizing the input and kernel images,
    * normalizing the kernel if requested, shifting the kernel, and
@@ -163,6 +222,13 @@ protected:
                      InternalComplexImagePointerType & preparedKernel,
                      ProgressAccumulator * progress, float progressWeight);
 
+  /** Prepare the kernel for an explicit padded region, whose index is
+   * the index of the prepared kernel. */
+  void PrepareKernel(const KernelImageType * kernel,
+                     const InternalRegionType & paddedRegion,
+                     InternalComplexImagePointerType & preparedKernel,
+                     ProgressAccumulator * progress, float progressWeight);
+
   /** Produce output from the final Fourier domain image. */
   void ProduceOutput(InternalComplexImageType * paddedOutput,
                      ProgressAccumulator * progress,
@@ -193,7 +259,16 @@ private:
   FFTConvolutionImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
+  typedef FFTConvolutionImageFilterTileThreader< Self > TileThreaderType;
+  friend class FFTConvolutionImageFilterTileThreader< Self >;
+
   SizeValueType m_SizeGreatestPrimeFactor;
+
+  InputSizeType m_TileSize;
+
+  typename TileThreaderType::Pointer m_TileThreader;
+
+  typename KernelSpectrumType::Pointer m_KernelSpectrum;
 };
 }
 
@@ -27,6 +27,8 @@
 #include "itkCyclicShiftImageFilter.h"
 #include "itkExtractImageFilter.h"
 #include "itkImageBase.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkMultiplyImageFilter.h"
 #include "itkNormalizeToConstantImageFilter.h"
 #include "itkMath.h"
@@ -39,6 +41,9 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
 ::FFTConvolutionImageFilter()
 {
   m_SizeGreatestPrimeFactor = FFTFilterType::New()->GetSizeGreatestPrimeFactor();
+  m_KernelSpectrum = KernelSpectrumType::New();
+  m_TileSize.Fill( 0 );
+  m_TileThreader = TileThreaderType::New();
 }
 
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
@@ -46,14 +51,8 @@ void
 FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
 ::GenerateInputRequestedRegion()
 {
-  // Request the largest possible region for both input images.
-  if ( this->GetInput() )
-    {
-    typename InputImageType::Pointer imagePtr =
-      const_cast< InputImageType * >( this->GetInput() );
-    imagePtr->SetRequestedRegionToLargestPossibleRegion();
-    }
-
+  // Request the largest possible region for the kernel, and for the
+  // input image unless the output is computed tile by tile.
   if ( this->GetKernelImage() )
     {
     // Input kernel is an image, cast away the constness so we can set
@@ -62,6 +61,31 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
       const_cast< KernelImageType * >( this->GetKernelImage() );
     kernelPtr->SetRequestedRegionToLargestPossibleRegion();
     }
+
+  if ( this->GetInput() )
+    {
+    typename InputImageType::Pointer imagePtr =
+      const_cast< InputImageType * >( this->GetInput() );
+    if ( this->GetUseTiles() && this->GetKernelImage() )
+      {
+      // Request the output requested region enlarged by the kernel
+      // support, through the boundary condition.
+      const KernelSizeType kernelSize = this->GetKernelImage()->GetLargestPossibleRegion().GetSize();
+      InputRegionType neededRegion = this->GetOutput()->GetRequestedRegion();
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+        {
+        neededRegion.SetIndex( i, neededRegion.GetIndex( i )
+                               - static_cast< IndexValueType >( kernelSize[i] - 1 - kernelSize[i] / 2 ) );
+        neededRegion.SetSize( i, neededRegion.GetSize( i ) + kernelSize[i] - 1 );
+        }
+      imagePtr->SetRequestedRegion( this->GetBoundaryCondition()->GetInputRequestedRegion(
+                                      imagePtr->GetLargestPossibleRegion(), neededRegion ) );
+      }
+    else
+      {
+      imagePtr->SetRequestedRegionToLargestPossibleRegion();
+      }
+    }
 }
 
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
@@ -69,6 +93,12 @@ void
 FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
 ::GenerateData()
 {
+  if ( this->GetUseTiles() )
+    {
+    this->GenerateDataWithTiles();
+    return;
+    }
+
   // Create a process accumulator for tracking the progress of this minipipeline
   ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
   progress->SetMiniPipelineFilter( this );
@@ -98,6 +128,231 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
   this->ProduceOutput( multiplyFilter->GetOutput(), progress, 0.2 );
 }
 
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+void
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::SetTileSize(const InputSizeType & tileSize)
+{
+  if ( m_TileSize == tileSize )
+    {
+    return;
+    }
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+    if ( tileSize[i] != 0 && !this->CanUseTiles() )
+      {
+      itkExceptionMacro( << "The whole image is needed, the output can't be computed tile by tile." );
+      }
+    }
+  m_TileSize = tileSize;
+  this->Modified();
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+bool
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::GetUseTiles() const
+{
+  if ( !this->CanUseTiles() )
+    {
+    return false;
+    }
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+    if ( m_TileSize[i] != 0 )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+void
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::GenerateDataWithTiles()
+{
+  this->AllocateOutputs();
+
+  const OutputRegionType outputRegion = this->GetOutput()->GetRequestedRegion();
+  if ( outputRegion.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+  const KernelImageType * kernel = this->GetKernelImage();
+  const KernelSizeType kernelSize = kernel->GetLargestPossibleRegion().GetSize();
+
+  // Choose the padded tile size, large enough for the tile and the kernel
+  // support, and with small prime factors. The tile is then as large as
+  // this padded size allows.
+  InputSizeType paddedTileSize;
+  OutputSizeType tileSize;
+  SizeValueType numberOfTiles[ImageDimension];
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+    SizeValueType size = outputRegion.GetSize( i );
+    if ( m_TileSize[i] != 0 && m_TileSize[i] < size )
+      {
+      size = m_TileSize[i];
+      }
+    paddedTileSize[i] = size + kernelSize[i] - 1;
+    if ( m_SizeGreatestPrimeFactor > 1 )
+      {
+      while ( Math::GreatestPrimeFactor( paddedTileSize[i] ) > m_SizeGreatestPrimeFactor )
+        {
+        paddedTileSize[i]++;
+        }
+      }
+    tileSize[i] = std::min( paddedTileSize[i] - kernelSize[i] + 1, outputRegion.GetSize( i ) );
+    numberOfTiles[i] = ( outputRegion.GetSize( i ) + tileSize[i] - 1 ) / tileSize[i];
+    }
+
+  typename TileThreaderType::TileContainerType tiles;
+  OutputIndexType position;
+  position.Fill( 0 );
+  bool done = false;
+  while ( !done )
+    {
+    OutputRegionType tile;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+      const OffsetValueType start = position[i] * static_cast< OffsetValueType >( tileSize[i] );
+      tile.SetIndex( i, outputRegion.GetIndex( i ) + start );
+      tile.SetSize( i, std::min( tileSize[i], outputRegion.GetSize( i ) - static_cast< SizeValueType >( start ) ) );
+      }
+    tiles.push_back( tile );
+
+    done = true;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+      if ( static_cast< SizeValueType >( ++position[i] ) < numberOfTiles[i] )
+        {
+        done = false;
+        break;
+        }
+      position[i] = 0;
+      }
+    }
+
+  // All the tiles share the kernel spectrum of the padded tile size. Its
+  // index doesn't matter, the tiles are multiplied buffer to buffer.
+  ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter( this );
+  InternalComplexImagePointerType kernelSpectrum;
+  this->PrepareKernel( kernel, InternalRegionType( paddedTileSize ), kernelSpectrum, progress, 0.1f );
+
+  // Run the tiles in parallel, and give the remaining threads to the
+  // Fourier transforms when there are less tiles than threads.
+  const ThreadIdType numberOfTileThreads = static_cast< ThreadIdType >(
+    std::min( static_cast< SizeValueType >( this->GetNumberOfThreads() ),
+              static_cast< SizeValueType >( tiles.size() ) ) );
+  const ThreadIdType numberOfFFTThreads = std::max( this->GetNumberOfThreads() / numberOfTileThreads,
+                                                    static_cast< ThreadIdType >( 1 ) );
+  m_TileThreader->SetTiles( tiles, paddedTileSize, kernelSpectrum, numberOfFFTThreads );
+  m_TileThreader->SetMaximumNumberOfThreads( numberOfTileThreads );
+  m_TileThreader->SetProgressRange( 0.1f, 0.9f );
+
+  typename TileThreaderType::DomainType tileRange;
+  tileRange[0] = 0;
+  tileRange[1] = static_cast< IndexValueType >( tiles.size() ) - 1;
+  m_TileThreader->Execute( this, tileRange );
+
+  // Don't keep a reference to the kernel spectrum in the threader.
+  m_TileThreader->SetTiles( typename TileThreaderType::TileContainerType(), paddedTileSize, ITK_NULLPTR, 1 );
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+void
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::ConvolveTile(const OutputRegionType & tile,
+               const InputSizeType & paddedTileSize,
+               const InternalComplexImageType * kernelSpectrum,
+               ThreadIdType numberOfFFTThreads)
+{
+  const InputImageType * input = this->GetInput();
+  const KernelSizeType kernelSize = this->GetKernelImage()->GetLargestPossibleRegion().GetSize();
+  const InputRegionType & inputLargestRegion = input->GetLargestPossibleRegion();
+
+  // The region of the input read by the tile, and its position in the
+  // padded tile, which starts at index 0.
+  InputRegionType neededRegion;
+  InputRegionType neededTileRegion;
+  OutputRegionType cropRegion;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+    const IndexValueType lowerRadius = static_cast< IndexValueType >( kernelSize[i] - 1 - kernelSize[i] / 2 );
+    neededRegion.SetIndex( i, tile.GetIndex( i ) - lowerRadius );
+    neededRegion.SetSize( i, tile.GetSize( i ) + kernelSize[i] - 1 );
+    neededTileRegion.SetIndex( i, 0 );
+    neededTileRegion.SetSize( i, neededRegion.GetSize( i ) );
+    cropRegion.SetIndex( i, lowerRadius );
+    cropRegion.SetSize( i, tile.GetSize( i ) );
+    }
+
+  InternalImagePointerType paddedTile = InternalImageType::New();
+  paddedTile->SetRegions( InternalRegionType( paddedTileSize ) );
+  paddedTile->Allocate( true );
+
+  // Copy the input samples, and use the boundary condition for the ones
+  // outside of the input.
+  InputRegionType insideRegion = neededRegion;
+  if ( insideRegion.Crop( inputLargestRegion ) )
+    {
+    InternalRegionType insideTileRegion = insideRegion;
+    insideTileRegion.SetIndex( neededTileRegion.GetIndex() + ( insideRegion.GetIndex() - neededRegion.GetIndex() ) );
+    ImageRegionConstIterator< InputImageType > inIt( input, insideRegion );
+    ImageRegionIterator< InternalImageType > tileIt( paddedTile, insideTileRegion );
+    for ( ; !inIt.IsAtEnd(); ++inIt, ++tileIt )
+      {
+      tileIt.Set( static_cast< TInternalPrecision >( inIt.Get() ) );
+      }
+    }
+  if ( insideRegion != neededRegion )
+    {
+    const BoundaryConditionPointerType boundaryCondition = this->GetBoundaryCondition();
+    const InputOffsetType shift = neededRegion.GetIndex() - neededTileRegion.GetIndex();
+    ImageRegionIteratorWithIndex< InternalImageType > tileIt( paddedTile, neededTileRegion );
+    for ( ; !tileIt.IsAtEnd(); ++tileIt )
+      {
+      const InputIndexType index = tileIt.GetIndex() + shift;
+      if ( !inputLargestRegion.IsInside( index ) )
+        {
+        tileIt.Set( static_cast< TInternalPrecision >( boundaryCondition->GetPixel( index, input ) ) );
+        }
+      }
+    }
+
+  typename FFTFilterType::Pointer fftFilter = FFTFilterType::New();
+  fftFilter->SetNumberOfThreads( numberOfFFTThreads );
+  fftFilter->SetInput( paddedTile );
+  fftFilter->Update();
+  InternalComplexImagePointerType spectrum = fftFilter->GetOutput();
+  spectrum->DisconnectPipeline();
+  fftFilter = ITK_NULLPTR;
+  paddedTile = ITK_NULLPTR;
+
+  InternalComplexType * spectrumBuffer = spectrum->GetBufferPointer();
+  const InternalComplexType * kernelBuffer = kernelSpectrum->GetBufferPointer();
+  const SizeValueType numberOfSamples = spectrum->GetBufferedRegion().GetNumberOfPixels();
+  for ( SizeValueType i = 0; i < numberOfSamples; ++i )
+    {
+    spectrumBuffer[i] *= kernelBuffer[i];
+    }
+
+  typename IFFTFilterType::Pointer ifftFilter = IFFTFilterType::New();
+  ifftFilter->SetActualXDimensionIsOdd( paddedTileSize[0] % 2 != 0 );
+  ifftFilter->SetNumberOfThreads( numberOfFFTThreads );
+  ifftFilter->SetInput( spectrum );
+  ifftFilter->Update();
+
+  ImageRegionConstIterator< InternalImageType > convolvedIt( ifftFilter->GetOutput(), cropRegion );
+  ImageRegionIterator< OutputImageType > outIt( this->GetOutput(), tile );
+  for ( ; !outIt.IsAtEnd(); ++convolvedIt, ++outIt )
+    {
+    outIt.Set( static_cast< OutputPixelType >( convolvedIt.Get() ) );
+    }
+}
+
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
 void
 FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
@@ -204,11 +459,41 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
 ::PrepareKernel(const KernelImageType * kernel,
                 InternalComplexImagePointerType & preparedKernel,
                 ProgressAccumulator * progress, float progressWeight)
+{
+  const InputSizeType padSize = this->GetPadSize();
+  const InputSizeType inputLowerBound = this->GetPadLowerBound();
+  const InputIndexType & inputIndex = this->GetInput()->GetLargestPossibleRegion().GetIndex();
+
+  InternalRegionType paddedRegion;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+    paddedRegion.SetIndex( i, inputIndex[i] - static_cast< typename InputIndexType::IndexValueType >( inputLowerBound[i] ) );
+    paddedRegion.SetSize( i, padSize[i] );
+    }
+  this->PrepareKernel( kernel, paddedRegion, preparedKernel, progress, progressWeight );
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+void
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::PrepareKernel(const KernelImageType * kernel,
+                const InternalRegionType & paddedRegion,
+                InternalComplexImagePointerType & preparedKernel,
+                ProgressAccumulator * progress, float progressWeight)
 {
   KernelRegionType kernelRegion = kernel->GetLargestPossibleRegion();
   KernelSizeType kernelSize = kernelRegion.GetSize();
 
-  InputSizeType padSize = this->GetPadSize();
+  const typename InternalRegionType::SizeType & padSize = paddedRegion.GetSize();
+
+  // Reuse the transformed kernel of a previous update if nothing it
+  // depends on has changed.
+  if ( m_KernelSpectrum.IsNotNull()
+       && m_KernelSpectrum->IsUpToDate( kernel, paddedRegion, this->GetNormalize() ) )
+    {
+    preparedKernel = m_KernelSpectrum->GetSpectrum();
+    return;
+    }
   typename KernelImageType::SizeType kernelUpperBound;
   for (unsigned int i = 0; i < ImageDimension; ++i)
     {
@@ -284,13 +569,11 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
   kernelInfoFilter->ChangeRegionOn();
 
   typedef typename InfoFilterType::OutputImageOffsetValueType InfoOffsetValueType;
-  const InputSizeType & inputLowerBound = this->GetPadLowerBound();
-  const InputIndexType & inputIndex = this->GetInput()->GetLargestPossibleRegion().GetIndex();
   const KernelIndexType & kernelIndex = kernel->GetLargestPossibleRegion().GetIndex();
   InfoOffsetValueType kernelOffset[ImageDimension];
   for (unsigned int i = 0; i < ImageDimension; ++i)
     {
-    kernelOffset[i] = static_cast< InfoOffsetValueType >( inputIndex[i] - inputLowerBound[i] - kernelIndex[i] );
+    kernelOffset[i] = static_cast< InfoOffsetValueType >( paddedRegion.GetIndex()[i] - kernelIndex[i] );
     }
   kernelInfoFilter->SetOutputOffset( kernelOffset );
   kernelInfoFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
@@ -299,6 +582,12 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
   kernelInfoFilter->Update();
 
   preparedKernel = kernelInfoFilter->GetOutput();
+
+  if ( m_KernelSpectrum.IsNotNull() )
+    {
+    preparedKernel->DisconnectPipeline();
+    m_KernelSpectrum->SetSpectrum( preparedKernel, kernel, paddedRegion, this->GetNormalize() );
+    }
 }
 
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
@@ -425,6 +714,8 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "SizeGreatestPrimeFactor: " << m_SizeGreatestPrimeFactor << std::endl;
+  os << indent << "TileSize: " << m_TileSize << std::endl;
+  itkPrintSelfObjectMacro( KernelSpectrum );
 }
 
 }
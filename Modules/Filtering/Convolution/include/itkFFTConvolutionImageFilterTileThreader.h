@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFFTConvolutionImageFilterTileThreader_h
+#define itkFFTConvolutionImageFilterTileThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class FFTConvolutionImageFilterTileThreader
+ * \brief Convolves the tiles of the output of FFTConvolutionImageFilter
+ * in parallel.
+ *
+ * The domain is the range of the indices of the tiles in the list given
+ * with SetTiles(). Each thread convolves its tiles one after the other,
+ * so the memory used is bounded by the number of threads times the
+ * memory needed by a tile.
+ *
+ * \ingroup ITKConvolution
+ */
+template< typename TFFTConvolutionImageFilter >
+class FFTConvolutionImageFilterTileThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TFFTConvolutionImageFilter >
+{
+public:
+  /** Standard class typedefs. */
+  typedef FFTConvolutionImageFilterTileThreader                                      Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TFFTConvolutionImageFilter > Superclass;
+  typedef SmartPointer< Self >                                                       Pointer;
+  typedef SmartPointer< const Self >                                                 ConstPointer;
+
+  itkTypeMacro( FFTConvolutionImageFilterTileThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+  typedef DomainType                         IndexRangeType;
+
+  typedef typename TFFTConvolutionImageFilter::OutputRegionType         OutputRegionType;
+  typedef std::vector< OutputRegionType >                               TileContainerType;
+  typedef typename TFFTConvolutionImageFilter::InputSizeType            SizeType;
+  typedef typename TFFTConvolutionImageFilter::InternalComplexImageType InternalComplexImageType;
+
+  /** Set the tiles to convolve, the size they are padded to, the kernel
+   * spectrum for this size, and the number of threads used by the
+   * Fourier transforms of each tile. */
+  void SetTiles( const TileContainerType & tiles, const SizeType & paddedTileSize,
+                 const InternalComplexImageType * kernelSpectrum, ThreadIdType numberOfFFTThreads );
+
+  /** Set the part of the progress of the filter reported as the tiles are
+   * convolved. */
+  void SetProgressRange( float initialProgress, float progressWeight )
+  {
+    m_InitialProgress = initialProgress;
+    m_ProgressWeight = progressWeight;
+  }
+
+  /** Get the number of tiles, which defines the domain. */
+  SizeValueType GetNumberOfTiles() const
+  {
+    return static_cast< SizeValueType >( m_Tiles.size() );
+  }
+
+protected:
+  FFTConvolutionImageFilterTileThreader();
+  virtual ~FFTConvolutionImageFilterTileThreader() {}
+
+  /** Convolve the tiles of \c subrange, and report the progress of the
+   * first thread per tile. */
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+  FFTConvolutionImageFilterTileThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  TileContainerType                m_Tiles;
+  SizeType                         m_PaddedTileSize;
+  const InternalComplexImageType * m_KernelSpectrum;
+  ThreadIdType                     m_NumberOfFFTThreads;
+  float                            m_InitialProgress;
+  float                            m_ProgressWeight;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFFTConvolutionImageFilterTileThreader.hxx"
+#endif
+
+#endif
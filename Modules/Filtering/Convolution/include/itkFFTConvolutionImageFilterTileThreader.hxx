@@ -0,0 +1,67 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFFTConvolutionImageFilterTileThreader_hxx
+#define itkFFTConvolutionImageFilterTileThreader_hxx
+
+#include "itkFFTConvolutionImageFilterTileThreader.h"
+#include "itkProgressReporter.h"
+
+namespace itk
+{
+
+template< typename TFFTConvolutionImageFilter >
+FFTConvolutionImageFilterTileThreader< TFFTConvolutionImageFilter >
+::FFTConvolutionImageFilterTileThreader() :
+  m_KernelSpectrum( ITK_NULLPTR ),
+  m_NumberOfFFTThreads( 1 ),
+  m_InitialProgress( 0.0f ),
+  m_ProgressWeight( 1.0f )
+{
+  m_PaddedTileSize.Fill( 0 );
+}
+
+template< typename TFFTConvolutionImageFilter >
+void
+FFTConvolutionImageFilterTileThreader< TFFTConvolutionImageFilter >
+::SetTiles( const TileContainerType & tiles, const SizeType & paddedTileSize,
+            const InternalComplexImageType * kernelSpectrum, ThreadIdType numberOfFFTThreads )
+{
+  m_Tiles = tiles;
+  m_PaddedTileSize = paddedTileSize;
+  m_KernelSpectrum = kernelSpectrum;
+  m_NumberOfFFTThreads = numberOfFFTThreads;
+}
+
+template< typename TFFTConvolutionImageFilter >
+void
+FFTConvolutionImageFilterTileThreader< TFFTConvolutionImageFilter >
+::ThreadedExecution( const IndexRangeType & subrange,
+                     const ThreadIdType threadId )
+{
+  ProgressReporter progress( this->m_Associate, threadId, subrange[1] - subrange[0] + 1, 100,
+                             m_InitialProgress, m_ProgressWeight );
+  for ( IndexValueType i = subrange[0]; i <= subrange[1]; ++i )
+    {
+    this->m_Associate->ConvolveTile( m_Tiles[i], m_PaddedTileSize, m_KernelSpectrum, m_NumberOfFFTThreads );
+    progress.CompletedPixel();
+    }
+}
+
+} // end namespace itk
+
+#endif
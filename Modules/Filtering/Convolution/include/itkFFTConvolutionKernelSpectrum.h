@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFFTConvolutionKernelSpectrum_h
+#define itkFFTConvolutionKernelSpectrum_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkDataObject.h"
+
+namespace itk
+{
+/** \class FFTConvolutionKernelSpectrum
+ * \brief Keep the Fourier transform of a padded and shifted kernel.
+ *
+ * The preparation of the kernel (normalization, padding, shift and
+ * forward FFT) of FFTConvolutionImageFilter and its subclasses only
+ * depends on the kernel image, on the normalization flag and on the
+ * padded region. This object stores the last prepared kernel, along
+ * with the state it has been computed from, so that a filter updated
+ * with a new input image of the same size doesn't have to transform the
+ * kernel again. The same object may be given to several filters using
+ * the same kernel.
+ *
+ * The stored spectrum must not be modified by its users.
+ *
+ * \sa FFTConvolutionImageFilter
+ * \ingroup ITKConvolution
+ */
+template< typename TComplexImage >
+class FFTConvolutionKernelSpectrum : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef FFTConvolutionKernelSpectrum Self;
+  typedef Object                       Superclass;
+  typedef SmartPointer< Self >         Pointer;
+  typedef SmartPointer< const Self >   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FFTConvolutionKernelSpectrum, Object);
+
+  typedef TComplexImage                         ComplexImageType;
+  typedef typename ComplexImageType::Pointer    ComplexImagePointerType;
+  typedef typename ComplexImageType::RegionType RegionType;
+
+  /** Get the stored spectrum. */
+  itkGetModifiableObjectMacro(Spectrum, ComplexImageType);
+
+  /** Return true if the stored spectrum has been computed from the
+   * current state of \c kernel, padded to \c paddedRegion, and
+   * normalized or not. */
+  bool IsUpToDate(const DataObject * kernel, const RegionType & paddedRegion, bool normalize) const;
+
+  /** Store the spectrum computed from \c kernel. The spectrum should be
+   * disconnected from the pipeline which has produced it. */
+  void SetSpectrum(ComplexImageType * spectrum, const DataObject * kernel,
+                   const RegionType & paddedRegion, bool normalize);
+
+  /** Release the stored spectrum. */
+  void Release();
+
+protected:
+  FFTConvolutionKernelSpectrum();
+  ~FFTConvolutionKernelSpectrum() {}
+
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  FFTConvolutionKernelSpectrum(const Self &) ITK_DELETE_FUNCTION;
+  void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  ComplexImagePointerType m_Spectrum;
+
+  // The kernel is only used as a key; it is not dereferenced.
+  const DataObject *      m_Kernel;
+  ModifiedTimeType        m_KernelMTime;
+  RegionType              m_PaddedRegion;
+  bool                    m_Normalize;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFFTConvolutionKernelSpectrum.hxx"
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFFTConvolutionKernelSpectrum_hxx
+#define itkFFTConvolutionKernelSpectrum_hxx
+
+#include "itkFFTConvolutionKernelSpectrum.h"
+
+namespace itk
+{
+
+template< typename TComplexImage >
+FFTConvolutionKernelSpectrum< TComplexImage >
+::FFTConvolutionKernelSpectrum() :
+  m_Spectrum( ITK_NULLPTR ),
+  m_Kernel( ITK_NULLPTR ),
+  m_KernelMTime( 0 ),
+  m_Normalize( false )
+{
+}
+
+template< typename TComplexImage >
+bool
+FFTConvolutionKernelSpectrum< TComplexImage >
+::IsUpToDate(const DataObject * kernel, const RegionType & paddedRegion, bool normalize) const
+{
+  // The spectrum buffer may have been released by a pipeline with the
+  // global release data flag set.
+  return m_Spectrum.IsNotNull()
+    && m_Spectrum->GetBufferPointer() != ITK_NULLPTR
+    && kernel != ITK_NULLPTR
+    && kernel == m_Kernel
+    && kernel->GetMTime() == m_KernelMTime
+    && paddedRegion == m_PaddedRegion
+    && normalize == m_Normalize;
+}
+
+template< typename TComplexImage >
+void
+FFTConvolutionKernelSpectrum< TComplexImage >
+::SetSpectrum(ComplexImageType * spectrum, const DataObject * kernel,
+              const RegionType & paddedRegion, bool normalize)
+{
+  m_Spectrum = spectrum;
+  m_Kernel = kernel;
+  m_KernelMTime = kernel->GetMTime();
+  m_PaddedRegion = paddedRegion;
+  m_Normalize = normalize;
+  this->Modified();
+}
+
+template< typename TComplexImage >
+void
+FFTConvolutionKernelSpectrum< TComplexImage >
+::Release()
+{
+  m_Spectrum = ITK_NULLPTR;
+  m_Kernel = ITK_NULLPTR;
+  m_KernelMTime = 0;
+  this->Modified();
+}
+
+template< typename TComplexImage >
+void
+FFTConvolutionKernelSpectrum< TComplexImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Spectrum: " << m_Spectrum.GetPointer() << std::endl;
+  os << indent << "Kernel: " << m_Kernel << std::endl;
+  os << indent << "KernelMTime: " << m_KernelMTime << std::endl;
+  os << indent << "PaddedRegion: " << m_PaddedRegion << std::endl;
+  os << indent << "Normalize: " << m_Normalize << std::endl;
+}
+
+} // end namespace itk
+#endif
@@ -0,0 +1,145 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFFTConvolutionImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+typedef itk::Image< float, 2 > KernelSpectrumTestImageType;
+
+KernelSpectrumTestImageType::Pointer
+CreateRandomImage( const KernelSpectrumTestImageType::SizeType & size,
+                   itk::Statistics::MersenneTwisterRandomVariateGenerator * generator )
+{
+  KernelSpectrumTestImageType::Pointer image = KernelSpectrumTestImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIterator< KernelSpectrumTestImageType > it( image, image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< float >( generator->GetUniformVariate( -1.0, 1.0 ) ) );
+    }
+  return image;
+}
+
+// Convolve with a filter which doesn't keep the kernel spectrum and
+// return the largest difference with the given output.
+double
+CompareWithoutKernelSpectrum( const KernelSpectrumTestImageType * input,
+                              const KernelSpectrumTestImageType * kernel,
+                              bool normalize,
+                              const KernelSpectrumTestImageType * output )
+{
+  typedef itk::FFTConvolutionImageFilter< KernelSpectrumTestImageType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetKernelSpectrum( ITK_NULLPTR );
+  filter->SetInput( input );
+  filter->SetKernelImage( kernel );
+  filter->SetNormalize( normalize );
+  filter->Update();
+
+  double maxDiff = 0.0;
+  itk::ImageRegionConstIterator< KernelSpectrumTestImageType > it( filter->GetOutput(),
+    filter->GetOutput()->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< KernelSpectrumTestImageType > ot( output,
+    filter->GetOutput()->GetLargestPossibleRegion() );
+  for ( ; !it.IsAtEnd(); ++it, ++ot )
+    {
+    maxDiff = std::max( maxDiff, static_cast< double >( std::abs( it.Get() - ot.Get() ) ) );
+    }
+  return maxDiff;
+}
+}
+
+int itkFFTConvolutionImageFilterKernelSpectrumTest( int, char * [] )
+{
+  typedef KernelSpectrumTestImageType                                   ImageType;
+  typedef itk::FFTConvolutionImageFilter< ImageType >                  FilterType;
+  typedef FilterType::KernelSpectrumType                               KernelSpectrumType;
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator       GeneratorType;
+
+  const double tolerance = 1e-4;
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 2017 );
+
+  ImageType::SizeType imageSize = {{ 37, 29 }};
+  ImageType::SizeType kernelSize = {{ 7, 5 }};
+  ImageType::Pointer input1 = CreateRandomImage( imageSize, generator );
+  ImageType::Pointer input2 = CreateRandomImage( imageSize, generator );
+  ImageType::Pointer kernel = CreateRandomImage( kernelSize, generator );
+
+  FilterType::Pointer filter = FilterType::New();
+  KernelSpectrumType::Pointer kernelSpectrum = filter->GetKernelSpectrum();
+  EXERCISE_BASIC_OBJECT_METHODS( kernelSpectrum, FFTConvolutionKernelSpectrum, Object );
+  filter->SetInput( input1 );
+  filter->SetKernelImage( kernel );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_TRUE( CompareWithoutKernelSpectrum( input1, kernel, false, filter->GetOutput() ) < tolerance );
+
+  // A new input of the same size reuses the transformed kernel.
+  KernelSpectrumType::ComplexImageType::Pointer spectrum = filter->GetKernelSpectrum()->GetSpectrum();
+  TEST_EXPECT_TRUE( spectrum.IsNotNull() );
+  filter->SetInput( input2 );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_TRUE( filter->GetKernelSpectrum()->GetSpectrum() == spectrum );
+  TEST_EXPECT_TRUE( CompareWithoutKernelSpectrum( input2, kernel, false, filter->GetOutput() ) < tolerance );
+
+  // The kernel spectrum can be shared between filters.
+  FilterType::Pointer sharingFilter = FilterType::New();
+  sharingFilter->SetKernelSpectrum( filter->GetKernelSpectrum() );
+  sharingFilter->SetInput( input1 );
+  sharingFilter->SetKernelImage( kernel );
+  TRY_EXPECT_NO_EXCEPTION( sharingFilter->Update() );
+  TEST_EXPECT_TRUE( filter->GetKernelSpectrum()->GetSpectrum() == spectrum );
+  TEST_EXPECT_TRUE( CompareWithoutKernelSpectrum( input1, kernel, false, sharingFilter->GetOutput() ) < tolerance );
+
+  // A modified kernel is transformed again.
+  ImageType::IndexType center = {{ 3, 2 }};
+  kernel->SetPixel( center, 4.0f );
+  kernel->Modified();
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_TRUE( filter->GetKernelSpectrum()->GetSpectrum() != spectrum );
+  TEST_EXPECT_TRUE( CompareWithoutKernelSpectrum( input2, kernel, false, filter->GetOutput() ) < tolerance );
+
+  // So is a kernel with a different normalization.
+  spectrum = filter->GetKernelSpectrum()->GetSpectrum();
+  filter->NormalizeOn();
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_TRUE( filter->GetKernelSpectrum()->GetSpectrum() != spectrum );
+  TEST_EXPECT_TRUE( CompareWithoutKernelSpectrum( input2, kernel, true, filter->GetOutput() ) < tolerance );
+
+  // And a kernel padded to a different size.
+  ImageType::SizeType largerSize = {{ 45, 29 }};
+  ImageType::Pointer input3 = CreateRandomImage( largerSize, generator );
+  spectrum = filter->GetKernelSpectrum()->GetSpectrum();
+  filter->SetInput( input3 );
+  TRY_EXPECT_NO_EXCEPTION( filter->UpdateLargestPossibleRegion() );
+  TEST_EXPECT_TRUE( filter->GetKernelSpectrum()->GetSpectrum() != spectrum );
+  TEST_EXPECT_TRUE( CompareWithoutKernelSpectrum( input3, kernel, true, filter->GetOutput() ) < tolerance );
+
+  filter->GetKernelSpectrum()->Release();
+  TEST_EXPECT_TRUE( filter->GetKernelSpectrum()->GetSpectrum() == ITK_NULLPTR );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
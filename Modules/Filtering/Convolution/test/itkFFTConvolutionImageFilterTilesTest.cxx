@@ -0,0 +1,214 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkCommand.h"
+#include "itkConstantBoundaryCondition.h"
+#include "itkFFTConvolutionImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkPeriodicBoundaryCondition.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+typedef itk::Image< float, 3 > TilesTestImageType;
+
+TilesTestImageType::Pointer
+CreateRandomTilesTestImage( const TilesTestImageType::SizeType & size,
+                            itk::Statistics::MersenneTwisterRandomVariateGenerator * generator )
+{
+  TilesTestImageType::Pointer image = TilesTestImageType::New();
+  TilesTestImageType::IndexType index = {{ -3, 5, 2 }};
+  image->SetRegions( TilesTestImageType::RegionType( index, size ) );
+  image->Allocate();
+  itk::ImageRegionIterator< TilesTestImageType > it( image, image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< float >( generator->GetUniformVariate( -1.0, 1.0 ) ) );
+    }
+  return image;
+}
+
+double
+MaximumDifference( const TilesTestImageType * image1, const TilesTestImageType * image2 )
+{
+  if ( image1->GetBufferedRegion() != image2->GetBufferedRegion() )
+    {
+    return itk::NumericTraits< double >::max();
+    }
+  double maxDiff = 0.0;
+  itk::ImageRegionConstIterator< TilesTestImageType > it1( image1, image1->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< TilesTestImageType > it2( image2, image2->GetBufferedRegion() );
+  for ( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    maxDiff = std::max( maxDiff, static_cast< double >( std::abs( it1.Get() - it2.Get() ) ) );
+    }
+  return maxDiff;
+}
+}
+
+// Record the progress reported while the tiles are convolved, after the
+// kernel is transformed.
+class TileProgressObject
+{
+public:
+  TileProgressObject( itk::ProcessObject * o ) :
+    m_Process( o ), m_NumberOfEvents( 0 ), m_LastProgress( 0.0f ), m_Decreased( false )
+    {}
+  void ShowProgress()
+    {
+    const float progress = m_Process->GetProgress();
+    if ( progress < m_LastProgress )
+      {
+      m_Decreased = true;
+      }
+    if ( progress > 0.1f && progress < 1.0f )
+      {
+      ++m_NumberOfEvents;
+      }
+    m_LastProgress = progress;
+    }
+  itk::ProcessObject * m_Process;
+  unsigned int         m_NumberOfEvents;
+  float                m_LastProgress;
+  bool                 m_Decreased;
+};
+
+int itkFFTConvolutionImageFilterTilesTest( int, char * [] )
+{
+  typedef TilesTestImageType                                        ImageType;
+  typedef itk::FFTConvolutionImageFilter< ImageType >              FilterType;
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator   GeneratorType;
+  typedef itk::ConstantBoundaryCondition< ImageType >              ConstantBoundaryConditionType;
+  typedef itk::PeriodicBoundaryCondition< ImageType >              PeriodicBoundaryConditionType;
+  typedef itk::StreamingImageFilter< ImageType, ImageType >        StreamingFilterType;
+
+  const double tolerance = 1e-4;
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 34 );
+
+  ImageType::SizeType imageSize = {{ 29, 23, 11 }};
+  ImageType::Pointer input = CreateRandomTilesTestImage( imageSize, generator );
+
+  ImageType::SizeType kernelSizes[2] = { {{ 5, 4, 3 }}, {{ 7, 6, 1 }} };
+
+  ImageType::SizeType tileSizes[3] = { {{ 8, 0, 0 }}, {{ 5, 6, 4 }}, {{ 100, 100, 100 }} };
+
+  ConstantBoundaryConditionType constantBoundaryCondition;
+  constantBoundaryCondition.SetConstant( 0.5f );
+  PeriodicBoundaryConditionType periodicBoundaryCondition;
+
+  FilterType::Pointer filter = FilterType::New();
+  TEST_SET_GET_VALUE( ImageType::SizeType(), filter->GetTileSize() );
+
+  bool success = true;
+  for ( unsigned int k = 0; k < 2; ++k )
+    {
+    ImageType::Pointer kernel = CreateRandomTilesTestImage( kernelSizes[k], generator );
+    for ( unsigned int boundary = 0; boundary < 3; ++boundary )
+      {
+      for ( unsigned int mode = 0; mode < 2; ++mode )
+        {
+        // The monolithic convolution is the reference.
+        FilterType::Pointer reference = FilterType::New();
+        reference->SetInput( input );
+        reference->SetKernelImage( kernel );
+        reference->SetNormalize( k == 1 );
+        if ( boundary == 1 )
+          {
+          reference->SetBoundaryCondition( &constantBoundaryCondition );
+          }
+        else if ( boundary == 2 )
+          {
+          reference->SetBoundaryCondition( &periodicBoundaryCondition );
+          }
+        if ( mode == 1 )
+          {
+          reference->SetOutputRegionModeToValid();
+          }
+        TRY_EXPECT_NO_EXCEPTION( reference->Update() );
+
+        for ( unsigned int t = 0; t < 3; ++t )
+          {
+          for ( unsigned int threads = 1; threads <= 3; threads += 2 )
+            {
+            FilterType::Pointer tiled = FilterType::New();
+            tiled->SetInput( input );
+            tiled->SetKernelImage( kernel );
+            tiled->SetNormalize( k == 1 );
+            tiled->SetBoundaryCondition( reference->GetBoundaryCondition() );
+            tiled->SetOutputRegionMode( reference->GetOutputRegionMode() );
+            tiled->SetTileSize( tileSizes[t] );
+            tiled->SetNumberOfThreads( threads );
+
+            // Stream the output in a few pieces.
+            StreamingFilterType::Pointer streamer = StreamingFilterType::New();
+            streamer->SetInput( tiled->GetOutput() );
+            streamer->SetNumberOfStreamDivisions( 1 + t );
+            TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+
+            const double difference = MaximumDifference( reference->GetOutput(), streamer->GetOutput() );
+            if ( difference > tolerance )
+              {
+              std::cerr << "Tiled convolution differs from the monolithic one by " << difference
+                        << " for kernel " << k << ", boundary condition " << boundary << ", mode "
+                        << mode << ", tile size " << tileSizes[t] << " and " << threads << " threads."
+                        << std::endl;
+              success = false;
+              }
+            }
+          }
+        }
+      }
+    }
+
+  // The progress is reported after each tile of the thread 0.
+  ImageType::Pointer kernel = CreateRandomTilesTestImage( kernelSizes[0], generator );
+  // The padded tile size, 8 x 8 x 8, has small prime factors.
+  ImageType::SizeType smallTileSize = {{ 4, 5, 6 }};
+  filter->SetInput( input );
+  filter->SetKernelImage( kernel );
+  filter->SetTileSize( smallTileSize );
+  filter->SetNumberOfThreads( 1 );
+
+  TileProgressObject progressWatch( filter );
+  itk::SimpleMemberCommand< TileProgressObject >::Pointer command =
+    itk::SimpleMemberCommand< TileProgressObject >::New();
+  command->SetCallbackFunction( &progressWatch, &TileProgressObject::ShowProgress );
+  filter->AddObserver( itk::ProgressEvent(), command );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  // 8 x 5 x 2 tiles of the output
+  const unsigned int numberOfTiles = 8 * 5 * 2;
+  if ( progressWatch.m_NumberOfEvents < numberOfTiles - 1 || progressWatch.m_Decreased )
+    {
+    std::cerr << "Expected a growing progress for each of the " << numberOfTiles << " tiles, got "
+              << progressWatch.m_NumberOfEvents << " events." << std::endl;
+    success = false;
+    }
+
+  if ( !success )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
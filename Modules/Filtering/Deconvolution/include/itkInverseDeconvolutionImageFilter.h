@@ -110,6 +110,13 @@ protected:
   /** This filter uses a minipipeline to compute the output. */
   virtual void GenerateData() ITK_OVERRIDE;
 
+  /** The deconvolution needs the whole image, so setting a non-zero
+   * TileSize throws an exception. */
+  virtual bool CanUseTiles() const ITK_OVERRIDE
+  {
+    return false;
+  }
+
   virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
 private:
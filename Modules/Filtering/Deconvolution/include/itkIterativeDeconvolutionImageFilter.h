@@ -125,6 +125,13 @@ protected:
    * ThreadedGenerateData is not overridden. */
   virtual void GenerateData() ITK_OVERRIDE;
 
+  /** The deconvolution needs the whole image, so setting a non-zero
+   * TileSize throws an exception. */
+  virtual bool CanUseTiles() const ITK_OVERRIDE
+  {
+    return false;
+  }
+
   /** Discrete Fourier transform of the padded kernel. */
   InternalComplexImagePointerType m_TransferFunction;
 
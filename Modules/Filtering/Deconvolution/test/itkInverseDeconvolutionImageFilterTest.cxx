@@ -84,6 +84,13 @@ int itkInverseDeconvolutionImageFilterTest(int argc, char * argv[])
   TEST_SET_GET_VALUE( zeroMagnitudeThreshold,
                       deconvolutionFilter->GetKernelZeroMagnitudeThreshold() );
 
+  // The deconvolution needs the whole image and rejects tiles
+  ImageType::SizeType tileSize;
+  tileSize.Fill( 0 );
+  TRY_EXPECT_NO_EXCEPTION( deconvolutionFilter->SetTileSize( tileSize ) );
+  tileSize[0] = 16;
+  TRY_EXPECT_EXCEPTION( deconvolutionFilter->SetTileSize( tileSize ) );
+
   typedef itk::ImageFileWriter<ImageType> WriterType;
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( argv[3] );
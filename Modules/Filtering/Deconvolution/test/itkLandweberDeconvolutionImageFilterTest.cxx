@@ -69,6 +69,19 @@ int itkLandweberDeconvolutionImageFilterTest(int argc, char* argv[])
     return EXIT_FAILURE;
     }
 
+  // The iterative deconvolution needs the whole image and rejects tiles
+  ImageType::SizeType tileSize;
+  tileSize.Fill( 16 );
+  try
+    {
+    deconvolutionFilter->SetTileSize( tileSize );
+    std::cerr << "SetTileSize() should throw an exception." << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch ( itk::ExceptionObject & )
+    {
+    }
+
   unsigned int iterations = static_cast< unsigned int >( atoi( argv[4] ) );
   deconvolutionFilter->SetNumberOfIterations( iterations );
 
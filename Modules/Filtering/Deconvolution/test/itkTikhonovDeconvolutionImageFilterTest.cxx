@@ -85,6 +85,13 @@ int itkTikhonovDeconvolutionImageFilterTest(int argc, char * argv[])
   TEST_SET_GET_VALUE( regularizationConstant,
                       deconvolutionFilter->GetRegularizationConstant() );
 
+  // The deconvolution needs the whole image and rejects tiles
+  ImageType::SizeType tileSize;
+  tileSize.Fill( 0 );
+  TRY_EXPECT_NO_EXCEPTION( deconvolutionFilter->SetTileSize( tileSize ) );
+  tileSize[1] = 16;
+  TRY_EXPECT_EXCEPTION( deconvolutionFilter->SetTileSize( tileSize ) );
+
   typedef itk::ImageFileWriter<ImageType> WriterType;
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( argv[3] );
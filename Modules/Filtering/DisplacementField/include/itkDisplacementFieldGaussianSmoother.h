@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDisplacementFieldGaussianSmoother_h
+#define itkDisplacementFieldGaussianSmoother_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkDisplacementFieldGaussianSmootherThreader.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class DisplacementFieldGaussianSmoother
+ * \brief Smooths a displacement field in place with a separable Gaussian
+ * kernel.
+ *
+ * The field is convolved along each dimension with the coefficients of a
+ * GaussianOperator of the given variance, using zero flux Neumann boundary
+ * conditions, exactly as a sequence of VectorNeighborhoodOperatorImageFilter
+ * passes would. Each image line is copied into a per-thread line buffer and
+ * written back into the field, so no intermediate field is allocated. The
+ * boundary constraint used by the Gaussian regularized transforms and
+ * registration methods is applied in the last pass: the displacement is
+ * zeroed on the faces of the buffered region and, for variances smaller
+ * than 0.5, the smoothed field is blended with the original one.
+ *
+ * The line buffers and the copy of the original field needed by the blend
+ * are kept between calls, so smoothing a field of the same size at every
+ * iteration of a registration does not allocate.
+ *
+ * \warning Not thread safe. Does its own threading.
+ *
+ * \ingroup ITKDisplacementField
+ */
+template<typename TDisplacementField>
+class DisplacementFieldGaussianSmoother : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef DisplacementFieldGaussianSmoother Self;
+  typedef Object                            Superclass;
+  typedef SmartPointer<Self>                Pointer;
+  typedef SmartPointer<const Self>          ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( DisplacementFieldGaussianSmoother, Object );
+
+  itkStaticConstMacro( ImageDimension, unsigned int, TDisplacementField::ImageDimension );
+
+  typedef TDisplacementField                            DisplacementFieldType;
+  typedef typename DisplacementFieldType::Pointer       DisplacementFieldPointer;
+  typedef typename DisplacementFieldType::PixelType     DisplacementVectorType;
+  typedef typename DisplacementFieldType::RegionType    RegionType;
+  typedef typename DisplacementVectorType::ValueType    ValueType;
+  typedef typename NumericTraits<ValueType>::RealType   RealType;
+
+  /** Get/Set the variance of the Gaussian kernel, in pixels.  A variance
+   * smaller or equal to zero leaves the field untouched. */
+  itkSetMacro( Variance, RealType );
+  itkGetConstMacro( Variance, RealType );
+
+  /** Get/Set the maximum error of the truncated Gaussian kernel.
+   * Default = 0.001. */
+  itkSetMacro( MaximumError, RealType );
+  itkGetConstMacro( MaximumError, RealType );
+
+  /** Smooth \c field in place over its buffered region. */
+  void SmoothInPlace( DisplacementFieldType * field );
+
+  /** Release the buffers cached between calls. */
+  void ReleaseBuffers();
+
+protected:
+  DisplacementFieldGaussianSmoother();
+  virtual ~DisplacementFieldGaussianSmoother() {}
+
+  virtual void PrintSelf( std::ostream & os, Indent indent ) const ITK_OVERRIDE;
+
+private:
+  DisplacementFieldGaussianSmoother( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  typedef DisplacementFieldGaussianSmootherThreader<Self> LineThreaderType;
+  friend class DisplacementFieldGaussianSmootherThreader<Self>;
+
+  RealType                                 m_Variance;
+  RealType                                 m_MaximumError;
+
+  /** State of the current pass, read by the line threader. */
+  DisplacementFieldType *                  m_Field;
+  unsigned int                             m_Direction;
+  bool                                     m_IsLastPass;
+  std::vector<RealType>                    m_Kernel;
+  SizeValueType                            m_KernelRadius;
+  RealType                                 m_SmoothedFieldWeight;
+  RealType                                 m_OriginalFieldWeight;
+
+  /** Copy of the input field, only used when blending. */
+  DisplacementFieldPointer                 m_OriginalField;
+
+  typename LineThreaderType::Pointer       m_LineThreader;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkDisplacementFieldGaussianSmoother.hxx"
+#endif
+
+#endif
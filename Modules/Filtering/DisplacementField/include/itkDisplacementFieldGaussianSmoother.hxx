@@ -0,0 +1,129 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDisplacementFieldGaussianSmoother_hxx
+#define itkDisplacementFieldGaussianSmoother_hxx
+
+#include "itkDisplacementFieldGaussianSmoother.h"
+
+#include "itkGaussianOperator.h"
+#include "itkImageAlgorithm.h"
+
+namespace itk
+{
+
+template<typename TDisplacementField>
+DisplacementFieldGaussianSmoother<TDisplacementField>
+::DisplacementFieldGaussianSmoother() :
+  m_Variance( 0.0 ),
+  m_MaximumError( 0.001 ),
+  m_Field( ITK_NULLPTR ),
+  m_Direction( 0 ),
+  m_IsLastPass( false ),
+  m_KernelRadius( 0 ),
+  m_SmoothedFieldWeight( 1.0 ),
+  m_OriginalFieldWeight( 0.0 )
+{
+  this->m_LineThreader = LineThreaderType::New();
+}
+
+template<typename TDisplacementField>
+void
+DisplacementFieldGaussianSmoother<TDisplacementField>
+::SmoothInPlace( DisplacementFieldType * field )
+{
+  if( this->m_Variance <= 0.0 || field == ITK_NULLPTR )
+    {
+    return;
+    }
+
+  const RegionType region = field->GetBufferedRegion();
+  if( region.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  //make sure boundary does not move
+  this->m_SmoothedFieldWeight = 1.0;
+  if( this->m_Variance < 0.5 )
+    {
+    this->m_SmoothedFieldWeight = 1.0 - 1.0 * ( this->m_Variance / 0.5 );
+    }
+  this->m_OriginalFieldWeight = 1.0 - this->m_SmoothedFieldWeight;
+
+  if( this->m_OriginalFieldWeight > 0.0 )
+    {
+    if( this->m_OriginalField.IsNull() || this->m_OriginalField->GetBufferedRegion() != region )
+      {
+      this->m_OriginalField = DisplacementFieldType::New();
+      this->m_OriginalField->CopyInformation( field );
+      this->m_OriginalField->SetRegions( region );
+      this->m_OriginalField->Allocate();
+      }
+    ImageAlgorithm::Copy( field, this->m_OriginalField.GetPointer(), region, region );
+    }
+
+  typedef GaussianOperator<RealType, ImageDimension> GaussianSmoothingOperatorType;
+  GaussianSmoothingOperatorType gaussianSmoothingOperator;
+
+  this->m_Field = field;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    // smooth along this dimension
+    gaussianSmoothingOperator.SetDirection( d );
+    gaussianSmoothingOperator.SetVariance( this->m_Variance );
+    gaussianSmoothingOperator.SetMaximumError( this->m_MaximumError );
+    gaussianSmoothingOperator.SetMaximumKernelWidth( region.GetSize( d ) );
+    gaussianSmoothingOperator.CreateDirectional();
+
+    this->m_Kernel.assign( gaussianSmoothingOperator.Begin(), gaussianSmoothingOperator.End() );
+    this->m_KernelRadius = gaussianSmoothingOperator.GetRadius( d );
+    this->m_Direction = d;
+    this->m_IsLastPass = ( d == ImageDimension - 1 );
+
+    RegionType lineStarts = region;
+    lineStarts.SetSize( d, 1 );
+    this->m_LineThreader->Execute( this, lineStarts );
+    }
+  this->m_Field = ITK_NULLPTR;
+
+  field->Modified();
+}
+
+template<typename TDisplacementField>
+void
+DisplacementFieldGaussianSmoother<TDisplacementField>
+::ReleaseBuffers()
+{
+  this->m_OriginalField = ITK_NULLPTR;
+  this->m_LineThreader->ReleaseLineBuffers();
+}
+
+template<typename TDisplacementField>
+void
+DisplacementFieldGaussianSmoother<TDisplacementField>
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Variance: " << this->m_Variance << std::endl;
+  os << indent << "Maximum error: " << this->m_MaximumError << std::endl;
+}
+
+} // end namespace itk
+
+#endif
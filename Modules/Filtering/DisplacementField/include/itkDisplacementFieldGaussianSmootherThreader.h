@@ -0,0 +1,92 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDisplacementFieldGaussianSmootherThreader_h
+#define itkDisplacementFieldGaussianSmootherThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedImageRegionPartitioner.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class DisplacementFieldGaussianSmootherThreader
+ * \brief Convolves the lines of a displacement field along one direction
+ * for DisplacementFieldGaussianSmoother.
+ *
+ * The domain is the buffered region of the field collapsed to a single
+ * pixel along the smoothing direction, i.e. the set of line starts. Each
+ * thread owns a line buffer that is kept between executions.
+ *
+ * \ingroup ITKDisplacementField
+ */
+template<typename TDisplacementFieldGaussianSmoother>
+class DisplacementFieldGaussianSmootherThreader
+  : public DomainThreader< ThreadedImageRegionPartitioner< TDisplacementFieldGaussianSmoother::ImageDimension >,
+                           TDisplacementFieldGaussianSmoother >
+{
+public:
+  /** Standard class typedefs. */
+  typedef DisplacementFieldGaussianSmootherThreader                                    Self;
+  typedef DomainThreader< ThreadedImageRegionPartitioner< TDisplacementFieldGaussianSmoother::ImageDimension >,
+                          TDisplacementFieldGaussianSmoother >                         Superclass;
+  typedef SmartPointer< Self >                                                         Pointer;
+  typedef SmartPointer< const Self >                                                   ConstPointer;
+
+  itkTypeMacro( DisplacementFieldGaussianSmootherThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef typename TDisplacementFieldGaussianSmoother::DisplacementFieldType  DisplacementFieldType;
+  typedef typename TDisplacementFieldGaussianSmoother::DisplacementVectorType DisplacementVectorType;
+  typedef typename TDisplacementFieldGaussianSmoother::ValueType              ValueType;
+  typedef typename TDisplacementFieldGaussianSmoother::RealType               RealType;
+
+  /** Release the line buffers. */
+  void ReleaseLineBuffers();
+
+protected:
+  DisplacementFieldGaussianSmootherThreader() {}
+  virtual ~DisplacementFieldGaussianSmootherThreader() {}
+
+  /** Make sure there is a line buffer per thread. */
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  /** Convolve the lines starting in \c subdomain. */
+  virtual void ThreadedExecution( const DomainType & subdomain,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+  DisplacementFieldGaussianSmootherThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  typedef std::vector< DisplacementVectorType > LineBufferType;
+  std::vector< LineBufferType > m_LineBuffers;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkDisplacementFieldGaussianSmootherThreader.hxx"
+#endif
+
+#endif
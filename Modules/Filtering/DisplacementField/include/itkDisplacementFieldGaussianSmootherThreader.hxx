@@ -0,0 +1,156 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDisplacementFieldGaussianSmootherThreader_hxx
+#define itkDisplacementFieldGaussianSmootherThreader_hxx
+
+#include "itkDisplacementFieldGaussianSmootherThreader.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+namespace itk
+{
+
+template<typename TDisplacementFieldGaussianSmoother>
+void
+DisplacementFieldGaussianSmootherThreader<TDisplacementFieldGaussianSmoother>
+::ReleaseLineBuffers()
+{
+  std::vector< LineBufferType >().swap( this->m_LineBuffers );
+}
+
+template<typename TDisplacementFieldGaussianSmoother>
+void
+DisplacementFieldGaussianSmootherThreader<TDisplacementFieldGaussianSmoother>
+::BeforeThreadedExecution()
+{
+  if( this->m_LineBuffers.size() < this->GetNumberOfThreadsUsed() )
+    {
+    this->m_LineBuffers.resize( this->GetNumberOfThreadsUsed() );
+    }
+}
+
+template<typename TDisplacementFieldGaussianSmoother>
+void
+DisplacementFieldGaussianSmootherThreader<TDisplacementFieldGaussianSmoother>
+::ThreadedExecution( const DomainType & subdomain, const ThreadIdType threadId )
+{
+  const unsigned int vectorDimension = DisplacementVectorType::Dimension;
+
+  DisplacementFieldType * field = this->m_Associate->m_Field;
+  const unsigned int direction = this->m_Associate->m_Direction;
+  const bool isLastPass = this->m_Associate->m_IsLastPass;
+  const RealType * kernel = &( this->m_Associate->m_Kernel[0] );
+  const SizeValueType kernelSize = this->m_Associate->m_Kernel.size();
+  const SizeValueType radius = this->m_Associate->m_KernelRadius;
+
+  const RealType smoothedFieldWeight = this->m_Associate->m_SmoothedFieldWeight;
+  const RealType originalFieldWeight = this->m_Associate->m_OriginalFieldWeight;
+  const bool blendWithOriginalField = isLastPass && originalFieldWeight > NumericTraits<RealType>::ZeroValue();
+  const DisplacementVectorType * originalBuffer = ITK_NULLPTR;
+  if( blendWithOriginalField )
+    {
+    originalBuffer = this->m_Associate->m_OriginalField->GetBufferPointer();
+    }
+
+  const typename DisplacementFieldType::RegionType bufferedRegion = field->GetBufferedRegion();
+  const typename DisplacementFieldType::IndexType startIndex = bufferedRegion.GetIndex();
+  const typename DisplacementFieldType::IndexType upperIndex = bufferedRegion.GetUpperIndex();
+  const SizeValueType lineLength = bufferedRegion.GetSize( direction );
+  const OffsetValueType stride = field->GetOffsetTable()[direction];
+
+  DisplacementVectorType * fieldBuffer = field->GetBufferPointer();
+
+  // The line is padded by the kernel radius on both ends with copies of the
+  // end pixels, which is the zero flux Neumann boundary condition.
+  LineBufferType & lineBuffer = this->m_LineBuffers[threadId];
+  if( lineBuffer.size() < lineLength + 2 * radius )
+    {
+    lineBuffer.resize( lineLength + 2 * radius );
+    }
+
+  DisplacementVectorType zeroVector;
+  zeroVector.Fill( NumericTraits<ValueType>::ZeroValue() );
+
+  ImageRegionConstIteratorWithIndex<DisplacementFieldType> It( field, subdomain );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    const typename DisplacementFieldType::IndexType index = It.GetIndex();
+    const OffsetValueType lineOffset = field->ComputeOffset( index );
+    DisplacementVectorType * line = fieldBuffer + lineOffset;
+
+    // In the last pass, lines lying on a face of the field are zeroed.
+    bool isLineOnBoundary = false;
+    if( isLastPass )
+      {
+      for( unsigned int d = 0; d < DisplacementFieldType::ImageDimension; d++ )
+        {
+        if( d != direction && ( index[d] == startIndex[d] || index[d] == upperIndex[d] ) )
+          {
+          isLineOnBoundary = true;
+          break;
+          }
+        }
+      }
+    if( isLineOnBoundary )
+      {
+      for( SizeValueType i = 0; i < lineLength; i++ )
+        {
+        line[i * stride] = zeroVector;
+        }
+      continue;
+      }
+
+    for( SizeValueType i = 0; i < radius; i++ )
+      {
+      lineBuffer[i] = line[0];
+      lineBuffer[radius + lineLength + i] = line[( lineLength - 1 ) * stride];
+      }
+    for( SizeValueType i = 0; i < lineLength; i++ )
+      {
+      lineBuffer[radius + i] = line[i * stride];
+      }
+
+    for( SizeValueType i = 0; i < lineLength; i++ )
+      {
+      DisplacementVectorType & pixel = line[i * stride];
+      if( isLastPass && ( i == 0 || i == lineLength - 1 ) )
+        {
+        pixel = zeroVector;
+        continue;
+        }
+
+      const DisplacementVectorType * window = &( lineBuffer[i] );
+      for( unsigned int c = 0; c < vectorDimension; c++ )
+        {
+        RealType sum = NumericTraits<RealType>::ZeroValue();
+        for( SizeValueType k = 0; k < kernelSize; k++ )
+          {
+          sum += kernel[k] * window[k][c];
+          }
+        if( blendWithOriginalField )
+          {
+          sum = sum * smoothedFieldWeight + originalBuffer[lineOffset + i * stride][c] * originalFieldWeight;
+          }
+        pixel[c] = static_cast<ValueType>( sum );
+        }
+      }
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -20,8 +20,7 @@
 
 #include "itkConstantVelocityFieldTransform.h"
 
-#include "itkGaussianOperator.h"
-#include "itkVectorNeighborhoodOperatorImageFilter.h"
+#include "itkDisplacementFieldGaussianSmoother.h"
 
 namespace itk
 {
@@ -115,15 +114,10 @@ protected:
   GaussianExponentialDiffeomorphicTransform();
   virtual ~GaussianExponentialDiffeomorphicTransform();
 
-  /** Type of Gaussian Operator used during smoothing. Define here
-   * so we can use a member var during the operation. */
-  typedef GaussianOperator<ScalarType, NDimensions> GaussianSmoothingOperatorType;
+  typedef DisplacementFieldGaussianSmoother<ConstantVelocityFieldType>
+                                                  GaussianSmootherType;
 
-  typedef VectorNeighborhoodOperatorImageFilter
-    <ConstantVelocityFieldType, ConstantVelocityFieldType>
-                                                  GaussianSmoothingSmootherType;
-
-  GaussianSmoothingOperatorType                   m_GaussianSmoothingOperator;
+  typename GaussianSmootherType::Pointer          m_GaussianSmoother;
 
   void PrintSelf( std::ostream &, Indent ) const ITK_OVERRIDE;
 
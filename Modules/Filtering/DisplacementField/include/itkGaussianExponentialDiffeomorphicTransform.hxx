@@ -21,7 +21,6 @@
 #include "itkGaussianExponentialDiffeomorphicTransform.h"
 
 #include "itkAddImageFilter.h"
-#include "itkImageDuplicator.h"
 #include "itkImportImageFilter.h"
 #include "itkMultiplyImageFilter.h"
 
@@ -34,6 +33,7 @@ GaussianExponentialDiffeomorphicTransform<TParametersValueType, NDimensions>
   m_GaussianSmoothingVarianceForTheUpdateField( 0.5 ),
   m_GaussianSmoothingVarianceForTheConstantVelocityField( 0.5 )
 {
+  this->m_GaussianSmoother = GaussianSmootherType::New();
 }
 
 template<typename TParametersValueType, unsigned int NDimensions>
@@ -149,80 +149,9 @@ GaussianExponentialDiffeomorphicTransform<TParametersValueType, NDimensions>
     return field;
     }
 
-  typedef ImageDuplicator<ConstantVelocityFieldType> DuplicatorType;
-  typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
-  duplicator->SetInputImage( field );
-  duplicator->Update();
-
-  ConstantVelocityFieldPointer smoothField = duplicator->GetModifiableOutput();
-
-  typename GaussianSmoothingSmootherType::Pointer smoother = GaussianSmoothingSmootherType::New();
-
-  for( unsigned int dimension = 0; dimension < Superclass::Dimension; ++dimension )
-    {
-    // smooth along this dimension
-    this->m_GaussianSmoothingOperator.SetDirection( dimension );
-    this->m_GaussianSmoothingOperator.SetVariance( variance );
-    this->m_GaussianSmoothingOperator.SetMaximumError( 0.001 );
-    this->m_GaussianSmoothingOperator.SetMaximumKernelWidth( smoothField->GetRequestedRegion().GetSize()[dimension] );
-    this->m_GaussianSmoothingOperator.CreateDirectional();
-
-    // todo: make sure we only smooth within the buffered region
-    smoother->SetOperator( this->m_GaussianSmoothingOperator );
-    smoother->SetInput( smoothField );
-    try
-      {
-      smoother->Update();
-      }
-    catch( ExceptionObject & exc )
-      {
-      std::string msg("Caught exception: ");
-      msg += exc.what();
-      itkExceptionMacro( << msg );
-      }
-
-    smoothField = smoother->GetOutput();
-    smoothField->Update();
-    smoothField->DisconnectPipeline();
-    }
-
-  const DisplacementVectorType zeroVector( 0.0 );
-
-  //make sure boundary does not move
-  ScalarType weight1 = 1.0;
-  if( variance < 0.5 )
-    {
-    weight1 = 1.0 - 1.0 * ( variance / 0.5 );
-    }
-  ScalarType weight2 = 1.0 - weight1;
-
-  const typename ConstantVelocityFieldType::RegionType region = field->GetLargestPossibleRegion();
-  const typename ConstantVelocityFieldType::SizeType size = region.GetSize();
-  const typename ConstantVelocityFieldType::IndexType startIndex = region.GetIndex();
-
-  ImageRegionIteratorWithIndex<ConstantVelocityFieldType> fieldIt( field, field->GetLargestPossibleRegion() );
-  ImageRegionConstIteratorWithIndex<ConstantVelocityFieldType> smoothedFieldIt( smoothField, smoothField->GetLargestPossibleRegion() );
-  for( fieldIt.GoToBegin(), smoothedFieldIt.GoToBegin(); !fieldIt.IsAtEnd(); ++fieldIt, ++smoothedFieldIt )
-    {
-    typename ConstantVelocityFieldType::IndexType index = fieldIt.GetIndex();
-    bool isOnBoundary = false;
-    for ( unsigned int dimension = 0; dimension < Dimension; ++dimension )
-      {
-      if( index[dimension] == startIndex[dimension] || index[dimension] == static_cast<IndexValueType>( size[dimension] ) - startIndex[dimension] - 1 )
-        {
-        isOnBoundary = true;
-        break;
-        }
-      }
-    if( isOnBoundary )
-      {
-      fieldIt.Set( zeroVector );
-      }
-    else
-      {
-      fieldIt.Set( smoothedFieldIt.Get() * weight1 + fieldIt.Get() * weight2 );
-      }
-  }
+  this->m_GaussianSmoother->SetVariance( variance );
+  this->m_GaussianSmoother->SetMaximumError( 0.001 );
+  this->m_GaussianSmoother->SmoothInPlace( field );
 
   return field;
 }
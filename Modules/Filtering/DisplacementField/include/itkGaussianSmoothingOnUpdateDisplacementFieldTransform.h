@@ -20,8 +20,7 @@
 
 #include "itkDisplacementFieldTransform.h"
 
-#include "itkGaussianOperator.h"
-#include "itkVectorNeighborhoodOperatorImageFilter.h"
+#include "itkDisplacementFieldGaussianSmoother.h"
 
 namespace itk
 {
@@ -36,8 +35,9 @@ namespace itk
  * the result of the addition of the update array and the displacement
  * field, using a \c GaussianOperator filter.
  *
- * To free the memory allocated and cached in \c GaussianSmoothDisplacementField
- * on demand, see \c FreeGaussianSmoothingTempField.
+ * The smoothing is done in place by a DisplacementFieldGaussianSmoother,
+ * which keeps its buffers between updates. To free them on demand, see
+ * \c ReleaseGaussianSmoothingBuffers.
  *
  *
  * \ingroup ITKDisplacementField
@@ -100,6 +100,9 @@ public:
    */
   virtual DisplacementFieldPointer GaussianSmoothDisplacementField( DisplacementFieldType *, ScalarType );
 
+  /** Free the buffers cached by \c GaussianSmoothDisplacementField. */
+  void ReleaseGaussianSmoothingBuffers();
+
 protected:
   GaussianSmoothingOnUpdateDisplacementFieldTransform();
   virtual ~GaussianSmoothingOnUpdateDisplacementFieldTransform();
@@ -113,14 +116,9 @@ protected:
   ScalarType                        m_GaussianSmoothingVarianceForTheUpdateField;
   ScalarType                        m_GaussianSmoothingVarianceForTheTotalField;
 
-  /** Type of Gaussian Operator used during smoothing. Define here
-   * so we can use a member var during the operation. */
-  typedef GaussianOperator<ScalarType, Superclass::Dimension>
-                                                  GaussianSmoothingOperatorType;
-  typedef VectorNeighborhoodOperatorImageFilter< DisplacementFieldType,
-                                                 DisplacementFieldType >
-                                                  GaussianSmoothingSmootherType;
-  GaussianSmoothingOperatorType                    m_GaussianSmoothingOperator;
+  typedef DisplacementFieldGaussianSmoother< DisplacementFieldType >
+                                                  GaussianSmootherType;
+  typename GaussianSmootherType::Pointer           m_GaussianSmoother;
 
 private:
   GaussianSmoothingOnUpdateDisplacementFieldTransform( const Self& ) ITK_DELETE_FUNCTION;
@@ -21,13 +21,10 @@
 #include "itkGaussianSmoothingOnUpdateDisplacementFieldTransform.h"
 
 #include "itkAddImageFilter.h"
-#include "itkGaussianOperator.h"
 #include "itkImageAlgorithm.h"
-#include "itkImageDuplicator.h"
 #include "itkImageLinearIteratorWithIndex.h"
 #include "itkImportImageFilter.h"
 #include "itkMultiplyImageFilter.h"
-#include "itkVectorNeighborhoodOperatorImageFilter.h"
 
 namespace itk
 {
@@ -38,6 +35,7 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, NDimen
 {
   this->m_GaussianSmoothingVarianceForTheUpdateField = 3.0;
   this->m_GaussianSmoothingVarianceForTheTotalField = 0.5;
+  this->m_GaussianSmoother = GaussianSmootherType::New();
 }
 
 template<typename TParametersValueType, unsigned int NDimensions>
@@ -87,7 +85,10 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, NDimen
 
     DisplacementFieldPointer smoothedField = this->GaussianSmoothDisplacementField( updateField, this->m_GaussianSmoothingVarianceForTheUpdateField );
 
-    ImageAlgorithm::Copy< DisplacementFieldType, DisplacementFieldType >( smoothedField, updateField, smoothedField->GetBufferedRegion(), updateField->GetBufferedRegion() );
+    if( smoothedField != updateField )
+      {
+      ImageAlgorithm::Copy< DisplacementFieldType, DisplacementFieldType >( smoothedField, updateField, smoothedField->GetBufferedRegion(), updateField->GetBufferedRegion() );
+      }
     }
 
   //
@@ -122,7 +123,10 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, NDimen
 
     DisplacementFieldPointer totalSmoothField = this->GaussianSmoothDisplacementField( totalField, this->m_GaussianSmoothingVarianceForTheTotalField );
 
-    ImageAlgorithm::Copy< DisplacementFieldType, DisplacementFieldType >( totalSmoothField, totalField, totalSmoothField->GetBufferedRegion(), totalField->GetBufferedRegion() );
+    if( totalSmoothField != totalField )
+      {
+      ImageAlgorithm::Copy< DisplacementFieldType, DisplacementFieldType >( totalSmoothField, totalField, totalSmoothField->GetBufferedRegion(), totalField->GetBufferedRegion() );
+      }
     }
 }
 
@@ -136,84 +140,21 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, NDimen
     return field;
     }
 
-  typedef ImageDuplicator< DisplacementFieldType > DuplicatorType;
-  typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
-  duplicator->SetInputImage( field );
-  duplicator->Update();
-
-  DisplacementFieldPointer smoothField = duplicator->GetModifiableOutput();
-
-  typename GaussianSmoothingSmootherType::Pointer smoother = GaussianSmoothingSmootherType::New();
-
-  for( unsigned int dimension = 0; dimension < Superclass::Dimension; ++dimension )
-    {
-    // smooth along this dimension
-    this->m_GaussianSmoothingOperator.SetDirection( dimension );
-    this->m_GaussianSmoothingOperator.SetVariance( variance );
-    this->m_GaussianSmoothingOperator.SetMaximumError( 0.001 );
-    this->m_GaussianSmoothingOperator.SetMaximumKernelWidth( smoothField->GetRequestedRegion().GetSize()[dimension] );
-    this->m_GaussianSmoothingOperator.CreateDirectional();
-
-    // todo: make sure we only smooth within the buffered region
-    smoother->SetOperator( this->m_GaussianSmoothingOperator );
-    smoother->SetInput( smoothField );
-    try
-      {
-      smoother->Update();
-      }
-    catch( ExceptionObject & exc )
-      {
-      std::string msg("Caught exception: ");
-      msg += exc.what();
-      itkExceptionMacro( << msg );
-      }
-
-    smoothField = smoother->GetOutput();
-    smoothField->Update();
-    smoothField->DisconnectPipeline();
-    }
-
-  const DisplacementVectorType zeroVector( 0.0 );
-
-  //make sure boundary does not move
-  ScalarType weight1 = 1.0;
-  if( variance < 0.5 )
-    {
-    weight1 = 1.0 - 1.0 * ( variance / 0.5 );
-    }
-  ScalarType weight2 = 1.0 - weight1;
-
-  const typename DisplacementFieldType::RegionType region = field->GetLargestPossibleRegion();
-  const typename DisplacementFieldType::SizeType size = region.GetSize();
-  const typename DisplacementFieldType::IndexType startIndex = region.GetIndex();
-
-  ImageRegionIteratorWithIndex< DisplacementFieldType > fieldIt( field, field->GetLargestPossibleRegion() );
-  ImageRegionConstIteratorWithIndex< DisplacementFieldType > smoothedFieldIt( smoothField, smoothField->GetLargestPossibleRegion() );
-  for( fieldIt.GoToBegin(), smoothedFieldIt.GoToBegin(); !fieldIt.IsAtEnd(); ++fieldIt, ++smoothedFieldIt )
-    {
-    typename DisplacementFieldType::IndexType index = fieldIt.GetIndex();
-    bool isOnBoundary = false;
-    for ( unsigned int dimension = 0; dimension < Superclass::Dimension; ++dimension )
-      {
-      if( index[dimension] == startIndex[dimension] || index[dimension] == static_cast<IndexValueType>( size[dimension] ) - startIndex[dimension] - 1 )
-        {
-        isOnBoundary = true;
-        break;
-        }
-      }
-    if( isOnBoundary )
-      {
-      fieldIt.Set( zeroVector );
-      }
-    else
-      {
-      fieldIt.Set( smoothedFieldIt.Get() * weight1 + fieldIt.Get() * weight2 );
-      }
-    }
+  this->m_GaussianSmoother->SetVariance( variance );
+  this->m_GaussianSmoother->SetMaximumError( 0.001 );
+  this->m_GaussianSmoother->SmoothInPlace( field );
 
   return field;
 }
 
+template<typename TParametersValueType, unsigned int NDimensions>
+void
+GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, NDimensions>
+::ReleaseGaussianSmoothingBuffers()
+{
+  this->m_GaussianSmoother->ReleaseBuffers();
+}
+
 template<typename TParametersValueType, unsigned int NDimensions>
 typename LightObject::Pointer
 GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, NDimensions>
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDisplacementFieldGaussianSmoother.h"
+#include "itkGaussianOperator.h"
+#include "itkImageAlgorithm.h"
+#include "itkImageDuplicator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkVectorNeighborhoodOperatorImageFilter.h"
+
+namespace
+{
+
+// Smooth a field the way the Gaussian regularized transforms used to, with a
+// VectorNeighborhoodOperatorImageFilter per dimension.
+template<typename TField>
+typename TField::Pointer
+ReferenceGaussianSmooth( const TField * field, double variance )
+{
+  typedef itk::ImageDuplicator<TField> DuplicatorType;
+  typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
+  duplicator->SetInputImage( field );
+  duplicator->Update();
+  typename TField::Pointer smoothField = duplicator->GetModifiableOutput();
+
+  typedef itk::GaussianOperator<typename TField::PixelType::ValueType, TField::ImageDimension> OperatorType;
+  OperatorType gaussianOperator;
+
+  typedef itk::VectorNeighborhoodOperatorImageFilter<TField, TField> SmootherType;
+  typename SmootherType::Pointer smoother = SmootherType::New();
+
+  for( unsigned int d = 0; d < TField::ImageDimension; d++ )
+    {
+    gaussianOperator.SetDirection( d );
+    gaussianOperator.SetVariance( variance );
+    gaussianOperator.SetMaximumError( 0.001 );
+    gaussianOperator.SetMaximumKernelWidth( smoothField->GetRequestedRegion().GetSize()[d] );
+    gaussianOperator.CreateDirectional();
+
+    smoother->SetOperator( gaussianOperator );
+    smoother->SetInput( smoothField );
+    smoother->Update();
+
+    smoothField = smoother->GetOutput();
+    smoothField->DisconnectPipeline();
+    }
+
+  double weight1 = 1.0;
+  if( variance < 0.5 )
+    {
+    weight1 = 1.0 - 1.0 * ( variance / 0.5 );
+    }
+  double weight2 = 1.0 - weight1;
+
+  const typename TField::RegionType region = field->GetLargestPossibleRegion();
+
+  typename TField::PixelType zeroVector( 0.0 );
+
+  itk::ImageRegionConstIteratorWithIndex<TField> ItF( field, region );
+  itk::ImageRegionIteratorWithIndex<TField> ItS( smoothField, region );
+  for( ItF.GoToBegin(), ItS.GoToBegin(); !ItF.IsAtEnd(); ++ItF, ++ItS )
+    {
+    typename TField::IndexType index = ItF.GetIndex();
+    bool isOnBoundary = false;
+    for( unsigned int d = 0; d < TField::ImageDimension; d++ )
+      {
+      if( index[d] == region.GetIndex( d ) || index[d] == region.GetUpperIndex()[d] )
+        {
+        isOnBoundary = true;
+        }
+      }
+    if( isOnBoundary )
+      {
+      ItS.Set( zeroVector );
+      }
+    else
+      {
+      ItS.Set( ItS.Get() * weight1 + ItF.Get() * weight2 );
+      }
+    }
+  return smoothField;
+}
+
+}
+
+int itkDisplacementFieldGaussianSmootherTest( int, char * [] )
+{
+  const unsigned int   ImageDimension = 3;
+
+  typedef itk::Vector<float, ImageDimension>       VectorType;
+  typedef itk::Image<VectorType, ImageDimension>   DisplacementFieldType;
+
+  DisplacementFieldType::SizeType size;
+  size[0] = 23;
+  size[1] = 17;
+  size[2] = 9;
+
+  DisplacementFieldType::Pointer field = DisplacementFieldType::New();
+  field->SetRegions( size );
+  field->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  itk::ImageRegionIterator<DisplacementFieldType> It( field, field->GetLargestPossibleRegion() );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    VectorType vector;
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      vector[d] = generator->GetUniformVariate( -1.0, 1.0 );
+      }
+    It.Set( vector );
+    }
+
+  typedef itk::DisplacementFieldGaussianSmoother<DisplacementFieldType> SmootherType;
+  SmootherType::Pointer smoother = SmootherType::New();
+
+  const double variances[] = { 3.0, 0.5, 0.25, 0.0 };
+  for( unsigned int n = 0; n < 4; n++ )
+    {
+    DisplacementFieldType::Pointer referenceField = ReferenceGaussianSmooth<DisplacementFieldType>( field, variances[n] );
+    if( variances[n] <= 0.0 )
+      {
+      referenceField = field;
+      }
+
+    typedef itk::ImageDuplicator<DisplacementFieldType> DuplicatorType;
+    DuplicatorType::Pointer duplicator = DuplicatorType::New();
+    duplicator->SetInputImage( field );
+    duplicator->Update();
+    DisplacementFieldType::Pointer smoothField = duplicator->GetModifiableOutput();
+
+    // Smooth twice to exercise the reuse of the cached buffers.
+    for( unsigned int repeat = 0; repeat < 2; repeat++ )
+      {
+      if( repeat > 0 )
+        {
+        itk::ImageAlgorithm::Copy( field.GetPointer(), smoothField.GetPointer(),
+          field->GetBufferedRegion(), field->GetBufferedRegion() );
+        }
+      smoother->SetVariance( variances[n] );
+      smoother->SmoothInPlace( smoothField );
+      }
+
+    itk::ImageRegionConstIteratorWithIndex<DisplacementFieldType> ItR( referenceField, referenceField->GetLargestPossibleRegion() );
+    for( ItR.GoToBegin(); !ItR.IsAtEnd(); ++ItR )
+      {
+      const VectorType difference = ItR.Get() - smoothField->GetPixel( ItR.GetIndex() );
+      if( difference.GetNorm() > 1.0e-5 )
+        {
+        std::cerr << "Smoothing with variance " << variances[n] << " differs at " << ItR.GetIndex()
+                  << ": " << smoothField->GetPixel( ItR.GetIndex() ) << " instead of " << ItR.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  smoother->ReleaseBuffers();
+  smoother->Print( std::cout, 3 );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFelzenszwalbDistanceMapImageFilter_h
+#define itkFelzenszwalbDistanceMapImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkFelzenszwalbDistanceMapImageFilterThreader.h"
+
+namespace itk
+{
+/** \class FelzenszwalbDistanceMapImageFilter
+ *
+ * \tparam TInputImage Input Image Type
+ * \tparam TOutputImage Output Image Type
+ * \tparam TVoronoiImage Voronoi Image Type. Note the default value is TInputImage.
+ *
+ * \brief Computes the exact Euclidean distance map of an image, and its
+ * Voronoi partition, with the separable lower envelope algorithm.
+ *
+ * Every pixel that is not equal to the BackgroundValue is a feature. The
+ * filter produces as output
+ *
+ * \li A <b>distance map</b> holding, for each pixel, the exact Euclidean
+ *   distance to the nearest feature.
+ * \li A <b>Voronoi partition</b> holding, for each pixel, the input value
+ *   of the nearest feature, computed in the same passes as the distance.
+ *
+ * The transform is computed one dimension at a time. The first pass scans
+ * the lines of the first dimension forward and backward; every following
+ * pass computes, on each line, the lower envelope of the parabolas rooted
+ * at the values of the previous pass. Each pass is multi-threaded over
+ * lines. The lines of the dimensions other than the first are gathered in
+ * tiles of adjacent lines into a contiguous buffer and scattered back, so
+ * that memory is always read and written along the first dimension.
+ *
+ * With UseImageSpacing on, the default, the distances are measured in
+ * physical units and the spacing may differ between dimensions.
+ *
+ * When MaximumDistance is set, distances larger than it are clamped to it
+ * and their Voronoi label is set to zero. The filter then only requests
+ * the input within MaximumDistance of the output requested region, so it
+ * can be streamed, and the memory it uses is bounded by the size of the
+ * streamed chunks. By default the maximum distance is unlimited and the
+ * whole image is processed at once.
+ *
+ * Felzenszwalb, P. F., Huttenlocher, D. P. Distance Transforms of Sampled
+ * Functions. Theory of Computing 8, 415-428 (2012).
+ *
+ * Meijster, A., Roerdink, J. B. T. M., Hesselink, W. H. A General Algorithm
+ * for Computing Distance Transforms in Linear Time. Mathematical Morphology
+ * and its Applications to Image and Signal Processing, 331-340 (2000).
+ *
+ * \sa SignedMaurerDistanceMapImageFilter
+ * \sa DanielssonDistanceMapImageFilter
+ *
+ * \ingroup ImageFeatureExtraction
+ * \ingroup ITKDistanceMap
+ */
+template< typename TInputImage,
+  typename TOutputImage,
+  typename TVoronoiImage = TInputImage >
+class FelzenszwalbDistanceMapImageFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef FelzenszwalbDistanceMapImageFilter              Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  typedef DataObject::Pointer                             DataObjectPointer;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FelzenszwalbDistanceMapImageFilter, ImageToImageFilter);
+
+  /** Type for input image. */
+  typedef TInputImage                              InputImageType;
+  typedef typename InputImageType::PixelType       InputPixelType;
+  typedef typename InputImageType::RegionType      RegionType;
+  typedef typename RegionType::IndexType           IndexType;
+  typedef typename RegionType::SizeType            SizeType;
+  typedef typename InputImageType::SpacingType     SpacingType;
+
+  /** Type for the distance map. */
+  typedef TOutputImage                             OutputImageType;
+  typedef typename OutputImageType::PixelType      OutputPixelType;
+
+  /** Type for the Voronoi map. */
+  typedef TVoronoiImage                            VoronoiImageType;
+  typedef typename VoronoiImageType::Pointer       VoronoiImagePointer;
+  typedef typename VoronoiImageType::PixelType     VoronoiPixelType;
+
+  /** Type used for the squared distances during the computation. */
+  typedef double RealType;
+
+  /** The dimension of the input and output images. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      InputImageType::ImageDimension);
+
+  /** Set/Get the value of the pixels that are not features. Defaults to
+   * zero. */
+  itkSetMacro(BackgroundValue, InputPixelType);
+  itkGetConstReferenceMacro(BackgroundValue, InputPixelType);
+
+  /** Set/Get if the distance should be squared. Defaults to false. */
+  itkSetMacro(SquaredDistance, bool);
+  itkGetConstReferenceMacro(SquaredDistance, bool);
+  itkBooleanMacro(SquaredDistance);
+
+  /** Set/Get if image spacing should be used in computing distances.
+   * Defaults to true. */
+  itkSetMacro(UseImageSpacing, bool);
+  itkGetConstReferenceMacro(UseImageSpacing, bool);
+  itkBooleanMacro(UseImageSpacing);
+
+  /** Set/Get the largest distance computed, in the units of the distance
+   * map (physical units with UseImageSpacing on, pixels otherwise). It is
+   * a distance even if SquaredDistance is on. Setting it enables the
+   * streamed mode. Defaults to NumericTraits< double >::max(), meaning no
+   * limit. */
+  itkSetMacro(MaximumDistance, double);
+  itkGetConstMacro(MaximumDistance, double);
+
+  /** Get the distance map. Output 0. */
+  OutputImageType * GetDistanceMap();
+
+  /** Get the Voronoi map. Output 1. Each pixel holds the input value of
+   * its nearest feature. */
+  VoronoiImageType * GetVoronoiMap();
+
+  /** Standard itk::ProcessObject subclass method. */
+  typedef ProcessObject::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
+  using Superclass::MakeOutput;
+  virtual DataObjectPointer MakeOutput( DataObjectPointerArraySizeType idx ) ITK_OVERRIDE;
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  itkStaticConstMacro(OutputImageDimension, unsigned int,
+                      TOutputImage::ImageDimension);
+  itkStaticConstMacro(VoronoiImageDimension, unsigned int,
+                      TVoronoiImage::ImageDimension);
+
+  // Begin concept checking
+  itkConceptMacro( InputOutputSameDimensionCheck,
+                   ( Concept::SameDimension< ImageDimension, OutputImageDimension > ) );
+  itkConceptMacro( InputVoronoiSameDimensionCheck,
+                   ( Concept::SameDimension< ImageDimension, VoronoiImageDimension > ) );
+  itkConceptMacro( DoubleConvertibleToOutputCheck,
+                   ( Concept::Convertible< double, OutputPixelType > ) );
+  itkConceptMacro( InputConvertibleToVoronoiCheck,
+                   ( Concept::Convertible< InputPixelType, VoronoiPixelType > ) );
+  itkConceptMacro( InputEqualityComparableCheck,
+                   ( Concept::EqualityComparable< InputPixelType > ) );
+  // End concept checking
+#endif
+
+protected:
+  FelzenszwalbDistanceMapImageFilter();
+  virtual ~FelzenszwalbDistanceMapImageFilter() {}
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** Without a maximum distance the whole output is computed. */
+  void EnlargeOutputRequestedRegion(DataObject *data) ITK_OVERRIDE;
+
+  /** Request the input within the maximum distance of the output requested
+   * region, or the whole input without a maximum distance. */
+  void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+  /** Compute the distance map and the Voronoi map. */
+  void GenerateData() ITK_OVERRIDE;
+
+  /** The spacing used to measure distances. */
+  SpacingType GetDistanceSpacing() const;
+
+  /** Whether a maximum distance has been set. */
+  bool HasMaximumDistance() const;
+
+private:
+  FelzenszwalbDistanceMapImageFilter(const Self &) ITK_DELETE_FUNCTION;
+  void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  typedef FelzenszwalbDistanceMapImageFilterThreader< Self > ThreaderType;
+
+  InputPixelType m_BackgroundValue;
+  bool           m_SquaredDistance;
+  bool           m_UseImageSpacing;
+  double         m_MaximumDistance;
+
+  typename ThreaderType::Pointer m_Threader;
+}; // end of FelzenszwalbDistanceMapImageFilter class
+} //end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFelzenszwalbDistanceMapImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,184 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFelzenszwalbDistanceMapImageFilter_hxx
+#define itkFelzenszwalbDistanceMapImageFilter_hxx
+
+#include "itkFelzenszwalbDistanceMapImageFilter.h"
+
+#include <cmath>
+
+namespace itk
+{
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::FelzenszwalbDistanceMapImageFilter() :
+  m_BackgroundValue( NumericTraits< InputPixelType >::ZeroValue() ),
+  m_SquaredDistance( false ),
+  m_UseImageSpacing( true ),
+  m_MaximumDistance( NumericTraits< double >::max() )
+{
+  this->SetNumberOfRequiredOutputs(2);
+
+  // distance map
+  this->SetNthOutput( 0, this->MakeOutput( 0 ) );
+
+  // voronoi map
+  this->SetNthOutput( 1, this->MakeOutput( 1 ) );
+
+  m_Threader = ThreaderType::New();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+typename FelzenszwalbDistanceMapImageFilter<
+  TInputImage, TOutputImage, TVoronoiImage >::DataObjectPointer
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::MakeOutput(DataObjectPointerArraySizeType idx)
+{
+  if( idx == 1 )
+    {
+    return VoronoiImageType::New().GetPointer();
+    }
+  return Superclass::MakeOutput( idx );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+typename
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >::OutputImageType *
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::GetDistanceMap()
+{
+  return dynamic_cast< OutputImageType * >(
+           this->ProcessObject::GetOutput(0) );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+typename
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >::VoronoiImageType *
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::GetVoronoiMap()
+{
+  return dynamic_cast< VoronoiImageType * >(
+           this->ProcessObject::GetOutput(1) );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+typename
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >::SpacingType
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::GetDistanceSpacing() const
+{
+  SpacingType spacing;
+  spacing.Fill( 1.0 );
+  if ( m_UseImageSpacing )
+    {
+    spacing = this->GetInput()->GetSpacing();
+    }
+  return spacing;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+bool
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::HasMaximumDistance() const
+{
+  return m_MaximumDistance < NumericTraits< double >::max();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+void
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  if ( this->HasMaximumDistance() )
+    {
+    Superclass::EnlargeOutputRequestedRegion( data );
+    }
+  else
+    {
+    data->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+void
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( !input )
+    {
+    return;
+    }
+
+  const RegionType & largestRegion = input->GetLargestPossibleRegion();
+  if ( !this->HasMaximumDistance() )
+    {
+    input->SetRequestedRegion( largestRegion );
+    return;
+    }
+
+  // the nearest feature of a pixel closer than the maximum distance to a
+  // feature is within the maximum distance along each dimension
+  const SpacingType spacing = this->GetDistanceSpacing();
+  SizeType          radius;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const double pixels = std::ceil( m_MaximumDistance / spacing[d] );
+    radius[d] = pixels < static_cast< double >( largestRegion.GetSize( d ) )
+                ? static_cast< SizeValueType >( pixels ) : largestRegion.GetSize( d );
+    }
+
+  RegionType requestedRegion = this->GetOutput()->GetRequestedRegion();
+  requestedRegion.PadByRadius( radius );
+  requestedRegion.Crop( largestRegion );
+  input->SetRequestedRegion( requestedRegion );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+void
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::GenerateData()
+{
+  this->AllocateOutputs();
+  this->UpdateProgress( 0.0f );
+
+  const InputImageType *input = this->GetInput();
+
+  m_Threader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+  m_Threader->Run( this, input, input->GetRequestedRegion(), this->GetDistanceSpacing(),
+                   m_MaximumDistance, this->GetDistanceMap(), this->GetVoronoiMap() );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+void
+FelzenszwalbDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Background Value  : "
+     << static_cast< typename NumericTraits< InputPixelType >::PrintType >( m_BackgroundValue ) << std::endl;
+  os << indent << "Squared Distance  : " << m_SquaredDistance << std::endl;
+  os << indent << "Use Image Spacing : " << m_UseImageSpacing << std::endl;
+  os << indent << "Maximum Distance  : " << m_MaximumDistance << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,164 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFelzenszwalbDistanceMapImageFilterThreader_h
+#define itkFelzenszwalbDistanceMapImageFilterThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class FelzenszwalbDistanceMapImageFilterThreader
+ * \brief Runs the line passes of FelzenszwalbDistanceMapImageFilter with
+ * threads.
+ *
+ * The squared distances and the Voronoi labels are computed in buffers
+ * covering the work region, which is the input requested region. The
+ * first pass initializes them from the input, line by line along the
+ * first dimension. The pass along each other dimension d splits the lines
+ * in tiles of up to TileWidth lines adjacent along the first dimension.
+ * A tile is gathered into a per thread buffer where the lines are
+ * contiguous, the lower envelope is computed on each line, and the result
+ * is scattered back. A last pass writes the output requested region of the
+ * distance and the Voronoi maps.
+ *
+ * The domain of each pass is the range of the indices of its lines, or
+ * tiles.
+ *
+ * \sa FelzenszwalbDistanceMapImageFilter
+ * \ingroup ITKDistanceMap
+ */
+template< typename TAssociate >
+class FelzenszwalbDistanceMapImageFilterThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate >
+{
+public:
+  /** Standard class typedefs. */
+  typedef FelzenszwalbDistanceMapImageFilterThreader                        Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate > Superclass;
+  typedef SmartPointer< Self >                                              Pointer;
+  typedef SmartPointer< const Self >                                        ConstPointer;
+
+  itkTypeMacro( FelzenszwalbDistanceMapImageFilterThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+  typedef DomainType                         IndexRangeType;
+
+  typedef typename TAssociate::InputImageType   InputImageType;
+  typedef typename TAssociate::InputPixelType   InputPixelType;
+  typedef typename TAssociate::OutputImageType  OutputImageType;
+  typedef typename TAssociate::OutputPixelType  OutputPixelType;
+  typedef typename TAssociate::VoronoiImageType VoronoiImageType;
+  typedef typename TAssociate::VoronoiPixelType VoronoiPixelType;
+  typedef typename TAssociate::RegionType       RegionType;
+  typedef typename TAssociate::IndexType        IndexType;
+  typedef typename TAssociate::SizeType         SizeType;
+  typedef typename TAssociate::SpacingType      SpacingType;
+  typedef typename TAssociate::RealType         RealType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, InputImageType::ImageDimension);
+
+  /** Number of lines gathered together by the passes along the dimensions
+   * other than the first. */
+  itkStaticConstMacro(TileWidth, unsigned int, 16);
+
+  /** Compute the distance map and the Voronoi map of the input of
+   * \c associate over \c workRegion, and write them in the output
+   * requested region of \c distanceMap and \c voronoiMap. Distances are
+   * measured with \c spacing, and the pixels farther than
+   * \c maximumDistance from all the features are set to \c maximumDistance
+   * with a zero label. */
+  void Run( AssociateType * associate, const InputImageType * input, const RegionType & workRegion,
+            const SpacingType & spacing, double maximumDistance,
+            OutputImageType * distanceMap, VoronoiImageType * voronoiMap );
+
+protected:
+  FelzenszwalbDistanceMapImageFilterThreader();
+  virtual ~FelzenszwalbDistanceMapImageFilterThreader() {}
+
+  /** Allocate the per thread buffers. */
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  /** Run the current pass on the lines, or tiles, of \c subrange. */
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+  FelzenszwalbDistanceMapImageFilterThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  /** Buffers used by one thread to process a tile. The lines of the tile
+   * are stored one after the other. */
+  struct TileBuffers
+    {
+    std::vector< RealType >         m_Values;
+    std::vector< VoronoiPixelType > m_Labels;
+    std::vector< RealType >         m_OutputValues;
+    std::vector< VoronoiPixelType > m_OutputLabels;
+    std::vector< OffsetValueType >  m_Vertices;
+    std::vector< RealType >         m_Boundaries;
+    };
+
+  /** Initialize a line along the first dimension from the input. */
+  void InitializeLine( SizeValueType line );
+
+  /** Compute the lower envelope on the lines of a tile along the current
+   * dimension. */
+  void ProcessTile( SizeValueType tile, TileBuffers & buffers );
+
+  /** Compute the lower envelope of the parabolas of height \c values on a
+   * line of \c length samples. */
+  void LowerEnvelope( const RealType * values, const VoronoiPixelType * labels,
+                      RealType * outputValues, VoronoiPixelType * outputLabels,
+                      SizeValueType length, TileBuffers & buffers ) const;
+
+  /** Write a line of the output requested region. */
+  void WriteLine( SizeValueType line );
+
+  /** Offset in the work buffers of the pixel at \c index. */
+  OffsetValueType ComputeWorkOffset( const IndexType & index ) const;
+
+  const InputImageType *          m_Input;
+  OutputImageType *               m_DistanceMap;
+  VoronoiImageType *              m_VoronoiMap;
+  RegionType                      m_WorkRegion;
+  OffsetValueType                 m_WorkStrides[ImageDimension];
+  SpacingType                     m_Spacing;
+  RealType                        m_MaximumDistance;
+  RealType                        m_OutputMaximum;
+  bool                            m_SquaredDistance;
+  InputPixelType                  m_BackgroundValue;
+  unsigned int                    m_Pass;
+  std::vector< RealType >         m_Values;
+  std::vector< VoronoiPixelType > m_Labels;
+  std::vector< TileBuffers >      m_TileBuffers;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFelzenszwalbDistanceMapImageFilterThreader.hxx"
+#endif
+
+#endif
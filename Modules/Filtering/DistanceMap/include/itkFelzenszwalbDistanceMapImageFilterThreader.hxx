@@ -0,0 +1,407 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFelzenszwalbDistanceMapImageFilterThreader_hxx
+#define itkFelzenszwalbDistanceMapImageFilterThreader_hxx
+
+#include "itkFelzenszwalbDistanceMapImageFilterThreader.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+template< typename TAssociate >
+FelzenszwalbDistanceMapImageFilterThreader< TAssociate >
+::FelzenszwalbDistanceMapImageFilterThreader() :
+  m_Input( ITK_NULLPTR ),
+  m_DistanceMap( ITK_NULLPTR ),
+  m_VoronoiMap( ITK_NULLPTR ),
+  m_MaximumDistance( NumericTraits< RealType >::max() ),
+  m_OutputMaximum( NumericTraits< RealType >::max() ),
+  m_SquaredDistance( false ),
+  m_BackgroundValue( NumericTraits< InputPixelType >::ZeroValue() ),
+  m_Pass( 0 )
+{
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    m_WorkStrides[d] = 0;
+    }
+}
+
+template< typename TAssociate >
+void
+FelzenszwalbDistanceMapImageFilterThreader< TAssociate >
+::Run( AssociateType * associate, const InputImageType * input, const RegionType & workRegion,
+       const SpacingType & spacing, double maximumDistance,
+       OutputImageType * distanceMap, VoronoiImageType * voronoiMap )
+{
+  this->m_Input = input;
+  this->m_DistanceMap = distanceMap;
+  this->m_VoronoiMap = voronoiMap;
+  this->m_WorkRegion = workRegion;
+  this->m_Spacing = spacing;
+  this->m_SquaredDistance = associate->GetSquaredDistance();
+  this->m_BackgroundValue = associate->GetBackgroundValue();
+
+  this->m_MaximumDistance = maximumDistance;
+  if ( this->m_SquaredDistance )
+    {
+    this->m_MaximumDistance =
+      maximumDistance < std::sqrt( NumericTraits< RealType >::max() )
+      ? maximumDistance * maximumDistance : NumericTraits< RealType >::max();
+    }
+  this->m_OutputMaximum = static_cast< RealType >( NumericTraits< OutputPixelType >::max() );
+
+  const SizeType & size = workRegion.GetSize();
+  OffsetValueType stride = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    this->m_WorkStrides[d] = stride;
+    stride *= static_cast< OffsetValueType >( size[d] );
+    }
+
+  const SizeValueType numberOfPixels = workRegion.GetNumberOfPixels();
+  if ( numberOfPixels == 0 )
+    {
+    return;
+    }
+  this->m_Values.resize( numberOfPixels );
+  this->m_Labels.resize( numberOfPixels );
+
+  const SizeValueType numberOfBlocks = ( size[0] + TileWidth - 1 ) / TileWidth;
+  for ( this->m_Pass = 0; this->m_Pass <= ImageDimension; ++this->m_Pass )
+    {
+    SizeValueType numberOfItems;
+    if ( this->m_Pass == 0 )
+      {
+      numberOfItems = numberOfPixels / size[0];
+      }
+    else if ( this->m_Pass < ImageDimension )
+      {
+      numberOfItems = numberOfBlocks * ( numberOfPixels / ( size[0] * size[this->m_Pass] ) );
+      }
+    else
+      {
+      const RegionType & outputRegion = distanceMap->GetRequestedRegion();
+      numberOfItems = outputRegion.GetNumberOfPixels() / outputRegion.GetSize( 0 );
+      }
+
+    if ( numberOfItems > 0 )
+      {
+      IndexRangeType range;
+      range[0] = 0;
+      range[1] = numberOfItems - 1;
+      this->Execute( associate, range );
+      }
+    associate->UpdateProgress( static_cast< float >( this->m_Pass + 1 ) / ( ImageDimension + 1 ) );
+    }
+
+  // release the memory of the work buffers
+  std::vector< RealType >().swap( this->m_Values );
+  std::vector< VoronoiPixelType >().swap( this->m_Labels );
+  std::vector< TileBuffers >().swap( this->m_TileBuffers );
+}
+
+template< typename TAssociate >
+void
+FelzenszwalbDistanceMapImageFilterThreader< TAssociate >
+::BeforeThreadedExecution()
+{
+  if ( this->m_Pass == 0 || this->m_Pass >= ImageDimension )
+    {
+    return;
+    }
+  const SizeValueType length = this->m_WorkRegion.GetSize( this->m_Pass );
+  this->m_TileBuffers.resize( this->GetNumberOfThreadsUsed() );
+  for ( typename std::vector< TileBuffers >::iterator it = this->m_TileBuffers.begin();
+        it != this->m_TileBuffers.end(); ++it )
+    {
+    it->m_Values.resize( TileWidth * length );
+    it->m_Labels.resize( TileWidth * length );
+    it->m_OutputValues.resize( TileWidth * length );
+    it->m_OutputLabels.resize( TileWidth * length );
+    it->m_Vertices.resize( length );
+    it->m_Boundaries.resize( length );
+    }
+}
+
+template< typename TAssociate >
+void
+FelzenszwalbDistanceMapImageFilterThreader< TAssociate >
+::ThreadedExecution( const IndexRangeType & subrange, const ThreadIdType threadId )
+{
+  for ( IndexValueType item = subrange[0]; item <= subrange[1]; ++item )
+    {
+    if ( this->m_Pass == 0 )
+      {
+      this->InitializeLine( item );
+      }
+    else if ( this->m_Pass < ImageDimension )
+      {
+      this->ProcessTile( item, this->m_TileBuffers[threadId] );
+      }
+    else
+      {
+      this->WriteLine( item );
+      }
+    }
+}
+
+template< typename TAssociate >
+OffsetValueType
+FelzenszwalbDistanceMapImageFilterThreader< TAssociate >
+::ComputeWorkOffset( const IndexType & index ) const
+{
+  OffsetValueType offset = 0;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    offset += ( index[d] - this->m_WorkRegion.GetIndex( d ) ) * this->m_WorkStrides[d];
+    }
+  return offset;
+}
+
+template< typename TAssociate >
+void
+FelzenszwalbDistanceMapImageFilterThreader< TAssociate >
+::InitializeLine( SizeValueType line )
+{
+  IndexType index = this->m_WorkRegion.GetIndex();
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    index[d] += static_cast< IndexValueType >( line % this->m_WorkRegion.GetSize( d ) );
+    line /= this->m_WorkRegion.GetSize( d );
+    }
+
+  const InputPixelType * input = this->m_Input->GetBufferPointer() + this->m_Input->ComputeOffset( index );
+  const OffsetValueType  workOffset = this->ComputeWorkOffset( index );
+  RealType *             values = &this->m_Values[workOffset];
+  VoronoiPixelType *     labels = &this->m_Labels[workOffset];
+
+  const OffsetValueType length = static_cast< OffsetValueType >( this->m_WorkRegion.GetSize( 0 ) );
+  const RealType        spacing2 = this->m_Spacing[0] * this->m_Spacing[0];
+
+  // nearest feature on the left
+  OffsetValueType feature = -1;
+  for ( OffsetValueType i = 0; i < length; ++i )
+    {
+    if ( input[i] != this->m_BackgroundValue )
+      {
+      feature = i;
+      }
+    if ( feature >= 0 )
+      {
+      const RealType distance = static_cast< RealType >( i - feature );
+      values[i] = spacing2 * distance * distance;
+      labels[i] = static_cast< VoronoiPixelType >( input[feature] );
+      }
+    else
+      {
+      values[i] = NumericTraits< RealType >::max();
+      labels[i] = NumericTraits< VoronoiPixelType >::ZeroValue();
+      }
+    }
+
+  // nearest feature on the right, if it is closer
+  feature = -1;
+  for ( OffsetValueType i = length - 1; i >= 0; --i )
+    {
+    if ( input[i] != this->m_BackgroundValue )
+      {
+      feature = i;
+      }
+    if ( feature >= 0 )
+      {
+      const RealType distance = static_cast< RealType >( feature - i );
+      const RealType value = spacing2 * distance * distance;
+      if ( value < values[i] )
+        {
+        values[i] = value;
+        labels[i] = static_cast< VoronoiPixelType >( input[feature] );
+        }
+      }
+    }
+}
+
+template< typename TAssociate >
+void
+FelzenszwalbDistanceMapImageFilterThreader< TAssociate >
+::ProcessTile( SizeValueType tile, TileBuffers & buffers )
+{
+  const unsigned int dimension = this->m_Pass;
+  const SizeType &   size = this->m_WorkRegion.GetSize();
+
+  // the tile is a block of adjacent lines along the first dimension
+  const SizeValueType numberOfBlocks = ( size[0] + TileWidth - 1 ) / TileWidth;
+  const SizeValueType block = tile % numberOfBlocks;
+  tile /= numberOfBlocks;
+
+  OffsetValueType base = static_cast< OffsetValueType >( block * TileWidth );
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    if ( d != dimension )
+      {
+      base += static_cast< OffsetValueType >( tile % size[d] ) * this->m_WorkStrides[d];
+      tile /= size[d];
+      }
+    }
+
+  const SizeValueType   width = std::min< SizeValueType >( TileWidth, size[0] - block * TileWidth );
+  const SizeValueType   length = size[dimension];
+  const OffsetValueType stride = this->m_WorkStrides[dimension];
+
+  // gather the lines, reading the image along the first dimension
+  OffsetValueType offset = base;
+  for ( SizeValueType k = 0; k < length; ++k, offset += stride )
+    {
+    for ( SizeValueType lane = 0; lane < width; ++lane )
+      {
+      buffers.m_Values[lane * length + k] = this->m_Values[offset + lane];
+      buffers.m_Labels[lane * length + k] = this->m_Labels[offset + lane];
+      }
+    }
+
+  for ( SizeValueType lane = 0; lane < width; ++lane )
+    {
+    this->LowerEnvelope( &buffers.m_Values[lane * length], &buffers.m_Labels[lane * length],
+                         &buffers.m_OutputValues[lane * length], &buffers.m_OutputLabels[lane * length],
+                         length, buffers );
+    }
+
+  // scatter them back
+  offset = base;
+  for ( SizeValueType k = 0; k < length; ++k, offset += stride )
+    {
+    for ( SizeValueType lane = 0; lane < width; ++lane )
+      {
+      this->m_Values[offset + lane] = buffers.m_OutputValues[lane * length + k];
+      this->m_Labels[offset + lane] = buffers.m_OutputLabels[lane * length + k];
+      }
+    }
+}
+
+template< typename TAssociate >
+void
+FelzenszwalbDistanceMapImageFilterThreader< TAssociate >
+::LowerEnvelope( const RealType * values, const VoronoiPixelType * labels,
+                 RealType * outputValues, VoronoiPixelType * outputLabels,
+                 SizeValueType length, TileBuffers & buffers ) const
+{
+  const RealType spacing2 = this->m_Spacing[this->m_Pass] * this->m_Spacing[this->m_Pass];
+  const RealType infinity = NumericTraits< RealType >::max();
+
+  OffsetValueType * vertices = &buffers.m_Vertices[0];
+  RealType *        boundaries = &buffers.m_Boundaries[0];
+
+  // The parabola rooted at v is values[v] + spacing2 * ( q - v )^2. The
+  // envelope is made of the parabolas of vertices[0..k], and the parabola
+  // of vertices[j] is the lowest on [boundaries[j], boundaries[j+1]].
+  OffsetValueType k = -1;
+  for ( OffsetValueType q = 0; q < static_cast< OffsetValueType >( length ); ++q )
+    {
+    if ( values[q] == infinity )
+      {
+      continue;
+      }
+    const RealType rq = static_cast< RealType >( q );
+    const RealType hq = values[q] + spacing2 * rq * rq;
+    RealType       boundary = -infinity;
+    while ( k >= 0 )
+      {
+      const RealType rv = static_cast< RealType >( vertices[k] );
+      boundary = ( hq - values[vertices[k]] - spacing2 * rv * rv ) / ( 2.0 * spacing2 * ( rq - rv ) );
+      if ( boundary > boundaries[k] )
+        {
+        break;
+        }
+      --k;
+      boundary = -infinity;
+      }
+    ++k;
+    vertices[k] = q;
+    boundaries[k] = boundary;
+    }
+
+  if ( k < 0 )
+    {
+    std::fill( outputValues, outputValues + length, infinity );
+    std::fill( outputLabels, outputLabels + length, NumericTraits< VoronoiPixelType >::ZeroValue() );
+    return;
+    }
+
+  OffsetValueType j = 0;
+  for ( OffsetValueType q = 0; q < static_cast< OffsetValueType >( length ); ++q )
+    {
+    const RealType rq = static_cast< RealType >( q );
+    while ( j < k && boundaries[j + 1] < rq )
+      {
+      ++j;
+      }
+    const OffsetValueType v = vertices[j];
+    const RealType        distance = static_cast< RealType >( q - v );
+    outputValues[q] = values[v] + spacing2 * distance * distance;
+    outputLabels[q] = labels[v];
+    }
+}
+
+template< typename TAssociate >
+void
+FelzenszwalbDistanceMapImageFilterThreader< TAssociate >
+::WriteLine( SizeValueType line )
+{
+  const RegionType & region = this->m_DistanceMap->GetRequestedRegion();
+
+  IndexType index = region.GetIndex();
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    index[d] += static_cast< IndexValueType >( line % region.GetSize( d ) );
+    line /= region.GetSize( d );
+    }
+
+  const OffsetValueType    workOffset = this->ComputeWorkOffset( index );
+  const RealType *         values = &this->m_Values[workOffset];
+  const VoronoiPixelType * labels = &this->m_Labels[workOffset];
+  OutputPixelType *        distances =
+    this->m_DistanceMap->GetBufferPointer() + this->m_DistanceMap->ComputeOffset( index );
+  VoronoiPixelType *       voronoi =
+    this->m_VoronoiMap->GetBufferPointer() + this->m_VoronoiMap->ComputeOffset( index );
+
+  const SizeValueType length = region.GetSize( 0 );
+  for ( SizeValueType i = 0; i < length; ++i )
+    {
+    RealType value = values[i];
+    if ( !this->m_SquaredDistance && value != NumericTraits< RealType >::max() )
+      {
+      value = std::sqrt( value );
+      }
+    if ( value > this->m_MaximumDistance )
+      {
+      value = this->m_MaximumDistance;
+      voronoi[i] = NumericTraits< VoronoiPixelType >::ZeroValue();
+      }
+    else
+      {
+      voronoi[i] = labels[i];
+      }
+    distances[i] = static_cast< OutputPixelType >( std::min( value, this->m_OutputMaximum ) );
+    }
+}
+
+} // end namespace itk
+
+#endif
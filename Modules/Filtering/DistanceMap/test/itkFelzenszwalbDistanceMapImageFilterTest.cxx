@@ -0,0 +1,261 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFelzenszwalbDistanceMapImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingMacros.h"
+
+#include <vector>
+
+namespace
+{
+
+template< typename TImage >
+typename TImage::Pointer
+CreateFeatureImage( const typename TImage::SizeType & size, const typename TImage::SpacingType & spacing,
+                    double density )
+{
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 4357 );
+
+  typename TImage::Pointer image = TImage::New();
+  typename TImage::RegionType region;
+  region.SetSize( size );
+  image->SetRegions( region );
+  image->SetSpacing( spacing );
+  image->Allocate();
+
+  itk::ImageRegionIterator< TImage > it( image, region );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( generator->GetVariate() < density )
+      {
+      it.Set( 1 + generator->GetIntegerVariate( 4 ) );
+      }
+    else
+      {
+      it.Set( 0 );
+      }
+    }
+  return image;
+}
+
+// Check the distance map, and the Voronoi map if any, over the buffered
+// region of distanceMap against an exhaustive search of the nearest
+// features.
+template< typename TInputImage, typename TOutputImage >
+bool
+CheckDistanceMap( const TInputImage *input, const TOutputImage *distanceMap, const TInputImage *voronoiMap,
+                  const typename TInputImage::SpacingType & spacing, bool squared, double maximumDistance )
+{
+  typedef typename TInputImage::IndexType IndexType;
+  const unsigned int Dimension = TInputImage::ImageDimension;
+
+  std::vector< IndexType >                        features;
+  std::vector< typename TInputImage::PixelType >  labels;
+  itk::ImageRegionConstIteratorWithIndex< TInputImage > fit( input, input->GetLargestPossibleRegion() );
+  for ( fit.GoToBegin(); !fit.IsAtEnd(); ++fit )
+    {
+    if ( fit.Get() != 0 )
+      {
+      features.push_back( fit.GetIndex() );
+      labels.push_back( fit.Get() );
+      }
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< TOutputImage > it( distanceMap, distanceMap->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const IndexType index = it.GetIndex();
+
+    std::vector< double > distances( features.size() );
+    double                minimum = itk::NumericTraits< double >::max();
+    for ( size_t f = 0; f < features.size(); ++f )
+      {
+      distances[f] = 0.0;
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        const double delta = ( index[d] - features[f][d] ) * spacing[d];
+        distances[f] += delta * delta;
+        }
+      minimum = std::min( minimum, distances[f] );
+      }
+
+    double expected = squared ? minimum : std::sqrt( minimum );
+    const double limit = squared ? maximumDistance * maximumDistance : maximumDistance;
+    const bool   beyond = expected > limit;
+    if ( beyond )
+      {
+      expected = limit;
+      }
+
+    if ( std::fabs( it.Get() - expected ) > 1e-4 * ( 1.0 + expected ) )
+      {
+      std::cerr << "Wrong distance at " << index << ": " << it.Get() << " instead of " << expected << std::endl;
+      return false;
+      }
+
+    if ( !voronoiMap )
+      {
+      continue;
+      }
+    const typename TInputImage::PixelType label = voronoiMap->GetPixel( index );
+    bool validLabel = false;
+    if ( beyond )
+      {
+      validLabel = ( label == 0 );
+      }
+    else
+      {
+      for ( size_t f = 0; f < features.size(); ++f )
+        {
+        if ( labels[f] == label && distances[f] <= minimum * ( 1.0 + 1e-9 ) )
+          {
+          validLabel = true;
+          }
+        }
+      }
+    if ( !validLabel )
+      {
+      std::cerr << "Wrong Voronoi label at " << index << ": " << static_cast< int >( label ) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+template< unsigned int VDimension >
+bool
+TestFelzenszwalbDistanceMap( const itk::Size< VDimension > & size, const itk::Vector< double, VDimension > & spacing )
+{
+  typedef itk::Image< unsigned char, VDimension > InputImageType;
+  typedef itk::Image< float, VDimension >         OutputImageType;
+  typedef itk::FelzenszwalbDistanceMapImageFilter< InputImageType, OutputImageType > FilterType;
+
+  typename InputImageType::SpacingType imageSpacing;
+  typename InputImageType::SpacingType unitSpacing;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    imageSpacing[d] = spacing[d];
+    unitSpacing[d] = 1.0;
+    }
+  typename InputImageType::Pointer input = CreateFeatureImage< InputImageType >( size, imageSpacing, 0.02 );
+
+  // the whole image, with any number of threads
+  const itk::ThreadIdType threads[] = { 1, 2, 3, 5 };
+  for ( unsigned int t = 0; t < 4; ++t )
+    {
+    for ( unsigned int squared = 0; squared < 2; ++squared )
+      {
+      for ( unsigned int useSpacing = 0; useSpacing < 2; ++useSpacing )
+        {
+        typename FilterType::Pointer filter = FilterType::New();
+        filter->SetInput( input );
+        filter->SetNumberOfThreads( threads[t] );
+        filter->SetSquaredDistance( squared != 0 );
+        filter->SetUseImageSpacing( useSpacing != 0 );
+        TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+        if ( !CheckDistanceMap( input.GetPointer(), filter->GetDistanceMap(), filter->GetVoronoiMap(),
+                                useSpacing ? imageSpacing : unitSpacing, squared != 0,
+                                itk::NumericTraits< double >::max() ) )
+          {
+          std::cerr << "Failed with " << threads[t] << " threads, SquaredDistance " << squared
+                    << ", UseImageSpacing " << useSpacing << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+
+  // streamed with a maximum distance
+  const double maximumDistance = 2.5;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( input );
+  filter->SetMaximumDistance( maximumDistance );
+  TEST_SET_GET_VALUE( maximumDistance, filter->GetMaximumDistance() );
+
+  typedef itk::StreamingImageFilter< OutputImageType, OutputImageType > StreamingFilterType;
+  typename StreamingFilterType::Pointer streamer = StreamingFilterType::New();
+  streamer->SetInput( filter->GetDistanceMap() );
+  streamer->SetNumberOfStreamDivisions( 4 );
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+
+  if ( filter->GetInput()->GetRequestedRegion() == input->GetLargestPossibleRegion() )
+    {
+    std::cerr << "The streamed filter requested the whole input" << std::endl;
+    return false;
+    }
+
+  // the Voronoi map of the last streamed chunk
+  if ( !CheckDistanceMap( input.GetPointer(), filter->GetDistanceMap(), filter->GetVoronoiMap(),
+                          imageSpacing, false, maximumDistance ) )
+    {
+    std::cerr << "Failed in the last streamed chunk" << std::endl;
+    return false;
+    }
+  if ( !CheckDistanceMap( input.GetPointer(), streamer->GetOutput(), static_cast< InputImageType * >( ITK_NULLPTR ),
+                          imageSpacing, false, maximumDistance ) )
+    {
+    std::cerr << "Failed in the streamed output" << std::endl;
+    return false;
+    }
+
+  return true;
+}
+
+}
+
+int itkFelzenszwalbDistanceMapImageFilterTest( int, char* [] )
+{
+  typedef itk::Image< unsigned char, 2 >                                  ImageType;
+  typedef itk::FelzenszwalbDistanceMapImageFilter< ImageType, ImageType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, FelzenszwalbDistanceMapImageFilter, ImageToImageFilter );
+
+  filter->SquaredDistanceOn();
+  TEST_SET_GET_VALUE( true, filter->GetSquaredDistance() );
+  filter->UseImageSpacingOff();
+  TEST_SET_GET_VALUE( false, filter->GetUseImageSpacing() );
+
+  itk::Size< 2 >            size2D = {{ 37, 29 }};
+  itk::Vector< double, 2 >  spacing2D;
+  spacing2D[0] = 0.7;
+  spacing2D[1] = 1.3;
+  if ( !TestFelzenszwalbDistanceMap< 2 >( size2D, spacing2D ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  itk::Size< 3 >            size3D = {{ 19, 13, 11 }};
+  itk::Vector< double, 3 >  spacing3D;
+  spacing3D[0] = 1.0;
+  spacing3D[1] = 0.5;
+  spacing3D[2] = 2.0;
+  if ( !TestFelzenszwalbDistanceMap< 3 >( size3D, spacing3D ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -348,15 +348,138 @@ public:
   }
 
 
+  /** Return a plan from the plan cache of FFTWGlobalConfiguration, or
+   * create it and add it to the cache. \c cached is set to false when
+   * plan caching is disabled. A cached plan may be run by several filters
+   * at once: it must be run with the Execute overloads taking the arrays.
+   * The plan must be given back with ReleasePlan(). */
+  static PlanType Plan_dft_c2r_cached(int rank,
+                                      const int *n,
+                                      ComplexType *in,
+                                      PixelType *out,
+                                      unsigned flags,
+                                      bool & cached,
+                                      int threads=1,
+                                      bool canDestroyInput=false)
+  {
+    const FFTWGlobalConfiguration::PlanKeyType key =
+      MakePlanKey(0, rank, n, 0, flags, threads, fftwf_alignment_of((PixelType *)in),
+                  fftwf_alignment_of(out), (void *)in == (void *)out);
+    PlanType plan;
+    if( FFTWGlobalConfiguration::AcquireCachedPlan(key, plan) )
+      {
+      cached = true;
+      return plan;
+      }
+    plan = Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput);
+    return FFTWGlobalConfiguration::CachePlan(key, plan, cached);
+  }
+
+  static PlanType Plan_dft_r2c_cached(int rank,
+                                      const int *n,
+                                      PixelType *in,
+                                      ComplexType *out,
+                                      unsigned flags,
+                                      bool & cached,
+                                      int threads=1,
+                                      bool canDestroyInput=false)
+  {
+    const FFTWGlobalConfiguration::PlanKeyType key =
+      MakePlanKey(1, rank, n, 0, flags, threads, fftwf_alignment_of(in),
+                  fftwf_alignment_of((PixelType *)out), (void *)in == (void *)out);
+    PlanType plan;
+    if( FFTWGlobalConfiguration::AcquireCachedPlan(key, plan) )
+      {
+      cached = true;
+      return plan;
+      }
+    plan = Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput);
+    return FFTWGlobalConfiguration::CachePlan(key, plan, cached);
+  }
+
+  static PlanType Plan_dft_cached(int rank,
+                                  const int *n,
+                                  ComplexType *in,
+                                  ComplexType *out,
+                                  int sign,
+                                  unsigned flags,
+                                  bool & cached,
+                                  int threads=1,
+                                  bool canDestroyInput=false)
+  {
+    const FFTWGlobalConfiguration::PlanKeyType key =
+      MakePlanKey(2, rank, n, sign, flags, threads, fftwf_alignment_of((PixelType *)in),
+                  fftwf_alignment_of((PixelType *)out), in == out);
+    PlanType plan;
+    if( FFTWGlobalConfiguration::AcquireCachedPlan(key, plan) )
+      {
+      cached = true;
+      return plan;
+      }
+    plan = Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput);
+    return FFTWGlobalConfiguration::CachePlan(key, plan, cached);
+  }
+
   static void Execute(PlanType p)
   {
     fftwf_execute(p);
   }
+  /** Run a plan on new arrays, with the same alignment and in-placeness
+   * as the ones used to create the plan. */
+  static void Execute(PlanType p, ComplexType *in, PixelType *out)
+  {
+    fftwf_execute_dft_c2r(p, in, out);
+  }
+  static void Execute(PlanType p, PixelType *in, ComplexType *out)
+  {
+    fftwf_execute_dft_r2c(p, in, out);
+  }
+  static void Execute(PlanType p, ComplexType *in, ComplexType *out)
+  {
+    fftwf_execute_dft(p, in, out);
+  }
   static void DestroyPlan(PlanType p)
   {
     MutexLockHolder< FFTWGlobalConfiguration::MutexType > lock( FFTWGlobalConfiguration::GetLockMutex() );
     fftwf_destroy_plan(p);
   }
+  /** Give back a plan returned by one of the cached planning methods */
+  static void ReleasePlan(PlanType p, bool cached)
+  {
+    if( cached )
+      {
+      FFTWGlobalConfiguration::ReleaseCachedPlan(p);
+      }
+    else
+      {
+      DestroyPlan(p);
+      }
+  }
+
+private:
+  static FFTWGlobalConfiguration::PlanKeyType MakePlanKey(int kind,
+                                                          int rank,
+                                                          const int *n,
+                                                          int sign,
+                                                          unsigned flags,
+                                                          int threads,
+                                                          int inAlignment,
+                                                          int outAlignment,
+                                                          bool inPlace)
+  {
+    FFTWGlobalConfiguration::PlanKeyType key;
+    key.reserve(rank + 7);
+    key.push_back(kind);
+    key.push_back(rank);
+    key.insert(key.end(), n, n + rank);
+    key.push_back(sign);
+    key.push_back(static_cast< int >( flags ));
+    key.push_back(threads);
+    key.push_back(inAlignment);
+    key.push_back(outAlignment);
+    key.push_back(inPlace);
+    return key;
+  }
 };
 
 #endif // ITK_USE_FFTWF
@@ -651,15 +774,138 @@ public:
   }
 
 
+  /** Return a plan from the plan cache of FFTWGlobalConfiguration, or
+   * create it and add it to the cache. \c cached is set to false when
+   * plan caching is disabled. A cached plan may be run by several filters
+   * at once: it must be run with the Execute overloads taking the arrays.
+   * The plan must be given back with ReleasePlan(). */
+  static PlanType Plan_dft_c2r_cached(int rank,
+                                      const int *n,
+                                      ComplexType *in,
+                                      PixelType *out,
+                                      unsigned flags,
+                                      bool & cached,
+                                      int threads=1,
+                                      bool canDestroyInput=false)
+  {
+    const FFTWGlobalConfiguration::PlanKeyType key =
+      MakePlanKey(0, rank, n, 0, flags, threads, fftw_alignment_of((PixelType *)in),
+                  fftw_alignment_of(out), (void *)in == (void *)out);
+    PlanType plan;
+    if( FFTWGlobalConfiguration::AcquireCachedPlan(key, plan) )
+      {
+      cached = true;
+      return plan;
+      }
+    plan = Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput);
+    return FFTWGlobalConfiguration::CachePlan(key, plan, cached);
+  }
+
+  static PlanType Plan_dft_r2c_cached(int rank,
+                                      const int *n,
+                                      PixelType *in,
+                                      ComplexType *out,
+                                      unsigned flags,
+                                      bool & cached,
+                                      int threads=1,
+                                      bool canDestroyInput=false)
+  {
+    const FFTWGlobalConfiguration::PlanKeyType key =
+      MakePlanKey(1, rank, n, 0, flags, threads, fftw_alignment_of(in),
+                  fftw_alignment_of((PixelType *)out), (void *)in == (void *)out);
+    PlanType plan;
+    if( FFTWGlobalConfiguration::AcquireCachedPlan(key, plan) )
+      {
+      cached = true;
+      return plan;
+      }
+    plan = Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput);
+    return FFTWGlobalConfiguration::CachePlan(key, plan, cached);
+  }
+
+  static PlanType Plan_dft_cached(int rank,
+                                  const int *n,
+                                  ComplexType *in,
+                                  ComplexType *out,
+                                  int sign,
+                                  unsigned flags,
+                                  bool & cached,
+                                  int threads=1,
+                                  bool canDestroyInput=false)
+  {
+    const FFTWGlobalConfiguration::PlanKeyType key =
+      MakePlanKey(2, rank, n, sign, flags, threads, fftw_alignment_of((PixelType *)in),
+                  fftw_alignment_of((PixelType *)out), in == out);
+    PlanType plan;
+    if( FFTWGlobalConfiguration::AcquireCachedPlan(key, plan) )
+      {
+      cached = true;
+      return plan;
+      }
+    plan = Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput);
+    return FFTWGlobalConfiguration::CachePlan(key, plan, cached);
+  }
+
   static void Execute(PlanType p)
   {
     fftw_execute(p);
   }
+  /** Run a plan on new arrays, with the same alignment and in-placeness
+   * as the ones used to create the plan. */
+  static void Execute(PlanType p, ComplexType *in, PixelType *out)
+  {
+    fftw_execute_dft_c2r(p, in, out);
+  }
+  static void Execute(PlanType p, PixelType *in, ComplexType *out)
+  {
+    fftw_execute_dft_r2c(p, in, out);
+  }
+  static void Execute(PlanType p, ComplexType *in, ComplexType *out)
+  {
+    fftw_execute_dft(p, in, out);
+  }
   static void DestroyPlan(PlanType p)
   {
     MutexLockHolder< FFTWGlobalConfiguration::MutexType > lock( FFTWGlobalConfiguration::GetLockMutex() );
     fftw_destroy_plan(p);
   }
+  /** Give back a plan returned by one of the cached planning methods */
+  static void ReleasePlan(PlanType p, bool cached)
+  {
+    if( cached )
+      {
+      FFTWGlobalConfiguration::ReleaseCachedPlan(p);
+      }
+    else
+      {
+      DestroyPlan(p);
+      }
+  }
+
+private:
+  static FFTWGlobalConfiguration::PlanKeyType MakePlanKey(int kind,
+                                                          int rank,
+                                                          const int *n,
+                                                          int sign,
+                                                          unsigned flags,
+                                                          int threads,
+                                                          int inAlignment,
+                                                          int outAlignment,
+                                                          bool inPlace)
+  {
+    FFTWGlobalConfiguration::PlanKeyType key;
+    key.reserve(rank + 7);
+    key.push_back(kind);
+    key.push_back(rank);
+    key.insert(key.end(), n, n + rank);
+    key.push_back(sign);
+    key.push_back(static_cast< int >( flags ));
+    key.push_back(threads);
+    key.push_back(inAlignment);
+    key.push_back(outAlignment);
+    key.push_back(inPlace);
+    return key;
+  }
 };
 
 #endif
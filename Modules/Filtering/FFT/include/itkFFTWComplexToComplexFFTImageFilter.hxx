@@ -94,16 +94,18 @@ FFTWComplexToComplexFFTImageFilter< TImage >
     sizes[(ImageDimension - 1) - i] = inputSize[i];
     }
 
-  plan = FFTWProxyType::Plan_dft(ImageDimension,sizes,
-                                    in,
-                                    out,
-                                    transformDirection,
-                                    flags,
-                                    this->GetNumberOfThreads());
+  bool cached;
+  plan = FFTWProxyType::Plan_dft_cached(ImageDimension,sizes,
+                                        in,
+                                        out,
+                                        transformDirection,
+                                        flags,
+                                        cached,
+                                        this->GetNumberOfThreads());
   delete[] sizes;
 
-  FFTWProxyType::Execute(plan);
-  FFTWProxyType::DestroyPlan(plan);
+  FFTWProxyType::Execute(plan, in, out);
+  FFTWProxyType::ReleasePlan(plan, cached);
 }
 
 
@@ -110,13 +110,14 @@ FFTWForwardFFTImageFilter< TInputImage, TOutputImage >
     sizes[(ImageDimension - 1) - i] = inputSize[i];
     }
 
-  plan = FFTWProxyType::Plan_dft_r2c(ImageDimension, sizes, in,
-                                     (typename FFTWProxyType::ComplexType*)
-                                     fftwOutput->GetBufferPointer(), flags,
-                                     this->GetNumberOfThreads());
+  typename FFTWProxyType::ComplexType * out =
+    (typename FFTWProxyType::ComplexType*) fftwOutput->GetBufferPointer();
+  bool cached;
+  plan = FFTWProxyType::Plan_dft_r2c_cached(ImageDimension, sizes, in, out, flags,
+                                           cached, this->GetNumberOfThreads());
   delete[] sizes;
-  FFTWProxyType::Execute(plan);
-  FFTWProxyType::DestroyPlan(plan);
+  FFTWProxyType::Execute(plan, in, out);
+  FFTWProxyType::ReleasePlan(plan, cached);
 
   // Expand the half image to the full image size
   typedef HalfToFullHermitianImageFilter< OutputImageType > HalfToFullFilterType;
@@ -31,6 +31,8 @@
 #include "fftw3.h"
 #include <algorithm>
 #include <cctype>
+#include <map>
+#include <vector>
 
 //* The fftw utilities help control the various strategies
 //available for controlling optimizations for the FFTW library.
@@ -50,6 +52,8 @@
 //                             file to be generated.  If this is
 //                             set, then ITK_FFTW_WISDOM_CACHE_BASE
 //                             is ignored.
+//ITK_FFTW_PLAN_CACHE - Defines if the plans are kept in a cache and
+//                      reused (it is "On" by default)
 //
 // The above behaviors can also be controlled by the application.
 //
@@ -280,6 +284,58 @@ public:
   static bool ImportDefaultWisdomFileFloat();
   static bool ExportDefaultWisdomFileFloat();
 
+  /** Key of a plan in the plan cache. It encodes the kind of transform,
+   * its rank and sizes, the planner flags, the number of threads, the
+   * alignment of the arrays and whether the transform is in place. */
+  typedef std::vector< int > PlanKeyType;
+
+  /**
+   * \brief Set/Get whether the plans are cached.
+   *
+   * When enabled (the default), the FFTW filters keep their plans in a
+   * process wide cache and run them again on new arrays with the same
+   * key, instead of planning and destroying a plan at each update.
+   * If the environmental variable "ITK_FFTW_PLAN_CACHE" is set, then the
+   * environmental setting overides the default setting.
+   * Disabling the caching clears the cache.
+   */
+  static void SetPlanCaching( const bool & v );
+  static bool GetPlanCaching();
+
+  /**
+   * \brief Set/Get the maximum number of plans of each precision in the
+   * cache.
+   *
+   * When a new plan would exceed this number, the least recently used
+   * plans are removed from the cache. The default is 16.
+   */
+  static void SetPlanCacheSize( const SizeValueType & v );
+  static SizeValueType GetPlanCacheSize();
+
+  /** Remove all the plans from the cache. The plans that are being run
+   * are destroyed when they are released. */
+  static void ClearPlanCache();
+
+  /** Acquire a plan from the cache, or add a new plan to the cache. An
+   * acquired or added plan can be run concurrently with the new-array
+   * execute functions, and must be given back with ReleaseCachedPlan(),
+   * which destroys it if it has been removed from the cache in the
+   * meantime. CachePlan() takes the ownership of the plan and returns the
+   * plan to run, which is an equivalent cached plan if there is one. It
+   * sets \c cached to false, and returns the plan unchanged, if the plans
+   * are not cached: the plan must then be destroyed by the caller. These
+   * methods lock the lock mutex. */
+#if defined(ITK_USE_FFTWF)
+  static bool AcquireCachedPlan( const PlanKeyType & key, fftwf_plan & plan );
+  static fftwf_plan CachePlan( const PlanKeyType & key, fftwf_plan plan, bool & cached );
+  static void ReleaseCachedPlan( fftwf_plan plan );
+#endif
+#if defined(ITK_USE_FFTWD)
+  static bool AcquireCachedPlan( const PlanKeyType & key, fftw_plan & plan );
+  static fftw_plan CachePlan( const PlanKeyType & key, fftw_plan plan, bool & cached );
+  static void ReleaseCachedPlan( fftw_plan plan );
+#endif
+
 private:
   FFTWGlobalConfiguration(); //This will process env variables
   ~FFTWGlobalConfiguration(); //This will write cache file if requested.
@@ -287,6 +343,34 @@ private:
   /** Return the singleton instance with no reference counting. */
   static Pointer GetInstance();
 
+  /** A plan of the cache, with the number of its current users and the
+   * time of its last use */
+  template< typename TPlan >
+  struct CachedPlanType
+    {
+    TPlan         m_Plan;
+    SizeValueType m_Users;
+    SizeValueType m_LastUse;
+    };
+
+  /** The plans of one precision: the cache, and the plans removed from
+   * the cache while they were in use, destroyed by their last user. */
+  template< typename TPlan >
+  struct PlanCacheType
+    {
+    typedef std::map< PlanKeyType, CachedPlanType< TPlan > > MapType;
+    MapType                               m_Plans;
+    std::vector< CachedPlanType< TPlan > > m_RemovedPlans;
+    };
+
+  /** Remove the plans from the caches, without locking. With \c all false,
+   * only the least recently used plans exceeding the cache size are
+   * removed. */
+  void RemoveCachedPlans( bool all );
+
+  /** Destroy all the plans, without locking. */
+  void DestroyCachedPlans();
+
   /** This is a singleton pattern New.  There will only be ONE
    * reference to a FFTWGlobalConfiguration object per process.
    * The single instance will be unreferenced when
@@ -305,6 +389,15 @@ private:
   bool                          m_WriteWisdomCache;
   bool                          m_ReadWisdomCache;
   std::string                   m_WisdomCacheBase;
+  bool                          m_PlanCaching;
+  SizeValueType                 m_PlanCacheSize;
+  SizeValueType                 m_PlanCacheTime;
+#if defined(ITK_USE_FFTWF)
+  PlanCacheType< fftwf_plan >   m_FloatPlanCache;
+#endif
+#if defined(ITK_USE_FFTWD)
+  PlanCacheType< fftw_plan >    m_DoublePlanCache;
+#endif
   //m_WriteWisdomCache Controls the behavior of default
   //wisdom file creation policies.
   WisdomFilenameGeneratorBase * m_WisdomFilenameGenerator;
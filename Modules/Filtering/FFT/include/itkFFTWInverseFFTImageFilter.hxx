@@ -92,12 +92,13 @@ FFTWInverseFFTImageFilter< TInputImage, TOutputImage >
     sizes[(ImageDimension - 1) - i] = outputSize[i];
     }
 
-  plan = FFTWProxyType::Plan_dft_c2r( ImageDimension, sizes, in, out, m_PlanRigor,
-                                      this->GetNumberOfThreads(), false );
-  FFTWProxyType::Execute( plan );
+  bool cached;
+  plan = FFTWProxyType::Plan_dft_c2r_cached( ImageDimension, sizes, in, out, m_PlanRigor,
+                                             cached, this->GetNumberOfThreads(), false );
+  FFTWProxyType::Execute( plan, in, out );
 
   // Some cleanup.
-  FFTWProxyType::DestroyPlan( plan );
+  FFTWProxyType::ReleasePlan( plan, cached );
 }
 
 template <typename TInputImage, typename TOutputImage>
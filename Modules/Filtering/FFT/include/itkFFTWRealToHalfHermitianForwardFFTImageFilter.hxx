@@ -93,11 +93,12 @@ FFTWRealToHalfHermitianForwardFFTImageFilter< TInputImage, TOutputImage >
     sizes[(ImageDimension - 1) - i] = inputSize[i];
     }
 
-  plan = FFTWProxyType::Plan_dft_r2c(ImageDimension, sizes, in, out, flags,
-                                    this->GetNumberOfThreads());
+  bool cached;
+  plan = FFTWProxyType::Plan_dft_r2c_cached(ImageDimension, sizes, in, out, flags,
+                                           cached, this->GetNumberOfThreads());
   delete[] sizes;
-  FFTWProxyType::Execute(plan);
-  FFTWProxyType::DestroyPlan(plan);
+  FFTWProxyType::Execute(plan, in, out);
+  FFTWProxyType::ReleasePlan(plan, cached);
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -26,7 +26,9 @@ namespace itk
  *
  * \brief VNL based complex to complex Fast Fourier Transform.
  *
- * This filter requires input images with sizes which are a power of two.
+ * Sizes whose prime factorization consists of 2s, 3s and 5s are
+ * transformed directly; other sizes use Bluestein's algorithm and are
+ * slower. The transform is multithreaded over blocks of lines.
  *
  * \ingroup FourierTransform
  * \ingroup ITKFFT
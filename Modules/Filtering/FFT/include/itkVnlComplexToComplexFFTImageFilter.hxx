@@ -46,17 +46,6 @@ VnlComplexToComplexFFTImageFilter< TImage >
   const typename ImageType::RegionType bufferedRegion = input->GetBufferedRegion();
   const typename ImageType::SizeType & imageSize = bufferedRegion.GetSize();
 
-  for( unsigned int ii = 0; ii < ImageDimension; ++ii )
-    {
-    if ( !VnlFFTCommon::IsDimensionSizeLegal( imageSize[ii] ) )
-      {
-      itkExceptionMacro(<< "Cannot compute FFT of image with size "
-                        << imageSize << ". VnlComplexToComplexFFTImageFilter operates "
-                        << "only on images whose size in each dimension is a multiple of "
-                        << "2, 3, or 5." );
-      }
-    }
-
   // Copy the input to the output, and we will work in place on the output.
   ImageAlgorithm::Copy< ImageType, ImageType >( input, output, bufferedRegion, bufferedRegion );
 
@@ -67,11 +56,11 @@ VnlComplexToComplexFFTImageFilter< TImage >
   VnlFFTCommon::VnlFFTTransform< Image< typename PixelType::value_type , ImageDimension > > vnlfft( imageSize );
   if ( this->GetTransformDirection() == Superclass::INVERSE )
     {
-    vnlfft.transform( outputBuffer, 1 );
+    vnlfft.transform( outputBuffer, 1, this->GetNumberOfThreads() );
     }
   else
     {
-    vnlfft.transform( outputBuffer, -1 );
+    vnlfft.transform( outputBuffer, -1, this->GetNumberOfThreads() );
     }
 }
 
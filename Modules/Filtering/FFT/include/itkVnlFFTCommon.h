@@ -19,8 +19,11 @@
 #define itkVnlFFTCommon_h
 
 #include "itkIntTypes.h"
+#include "itkMultiThreader.h"
 
-#include "vnl/algo/vnl_fft_base.h"
+#include "vnl/algo/vnl_fft_prime_factors.h"
+#include <complex>
+#include <vector>
 
 namespace itk
 {
@@ -33,23 +36,113 @@ namespace itk
 struct VnlFFTCommon
 {
 
-  /** Vnl's FFT supports discrete Fourier transforms for images whose
-  sizes have a prime factorization consisting of 2's, 3's, and 5's. */
+  /** Vnl's FFT routines compute discrete Fourier transforms of sizes
+  whose prime factorization consists of 2's, 3's, and 5's. The other
+  sizes are computed with Bluestein's algorithm, which is a few times
+  slower. */
   template< typename TSizeValue >
   static bool IsDimensionSizeLegal(TSizeValue n);
 
+  /** Sizes with prime factors up to GREATEST_PRIME_FACTOR are computed
+  with the fastest algorithm. */
   static ITK_CONSTEXPR SizeValueType GREATEST_PRIME_FACTOR = 5;
 
+  /** \class VnlFFTLineTransform
+   * \brief Unnormalized discrete Fourier transform of lines of a given
+   * length.
+   *
+   * The lines are stored one after the other in a buffer, every
+   * GetBufferLength() samples, and are transformed in place. Lengths
+   * whose prime factors are 2, 3 and 5 use Vnl's GPFA routine directly.
+   * The other lengths use Bluestein's algorithm: the transform is
+   * rewritten as a convolution with a chirp, computed with transforms of
+   * a legal length at least twice as large.
+   *
+   * \ingroup ITKFFT
+   */
+  template< typename TReal >
+  class VnlFFTLineTransform
+  {
+  public:
+    typedef std::complex< TReal > ComplexType;
+
+    explicit VnlFFTLineTransform(SizeValueType length);
+    ~VnlFFTLineTransform();
+
+    SizeValueType GetLength() const { return m_Length; }
+
+    /** Distance between two lines in the buffer given to Transform(). */
+    SizeValueType GetBufferLength() const { return m_BufferLength; }
+
+    /** Transform \c numberOfLines lines in place. \c direction is -1 for
+     * the forward transform and +1 for the backward one. */
+    void Transform(ComplexType *lines, SizeValueType numberOfLines, int direction) const;
+
+  private:
+    VnlFFTLineTransform(const VnlFFTLineTransform &) ITK_DELETE_FUNCTION;
+    void operator=(const VnlFFTLineTransform &) ITK_DELETE_FUNCTION;
+
+    void TransformLegal(ComplexType *lines, SizeValueType numberOfLines, int direction) const;
+
+    SizeValueType                       m_Length;
+    SizeValueType                       m_BufferLength;
+    vnl_fft_prime_factors< TReal > *    m_Factors;
+    bool                                m_Bluestein;
+    // exp(-i pi k^2 / n), the chirp of the forward transform
+    std::vector< ComplexType >          m_Chirp;
+    // transforms of the conjugated chirps, divided by the buffer length
+    std::vector< ComplexType >          m_ForwardKernel;
+    std::vector< ComplexType >          m_BackwardKernel;
+  };
+
   /** Convenience struct for computing the discrete Fourier
-  Transform. */
+  Transform of an image of any size.
+
+  The one dimensional transforms along each dimension are computed in
+  parallel, by blocks of neighbor lines. The lines of a block are gathered
+  in a contiguous buffer, transformed together and scattered back, so that
+  both the image and the buffer are accessed by contiguous runs. */
   template< typename TImage >
-  struct VnlFFTTransform:
-    public vnl_fft_base< TImage::ImageDimension, typename TImage::PixelType >
+  struct VnlFFTTransform
   {
-    typedef vnl_fft_base< TImage::ImageDimension, typename TImage::PixelType > Base;
+    typedef typename TImage::PixelType               RealType;
+    typedef std::complex< RealType >                 ComplexType;
+    typedef VnlFFTLineTransform< RealType >          LineTransformType;
 
     //: constructor takes size of signal.
     VnlFFTTransform(const typename TImage::SizeType & s);
+    ~VnlFFTTransform();
+
+    /** Transform \c signal in place. \c direction is -1 for the forward
+     * transform and +1 for the backward one, which is not normalized. */
+    void transform(ComplexType *signal, int direction, ThreadIdType numberOfThreads = 1);
+
+  private:
+    VnlFFTTransform(const VnlFFTTransform &) ITK_DELETE_FUNCTION;
+    void operator=(const VnlFFTTransform &) ITK_DELETE_FUNCTION;
+
+    /** Number of neighbor lines transformed together. */
+    static ITK_CONSTEXPR SizeValueType BlockSize = 16;
+
+    struct ThreadStruct
+    {
+      VnlFFTTransform * Transform;
+      ComplexType *     Signal;
+      int               Direction;
+      unsigned int      Dimension;
+    };
+
+    static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
+
+    /** Number of blocks of lines along \c dimension. */
+    SizeValueType GetNumberOfBlocks(unsigned int dimension) const;
+
+    /** Transform the blocks [begin, end) along \c dimension. */
+    void TransformBlocks(ComplexType *signal, int direction, unsigned int dimension,
+                         SizeValueType begin, SizeValueType end) const;
+
+    typename TImage::SizeType          m_Size;
+    std::vector< LineTransformType * > m_LineTransforms;
   };
 
 };
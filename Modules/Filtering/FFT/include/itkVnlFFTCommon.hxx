@@ -19,6 +19,10 @@
 #define itkVnlFFTCommon_hxx
 
 #include "itkVnlFFTCommon.h"
+#include "itkMath.h"
+
+#include "vnl/algo/vnl_fft.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -41,13 +45,338 @@ VnlFFTCommon
   return ( n == 1 ); // return false if decomposition failed
 }
 
+template< typename TReal >
+VnlFFTCommon::VnlFFTLineTransform< TReal >
+::VnlFFTLineTransform(SizeValueType length) :
+  m_Length( length ),
+  m_BufferLength( length ),
+  m_Factors( ITK_NULLPTR ),
+  m_Bluestein( !IsDimensionSizeLegal( length ) )
+{
+  if ( !m_Bluestein )
+    {
+    m_Factors = new vnl_fft_prime_factors< TReal >( static_cast< int >( length ) );
+    return;
+    }
+
+  // Bluestein's algorithm: with jk = ( j^2 + k^2 - (j-k)^2 ) / 2, the
+  // transform is the chirp times the convolution of the input times the
+  // chirp with the conjugated chirp. The cyclic convolution is computed
+  // with a legal length large enough to avoid any wrap around.
+  m_BufferLength = 2 * length - 1;
+  while ( !IsDimensionSizeLegal( m_BufferLength ) )
+    {
+    ++m_BufferLength;
+    }
+  m_Factors = new vnl_fft_prime_factors< TReal >( static_cast< int >( m_BufferLength ) );
+
+  m_Chirp.resize( length );
+  for ( SizeValueType k = 0; k < length; ++k )
+    {
+    // k^2 modulo 2n keeps the angle accurate for large k
+    const double angle = Math::pi * static_cast< double >( ( k * k ) % ( 2 * length ) )
+                         / static_cast< double >( length );
+    m_Chirp[k] = ComplexType( static_cast< TReal >( std::cos( angle ) ),
+                              static_cast< TReal >( -std::sin( angle ) ) );
+    }
+
+  m_ForwardKernel.assign( m_BufferLength, ComplexType( 0 ) );
+  m_BackwardKernel.assign( m_BufferLength, ComplexType( 0 ) );
+  for ( SizeValueType k = 0; k < length; ++k )
+    {
+    m_ForwardKernel[k] = std::conj( m_Chirp[k] );
+    m_BackwardKernel[k] = m_Chirp[k];
+    if ( k != 0 )
+      {
+      m_ForwardKernel[m_BufferLength - k] = m_ForwardKernel[k];
+      m_BackwardKernel[m_BufferLength - k] = m_BackwardKernel[k];
+      }
+    }
+  this->TransformLegal( &m_ForwardKernel[0], 1, -1 );
+  this->TransformLegal( &m_BackwardKernel[0], 1, -1 );
+  const TReal scale = static_cast< TReal >( 1.0 / static_cast< double >( m_BufferLength ) );
+  for ( SizeValueType k = 0; k < m_BufferLength; ++k )
+    {
+    m_ForwardKernel[k] *= scale;
+    m_BackwardKernel[k] *= scale;
+    }
+}
+
+template< typename TReal >
+VnlFFTCommon::VnlFFTLineTransform< TReal >
+::~VnlFFTLineTransform()
+{
+  delete m_Factors;
+}
+
+template< typename TReal >
+void
+VnlFFTCommon::VnlFFTLineTransform< TReal >
+::TransformLegal(ComplexType *lines, SizeValueType numberOfLines, int direction) const
+{
+  // This relies on the assumption that std::complex<T> is layout
+  // compatible with "struct { T real; T imag; }".
+  TReal *data = reinterpret_cast< TReal * >( lines );
+  long info = 0;
+  vnl_fft_gpfa( /* A */     data,
+                /* B */     data + 1,
+                /* TRIGS */ m_Factors->trigs(),
+                /* INC */   2,
+                /* JUMP */  2 * static_cast< long >( m_BufferLength ),
+                /* N */     static_cast< long >( m_BufferLength ),
+                /* LOT */   static_cast< long >( numberOfLines ),
+                /* ISIGN */ direction,
+                /* NIPQ */  m_Factors->pqr(),
+                /* INFO */  &info );
+  itkAssertInDebugAndIgnoreInReleaseMacro( info != -1 );
+}
+
+template< typename TReal >
+void
+VnlFFTCommon::VnlFFTLineTransform< TReal >
+::Transform(ComplexType *lines, SizeValueType numberOfLines, int direction) const
+{
+  if ( !m_Bluestein )
+    {
+    this->TransformLegal( lines, numberOfLines, direction );
+    return;
+    }
+
+  // The backward transform uses the conjugated chirp.
+  const bool forward = ( direction < 0 );
+  const std::vector< ComplexType > & kernel = forward ? m_ForwardKernel : m_BackwardKernel;
+  for ( SizeValueType l = 0; l < numberOfLines; ++l )
+    {
+    ComplexType *line = lines + l * m_BufferLength;
+    for ( SizeValueType k = 0; k < m_Length; ++k )
+      {
+      line[k] *= forward ? m_Chirp[k] : std::conj( m_Chirp[k] );
+      }
+    std::fill( line + m_Length, line + m_BufferLength, ComplexType( 0 ) );
+    }
+  this->TransformLegal( lines, numberOfLines, -1 );
+  for ( SizeValueType l = 0; l < numberOfLines; ++l )
+    {
+    ComplexType *line = lines + l * m_BufferLength;
+    for ( SizeValueType k = 0; k < m_BufferLength; ++k )
+      {
+      line[k] *= kernel[k];
+      }
+    }
+  this->TransformLegal( lines, numberOfLines, 1 );
+  for ( SizeValueType l = 0; l < numberOfLines; ++l )
+    {
+    ComplexType *line = lines + l * m_BufferLength;
+    for ( SizeValueType k = 0; k < m_Length; ++k )
+      {
+      line[k] *= forward ? m_Chirp[k] : std::conj( m_Chirp[k] );
+      }
+    }
+}
+
 template< typename TImage >
 VnlFFTCommon::VnlFFTTransform< TImage >
-::VnlFFTTransform(const typename TImage::SizeType & s)
+::VnlFFTTransform(const typename TImage::SizeType & s) :
+  m_Size( s )
 {
+  m_LineTransforms.resize( TImage::ImageDimension, ITK_NULLPTR );
   for( unsigned int i=0; i < TImage::ImageDimension; i++ )
     {
-    Base::factors_[TImage::ImageDimension - i - 1].resize(s[i]);
+    // share the line transforms of the dimensions with the same size
+    for( unsigned int j=0; j < i; j++ )
+      {
+      if ( s[j] == s[i] )
+        {
+        m_LineTransforms[i] = m_LineTransforms[j];
+        break;
+        }
+      }
+    if ( !m_LineTransforms[i] )
+      {
+      m_LineTransforms[i] = new LineTransformType( s[i] );
+      }
+    }
+}
+
+template< typename TImage >
+VnlFFTCommon::VnlFFTTransform< TImage >
+::~VnlFFTTransform()
+{
+  for( unsigned int i=0; i < TImage::ImageDimension; i++ )
+    {
+    bool shared = false;
+    for( unsigned int j=0; j < i; j++ )
+      {
+      shared = shared || ( m_LineTransforms[j] == m_LineTransforms[i] );
+      }
+    if ( !shared )
+      {
+      delete m_LineTransforms[i];
+      }
+    }
+}
+
+template< typename TImage >
+SizeValueType
+VnlFFTCommon::VnlFFTTransform< TImage >
+::GetNumberOfBlocks(unsigned int dimension) const
+{
+  SizeValueType stride = 1;
+  SizeValueType outer = 1;
+  for( unsigned int i=0; i < TImage::ImageDimension; i++ )
+    {
+    if ( i < dimension )
+      {
+      stride *= m_Size[i];
+      }
+    else if ( i > dimension )
+      {
+      outer *= m_Size[i];
+      }
+    }
+  if ( dimension == 0 )
+    {
+    // the lines are contiguous, and grouped by blocks
+    return ( outer + BlockSize - 1 ) / BlockSize;
+    }
+  return outer * ( ( stride + BlockSize - 1 ) / BlockSize );
+}
+
+template< typename TImage >
+void
+VnlFFTCommon::VnlFFTTransform< TImage >
+::TransformBlocks(ComplexType *signal, int direction, unsigned int dimension,
+                  SizeValueType begin, SizeValueType end) const
+{
+  const LineTransformType * lineTransform = m_LineTransforms[dimension];
+  const SizeValueType length = m_Size[dimension];
+  const SizeValueType bufferLength = lineTransform->GetBufferLength();
+  const SizeValueType blockSize = BlockSize;
+
+  SizeValueType stride = 1;
+  SizeValueType outer = 1;
+  for( unsigned int i=0; i < TImage::ImageDimension; i++ )
+    {
+    if ( i < dimension )
+      {
+      stride *= m_Size[i];
+      }
+    else if ( i > dimension )
+      {
+      outer *= m_Size[i];
+      }
+    }
+
+  std::vector< ComplexType > buffer;
+  if ( dimension != 0 || bufferLength != length )
+    {
+    buffer.resize( blockSize * bufferLength );
+    }
+
+  if ( dimension == 0 )
+    {
+    for ( SizeValueType block = begin; block < end; ++block )
+      {
+      const SizeValueType first = block * blockSize;
+      const SizeValueType numberOfLines = std::min( blockSize, outer - first );
+      ComplexType *base = signal + first * length;
+      if ( bufferLength == length )
+        {
+        // The lines are contiguous in the image.
+        lineTransform->Transform( base, numberOfLines, direction );
+        continue;
+        }
+      for ( SizeValueType l = 0; l < numberOfLines; ++l )
+        {
+        std::copy( base + l * length, base + ( l + 1 ) * length, &buffer[l * bufferLength] );
+        }
+      lineTransform->Transform( &buffer[0], numberOfLines, direction );
+      for ( SizeValueType l = 0; l < numberOfLines; ++l )
+        {
+        std::copy( &buffer[l * bufferLength], &buffer[l * bufferLength] + length, base + l * length );
+        }
+      }
+    return;
+    }
+
+  const SizeValueType blocksPerSlab = ( stride + blockSize - 1 ) / blockSize;
+  for ( SizeValueType block = begin; block < end; ++block )
+    {
+    const SizeValueType slab = block / blocksPerSlab;
+    const SizeValueType first = ( block % blocksPerSlab ) * blockSize;
+    const SizeValueType numberOfLines = std::min( blockSize, stride - first );
+    ComplexType *base = signal + slab * length * stride + first;
+
+    // Gather the lines in the buffer: a blocked transpose, which reads the
+    // image by runs of numberOfLines contiguous samples.
+    for ( SizeValueType k = 0; k < length; ++k )
+      {
+      const ComplexType *in = base + k * stride;
+      for ( SizeValueType l = 0; l < numberOfLines; ++l )
+        {
+        buffer[l * bufferLength + k] = in[l];
+        }
+      }
+    lineTransform->Transform( &buffer[0], numberOfLines, direction );
+    for ( SizeValueType k = 0; k < length; ++k )
+      {
+      ComplexType *out = base + k * stride;
+      for ( SizeValueType l = 0; l < numberOfLines; ++l )
+        {
+        out[l] = buffer[l * bufferLength + k];
+        }
+      }
+    }
+}
+
+template< typename TImage >
+ITK_THREAD_RETURN_TYPE
+VnlFFTCommon::VnlFFTTransform< TImage >
+::ThreaderCallback(void *arg)
+{
+  const ThreadIdType threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+  const ThreadIdType threadCount = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->NumberOfThreads;
+  ThreadStruct *str = (ThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  const SizeValueType numberOfBlocks = str->Transform->GetNumberOfBlocks( str->Dimension );
+  const SizeValueType begin = numberOfBlocks * threadId / threadCount;
+  const SizeValueType end = numberOfBlocks * ( threadId + 1 ) / threadCount;
+  str->Transform->TransformBlocks( str->Signal, str->Direction, str->Dimension, begin, end );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TImage >
+void
+VnlFFTCommon::VnlFFTTransform< TImage >
+::transform(ComplexType *signal, int direction, ThreadIdType numberOfThreads)
+{
+  itkAssertInDebugAndIgnoreInReleaseMacro( direction == 1 || direction == -1 );
+
+  MultiThreader::Pointer threader;
+  ThreadStruct str;
+  str.Transform = this;
+  str.Signal = signal;
+  str.Direction = direction;
+
+  // transform along each dimension, i, in turn.
+  for( unsigned int i=0; i < TImage::ImageDimension; i++ )
+    {
+    const SizeValueType numberOfBlocks = this->GetNumberOfBlocks( i );
+    if ( numberOfThreads <= 1 || numberOfBlocks <= 1 )
+      {
+      this->TransformBlocks( signal, direction, i, 0, numberOfBlocks );
+      continue;
+      }
+    if ( threader.IsNull() )
+      {
+      threader = MultiThreader::New();
+      }
+    str.Dimension = i;
+    threader->SetNumberOfThreads( static_cast< ThreadIdType >(
+                                    std::min( static_cast< SizeValueType >( numberOfThreads ), numberOfBlocks ) ) );
+    threader->SetSingleMethod( ThreaderCallback, &str );
+    threader->SingleMethodExecute();
     }
 }
 
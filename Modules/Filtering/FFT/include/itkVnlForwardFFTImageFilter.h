@@ -27,8 +27,9 @@ namespace itk
  *
  * \brief VNL based forward Fast Fourier Transform.
  *
- * The input image size must be a multiple of combinations of 2s, 3s,
- * and/or 5s in all dimensions.
+ * Sizes whose prime factorization consists of 2s, 3s and 5s are
+ * transformed directly; other sizes use Bluestein's algorithm and are
+ * slower. The transform is multithreaded over blocks of lines.
  *
  * \ingroup FourierTransform
  *
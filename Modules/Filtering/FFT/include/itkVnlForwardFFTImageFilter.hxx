@@ -53,13 +53,6 @@ VnlForwardFFTImageFilter< TInputImage, TOutputImage >
   unsigned int vectorSize = 1;
   for ( unsigned int i = 0; i < ImageDimension; i++ )
     {
-    if ( !VnlFFTCommon::IsDimensionSizeLegal( inputSize[i] ) )
-      {
-      itkExceptionMacro(<< "Cannot compute FFT of image with size "
-                        << inputSize << ". VnlForwardFFTImageFilter operates "
-                        << "only on images whose size in each dimension is a multiple of "
-                        << "2, 3, or 5." );
-      }
     vectorSize *= inputSize[i];
     }
 
@@ -72,7 +65,7 @@ VnlForwardFFTImageFilter< TInputImage, TOutputImage >
 
   // call the proper transform, based on compile type template parameter
   VnlFFTCommon::VnlFFTTransform< InputImageType > vnlfft( inputSize );
-  vnlfft.transform( signal.data_block(), -1 );
+  vnlfft.transform( signal.data_block(), -1, this->GetNumberOfThreads() );
 
   // Copy the VNL output back to the ITK image.
   ImageRegionIteratorWithIndex< TOutputImage > oIt( outputPtr,
@@ -56,13 +56,6 @@ VnlHalfHermitianToRealInverseFFTImageFilter< TInputImage, TOutputImage >
   unsigned int vectorSize = 1;
   for ( unsigned int i = 0; i < ImageDimension; i++ )
     {
-    if ( !VnlFFTCommon::IsDimensionSizeLegal( outputSize[i] ) )
-      {
-      itkExceptionMacro(<< "Cannot compute FFT of image with size "
-                        << outputSize << ". VnlHalfHermitianToRealInverseFFTImageFilter operates "
-                        << "only on images whose size in each dimension is a multiple of "
-                        << "2, 3, or 5." );
-      }
     vectorSize *= outputSize[i];
     }
 
@@ -101,7 +94,7 @@ VnlHalfHermitianToRealInverseFFTImageFilter< TInputImage, TOutputImage >
 
   // call the proper transform, based on compile type template parameter
   VnlFFTCommon::VnlFFTTransform< OutputImageType > vnlfft( outputSize );
-  vnlfft.transform( signal.data_block(), 1 );
+  vnlfft.transform( signal.data_block(), 1, this->GetNumberOfThreads() );
 
   // Copy the VNL output back to the ITK image. Extract the real part
   // of the signal. Ideally, the normalization by the number of
@@ -55,13 +55,6 @@ VnlInverseFFTImageFilter< TInputImage, TOutputImage >
   unsigned int vectorSize = 1;
   for ( unsigned int i = 0; i < ImageDimension; i++ )
     {
-    if ( !VnlFFTCommon::IsDimensionSizeLegal( outputSize[i] ) )
-      {
-      itkExceptionMacro(<< "Cannot compute FFT of image with size "
-                        << outputSize << ". VnlInverseFFTImageFilter operates "
-                        << "only on images whose size in each dimension is a multiple of "
-                        << "2, 3, or 5." );
-      }
     vectorSize *= outputSize[i];
     }
 
@@ -75,7 +68,7 @@ VnlInverseFFTImageFilter< TInputImage, TOutputImage >
 
   // call the proper transform, based on compile type template parameter
   VnlFFTCommon::VnlFFTTransform< OutputImageType > vnlfft( outputSize );
-  vnlfft.transform( signal.data_block(), 1 );
+  vnlfft.transform( signal.data_block(), 1, this->GetNumberOfThreads() );
 
   // Copy the VNL output back to the ITK image.
   // Extract the real part of the signal.
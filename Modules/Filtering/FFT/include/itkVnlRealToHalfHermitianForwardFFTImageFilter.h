@@ -28,8 +28,9 @@ namespace itk
  *
  * \brief VNL-based forward Fast Fourier Transform.
  *
- * The input image size in all dimensions must have a prime
- * factorization consisting of 2s, 3s, and 5s.
+ * Sizes whose prime factorization consists of 2s, 3s and 5s are
+ * transformed directly; other sizes use Bluestein's algorithm and are
+ * slower. The transform is multithreaded over blocks of lines.
  *
  * \ingroup FourierTransform
  *
@@ -31,6 +31,7 @@
 #endif
 
 # include "itkObjectFactory.h"
+# include "itkMutexLockHolder.h"
 
 namespace itk
 {
@@ -410,7 +411,10 @@ FFTWGlobalConfiguration
   m_PlanRigor(0),
   m_WriteWisdomCache(false),
   m_ReadWisdomCache(true),
-  m_WisdomCacheBase("")
+  m_WisdomCacheBase(""),
+  m_PlanCaching(true),
+  m_PlanCacheSize(16),
+  m_PlanCacheTime(0)
 {
     {//Configure default method for creating WISDOM_CACHE files
     std::string manualCacheFilename="";
@@ -511,6 +515,12 @@ FFTWGlobalConfiguration
       this->m_ReadWisdomCache=true;
       }
     }
+    {
+    std::string plan_cache_env;
+    const bool envITK_FFTW_PLAN_CACHEfound=
+      itksys::SystemTools::GetEnv("ITK_FFTW_PLAN_CACHE", plan_cache_env);
+    this->m_PlanCaching = !( envITK_FFTW_PLAN_CACHEfound && isDeclineString(plan_cache_env) );
+    }
 
   if( this->m_ReadWisdomCache )
     {
@@ -550,6 +560,8 @@ FFTWGlobalConfiguration
       }
 #endif
     }
+  // the cached plans must be destroyed before cleaning up fftw
+  this->DestroyCachedPlans();
 #if defined(ITK_USE_FFTWF)
   fftwf_cleanup_threads();
   fftwf_cleanup();
@@ -771,6 +783,270 @@ FFTWGlobalConfiguration
   return GetInstance()->m_NewWisdomAvailable;
 }
 
+namespace
+{
+// The plan caches of both precisions are handled by these functions, called
+// with the lock mutex held.
+
+// Give the plan of key to one more user, if it is in the cache
+template< typename TCache, typename TPlan >
+bool
+AcquirePlan( TCache & cache, const FFTWGlobalConfiguration::PlanKeyType & key, SizeValueType time, TPlan & plan )
+{
+  typename TCache::MapType::iterator it = cache.m_Plans.find( key );
+  if( it == cache.m_Plans.end() )
+    {
+    return false;
+    }
+  ++it->second.m_Users;
+  it->second.m_LastUse = time;
+  plan = it->second.m_Plan;
+  return true;
+}
+
+// Add a plan with one user to the cache
+template< typename TCache, typename TPlan >
+TPlan
+AddPlan( TCache & cache, const FFTWGlobalConfiguration::PlanKeyType & key, SizeValueType time, TPlan plan,
+         void (*destroy)( TPlan ) )
+{
+  TPlan existing;
+  if( AcquirePlan( cache, key, time, existing ) )
+    {
+    // another thread has cached the same plan in the meantime
+    destroy( plan );
+    return existing;
+    }
+  typename TCache::MapType::mapped_type & cachedPlan = cache.m_Plans[key];
+  cachedPlan.m_Plan = plan;
+  cachedPlan.m_Users = 1;
+  cachedPlan.m_LastUse = time;
+  return plan;
+}
+
+// Remove one user of a plan, and destroy it if it was removed from the
+// cache and has no other user
+template< typename TCache, typename TPlan >
+void
+ReleasePlan( TCache & cache, TPlan plan, void (*destroy)( TPlan ) )
+{
+  for( typename TCache::MapType::iterator it = cache.m_Plans.begin(); it != cache.m_Plans.end(); ++it )
+    {
+    if( it->second.m_Plan == plan )
+      {
+      --it->second.m_Users;
+      return;
+      }
+    }
+  for( size_t i = 0; i < cache.m_RemovedPlans.size(); ++i )
+    {
+    if( cache.m_RemovedPlans[i].m_Plan == plan )
+      {
+      if( --cache.m_RemovedPlans[i].m_Users == 0 )
+        {
+        destroy( plan );
+        cache.m_RemovedPlans.erase( cache.m_RemovedPlans.begin() + i );
+        }
+      return;
+      }
+    }
+}
+
+// Remove the least recently used plans until the cache holds at most size
+// plans. The removed plans that are in use are destroyed by their last user.
+template< typename TCache, typename TPlan >
+void
+TrimPlans( TCache & cache, SizeValueType size, void (*destroy)( TPlan ) )
+{
+  while( cache.m_Plans.size() > size )
+    {
+    typename TCache::MapType::iterator oldest = cache.m_Plans.begin();
+    for( typename TCache::MapType::iterator it = cache.m_Plans.begin(); it != cache.m_Plans.end(); ++it )
+      {
+      if( it->second.m_LastUse < oldest->second.m_LastUse )
+        {
+        oldest = it;
+        }
+      }
+    if( oldest->second.m_Users == 0 )
+      {
+      destroy( oldest->second.m_Plan );
+      }
+    else
+      {
+      cache.m_RemovedPlans.push_back( oldest->second );
+      }
+    cache.m_Plans.erase( oldest );
+    }
+}
+
+// Destroy all the plans, whether they are in use or not
+template< typename TCache, typename TPlan >
+void
+DestroyPlans( TCache & cache, void (*destroy)( TPlan ) )
+{
+  for( typename TCache::MapType::iterator it = cache.m_Plans.begin(); it != cache.m_Plans.end(); ++it )
+    {
+    destroy( it->second.m_Plan );
+    }
+  cache.m_Plans.clear();
+  for( size_t i = 0; i < cache.m_RemovedPlans.size(); ++i )
+    {
+    destroy( cache.m_RemovedPlans[i].m_Plan );
+    }
+  cache.m_RemovedPlans.clear();
+}
+} // end anonymous namespace
+
+void
+FFTWGlobalConfiguration
+::SetPlanCaching( const bool & v )
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  instance->m_PlanCaching = v;
+  if( !v )
+    {
+    instance->RemoveCachedPlans( true );
+    }
+}
+
+bool
+FFTWGlobalConfiguration
+::GetPlanCaching()
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  return instance->m_PlanCaching;
+}
+
+void
+FFTWGlobalConfiguration
+::SetPlanCacheSize( const SizeValueType & v )
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  instance->m_PlanCacheSize = v;
+  instance->RemoveCachedPlans( false );
+}
+
+SizeValueType
+FFTWGlobalConfiguration
+::GetPlanCacheSize()
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  return instance->m_PlanCacheSize;
+}
+
+void
+FFTWGlobalConfiguration
+::ClearPlanCache()
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  instance->RemoveCachedPlans( true );
+}
+
+void
+FFTWGlobalConfiguration
+::RemoveCachedPlans( bool all )
+{
+  const SizeValueType size = all ? 0 : this->m_PlanCacheSize;
+#if defined(ITK_USE_FFTWF)
+  TrimPlans( this->m_FloatPlanCache, size, fftwf_destroy_plan );
+#endif
+#if defined(ITK_USE_FFTWD)
+  TrimPlans( this->m_DoublePlanCache, size, fftw_destroy_plan );
+#endif
+}
+
+void
+FFTWGlobalConfiguration
+::DestroyCachedPlans()
+{
+#if defined(ITK_USE_FFTWF)
+  DestroyPlans( this->m_FloatPlanCache, fftwf_destroy_plan );
+#endif
+#if defined(ITK_USE_FFTWD)
+  DestroyPlans( this->m_DoublePlanCache, fftw_destroy_plan );
+#endif
+}
+
+#if defined(ITK_USE_FFTWF)
+bool
+FFTWGlobalConfiguration
+::AcquireCachedPlan( const PlanKeyType & key, fftwf_plan & plan )
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  return instance->m_PlanCaching
+    && AcquirePlan( instance->m_FloatPlanCache, key, ++instance->m_PlanCacheTime, plan );
+}
+
+fftwf_plan
+FFTWGlobalConfiguration
+::CachePlan( const PlanKeyType & key, fftwf_plan plan, bool & cached )
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  cached = instance->m_PlanCaching;
+  if( !cached )
+    {
+    return plan;
+    }
+  plan = AddPlan( instance->m_FloatPlanCache, key, ++instance->m_PlanCacheTime, plan, fftwf_destroy_plan );
+  instance->RemoveCachedPlans( false );
+  return plan;
+}
+
+void
+FFTWGlobalConfiguration
+::ReleaseCachedPlan( fftwf_plan plan )
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  ReleasePlan( instance->m_FloatPlanCache, plan, fftwf_destroy_plan );
+}
+#endif
+
+#if defined(ITK_USE_FFTWD)
+bool
+FFTWGlobalConfiguration
+::AcquireCachedPlan( const PlanKeyType & key, fftw_plan & plan )
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  return instance->m_PlanCaching
+    && AcquirePlan( instance->m_DoublePlanCache, key, ++instance->m_PlanCacheTime, plan );
+}
+
+fftw_plan
+FFTWGlobalConfiguration
+::CachePlan( const PlanKeyType & key, fftw_plan plan, bool & cached )
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  cached = instance->m_PlanCaching;
+  if( !cached )
+    {
+    return plan;
+    }
+  plan = AddPlan( instance->m_DoublePlanCache, key, ++instance->m_PlanCacheTime, plan, fftw_destroy_plan );
+  instance->RemoveCachedPlans( false );
+  return plan;
+}
+
+void
+FFTWGlobalConfiguration
+::ReleaseCachedPlan( fftw_plan plan )
+{
+  Pointer instance = GetInstance();
+  MutexLockHolder< SimpleFastMutexLock > lock( instance->m_Lock );
+  ReleasePlan( instance->m_DoublePlanCache, plan, fftw_destroy_plan );
+}
+#endif
+
 void
 FFTWGlobalConfiguration
 ::SetPlanRigor( const int & v )
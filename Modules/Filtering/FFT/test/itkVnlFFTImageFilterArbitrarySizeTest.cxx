@@ -0,0 +1,217 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkVnlForwardFFTImageFilter.h"
+#include "itkVnlInverseFFTImageFilter.h"
+#include "itkComplexToComplexFFTImageFilter.h"
+#include "itkVnlRealToHalfHermitianForwardFFTImageFilter.h"
+#include "itkVnlHalfHermitianToRealInverseFFTImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+/* Compare the Vnl filters against a direct evaluation of the discrete
+ * Fourier transform for sizes that are not products of 2s, 3s and 5s
+ * (Bluestein's algorithm) and for mixed sizes, with one and several
+ * threads. */
+namespace
+{
+
+template< typename TRealImage, typename TComplexImage >
+double
+MaximumDFTError( const TRealImage * input, const TComplexImage * output )
+{
+  typedef typename TRealImage::IndexType IndexType;
+  const unsigned int Dimension = TRealImage::ImageDimension;
+  const typename TRealImage::SizeType size = input->GetLargestPossibleRegion().GetSize();
+
+  double maximumError = 0.0;
+  double maximumValue = 0.0;
+  itk::ImageRegionConstIteratorWithIndex< TComplexImage > oIt( output, output->GetLargestPossibleRegion() );
+  for( oIt.GoToBegin(); !oIt.IsAtEnd(); ++oIt )
+    {
+    const IndexType k = oIt.GetIndex();
+    std::complex< double > sum( 0.0, 0.0 );
+    itk::ImageRegionConstIteratorWithIndex< TRealImage > iIt( input, input->GetLargestPossibleRegion() );
+    for( iIt.GoToBegin(); !iIt.IsAtEnd(); ++iIt )
+      {
+      const IndexType n = iIt.GetIndex();
+      double phase = 0.0;
+      for( unsigned int d = 0; d < Dimension; ++d )
+        {
+        phase += static_cast< double >( ( k[d] * n[d] ) % static_cast< long >( size[d] ) ) / size[d];
+        }
+      phase *= -2.0 * itk::Math::pi;
+      sum += static_cast< double >( iIt.Get() ) * std::complex< double >( std::cos( phase ), std::sin( phase ) );
+      }
+    const std::complex< double > value( oIt.Get().real(), oIt.Get().imag() );
+    maximumError = std::max( maximumError, std::abs( value - sum ) );
+    maximumValue = std::max( maximumValue, std::abs( sum ) );
+    }
+  return maximumError / maximumValue;
+}
+
+template< typename TPixel, unsigned int VDimension >
+int
+TestSize( const itk::Size< VDimension > & size, itk::ThreadIdType numberOfThreads, double tolerance )
+{
+  typedef itk::Image< TPixel, VDimension >                  RealImageType;
+  typedef itk::Image< std::complex< TPixel >, VDimension >  ComplexImageType;
+
+  std::cout << "Size " << size << ", " << numberOfThreads << " thread(s), "
+            << sizeof( TPixel ) << "-byte pixels" << std::endl;
+
+  typename RealImageType::Pointer image = RealImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< RealImageType > it( image, image->GetLargestPossibleRegion() );
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 7 );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< TPixel >( generator->GetIntegerVariate( 999 ) ) / 100 );
+    }
+
+  int status = EXIT_SUCCESS;
+
+  // Full complex forward transform.
+  typedef itk::VnlForwardFFTImageFilter< RealImageType, ComplexImageType > ForwardType;
+  typename ForwardType::Pointer forward = ForwardType::New();
+  forward->SetInput( image );
+  forward->SetNumberOfThreads( numberOfThreads );
+  TRY_EXPECT_NO_EXCEPTION( forward->Update() );
+  const double forwardError = MaximumDFTError( image.GetPointer(), forward->GetOutput() );
+  if( forwardError > tolerance )
+    {
+    std::cerr << "Forward transform error " << forwardError << " exceeds " << tolerance << std::endl;
+    status = EXIT_FAILURE;
+    }
+
+  // Half Hermitian forward transform.
+  typedef itk::VnlRealToHalfHermitianForwardFFTImageFilter< RealImageType, ComplexImageType > HalfForwardType;
+  typename HalfForwardType::Pointer halfForward = HalfForwardType::New();
+  halfForward->SetInput( image );
+  halfForward->SetNumberOfThreads( numberOfThreads );
+  TRY_EXPECT_NO_EXCEPTION( halfForward->Update() );
+  const double halfForwardError = MaximumDFTError( image.GetPointer(), halfForward->GetOutput() );
+  if( halfForwardError > tolerance )
+    {
+    std::cerr << "Half Hermitian forward transform error " << halfForwardError
+              << " exceeds " << tolerance << std::endl;
+    status = EXIT_FAILURE;
+    }
+
+  // Round trips through the inverse transforms.
+  typedef itk::VnlInverseFFTImageFilter< ComplexImageType, RealImageType > InverseType;
+  typename InverseType::Pointer inverse = InverseType::New();
+  inverse->SetInput( forward->GetOutput() );
+  inverse->SetNumberOfThreads( numberOfThreads );
+  TRY_EXPECT_NO_EXCEPTION( inverse->Update() );
+
+  typedef itk::VnlHalfHermitianToRealInverseFFTImageFilter< ComplexImageType, RealImageType > HalfInverseType;
+  typename HalfInverseType::Pointer halfInverse = HalfInverseType::New();
+  halfInverse->SetInput( halfForward->GetOutput() );
+  halfInverse->SetActualXDimensionIsOdd( size[0] % 2 != 0 );
+  halfInverse->SetNumberOfThreads( numberOfThreads );
+  TRY_EXPECT_NO_EXCEPTION( halfInverse->Update() );
+
+  // Complex to complex forward and inverse transforms.
+  typedef itk::VnlComplexToComplexFFTImageFilter< ComplexImageType > ComplexType;
+  typename ComplexType::Pointer complexForward = ComplexType::New();
+  complexForward->SetInput( forward->GetOutput() );
+  complexForward->SetTransformDirection( ComplexType::INVERSE );
+  complexForward->SetNumberOfThreads( numberOfThreads );
+  TRY_EXPECT_NO_EXCEPTION( complexForward->Update() );
+
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const double expected = it.Get();
+    const double inverseValue = inverse->GetOutput()->GetPixel( it.GetIndex() );
+    const double halfInverseValue = halfInverse->GetOutput()->GetPixel( it.GetIndex() );
+    const std::complex< TPixel > complexValue = complexForward->GetOutput()->GetPixel( it.GetIndex() );
+    if( std::abs( inverseValue - expected ) > tolerance * 10
+        || std::abs( halfInverseValue - expected ) > tolerance * 10
+        || std::abs( complexValue.real() - expected ) > tolerance * 10
+        || std::abs( complexValue.imag() ) > tolerance * 10 )
+      {
+      std::cerr << "Round trip mismatch at " << it.GetIndex() << ": expected " << expected
+                << ", got " << inverseValue << ", " << halfInverseValue << " and "
+                << complexValue << std::endl;
+      status = EXIT_FAILURE;
+      break;
+      }
+    }
+
+  return status;
+}
+
+} // end anonymous namespace
+
+int itkVnlFFTImageFilterArbitrarySizeTest( int, char *[] )
+{
+  int status = EXIT_SUCCESS;
+
+  for( itk::ThreadIdType threads = 1; threads <= 3; threads += 2 )
+    {
+    itk::Size< 1 > size1;
+    size1[0] = 13;
+    if( TestSize< double, 1 >( size1, threads, 1e-10 ) != EXIT_SUCCESS )
+      {
+      status = EXIT_FAILURE;
+      }
+
+    itk::Size< 2 > size2;
+    size2[0] = 14;
+    size2[1] = 11;
+    if( TestSize< double, 2 >( size2, threads, 1e-10 ) != EXIT_SUCCESS )
+      {
+      status = EXIT_FAILURE;
+      }
+    if( TestSize< float, 2 >( size2, threads, 1e-4 ) != EXIT_SUCCESS )
+      {
+      status = EXIT_FAILURE;
+      }
+
+    itk::Size< 3 > size3;
+    size3[0] = 7;
+    size3[1] = 9;
+    size3[2] = 17;
+    if( TestSize< double, 3 >( size3, threads, 1e-10 ) != EXIT_SUCCESS )
+      {
+      status = EXIT_FAILURE;
+      }
+
+    // Sizes handled directly by the GPFA routine, with more lines than
+    // fit in a single transpose block.
+    size3[0] = 20;
+    size3[1] = 18;
+    size3[2] = 5;
+    if( TestSize< float, 3 >( size3, threads, 1e-4 ) != EXIT_SUCCESS )
+      {
+      status = EXIT_FAILURE;
+      }
+    }
+
+  if( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test finished." << std::endl;
+    }
+  return status;
+}
@@ -46,8 +46,8 @@ int itkVnlRealFFTTest(int, char *[])
 
   unsigned int SizeOfDimensions1[] = { 4,4,4,4 };
   unsigned int SizeOfDimensions2[] = { 3,5,4 };
-  unsigned int SizeOfDimensions3[] = { 7,6,4 }; // Should fail
-                                                // (illegal prime factor)
+  unsigned int SizeOfDimensions3[] = { 7,6,4 }; // Prime factor 7 uses
+                                                // Bluestein's algorithm
   int rval = 0;
   std::cerr << "Vnl float,1 (4,4,4)" << std::endl;
   if((test_fft<float,1,
@@ -154,85 +154,61 @@ int itkVnlRealFFTTest(int, char *[])
     rval++;
     }
 
-  // These tests should fail.
+  // Sizes with prime factors other than 2, 3 and 5.
 
   std::cerr << "Vnl float,1 (7,6,4)" << std::endl;
   if((test_fft<float,1,
       itk::VnlRealToHalfHermitianForwardFFTImageFilter<ImageF1> ,
-      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCF1> >(SizeOfDimensions3)) == 0)
+      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCF1> >(SizeOfDimensions3)) != 0)
     {
     std::cerr << "--------------------- Failed!" << std::endl;
     rval++;
     }
-  else
-    {
-    std::cerr << "Caught expected size error." << std::endl;
-    }
 
   std::cerr << "Vnl float,2 (7,6,4)" << std::endl;
   if((test_fft<float,2,
       itk::VnlRealToHalfHermitianForwardFFTImageFilter<ImageF2> ,
-      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCF2> >(SizeOfDimensions3)) == 0)
+      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCF2> >(SizeOfDimensions3)) != 0)
     {
     std::cerr << "--------------------- Failed!" << std::endl;
     rval++;
     }
-  else
-    {
-    std::cerr << "Caught expected size error." << std::endl;
-    }
 
   std::cerr << "Vnl float,3 (7,6,4)" << std::endl;
   if((test_fft<float,3,
       itk::VnlRealToHalfHermitianForwardFFTImageFilter<ImageF3> ,
-      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCF3> >(SizeOfDimensions3)) == 0)
+      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCF3> >(SizeOfDimensions3)) != 0)
     {
     std::cerr << "--------------------- Failed!" << std::endl;
     rval++;
     }
-  else
-    {
-    std::cerr << "Caught expected size error." << std::endl;
-    }
 
   std::cerr << "Vnl double,1 (7,6,4)" << std::endl;
   if((test_fft<double,1,
       itk::VnlRealToHalfHermitianForwardFFTImageFilter<ImageD1> ,
-      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCD1> >(SizeOfDimensions3)) == 0)
+      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCD1> >(SizeOfDimensions3)) != 0)
     {
     std::cerr << "--------------------- Failed!" << std::endl;
     rval++;
     }
-  else
-    {
-    std::cerr << "Caught expected size error." << std::endl;
-    }
 
   std::cerr << "Vnl double,2 (7,6,4)" << std::endl;
   if((test_fft<double,2,
       itk::VnlRealToHalfHermitianForwardFFTImageFilter<ImageD2> ,
-      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCD2> >(SizeOfDimensions3)) == 0)
+      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCD2> >(SizeOfDimensions3)) != 0)
     {
     std::cerr << "--------------------- Failed!" << std::endl;
     rval++;
     }
-  else
-    {
-    std::cerr << "Caught expected size error." << std::endl;
-    }
 
   std::cerr << "Vnl double,3 (7,6,4)" << std::endl;
   if((test_fft<double,3,
       itk::VnlRealToHalfHermitianForwardFFTImageFilter<ImageD3> ,
-      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCD3> >(SizeOfDimensions3)) == 0)
+      itk::VnlHalfHermitianToRealInverseFFTImageFilter<ImageCD3> >(SizeOfDimensions3)) != 0)
     {
     std::cerr << "--------------------- Failed!" << std::endl;
     rval++;
     }
-  else
-    {
-    std::cerr << "Caught expected size error." << std::endl;
-    }
 
   return rval == 0 ? 0 : -1;
 }
@@ -22,12 +22,33 @@
 #include "itkIntTypes.h"
 #include "itkFastMarchingStoppingCriterionBase.h"
 #include "itkFastMarchingTraits.h"
+#include "itkIndexedDAryHeap.h"
 
-#include <queue>
 #include <functional>
+#include <map>
 
 namespace itk
 {
+/** \class FastMarchingNodeCompare
+ * \brief Strict weak ordering of the fast marching nodes.
+ *
+ * std::less for the nodes that define operator<, like the point
+ * identifiers of meshes, and the lexicographic order for image indexes.
+ *
+ * \ingroup ITKFastMarching
+ */
+template< typename TNode >
+struct FastMarchingNodeCompare
+{
+  typedef std::less< TNode > Type;
+};
+
+template< unsigned int VDimension >
+struct FastMarchingNodeCompare< Index< VDimension > >
+{
+  typedef typename Index< VDimension >::LexicographicCompare Type;
+};
+
 /**
  * \class FastMarchingBase
  * \brief Abstract class to solve an Eikonal based-equation using Fast Marching
@@ -40,8 +61,9 @@ namespace itk
  *
  * Updates are preformed using an entropy satisfy scheme where only
  * "upwind" neighborhoods are used. This implementation of Fast Marching
- * uses a std::priority_queue to locate the next proper node to
- * update.
+ * uses an IndexedDAryHeap to locate the next proper node to
+ * update. The trial nodes are in the heap once, with their current value:
+ * updating the value of a trial node moves it in the heap.
  *
  * Fast Marching sweeps through N points in (N log N) steps to obtain
  * the arrival time value as the front propagates through the domain.
@@ -68,10 +90,6 @@ namespace itk
  *    \li Superclass (itk::ImageToImageFilter or
  * itk::QuadEdgeMeshToQuadEdgeMeshFilter )
  *
- * \todo In the current implemenation, std::priority_queue only allows
- * taking nodes out from the front and putting nodes in from the back.
- * Use itk::PriorityQueueContainer instead.
- *
  * \par Topology constraints:
  * Additional flexibiility in this class includes the implementation of
  * topology constraints for image-based fast marching.  Further details
@@ -230,23 +248,30 @@ protected:
 
   bool m_CollectPoints;
 
-  //PriorityQueuePointer m_Heap;
-  typedef std::vector< NodePairType >   HeapContainerType;
-  typedef std::greater< NodePairType >  NodeComparerType;
-
-  typedef std::priority_queue<
-    NodeType,
-    HeapContainerType,
-    NodeComparerType >
-    PriorityQueueType;
+  /** Min-heap of the trial nodes, keyed by GetNodeIdentifier(). */
+  typedef IndexedDAryHeap< NodePairType > PriorityQueueType;
 
   PriorityQueueType m_Heap;
 
+  /** Identifiers given by the default GetNodeIdentifier(). */
+  typedef std::map< NodeType, IdentifierType,
+                    typename FastMarchingNodeCompare< NodeType >::Type > NodeIdentifierMapType;
+
+  mutable NodeIdentifierMapType m_NodeIdentifiers;
+
   TopologyCheckType m_TopologyCheck;
 
   /** \brief Get the total number of nodes in the domain */
   virtual IdentifierType GetTotalNumberOfNodes() const = 0;
 
+  /** \brief Get the identifier of a node in the heap, a non-negative
+   * integer unique to the node; the heap indexes a table with it, so it
+   * should be lower than or close to GetTotalNumberOfNodes().
+   * The default implementation numbers the nodes in the order they are
+   * first seen, using a map; subclasses that can compute it directly, like
+   * a pixel offset, should override it. */
+  virtual IdentifierType GetNodeIdentifier( const NodeType& iNode ) const;
+
   /** \brief Get the ouput value (front value) for a given node */
   virtual const OutputPixelType GetOutputValue( OutputDomainType* oDomain,
                                          const NodeType& iNode ) const = 0;
@@ -104,16 +104,8 @@ Initialize( OutputDomainType* oDomain )
     }
 
   // make sure the heap is empty
-  while ( !m_Heap.empty() )
-    {
-    m_Heap.pop();
-    }
-  /*
-  while ( !m_Heap->Empty() )
-    {
-    m_Heap->Pop();
-    }
-  */
+  m_Heap.Clear();
+  m_NodeIdentifiers.clear();
 
   this->InitializeOutput( oDomain );
 
@@ -123,6 +115,23 @@ Initialize( OutputDomainType* oDomain )
   }
 // -----------------------------------------------------------------------------
 
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+IdentifierType
+FastMarchingBase< TInput, TOutput >::
+GetNodeIdentifier( const NodeType& iNode ) const
+  {
+  typename NodeIdentifierMapType::iterator it = m_NodeIdentifiers.find( iNode );
+  if( it == m_NodeIdentifiers.end() )
+    {
+    const IdentifierType identifier = static_cast< IdentifierType >( m_NodeIdentifiers.size() );
+    m_NodeIdentifiers.insert( typename NodeIdentifierMapType::value_type( iNode, identifier ) );
+    return identifier;
+    }
+  return it->second;
+  }
+// -----------------------------------------------------------------------------
+
 // -----------------------------------------------------------------------------
 template< typename TInput, typename TOutput >
 void
@@ -141,50 +150,39 @@ GenerateData()
 
   try
     {
-    //while( !m_Heap->Empty() )
-    while( !m_Heap.empty() )
+    while( !m_Heap.Empty() )
       {
-      //PriorityQueueElementType element = m_Heap->Peek();
-      //m_Heap->Pop();
-      //
-      //NodeType current_node = element.m_Element;
-      //OutputPixelType current_value = element.m_Priority;
-
-
-      NodePairType current_node_pair = m_Heap.top();
-      m_Heap.pop();
+      NodePairType current_node_pair = m_Heap.Top();
+      m_Heap.Pop();
 
       NodeType current_node = current_node_pair.GetNode();
-      current_value = this->GetOutputValue( output, current_node );
+      current_value = current_node_pair.GetValue();
 
-      if( Math::ExactlyEquals(current_value, current_node_pair.GetValue()) )
+      // is this node already alive ?
+      if( this->GetLabelValueForGivenNode( current_node ) != Traits::Alive )
         {
-        // is this node already alive ?
-        if( this->GetLabelValueForGivenNode( current_node ) != Traits::Alive )
+        m_StoppingCriterion->SetCurrentNodePair( current_node_pair );
+
+        if( m_StoppingCriterion->IsSatisfied() )
           {
-          m_StoppingCriterion->SetCurrentNodePair( current_node_pair );
+          break;
+          }
 
-          if( m_StoppingCriterion->IsSatisfied() )
+        if( this->CheckTopology( output, current_node ) )
+          {
+          if ( m_CollectPoints )
             {
-            break;
+            m_ProcessedPoints->push_back( current_node_pair );
             }
 
-          if( this->CheckTopology( output, current_node ) )
-            {
-            if ( m_CollectPoints )
-              {
-              m_ProcessedPoints->push_back( current_node_pair );
-              }
-
-              // set this node as alive
-            this->SetLabelValueForGivenNode( current_node, Traits::Alive );
+            // set this node as alive
+          this->SetLabelValueForGivenNode( current_node, Traits::Alive );
 
-            // update its neighbors
-            this->UpdateNeighbors( output, current_node );
-            }
+          // update its neighbors
+          this->UpdateNeighbors( output, current_node );
           }
-        progress.CompletedPixel();
         }
+      progress.CompletedPixel();
       }
     }
   catch ( ProcessAborted & )
@@ -195,14 +193,8 @@ GenerateData()
     // it.
     //
     // RELEASE MEMORY!!!
-    while( !m_Heap.empty() )
-      {
-      m_Heap.pop();
-      }
-    /*while( !m_Heap->Empty() )
-      {
-      m_Heap->Pop();
-      }*/
+    PriorityQueueType().Swap( m_Heap );
+    m_NodeIdentifiers.clear();
 
     throw ProcessAborted(__FILE__, __LINE__);
     }
@@ -210,14 +202,8 @@ GenerateData()
   m_TargetReachedValue = current_value;
 
   // let's release some useless memory...
-  while( !m_Heap.empty() )
-    {
-    m_Heap.pop();
-    }
-  /*while( !m_Heap->Empty() )
-    {
-    m_Heap->Pop();
-    }*/
+  PriorityQueueType().Swap( m_Heap );
+  m_NodeIdentifiers.clear();
   }
 // -----------------------------------------------------------------------------
 
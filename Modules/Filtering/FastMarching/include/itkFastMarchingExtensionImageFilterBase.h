@@ -134,6 +134,10 @@ protected:
 
   virtual void UpdateValue( OutputImageType* oImage, const NodeType& iValue ) ITK_OVERRIDE;
 
+  /** The auxiliary values are extended in UpdateValue(), so the front is
+   * always propagated sequentially. */
+  virtual bool CanUseParallelSolver() const ITK_OVERRIDE { return false; }
+
   /** Generate the output image meta information */
   virtual void GenerateOutputInformation() ITK_OVERRIDE;
 
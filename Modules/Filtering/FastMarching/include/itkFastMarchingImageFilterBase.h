@@ -20,6 +20,7 @@
 #define itkFastMarchingImageFilterBase_h
 
 #include "itkFastMarchingBase.h"
+#include "itkFastMarchingImageFilterBaseThreader.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkNeighborhoodIterator.h"
 #include "itkArray.h"
@@ -57,6 +58,15 @@ namespace itk
  *
  * Else the output information is copied from the input speed image.
  *
+ * With UseParallelSolver on, the arrival times are computed with threads
+ * by the iterative method of FastMarchingImageFilterBaseThreader, then
+ * the stopping criterion is applied to the nodes in increasing order of
+ * arrival time. The alive nodes match those of the sequential front, and
+ * their values match within round-off. The parallel solver does not
+ * support the topology checks, and is not used by the subclasses which
+ * compute additional outputs while the front propagates; in these cases
+ * the sequential front is used.
+ *
  * Implementation of this class is based on Chapter 8 of
  * "Level Set Methods and Fast Marching Methods", J.A. Sethian,
  * Cambridge Press, Second edition, 1999.
@@ -151,6 +161,12 @@ public:
   itkGetConstReferenceMacro(OverrideOutputInformation, bool);
   itkBooleanMacro(OverrideOutputInformation);
 
+  /** Set/Get whether the front is propagated with threads. Defaults to
+   * false. */
+  itkSetMacro(UseParallelSolver, bool);
+  itkGetConstReferenceMacro(UseParallelSolver, bool);
+  itkBooleanMacro(UseParallelSolver);
+
 protected:
 
   /** Constructor */
@@ -168,17 +184,27 @@ protected:
   OutputSpacingType   m_OutputSpacing;
   OutputDirectionType m_OutputDirection;
   bool                m_OverrideOutputInformation;
+  bool                m_UseParallelSolver;
 
   /** Generate the output image meta information. */
   virtual void GenerateOutputInformation() ITK_OVERRIDE;
 
   virtual void EnlargeOutputRequestedRegion(DataObject *output) ITK_OVERRIDE;
 
+  /** Propagate the front, with threads if UseParallelSolver is on and
+   * CanUseParallelSolver() returns true. */
+  virtual void GenerateData() ITK_OVERRIDE;
+
+  /** Whether the parallel solver can compute the output of this filter. */
+  virtual bool CanUseParallelSolver() const;
+
   LabelImagePointer               m_LabelImage;
   ConnectedComponentImagePointer  m_ConnectedComponentImage;
 
   IdentifierType GetTotalNumberOfNodes() const ITK_OVERRIDE;
 
+  IdentifierType GetNodeIdentifier( const NodeType& iNode ) const ITK_OVERRIDE;
+
   void SetOutputValue( OutputImageType* oDomain,
                        const NodeType& iNode,
                        const OutputPixelType& iValue ) ITK_OVERRIDE;
@@ -255,6 +281,11 @@ private:
 
   FastMarchingImageFilterBase( const Self& );
   void operator = ( const Self& );
+
+  typedef FastMarchingImageFilterBaseThreader< Self > ParallelSolverType;
+  friend class FastMarchingImageFilterBaseThreader< Self >;
+
+  typename ParallelSolverType::Pointer m_ParallelSolver;
   };
 }
 
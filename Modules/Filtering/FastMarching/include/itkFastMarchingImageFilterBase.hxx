@@ -66,9 +66,12 @@ FastMarchingImageFilterBase()
   m_OutputSpacing.Fill(1.0);
   m_OutputDirection.SetIdentity();
   m_OverrideOutputInformation = false;
+  m_UseParallelSolver = false;
 
   m_InputCache = ITK_NULLPTR;
   m_LabelImage = LabelImageType::New();
+
+  m_ParallelSolver = ParallelSolverType::New();
   }
 // -----------------------------------------------------------------------------
 
@@ -126,6 +129,39 @@ EnlargeOutputRequestedRegion(
 }
 // -----------------------------------------------------------------------------
 
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+bool
+FastMarchingImageFilterBase< TInput, TOutput >::
+CanUseParallelSolver() const
+{
+  return this->m_TopologyCheck == Superclass::Nothing;
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+void
+FastMarchingImageFilterBase< TInput, TOutput >::
+GenerateData()
+{
+  if ( !m_UseParallelSolver || !this->CanUseParallelSolver() )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  OutputImageType* output = this->GetOutput();
+
+  this->Initialize( output );
+
+  this->m_StoppingCriterion->Reinitialize();
+
+  m_ParallelSolver->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+  m_ParallelSolver->Run( this, output );
+}
+// -----------------------------------------------------------------------------
+
 // -----------------------------------------------------------------------------
 template< typename TInput, typename TOutput >
 IdentifierType
@@ -136,6 +172,16 @@ GetTotalNumberOfNodes() const
   }
 // -----------------------------------------------------------------------------
 
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+IdentifierType
+FastMarchingImageFilterBase< TInput, TOutput >::
+GetNodeIdentifier( const NodeType& iNode ) const
+  {
+  return static_cast< IdentifierType >( this->m_LabelImage->ComputeOffset( iNode ) );
+  }
+// -----------------------------------------------------------------------------
+
 // -----------------------------------------------------------------------------
 template< typename TInput, typename TOutput >
 void
@@ -243,8 +289,8 @@ UpdateValue( OutputImageType* oImage, const NodeType& iNode )
 
     this->SetLabelValueForGivenNode( iNode, Traits::Trial );
 
-    // insert point into trial heap
-    this->m_Heap.push( NodePairType( iNode, outputPixel ) );
+    // insert point into trial heap, or move it if it is already there
+    this->m_Heap.Push( this->GetNodeIdentifier( iNode ), NodePairType( iNode, outputPixel ) );
     }
   }
 // -----------------------------------------------------------------------------
@@ -638,8 +684,7 @@ InitializeOutput( OutputImageType* oImage )
         outputPixel = pointsIter->Value().GetValue();
         this->SetOutputValue( oImage, idx, outputPixel );
 
-        //this->m_Heap->Push( PriorityQueueElementType( idx, pointsIter->second ) );
-        this->m_Heap.push( pointsIter->Value() );
+        this->m_Heap.Push( this->GetNodeIdentifier( idx ), pointsIter->Value() );
         }
       ++pointsIter;
       }
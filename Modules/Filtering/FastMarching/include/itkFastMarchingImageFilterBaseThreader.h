@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFastMarchingImageFilterBaseThreader_h
+#define itkFastMarchingImageFilterBaseThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+
+/** \class FastMarchingImageFilterBaseThreader
+ * \brief Parallel solver of FastMarchingImageFilterBase.
+ *
+ * The arrival times are computed with an iterative method in the spirit of
+ * the fast iterative method of Jeong and Whitaker. An active list holds
+ * the nodes whose upwind neighbors have changed. In each iteration the new
+ * values of the active nodes are computed in parallel with the upwind
+ * scheme of the sequential solver; the nodes whose value decreases are
+ * updated, and their neighbors form the next active list. The iterations
+ * stop when no value decreases, at the solution of the discrete equation
+ * solved by the sequential front.
+ *
+ * With a FastMarchingThresholdStoppingCriterion or a
+ * FastMarchingReachedTargetNodesStoppingCriterion, the front does not
+ * propagate from the nodes whose value is above the threshold, or above
+ * the current value at which the target nodes are reached plus the target
+ * offset. These nodes cannot be made alive, and the values of the nodes
+ * below the bound do not depend on them, so the iterations only cover the
+ * part of the image the sequential front would visit. With the other
+ * criteria the front propagates to the whole image.
+ *
+ * The stopping criterion is then applied as by the sequential solver: the
+ * reached nodes are sorted by value in parallel, merged, and made alive in
+ * increasing order until the criterion is satisfied. The nodes which are
+ * not alive get the value the sequential solver would give to its trial
+ * nodes, computed from their alive neighbors, or the large value. The
+ * progress is reported as nodes are reached, then as they are made alive.
+ *
+ * Jeong, W.-K., Whitaker, R. T. A Fast Iterative Method for Eikonal
+ * Equations. SIAM Journal on Scientific Computing 30(5), 2512-2534 (2008).
+ *
+ * \sa FastMarchingImageFilterBase
+ * \ingroup ITKFastMarching
+ */
+template< typename TAssociate >
+class FastMarchingImageFilterBaseThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate >
+{
+public:
+  /** Standard class typedefs. */
+  typedef FastMarchingImageFilterBaseThreader                               Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate > Superclass;
+  typedef SmartPointer< Self >                                              Pointer;
+  typedef SmartPointer< const Self >                                        ConstPointer;
+
+  itkTypeMacro( FastMarchingImageFilterBaseThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+  typedef DomainType                         IndexRangeType;
+
+  typedef typename TAssociate::Traits                     Traits;
+  typedef typename TAssociate::OutputImageType            OutputImageType;
+  typedef typename TAssociate::OutputPixelType            OutputPixelType;
+  typedef typename TAssociate::OutputRegionType           OutputRegionType;
+  typedef typename TAssociate::NodeType                   NodeType;
+  typedef typename TAssociate::NodePairType               NodePairType;
+  typedef typename TAssociate::InternalNodeStructure      InternalNodeStructure;
+  typedef typename TAssociate::InternalNodeStructureArray InternalNodeStructureArray;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TAssociate::ImageDimension);
+
+  /** Propagate the front initialized by \c associate in \c output, then
+   * apply the stopping criterion. */
+  void Run( AssociateType * associate, OutputImageType * output );
+
+protected:
+  FastMarchingImageFilterBaseThreader();
+  virtual ~FastMarchingImageFilterBaseThreader() {}
+
+  /** Allocate the per thread lists of the current phase. */
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  /** Run the current phase on the elements of \c subrange. */
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+  FastMarchingImageFilterBaseThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  typedef std::pair< OutputPixelType, OffsetValueType > ValueOffsetPairType;
+  typedef std::vector< ValueOffsetPairType >            ValueOffsetPairListType;
+
+  enum PhaseType {
+    /** Compute the new values of the active nodes. */
+    SolvePhase,
+    /** Store the values which decrease and list the neighbors. */
+    UpdatePhase,
+    /** List the reached nodes of a range of the image, sorted by value. */
+    SortPhase,
+    /** Compute the values of the nodes which are not alive. */
+    TrialPhase,
+    /** Label the reached nodes which are not alive as trial nodes. */
+    LabelPhase };
+
+  /** Run a phase on the elements [0, numberOfElements). */
+  void ExecutePhase( PhaseType phase, SizeValueType numberOfElements );
+
+  /** Whether the front propagates to a node with this label. */
+  static bool CanPropagateTo( unsigned char label )
+  {
+    return label != Traits::Alive && label != Traits::InitialTrial && label != Traits::Forbidden;
+  }
+
+  /** Append the neighbors of \c offset to which the front propagates. */
+  void ListNeighbors( OffsetValueType offset, std::vector< OffsetValueType > & neighbors ) const;
+
+  /** Compute the value of a node from all its reached neighbors. */
+  OutputPixelType SolveNode( OffsetValueType offset ) const;
+
+  /** Move the listed neighbors into the active list, once each. */
+  void MergeNeighbors();
+
+  /** The largest value from which the front propagates, or m_LargeValue
+   * if the stopping criterion does not bound the values of the alive
+   * nodes. */
+  OutputPixelType ComputePropagationBound() const;
+
+  /** Make the reached nodes alive in increasing order until the stopping
+   * criterion is satisfied. */
+  void ApplyStoppingCriterion();
+
+  OutputImageType *                              m_Output;
+  OutputPixelType *                              m_Values;
+  unsigned char *                                m_Labels;
+  OutputRegionType                               m_Region;
+  OffsetValueType                                m_Strides[ImageDimension];
+  OutputPixelType                                m_LargeValue;
+  OutputPixelType                                m_PropagationBound;
+  PhaseType                                      m_Phase;
+  std::vector< OffsetValueType >                 m_Active;
+  std::vector< OutputPixelType >                 m_NewValues;
+  std::vector< unsigned char >                   m_Listed;
+  std::vector< std::vector< OffsetValueType > >  m_Neighbors;
+  /** The nodes reached by each thread, in the order they are reached. */
+  std::vector< std::vector< OffsetValueType > >  m_NewlyReached;
+  /** All the reached nodes, from the initial trial nodes. */
+  std::vector< OffsetValueType >                 m_Reached;
+  std::vector< ValueOffsetPairListType >         m_Sorted;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFastMarchingImageFilterBaseThreader.hxx"
+#endif
+
+#endif
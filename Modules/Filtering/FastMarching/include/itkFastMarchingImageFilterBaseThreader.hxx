@@ -0,0 +1,475 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFastMarchingImageFilterBaseThreader_hxx
+#define itkFastMarchingImageFilterBaseThreader_hxx
+
+#include "itkFastMarchingImageFilterBaseThreader.h"
+#include "itkFastMarchingReachedTargetNodesStoppingCriterion.h"
+#include "itkFastMarchingThresholdStoppingCriterion.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace itk
+{
+
+template< typename TAssociate >
+FastMarchingImageFilterBaseThreader< TAssociate >
+::FastMarchingImageFilterBaseThreader() :
+  m_Output( ITK_NULLPTR ),
+  m_Values( ITK_NULLPTR ),
+  m_Labels( ITK_NULLPTR ),
+  m_LargeValue( NumericTraits< OutputPixelType >::max() ),
+  m_PropagationBound( NumericTraits< OutputPixelType >::max() ),
+  m_Phase( SolvePhase )
+{
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    m_Strides[d] = 0;
+    }
+}
+
+template< typename TAssociate >
+void
+FastMarchingImageFilterBaseThreader< TAssociate >
+::Run( AssociateType * associate, OutputImageType * output )
+{
+  this->m_Associate = associate;
+  this->m_Output = output;
+  this->m_Values = output->GetBufferPointer();
+  this->m_Labels = associate->m_LabelImage->GetBufferPointer();
+  this->m_Region = associate->m_BufferedRegion;
+  this->m_LargeValue = associate->m_LargeValue;
+
+  OffsetValueType stride = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    this->m_Strides[d] = stride;
+    stride *= static_cast< OffsetValueType >( this->m_Region.GetSize( d ) );
+    }
+
+  const SizeValueType numberOfNodes = this->m_Region.GetNumberOfPixels();
+  this->m_Listed.assign( numberOfNodes, 0 );
+  this->m_Reached.clear();
+  this->m_PropagationBound = this->ComputePropagationBound();
+
+  // the front starts from the initial trial nodes
+  this->m_Neighbors.resize( 1 );
+  while ( !associate->m_Heap.Empty() )
+    {
+    const OffsetValueType offset = static_cast< OffsetValueType >( associate->m_Heap.TopIdentifier() );
+    this->m_Reached.push_back( offset );
+    if ( this->m_Values[offset] <= this->m_PropagationBound )
+      {
+      this->ListNeighbors( offset, this->m_Neighbors[0] );
+      }
+    associate->m_Heap.Pop();
+    }
+  typename AssociateType::PriorityQueueType().Swap( associate->m_Heap );
+  this->MergeNeighbors();
+
+  try
+    {
+    // the first half of the progress is reported as the nodes are reached
+    ProgressReporter progress( associate, 0, numberOfNodes, 100, 0.0f, 0.5f );
+    while ( !this->m_Active.empty() )
+      {
+      this->m_NewValues.resize( this->m_Active.size() );
+      this->ExecutePhase( SolvePhase, this->m_Active.size() );
+      this->ExecutePhase( UpdatePhase, this->m_Active.size() );
+      this->MergeNeighbors();
+
+      for ( size_t t = 0; t < this->m_NewlyReached.size(); ++t )
+        {
+        std::vector< OffsetValueType > & newlyReached = this->m_NewlyReached[t];
+        for ( size_t i = 0; i < newlyReached.size(); ++i )
+          {
+          this->m_Reached.push_back( newlyReached[i] );
+          progress.CompletedPixel();
+          }
+        newlyReached.clear();
+        }
+      this->m_PropagationBound = this->ComputePropagationBound();
+      }
+    std::vector< unsigned char >().swap( this->m_Listed );
+    std::vector< OffsetValueType >().swap( this->m_Active );
+    std::vector< OutputPixelType >().swap( this->m_NewValues );
+
+    this->ExecutePhase( SortPhase, this->m_Reached.size() );
+    this->ApplyStoppingCriterion();
+    std::vector< ValueOffsetPairListType >().swap( this->m_Sorted );
+    }
+  catch ( ProcessAborted & )
+    {
+    std::vector< unsigned char >().swap( this->m_Listed );
+    std::vector< OffsetValueType >().swap( this->m_Active );
+    std::vector< OutputPixelType >().swap( this->m_NewValues );
+    std::vector< std::vector< OffsetValueType > >().swap( this->m_Neighbors );
+    std::vector< std::vector< OffsetValueType > >().swap( this->m_NewlyReached );
+    std::vector< OffsetValueType >().swap( this->m_Reached );
+    std::vector< ValueOffsetPairListType >().swap( this->m_Sorted );
+    throw;
+    }
+
+  this->ExecutePhase( TrialPhase, this->m_Reached.size() );
+  this->ExecutePhase( LabelPhase, this->m_Reached.size() );
+  std::vector< OffsetValueType >().swap( this->m_Reached );
+}
+
+template< typename TAssociate >
+void
+FastMarchingImageFilterBaseThreader< TAssociate >
+::ExecutePhase( PhaseType phase, SizeValueType numberOfElements )
+{
+  if ( numberOfElements == 0 )
+    {
+    return;
+    }
+  this->m_Phase = phase;
+
+  IndexRangeType range;
+  range[0] = 0;
+  range[1] = numberOfElements - 1;
+  this->Execute( this->m_Associate, range );
+}
+
+template< typename TAssociate >
+void
+FastMarchingImageFilterBaseThreader< TAssociate >
+::BeforeThreadedExecution()
+{
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  if ( this->m_Phase == UpdatePhase )
+    {
+    this->m_Neighbors.resize( numberOfThreads );
+    this->m_NewlyReached.resize( numberOfThreads );
+    }
+  else if ( this->m_Phase == SortPhase )
+    {
+    this->m_Sorted.clear();
+    this->m_Sorted.resize( numberOfThreads );
+    }
+}
+
+template< typename TAssociate >
+void
+FastMarchingImageFilterBaseThreader< TAssociate >
+::ThreadedExecution( const IndexRangeType & subrange, const ThreadIdType threadId )
+{
+  switch ( this->m_Phase )
+    {
+    case SolvePhase:
+      for ( IndexValueType i = subrange[0]; i <= subrange[1]; ++i )
+        {
+        this->m_NewValues[i] = this->SolveNode( this->m_Active[i] );
+        }
+      break;
+    case UpdatePhase:
+      {
+      std::vector< OffsetValueType > & neighbors = this->m_Neighbors[threadId];
+      std::vector< OffsetValueType > & newlyReached = this->m_NewlyReached[threadId];
+      for ( IndexValueType i = subrange[0]; i <= subrange[1]; ++i )
+        {
+        const OffsetValueType offset = this->m_Active[i];
+        const OutputPixelType value = this->m_NewValues[i];
+        if ( value < this->m_Values[offset] )
+          {
+          if ( !( this->m_Values[offset] < this->m_LargeValue ) )
+            {
+            newlyReached.push_back( offset );
+            }
+          this->m_Values[offset] = value;
+          // the nodes past the bound are never made alive
+          if ( value <= this->m_PropagationBound )
+            {
+            this->ListNeighbors( offset, neighbors );
+            }
+          }
+        }
+      break;
+      }
+    case SortPhase:
+      {
+      ValueOffsetPairListType & sorted = this->m_Sorted[threadId];
+      for ( IndexValueType i = subrange[0]; i <= subrange[1]; ++i )
+        {
+        const OffsetValueType offset = this->m_Reached[i];
+        const unsigned char   label = this->m_Labels[offset];
+        if ( ( label == Traits::Far || label == Traits::InitialTrial ) && this->m_Values[offset] < this->m_LargeValue )
+          {
+          sorted.push_back( ValueOffsetPairType( this->m_Values[offset], offset ) );
+          }
+        }
+      std::sort( sorted.begin(), sorted.end() );
+      break;
+      }
+    case TrialPhase:
+      for ( IndexValueType i = subrange[0]; i <= subrange[1]; ++i )
+        {
+        const OffsetValueType offset = this->m_Reached[i];
+        if ( this->m_Labels[offset] == Traits::Far && this->m_Values[offset] < this->m_LargeValue )
+          {
+          // the value given by the sequential solver to its trial nodes
+          const NodeType             node = this->m_Output->ComputeIndex( offset );
+          InternalNodeStructureArray nodesUsed;
+          this->m_Associate->GetInternalNodesUsed( this->m_Output, node, nodesUsed );
+
+          OutputPixelType value = this->m_LargeValue;
+          for ( unsigned int j = 0; j < ImageDimension; ++j )
+            {
+            if ( nodesUsed[j].m_Value < this->m_LargeValue )
+              {
+              value = static_cast< OutputPixelType >( this->m_Associate->Solve( this->m_Output, node, nodesUsed ) );
+              break;
+              }
+            }
+          this->m_Values[offset] = value < this->m_LargeValue ? value : this->m_LargeValue;
+          }
+        }
+      break;
+    case LabelPhase:
+      for ( IndexValueType i = subrange[0]; i <= subrange[1]; ++i )
+        {
+        const OffsetValueType offset = this->m_Reached[i];
+        if ( this->m_Labels[offset] == Traits::Far && this->m_Values[offset] < this->m_LargeValue )
+          {
+          this->m_Labels[offset] = Traits::Trial;
+          }
+        }
+      break;
+    }
+}
+
+template< typename TAssociate >
+void
+FastMarchingImageFilterBaseThreader< TAssociate >
+::ListNeighbors( OffsetValueType offset, std::vector< OffsetValueType > & neighbors ) const
+{
+  const NodeType node = this->m_Output->ComputeIndex( offset );
+  for ( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    const OffsetValueType start = this->m_Region.GetIndex( j );
+    const OffsetValueType last = start + static_cast< OffsetValueType >( this->m_Region.GetSize( j ) ) - 1;
+    if ( node[j] > start && CanPropagateTo( this->m_Labels[offset - this->m_Strides[j]] ) )
+      {
+      neighbors.push_back( offset - this->m_Strides[j] );
+      }
+    if ( node[j] < last && CanPropagateTo( this->m_Labels[offset + this->m_Strides[j]] ) )
+      {
+      neighbors.push_back( offset + this->m_Strides[j] );
+      }
+    }
+}
+
+template< typename TAssociate >
+typename FastMarchingImageFilterBaseThreader< TAssociate >::OutputPixelType
+FastMarchingImageFilterBaseThreader< TAssociate >
+::SolveNode( OffsetValueType offset ) const
+{
+  const NodeType             node = this->m_Output->ComputeIndex( offset );
+  InternalNodeStructureArray neighbors;
+  bool                       reached = false;
+
+  // the smallest reached neighbor along each axis
+  for ( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    InternalNodeStructure neighbor;
+    neighbor.m_Node = node;
+    neighbor.m_Value = this->m_LargeValue;
+    neighbor.m_Axis = j;
+
+    const OffsetValueType start = this->m_Region.GetIndex( j );
+    const OffsetValueType last = start + static_cast< OffsetValueType >( this->m_Region.GetSize( j ) ) - 1;
+    for ( int s = -1; s < 2; s += 2 )
+      {
+      const OffsetValueType index = node[j] + s;
+      if ( index >= start && index <= last )
+        {
+        const OffsetValueType neighborOffset = offset + s * this->m_Strides[j];
+        if ( this->m_Labels[neighborOffset] != Traits::Forbidden
+             && this->m_Values[neighborOffset] < neighbor.m_Value )
+          {
+          neighbor.m_Value = this->m_Values[neighborOffset];
+          neighbor.m_Node[j] = index;
+          reached = true;
+          }
+        }
+      }
+    neighbors[j] = neighbor;
+    }
+
+  if ( !reached )
+    {
+    return this->m_LargeValue;
+    }
+  const OutputPixelType value =
+    static_cast< OutputPixelType >( this->m_Associate->Solve( this->m_Output, node, neighbors ) );
+  return value < this->m_LargeValue ? value : this->m_LargeValue;
+}
+
+template< typename TAssociate >
+void
+FastMarchingImageFilterBaseThreader< TAssociate >
+::MergeNeighbors()
+{
+  this->m_Active.clear();
+  for ( size_t t = 0; t < this->m_Neighbors.size(); ++t )
+    {
+    std::vector< OffsetValueType > & neighbors = this->m_Neighbors[t];
+    for ( size_t i = 0; i < neighbors.size(); ++i )
+      {
+      if ( !this->m_Listed[neighbors[i]] )
+        {
+        this->m_Listed[neighbors[i]] = 1;
+        this->m_Active.push_back( neighbors[i] );
+        }
+      }
+    neighbors.clear();
+    }
+  for ( size_t i = 0; i < this->m_Active.size(); ++i )
+    {
+    this->m_Listed[this->m_Active[i]] = 0;
+    }
+}
+
+template< typename TAssociate >
+typename FastMarchingImageFilterBaseThreader< TAssociate >::OutputPixelType
+FastMarchingImageFilterBaseThreader< TAssociate >
+::ComputePropagationBound() const
+{
+  typedef typename TAssociate::InputImageType                                                InputImageType;
+  typedef FastMarchingThresholdStoppingCriterion< InputImageType, OutputImageType >          ThresholdCriterionType;
+  typedef FastMarchingReachedTargetNodesStoppingCriterion< InputImageType, OutputImageType > TargetCriterionType;
+
+  typename AssociateType::StoppingCriterionType * criterion = this->m_Associate->m_StoppingCriterion;
+
+  ThresholdCriterionType * threshold = dynamic_cast< ThresholdCriterionType * >( criterion );
+  if ( threshold )
+    {
+    return threshold->GetThreshold() < this->m_LargeValue ? threshold->GetThreshold() : this->m_LargeValue;
+    }
+
+  TargetCriterionType * target = dynamic_cast< TargetCriterionType * >( criterion );
+  if ( !target )
+    {
+    return this->m_LargeValue;
+    }
+
+  // the criterion is satisfied past the value at which the targets are
+  // reached plus the offset; the current values of the targets are not
+  // below their final values, and the stopping value is computed from the
+  // value of the previous alive node, which is zero at first
+  const std::vector< NodeType > & targetNodes = target->GetTargetNodes();
+  std::vector< OffsetValueType >  offsets;
+  for ( size_t i = 0; i < targetNodes.size(); ++i )
+    {
+    if ( this->m_Region.IsInside( targetNodes[i] ) )
+      {
+      const OffsetValueType offset = this->m_Output->ComputeOffset( targetNodes[i] );
+      const unsigned char   label = this->m_Labels[offset];
+      if ( label != Traits::Alive && label != Traits::Forbidden )
+        {
+        offsets.push_back( offset );
+        }
+      }
+    }
+  std::sort( offsets.begin(), offsets.end() );
+  offsets.erase( std::unique( offsets.begin(), offsets.end() ), offsets.end() );
+
+  const size_t numberOfTargets = target->GetNumberOfTargetsToBeReached();
+  if ( numberOfTargets == 0 || offsets.size() < numberOfTargets )
+    {
+    return this->m_LargeValue;
+    }
+
+  std::vector< OutputPixelType > values( offsets.size() );
+  for ( size_t i = 0; i < offsets.size(); ++i )
+    {
+    values[i] = this->m_Values[offsets[i]];
+    }
+  std::nth_element( values.begin(), values.begin() + ( numberOfTargets - 1 ), values.end() );
+  const OutputPixelType reachedValue = values[numberOfTargets - 1];
+  if ( !( reachedValue < this->m_LargeValue ) )
+    {
+    return this->m_LargeValue;
+    }
+
+  const OutputPixelType zero = NumericTraits< OutputPixelType >::ZeroValue();
+  const OutputPixelType bound = ( reachedValue > zero ? reachedValue : zero ) + target->GetTargetOffset();
+  return bound < this->m_LargeValue ? bound : this->m_LargeValue;
+}
+
+template< typename TAssociate >
+void
+FastMarchingImageFilterBaseThreader< TAssociate >
+::ApplyStoppingCriterion()
+{
+  AssociateType * associate = this->m_Associate;
+
+  // merge the sorted lists of the threads
+  typedef std::pair< ValueOffsetPairType, size_t > HeadType;
+  std::priority_queue< HeadType, std::vector< HeadType >, std::greater< HeadType > > heads;
+  std::vector< size_t > positions( this->m_Sorted.size(), 0 );
+  for ( size_t t = 0; t < this->m_Sorted.size(); ++t )
+    {
+    if ( !this->m_Sorted[t].empty() )
+      {
+      heads.push( HeadType( this->m_Sorted[t][0], t ) );
+      }
+    }
+
+  // the second half of the progress is reported as the nodes are made alive
+  ProgressReporter progress( associate, 0, this->m_Reached.size(), 100, 0.5f, 0.5f );
+  OutputPixelType  currentValue = NumericTraits< OutputPixelType >::ZeroValue();
+
+  while ( !heads.empty() )
+    {
+    const HeadType head = heads.top();
+    heads.pop();
+    const size_t t = head.second;
+    if ( ++positions[t] < this->m_Sorted[t].size() )
+      {
+      heads.push( HeadType( this->m_Sorted[t][positions[t]], t ) );
+      }
+
+    const OffsetValueType offset = head.first.second;
+    currentValue = head.first.first;
+
+    const NodePairType nodePair( this->m_Output->ComputeIndex( offset ), currentValue );
+    associate->m_StoppingCriterion->SetCurrentNodePair( nodePair );
+    if ( associate->m_StoppingCriterion->IsSatisfied() )
+      {
+      break;
+      }
+
+    if ( associate->m_CollectPoints )
+      {
+      associate->m_ProcessedPoints->push_back( nodePair );
+      }
+    this->m_Labels[offset] = Traits::Alive;
+    progress.CompletedPixel();
+    }
+
+  associate->m_TargetReachedValue = currentValue;
+}
+
+} // end namespace itk
+
+#endif
@@ -47,6 +47,14 @@ FastMarchingQuadEdgeMeshFilterBase< TInput, TOutput >
   return this->GetInput()->GetNumberOfPoints();
 }
 
+template< typename TInput, typename TOutput >
+IdentifierType
+FastMarchingQuadEdgeMeshFilterBase< TInput, TOutput >
+::GetNodeIdentifier( const NodeType& iNode ) const
+{
+  return static_cast< IdentifierType >( iNode );
+}
+
 template< typename TInput, typename TOutput >
 void
 FastMarchingQuadEdgeMeshFilterBase< TInput, TOutput >
@@ -236,7 +244,7 @@ FastMarchingQuadEdgeMeshFilterBase< TInput, TOutput >
 
       this->SetLabelValueForGivenNode( iNode, Traits::Trial );
 
-      this->m_Heap.push( NodePairType( iNode, outputPixel ) );
+      this->m_Heap.Push( this->GetNodeIdentifier( iNode ), NodePairType( iNode, outputPixel ) );
       }
     }
   else
@@ -728,7 +736,7 @@ FastMarchingQuadEdgeMeshFilterBase< TInput, TOutput >
         this->SetLabelValueForGivenNode( idx, Traits::InitialTrial );
         this->SetOutputValue( oMesh, idx, outputPixel );
 
-        this->m_Heap.push( pointsIter->Value() );
+        this->m_Heap.Push( this->GetNodeIdentifier( idx ), pointsIter->Value() );
         }
 
       ++pointsIter;
@@ -82,6 +82,10 @@ public:
     this->Modified();
   }
 
+  /** \brief Get the number of target nodes to be reached, as set by the
+   * target condition once the criterion is initialized */
+  itkGetConstMacro( NumberOfTargetsToBeReached, size_t );
+
   /** \brief Set Target Nodes*/
   virtual void SetTargetNodes( const std::vector< NodeType >& iNodes )
   {
@@ -90,6 +94,12 @@ public:
     this->Modified();
   }
 
+  /** \brief Get Target Nodes*/
+  const std::vector< NodeType >& GetTargetNodes() const
+  {
+    return m_TargetNodes;
+  }
+
   /** \brief Set the current node */
   void SetCurrentNode( const NodeType& iNode ) ITK_OVERRIDE
   {
@@ -102,6 +102,10 @@ protected:
   virtual void ComputeGradient(OutputImageType* oImage,
                                const NodeType& iNode );
 
+  /** The gradient is computed in UpdateNeighbors(), so the front is
+   * always propagated sequentially. */
+  virtual bool CanUseParallelSolver() const ITK_OVERRIDE { return false; }
+
 private:
   FastMarchingUpwindGradientImageFilterBase(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
@@ -0,0 +1,336 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFastMarchingImageFilterBase.h"
+#include "itkFastMarchingThresholdStoppingCriterion.h"
+#include "itkFastMarchingNumberOfElementsStoppingCriterion.h"
+#include "itkFastMarchingReachedTargetNodesStoppingCriterion.h"
+#include "itkCommand.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// Record the progress reported while the front propagates, which is the
+// first half of the progress of the parallel solver.
+class PropagationProgressObject
+{
+public:
+  PropagationProgressObject( itk::ProcessObject * o ) :
+    m_Process( o ), m_NumberOfEvents( 0 ), m_MaximumProgress( 0.0f )
+    {}
+  void ShowProgress()
+    {
+    const float progress = m_Process->GetProgress();
+    if ( progress > 0.0f && progress < 0.5f )
+      {
+      ++m_NumberOfEvents;
+      m_MaximumProgress = std::max( m_MaximumProgress, progress );
+      }
+    }
+  itk::ProcessObject * m_Process;
+  unsigned int         m_NumberOfEvents;
+  float                m_MaximumProgress;
+};
+
+template< typename TImage >
+typename TImage::Pointer
+CreateSpeedImage( const typename TImage::SizeType & size, double spacing )
+{
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  typename TImage::RegionType region( size );
+  typename TImage::SpacingType imageSpacing;
+  imageSpacing.Fill( 1.0 );
+  imageSpacing[0] = spacing;
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( region );
+  image->SetSpacing( imageSpacing );
+  image->Allocate();
+
+  itk::ImageRegionIterator< TImage > it( image, region );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< typename TImage::PixelType >( generator->GetUniformVariate( 0.5, 2.0 ) ) );
+    }
+  return image;
+}
+
+template< typename TImage >
+typename TImage::Pointer
+RunMarcher( TImage * speed,
+            itk::FastMarchingStoppingCriterionBase< TImage, TImage > * criterion,
+            bool parallel,
+            itk::ThreadIdType numberOfThreads,
+            itk::SizeValueType & numberOfProcessedPoints,
+            double & targetReachedValue,
+            float & propagationProgress )
+{
+  typedef itk::FastMarchingImageFilterBase< TImage, TImage > MarcherType;
+  typedef typename MarcherType::NodePairType                 NodePairType;
+  typedef typename MarcherType::NodePairContainerType        NodePairContainerType;
+  typedef typename TImage::IndexType                         IndexType;
+
+  const unsigned int Dimension = TImage::ImageDimension;
+  const typename TImage::SizeType size = speed->GetLargestPossibleRegion().GetSize();
+
+  // an alive seed surrounded by trial nodes, a second trial seed, and a
+  // wall of forbidden nodes with a gap
+  typename NodePairContainerType::Pointer alive = NodePairContainerType::New();
+  typename NodePairContainerType::Pointer trial = NodePairContainerType::New();
+  typename NodePairContainerType::Pointer forbidden = NodePairContainerType::New();
+
+  IndexType seed;
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    seed[d] = size[d] / 3;
+    }
+  alive->push_back( NodePairType( seed, 0.0 ) );
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    for ( int s = -1; s < 2; s += 2 )
+      {
+      IndexType neighbor = seed;
+      neighbor[d] += s;
+      trial->push_back( NodePairType( neighbor, 1.0 ) );
+      }
+    }
+
+  IndexType secondSeed;
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    secondSeed[d] = ( 3 * size[d] ) / 4;
+    }
+  trial->push_back( NodePairType( secondSeed, 2.5 ) );
+
+  // the sequential front does not propagate from the nodes of the image
+  // boundary along the normal axis, hence the boundary is forbidden
+  typename TImage::RegionType interior( size );
+  interior.ShrinkByRadius( 1 );
+  itk::ImageRegionIteratorWithIndex< TImage > it( speed, speed->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( !interior.IsInside( it.GetIndex() ) )
+      {
+      forbidden->push_back( NodePairType( it.GetIndex(), 0.0 ) );
+      }
+    }
+
+  IndexType wall = seed;
+  wall[0] = seed[0] + 4;
+  for ( itk::IndexValueType i = 0; i < static_cast< itk::IndexValueType >( size[1] ) - 5; ++i )
+    {
+    wall[1] = i;
+    forbidden->push_back( NodePairType( wall, 0.0 ) );
+    }
+
+  typename MarcherType::Pointer marcher = MarcherType::New();
+  marcher->SetInput( speed );
+  marcher->SetStoppingCriterion( criterion );
+  marcher->SetAlivePoints( alive );
+  marcher->SetTrialPoints( trial );
+  marcher->SetForbiddenPoints( forbidden );
+  marcher->SetCollectPoints( true );
+  marcher->SetNumberOfThreads( numberOfThreads );
+  marcher->SetUseParallelSolver( parallel );
+
+  PropagationProgressObject progressWatch( marcher );
+  itk::SimpleMemberCommand< PropagationProgressObject >::Pointer command =
+    itk::SimpleMemberCommand< PropagationProgressObject >::New();
+  command->SetCallbackFunction( &progressWatch, &PropagationProgressObject::ShowProgress );
+  marcher->AddObserver( itk::ProgressEvent(), command );
+
+  marcher->Update();
+
+  numberOfProcessedPoints = marcher->GetProcessedPoints()->Size();
+  targetReachedValue = marcher->GetTargetReachedValue();
+  propagationProgress = progressWatch.m_NumberOfEvents > 0 ? progressWatch.m_MaximumProgress : 0.0f;
+
+  typename TImage::Pointer output = marcher->GetOutput();
+  output->DisconnectPipeline();
+  return output;
+}
+
+template< typename TImage >
+bool
+CompareOutputs( TImage * expected, TImage * result, double largeValue )
+{
+  unsigned int numberOfMismatches = 0;
+
+  itk::ImageRegionIteratorWithIndex< TImage > eIt( expected, expected->GetBufferedRegion() );
+  itk::ImageRegionIteratorWithIndex< TImage > rIt( result, result->GetBufferedRegion() );
+  for ( ; !eIt.IsAtEnd(); ++eIt, ++rIt )
+    {
+    const double e = eIt.Get();
+    const double r = rIt.Get();
+    const bool   eReached = e < largeValue;
+    const bool   rReached = r < largeValue;
+    if ( eReached != rReached || ( eReached && std::abs( e - r ) > 1e-4 * ( 1.0 + std::abs( e ) ) ) )
+      {
+      if ( numberOfMismatches++ < 10 )
+        {
+        std::cerr << "Mismatch at " << eIt.GetIndex() << ": expected " << e << ", got " << r << std::endl;
+        }
+      }
+    }
+  return numberOfMismatches == 0;
+}
+
+template< unsigned int VDimension >
+bool
+TestParallelSolver( const itk::Size< VDimension > & size )
+{
+  typedef itk::Image< float, VDimension >                                            ImageType;
+  typedef itk::FastMarchingThresholdStoppingCriterion< ImageType, ImageType >        ThresholdType;
+  typedef itk::FastMarchingNumberOfElementsStoppingCriterion< ImageType, ImageType > NumberOfElementsType;
+  typedef itk::FastMarchingReachedTargetNodesStoppingCriterion< ImageType, ImageType > TargetNodesType;
+  typedef typename ImageType::IndexType                                              IndexType;
+
+  typename ImageType::Pointer speed = CreateSpeedImage< ImageType >( size, 0.75 );
+  const double                largeValue = itk::NumericTraits< float >::max() / 2.0;
+
+  bool  passed = true;
+  float unboundedProgress = 0.0f;
+  for ( unsigned int c = 0; c < 4; ++c )
+    {
+    typename itk::FastMarchingStoppingCriterionBase< ImageType, ImageType >::Pointer criterion;
+    if ( c < 2 )
+      {
+      typename ThresholdType::Pointer threshold = ThresholdType::New();
+      threshold->SetThreshold( c == 0 ? 1.0e6 : 12.0 );
+      criterion = threshold;
+      }
+    else if ( c == 2 )
+      {
+      typename NumberOfElementsType::Pointer numberOfElements = NumberOfElementsType::New();
+      numberOfElements->SetTargetNumberOfElements( size[0] * size[1] / 2 );
+      criterion = numberOfElements;
+      }
+    else
+      {
+      // two of three targets, on both sides of the wall
+      std::vector< IndexType > targets( 3 );
+      for ( unsigned int d = 0; d < VDimension; ++d )
+        {
+        targets[0][d] = size[d] / 2;
+        targets[1][d] = size[d] / 2;
+        targets[2][d] = ( 4 * size[d] ) / 5;
+        }
+      targets[1][0] = size[0] / 5;
+
+      typename TargetNodesType::Pointer targetNodes = TargetNodesType::New();
+      targetNodes->SetTargetCondition( TargetNodesType::SomeTargets );
+      targetNodes->SetNumberOfTargetsToBeReached( 2 );
+      targetNodes->SetTargetOffset( 1.5 );
+      targetNodes->SetTargetNodes( targets );
+      criterion = targetNodes;
+      }
+
+    itk::SizeValueType expectedPoints;
+    double             expectedTarget;
+    float              expectedProgress;
+    typename ImageType::Pointer expected =
+      RunMarcher< ImageType >( speed, criterion, false, 1, expectedPoints, expectedTarget, expectedProgress );
+
+    for ( itk::ThreadIdType threads = 1; threads <= 3; ++threads )
+      {
+      itk::SizeValueType points;
+      double             target;
+      float              progress;
+      typename ImageType::Pointer result =
+        RunMarcher< ImageType >( speed, criterion, true, threads, points, target, progress );
+
+      std::cout << VDimension << "D, criterion " << c << ", " << threads << " threads: "
+                << points << " alive nodes (expected " << expectedPoints << "), propagation progress "
+                << progress << std::endl;
+
+      if ( !CompareOutputs< ImageType >( expected, result, largeValue ) )
+        {
+        passed = false;
+        }
+      // the progress is reported while the front propagates, and the
+      // threshold and the targets stop the propagation before the front
+      // reaches all the nodes the large threshold lets it reach
+      if ( c == 0 )
+        {
+        unboundedProgress = progress;
+        }
+      const bool bounded = c == 1 || c == 3;
+      if ( progress <= 0.0f || ( bounded && progress >= unboundedProgress ) )
+        {
+        std::cerr << "Unexpected propagation progress " << progress << std::endl;
+        passed = false;
+        }
+      // nodes whose values are equal within round-off may be ordered
+      // differently at the stopping value; once all the nodes are alive,
+      // the target reached value of the sequential front is the value of
+      // the last node popped from its heap, which may be any node
+      const itk::SizeValueType difference =
+        points > expectedPoints ? points - expectedPoints : expectedPoints - points;
+      if ( difference > 2
+           || ( c > 0 && std::abs( target - expectedTarget ) > 1e-4 * ( 1.0 + std::abs( expectedTarget ) ) ) )
+        {
+        std::cerr << "Expected " << expectedPoints << " alive nodes up to " << expectedTarget
+                  << ", got " << points << " up to " << target << std::endl;
+        passed = false;
+        }
+      }
+    }
+  return passed;
+}
+
+}
+
+int itkFastMarchingImageFilterBaseParallelSolverTest( int, char* [] )
+{
+  typedef itk::Image< float, 2 >                                    ImageType;
+  typedef itk::FastMarchingImageFilterBase< ImageType, ImageType > MarcherType;
+
+  MarcherType::Pointer marcher = MarcherType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( marcher, FastMarchingImageFilterBase, ImageToImageFilter );
+
+  TEST_SET_GET_VALUE( false, marcher->GetUseParallelSolver() );
+  marcher->UseParallelSolverOn();
+  TEST_SET_GET_VALUE( true, marcher->GetUseParallelSolver() );
+  marcher->UseParallelSolverOff();
+  TEST_SET_GET_VALUE( false, marcher->GetUseParallelSolver() );
+
+  bool passed = true;
+
+  itk::Size< 2 > size2D = {{ 61, 47 }};
+  passed &= TestParallelSolver< 2 >( size2D );
+
+  itk::Size< 3 > size3D = {{ 23, 19, 17 }};
+  passed &= TestParallelSolver< 3 >( size3D );
+
+  if ( !passed )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
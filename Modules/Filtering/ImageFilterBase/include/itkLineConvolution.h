@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLineConvolution_h
+#define itkLineConvolution_h
+
+#include "itkImage.h"
+#include "itkNeighborhood.h"
+#include <vector>
+
+namespace itk
+{
+/** \class LineConvolution
+ * \brief Convolves the lines of an image region with a one dimensional kernel.
+ *
+ * This class computes the same inner products as NeighborhoodInnerProduct
+ * applied with a directional NeighborhoodOperator and a zero flux Neumann
+ * boundary condition, but works a whole line at a time. Each line is
+ * copied, with its boundary padding, into a contiguous scratch buffer and
+ * the kernel is applied one tap at a time over the whole line, which keeps
+ * the inner loop free of boundary checks and lets the compiler vectorize
+ * it. Symmetric kernels are folded so that each pair of taps costs a
+ * single multiplication.
+ *
+ * Lines that are not contiguous in memory are processed in tiles of
+ * adjacent lines, so that the image is read and written along its
+ * contiguous dimension while the tile is transposed into the scratch
+ * buffer.
+ *
+ * The input and the output may be the same image, in which case the
+ * convolution is done in place. A LineConvolution object owns its scratch
+ * buffers and must not be shared between threads.
+ *
+ * \tparam TInputImage   Type of the image read by the convolution.
+ * \tparam TOutputImage  Type of the image written by the convolution.
+ * \tparam TKernelValue  Value type of the kernel coefficients.
+ *
+ * \sa NeighborhoodInnerProduct
+ * \sa NeighborhoodOperatorImageFilter
+ *
+ * \ingroup Operators
+ * \ingroup ITKImageFilterBase
+ */
+template< typename TInputImage, typename TOutputImage, typename TKernelValue >
+class LineConvolution
+{
+public:
+  /** Standard typedefs */
+  typedef LineConvolution Self;
+
+  typedef TInputImage                         InputImageType;
+  typedef TOutputImage                        OutputImageType;
+  typedef typename InputImageType::PixelType  InputPixelType;
+  typedef typename OutputImageType::PixelType OutputPixelType;
+  typedef TKernelValue                        KernelValueType;
+
+  /** Pixel type used for the inner products, as in NeighborhoodInnerProduct. */
+  typedef typename NumericTraits< InputPixelType >::RealType     ComputingPixelType;
+  typedef typename NumericTraits< ComputingPixelType >::ValueType ComputingValueType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+  typedef typename OutputImageType::RegionType RegionType;
+  typedef typename OutputImageType::IndexType  IndexType;
+  typedef std::vector< KernelValueType >       KernelType;
+
+  typedef Neighborhood< KernelValueType, itkGetStaticConstMacro(ImageDimension) > NeighborhoodType;
+
+  /** Number of adjacent lines processed together when the lines are not
+   * contiguous in memory. */
+  itkStaticConstMacro(TileSize, unsigned int, 8);
+
+  LineConvolution();
+
+  /** Set the kernel and the direction along which it is applied. The
+   * kernel must have an odd number of coefficients; the center one is
+   * applied to the pixel being computed. */
+  void SetKernel(unsigned int direction, const KernelType & kernel);
+
+  /** Set the kernel from a neighborhood operator. Returns false, leaving the
+   * kernel unchanged, if the operator extends along more than one
+   * direction. */
+  bool SetKernel(const NeighborhoodType & neighborhood);
+
+  unsigned int GetDirection() const
+  { return m_Direction; }
+
+  /** Set the region of the input which may be read. Samples outside of it
+   * are replaced by the nearest sample inside, as with
+   * ZeroFluxNeumannBoundaryCondition. This region must lie inside the
+   * buffered region of the input. */
+  void SetBoundaryRegion(const RegionType & region)
+  { m_BoundaryRegion = region; }
+
+  const RegionType & GetBoundaryRegion() const
+  { return m_BoundaryRegion; }
+
+  /** Convolve the input and store the result over the output region. The
+   * output region must lie inside the buffered region of the output, and
+   * outside of the convolution direction, inside the boundary region. */
+  void Convolve(const InputImageType *input, OutputImageType *output, const RegionType & outputRegion);
+
+private:
+  void ConvolveBuffer(const ComputingPixelType *in, ComputingPixelType *out, SizeValueType length) const;
+
+  unsigned int                      m_Direction;
+  std::vector< ComputingValueType > m_Kernel;
+  bool                              m_SymmetricKernel;
+  RegionType                        m_BoundaryRegion;
+
+  std::vector< ComputingPixelType > m_LineBuffer;
+  std::vector< ComputingPixelType > m_ResultBuffer;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLineConvolution.hxx"
+#endif
+
+#endif
@@ -0,0 +1,238 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLineConvolution_hxx
+#define itkLineConvolution_hxx
+
+#include "itkLineConvolution.h"
+#include <algorithm>
+
+namespace itk
+{
+template< typename TInputImage, typename TOutputImage, typename TKernelValue >
+LineConvolution< TInputImage, TOutputImage, TKernelValue >
+::LineConvolution() :
+  m_Direction( 0 ),
+  m_Kernel( 1, NumericTraits< ComputingValueType >::OneValue() ),
+  m_SymmetricKernel( true )
+{
+}
+
+template< typename TInputImage, typename TOutputImage, typename TKernelValue >
+void
+LineConvolution< TInputImage, TOutputImage, TKernelValue >
+::SetKernel(unsigned int direction, const KernelType & kernel)
+{
+  if ( direction >= ImageDimension || kernel.size() % 2 == 0 )
+    {
+    itkGenericExceptionMacro( "The kernel must have an odd size and a valid direction" );
+    }
+
+  m_Direction = direction;
+  m_Kernel.resize( kernel.size() );
+  for ( size_t i = 0; i < kernel.size(); ++i )
+    {
+    m_Kernel[i] = static_cast< ComputingValueType >( kernel[i] );
+    }
+
+  const size_t last = m_Kernel.size() - 1;
+  m_SymmetricKernel = true;
+  for ( size_t i = 0; i < m_Kernel.size() / 2; ++i )
+    {
+    if ( m_Kernel[i] != m_Kernel[last - i] )
+      {
+      m_SymmetricKernel = false;
+      break;
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TKernelValue >
+bool
+LineConvolution< TInputImage, TOutputImage, TKernelValue >
+::SetKernel(const NeighborhoodType & neighborhood)
+{
+  unsigned int direction = 0;
+  unsigned int numberOfDirections = 0;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    if ( neighborhood.GetRadius( d ) > 0 )
+      {
+      direction = d;
+      ++numberOfDirections;
+      }
+    }
+  if ( numberOfDirections > 1 )
+    {
+    return false;
+    }
+
+  this->SetKernel( direction, KernelType( neighborhood.Begin(), neighborhood.End() ) );
+  return true;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TKernelValue >
+void
+LineConvolution< TInputImage, TOutputImage, TKernelValue >
+::ConvolveBuffer(const ComputingPixelType *in, ComputingPixelType *out, SizeValueType length) const
+{
+  // Apply the kernel one tap at a time over the whole line; the inner
+  // loops are branch free and stride one.
+  const SizeValueType radius = m_Kernel.size() / 2;
+  if ( m_SymmetricKernel )
+    {
+    const ComputingValueType center = m_Kernel[radius];
+    for ( SizeValueType j = 0; j < length; ++j )
+      {
+      out[j] = in[j + radius] * center;
+      }
+    for ( SizeValueType t = 1; t <= radius; ++t )
+      {
+      const ComputingValueType tap = m_Kernel[radius + t];
+      const ComputingPixelType *left = in + radius - t;
+      const ComputingPixelType *right = in + radius + t;
+      for ( SizeValueType j = 0; j < length; ++j )
+        {
+        out[j] += ( left[j] + right[j] ) * tap;
+        }
+      }
+    }
+  else
+    {
+    const ComputingValueType first = m_Kernel[0];
+    for ( SizeValueType j = 0; j < length; ++j )
+      {
+      out[j] = in[j] * first;
+      }
+    for ( SizeValueType t = 1; t < m_Kernel.size(); ++t )
+      {
+      const ComputingValueType tap = m_Kernel[t];
+      const ComputingPixelType *shifted = in + t;
+      for ( SizeValueType j = 0; j < length; ++j )
+        {
+        out[j] += shifted[j] * tap;
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TKernelValue >
+void
+LineConvolution< TInputImage, TOutputImage, TKernelValue >
+::Convolve(const InputImageType *input, OutputImageType *output, const RegionType & outputRegion)
+{
+  if ( outputRegion.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  const unsigned int    direction = m_Direction;
+  const OffsetValueType radius = static_cast< OffsetValueType >( m_Kernel.size() / 2 );
+
+  // Extent of the lines, and of the samples which may be read along them.
+  const IndexValueType lineBegin = outputRegion.GetIndex( direction );
+  const SizeValueType  lineLength = outputRegion.GetSize( direction );
+  const SizeValueType  paddedLength = lineLength + 2 * radius;
+  const IndexValueType lowerBound = m_BoundaryRegion.GetIndex( direction );
+  const IndexValueType upperBound = lowerBound + static_cast< IndexValueType >( m_BoundaryRegion.GetSize( direction ) ) - 1;
+
+  // Lines along a non contiguous direction are grouped in tiles of lines
+  // adjacent along the first, contiguous, dimension.
+  const bool          tiled = ( direction != 0 );
+  const SizeValueType tileExtent = tiled ? outputRegion.GetSize( 0 ) : 1;
+  const SizeValueType tileSize = std::min( tileExtent, static_cast< SizeValueType >( TileSize ) );
+
+  m_LineBuffer.resize( tileSize * paddedLength );
+  m_ResultBuffer.resize( tileSize * lineLength );
+
+  const InputPixelType  *inputBuffer = input->GetBufferPointer();
+  OutputPixelType       *outputBuffer = output->GetBufferPointer();
+  const IndexValueType   inputStart = input->GetBufferedRegion().GetIndex( direction );
+  const IndexValueType   outputStart = output->GetBufferedRegion().GetIndex( direction );
+  const OffsetValueType  inputStride = input->GetOffsetTable()[direction];
+  const OffsetValueType  outputStride = output->GetOffsetTable()[direction];
+
+  // Visit the first pixel of each tile.
+  RegionType tileStarts = outputRegion;
+  tileStarts.SetSize( direction, 1 );
+  tileStarts.SetSize( 0, 1 );
+  const SizeValueType numberOfTileStarts = tileStarts.GetNumberOfPixels();
+
+  IndexType index = tileStarts.GetIndex();
+  index[direction] = inputStart;
+  for ( SizeValueType n = 0; n < numberOfTileStarts; ++n )
+    {
+    for ( SizeValueType x = 0; x < tileExtent; x += tileSize )
+      {
+      const SizeValueType numberOfLines = std::min( tileSize, tileExtent - x );
+
+      IndexType lineIndex = index;
+      if ( tiled )
+        {
+        lineIndex[0] += static_cast< IndexValueType >( x );
+        }
+
+      // Gather the padded lines, transposing the tile.
+      lineIndex[direction] = inputStart;
+      const InputPixelType *inputLine = inputBuffer + input->ComputeOffset( lineIndex );
+      for ( SizeValueType k = 0; k < paddedLength; ++k )
+        {
+        const IndexValueType position = std::min( std::max( lineBegin - radius + static_cast< IndexValueType >( k ),
+                                                            lowerBound ), upperBound );
+        const InputPixelType *sample = inputLine + ( position - inputStart ) * inputStride;
+        for ( SizeValueType l = 0; l < numberOfLines; ++l )
+          {
+          m_LineBuffer[l * paddedLength + k] = static_cast< ComputingPixelType >( sample[l] );
+          }
+        }
+
+      for ( SizeValueType l = 0; l < numberOfLines; ++l )
+        {
+        this->ConvolveBuffer( &( m_LineBuffer[l * paddedLength] ), &( m_ResultBuffer[l * lineLength] ), lineLength );
+        }
+
+      // Scatter the results, transposing the tile back.
+      lineIndex[direction] = outputStart;
+      OutputPixelType *outputLine = outputBuffer + output->ComputeOffset( lineIndex );
+      for ( SizeValueType k = 0; k < lineLength; ++k )
+        {
+        OutputPixelType *pixel = outputLine + ( lineBegin + static_cast< IndexValueType >( k ) - outputStart ) * outputStride;
+        for ( SizeValueType l = 0; l < numberOfLines; ++l )
+          {
+          pixel[l] = static_cast< OutputPixelType >( m_ResultBuffer[l * lineLength + k] );
+          }
+        }
+      }
+
+    // Move to the next tile start.
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      if ( d == direction )
+        {
+        continue;
+        }
+      if ( ++index[d] < tileStarts.GetIndex( d ) + static_cast< IndexValueType >( tileStarts.GetSize( d ) ) )
+        {
+        break;
+        }
+      index[d] = tileStarts.GetIndex( d );
+      }
+    }
+}
+} // end namespace itk
+
+#endif
@@ -22,6 +22,7 @@
 #include "itkNeighborhoodOperator.h"
 #include "itkImage.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "itkIsSame.h"
 
 namespace itk
 {
@@ -35,6 +36,11 @@ namespace itk
  * with the image region.  Apply the mirror()'d operator for
  * non-symmetric NeighborhoodOperators.
  *
+ * Operators that extend along a single direction, such as the ones
+ * created by NeighborhoodOperator::CreateDirectional(), are applied a
+ * line at a time with LineConvolution when the default boundary
+ * condition is used and both images are itk::Image.
+ *
  * \ingroup ImageFilters
  *
  * \sa Image
@@ -176,6 +182,18 @@ private:
   NeighborhoodOperatorImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
+  /** LineConvolution accesses the pixel buffers directly. */
+  typedef typename mpl::And< mpl::IsSame< InputImageType, Image< InputPixelType, itkGetStaticConstMacro(InputImageDimension) > >,
+                             mpl::IsSame< OutputImageType, Image< OutputPixelType, itkGetStaticConstMacro(ImageDimension) > > >::Type
+    LineConvolutionSupportType;
+
+  /** Apply a directional operator a line at a time. Returns false if the
+   * operator is not directional. */
+  bool ThreadedGenerateDataWithLineConvolution(const OutputImageRegionType & outputRegionForThread,
+                                               ThreadIdType threadId, mpl::TrueType);
+  bool ThreadedGenerateDataWithLineConvolution(const OutputImageRegionType &, ThreadIdType, mpl::FalseType)
+  { return false; }
+
   /** Internal operator used to filter the image. */
   OutputNeighborhoodType m_Operator;
 
@@ -22,6 +22,7 @@
 
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkNeighborhoodInnerProduct.h"
+#include "itkLineConvolution.h"
 #include "itkImageRegionIterator.h"
 #include "itkConstNeighborhoodIterator.h"
 #include "itkProgressReporter.h"
@@ -83,6 +84,13 @@ NeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
+  if ( m_BoundsCondition == &m_DefaultBoundaryCondition
+       && this->ThreadedGenerateDataWithLineConvolution( outputRegionForThread, threadId,
+                                                         LineConvolutionSupportType() ) )
+    {
+    return;
+    }
+
   typedef NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< InputImageType >
   BFC;
 
@@ -131,6 +139,29 @@ NeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
       }
     }
 }
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+bool
+NeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::ThreadedGenerateDataWithLineConvolution(const OutputImageRegionType & outputRegionForThread,
+                                          ThreadIdType threadId, mpl::TrueType)
+{
+  LineConvolution< InputImageType, OutputImageType, OperatorValueType > lineConvolution;
+  if ( !lineConvolution.SetKernel( m_Operator ) )
+    {
+    return false;
+    }
+
+  ProgressReporter progress( this, threadId, 1 );
+
+  // The zero flux Neumann condition replicates the edge of the buffer.
+  const InputImageType *input = this->GetInput();
+  lineConvolution.SetBoundaryRegion( input->GetBufferedRegion() );
+  lineConvolution.Convolve( input, this->GetOutput(), outputRegionForThread );
+
+  progress.CompletedPixel();
+  return true;
+}
 } // end namespace itk
 
 #endif
@@ -23,6 +23,7 @@
 #include "itkImageLinearIteratorWithIndex.h"
 #include "itkProgressReporter.h"
 #include <new>
+#include <vector>
 
 namespace itk
 {
@@ -170,6 +171,116 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
     }
 }
 
+/**
+ * Apply Recursive Filter to a batch of interleaved lines
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::FilterDataArrayBatch(ScalarRealType *outs, const ScalarRealType *data,
+                       ScalarRealType *scratch, SizeValueType ln)
+{
+  // signed, as the anti-causal pass uses negative offsets
+  const OffsetValueType W = BatchSize;
+
+  // local copies, which the compiler knows are not aliased by the arrays
+  const ScalarRealType n0 = m_N0;
+  const ScalarRealType n1 = m_N1;
+  const ScalarRealType n2 = m_N2;
+  const ScalarRealType n3 = m_N3;
+  const ScalarRealType d1 = m_D1;
+  const ScalarRealType d2 = m_D2;
+  const ScalarRealType d3 = m_D3;
+  const ScalarRealType d4 = m_D4;
+  const ScalarRealType m1 = m_M1;
+  const ScalarRealType m2 = m_M2;
+  const ScalarRealType m3 = m_M3;
+  const ScalarRealType m4 = m_M4;
+  const ScalarRealType bn1 = m_BN1;
+  const ScalarRealType bn2 = m_BN2;
+  const ScalarRealType bn3 = m_BN3;
+  const ScalarRealType bn4 = m_BN4;
+  const ScalarRealType bm1 = m_BM1;
+  const ScalarRealType bm2 = m_BM2;
+  const ScalarRealType bm3 = m_BM3;
+  const ScalarRealType bm4 = m_BM4;
+
+  ScalarRealType * scratch1 = outs;
+  ScalarRealType * scratch2 = scratch;
+
+  /**
+   * Causal direction pass, same operations as in FilterDataArray
+   */
+  for ( OffsetValueType l = 0; l < W; ++l )
+    {
+    const ScalarRealType   outV1 = data[l];
+    const ScalarRealType * x = data + l;
+    ScalarRealType *       y = scratch1 + l;
+
+    y[0]     = outV1   * n0 + outV1   * n1 + outV1   * n2 + outV1 * n3;
+    y[W]     = x[W]    * n0 + outV1   * n1 + outV1   * n2 + outV1 * n3;
+    y[2 * W] = x[2 * W] * n0 + x[W]    * n1 + outV1   * n2 + outV1 * n3;
+    y[3 * W] = x[3 * W] * n0 + x[2 * W] * n1 + x[W]    * n2 + outV1 * n3;
+
+    y[0]     -= outV1       * bn1 + outV1       * bn2 + outV1 * bn3 + outV1 * bn4;
+    y[W]     -= y[0]        * d1  + outV1       * bn2 + outV1 * bn3 + outV1 * bn4;
+    y[2 * W] -= y[W]        * d1  + y[0]        * d2  + outV1 * bn3 + outV1 * bn4;
+    y[3 * W] -= y[2 * W]    * d1  + y[W]        * d2  + y[0]  * d3  + outV1 * bn4;
+    }
+
+  for ( SizeValueType i = 4; i < ln; ++i )
+    {
+    const ScalarRealType * x = data + i * W;
+    ScalarRealType *       y = scratch1 + i * W;
+    for ( OffsetValueType l = 0; l < W; ++l )
+      {
+      ScalarRealType value = x[l] * n0 + x[l - W] * n1 + x[l - 2 * W] * n2 + x[l - 3 * W] * n3;
+      value -= y[l - W] * d1 + y[l - 2 * W] * d2 + y[l - 3 * W] * d3 + y[l - 4 * W] * d4;
+      y[l] = value;
+      }
+    }
+
+  /**
+   * AntiCausal direction pass
+   */
+  for ( OffsetValueType l = 0; l < W; ++l )
+    {
+    const ScalarRealType * x = data + ( ln - 1 ) * W + l;
+    ScalarRealType *       y = scratch2 + ( ln - 1 ) * W + l;
+    const ScalarRealType   outV2 = x[0];
+
+    y[0]      = outV2     * m1 + outV2     * m2 + outV2 * m3 + outV2 * m4;
+    y[-W]     = x[0]      * m1 + outV2     * m2 + outV2 * m3 + outV2 * m4;
+    y[-2 * W] = x[-W]     * m1 + x[0]      * m2 + outV2 * m3 + outV2 * m4;
+    y[-3 * W] = x[-2 * W] * m1 + x[-W]     * m2 + x[0]  * m3 + outV2 * m4;
+
+    y[0]      -= outV2    * bm1 + outV2 * bm2 + outV2 * bm3 + outV2 * bm4;
+    y[-W]     -= y[0]     * d1  + outV2 * bm2 + outV2 * bm3 + outV2 * bm4;
+    y[-2 * W] -= y[-W]    * d1  + y[0]  * d2  + outV2 * bm3 + outV2 * bm4;
+    y[-3 * W] -= y[-2 * W] * d1 + y[-W] * d2  + y[0]  * d3  + outV2 * bm4;
+    }
+
+  for ( SizeValueType i = ln - 4; i > 0; --i )
+    {
+    const ScalarRealType * x = data + i * W;
+    ScalarRealType *       y = scratch2 + ( i - 1 ) * W;
+    for ( OffsetValueType l = 0; l < W; ++l )
+      {
+      ScalarRealType value = x[l] * m1 + x[l + W] * m2 + x[l + 2 * W] * m3 + x[l + 3 * W] * m4;
+      value -= y[l + W] * d1 + y[l + 2 * W] * d2 + y[l + 3 * W] * d3 + y[l + 4 * W] * d4;
+      y[l] = value;
+      }
+    }
+
+  /**
+   * Roll the antiCausal part into the output
+   */
+  for ( SizeValueType i = 0; i < ln * W; ++i )
+    {
+    outs[i] += scratch2[i];
+    }
+}
+
 //
 // we need all of the image in just the "Direction" we are separated into
 //
@@ -248,12 +359,111 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 
 /**
  * Compute Recursive filter
- * line by line in one of the dimensions
+ * in one of the dimensions
  */
 template< typename TInputImage, typename TOutputImage >
 void
 RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
+{
+  this->ThreadedGenerateDataInBatches( outputRegionForThread, threadId, BatchSupportType() );
+}
+
+/**
+ * Compute Recursive filter
+ * BatchSize lines at a time
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataInBatches(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId,
+                                mpl::TrueType)
+{
+  typedef typename TOutputImage::PixelType OutputPixelType;
+
+  typedef ImageLinearConstIteratorWithIndex< TInputImage > InputConstIteratorType;
+  typedef ImageLinearIteratorWithIndex< TOutputImage >     OutputIteratorType;
+
+  typename TInputImage::ConstPointer inputImage( this->GetInputImage () );
+  typename TOutputImage::Pointer     outputImage( this->GetOutput() );
+
+  InputConstIteratorType inputIterator(inputImage,  outputRegionForThread);
+  OutputIteratorType     outputIterator(outputImage, outputRegionForThread);
+
+  inputIterator.SetDirection(this->m_Direction);
+  outputIterator.SetDirection(this->m_Direction);
+
+  const SizeValueType ln = outputRegionForThread.GetSize(this->m_Direction);
+  const unsigned int  W = BatchSize;
+
+  // the unused lanes of the last batch keep finite values
+  std::vector< ScalarRealType > inps( ln * W, NumericTraits< ScalarRealType >::ZeroValue() );
+  std::vector< ScalarRealType > outs( ln * W );
+  std::vector< ScalarRealType > scratch( ln * W );
+
+  std::vector< InputConstIteratorType > inputLanes;
+  std::vector< OutputIteratorType >     outputLanes;
+  inputLanes.reserve( W );
+  outputLanes.reserve( W );
+
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / ln;
+  ProgressReporter   progress(this, threadId, numberOfLinesToProcess, 10);
+
+  inputIterator.GoToBegin();
+  outputIterator.GoToBegin();
+
+  while ( !inputIterator.IsAtEnd() && !outputIterator.IsAtEnd() )
+    {
+    inputLanes.clear();
+    outputLanes.clear();
+    while ( inputLanes.size() < W && !inputIterator.IsAtEnd() && !outputIterator.IsAtEnd() )
+      {
+      inputLanes.push_back( inputIterator );
+      outputLanes.push_back( outputIterator );
+      inputIterator.NextLine();
+      outputIterator.NextLine();
+      }
+    const unsigned int lanes = static_cast< unsigned int >( inputLanes.size() );
+
+    // The lines of a batch are neighbors, so reading them side by side
+    // walks along the same cache lines.
+    for ( SizeValueType i = 0; i < ln; ++i )
+      {
+      for ( unsigned int l = 0; l < lanes; ++l )
+        {
+        inps[i * W + l] = inputLanes[l].Get();
+        ++inputLanes[l];
+        }
+      }
+
+    this->FilterDataArrayBatch(&outs[0], &inps[0], &scratch[0], ln);
+
+    for ( SizeValueType i = 0; i < ln; ++i )
+      {
+      for ( unsigned int l = 0; l < lanes; ++l )
+        {
+        outputLanes[l].Set( static_cast< OutputPixelType >( outs[i * W + l] ) );
+        ++outputLanes[l];
+        }
+      }
+
+    // Although the method name is CompletedPixel(),
+    // this is being called after each line is processed
+    for ( unsigned int l = 0; l < lanes; ++l )
+      {
+      progress.CompletedPixel();
+      }
+    }
+}
+
+/**
+ * Compute Recursive filter
+ * line by line in one of the dimensions
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataLineByLine(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
 {
   typedef typename TOutputImage::PixelType OutputPixelType;
 
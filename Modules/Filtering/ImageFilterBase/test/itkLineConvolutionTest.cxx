@@ -0,0 +1,162 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkLineConvolution.h"
+#include "itkDerivativeOperator.h"
+#include "itkGaussianOperator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+typedef itk::Image< short, 3 > InputImageType;
+typedef itk::Image< float, 3 > OutputImageType;
+
+// Compares a NeighborhoodOperatorImageFilter running the line convolution
+// with one using the neighborhood iterator, which is forced by overriding
+// the boundary condition.
+int
+LineConvolutionTestCompare( const InputImageType * input,
+                            const itk::Neighborhood< float, 3 > & oper,
+                            const OutputImageType::RegionType & requestedRegion )
+{
+  typedef itk::NeighborhoodOperatorImageFilter< InputImageType, OutputImageType, float > FilterType;
+
+  FilterType::Pointer lineFilter = FilterType::New();
+  lineFilter->SetInput( input );
+  lineFilter->SetOperator( oper );
+  lineFilter->GetOutput()->SetRequestedRegion( requestedRegion );
+  TRY_EXPECT_NO_EXCEPTION( lineFilter->Update() );
+
+  itk::ZeroFluxNeumannBoundaryCondition< InputImageType > boundaryCondition;
+  FilterType::Pointer neighborhoodFilter = FilterType::New();
+  neighborhoodFilter->SetInput( input );
+  neighborhoodFilter->SetOperator( oper );
+  neighborhoodFilter->OverrideBoundaryCondition( &boundaryCondition );
+  neighborhoodFilter->GetOutput()->SetRequestedRegion( requestedRegion );
+  TRY_EXPECT_NO_EXCEPTION( neighborhoodFilter->Update() );
+
+  itk::ImageRegionConstIteratorWithIndex< OutputImageType > lineIt( lineFilter->GetOutput(), requestedRegion );
+  itk::ImageRegionConstIteratorWithIndex< OutputImageType > neighborhoodIt( neighborhoodFilter->GetOutput(),
+                                                                           requestedRegion );
+  for ( ; !lineIt.IsAtEnd(); ++lineIt, ++neighborhoodIt )
+    {
+    const float expected = neighborhoodIt.Get();
+    if ( std::fabs( lineIt.Get() - expected ) > 1e-5 * ( 1.0 + std::fabs( expected ) ) )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error at index " << lineIt.GetIndex() << " for the operator of radius "
+                << oper.GetRadius() << std::endl;
+      std::cerr << "Expected value " << expected << std::endl;
+      std::cerr << " differs from " << lineIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+}
+
+int itkLineConvolutionTest( int, char* [] )
+{
+  InputImageType::SizeType size;
+  size[0] = 23;
+  size[1] = 17;
+  size[2] = 9;
+
+  InputImageType::Pointer input = InputImageType::New();
+  input->SetRegions( size );
+  input->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  itk::ImageRegionIterator< InputImageType > it( input, input->GetBufferedRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< short >( generator->GetIntegerVariate( 2000 ) ) - 1000 );
+    }
+
+  // The whole image and a region away from some of the borders.
+  OutputImageType::RegionType subregion;
+  subregion.SetIndex( 0, 3 );
+  subregion.SetIndex( 1, 0 );
+  subregion.SetIndex( 2, 2 );
+  subregion.SetSize( 0, 11 );
+  subregion.SetSize( 1, 13 );
+  subregion.SetSize( 2, 7 );
+
+  std::vector< OutputImageType::RegionType > regions;
+  regions.push_back( input->GetLargestPossibleRegion() );
+  regions.push_back( subregion );
+
+  int status = EXIT_SUCCESS;
+  for ( unsigned int direction = 0; direction < 3; ++direction )
+    {
+    // Symmetric kernels, including one wider than the image.
+    const double variances[] = { 0.5, 4.0, 50.0 };
+    for ( unsigned int v = 0; v < 3; ++v )
+      {
+      itk::GaussianOperator< float, 3 > gaussian;
+      gaussian.SetDirection( direction );
+      gaussian.SetVariance( variances[v] );
+      gaussian.SetMaximumKernelWidth( 64 );
+      gaussian.CreateDirectional();
+      for ( unsigned int r = 0; r < regions.size(); ++r )
+        {
+        if ( LineConvolutionTestCompare( input, gaussian, regions[r] ) != EXIT_SUCCESS )
+          {
+          status = EXIT_FAILURE;
+          }
+        }
+      }
+
+    // Antisymmetric kernel
+    itk::DerivativeOperator< float, 3 > derivative;
+    derivative.SetDirection( direction );
+    derivative.SetOrder( 1 );
+    derivative.CreateDirectional();
+    for ( unsigned int r = 0; r < regions.size(); ++r )
+      {
+      if ( LineConvolutionTestCompare( input, derivative, regions[r] ) != EXIT_SUCCESS )
+        {
+        status = EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Operators which are not directional are not handled by LineConvolution.
+  itk::Neighborhood< float, 3 > box;
+  box.SetRadius( 1 );
+  for ( unsigned int i = 0; i < box.Size(); ++i )
+    {
+    box[i] = 1.0f / 27.0f;
+    }
+  itk::LineConvolution< InputImageType, OutputImageType, float > lineConvolution;
+  TEST_EXPECT_TRUE( !lineConvolution.SetKernel( box ) );
+  if ( LineConvolutionTestCompare( input, box, subregion ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  return status;
+}
@@ -79,7 +79,6 @@ LabelShapeOpeningImageFilter< TInputImage >
 
   typename LabelObjectValuatorType::Pointer valuator = LabelObjectValuatorType::New();
   valuator->SetInput( labelizer->GetOutput() );
-  valuator->SetLabelImage( this->GetInput() );
   valuator->SetNumberOfThreads( this->GetNumberOfThreads() );
   if ( m_Attribute != LabelObjectType::PERIMETER && m_Attribute != LabelObjectType::ROUNDNESS )
     {
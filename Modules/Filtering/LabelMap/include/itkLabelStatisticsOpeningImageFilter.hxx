@@ -81,7 +81,6 @@ LabelStatisticsOpeningImageFilter< TInputImage, TFeatureImage >
   typename LabelObjectValuatorType::Pointer valuator = LabelObjectValuatorType::New();
   valuator->SetInput( labelizer->GetOutput() );
   valuator->SetFeatureImage( this->GetFeatureImage() );
-  valuator->SetLabelImage( this->GetInput() );
   valuator->SetNumberOfThreads( this->GetNumberOfThreads() );
   valuator->SetComputeHistogram(false);
   if ( m_Attribute != LabelObjectType::PERIMETER && m_Attribute != LabelObjectType::ROUNDNESS )
@@ -19,6 +19,7 @@
 #define itkShapeLabelMapFilter_h
 
 #include "itkInPlaceLabelMapFilter.h"
+#include <vector>
 
 namespace itk
 {
@@ -28,15 +29,13 @@ namespace itk
  * ShapeLabelMapFilter can be used to set the attributes values of the
  * ShapeLabelObject in a LabelMap.
  *
- * ShapeLabelMapFilter takes an optional parameter, used only to
- * optimize the computation time and the memory usage when the
- * perimeter or the feret diameter is used: the exact copy of the
- * input LabelMap is stored in an Image.
- * It can be set with SetLabelImage(). It is cleared at the end of the
- * computation, so must be reset before running Update() again. It is
- * not part of the pipeline management design, to let the subclasses
- * of ShapeLabelMapFilter use the pipeline design to specify truly
- * required inputs.
+ * All the attributes are computed directly from the lines of the label
+ * objects. The feret diameter is searched between the vertices of the
+ * convex hull of the line ends, computed in each plane of the first two
+ * dimensions, and the perimeter from the intercepts between adjacent lines.
+ *
+ * SetLabelImage() is deprecated: the label image is not required
+ * anymore and is ignored.
  *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
@@ -115,11 +114,10 @@ public:
   itkGetConstReferenceMacro(ComputePerimeter, bool);
   itkBooleanMacro(ComputePerimeter);
 
-  /** Set the label image */
-  void SetLabelImage(const TLabelImage *input)
-  {
-    m_LabelImage = input;
-  }
+  /** Set the label image.
+   * \deprecated The label image is not used anymore: the attributes are
+   * computed from the lines of the label objects. */
+  itkLegacyMacro(void SetLabelImage(const TLabelImage *));
 
 protected:
   ShapeLabelMapFilter();
@@ -127,21 +125,18 @@ protected:
 
   virtual void ThreadedProcessLabelObject(LabelObjectType *labelObject) ITK_OVERRIDE;
 
-  virtual void BeforeThreadedGenerateData() ITK_OVERRIDE;
-
-  virtual void AfterThreadedGenerateData() ITK_OVERRIDE;
-
   void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
 private:
   ShapeLabelMapFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
-  bool                   m_ComputeFeretDiameter;
-  bool                   m_ComputePerimeter;
-  LabelImageConstPointer m_LabelImage;
+  bool m_ComputeFeretDiameter;
+  bool m_ComputePerimeter;
 
   void ComputeFeretDiameter(LabelObjectType *labelObject);
+  void ConvexHullInPlane(std::vector< IndexType > & points);
+  static OffsetValueType Cross(const IndexType & o, const IndexType & a, const IndexType & b);
   void ComputePerimeter(LabelObjectType *labelObject);
 
   typedef itk::Offset<2>                                                          Offset2Type;
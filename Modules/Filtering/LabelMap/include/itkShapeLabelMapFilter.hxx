@@ -20,17 +20,16 @@
 
 #include "itkShapeLabelMapFilter.h"
 #include "itkProgressReporter.h"
-#include "itkConstNeighborhoodIterator.h"
 #include "itkConstShapedNeighborhoodIterator.h"
-#include "itkLabelMapToLabelImageFilter.h"
-#include "itkConstantBoundaryCondition.h"
 #include "itkGeometryUtilities.h"
 #include "itkConnectedComponentAlgorithm.h"
 #include "vnl/algo/vnl_real_eigensystem.h"
 #include "vnl/algo/vnl_symmetric_eigensystem.h"
 #include "itkMath.h"
+#include <algorithm>
 #include <deque>
 #include <map>
+#include <vector>
 
 namespace itk
 {
@@ -42,30 +41,6 @@ ShapeLabelMapFilter< TImage, TLabelImage >
   m_ComputePerimeter = true;
 }
 
-template< typename TImage, typename TLabelImage >
-void
-ShapeLabelMapFilter< TImage, TLabelImage >
-::BeforeThreadedGenerateData()
-{
-  Superclass::BeforeThreadedGenerateData();
-
-  // Generate the label image, if needed
-  if ( m_ComputeFeretDiameter )
-    {
-    if ( !m_LabelImage )
-      {
-      // generate an image of the labelized image
-      typedef LabelMapToLabelImageFilter< TImage, LabelImageType > LCI2IType;
-      typename LCI2IType::Pointer lci2i = LCI2IType::New();
-      lci2i->SetInput( this->GetOutput() );
-      // Respect the number of threads of the filter
-      lci2i->SetNumberOfThreads( this->GetNumberOfThreads() );
-      lci2i->Update();
-      m_LabelImage = lci2i->GetOutput();
-      }
-    }
-}
-
 template< typename TImage, typename TLabelImage >
 void
 ShapeLabelMapFilter< TImage, TLabelImage >
@@ -387,40 +362,41 @@ void
 ShapeLabelMapFilter< TImage, TLabelImage >
 ::ComputeFeretDiameter(LabelObjectType *labelObject)
 {
-  const LabelPixelType & label = labelObject->GetLabel();
-
-  typedef typename std::deque< IndexType > IndexListType;
-  IndexListType idxList;
-
-  typedef typename itk::ConstNeighborhoodIterator< LabelImageType > NeighborIteratorType;
-  SizeType neighborHoodRadius;
-  neighborHoodRadius.Fill(1);
-  NeighborIteratorType                        it( neighborHoodRadius, m_LabelImage, m_LabelImage->GetBufferedRegion() );
-  ConstantBoundaryCondition< LabelImageType > lcbc;
-  // Use label + 1 to have a label different of the current label on the border
-  lcbc.SetConstant(label + 1);
-  it.OverrideBoundaryCondition(&lcbc);
-  it.GoToBegin();
-
-  typedef typename NeighborIteratorType::NeighborIndexType   NeighborIndexType;
-
-  // Iterate over all the indexes
-  typename LabelObjectType::ConstIndexIterator iit( labelObject );
-  while( ! iit.IsAtEnd() )
+  // The feret diameter is reached between two vertices of the convex hull of
+  // the object, and those vertices are always the first or the last index of
+  // a line. Collect the line ends, grouped by plane orthogonal to the first
+  // two dimensions.
+  typedef std::vector< IndexType >                                                 IndexListType;
+  typedef std::map< IndexType, IndexListType, typename IndexType::LexicographicCompare > PlaneMapType;
+  PlaneMapType planes;
+
+  for ( SizeValueType lineNumber = 0; lineNumber < labelObject->GetNumberOfLines(); lineNumber++ )
     {
-    // Move the iterator to the new location
-    it += iit.GetIndex() - it.GetIndex();
+    const typename LabelObjectType::LineType & line = labelObject->GetLine(lineNumber);
+    IndexType firstIdx = line.GetIndex();
+    IndexType lastIdx = firstIdx;
+    lastIdx[0] += line.GetLength() - 1;
 
-    // Push the pixel in the list if it is on the border of the object
-    for ( NeighborIndexType i = 0; i < it.Size(); i++ )
+    IndexType planeIdx = firstIdx;
+    for ( unsigned int i = 0; i < ImageDimension && i < 2; i++ )
       {
-      if ( it.GetPixel(i) != label )
-        {
-        idxList.push_back( iit.GetIndex() );
-        break;
-        }
+      planeIdx[i] = 0;
+      }
+    IndexListType & planeList = planes[planeIdx];
+    planeList.push_back(firstIdx);
+    if ( line.GetLength() > 1 )
+      {
+      planeList.push_back(lastIdx);
       }
-    ++iit;
+    }
+
+  // A vertex of the convex hull of the object is also a vertex of the convex
+  // hull of its plane, so only those are kept.
+  IndexListType idxList;
+  for ( typename PlaneMapType::iterator pIt = planes.begin(); pIt != planes.end(); ++pIt )
+    {
+    this->ConvexHullInPlane( pIt->second );
+    idxList.insert( idxList.end(), pIt->second.begin(), pIt->second.end() );
     }
 
   ImageType *output = this->GetOutput();
@@ -456,6 +432,63 @@ ShapeLabelMapFilter< TImage, TLabelImage >
   labelObject->SetFeretDiameter(feretDiameter);
 }
 
+template< typename TImage, typename TLabelImage >
+void
+ShapeLabelMapFilter< TImage, TLabelImage >
+::ConvexHullInPlane(std::vector< IndexType > & points)
+{
+  // Nothing to simplify along a single dimension: the line ends are the hull
+  if ( ImageDimension < 2 || points.size() < 3 )
+    {
+    return;
+    }
+
+  // Andrew's monotone chain, on the first two dimensions. The cross products
+  // are computed exactly on the indexes, and the collinear points are dropped.
+  std::sort( points.begin(), points.end(), typename IndexType::LexicographicCompare() );
+  points.erase( std::unique( points.begin(), points.end() ), points.end() );
+  if ( points.size() < 3 )
+    {
+    return;
+    }
+
+  const size_t numberOfPoints = points.size();
+  std::vector< IndexType > hull( 2 * numberOfPoints );
+  size_t k = 0;
+
+  // lower chain
+  for ( size_t i = 0; i < numberOfPoints; i++ )
+    {
+    while ( k >= 2 && Self::Cross( hull[k - 2], hull[k - 1], points[i] ) <= 0 )
+      {
+      k--;
+      }
+    hull[k++] = points[i];
+    }
+  // upper chain
+  const size_t lowerSize = k + 1;
+  for ( size_t i = numberOfPoints - 1; i > 0; i-- )
+    {
+    while ( k >= lowerSize && Self::Cross( hull[k - 2], hull[k - 1], points[i - 1] ) <= 0 )
+      {
+      k--;
+      }
+    hull[k++] = points[i - 1];
+    }
+
+  // the last point is the same as the first one
+  hull.resize(k - 1);
+  points.swap(hull);
+}
+
+template< typename TImage, typename TLabelImage >
+OffsetValueType
+ShapeLabelMapFilter< TImage, TLabelImage >
+::Cross(const IndexType & o, const IndexType & a, const IndexType & b)
+{
+  return ( a[0] - o[0] ) * ( b[1] - o[1] ) - ( a[1] - o[1] ) * ( b[0] - o[0] );
+}
+
 template< typename TImage, typename TLabelImage >
 void
 ShapeLabelMapFilter< TImage, TLabelImage >
@@ -741,24 +774,23 @@ ShapeLabelMapFilter< TImage, TLabelImage >
 template< typename TImage, typename TLabelImage >
 void
 ShapeLabelMapFilter< TImage, TLabelImage >
-::AfterThreadedGenerateData()
+::PrintSelf(std::ostream & os, Indent indent) const
 {
-  Superclass::AfterThreadedGenerateData();
+  Superclass::PrintSelf(os, indent);
 
-  // Release the label image
-  m_LabelImage = ITK_NULLPTR;
+  os << indent << "ComputeFeretDiameter: " << m_ComputeFeretDiameter << std::endl;
+  os << indent << "ComputePerimeter: " << m_ComputePerimeter << std::endl;
 }
 
+#if !defined(ITK_LEGACY_REMOVE)
 template< typename TImage, typename TLabelImage >
 void
 ShapeLabelMapFilter< TImage, TLabelImage >
-::PrintSelf(std::ostream & os, Indent indent) const
+::SetLabelImage(const TLabelImage *)
 {
-  Superclass::PrintSelf(os, indent);
-
-  os << indent << "ComputeFeretDiameter: " << m_ComputeFeretDiameter << std::endl;
-  os << indent << "ComputePerimeter: " << m_ComputePerimeter << std::endl;
+  itkLegacyBodyMacro(ShapeLabelMapFilter::SetLabelImage, 4.11);
 }
+#endif
 
 } // end namespace itk
 #endif
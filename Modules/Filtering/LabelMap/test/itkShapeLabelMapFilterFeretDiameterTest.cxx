@@ -0,0 +1,155 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLabelImageToShapeLabelMapFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMath.h"
+
+namespace
+{
+
+// Compare the feret diameter of the shape label objects with a brute force
+// search over all the pairs of pixels of the objects.
+template< unsigned int VDimension >
+int
+ShapeLabelMapFilterFeretDiameterTestDimension(unsigned int seed)
+{
+  typedef unsigned char                                     PixelType;
+  typedef itk::Image< PixelType, VDimension >               ImageType;
+  typedef itk::ShapeLabelObject< PixelType, VDimension >    LabelObjectType;
+  typedef itk::LabelMap< LabelObjectType >                  LabelMapType;
+  typedef typename ImageType::IndexType                     IndexType;
+
+  typename ImageType::SizeType size;
+  typename ImageType::SpacingType spacing;
+  for ( unsigned int i = 0; i < VDimension; i++ )
+    {
+    size[i] = ( VDimension == 2 ) ? 48 : 14;
+    spacing[i] = 0.5 + 0.25 * i;
+    }
+
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->SetSpacing(spacing);
+  image->Allocate();
+  image->FillBuffer(0);
+
+  // A few labels: random blobs, with holes and several components.
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( seed );
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const IndexType & idx = it.GetIndex();
+    double r2 = 0;
+    for ( unsigned int i = 0; i < VDimension; i++ )
+      {
+      const double d = idx[i] - 0.5 * size[i];
+      r2 += d * d;
+      }
+    const double r = std::sqrt(r2) / size[0];
+    if ( r < 0.2 )
+      {
+      it.Set( generator->GetIntegerVariate( 4 ) ? 1 : 0 );
+      }
+    else if ( r < 0.45 )
+      {
+      it.Set( generator->GetIntegerVariate( 2 ) ? 0 : 2 + idx[0] % 2 );
+      }
+    }
+  // A single pixel object
+  IndexType corner;
+  corner.Fill(0);
+  image->SetPixel(corner, 4);
+
+  typedef itk::LabelImageToShapeLabelMapFilter< ImageType, LabelMapType > I2LType;
+  typename I2LType::Pointer i2l = I2LType::New();
+  i2l->SetInput(image);
+  i2l->SetComputeFeretDiameter(true);
+  i2l->SetComputePerimeter(false);
+  i2l->Update();
+
+  LabelMapType *labelMap = i2l->GetOutput();
+  if ( labelMap->GetNumberOfLabelObjects() != 4 )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Unexpected number of label objects: " << labelMap->GetNumberOfLabelObjects() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for ( unsigned int n = 0; n < labelMap->GetNumberOfLabelObjects(); n++ )
+    {
+    const LabelObjectType *labelObject = labelMap->GetNthLabelObject(n);
+
+    std::vector< IndexType > indexes;
+    typename LabelObjectType::ConstIndexIterator iit( labelObject );
+    for ( ; !iit.IsAtEnd(); ++iit )
+      {
+      indexes.push_back( iit.GetIndex() );
+      }
+
+    double expected = 0;
+    for ( size_t i = 0; i < indexes.size(); i++ )
+      {
+      for ( size_t j = i + 1; j < indexes.size(); j++ )
+        {
+        double length = 0;
+        for ( unsigned int d = 0; d < VDimension; d++ )
+          {
+          const double diff = ( indexes[i][d] - indexes[j][d] ) * spacing[d];
+          length += diff * diff;
+          }
+        expected = std::max( expected, length );
+        }
+      }
+    expected = std::sqrt(expected);
+
+    const double feretDiameter = labelObject->GetFeretDiameter();
+    if ( !itk::Math::FloatAlmostEqual( feretDiameter, expected, 4, 1e-9 ) )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Dimension " << VDimension << ", label " << int( labelObject->GetLabel() )
+                << ": feret diameter is " << feretDiameter << ", expected " << expected << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+int itkShapeLabelMapFilterFeretDiameterTest(int, char *[])
+{
+  int status = EXIT_SUCCESS;
+  for ( unsigned int seed = 1; seed <= 3; seed++ )
+    {
+    if ( ShapeLabelMapFilterFeretDiameterTestDimension< 2 >(seed) == EXIT_FAILURE )
+      {
+      status = EXIT_FAILURE;
+      }
+    if ( ShapeLabelMapFilterFeretDiameterTestDimension< 3 >(seed) == EXIT_FAILURE )
+      {
+      status = EXIT_FAILURE;
+      }
+    }
+  return status;
+}
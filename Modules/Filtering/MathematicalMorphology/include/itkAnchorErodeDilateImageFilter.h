@@ -19,9 +19,8 @@
 #define itkAnchorErodeDilateImageFilter_h
 
 #include "itkKernelImageFilter.h"
-#include "itkProgressReporter.h"
 #include "itkAnchorErodeDilateLine.h"
-#include "itkBresenhamLine.h"
+#include "itkMorphologyLineDecompositionThreader.h"
 
 namespace itk
 {
@@ -33,6 +32,10 @@ namespace itk
  * The SetBoundary facility isn't necessary for operation of the
  * anchor method but is included for compatibility with other
  * morphology classes in itk.
+ *
+ * The lines of the decomposition are applied one after the other to the
+ * whole requested region by a MorphologyLineDecompositionThreader, with
+ * threads over the lines of each pass.
  * \ingroup ITKMathematicalMorphology
  */
 template< typename TImage, typename TKernel,
@@ -82,9 +85,9 @@ protected:
   ~AnchorErodeDilateImageFilter() {}
   void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
-  /** Multi-thread version GenerateData. */
-  void  ThreadedGenerateData(const InputImageRegionType & outputRegionForThread,
-                             ThreadIdType threadId) ITK_OVERRIDE;
+  /** Apply the lines of the decomposition. The lines of each pass are
+   * processed by several threads. */
+  void  GenerateData() ITK_OVERRIDE;
 
   // should be set by the meta filter
   InputImagePixelType m_Boundary;
@@ -93,10 +96,11 @@ private:
   AnchorErodeDilateImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
-  typedef BresenhamLine< itkGetStaticConstMacro(InputImageDimension) > BresType;
-
   // the class that operates on lines
-  typedef AnchorErodeDilateLine< InputImagePixelType, TFunction1 > AnchorLineType;
+  typedef AnchorErodeDilateLine< InputImagePixelType, TFunction1 >    AnchorLineType;
+  typedef MorphologyLineDecompositionThreader< Self, AnchorLineType > LineThreaderType;
+
+  typename LineThreaderType::Pointer m_LineThreader;
 }; // end of class
 } // end namespace itk
 
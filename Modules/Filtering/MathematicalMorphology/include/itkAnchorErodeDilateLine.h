@@ -40,6 +40,10 @@ public:
   /** Some convenient typedefs. */
   typedef TInputPix InputImagePixelType;
 
+  /** Number of lines processed by a call to DoLine(). The anchor method
+   * branches on the data, so the lines are processed one at a time. */
+  itkStaticConstMacro(NumberOfLanes, unsigned int, 1);
+
   void DoLine(std::vector<TInputPix> & buffer, std::vector<TInputPix> & inbuffer,
               unsigned bufflength);
 
@@ -35,7 +35,7 @@ template< typename TImage, typename TBres, typename TLine >
 int ComputeStartEnd(const typename TImage::IndexType StartIndex,
                     const TLine line,
                     const float tol,
-                    const typename TBres::OffsetArray LineOffsets,
+                    const typename TBres::OffsetArray & LineOffsets,
                     const typename TImage::RegionType AllImage,
                     unsigned & start,
                     unsigned & end);
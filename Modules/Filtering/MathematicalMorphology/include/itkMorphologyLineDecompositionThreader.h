@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMorphologyLineDecompositionThreader_h
+#define itkMorphologyLineDecompositionThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+#include "itkBresenhamLine.h"
+#include "itkProgressReporter.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class MorphologyLineDecompositionThreader
+ * \brief Applies the lines of a decomposed FlatStructuringElement to an
+ * image, with threads over the independent lines of each pass.
+ *
+ * Run() applies the lines of the decomposition one after the other. For
+ * each line, the region is swept by parallel Bresenham lines starting
+ * from an enlarged face of the region (see MakeEnlargedFace()). These
+ * lines do not overlap, so the domain of each pass is the range of the
+ * indices of the pixels of the face, and the threads work in place in
+ * the output image.
+ *
+ * Each line is gathered into a contiguous buffer with precomputed buffer
+ * offsets, processed by a copy of TLineOperator owned by the thread, and
+ * scattered back. TLineOperator provides SetSize(), DoLine() and the
+ * NumberOfLanes constant; when NumberOfLanes is greater than one,
+ * neighbor lines with similar lengths in the region are interleaved,
+ * padded with the boundary value, and processed together, see
+ * VanHerkGilWermanErodeDilateLine. The padding requires a line operator
+ * computing the extreme over a window truncated at the ends of the line,
+ * as the erosions and dilations do.
+ *
+ * \sa AnchorErodeDilateImageFilter
+ * \sa VanHerkGilWermanErodeDilateImageFilter
+ * \ingroup ITKMathematicalMorphology
+ */
+template< typename TAssociate, typename TLineOperator >
+class MorphologyLineDecompositionThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MorphologyLineDecompositionThreader                               Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate > Superclass;
+  typedef SmartPointer< Self >                                              Pointer;
+  typedef SmartPointer< const Self >                                        ConstPointer;
+
+  itkTypeMacro( MorphologyLineDecompositionThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+  typedef DomainType                         IndexRangeType;
+
+  typedef typename TAssociate::InputImageType ImageType;
+  typedef typename ImageType::RegionType      RegionType;
+  typedef typename ImageType::IndexType       IndexType;
+  typedef typename ImageType::PixelType       PixelType;
+  typedef typename TAssociate::KernelType     KernelType;
+  typedef typename KernelType::LType          LineType;
+  typedef typename KernelType::DecompType     DecompType;
+  typedef TLineOperator                       LineOperatorType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, ImageType::ImageDimension);
+
+  /** Apply the lines to \c region. The first pass reads \c input, and
+   * the next ones work in place in \c output, whose buffered region must
+   * contain \c region. \c boundary is the value assumed outside of
+   * \c region. The progress is reported once per line. */
+  void Run( AssociateType * associate, const ImageType * input, ImageType * output,
+            const RegionType & region, const DecompType & lines, const PixelType & boundary,
+            ProgressReporter & progress );
+
+protected:
+  MorphologyLineDecompositionThreader();
+  virtual ~MorphologyLineDecompositionThreader() {}
+
+  /** Allocate the line operators and buffers of the threads. */
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  /** Process the lines starting from the face pixels of \c subrange. */
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+  MorphologyLineDecompositionThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  typedef BresenhamLine< itkGetStaticConstMacro(ImageDimension) > BresType;
+  typedef typename BresType::OffsetArray                          BresOffsetArray;
+
+  struct ThreadDataType
+    {
+    LineOperatorType            m_LineOperator;
+    std::vector< PixelType >    m_InputBuffer;
+    std::vector< PixelType >    m_OutputBuffer;
+    std::vector< IndexType >    m_LineStarts;
+    std::vector< unsigned int > m_LineStartPositions;
+    std::vector< unsigned int > m_LineLengths;
+    };
+
+  /** Process the first \c numberOfLines lines of the thread, which have
+   * at most \c len pixels in the region. */
+  void ProcessLines( ThreadDataType & data, unsigned int numberOfLines, unsigned int len );
+
+  const ImageType *              m_Input;
+  ImageType *                    m_Output;
+  RegionType                     m_Region;
+  RegionType                     m_Face;
+  LineType                       m_Line;
+  float                          m_Tolerance;
+  PixelType                      m_Boundary;
+  BresOffsetArray                m_LineOffsets;
+  std::vector< OffsetValueType > m_InputOffsets;
+  std::vector< OffsetValueType > m_OutputOffsets;
+  unsigned int                   m_LineLength;
+  unsigned int                   m_BufferLength;
+  std::vector< ThreadDataType >  m_ThreadData;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMorphologyLineDecompositionThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,230 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMorphologyLineDecompositionThreader_hxx
+#define itkMorphologyLineDecompositionThreader_hxx
+
+#include "itkMorphologyLineDecompositionThreader.h"
+#include "itkSharedMorphologyUtilities.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template< typename TAssociate, typename TLineOperator >
+MorphologyLineDecompositionThreader< TAssociate, TLineOperator >
+::MorphologyLineDecompositionThreader() :
+  m_Input( ITK_NULLPTR ),
+  m_Output( ITK_NULLPTR ),
+  m_Tolerance( 0.0f ),
+  m_Boundary( NumericTraits< PixelType >::ZeroValue() ),
+  m_LineLength( 0 ),
+  m_BufferLength( 0 )
+{
+}
+
+template< typename TAssociate, typename TLineOperator >
+void
+MorphologyLineDecompositionThreader< TAssociate, TLineOperator >
+::Run( AssociateType * associate, const ImageType * input, ImageType * output,
+       const RegionType & region, const DecompType & lines, const PixelType & boundary,
+       ProgressReporter & progress )
+{
+  m_Input = input;
+  m_Output = output;
+  m_Region = region;
+  m_Boundary = boundary;
+
+  // maximum buffer length is sum of dimensions
+  m_BufferLength = 0;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    m_BufferLength += region.GetSize()[i];
+    }
+  // compat
+  m_BufferLength += 2;
+
+  BresType BresLine;
+  for ( unsigned int i = 0; i < lines.size(); i++ )
+    {
+    const LineType & line = lines[i];
+    m_LineOffsets = BresLine.BuildLine(line, m_BufferLength);
+    m_LineLength = GetLinePixels< LineType >(line);
+    // want lines to be odd
+    if ( !( m_LineLength % 2 ) )
+      {
+      ++m_LineLength;
+      }
+    m_Line = line;
+    m_Line.Normalize();
+    // set a generous tolerance
+    m_Tolerance = 1.0 / m_LineOffsets.size();
+    m_Face = MakeEnlargedFace< ImageType, LineType >(m_Input, m_Region, line);
+
+    // the offsets of the line in the buffers of the images
+    m_InputOffsets.resize( m_LineOffsets.size() );
+    m_OutputOffsets.resize( m_LineOffsets.size() );
+    const OffsetValueType *inputTable = m_Input->GetOffsetTable();
+    const OffsetValueType *outputTable = m_Output->GetOffsetTable();
+    for ( unsigned int k = 0; k < m_LineOffsets.size(); k++ )
+      {
+      m_InputOffsets[k] = 0;
+      m_OutputOffsets[k] = 0;
+      for ( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        m_InputOffsets[k] += m_LineOffsets[k][d] * inputTable[d];
+        m_OutputOffsets[k] += m_LineOffsets[k][d] * outputTable[d];
+        }
+      }
+
+    if ( m_Face.GetNumberOfPixels() > 0 )
+      {
+      DomainType faceRange;
+      faceRange[0] = 0;
+      faceRange[1] = static_cast< IndexValueType >( m_Face.GetNumberOfPixels() ) - 1;
+      this->Execute(associate, faceRange);
+      }
+
+    // after the first pass the input will be taken from the output
+    m_Input = m_Output;
+    progress.CompletedPixel();
+    }
+}
+
+template< typename TAssociate, typename TLineOperator >
+void
+MorphologyLineDecompositionThreader< TAssociate, TLineOperator >
+::BeforeThreadedExecution()
+{
+  const unsigned int lanes = LineOperatorType::NumberOfLanes;
+
+  m_ThreadData.resize( this->GetNumberOfThreadsUsed() );
+  for ( unsigned int t = 0; t < m_ThreadData.size(); t++ )
+    {
+    m_ThreadData[t].m_LineOperator.SetSize(m_LineLength);
+    m_ThreadData[t].m_InputBuffer.resize( lanes * ( m_BufferLength + 2 ) );
+    m_ThreadData[t].m_OutputBuffer.resize( lanes * ( m_BufferLength + 2 ) );
+    m_ThreadData[t].m_LineStarts.resize(lanes);
+    m_ThreadData[t].m_LineStartPositions.resize(lanes);
+    m_ThreadData[t].m_LineLengths.resize(lanes);
+    }
+}
+
+template< typename TAssociate, typename TLineOperator >
+void
+MorphologyLineDecompositionThreader< TAssociate, TLineOperator >
+::ThreadedExecution( const IndexRangeType & subrange,
+                     const ThreadIdType threadId )
+{
+  const unsigned int lanes = LineOperatorType::NumberOfLanes;
+  ThreadDataType &   data = m_ThreadData[threadId];
+
+  const IndexType &                     faceIndex = m_Face.GetIndex();
+  const typename RegionType::SizeType & faceSize = m_Face.GetSize();
+
+  unsigned int numberOfLines = 0;
+  unsigned int batchLength = 0;
+  for ( IndexValueType f = subrange[0]; f <= subrange[1]; ++f )
+    {
+    // the index of the face pixel; the face may extend outside of the
+    // image, so it is computed from the face region only
+    IndexType       Ind;
+    OffsetValueType remainder = f;
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      const OffsetValueType faceSizeD = static_cast< OffsetValueType >( faceSize[d] );
+      Ind[d] = faceIndex[d] + remainder % faceSizeD;
+      remainder /= faceSizeD;
+      }
+
+    unsigned int start, end;
+    if ( !ComputeStartEnd< ImageType, BresType, LineType >(Ind, m_Line, m_Tolerance, m_LineOffsets,
+                                                           m_Region, start, end) )
+      {
+      continue;
+      }
+    // the lines processed together are padded to the same length with
+    // the boundary value, which does not change the extremes since the
+    // windows which reach the padding already include the boundary, so
+    // only the lines with similar lengths are grouped
+    const unsigned int len = end - start + 1;
+    if ( numberOfLines > 0 && ( len > batchLength + batchLength / 4 + 1
+                                || len + batchLength / 4 + 1 < batchLength ) )
+      {
+      this->ProcessLines(data, numberOfLines, batchLength);
+      numberOfLines = 0;
+      }
+    batchLength = numberOfLines > 0 ? std::max( batchLength, len ) : len;
+    data.m_LineStarts[numberOfLines] = Ind;
+    data.m_LineStartPositions[numberOfLines] = start;
+    data.m_LineLengths[numberOfLines] = len;
+    if ( ++numberOfLines == lanes )
+      {
+      this->ProcessLines(data, numberOfLines, batchLength);
+      numberOfLines = 0;
+      }
+    }
+  if ( numberOfLines > 0 )
+    {
+    this->ProcessLines(data, numberOfLines, batchLength);
+    }
+}
+
+template< typename TAssociate, typename TLineOperator >
+void
+MorphologyLineDecompositionThreader< TAssociate, TLineOperator >
+::ProcessLines( ThreadDataType & data, unsigned int numberOfLines, unsigned int len )
+{
+  const unsigned int lanes = LineOperatorType::NumberOfLanes;
+
+  std::vector< PixelType > & in = data.m_InputBuffer;
+  const PixelType *          inputBuffer = m_Input->GetBufferPointer();
+  PixelType *                outputBuffer = m_Output->GetBufferPointer();
+
+  // the unused lanes and the end of the shorter lines are filled with
+  // the boundary value
+  std::fill( in.begin(), in.begin() + lanes * ( len + 2 ), m_Boundary );
+  for ( unsigned int l = 0; l < numberOfLines; l++ )
+    {
+    const OffsetValueType   base = m_Input->ComputeOffset( data.m_LineStarts[l] );
+    const OffsetValueType * offsets = &m_InputOffsets[data.m_LineStartPositions[l]];
+    for ( unsigned int i = 0; i < data.m_LineLengths[l]; i++ )
+      {
+      in[( i + 1 ) * lanes + l] = inputBuffer[base + offsets[i]];
+      }
+    }
+
+  // compat
+  data.m_LineOperator.DoLine(data.m_OutputBuffer, data.m_InputBuffer, len + 2);
+
+  const std::vector< PixelType > & out = data.m_OutputBuffer;
+
+  for ( unsigned int l = 0; l < numberOfLines; l++ )
+    {
+    const OffsetValueType   base = m_Output->ComputeOffset( data.m_LineStarts[l] );
+    const OffsetValueType * offsets = &m_OutputOffsets[data.m_LineStartPositions[l]];
+    for ( unsigned int i = 0; i < data.m_LineLengths[l]; i++ )
+      {
+      outputBuffer[base + offsets[i]] = out[( i + 1 ) * lanes + l];
+      }
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -22,6 +22,7 @@
 #include "itkShapedNeighborhoodIterator.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
+#include "itkReconstructionImageFilterThreader.h"
 #include <queue>
 
 //#define BASIC
@@ -43,6 +44,12 @@ namespace itk
  * applications and efficient algorithms" -- IEEE Transactions on
  * Image processing, Vol 2, No 2, pp 176-201, April 1993
  *
+ * When UseInternalCopy is on, the reconstruction is multithreaded: the
+ * image is split in slabs which run the raster passes and the FIFO
+ * propagation on their own, and exchange the propagations across their
+ * boundaries until convergence, see ReconstructionImageFilterThreader.
+ * The result does not depend on the number of threads.
+ *
  * \author Richard Beare. Department of Medicine, Monash University,
  * Melbourne, Australia.
  *
@@ -84,8 +91,8 @@ public:
   typedef typename OutputImageType::RegionType   OutputImageRegionType;
   typedef typename OutputImageType::PixelType    OutputImagePixelType;
   typedef typename OutputImageType::IndexType    OutputImageIndexType;
+  typedef TCompare                               CompareType;
 
-  /** ImageDimension constants */
   /** ImageDimension constants */
   itkStaticConstMacro(MarkerImageDimension, unsigned int,
                       TInputImage::ImageDimension);
@@ -129,8 +136,9 @@ public:
 
   /**
    * Perform a padding of the image internally to increase the performance
-   * of the filter. UseInternalCopy can be set to false to reduce the memory
-   * usage.
+   * of the filter and to run it with several threads. UseInternalCopy can
+   * be set to false to reduce the memory usage, in which case the filter
+   * runs on a single thread.
    */
   itkSetMacro(UseInternalCopy, bool);
   itkGetConstReferenceMacro(UseInternalCopy, bool);
@@ -163,6 +171,9 @@ private:
   bool m_FullyConnected;
   bool m_UseInternalCopy;
 
+  typedef ReconstructionImageFilterThreader< Self > ThreaderType;
+  typename ThreaderType::Pointer m_Threader;
+
   typedef typename itk::NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< OutputImageType > FaceCalculatorType;
 
   typedef typename FaceCalculatorType::FaceListType           FaceListType;
@@ -34,6 +34,7 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
 {
   m_FullyConnected = false;
   m_UseInternalCopy = true;
+  m_Threader = ThreaderType::New();
 }
 
 template< typename TInputImage, typename TOutputImage, typename TCompare >
@@ -153,24 +154,54 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
 
     markerImageP = MarkerPad->GetOutput();
     maskImageP = MaskPad->GetOutput();
-    }
-  else
-    {
-    maskImageP = this->GetMaskImage();
-    InputIteratorType inIt( markerImage,
-                            output->GetRequestedRegion() );
-    OutputIteratorType outIt( output,
-                              output->GetRequestedRegion() );
-    // copy marker to output - isn't there a better way?
-    while ( !outIt.IsAtEnd() )
+
+    // the reconstruction is done in place in the padded marker, by slabs
+    // of the image in the threads
+    m_Threader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+    if ( !m_Threader->Run( this, const_cast< MarkerImageType * >( markerImageP.GetPointer() ),
+                           maskImageP, m_FullyConnected ) )
       {
-      MarkerImagePixelType currentValue = inIt.Get();
-      outIt.Set( static_cast< OutputImagePixelType >( currentValue ) );
-      ++inIt;
-      ++outIt;
+      if ( compare(0, 1) )
+        {
+        itkExceptionMacro(<< "Marker pixels must be <= mask pixels.");
+        }
+      else
+        {
+        itkExceptionMacro(<< "Marker pixels must be >= mask pixels.");
+        }
       }
-    markerImageP = output;
+
+    typedef typename itk::CropImageFilter< InputImageType, OutputImageType > CropType;
+    typename CropType::Pointer crop = CropType::New();
+
+    crop->SetInput(markerImageP);
+    crop->SetUpperBoundaryCropSize(padSize);
+    crop->SetLowerBoundaryCropSize(padSize);
+    crop->GraftOutput( this->GetOutput() );
+    /** execute the minipipeline */
+    crop->Update();
+
+    /** graft the minipipeline output back into this filter's output */
+    this->GraftOutput( crop->GetOutput() );
+    return;
+    }
+
+  // without the internal copy, the reconstruction is done in the output
+  // with a single thread
+  maskImageP = this->GetMaskImage();
+  InputIteratorType inIt( markerImage,
+                          output->GetRequestedRegion() );
+  OutputIteratorType outIt( output,
+                            output->GetRequestedRegion() );
+  // copy marker to output - isn't there a better way?
+  while ( !outIt.IsAtEnd() )
+    {
+    MarkerImagePixelType currentValue = inIt.Get();
+    outIt.Set( static_cast< OutputImagePixelType >( currentValue ) );
+    ++inIt;
+    ++outIt;
     }
+  markerImageP = output;
 
   // declare our queue type
   typedef typename std::queue< OutputImageIndexType > FifoType;
@@ -181,46 +212,18 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
   CNInputIterator   mskNIt;
   ISizeType         kernelRadius;
   kernelRadius.Fill(1);
-  if ( m_UseInternalCopy )
-    {
-    FaceCalculatorType faceCalculator;
-
-    FaceListType   faceList;
-    FaceListTypeIt fit;
-
-    faceList = faceCalculator(maskImageP, maskImageP->GetLargestPossibleRegion(),
-                              kernelRadius);
-    // we will only be processing the body region
-    fit = faceList.begin();
-    // must be a better way of doing this
-    NOutputIterator tt(kernelRadius,
-                       markerImageP,
-                       *fit);
-    outNIt = tt;
-
-    InputIteratorType ttt(maskImageP,
-                          *fit);
-    mskIt = ttt;
-    CNInputIterator tttt(kernelRadius,
-                         maskImageP,
-                         *fit);
-    mskNIt = tttt;
-    }
-  else
-    {
-    NOutputIterator tt( kernelRadius,
-                        markerImageP,
+  NOutputIterator tt( kernelRadius,
+                      markerImageP,
+                      output->GetRequestedRegion() );
+  outNIt = tt;
+
+  InputIteratorType ttt( maskImageP,
+                         output->GetRequestedRegion() );
+  mskIt = ttt;
+  CNInputIterator tttt( kernelRadius,
+                        maskImageP,
                         output->GetRequestedRegion() );
-    outNIt = tt;
-
-    InputIteratorType ttt( maskImageP,
-                           output->GetRequestedRegion() );
-    mskIt = ttt;
-    CNInputIterator tttt( kernelRadius,
-                          maskImageP,
-                          output->GetRequestedRegion() );
-    mskNIt = tttt;
-    }
+  mskNIt = tttt;
 
   setConnectivityPrevious(&outNIt, m_FullyConnected);
 
@@ -370,22 +373,6 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
       }
     progress.CompletedPixel();
     }
-
-  if ( m_UseInternalCopy )
-    {
-    typedef typename itk::CropImageFilter< InputImageType, OutputImageType > CropType;
-    typename CropType::Pointer crop = CropType::New();
-
-    crop->SetInput(markerImageP);
-    crop->SetUpperBoundaryCropSize(padSize);
-    crop->SetLowerBoundaryCropSize(padSize);
-    crop->GraftOutput( this->GetOutput() );
-    /** execute the minipipeline */
-    crop->Update();
-
-    /** graft the minipipeline output back into this filter's output */
-    this->GraftOutput( crop->GetOutput() );
-    }
 }
 
 template< typename TInputImage, typename TOutputImage, typename TCompare >
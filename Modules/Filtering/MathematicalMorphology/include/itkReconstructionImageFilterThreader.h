@@ -0,0 +1,159 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkReconstructionImageFilterThreader_h
+#define itkReconstructionImageFilterThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+
+/** \class ReconstructionImageFilterThreader
+ * \brief Performs the grayscale reconstruction of ReconstructionImageFilter
+ * with threads over slabs of the image.
+ *
+ * The marker and the mask are the padded copies made by the filter: a
+ * border of one pixel with a value which never propagates surrounds the
+ * images, so the neighbors are read with constant buffer offsets and
+ * without boundary conditions.
+ *
+ * The image is split in slabs along its last dimension, one per thread.
+ * Each slab first runs the raster and anti-raster passes of Vincent's
+ * hybrid algorithm on its own pixels, then processes its FIFO. A slab
+ * only writes its own pixels: the propagation to a neighbor in the next
+ * or the previous slab is sent to that slab, which applies it in the next
+ * round. The rounds are repeated until no slab has anything to send. The
+ * reconstruction does not depend on the order of the propagation, so the
+ * result is the same as with the single threaded algorithm.
+ *
+ * As in the single threaded algorithm, the two raster passes and the FIFO
+ * each count for a third of the progress. The slab of the first thread
+ * updates the progress of the filter, and all the slabs stop when the
+ * filter is aborted; Run() then throws ProcessAborted.
+ *
+ * \sa ReconstructionImageFilter
+ * \ingroup ITKMathematicalMorphology
+ */
+template< typename TAssociate >
+class ReconstructionImageFilterThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ReconstructionImageFilterThreader                                 Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate > Superclass;
+  typedef SmartPointer< Self >                                              Pointer;
+  typedef SmartPointer< const Self >                                        ConstPointer;
+
+  itkTypeMacro( ReconstructionImageFilterThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+  typedef DomainType                         IndexRangeType;
+
+  typedef typename TAssociate::InputImageType ImageType;
+  typedef typename ImageType::PixelType       PixelType;
+  typedef typename ImageType::SizeType        SizeType;
+  typedef typename TAssociate::CompareType    CompareType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, ImageType::ImageDimension);
+
+  /** Reconstruct \c marker under \c mask, in place in \c marker. Both
+   * images must have the same buffered region, padded by one pixel on each
+   * side. Return false, without completing the reconstruction, if a marker
+   * pixel does not satisfy the precondition of the filter. Throw
+   * ProcessAborted if the associate is aborted. */
+  bool Run( AssociateType * associate, ImageType * marker, const ImageType * mask,
+            bool fullyConnected );
+
+protected:
+  ReconstructionImageFilterThreader();
+  virtual ~ReconstructionImageFilterThreader() {}
+
+  /** Run the raster passes or a propagation round on the slabs of
+   * \c subrange. */
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+  ReconstructionImageFilterThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  typedef std::pair< OffsetValueType, PixelType > MessageType;
+  typedef std::vector< MessageType >              MessageListType;
+  typedef std::queue< OffsetValueType >           FifoType;
+
+  /** Raster and anti-raster passes restricted to the slab, which fill
+   * its FIFO. */
+  void RasterPasses( SizeValueType slab );
+
+  /** Apply the propagations received by the slab, then process its
+   * FIFO. */
+  void Propagate( SizeValueType slab );
+
+  /** Propagate the value \c value to the pixel at \c q of the slab. */
+  void PropagateTo( OffsetValueType q, const PixelType & value, FifoType & fifo );
+
+  /** Count \c n pixels completed by \c slab. The first slab updates the
+   * progress of the associate. Return true if the associate is aborted. */
+  bool CompletedPixels( SizeValueType slab, SizeValueType n );
+
+  /** Throw ProcessAborted if the associate is aborted. */
+  void ThrowIfAborted() const;
+
+  /** Number of pixels popped from the FIFO between two checks of the abort
+   * flag. */
+  itkStaticConstMacro(PixelsPerProgressCheck, SizeValueType, 1024);
+
+  PixelType *                    m_Marker;
+  const PixelType *              m_Mask;
+  CompareType                    m_Compare;
+  std::vector< OffsetValueType > m_PreviousOffsets;
+  std::vector< OffsetValueType > m_LaterOffsets;
+  std::vector< OffsetValueType > m_Offsets;
+  std::vector< OffsetValueType > m_RowStarts;
+  SizeValueType                  m_RowLength;
+  OffsetValueType                m_PlaneSize;
+  std::vector< SizeValueType >   m_SlabPlanes;
+  std::vector< FifoType >        m_Fifos;
+  std::vector< unsigned char >   m_Valid;
+  bool                           m_RasterPhase;
+  SizeValueType                  m_Round;
+  SizeValueType                  m_FirstSlabProgressPixels;
+  SizeValueType                  m_FirstSlabCompletedPixels;
+  SizeValueType                  m_FirstSlabReportedPixels;
+
+  // the propagations sent during a round to the previous and to the next
+  // slab, indexed by [round parity][2 * sender + direction]
+  std::vector< MessageListType > m_Messages[2];
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkReconstructionImageFilterThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,429 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkReconstructionImageFilterThreader_hxx
+#define itkReconstructionImageFilterThreader_hxx
+
+#include "itkReconstructionImageFilterThreader.h"
+#include "itkMath.h"
+
+#include <algorithm>
+#include <string>
+
+namespace itk
+{
+
+template< typename TAssociate >
+ReconstructionImageFilterThreader< TAssociate >
+::ReconstructionImageFilterThreader() :
+  m_Marker( ITK_NULLPTR ),
+  m_Mask( ITK_NULLPTR ),
+  m_RowLength( 0 ),
+  m_PlaneSize( 0 ),
+  m_RasterPhase( true ),
+  m_Round( 0 ),
+  m_FirstSlabProgressPixels( 0 ),
+  m_FirstSlabCompletedPixels( 0 ),
+  m_FirstSlabReportedPixels( 0 )
+{
+}
+
+template< typename TAssociate >
+bool
+ReconstructionImageFilterThreader< TAssociate >
+::Run( AssociateType * associate, ImageType * marker, const ImageType * mask,
+       bool fullyConnected )
+{
+  m_Marker = marker->GetBufferPointer();
+  m_Mask = mask->GetBufferPointer();
+
+  const SizeType &        size = marker->GetBufferedRegion().GetSize();
+  const OffsetValueType * offsetTable = marker->GetOffsetTable();
+
+  // the offsets of the neighbors, split in the ones before and after the
+  // center in raster order
+  m_Offsets.clear();
+  m_PreviousOffsets.clear();
+  m_LaterOffsets.clear();
+  SizeValueType numberOfNeighbors = 1;
+  for ( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    numberOfNeighbors *= 3;
+    }
+  for ( SizeValueType n = 0; n < numberOfNeighbors; n++ )
+    {
+    OffsetValueType offset = 0;
+    unsigned int    nonZero = 0;
+    SizeValueType   k = n;
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      const OffsetValueType o = static_cast< OffsetValueType >( k % 3 ) - 1;
+      k /= 3;
+      offset += o * offsetTable[d];
+      nonZero += ( o != 0 );
+      }
+    if ( nonZero == 0 || ( !fullyConnected && nonZero > 1 ) )
+      {
+      continue;
+      }
+    m_Offsets.push_back(offset);
+    if ( offset < 0 )
+      {
+      m_PreviousOffsets.push_back(offset);
+      }
+    else
+      {
+      m_LaterOffsets.push_back(offset);
+      }
+    }
+
+  // the pixels of a plane orthogonal to the last dimension are visited
+  // row by row, without the border
+  m_PlaneSize = offsetTable[ImageDimension - 1];
+  m_RowStarts.clear();
+  if ( ImageDimension == 1 )
+    {
+    m_RowLength = 1;
+    m_RowStarts.push_back(0);
+    }
+  else
+    {
+    m_RowLength = size[0] - 2;
+    SizeValueType numberOfRows = 1;
+    for ( unsigned int d = 1; d + 1 < ImageDimension; d++ )
+      {
+      numberOfRows *= size[d] - 2;
+      }
+    for ( SizeValueType r = 0; r < numberOfRows; r++ )
+      {
+      OffsetValueType rowStart = 1;
+      SizeValueType   k = r;
+      for ( unsigned int d = 1; d + 1 < ImageDimension; d++ )
+        {
+        rowStart += static_cast< OffsetValueType >( k % ( size[d] - 2 ) + 1 ) * offsetTable[d];
+        k /= size[d] - 2;
+        }
+      m_RowStarts.push_back(rowStart);
+      }
+    }
+
+  const SizeValueType numberOfPlanes = size[ImageDimension - 1] - 2;
+  if ( numberOfPlanes == 0 || m_RowLength == 0 || m_RowStarts.empty() )
+    {
+    return true;
+    }
+  const SizeValueType numberOfSlabs =
+    std::min( static_cast< SizeValueType >( this->GetMaximumNumberOfThreads() ), numberOfPlanes );
+  m_SlabPlanes.resize(numberOfSlabs + 1);
+  for ( SizeValueType s = 0; s <= numberOfSlabs; s++ )
+    {
+    m_SlabPlanes[s] = 1 + s * numberOfPlanes / numberOfSlabs;
+    }
+  m_Fifos.assign( numberOfSlabs, FifoType() );
+  m_Valid.assign(numberOfSlabs, 1);
+  m_Messages[0].assign( 2 * numberOfSlabs, MessageListType() );
+  m_Messages[1].assign( 2 * numberOfSlabs, MessageListType() );
+
+  // two raster passes and about one FIFO pop per pixel
+  m_FirstSlabProgressPixels = 3 * ( m_SlabPlanes[1] - m_SlabPlanes[0] ) * m_RowStarts.size() * m_RowLength;
+  m_FirstSlabCompletedPixels = 0;
+  m_FirstSlabReportedPixels = 0;
+
+  DomainType slabRange;
+  slabRange[0] = 0;
+  slabRange[1] = static_cast< IndexValueType >( numberOfSlabs ) - 1;
+
+  m_RasterPhase = true;
+  this->Execute(associate, slabRange);
+  this->ThrowIfAborted();
+  if ( std::find(m_Valid.begin(), m_Valid.end(), 0) != m_Valid.end() )
+    {
+    return false;
+    }
+
+  m_RasterPhase = false;
+  m_Round = 0;
+  bool sent = true;
+  while ( sent )
+    {
+    this->Execute(associate, slabRange);
+    this->ThrowIfAborted();
+    ++m_Round;
+    sent = false;
+    for ( SizeValueType i = 0; i < m_Messages[m_Round % 2].size(); i++ )
+      {
+      sent = sent || !m_Messages[m_Round % 2][i].empty();
+      }
+    }
+  return true;
+}
+
+template< typename TAssociate >
+void
+ReconstructionImageFilterThreader< TAssociate >
+::ThreadedExecution( const IndexRangeType & subrange,
+                     const ThreadIdType itkNotUsed(threadId) )
+{
+  for ( IndexValueType s = subrange[0]; s <= subrange[1]; s++ )
+    {
+    if ( m_RasterPhase )
+      {
+      this->RasterPasses(s);
+      }
+    else
+      {
+      this->Propagate(s);
+      }
+    }
+}
+
+template< typename TAssociate >
+void
+ReconstructionImageFilterThreader< TAssociate >
+::RasterPasses( SizeValueType slab )
+{
+  const SizeValueType   firstPlane = m_SlabPlanes[slab];
+  const SizeValueType   endPlane = m_SlabPlanes[slab + 1];
+  const OffsetValueType begin = firstPlane * m_PlaneSize;
+  const OffsetValueType end = endPlane * m_PlaneSize;
+  const bool            hasPrevious = slab > 0;
+  const bool            hasNext = slab + 2 < m_SlabPlanes.size();
+  FifoType &            fifo = m_Fifos[slab];
+
+  // scan in forward raster order
+  for ( SizeValueType z = firstPlane; z < endPlane; z++ )
+    {
+    for ( SizeValueType r = 0; r < m_RowStarts.size(); r++ )
+      {
+      const OffsetValueType rowStart = z * m_PlaneSize + m_RowStarts[r];
+      for ( OffsetValueType p = rowStart; p < rowStart + static_cast< OffsetValueType >( m_RowLength ); p++ )
+        {
+        PixelType       V = m_Marker[p];
+        const PixelType iV = m_Mask[p];
+
+        // be sure that the pixels in the images follow the preconditions
+        if ( m_Compare(V, iV) )
+          {
+          m_Valid[slab] = 0;
+          return;
+          }
+
+        // visit the previous neighbours in the slab
+        for ( SizeValueType i = 0; i < m_PreviousOffsets.size(); i++ )
+          {
+          const OffsetValueType q = p + m_PreviousOffsets[i];
+          if ( q >= begin && m_Compare(m_Marker[q], V) )
+            {
+            V = m_Marker[q];
+            }
+          }
+
+        // this step clamps to the mask
+        if ( m_Compare(V, iV) )
+          {
+          V = iV;
+          }
+        m_Marker[p] = V;
+        }
+      if ( this->CompletedPixels(slab, m_RowLength) )
+        {
+        return;
+        }
+      }
+    }
+
+  // now for the reverse raster order pass
+  for ( SizeValueType z = endPlane; z-- > firstPlane; )
+    {
+    // the pixels next to another slab may propagate there
+    const bool boundaryPlane = ( z == firstPlane && hasPrevious ) || ( z + 1 == endPlane && hasNext );
+    for ( SizeValueType r = m_RowStarts.size(); r-- > 0; )
+      {
+      const OffsetValueType rowStart = z * m_PlaneSize + m_RowStarts[r];
+      for ( OffsetValueType p = rowStart + static_cast< OffsetValueType >( m_RowLength ); p-- > rowStart; )
+        {
+        PixelType V = m_Marker[p];
+        for ( SizeValueType i = 0; i < m_LaterOffsets.size(); i++ )
+          {
+          const OffsetValueType q = p + m_LaterOffsets[i];
+          if ( q < end && m_Compare(m_Marker[q], V) )
+            {
+            V = m_Marker[q];
+            }
+          }
+        const PixelType iV = m_Mask[p];
+        if ( m_Compare(V, iV) )
+          {
+          V = iV;
+          }
+        m_Marker[p] = V;
+
+        // now put indexes in the fifo
+        bool push = boundaryPlane;
+        for ( SizeValueType i = 0; i < m_LaterOffsets.size() && !push; i++ )
+          {
+          const OffsetValueType q = p + m_LaterOffsets[i];
+          push = q < end && m_Compare(V, m_Marker[q]) && m_Compare(m_Mask[q], m_Marker[q]);
+          }
+        if ( push )
+          {
+          fifo.push(p);
+          }
+        }
+      if ( this->CompletedPixels(slab, m_RowLength) )
+        {
+        return;
+        }
+      }
+    }
+}
+
+template< typename TAssociate >
+void
+ReconstructionImageFilterThreader< TAssociate >
+::Propagate( SizeValueType slab )
+{
+  const OffsetValueType begin = m_SlabPlanes[slab] * m_PlaneSize;
+  const OffsetValueType end = m_SlabPlanes[slab + 1] * m_PlaneSize;
+  const bool            hasPrevious = slab > 0;
+  const bool            hasNext = slab + 2 < m_SlabPlanes.size();
+  FifoType &            fifo = m_Fifos[slab];
+
+  // the propagations sent by the neighbor slabs during the previous round
+  std::vector< MessageListType > & received = m_Messages[m_Round % 2];
+  if ( hasPrevious )
+    {
+    MessageListType & messages = received[2 * ( slab - 1 ) + 1];
+    for ( SizeValueType i = 0; i < messages.size(); i++ )
+      {
+      this->PropagateTo(messages[i].first, messages[i].second, fifo);
+      }
+    messages.clear();
+    }
+  if ( hasNext )
+    {
+    MessageListType & messages = received[2 * ( slab + 1 )];
+    for ( SizeValueType i = 0; i < messages.size(); i++ )
+      {
+      this->PropagateTo(messages[i].first, messages[i].second, fifo);
+      }
+    messages.clear();
+    }
+
+  MessageListType & toPrevious = m_Messages[( m_Round + 1 ) % 2][2 * slab];
+  MessageListType & toNext = m_Messages[( m_Round + 1 ) % 2][2 * slab + 1];
+  SizeValueType     popped = 0;
+  while ( !fifo.empty() )
+    {
+    if ( ++popped == PixelsPerProgressCheck )
+      {
+      popped = 0;
+      if ( this->CompletedPixels(slab, PixelsPerProgressCheck) )
+        {
+        return;
+        }
+      }
+    const OffsetValueType p = fifo.front();
+    fifo.pop();
+    const PixelType V = m_Marker[p];
+    for ( SizeValueType i = 0; i < m_Offsets.size(); i++ )
+      {
+      const OffsetValueType q = p + m_Offsets[i];
+      if ( q < begin )
+        {
+        if ( hasPrevious )
+          {
+          toPrevious.push_back( MessageType(q, V) );
+          }
+        }
+      else if ( q >= end )
+        {
+        if ( hasNext )
+          {
+          toNext.push_back( MessageType(q, V) );
+          }
+        }
+      else
+        {
+        this->PropagateTo(q, V, fifo);
+        }
+      }
+    }
+  this->CompletedPixels(slab, popped);
+}
+
+template< typename TAssociate >
+void
+ReconstructionImageFilterThreader< TAssociate >
+::PropagateTo( OffsetValueType q, const PixelType & value, FifoType & fifo )
+{
+  const PixelType VN = m_Marker[q];
+  const PixelType iN = m_Mask[q];
+  // candidate for dilation via flooding
+  if ( m_Compare(value, VN) && Math::NotAlmostEquals( iN, VN ) )
+    {
+    if ( m_Compare(iN, value) )
+      {
+      // not clamped by the mask, propagate the center value
+      m_Marker[q] = value;
+      }
+    else
+      {
+      // apply the clamping
+      m_Marker[q] = iN;
+      }
+    fifo.push(q);
+    }
+}
+
+template< typename TAssociate >
+bool
+ReconstructionImageFilterThreader< TAssociate >
+::CompletedPixels( SizeValueType slab, SizeValueType n )
+{
+  // only the first slab, run by the first thread, updates the progress, in
+  // steps of one percent
+  if ( slab == 0 )
+    {
+    m_FirstSlabCompletedPixels += n;
+    const SizeValueType step = std::max< SizeValueType >( m_FirstSlabProgressPixels / 100, 1 );
+    if ( m_FirstSlabCompletedPixels >= m_FirstSlabReportedPixels + step )
+      {
+      m_FirstSlabReportedPixels = m_FirstSlabCompletedPixels;
+      const float progress = static_cast< float >( m_FirstSlabCompletedPixels ) / m_FirstSlabProgressPixels;
+      this->m_Associate->UpdateProgress( std::min( progress, 1.0f ) );
+      }
+    }
+  return this->m_Associate->GetAbortGenerateData();
+}
+
+template< typename TAssociate >
+void
+ReconstructionImageFilterThreader< TAssociate >
+::ThrowIfAborted() const
+{
+  if ( this->m_Associate->GetAbortGenerateData() )
+    {
+    ProcessAborted e(__FILE__, __LINE__);
+    e.SetDescription( "Object " + std::string( this->m_Associate->GetNameOfClass() ) + ": AbortGenerateDataOn" );
+    throw e;
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -32,7 +32,7 @@ template< typename TImage, typename TBres, typename TLine >
 int ComputeStartEnd(const typename TImage::IndexType StartIndex,
                     const TLine line,
                     const float tol,
-                    const typename TBres::OffsetArray LineOffsets,
+                    const typename TBres::OffsetArray & LineOffsets,
                     const typename TImage::RegionType AllImage,
                     unsigned & start,
                     unsigned & end);
@@ -42,7 +42,7 @@ int FillLineBuffer(typename TImage::ConstPointer input,
                    const typename TImage::IndexType StartIndex,
                    const TLine line,
                    const float tol,
-                   const typename TBres::OffsetArray LineOffsets,
+                   const typename TBres::OffsetArray & LineOffsets,
                    const typename TImage::RegionType AllImage,
                    std::vector<typename TImage::PixelType> & inbuffer,
                    unsigned int &start,
@@ -51,7 +51,7 @@ int FillLineBuffer(typename TImage::ConstPointer input,
 template< typename TImage, typename TBres >
 void CopyLineToImage(const typename TImage::Pointer output,
                      const typename TImage::IndexType StartIndex,
-                     const typename TBres::OffsetArray LineOffsets,
+                     const typename TBres::OffsetArray & LineOffsets,
                      std::vector<typename TImage::PixelType> & outbuffer,
                      const unsigned start,
                      const unsigned end);
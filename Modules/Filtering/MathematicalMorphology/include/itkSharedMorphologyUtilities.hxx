@@ -79,7 +79,7 @@ template< typename TImage, typename TBres, typename TLine >
 int ComputeStartEnd(const typename TImage::IndexType StartIndex,
                     const TLine line,
                     const float tol,
-                    const typename TBres::OffsetArray LineOffsets,
+                    const typename TBres::OffsetArray & LineOffsets,
                     const typename TImage::RegionType AllImage,
                     unsigned & start,
                     unsigned & end)
@@ -241,7 +241,7 @@ int ComputeStartEnd(const typename TImage::IndexType StartIndex,
 template< typename TImage, typename TBres >
 void CopyLineToImage(const typename TImage::Pointer output,
                      const typename TImage::IndexType StartIndex,
-                     const typename TBres::OffsetArray LineOffsets,
+                     const typename TBres::OffsetArray & LineOffsets,
                      std::vector<typename TImage::PixelType> & outbuffer,
                      const unsigned start,
                      const unsigned end)
@@ -258,7 +258,7 @@ void CopyLineToImage(const typename TImage::Pointer output,
 
 template< typename TInputImage, typename TLine >
 typename TInputImage::RegionType
-MakeEnlargedFace(const typename TInputImage::ConstPointer itkNotUsed(input),
+MakeEnlargedFace(const TInputImage *itkNotUsed(input),
                  const typename TInputImage::RegionType AllImage,
                  const TLine line)
 {
@@ -388,7 +388,7 @@ int FillLineBuffer(typename TImage::ConstPointer input,
                    const typename TImage::IndexType StartIndex,
                    const TLine line,  // unit vector
                    const float tol,
-                   const typename TBres::OffsetArray LineOffsets,
+                   const typename TBres::OffsetArray & LineOffsets,
                    const typename TImage::RegionType AllImage,
                    std::vector<typename TImage::PixelType> & inbuffer,
                    unsigned int & start,
@@ -19,8 +19,8 @@
 #define itkVanHerkGilWermanErodeDilateImageFilter_h
 
 #include "itkKernelImageFilter.h"
-#include "itkProgressReporter.h"
-#include "itkBresenhamLine.h"
+#include "itkVanHerkGilWermanErodeDilateLine.h"
+#include "itkMorphologyLineDecompositionThreader.h"
 
 namespace itk
 {
@@ -35,6 +35,10 @@ template< typename TInputImage, typename TOutputImage, typename TKernel > class
  * The SetBoundary facility isn't necessary for operation of the
  * anchor method but is included for compatibility with other
  * morphology classes in itk.
+ *
+ * The lines of the decomposition are applied one after the other to the
+ * whole requested region by a MorphologyLineDecompositionThreader, with
+ * threads over the lines of each pass, several lines at a time.
  * \ingroup ITKMathematicalMorphology
  */
 template< typename TImage, typename TKernel, typename TFunction1 >
@@ -83,9 +87,9 @@ protected:
   ~VanHerkGilWermanErodeDilateImageFilter() {}
   void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
-  /** Multi-thread version GenerateData. */
-  void  ThreadedGenerateData(const InputImageRegionType & outputRegionForThread,
-                             ThreadIdType threadId) ITK_OVERRIDE;
+  /** Apply the lines of the decomposition. The lines of each pass are
+   * processed by several threads. */
+  void  GenerateData() ITK_OVERRIDE;
 
   // should be set by the meta filter
   InputImagePixelType m_Boundary;
@@ -94,8 +98,11 @@ private:
   VanHerkGilWermanErodeDilateImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
-  typedef BresenhamLine< itkGetStaticConstMacro(InputImageDimension) > BresType;
+  // the class that operates on lines
+  typedef VanHerkGilWermanErodeDilateLine< InputImagePixelType, TFunction1 > LineType;
+  typedef MorphologyLineDecompositionThreader< Self, LineType >           LineThreaderType;
 
+  typename LineThreaderType::Pointer m_LineThreader;
 }; // end of class
 } // end namespace itk
 
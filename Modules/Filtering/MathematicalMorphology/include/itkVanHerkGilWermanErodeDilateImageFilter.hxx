@@ -19,9 +19,8 @@
 #define itkVanHerkGilWermanErodeDilateImageFilter_hxx
 
 #include "itkVanHerkGilWermanErodeDilateImageFilter.h"
-#include "itkImageRegionIterator.h"
-
-#include "itkVanHerkGilWermanUtilities.h"
+#include "itkImageAlgorithm.h"
+#include "itkProgressReporter.h"
 
 namespace itk
 {
@@ -30,13 +29,13 @@ VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
 ::VanHerkGilWermanErodeDilateImageFilter():
   m_Boundary( NumericTraits< InputImagePixelType >::ZeroValue() )
 {
+  m_LineThreader = LineThreaderType::New();
 }
 
 template< typename TImage, typename TKernel, typename TFunction1 >
 void
 VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
-::ThreadedGenerateData(const InputImageRegionType & outputRegionForThread,
-                       ThreadIdType threadId)
+::GenerateData()
 {
   // check that we are using a decomposable kernel
   if ( !this->GetKernel().GetDecomposable() )
@@ -44,81 +43,40 @@ VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
     itkExceptionMacro("VanHerkGilWerman morphology only works with decomposable structuring elements");
     return;
     }
+  // TFunction1 will be < for erosions
 
-// TFunction1 will be < for erosions
-
-  // the initial version will adopt the methodology of loading a line
-  // at a time into a buffer vector, carrying out the opening or
-  // closing, and then copy the result to the output. Hopefully this
-  // will improve cache performance when working along non raster
-  // directions.
+  this->AllocateOutputs();
 
-  ProgressReporter progress(this, threadId, static_cast<SizeValueType>( this->GetKernel().GetLines().size() ) + 1);
+  const InputImageType * input = this->GetInput();
+  InputImageType *       output = this->GetOutput();
 
-  InputImageConstPointer input = this->GetInput();
+  const typename KernelType::DecompType & decomposition = this->GetKernel().GetLines();
+  ProgressReporter progress(this, 0, static_cast<SizeValueType>( decomposition.size() ) + 1);
 
-  InputImageRegionType IReg = outputRegionForThread;
+  // the lines are applied to the requested region padded by the kernel
+  // radius, so that the boundary effects do not reach the output
+  const InputImageRegionType OReg = output->GetRequestedRegion();
+  InputImageRegionType       IReg = OReg;
   IReg.PadByRadius( this->GetKernel().GetRadius() );
-  // IReg.PadByRadius( this->GetKernel().GetRadius() );
-  IReg.Crop( this->GetInput()->GetRequestedRegion() );
-
-  // allocate an internal buffer
-  typename InputImageType::Pointer internalbuffer = InputImageType::New();
-  internalbuffer->SetRegions(IReg);
-  internalbuffer->Allocate();
-  InputImagePointer output = internalbuffer;
+  IReg.Crop( input->GetRequestedRegion() );
 
-  // get the region size
-  InputImageRegionType OReg = outputRegionForThread;
-  // maximum buffer length is sum of dimensions
-  unsigned int bufflength = 0;
-  for ( unsigned i = 0; i < TImage::ImageDimension; i++ )
+  // work in place in the output when there is no padding, and in an
+  // internal buffer otherwise
+  InputImagePointer internalbuffer = output;
+  if ( IReg != output->GetBufferedRegion() )
     {
-    bufflength += IReg.GetSize()[i];
+    internalbuffer = InputImageType::New();
+    internalbuffer->SetRegions(IReg);
+    internalbuffer->Allocate();
     }
 
-  // compat
-  bufflength += 2;
-
-  std::vector<InputImagePixelType> buffer(bufflength);
-  std::vector<InputImagePixelType> forward(bufflength);
-  std::vector<InputImagePixelType> reverse(bufflength);
-  // iterate over all the structuring elements
-  typename KernelType::DecompType decomposition = this->GetKernel().GetLines();
-  BresType BresLine;
-
-  typedef typename KernelType::LType KernelLType;
-
-  for ( unsigned i = 0; i < decomposition.size(); i++ )
-    {
-    typename KernelType::LType ThisLine = decomposition[i];
-    typename BresType::OffsetArray TheseOffsets = BresLine.BuildLine(ThisLine, bufflength);
-    unsigned int SELength = GetLinePixels< KernelLType >(ThisLine);
-    // want lines to be odd
-    if ( !( SELength % 2 ) )
-      {
-      ++SELength;
-      }
-
-    InputImageRegionType BigFace = MakeEnlargedFace< InputImageType, KernelLType >(input, IReg, ThisLine);
-
-    DoFace< TImage, BresType, TFunction1, KernelLType >(input, output, m_Boundary, ThisLine,
-                                                        TheseOffsets, SELength,
-                                                        buffer, forward,
-                                                        reverse, IReg, BigFace);
-
-    // after the first pass the input will be taken from the output
-    input = internalbuffer;
-    progress.CompletedPixel();
-    }
+  m_LineThreader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+  m_LineThreader->Run(this, input, internalbuffer, IReg, decomposition, m_Boundary, progress);
 
   // copy internal buffer to output
-  typedef ImageRegionIterator< InputImageType > IterType;
-  IterType oit(this->GetOutput(), OReg);
-  IterType iit(internalbuffer, OReg);
-  for ( oit.GoToBegin(), iit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++iit )
+  if ( internalbuffer != output )
     {
-    oit.Set( iit.Get() );
+    ImageAlgorithm::Copy( internalbuffer.GetPointer(), output, OReg, OReg );
     }
   progress.CompletedPixel();
 }
@@ -0,0 +1,86 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkVanHerkGilWermanErodeDilateLine_h
+#define itkVanHerkGilWermanErodeDilateLine_h
+
+#include "itkMacro.h"
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class VanHerkGilWermanErodeDilateLine
+ * \brief Erodes or dilates several lines at once with the van
+ * Herk/Gil-Werman algorithm.
+ *
+ * The lines are interleaved in the buffers: sample \c i of line \c l is
+ * at position <tt>i * NumberOfLanes + l</tt>. All the lines have the
+ * same length, so the loops over the lines have a constant trip count
+ * and are vectorized by the compiler. The first and last samples of
+ * each line hold the boundary value, as in the other line based
+ * morphology classes.
+ *
+ * TFunction returns the minimum of its arguments for erosions, and the
+ * maximum for dilations.
+ *
+ * \sa AnchorErodeDilateLine
+ * \ingroup ITKMathematicalMorphology
+ */
+template< typename TInputPix, typename TFunction >
+class VanHerkGilWermanErodeDilateLine
+{
+public:
+  /** Some convenient typedefs. */
+  typedef TInputPix InputImagePixelType;
+
+  /** Number of lines processed by a call to DoLine(). */
+  itkStaticConstMacro(NumberOfLanes, unsigned int,
+                      sizeof( TInputPix ) < 32 ? 32 / sizeof( TInputPix ) : 1);
+
+  /** Process NumberOfLanes interleaved lines of \c bufflength samples
+   * from \c inbuffer, and write the result in \c buffer. */
+  void DoLine(std::vector<TInputPix> & buffer, std::vector<TInputPix> & inbuffer,
+              unsigned bufflength);
+
+  void SetSize(unsigned int size)
+  {
+    m_Size = size;
+  }
+
+  VanHerkGilWermanErodeDilateLine() :
+    m_Size( 0 )
+  {
+  }
+
+  ~VanHerkGilWermanErodeDilateLine()
+  {
+  }
+
+private:
+  unsigned int m_Size;
+
+  std::vector< TInputPix > m_ForwardExtremes;
+  std::vector< TInputPix > m_ReverseExtremes;
+}; // end of class
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkVanHerkGilWermanErodeDilateLine.hxx"
+#endif
+
+#endif
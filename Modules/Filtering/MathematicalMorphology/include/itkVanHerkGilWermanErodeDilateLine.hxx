@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkVanHerkGilWermanErodeDilateLine_hxx
+#define itkVanHerkGilWermanErodeDilateLine_hxx
+
+#include "itkVanHerkGilWermanErodeDilateLine.h"
+
+namespace itk
+{
+template< typename TInputPix, typename TFunction >
+void
+VanHerkGilWermanErodeDilateLine< TInputPix, TFunction >
+::DoLine(std::vector<TInputPix> & buffer, std::vector<TInputPix> & inbuffer,
+         unsigned bufflength)
+{
+  const unsigned int lanes = NumberOfLanes;
+  const unsigned int size = bufflength;
+  const unsigned int KernLen = m_Size;
+  const unsigned int half = KernLen / 2;
+  TFunction          m_TF;
+
+  if ( m_ForwardExtremes.size() < size * lanes )
+    {
+    m_ForwardExtremes.resize(size * lanes);
+    m_ReverseExtremes.resize(size * lanes);
+    }
+  const std::vector< TInputPix > & in = inbuffer;
+  std::vector< TInputPix > &       out = buffer;
+  std::vector< TInputPix > &       fExt = m_ForwardExtremes;
+  std::vector< TInputPix > &       rExt = m_ReverseExtremes;
+
+  // the extremes are restarted at the beginning of each block of
+  // KernLen samples, going forward, and at the end of each block,
+  // going backward
+  for ( unsigned int i = 0; i < size; i++ )
+    {
+    if ( i % KernLen == 0 )
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        fExt[i * lanes + l] = in[i * lanes + l];
+        }
+      }
+    else
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        fExt[i * lanes + l] = m_TF(in[i * lanes + l], fExt[( i - 1 ) * lanes + l]);
+        }
+      }
+    }
+  for ( unsigned int i = size; i-- > 0; )
+    {
+    if ( i == size - 1 || ( i + 1 ) % KernLen == 0 )
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        rExt[i * lanes + l] = in[i * lanes + l];
+        }
+      }
+    else
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        rExt[i * lanes + l] = m_TF(in[i * lanes + l], rExt[( i + 1 ) * lanes + l]);
+        }
+      }
+    }
+
+  // now compute result
+  if ( size <= half )
+    {
+    for ( unsigned int j = 0; j < size; j++ )
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        out[j * lanes + l] = fExt[( size - 1 ) * lanes + l];
+        }
+      }
+    }
+  else if ( size <= KernLen )
+    {
+    for ( unsigned int j = 0; j < size - half; j++ )
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        out[j * lanes + l] = fExt[( j + half ) * lanes + l];
+        }
+      }
+    for ( unsigned int j = size - half; j <= half; j++ )
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        out[j * lanes + l] = fExt[( size - 1 ) * lanes + l];
+        }
+      }
+    for ( unsigned int j = half + 1; j < size; j++ )
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        out[j * lanes + l] = rExt[( j - half ) * lanes + l];
+        }
+      }
+    }
+  else
+    {
+    // line beginning
+    for ( unsigned int j = 0; j < half; j++ )
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        out[j * lanes + l] = fExt[( j + half ) * lanes + l];
+        }
+      }
+    for ( unsigned int j = half; j < size - half; j++ )
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        out[j * lanes + l] = m_TF(fExt[( j + half ) * lanes + l], rExt[( j - half ) * lanes + l]);
+        }
+      }
+    // line end -- involves reseting the end of the reverse
+    // extreme array
+    for ( unsigned int j = size - 2; ( j > 0 ) && ( j >= ( size - KernLen - 1 ) ); j-- )
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        rExt[j * lanes + l] = m_TF(rExt[( j + 1 ) * lanes + l], rExt[j * lanes + l]);
+        }
+      }
+    for ( unsigned int j = size - half; j < size; j++ )
+      {
+      for ( unsigned int l = 0; l < lanes; l++ )
+        {
+        out[j * lanes + l] = rExt[( j - half ) * lanes + l];
+        }
+      }
+    }
+}
+
+} // end namespace itk
+
+#endif
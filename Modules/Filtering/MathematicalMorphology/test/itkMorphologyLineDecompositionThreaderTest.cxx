@@ -0,0 +1,295 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkGrayscaleErodeImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+/* Check the line decomposition algorithms, which apply the lines with
+ * threads over the lines of each pass. Boxes are decomposed exactly, so
+ * every algorithm must give the maximum (dilation) or the minimum
+ * (erosion) of the input over the box clipped to the image, for any
+ * number of threads and any requested region. The oblique lines of
+ * polygons only approximate the kernel: polygons are compared with the
+ * single threaded result of the same algorithm, and since the kernel
+ * contains its center, the dilation can't be lower than the input and the
+ * erosion can't be higher. */
+namespace
+{
+
+// The dilation or the erosion by a box, computed pixel by pixel.
+template< typename TImage >
+typename TImage::Pointer
+BoxReference( const TImage * image, const typename TImage::SizeType & radius, bool dilate )
+{
+  typedef typename TImage::RegionType RegionType;
+  typedef typename TImage::PixelType  PixelType;
+
+  const RegionType largestRegion = image->GetLargestPossibleRegion();
+  typename TImage::Pointer reference = TImage::New();
+  reference->SetRegions( largestRegion );
+  reference->Allocate();
+
+  itk::ImageRegionConstIteratorWithIndex< TImage > it( image, largestRegion );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    typename TImage::IndexType index = it.GetIndex();
+    typename TImage::SizeType  size;
+    for ( unsigned int d = 0; d < TImage::ImageDimension; ++d )
+      {
+      index[d] -= static_cast< typename TImage::IndexValueType >( radius[d] );
+      size[d] = 2 * radius[d] + 1;
+      }
+    RegionType box( index, size );
+    box.Crop( largestRegion );
+
+    itk::ImageRegionConstIterator< TImage > bit( image, box );
+    PixelType value = bit.Get();
+    for ( ; !bit.IsAtEnd(); ++bit )
+      {
+      value = dilate ? std::max( value, bit.Get() ) : std::min( value, bit.Get() );
+      }
+    reference->SetPixel( it.GetIndex(), value );
+    }
+  return reference;
+}
+
+template< typename TImage >
+unsigned int
+CountMismatches( const TImage * image, const TImage * reference, const typename TImage::RegionType & region )
+{
+  itk::ImageRegionConstIterator< TImage > it( image, region );
+  itk::ImageRegionConstIterator< TImage > rit( reference, region );
+  unsigned int mismatches = 0;
+  for ( ; !it.IsAtEnd(); ++it, ++rit )
+    {
+    if ( it.Get() != rit.Get() )
+      {
+      ++mismatches;
+      }
+    }
+  return mismatches;
+}
+
+template< typename TFilter >
+int
+CheckBox( typename TFilter::InputImageType * image,
+          const typename TFilter::KernelType & kernel,
+          const char * name, bool dilate )
+{
+  typedef typename TFilter::InputImageType ImageType;
+  typedef typename ImageType::RegionType   RegionType;
+
+  typename ImageType::Pointer reference = BoxReference< ImageType >( image, kernel.GetRadius(), dilate );
+
+  // a requested region touching the lower boundary of the image only
+  RegionType subRegion = image->GetLargestPossibleRegion();
+  for ( unsigned int d = 0; d < ImageType::ImageDimension; ++d )
+    {
+    subRegion.SetSize( d, subRegion.GetSize( d ) / 2 + 1 );
+    }
+
+  const int algorithms[] = { TFilter::BASIC, TFilter::ANCHOR, TFilter::VHGW };
+  const char * algorithmNames[] = { "BASIC", "ANCHOR", "VHGW" };
+  int status = EXIT_SUCCESS;
+  for ( unsigned int a = 0; a < 3; ++a )
+    {
+    for ( itk::ThreadIdType threads = 1; threads <= 4; threads += 3 )
+      {
+      for ( unsigned int r = 0; r < 2; ++r )
+        {
+        const RegionType region = r == 0 ? image->GetLargestPossibleRegion() : subRegion;
+
+        typename TFilter::Pointer filter = TFilter::New();
+        filter->SetInput( image );
+        filter->SetKernel( kernel );
+        filter->SetAlgorithm( algorithms[a] );
+        filter->SetNumberOfThreads( threads );
+        filter->GetOutput()->SetRequestedRegion( region );
+        TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+        const unsigned int mismatches = CountMismatches< ImageType >( filter->GetOutput(), reference, region );
+        if ( mismatches != 0 )
+          {
+          std::cerr << name << " " << algorithmNames[a] << " with " << threads
+                    << " thread(s) on the requested region " << region.GetIndex()
+                    << region.GetSize() << ": " << mismatches
+                    << " pixels differ from the brute force result" << std::endl;
+          status = EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  return status;
+}
+
+template< typename TFilter >
+int
+CheckPolygon( typename TFilter::InputImageType * image,
+              const typename TFilter::KernelType & kernel,
+              const char * name, bool dilate )
+{
+  typedef typename TFilter::InputImageType ImageType;
+
+  const typename ImageType::RegionType region = image->GetLargestPossibleRegion();
+  const int algorithms[] = { TFilter::ANCHOR, TFilter::VHGW };
+  const char * algorithmNames[] = { "ANCHOR", "VHGW" };
+  int status = EXIT_SUCCESS;
+  for ( unsigned int a = 0; a < 2; ++a )
+    {
+    typename TFilter::Pointer reference = TFilter::New();
+    reference->SetInput( image );
+    reference->SetKernel( kernel );
+    reference->SetAlgorithm( algorithms[a] );
+    reference->SetNumberOfThreads( 1 );
+    TRY_EXPECT_NO_EXCEPTION( reference->Update() );
+
+    unsigned int wrongSide = 0;
+    itk::ImageRegionConstIterator< ImageType > it( image, region );
+    itk::ImageRegionConstIterator< ImageType > rit( reference->GetOutput(), region );
+    for ( ; !it.IsAtEnd(); ++it, ++rit )
+      {
+      if ( dilate ? rit.Get() < it.Get() : rit.Get() > it.Get() )
+        {
+        ++wrongSide;
+        }
+      }
+    if ( wrongSide != 0 )
+      {
+      std::cerr << name << " " << algorithmNames[a] << ": " << wrongSide
+                << ( dilate ? " pixels are lower" : " pixels are higher" )
+                << " than the input" << std::endl;
+      status = EXIT_FAILURE;
+      }
+
+    typename TFilter::Pointer filter = TFilter::New();
+    filter->SetInput( image );
+    filter->SetKernel( kernel );
+    filter->SetAlgorithm( algorithms[a] );
+    filter->SetNumberOfThreads( 4 );
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+    const unsigned int mismatches = CountMismatches< ImageType >( filter->GetOutput(), reference->GetOutput(), region );
+    if ( mismatches != 0 )
+      {
+      std::cerr << name << " " << algorithmNames[a] << " with 4 threads: " << mismatches
+                << " pixels differ from the single threaded result" << std::endl;
+      status = EXIT_FAILURE;
+      }
+    }
+  return status;
+}
+
+template< unsigned int VDimension >
+typename itk::Image< short, VDimension >::Pointer
+MakeImage( const itk::Size< VDimension > & size )
+{
+  typedef itk::Image< short, VDimension > ImageType;
+
+  typename ImageType::IndexType index;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    index[d] = static_cast< typename ImageType::IndexValueType >( 3 * d ) - 2;
+    }
+  typename ImageType::RegionType region( index, size );
+
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 11 );
+
+  itk::ImageRegionIterator< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< short >( generator->GetIntegerVariate( 1999 ) ) - 1000 );
+    }
+  return image;
+}
+
+} // end anonymous namespace
+
+int itkMorphologyLineDecompositionThreaderTest( int, char *[] )
+{
+  int status = EXIT_SUCCESS;
+
+  // 2D, with oblique lines
+  typedef itk::Image< short, 2 >                                          Image2DType;
+  typedef itk::FlatStructuringElement< 2 >                                Kernel2DType;
+  typedef itk::GrayscaleDilateImageFilter< Image2DType, Image2DType, Kernel2DType > Dilate2DType;
+  typedef itk::GrayscaleErodeImageFilter< Image2DType, Image2DType, Kernel2DType >  Erode2DType;
+
+  itk::Size< 2 > size2D;
+  size2D[0] = 61;
+  size2D[1] = 47;
+  Image2DType::Pointer image2D = MakeImage< 2 >( size2D );
+
+  Kernel2DType::RadiusType radius2D;
+  radius2D[0] = 7;
+  radius2D[1] = 5;
+  const Kernel2DType box2D = Kernel2DType::Box( radius2D );
+  radius2D.Fill( 6 );
+  const Kernel2DType polygon2D = Kernel2DType::Polygon( radius2D, 6 );
+
+  if ( CheckBox< Dilate2DType >( image2D, box2D, "2D box dilation", true ) != EXIT_SUCCESS
+       || CheckBox< Erode2DType >( image2D, box2D, "2D box erosion", false ) != EXIT_SUCCESS
+       || CheckPolygon< Dilate2DType >( image2D, polygon2D, "2D polygon dilation", true ) != EXIT_SUCCESS
+       || CheckPolygon< Erode2DType >( image2D, polygon2D, "2D polygon erosion", false ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  // 3D, with a structuring element larger than the image along z
+  typedef itk::Image< short, 3 >                                          Image3DType;
+  typedef itk::FlatStructuringElement< 3 >                                Kernel3DType;
+  typedef itk::GrayscaleDilateImageFilter< Image3DType, Image3DType, Kernel3DType > Dilate3DType;
+  typedef itk::GrayscaleErodeImageFilter< Image3DType, Image3DType, Kernel3DType >  Erode3DType;
+
+  itk::Size< 3 > size3D;
+  size3D[0] = 29;
+  size3D[1] = 23;
+  size3D[2] = 9;
+  Image3DType::Pointer image3D = MakeImage< 3 >( size3D );
+
+  Kernel3DType::RadiusType radius3D;
+  radius3D[0] = 4;
+  radius3D[1] = 2;
+  radius3D[2] = 6;
+  const Kernel3DType box3D = Kernel3DType::Box( radius3D );
+  radius3D.Fill( 3 );
+  const Kernel3DType polygon3D = Kernel3DType::Polygon( radius3D, 10 );
+
+  if ( CheckBox< Dilate3DType >( image3D, box3D, "3D box dilation", true ) != EXIT_SUCCESS
+       || CheckBox< Erode3DType >( image3D, box3D, "3D box erosion", false ) != EXIT_SUCCESS
+       || CheckPolygon< Dilate3DType >( image3D, polygon3D, "3D polygon dilation", true ) != EXIT_SUCCESS
+       || CheckPolygon< Erode3DType >( image3D, polygon3D, "3D polygon erosion", false ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test finished." << std::endl;
+    }
+  return status;
+}
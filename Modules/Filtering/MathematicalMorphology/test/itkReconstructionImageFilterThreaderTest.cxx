@@ -0,0 +1,377 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkReconstructionByDilationImageFilter.h"
+#include "itkReconstructionByErosionImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkCommand.h"
+#include "itkTestingMacros.h"
+
+/* Check that the threaded reconstruction, which splits the image in
+ * slabs exchanging their propagations, gives the reconstruction computed
+ * by repeated elementary geodesic dilations or erosions, for any number
+ * of threads, with and without the internal copy, and for both
+ * connectivities. The mask has large plateaus so that the propagation
+ * crosses the slabs several times. Also check that the progress is
+ * reported and that the filter can be aborted with any number of
+ * threads. */
+namespace
+{
+
+/* The reconstruction by dilation (erosion) of the marker under (above)
+ * the mask: the marker is dilated (eroded) by the elementary neighborhood
+ * and clipped by the mask until it doesn't change anymore. */
+template< typename TImage >
+typename TImage::Pointer
+GeodesicReconstruction( const TImage * marker, const TImage * mask, bool fullyConnected, bool dilate )
+{
+  typedef typename TImage::RegionType RegionType;
+  typedef typename TImage::IndexType  IndexType;
+  typedef typename TImage::OffsetType OffsetType;
+  typedef typename TImage::PixelType  PixelType;
+
+  std::vector< OffsetType > neighbors;
+  unsigned int neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < TImage::ImageDimension; ++d )
+    {
+    neighborhoodSize *= 3;
+    }
+  for ( unsigned int n = 0; n < neighborhoodSize; ++n )
+    {
+    OffsetType   offset;
+    unsigned int nonZero = 0;
+    unsigned int rest = n;
+    for ( unsigned int d = 0; d < TImage::ImageDimension; ++d )
+      {
+      offset[d] = static_cast< typename OffsetType::OffsetValueType >( rest % 3 ) - 1;
+      rest /= 3;
+      if ( offset[d] != 0 )
+        {
+        ++nonZero;
+        }
+      }
+    if ( nonZero == 1 || ( nonZero > 1 && fullyConnected ) )
+      {
+      neighbors.push_back( offset );
+      }
+    }
+
+  const RegionType region = mask->GetLargestPossibleRegion();
+  typename TImage::Pointer current = TImage::New();
+  current->SetRegions( region );
+  current->Allocate();
+  typename TImage::Pointer next = TImage::New();
+  next->SetRegions( region );
+  next->Allocate();
+
+  itk::ImageRegionConstIterator< TImage > mit( marker, region );
+  itk::ImageRegionIterator< TImage >      cit( current, region );
+  for ( ; !cit.IsAtEnd(); ++cit, ++mit )
+    {
+    cit.Set( mit.Get() );
+    }
+
+  bool changed = true;
+  while ( changed )
+    {
+    changed = false;
+    itk::ImageRegionConstIteratorWithIndex< TImage > it( current, region );
+    itk::ImageRegionConstIterator< TImage >          maskIt( mask, region );
+    for ( ; !it.IsAtEnd(); ++it, ++maskIt )
+      {
+      PixelType value = it.Get();
+      for ( unsigned int k = 0; k < neighbors.size(); ++k )
+        {
+        const IndexType index = it.GetIndex() + neighbors[k];
+        if ( region.IsInside( index ) )
+          {
+          const PixelType neighbor = current->GetPixel( index );
+          value = dilate ? std::max( value, neighbor ) : std::min( value, neighbor );
+          }
+        }
+      value = dilate ? std::min( value, maskIt.Get() ) : std::max( value, maskIt.Get() );
+      if ( value != it.Get() )
+        {
+        changed = true;
+        }
+      next->SetPixel( it.GetIndex(), value );
+      }
+    std::swap( current, next );
+    }
+  return current;
+}
+
+template< typename TFilter >
+int
+CompareWithGeodesicReconstruction( typename TFilter::InputImageType * marker,
+                                   typename TFilter::InputImageType * mask,
+                                   const char * name, bool dilate )
+{
+  typedef typename TFilter::InputImageType ImageType;
+
+  int status = EXIT_SUCCESS;
+  for ( unsigned int fullyConnected = 0; fullyConnected < 2; ++fullyConnected )
+    {
+    typename ImageType::Pointer reference =
+      GeodesicReconstruction< ImageType >( marker, mask, fullyConnected, dilate );
+
+    for ( unsigned int useInternalCopy = 0; useInternalCopy < 2; ++useInternalCopy )
+      {
+      for ( itk::ThreadIdType threads = 1; threads <= 7; threads += 2 )
+        {
+        typename TFilter::Pointer filter = TFilter::New();
+        filter->SetMarkerImage( marker );
+        filter->SetMaskImage( mask );
+        filter->SetFullyConnected( fullyConnected );
+        filter->SetUseInternalCopy( useInternalCopy );
+        filter->SetNumberOfThreads( threads );
+        TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+        itk::ImageRegionConstIterator< ImageType > it( filter->GetOutput(),
+                                                       filter->GetOutput()->GetLargestPossibleRegion() );
+        itk::ImageRegionConstIterator< ImageType > rit( reference, reference->GetLargestPossibleRegion() );
+        unsigned int mismatches = 0;
+        for ( ; !it.IsAtEnd(); ++it, ++rit )
+          {
+          if ( it.Get() != rit.Get() )
+            {
+            ++mismatches;
+            }
+          }
+        if ( mismatches != 0 )
+          {
+          std::cerr << name << " with " << threads << " thread(s), FullyConnected "
+                    << fullyConnected << ", UseInternalCopy " << useInternalCopy << ": "
+                    << mismatches << " pixels differ from the geodesic reconstruction" << std::endl;
+          status = EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  return status;
+}
+
+/* Record the progress events of a filter, and abort it when its progress
+ * reaches a given value. */
+class ProgressObserver : public itk::Command
+{
+public:
+  typedef ProgressObserver             Self;
+  typedef itk::Command                 Superclass;
+  typedef itk::SmartPointer< Self >    Pointer;
+
+  itkNewMacro( Self );
+
+  void Execute( itk::Object * caller, const itk::EventObject & event ) ITK_OVERRIDE
+    {
+    itk::ProcessObject * filter = dynamic_cast< itk::ProcessObject * >( caller );
+    if ( filter == ITK_NULLPTR || !itk::ProgressEvent().CheckEvent( &event ) )
+      {
+      return;
+      }
+    const float progress = filter->GetProgress();
+    if ( progress > 0.0f && progress < 1.0f )
+      {
+      ++m_NumberOfIntermediateEvents;
+      }
+    if ( progress < m_LastProgress && progress > 0.0f )
+      {
+      m_Decreased = true;
+      }
+    m_LastProgress = progress;
+    if ( progress >= m_AbortAt )
+      {
+      filter->AbortGenerateDataOn();
+      }
+    }
+
+  void Execute( const itk::Object *, const itk::EventObject & ) ITK_OVERRIDE
+    {
+    }
+
+  unsigned int m_NumberOfIntermediateEvents;
+  float        m_LastProgress;
+  bool         m_Decreased;
+  float        m_AbortAt;
+
+protected:
+  ProgressObserver() :
+    m_NumberOfIntermediateEvents( 0 ),
+    m_LastProgress( 0.0f ),
+    m_Decreased( false ),
+    m_AbortAt( 2.0f )
+    {
+    }
+};
+
+template< typename TFilter >
+int
+CheckProgressAndAbort( typename TFilter::InputImageType * marker,
+                       typename TFilter::InputImageType * mask )
+{
+  int status = EXIT_SUCCESS;
+  for ( unsigned int useInternalCopy = 0; useInternalCopy < 2; ++useInternalCopy )
+    {
+    for ( itk::ThreadIdType threads = 1; threads <= 4; threads += 3 )
+      {
+      typename TFilter::Pointer filter = TFilter::New();
+      filter->SetMarkerImage( marker );
+      filter->SetMaskImage( mask );
+      filter->SetUseInternalCopy( useInternalCopy );
+      filter->SetNumberOfThreads( threads );
+      ProgressObserver::Pointer observer = ProgressObserver::New();
+      filter->AddObserver( itk::ProgressEvent(), observer );
+      TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+      if ( observer->m_NumberOfIntermediateEvents < 10 || observer->m_Decreased
+           || observer->m_LastProgress != 1.0f )
+        {
+        std::cerr << "UseInternalCopy " << useInternalCopy << " with " << threads
+                  << " thread(s): " << observer->m_NumberOfIntermediateEvents
+                  << " intermediate progress events, final progress "
+                  << observer->m_LastProgress
+                  << ( observer->m_Decreased ? ", decreasing progress" : "" ) << std::endl;
+        status = EXIT_FAILURE;
+        }
+
+      typename TFilter::Pointer aborted = TFilter::New();
+      aborted->SetMarkerImage( marker );
+      aborted->SetMaskImage( mask );
+      aborted->SetUseInternalCopy( useInternalCopy );
+      aborted->SetNumberOfThreads( threads );
+      ProgressObserver::Pointer abortObserver = ProgressObserver::New();
+      abortObserver->m_AbortAt = 0.3f;
+      aborted->AddObserver( itk::ProgressEvent(), abortObserver );
+      TRY_EXPECT_EXCEPTION( aborted->Update() );
+      }
+    }
+  return status;
+}
+
+template< unsigned int VDimension >
+typename itk::Image< short, VDimension >::Pointer
+MakeImage( const itk::Size< VDimension > & size, unsigned int seed, unsigned int levels )
+{
+  typedef itk::Image< short, VDimension > ImageType;
+
+  typename ImageType::IndexType index;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    index[d] = static_cast< typename ImageType::IndexValueType >( 2 * d ) - 3;
+    }
+  typename ImageType::RegionType region( index, size );
+
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( seed );
+
+  itk::ImageRegionIterator< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< short >( generator->GetIntegerVariate( levels - 1 ) * 100 ) );
+    }
+  return image;
+}
+
+/* Sparse seeds taken from the mask, and the background elsewhere. */
+template< typename TImage >
+typename TImage::Pointer
+MakeMarker( const TImage * mask, typename TImage::PixelType background )
+{
+  typename TImage::Pointer marker = TImage::New();
+  marker->SetRegions( mask->GetLargestPossibleRegion() );
+  marker->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 5 );
+
+  itk::ImageRegionConstIterator< TImage > mit( mask, mask->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< TImage >      it( marker, marker->GetLargestPossibleRegion() );
+  for ( ; !it.IsAtEnd(); ++it, ++mit )
+    {
+    it.Set( generator->GetIntegerVariate( 499 ) == 0 ? mit.Get() : background );
+    }
+  return marker;
+}
+
+} // end anonymous namespace
+
+int itkReconstructionImageFilterThreaderTest( int, char *[] )
+{
+  int status = EXIT_SUCCESS;
+
+  typedef itk::Image< short, 2 >                                                 Image2DType;
+  typedef itk::ReconstructionByDilationImageFilter< Image2DType, Image2DType > Dilation2DType;
+  typedef itk::ReconstructionByErosionImageFilter< Image2DType, Image2DType >  Erosion2DType;
+
+  itk::Size< 2 > size2D;
+  size2D[0] = 73;
+  size2D[1] = 61;
+  Image2DType::Pointer mask2D = MakeImage< 2 >( size2D, 3, 3 );
+
+  if ( CompareWithGeodesicReconstruction< Dilation2DType >(
+         MakeMarker< Image2DType >( mask2D, -1 ), mask2D, "2D dilation", true ) != EXIT_SUCCESS
+       || CompareWithGeodesicReconstruction< Erosion2DType >(
+         MakeMarker< Image2DType >( mask2D, 1000 ), mask2D, "2D erosion", false ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  typedef itk::Image< short, 3 >                                                 Image3DType;
+  typedef itk::ReconstructionByDilationImageFilter< Image3DType, Image3DType > Dilation3DType;
+  typedef itk::ReconstructionByErosionImageFilter< Image3DType, Image3DType >  Erosion3DType;
+
+  itk::Size< 3 > size3D;
+  size3D[0] = 31;
+  size3D[1] = 27;
+  size3D[2] = 19;
+  Image3DType::Pointer mask3D = MakeImage< 3 >( size3D, 7, 3 );
+
+  if ( CompareWithGeodesicReconstruction< Dilation3DType >(
+         MakeMarker< Image3DType >( mask3D, -1 ), mask3D, "3D dilation", true ) != EXIT_SUCCESS
+       || CompareWithGeodesicReconstruction< Erosion3DType >(
+         MakeMarker< Image3DType >( mask3D, 1000 ), mask3D, "3D erosion", false ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  if ( CheckProgressAndAbort< Dilation3DType >(
+         MakeMarker< Image3DType >( mask3D, -1 ), mask3D ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  // a marker above the mask is still detected by the threads
+  Image3DType::Pointer marker3D = MakeMarker< Image3DType >( mask3D, 1000 );
+  Dilation3DType::Pointer invalid = Dilation3DType::New();
+  invalid->SetMarkerImage( marker3D );
+  invalid->SetMaskImage( mask3D );
+  invalid->SetNumberOfThreads( 3 );
+  TRY_EXPECT_EXCEPTION( invalid->Update() );
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test finished." << std::endl;
+    }
+  return status;
+}
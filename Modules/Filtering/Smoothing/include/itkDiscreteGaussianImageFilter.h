@@ -20,6 +20,7 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
+#include "itkIsSame.h"
 
 namespace itk
 {
@@ -43,6 +44,12 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * For itk::Image inputs and outputs, all the dimensions are filtered in a
+ * single streamed pass: each piece of the output is convolved one
+ * direction at a time with LineConvolution, in place in an internal real
+ * valued image that is reused from piece to piece. Other image types are
+ * filtered with a pipeline of NeighborhoodOperatorImageFilter.
+ *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
@@ -95,6 +102,11 @@ public:
   itkStaticConstMacro(ImageDimension, unsigned int,
                       TOutputImage::ImageDimension);
 
+  /** Type of the internal image holding the partially filtered pixels. */
+  typedef typename NumericTraits< OutputPixelType >::RealType        RealOutputPixelType;
+  typedef typename NumericTraits< RealOutputPixelType >::ValueType   RealOutputPixelValueType;
+  typedef Image< RealOutputPixelType, itkGetStaticConstMacro(ImageDimension) > RealOutputImageType;
+
   /** Typedef of double containers */
   typedef FixedArray< double, itkGetStaticConstMacro(ImageDimension) > ArrayType;
 
@@ -244,16 +256,23 @@ protected:
   void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
   /** Standard pipeline method. While this class does not implement a
-   * ThreadedGenerateData(), its GenerateData() delegates all
-   * calculations to an NeighborhoodOperatorImageFilter.  Since the
-   * NeighborhoodOperatorImageFilter is multithreaded, this filter is
-   * multithreaded by default. */
+   * ThreadedGenerateData(), its GenerateData() runs each convolution pass
+   * with multiple threads, so this filter is multithreaded by default. */
   void GenerateData() ITK_OVERRIDE;
 
 private:
   DiscreteGaussianImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
+  /** LineConvolution accesses the pixel buffers directly. */
+  typedef typename mpl::And< mpl::IsSame< InputImageType, Image< InputPixelType, itkGetStaticConstMacro(ImageDimension) > >,
+                             mpl::IsSame< OutputImageType, Image< OutputPixelType, itkGetStaticConstMacro(ImageDimension) > > >::Type
+    LineConvolutionSupportType;
+
+  /** Filter the first filterDimensionality dimensions of the input. */
+  void GenerateDataWithLineConvolution(const InputImageType *input, unsigned int filterDimensionality, mpl::TrueType);
+  void GenerateDataWithLineConvolution(const InputImageType *input, unsigned int filterDimensionality, mpl::FalseType);
+
   /** The variance of the gaussian blurring kernel in each dimensional
     direction. */
   ArrayType m_Variance;
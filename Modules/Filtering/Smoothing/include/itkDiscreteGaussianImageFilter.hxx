@@ -24,6 +24,8 @@
 #include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
 #include "itkStreamingImageFilter.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkDiscreteGaussianImageFilterThreader.h"
 
 namespace itk
 {
@@ -152,11 +154,122 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     return;
     }
 
-  // Type of the pixel to use for intermediate results
-  typedef typename NumericTraits< OutputPixelType >::RealType RealOutputPixelType;
-  typedef Image< OutputPixelType, ImageDimension >            RealOutputImageType;
+  this->GenerateDataWithLineConvolution( localInput, filterDimensionality, LineConvolutionSupportType() );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::GenerateDataWithLineConvolution(const InputImageType *input, unsigned int filterDimensionality, mpl::TrueType)
+{
+  typename TOutputImage::Pointer output = this->GetOutput();
+
+  typedef DiscreteGaussianImageFilterThreader< Self > ThreaderType;
+  typedef typename ThreaderType::KernelType           KernelType;
+  typedef typename OutputImageType::RegionType        RegionType;
+
+  // Build the kernels
+  std::vector< KernelType > kernels( filterDimensionality );
+  typename RegionType::SizeType radius;
+  radius.Fill( 0 );
+  for ( unsigned int i = 0; i < filterDimensionality; ++i )
+    {
+    GaussianOperator< RealOutputPixelValueType, ImageDimension > oper;
+    oper.SetDirection(i);
+    if ( m_UseImageSpacing == true )
+      {
+      if ( input->GetSpacing()[i] == 0.0 )
+        {
+        itkExceptionMacro(<< "Pixel spacing cannot be zero");
+        }
+      else
+        {
+        // convert the variance from physical units to pixels
+        double s = input->GetSpacing()[i];
+        s = s * s;
+        oper.SetVariance(m_Variance[i] / s);
+        }
+      }
+    else
+      {
+      oper.SetVariance(m_Variance[i]);
+      }
+    oper.SetMaximumKernelWidth(m_MaximumKernelWidth);
+    oper.SetMaximumError(m_MaximumError[i]);
+    oper.CreateDirectional();
+
+    kernels[i].assign( oper.Begin(), oper.End() );
+    radius[i] = oper.GetRadius(i);
+    }
+
+  typename ThreaderType::Pointer threader = ThreaderType::New();
+  threader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+
+  // The internal images are allocated for the first piece and their buffers
+  // are reused by the following ones. The passes between the first and the
+  // last one alternate between them, since a pass can not be done in place:
+  // its region may be split by the threads along its direction.
+  typename RealOutputImageType::Pointer realImages[2];
+  realImages[0] = RealOutputImageType::New();
+  realImages[1] = RealOutputImageType::New();
+
+  ImageRegionSplitterSlowDimension::Pointer splitter = ImageRegionSplitterSlowDimension::New();
+  const RegionType    requestedRegion = output->GetRequestedRegion();
+  const unsigned int  numberOfPieces =
+    splitter->GetNumberOfSplits( requestedRegion, this->GetInternalNumberOfStreamDivisions() );
+
+  for ( unsigned int piece = 0; piece < numberOfPieces; ++piece )
+    {
+    RegionType region = requestedRegion;
+    splitter->GetSplit( piece, numberOfPieces, region );
+
+    // Region of the input read by this piece. The zero flux Neumann
+    // boundary condition replicates its edges.
+    RegionType paddedRegion = region;
+    paddedRegion.PadByRadius( radius );
+    paddedRegion.Crop( input->GetBufferedRegion() );
+
+    if ( filterDimensionality > 1 )
+      {
+      realImages[0]->SetRegions( paddedRegion );
+      realImages[0]->Allocate();
+      }
+    if ( filterDimensionality > 2 )
+      {
+      realImages[1]->SetRegions( paddedRegion );
+      realImages[1]->Allocate();
+      }
+
+    // Each pass restricts one more direction to the piece.
+    RegionType passRegion = paddedRegion;
+    for ( unsigned int i = 0; i < filterDimensionality; ++i )
+      {
+      passRegion.SetIndex( i, region.GetIndex(i) );
+      passRegion.SetSize( i, region.GetSize(i) );
+
+      const bool firstPass = ( i == 0 );
+      const bool lastPass = ( i == filterDimensionality - 1 );
+      threader->SetPass( i, kernels[i], paddedRegion,
+                         firstPass ? input : ITK_NULLPTR,
+                         firstPass ? ITK_NULLPTR : realImages[( i + 1 ) % 2].GetPointer(),
+                         realImages[i % 2],
+                         lastPass ? output.GetPointer() : ITK_NULLPTR );
+      threader->Execute( this, passRegion );
+      }
+
+    this->UpdateProgress( static_cast< float >( piece + 1 ) / numberOfPieces );
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::GenerateDataWithLineConvolution(const InputImageType *input, unsigned int filterDimensionality, mpl::FalseType)
+{
+  typename TOutputImage::Pointer output = this->GetOutput();
 
-  typedef typename NumericTraits<RealOutputPixelType>::ValueType RealOutputPixelValueType;
+  // Type of the image to use for intermediate results
+  typedef Image< OutputPixelType, ImageDimension > IntermediateImageType;
 
   // Type definition for the internal neighborhood filter
   //
@@ -167,10 +280,10 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
 
 
   typedef NeighborhoodOperatorImageFilter< InputImageType,
-                                           RealOutputImageType, RealOutputPixelValueType > FirstFilterType;
-  typedef NeighborhoodOperatorImageFilter< RealOutputImageType,
-                                           RealOutputImageType, RealOutputPixelValueType > IntermediateFilterType;
-  typedef NeighborhoodOperatorImageFilter< RealOutputImageType,
+                                           IntermediateImageType, RealOutputPixelValueType > FirstFilterType;
+  typedef NeighborhoodOperatorImageFilter< IntermediateImageType,
+                                           IntermediateImageType, RealOutputPixelValueType > IntermediateFilterType;
+  typedef NeighborhoodOperatorImageFilter< IntermediateImageType,
                                            OutputImageType, RealOutputPixelValueType > LastFilterType;
   typedef NeighborhoodOperatorImageFilter< InputImageType,
                                            OutputImageType, RealOutputPixelValueType > SingleFilterType;
@@ -206,14 +319,14 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     oper[reverse_i].SetDirection(i);
     if ( m_UseImageSpacing == true )
       {
-      if ( localInput->GetSpacing()[i] == 0.0 )
+      if ( input->GetSpacing()[i] == 0.0 )
         {
         itkExceptionMacro(<< "Pixel spacing cannot be zero");
         }
       else
         {
         // convert the variance from physical units to pixels
-        double s = localInput->GetSpacing()[i];
+        double s = input->GetSpacing()[i];
         s = s * s;
         oper[reverse_i].SetVariance(m_Variance[i] / s);
         }
@@ -237,7 +350,7 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     // Use just a single filter
     SingleFilterPointer singleFilter = SingleFilterType::New();
     singleFilter->SetOperator(oper[0]);
-    singleFilter->SetInput(localInput);
+    singleFilter->SetInput(input);
     progress->RegisterInternalFilter(singleFilter, 1.0f / m_FilterDimensionality);
 
     // Graft this filters output onto the mini-pipeline so the mini-pipeline
@@ -263,7 +376,7 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     FirstFilterPointer firstFilter = FirstFilterType::New();
     firstFilter->SetOperator(oper[0]);
     firstFilter->ReleaseDataFlagOn();
-    firstFilter->SetInput(localInput);
+    firstFilter->SetInput(input);
     progress->RegisterInternalFilter(firstFilter, 1.0f / numberOfStages);
 
     // Middle filters convolves from real to real
@@ -0,0 +1,106 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDiscreteGaussianImageFilterThreader_h
+#define itkDiscreteGaussianImageFilterThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedImageRegionPartitioner.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class DiscreteGaussianImageFilterThreader
+ * \brief Convolves the lines of an image along one direction for
+ * DiscreteGaussianImageFilter.
+ *
+ * Each execution is one pass of the separable convolution. The domain is
+ * the region written by the pass. The pass reads either the filter input
+ * or an internal real valued image, and writes either another internal
+ * image or the filter output. A pass never works in place: the region may
+ * be split along the direction of the pass, and a thread would then read
+ * samples already overwritten by another one.
+ *
+ * \ingroup ITKSmoothing
+ */
+template< typename TDiscreteGaussianImageFilter >
+class DiscreteGaussianImageFilterThreader
+  : public DomainThreader< ThreadedImageRegionPartitioner< TDiscreteGaussianImageFilter::ImageDimension >,
+                           TDiscreteGaussianImageFilter >
+{
+public:
+  /** Standard class typedefs. */
+  typedef DiscreteGaussianImageFilterThreader                                  Self;
+  typedef DomainThreader< ThreadedImageRegionPartitioner< TDiscreteGaussianImageFilter::ImageDimension >,
+                          TDiscreteGaussianImageFilter >                       Superclass;
+  typedef SmartPointer< Self >                                                 Pointer;
+  typedef SmartPointer< const Self >                                           ConstPointer;
+
+  itkTypeMacro( DiscreteGaussianImageFilterThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef typename TDiscreteGaussianImageFilter::InputImageType           InputImageType;
+  typedef typename TDiscreteGaussianImageFilter::OutputImageType          OutputImageType;
+  typedef typename TDiscreteGaussianImageFilter::RealOutputImageType      RealOutputImageType;
+  typedef typename TDiscreteGaussianImageFilter::RealOutputPixelValueType KernelValueType;
+  typedef std::vector< KernelValueType >                                  KernelType;
+
+  /** Set up the next pass. A null \c input reads \c realInput, and a null
+   * \c output writes \c realOutput, which must not be \c realInput.
+   * Samples outside of \c boundaryRegion are replaced by the nearest
+   * sample inside it. */
+  void SetPass( unsigned int direction, const KernelType & kernel, const DomainType & boundaryRegion,
+                const InputImageType *input, const RealOutputImageType *realInput,
+                RealOutputImageType *realOutput, OutputImageType *output );
+
+protected:
+  DiscreteGaussianImageFilterThreader();
+  virtual ~DiscreteGaussianImageFilterThreader() {}
+
+  /** Convolve the lines of \c subdomain. */
+  virtual void ThreadedExecution( const DomainType & subdomain,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+  DiscreteGaussianImageFilterThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  template< typename TSourceImage, typename TDestinationImage >
+  void ConvolveLines( const TSourceImage *source, TDestinationImage *destination, const DomainType & region ) const;
+
+  unsigned int          m_Direction;
+  KernelType            m_Kernel;
+  DomainType            m_BoundaryRegion;
+  const InputImageType      *m_Input;
+  const RealOutputImageType *m_RealInput;
+  RealOutputImageType       *m_RealOutput;
+  OutputImageType           *m_Output;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkDiscreteGaussianImageFilterThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,101 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDiscreteGaussianImageFilterThreader_hxx
+#define itkDiscreteGaussianImageFilterThreader_hxx
+
+#include "itkDiscreteGaussianImageFilterThreader.h"
+#include "itkLineConvolution.h"
+
+namespace itk
+{
+
+template< typename TDiscreteGaussianImageFilter >
+DiscreteGaussianImageFilterThreader< TDiscreteGaussianImageFilter >
+::DiscreteGaussianImageFilterThreader() :
+  m_Direction( 0 ),
+  m_Input( ITK_NULLPTR ),
+  m_RealInput( ITK_NULLPTR ),
+  m_RealOutput( ITK_NULLPTR ),
+  m_Output( ITK_NULLPTR )
+{
+}
+
+template< typename TDiscreteGaussianImageFilter >
+void
+DiscreteGaussianImageFilterThreader< TDiscreteGaussianImageFilter >
+::SetPass( unsigned int direction, const KernelType & kernel, const DomainType & boundaryRegion,
+           const InputImageType *input, const RealOutputImageType *realInput,
+           RealOutputImageType *realOutput, OutputImageType *output )
+{
+  if ( !input && !output && realInput == realOutput )
+    {
+    itkExceptionMacro( << "A pass can not convolve the internal image in place" );
+    }
+  this->m_Direction = direction;
+  this->m_Kernel = kernel;
+  this->m_BoundaryRegion = boundaryRegion;
+  this->m_Input = input;
+  this->m_RealInput = realInput;
+  this->m_RealOutput = realOutput;
+  this->m_Output = output;
+}
+
+template< typename TDiscreteGaussianImageFilter >
+void
+DiscreteGaussianImageFilterThreader< TDiscreteGaussianImageFilter >
+::ThreadedExecution( const DomainType & subdomain, const ThreadIdType itkNotUsed( threadId ) )
+{
+  if ( this->m_Input )
+    {
+    if ( this->m_Output )
+      {
+      this->ConvolveLines( this->m_Input, this->m_Output, subdomain );
+      }
+    else
+      {
+      this->ConvolveLines( this->m_Input, this->m_RealOutput, subdomain );
+      }
+    }
+  else
+    {
+    if ( this->m_Output )
+      {
+      this->ConvolveLines( this->m_RealInput, this->m_Output, subdomain );
+      }
+    else
+      {
+      this->ConvolveLines( this->m_RealInput, this->m_RealOutput, subdomain );
+      }
+    }
+}
+
+template< typename TDiscreteGaussianImageFilter >
+template< typename TSourceImage, typename TDestinationImage >
+void
+DiscreteGaussianImageFilterThreader< TDiscreteGaussianImageFilter >
+::ConvolveLines( const TSourceImage *source, TDestinationImage *destination, const DomainType & region ) const
+{
+  LineConvolution< TSourceImage, TDestinationImage, KernelValueType > lineConvolution;
+  lineConvolution.SetKernel( this->m_Direction, this->m_Kernel );
+  lineConvolution.SetBoundaryRegion( this->m_BoundaryRegion );
+  lineConvolution.Convolve( source, destination, region );
+}
+
+} // end namespace itk
+
+#endif
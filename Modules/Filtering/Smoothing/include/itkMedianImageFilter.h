@@ -20,6 +20,9 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include "itkMetaProgrammingLibrary.h"
+
+#include <limits>
 
 namespace itk
 {
@@ -35,6 +38,15 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * The algorithm is chosen from the pixel type and the radius. Neighborhoods
+ * of nine pixels (a radius of 1 in 2D) use a fixed median selection network.
+ * Larger neighborhoods of 8 and 16 bit integer images use a sliding window
+ * histogram (T. S. Huang, G. J. Yang and G. Y. Tang, "A fast two-dimensional
+ * median filtering algorithm", IEEE TASSP, 1979): the window slides along
+ * the dimension of largest radius, so each step only adds and removes one
+ * slab of the neighborhood. Otherwise, the neighborhood is copied and the
+ * median is selected with std::nth_element. All of them give the same result.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -115,6 +127,27 @@ protected:
 private:
   MedianImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  /** The sliding window histogram is only used for integer pixel types
+   * small enough for a dense histogram. */
+  typedef typename mpl::AndC< std::numeric_limits< InputPixelType >::is_integer,
+                              ( sizeof( InputPixelType ) <= 2 ) >::Type HistogramSupportType;
+
+  /** Compute the median by copying each neighborhood and selecting the
+   * middle element. */
+  void ThreadedGenerateDataWithSelection(const OutputImageRegionType & outputRegionForThread,
+                                         ThreadIdType threadId);
+
+  /** Compute the median with a sliding window histogram. The overload
+   * for pixel types without histogram support uses selection. */
+  void ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                         ThreadIdType threadId, mpl::TrueType);
+  void ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                         ThreadIdType threadId, mpl::FalseType);
+
+  /** Median of nine values with a 19 exchange selection network. The
+   * values are reordered. */
+  static InputPixelType MedianOfNine(InputPixelType *values);
 };
 } // end namespace itk
 
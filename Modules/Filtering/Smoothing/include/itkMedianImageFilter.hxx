@@ -22,6 +22,7 @@
 #include "itkConstNeighborhoodIterator.h"
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkOffset.h"
 #include "itkProgressReporter.h"
@@ -41,6 +42,29 @@ void
 MedianImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
+{
+  SizeValueType neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    neighborhoodSize *= 2 * this->GetRadius()[d] + 1;
+    }
+
+  // Neighborhoods of up to nine pixels are faster to select directly.
+  if ( neighborhoodSize > 9 )
+    {
+    this->ThreadedGenerateDataWithHistogram( outputRegionForThread, threadId, HistogramSupportType() );
+    }
+  else
+    {
+    this->ThreadedGenerateDataWithSelection( outputRegionForThread, threadId );
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataWithSelection(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId)
 {
   // Allocate output
   typename OutputImageType::Pointer output = this->GetOutput();
@@ -84,9 +108,16 @@ MedianImageFilter< TInputImage, TOutputImage >
         }
 
       // get the median value
-      const typename std::vector< InputPixelType >::iterator medianIterator = pixels.begin() + medianPosition;
-      std::nth_element( pixels.begin(), medianIterator, pixels.end() );
-      it.Set( static_cast< typename OutputImageType::PixelType >( *medianIterator ) );
+      if ( neighborhoodSize == 9 )
+        {
+        it.Set( static_cast< typename OutputImageType::PixelType >( Self::MedianOfNine( &( pixels[0] ) ) ) );
+        }
+      else
+        {
+        const typename std::vector< InputPixelType >::iterator medianIterator = pixels.begin() + medianPosition;
+        std::nth_element( pixels.begin(), medianIterator, pixels.end() );
+        it.Set( static_cast< typename OutputImageType::PixelType >( *medianIterator ) );
+        }
 
       ++bit;
       ++it;
@@ -94,6 +125,234 @@ MedianImageFilter< TInputImage, TOutputImage >
       }
     }
 }
+template< typename TInputImage, typename TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId, mpl::FalseType)
+{
+  this->ThreadedGenerateDataWithSelection( outputRegionForThread, threadId );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId, mpl::TrueType)
+{
+  typename OutputImageType::Pointer output = this->GetOutput();
+  typename  InputImageType::ConstPointer input  = this->GetInput();
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  const InputSizeType & radius = this->GetRadius();
+
+  // Slide the window along the dimension of largest radius, so each step
+  // adds and removes the smallest slab of the neighborhood.
+  unsigned int slideDimension = 0;
+  for ( unsigned int d = 1; d < InputImageDimension; ++d )
+    {
+    if ( radius[d] > radius[slideDimension] )
+      {
+      slideDimension = d;
+      }
+    }
+  const OffsetValueType slideRadius = static_cast< OffsetValueType >( radius[slideDimension] );
+
+  // The zero flux Neumann boundary condition clamps the neighbors to the
+  // buffered region of the input, as in the selection path.
+  const InputImageRegionType bufferedRegion = input->GetBufferedRegion();
+  const typename InputImageType::IndexType bufferedStart = bufferedRegion.GetIndex();
+  const typename InputImageType::IndexType bufferedEnd = bufferedRegion.GetUpperIndex();
+  const OffsetValueType *offsetTable = input->GetOffsetTable();
+  const InputPixelType *inputBuffer = input->GetBufferPointer();
+
+  // Shifts of the neighbors in the slab orthogonal to the sliding dimension.
+  SizeValueType slabSize = 1;
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    if ( d != slideDimension )
+      {
+      slabSize *= 2 * radius[d] + 1;
+      }
+    }
+  std::vector< typename InputImageType::OffsetType > slabShifts( slabSize );
+  typename InputImageType::OffsetType shift;
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    shift[d] = ( d == slideDimension ) ? 0 : -static_cast< OffsetValueType >( radius[d] );
+    }
+  for ( SizeValueType s = 0; s < slabSize; ++s )
+    {
+    slabShifts[s] = shift;
+    for ( unsigned int d = 0; d < InputImageDimension; ++d )
+      {
+      if ( d == slideDimension )
+        {
+        continue;
+        }
+      if ( ++shift[d] <= static_cast< OffsetValueType >( radius[d] ) )
+        {
+        break;
+        }
+      shift[d] = -static_cast< OffsetValueType >( radius[d] );
+      }
+    }
+  const SizeValueType neighborhoodSize = slabSize * ( 2 * slideRadius + 1 );
+  const SizeValueType medianPosition = neighborhoodSize / 2;
+
+  // Dense histogram over the full range of the pixel type.
+  typedef long BinValueType;
+  const BinValueType minimumValue = static_cast< BinValueType >( NumericTraits< InputPixelType >::NonpositiveMin() );
+  const BinValueType maximumValue = static_cast< BinValueType >( NumericTraits< InputPixelType >::max() );
+  std::vector< SizeValueType > histogram( static_cast< SizeValueType >( maximumValue - minimumValue ) + 1, 0 );
+
+  std::vector< OffsetValueType > slabOffsets( slabSize );
+  std::vector< InputPixelType >  pixels( neighborhoodSize );
+
+  // Iterate over the line starts of the output region.
+  OutputImageRegionType lineStarts = outputRegionForThread;
+  lineStarts.SetSize( slideDimension, 1 );
+  const IndexValueType lineBegin = outputRegionForThread.GetIndex( slideDimension );
+  const IndexValueType lineEnd = lineBegin + static_cast< IndexValueType >( outputRegionForThread.GetSize( slideDimension ) );
+  const OffsetValueType slideStride = offsetTable[slideDimension];
+
+  ImageRegionConstIteratorWithIndex< OutputImageType > lineIt( output, lineStarts );
+  for ( lineIt.GoToBegin(); !lineIt.IsAtEnd(); ++lineIt )
+    {
+    const typename OutputImageType::IndexType lineIndex = lineIt.GetIndex();
+
+    // Buffer offsets of the slab without the sliding dimension component.
+    for ( SizeValueType s = 0; s < slabSize; ++s )
+      {
+      OffsetValueType offset = 0;
+      for ( unsigned int d = 0; d < InputImageDimension; ++d )
+        {
+        if ( d != slideDimension )
+          {
+          const IndexValueType index = std::min( std::max( lineIndex[d] + slabShifts[s][d], bufferedStart[d] ), bufferedEnd[d] );
+          offset += ( index - bufferedStart[d] ) * offsetTable[d];
+          }
+        }
+      slabOffsets[s] = offset;
+      }
+
+    const IndexValueType slideStart = bufferedStart[slideDimension];
+    const IndexValueType slideEnd = bufferedEnd[slideDimension];
+
+    // Fill the window of the first pixel of the line and select its median.
+    SizeValueType count = 0;
+    for ( OffsetValueType j = -slideRadius; j <= slideRadius; ++j )
+      {
+      const IndexValueType position = std::min( std::max( lineBegin + j, slideStart ), slideEnd );
+      const InputPixelType *slab = inputBuffer + ( position - slideStart ) * slideStride;
+      for ( SizeValueType s = 0; s < slabSize; ++s )
+        {
+        const InputPixelType value = slab[slabOffsets[s]];
+        ++histogram[static_cast< BinValueType >( value ) - minimumValue];
+        pixels[count++] = value;
+        }
+      }
+    std::nth_element( pixels.begin(), pixels.begin() + medianPosition, pixels.end() );
+    BinValueType median = static_cast< BinValueType >( pixels[medianPosition] );
+    SizeValueType belowMedian = 0;
+    for ( SizeValueType i = 0; i < neighborhoodSize; ++i )
+      {
+      if ( static_cast< BinValueType >( pixels[i] ) < median )
+        {
+        ++belowMedian;
+        }
+      }
+
+    typename OutputImageType::IndexType outputIndex = lineIndex;
+    for ( IndexValueType x = lineBegin; x < lineEnd; ++x )
+      {
+      if ( x > lineBegin )
+        {
+        // Slide the window by one pixel.
+        const IndexValueType removed = std::min( std::max( x - slideRadius - 1, slideStart ), slideEnd );
+        const IndexValueType added = std::min( std::max( x + slideRadius, slideStart ), slideEnd );
+        if ( removed != added )
+          {
+          const InputPixelType *removedSlab = inputBuffer + ( removed - slideStart ) * slideStride;
+          const InputPixelType *addedSlab = inputBuffer + ( added - slideStart ) * slideStride;
+          for ( SizeValueType s = 0; s < slabSize; ++s )
+            {
+            const BinValueType removedValue = static_cast< BinValueType >( removedSlab[slabOffsets[s]] );
+            --histogram[removedValue - minimumValue];
+            if ( removedValue < median )
+              {
+              --belowMedian;
+              }
+            const BinValueType addedValue = static_cast< BinValueType >( addedSlab[slabOffsets[s]] );
+            ++histogram[addedValue - minimumValue];
+            if ( addedValue < median )
+              {
+              ++belowMedian;
+              }
+            }
+
+          // The median is the smallest value whose cumulative count
+          // exceeds the median position.
+          while ( belowMedian > medianPosition )
+            {
+            --median;
+            belowMedian -= histogram[median - minimumValue];
+            }
+          while ( belowMedian + histogram[median - minimumValue] <= medianPosition )
+            {
+            belowMedian += histogram[median - minimumValue];
+            ++median;
+            }
+          }
+        }
+
+      outputIndex[slideDimension] = x;
+      output->SetPixel( outputIndex, static_cast< OutputPixelType >( static_cast< InputPixelType >( median ) ) );
+      progress.CompletedPixel();
+      }
+
+    // Empty the histogram for the next line.
+    for ( OffsetValueType j = -slideRadius; j <= slideRadius; ++j )
+      {
+      const IndexValueType position = std::min( std::max( lineEnd - 1 + j, slideStart ), slideEnd );
+      const InputPixelType *slab = inputBuffer + ( position - slideStart ) * slideStride;
+      for ( SizeValueType s = 0; s < slabSize; ++s )
+        {
+        --histogram[static_cast< BinValueType >( slab[slabOffsets[s]] ) - minimumValue];
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+typename MedianImageFilter< TInputImage, TOutputImage >::InputPixelType
+MedianImageFilter< TInputImage, TOutputImage >
+::MedianOfNine(InputPixelType *p)
+{
+  // Selection network of "Fast median search: an ANSI C implementation",
+  // N. Devillard, 1998. Each exchange only uses operator<().
+  const unsigned int network[19][2] = {
+    { 1, 2 }, { 4, 5 }, { 7, 8 },
+    { 0, 1 }, { 3, 4 }, { 6, 7 },
+    { 1, 2 }, { 4, 5 }, { 7, 8 },
+    { 0, 3 }, { 5, 8 }, { 4, 7 },
+    { 3, 6 }, { 1, 4 }, { 2, 5 },
+    { 4, 7 }, { 4, 2 }, { 6, 4 },
+    { 4, 2 } };
+
+  for ( unsigned int i = 0; i < 19; ++i )
+    {
+    InputPixelType & a = p[network[i][0]];
+    InputPixelType & b = p[network[i][1]];
+    if ( b < a )
+      {
+      std::swap( a, b );
+      }
+    }
+  return p[4];
+}
+
 } // end namespace itk
 
 #endif
@@ -0,0 +1,196 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+/* Check that DiscreteGaussianImageFilter gives the same output with one
+ * and with several threads. With a size of one along the last dimension,
+ * the threads split the region along the second dimension, which is also
+ * the direction of a pass between the first and the last one. Also check
+ * that the response to an impulse, computed with several threads on such
+ * a volume, is a centered, symmetric and separable kernel of unit sum, with
+ * the requested variance up to the truncation of the kernel. */
+namespace
+{
+
+typedef itk::Image< float, 3 >                                  ImageType;
+typedef itk::DiscreteGaussianImageFilter< ImageType, ImageType > FilterType;
+
+ImageType::Pointer
+MakeImage( const ImageType::SizeType & size )
+{
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 11 );
+
+  itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< float >( generator->GetIntegerVariate( 999 ) ) );
+    }
+  return image;
+}
+
+ImageType::Pointer
+Smooth( const ImageType * image, itk::ThreadIdType numberOfThreads )
+{
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetVariance( 16.0 );
+  filter->SetMaximumKernelWidth( 64 );
+  filter->SetNumberOfThreads( numberOfThreads );
+  filter->Update();
+  return filter->GetOutput();
+}
+
+int
+CompareThreads( const ImageType::SizeType & size )
+{
+  ImageType::Pointer image = MakeImage( size );
+  ImageType::Pointer reference = Smooth( image, 1 );
+
+  int status = EXIT_SUCCESS;
+  for ( itk::ThreadIdType threads = 2; threads <= 8; ++threads )
+    {
+    ImageType::Pointer output = Smooth( image, threads );
+
+    itk::ImageRegionConstIterator< ImageType > it( output, output->GetLargestPossibleRegion() );
+    itk::ImageRegionConstIterator< ImageType > rit( reference, reference->GetLargestPossibleRegion() );
+    unsigned int mismatches = 0;
+    for ( ; !it.IsAtEnd(); ++it, ++rit )
+      {
+      if ( it.Get() != rit.Get() )
+        {
+        ++mismatches;
+        }
+      }
+    if ( mismatches != 0 )
+      {
+      std::cerr << "Size " << size << " with " << threads << " threads: " << mismatches
+                << " pixels differ from the single threaded output" << std::endl;
+      status = EXIT_FAILURE;
+      }
+    }
+  return status;
+}
+
+int
+CheckImpulseResponse( const ImageType::SizeType & size )
+{
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  image->FillBuffer( 0.0f );
+  ImageType::IndexType center;
+  for ( unsigned int d = 0; d < 3; ++d )
+    {
+    center[d] = size[d] / 2;
+    }
+  image->SetPixel( center, 1.0f );
+
+  ImageType::Pointer response = Smooth( image, 4 );
+
+  // the sum, the moments, the asymmetry and the marginals along the first
+  // two dimensions
+  double                sum = 0.0;
+  double                mean[2] = { 0.0, 0.0 };
+  double                variance[2] = { 0.0, 0.0 };
+  double                asymmetry = 0.0;
+  std::vector< double > marginals[2];
+  marginals[0].assign( size[0], 0.0 );
+  marginals[1].assign( size[1], 0.0 );
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( response, response->GetLargestPossibleRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const double         value = it.Get();
+    ImageType::IndexType opposite = center;
+    sum += value;
+    for ( unsigned int d = 0; d < 2; ++d )
+      {
+      const double x = it.GetIndex()[d] - center[d];
+      mean[d] += value * x;
+      variance[d] += value * x * x;
+      marginals[d][it.GetIndex()[d]] += value;
+      opposite[d] = 2 * center[d] - it.GetIndex()[d];
+      }
+    if ( response->GetLargestPossibleRegion().IsInside( opposite ) )
+      {
+      asymmetry = std::max( asymmetry, std::abs( value - response->GetPixel( opposite ) ) );
+      }
+    }
+
+  double separability = 0.0;
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const double product = marginals[0][it.GetIndex()[0]] * marginals[1][it.GetIndex()[1]] / sum;
+    separability = std::max( separability, std::abs( it.Get() - product ) );
+    }
+
+  std::cout << "Impulse response: sum " << sum << ", variances " << variance[0] << " and " << variance[1] << std::endl;
+  if ( std::abs( sum - 1.0 ) > 1e-5 || std::abs( mean[0] ) > 1e-5 || std::abs( mean[1] ) > 1e-5
+       || asymmetry > 1e-7 || separability > 1e-7
+       || variance[0] > 16.0 || variance[0] < 14.4 || variance[1] > 16.0 || variance[1] < 14.4 )
+    {
+    std::cerr << "Size " << size << ": wrong impulse response, sum " << sum << ", mean " << mean[0] << " "
+              << mean[1] << ", variance " << variance[0] << " " << variance[1] << ", asymmetry " << asymmetry
+              << ", separability error " << separability << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
+} // end anonymous namespace
+
+int itkDiscreteGaussianImageFilterThreadsTest( int, char *[] )
+{
+  int status = EXIT_SUCCESS;
+
+  ImageType::SizeType flatSize;
+  flatSize[0] = 67;
+  flatSize[1] = 45;
+  flatSize[2] = 1;
+  if ( CompareThreads( flatSize ) != EXIT_SUCCESS || CheckImpulseResponse( flatSize ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  ImageType::SizeType size;
+  size[0] = 23;
+  size[1] = 19;
+  size[2] = 17;
+  if ( CompareThreads( size ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test finished." << std::endl;
+    }
+  else
+    {
+    std::cerr << "Test failed!" << std::endl;
+    }
+  return status;
+}
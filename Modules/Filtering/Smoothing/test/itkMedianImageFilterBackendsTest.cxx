@@ -0,0 +1,150 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMedianImageFilter.h"
+#include "itkRandomImageSource.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkNeighborhoodIterator.h"
+#include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+// Compares the output of the median filter with a brute force median
+// computed over the zero flux Neumann neighborhood of each pixel.
+template< typename TImage >
+int
+MedianImageFilterBackendsTestCompare( const TImage * input,
+                                      const typename TImage::SizeType & radius,
+                                      unsigned int numberOfThreads )
+{
+  typedef itk::MedianImageFilter< TImage, TImage > FilterType;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( input );
+  filter->SetRadius( radius );
+  filter->SetNumberOfThreads( numberOfThreads );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  typedef itk::ZeroFluxNeumannBoundaryCondition< TImage > BoundaryConditionType;
+  typedef itk::ConstNeighborhoodIterator< TImage, BoundaryConditionType > NeighborhoodIteratorType;
+  NeighborhoodIteratorType nit( radius, input, input->GetBufferedRegion() );
+
+  itk::ImageRegionConstIteratorWithIndex< TImage > it( filter->GetOutput(), filter->GetOutput()->GetBufferedRegion() );
+
+  std::vector< typename TImage::PixelType > pixels( nit.Size() );
+  for ( it.GoToBegin(), nit.GoToBegin(); !it.IsAtEnd(); ++it, ++nit )
+    {
+    for ( unsigned int i = 0; i < nit.Size(); ++i )
+      {
+      pixels[i] = nit.GetPixel( i );
+      }
+    std::nth_element( pixels.begin(), pixels.begin() + pixels.size() / 2, pixels.end() );
+    if ( it.Get() != pixels[pixels.size() / 2] )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error at index " << it.GetIndex() << " with radius " << radius
+                << " and " << numberOfThreads << " threads" << std::endl;
+      std::cerr << "Expected value " << pixels[pixels.size() / 2] << std::endl;
+      std::cerr << " differs from " << it.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+template< typename TPixel, unsigned int VDimension >
+int
+MedianImageFilterBackendsTestRun( double minimum, double maximum )
+{
+  typedef itk::Image< TPixel, VDimension > ImageType;
+
+  typename ImageType::SizeType size;
+  size.Fill( 11 );
+  size[0] = 17;
+
+  typedef itk::RandomImageSource< ImageType > SourceType;
+  typename SourceType::Pointer source = SourceType::New();
+  source->SetSize( size );
+  source->SetMin( static_cast< TPixel >( minimum ) );
+  source->SetMax( static_cast< TPixel >( maximum ) );
+  source->Update();
+
+  // Radii covering the nine pixel selection network, the sliding
+  // histogram along each dimension, and windows larger than the image.
+  const unsigned int radii[][3] = {
+    { 1, 1, 0 }, { 1, 0, 1 }, { 2, 1, 1 }, { 1, 3, 2 }, { 0, 2, 0 }, { 4, 1, 6 }, { 12, 2, 1 } };
+
+  int status = EXIT_SUCCESS;
+  for ( unsigned int r = 0; r < sizeof( radii ) / sizeof( radii[0] ); ++r )
+    {
+    typename ImageType::SizeType radius;
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      radius[d] = radii[r][d];
+      }
+    for ( unsigned int threads = 1; threads <= 3; threads += 2 )
+      {
+      if ( MedianImageFilterBackendsTestCompare( source->GetOutput(), radius, threads ) != EXIT_SUCCESS )
+        {
+        status = EXIT_FAILURE;
+        }
+      }
+    }
+  return status;
+}
+
+}
+
+int itkMedianImageFilterBackendsTest( int, char* [] )
+{
+  int status = EXIT_SUCCESS;
+
+  // Sliding histogram
+  if ( MedianImageFilterBackendsTestRun< unsigned char, 2 >( 0, 255 ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+  if ( MedianImageFilterBackendsTestRun< signed char, 3 >( -128, 127 ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+  if ( MedianImageFilterBackendsTestRun< short, 3 >( -3000, 3000 ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+  if ( MedianImageFilterBackendsTestRun< unsigned short, 2 >( 0, 65535 ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  // Selection
+  if ( MedianImageFilterBackendsTestRun< int, 2 >( -100000, 100000 ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+  if ( MedianImageFilterBackendsTestRun< float, 3 >( -1.0, 1.0 ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  return status;
+}
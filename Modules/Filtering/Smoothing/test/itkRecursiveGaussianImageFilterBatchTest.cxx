@@ -0,0 +1,150 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRecursiveGaussianImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Scalar images are filtered BatchSize lines at a time, while images of
+ * vectors are filtered one line at a time. Filter the same data as
+ * scalars and as vectors of one component, and compare.
+ */
+namespace
+{
+
+typedef itk::Image< float, 3 >                      ScalarImageType;
+typedef itk::Image< itk::Vector< float, 1 >, 3 >    VectorImageType;
+
+typedef itk::RecursiveGaussianImageFilter< ScalarImageType > ScalarFilterType;
+typedef itk::RecursiveGaussianImageFilter< VectorImageType > VectorFilterType;
+
+bool
+CompareBatchedAndLineByLine( const ScalarImageType * scalarImage, const VectorImageType * vectorImage,
+                             const ScalarImageType::RegionType & requestedRegion, unsigned int direction,
+                             ScalarFilterType::OrderEnumType order, itk::ThreadIdType threads )
+{
+  ScalarFilterType::Pointer scalarFilter = ScalarFilterType::New();
+  scalarFilter->SetInput( scalarImage );
+  scalarFilter->SetDirection( direction );
+  scalarFilter->SetOrder( order );
+  scalarFilter->SetSigma( 1.7 );
+  scalarFilter->SetNumberOfThreads( threads );
+  scalarFilter->GetOutput()->SetRequestedRegion( requestedRegion );
+  scalarFilter->Update();
+
+  VectorFilterType::Pointer vectorFilter = VectorFilterType::New();
+  vectorFilter->SetInput( vectorImage );
+  vectorFilter->SetDirection( direction );
+  vectorFilter->SetOrder( static_cast< VectorFilterType::OrderEnumType >( order ) );
+  vectorFilter->SetSigma( 1.7 );
+  vectorFilter->SetNumberOfThreads( threads );
+  vectorFilter->GetOutput()->SetRequestedRegion( requestedRegion );
+  vectorFilter->Update();
+
+  const ScalarImageType * scalarOutput = scalarFilter->GetOutput();
+  const VectorImageType * vectorOutput = vectorFilter->GetOutput();
+  if ( !scalarOutput->GetBufferedRegion().IsInside( requestedRegion ) )
+    {
+    std::cerr << "The requested region was not computed" << std::endl;
+    return false;
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< ScalarImageType > it( scalarOutput, scalarOutput->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const double expected = vectorOutput->GetPixel( it.GetIndex() )[0];
+    if ( std::fabs( it.Get() - expected ) > 1e-5 * ( 1.0 + std::fabs( expected ) ) )
+      {
+      std::cerr << "Direction " << direction << ", order " << order << ", " << threads << " threads: "
+                << "batched value " << it.Get() << " instead of " << expected
+                << " at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+int itkRecursiveGaussianImageFilterBatchTest( int, char* [] )
+{
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  // the numbers of lines are not multiples of the batch size, and the
+  // last dimension has the minimal length of four pixels
+  ScalarImageType::SizeType size = {{ 21, 13, 4 }};
+  ScalarImageType::RegionType region;
+  region.SetSize( size );
+
+  ScalarImageType::Pointer scalarImage = ScalarImageType::New();
+  scalarImage->SetRegions( region );
+  scalarImage->Allocate();
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions( region );
+  vectorImage->Allocate();
+
+  itk::ImageRegionIterator< ScalarImageType > sit( scalarImage, region );
+  itk::ImageRegionIterator< VectorImageType > vit( vectorImage, region );
+  for ( ; !sit.IsAtEnd(); ++sit, ++vit )
+    {
+    const float value = static_cast< float >( generator->GetUniformVariate( -100.0, 100.0 ) );
+    sit.Set( value );
+    VectorImageType::PixelType vector;
+    vector[0] = value;
+    vit.Set( vector );
+    }
+
+  ScalarImageType::RegionType subRegion;
+  subRegion.SetIndex( 0, 3 );
+  subRegion.SetIndex( 1, 2 );
+  subRegion.SetIndex( 2, 1 );
+  subRegion.SetSize( 0, 11 );
+  subRegion.SetSize( 1, 9 );
+  subRegion.SetSize( 2, 2 );
+
+  const ScalarFilterType::OrderEnumType orders[] =
+    { ScalarFilterType::ZeroOrder, ScalarFilterType::FirstOrder, ScalarFilterType::SecondOrder };
+  const itk::ThreadIdType threads[] = { 1, 3 };
+
+  for ( unsigned int direction = 0; direction < 3; ++direction )
+    {
+    for ( unsigned int o = 0; o < 3; ++o )
+      {
+      for ( unsigned int t = 0; t < 2; ++t )
+        {
+        if ( !CompareBatchedAndLineByLine( scalarImage, vectorImage, region, direction, orders[o], threads[t] ) )
+          {
+          return EXIT_FAILURE;
+          }
+        if ( !CompareBatchedAndLineByLine( scalarImage, vectorImage, subRegion, direction, orders[o], threads[t] ) )
+          {
+          std::cerr << "Failed on a sub-region" << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
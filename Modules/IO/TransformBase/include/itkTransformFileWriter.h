@@ -75,6 +75,12 @@ public:
 
   bool GetAppendMode();
 
+  /** Set/Get whether the transform parameters are compressed, when the
+   * file format supports it (HDF5). Default is off. */
+  itkSetMacro(UseCompression, bool);
+  itkGetConstMacro(UseCompression, bool);
+  itkBooleanMacro(UseCompression);
+
   /** Set/Get the input transform to write */
   void SetInput(const Object *transform);
 
@@ -102,6 +108,7 @@ private:
   std::string                       m_FileName;
   ConstTransformListType            m_TransformList;
   bool                              m_AppendMode;
+  bool                              m_UseCompression;
   typename TransformIOType::Pointer m_TransformIO;
 
   TransformFileWriterTemplate(const Self &) ITK_DELETE_FUNCTION;
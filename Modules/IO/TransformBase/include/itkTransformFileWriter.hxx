@@ -31,7 +31,8 @@ template<typename TParametersValueType>
 TransformFileWriterTemplate<TParametersValueType>
 ::TransformFileWriterTemplate() :
   m_FileName(""),
-  m_AppendMode(false)
+  m_AppendMode(false),
+  m_UseCompression(false)
 {
   TransformFactoryBase::RegisterDefaultTransforms();
 }
@@ -169,6 +170,7 @@ void TransformFileWriterTemplate<TParametersValueType>
     }
 
   m_TransformIO->SetAppendMode(this->m_AppendMode);
+  m_TransformIO->SetUseCompression(this->m_UseCompression);
   m_TransformIO->SetFileName(this->m_FileName);
   m_TransformIO->SetTransformList(this->m_TransformList);
   m_TransformIO->Write();
@@ -181,6 +183,7 @@ void TransformFileWriterTemplate<TParametersValueType>
   Superclass::PrintSelf(os, indent);
 
   os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "UseCompression: " << ( m_UseCompression ? "true" : "false" ) << std::endl;
 }
 
 } // namespace itk
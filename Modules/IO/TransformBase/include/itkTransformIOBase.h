@@ -102,6 +102,13 @@ public:
   itkGetConstMacro(AppendMode, bool);
   itkBooleanMacro(AppendMode);
 
+  /** Set/Get whether the writer compresses the transform parameters, when
+   * the file format supports it. Large transforms such as displacement
+   * fields benefit the most. Default is off. */
+  itkSetMacro(UseCompression, bool);
+  itkGetConstMacro(UseCompression, bool);
+  itkBooleanMacro(UseCompression);
+
   /** The transform type has a string representation used when reading
    * and writing transform files.  In the case where a double-precision
    * transform is to be written as float, or vice versa, the transform
@@ -128,6 +135,7 @@ protected:
   TransformListType      m_ReadTransformList;
   ConstTransformListType m_WriteTransformList;
   bool                   m_AppendMode;
+  bool                   m_UseCompression;
 
   /* The following struct returns the string name of computation type */
   /* default implementation */
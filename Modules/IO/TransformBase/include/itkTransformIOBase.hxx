@@ -30,7 +30,8 @@ namespace itk
 template<typename TParametersValueType>
 TransformIOBaseTemplate<TParametersValueType>
 ::TransformIOBaseTemplate() :
-  m_AppendMode(false)
+  m_AppendMode(false),
+  m_UseCompression(false)
 {
 }
 
@@ -111,6 +112,8 @@ Superclass::PrintSelf(os, indent);
 os << indent << "FileName: " << m_FileName << std::endl;
 os << indent << "AppendMode: "
 << ( m_AppendMode ? "true" : "false" ) << std::endl;
+os << indent << "UseCompression: "
+<< ( m_UseCompression ? "true" : "false" ) << std::endl;
 if ( m_ReadTransformList.size() > 0 )
   {
   os << indent << "ReadTransformList: " << std::endl;
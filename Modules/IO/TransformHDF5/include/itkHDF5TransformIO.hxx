@@ -24,6 +24,7 @@
 #include "itkCompositeTransform.h"
 #include "itkCompositeTransformIOHelper.h"
 #include "itkVersion.h"
+#include <algorithm>
 #include <sstream>
 #include "itk_H5Cpp.h"
 
@@ -97,40 +98,43 @@ HDF5TransformIOTemplate<TParametersValueType>
   const hsize_t dim(parameters.Size());
 
   const std::string & NameParametersValueTypeString = Superclass::GetTypeNameString();
-  ParametersValueType *buf = new ParametersValueType[dim];
-  if( ! NameParametersValueTypeString.compare( std::string("double") ))
+  H5::PredType paramType = H5::PredType::NATIVE_DOUBLE;
+  if( ! NameParametersValueTypeString.compare(std::string("float") ) )
     {
-    for(unsigned i(0); i < dim; i++)
-      {
-      buf[i] = parameters[i];
-      }
-    H5::DataSpace paramSpace(1,&dim);
-    H5::DataSet paramSet = this->m_H5File->createDataSet(name,
-                                                         H5::PredType::NATIVE_DOUBLE,
-                                                         paramSpace);
-    paramSet.write(buf,H5::PredType::NATIVE_DOUBLE);
-    paramSet.close();
-    }
-  else if( ! NameParametersValueTypeString.compare(std::string("float") ) )
-    {
-    for(unsigned i(0); i < dim; i++)
-      {
-      buf[i] = parameters[i];
-      }
-    H5::DataSpace paramSpace(1,&dim);
-    H5::DataSet paramSet = this->m_H5File->createDataSet(name,
-                                                         H5::PredType::NATIVE_FLOAT,
-                                                         paramSpace);
-    paramSet.write(buf,H5::PredType::NATIVE_FLOAT);
-    paramSet.close();
+    paramType = H5::PredType::NATIVE_FLOAT;
     }
-  else
+  else if( NameParametersValueTypeString.compare( std::string("double") ) )
     {
     itkExceptionMacro(<< "Wrong data precision type "
                       << NameParametersValueTypeString
                       << "for writing in HDF5 File");
     }
-  delete [] buf;
+
+  //
+  // Large parameter arrays, e.g. the ones of displacement field
+  // transforms, are written in deflated chunks on request.
+  H5::DSetCreatPropList plist;
+  if( this->GetUseCompression() && dim > 0 )
+    {
+    const hsize_t maximumChunkSize = 65536;
+    const hsize_t chunkSize = std::min( dim, maximumChunkSize );
+    plist.setChunk( 1, &chunkSize );
+    plist.setDeflate( 5 );
+    }
+
+  H5::DataSpace paramSpace(1,&dim);
+  H5::DataSet paramSet = this->m_H5File->createDataSet(name,
+                                                       paramType,
+                                                       paramSpace,
+                                                       plist);
+  //
+  // The parameters are contiguous and already of the stored type, so
+  // they are written without an intermediate copy.
+  if( dim > 0 )
+    {
+    paramSet.write(parameters.data_block(),paramType);
+    }
+  paramSet.close();
 }
 
 template<typename TParametersValueType>
@@ -179,27 +183,20 @@ HDF5TransformIOTemplate<TParametersValueType>
   Space.getSimpleExtentDims(&dim,ITK_NULLPTR);
   ParametersType ParameterArray;
   ParameterArray.SetSize(dim);
-  H5::FloatType ParamType = paramSet.getFloatType();
 
-  if( ParamType.getSize() == sizeof(double) )
+  //
+  // HDF5 converts the stored precision to the one of the parameters, so
+  // they are read in place rather than through a temporary buffer.
+  if( dim > 0 )
     {
-    double *buf = new double[dim];
-    paramSet.read(buf,H5::PredType::NATIVE_DOUBLE);
-    for(unsigned i = 0; i < dim; i++)
+    if( sizeof(ParametersValueType) == sizeof(double) )
       {
-      ParameterArray.SetElement(i,static_cast<ParametersValueType>(buf[i]));
+      paramSet.read(ParameterArray.data_block(),H5::PredType::NATIVE_DOUBLE);
       }
-    delete[] buf;
-    }
-  else
-    {
-    float *buf = new float[dim];
-    paramSet.read(buf,H5::PredType::NATIVE_FLOAT);
-    for(unsigned i = 0; i < dim; i++)
+    else
       {
-      ParameterArray.SetElement(i,static_cast<ParametersValueType>(buf[i]));
+      paramSet.read(ParameterArray.data_block(),H5::PredType::NATIVE_FLOAT);
       }
-    delete[] buf;
     }
   paramSet.close();
   return ParameterArray;
@@ -391,7 +388,7 @@ HDF5TransformIOTemplate<TParametersValueType>
     fixedParamsName += transformFixedName;
     this->WriteFixedParameters(fixedParamsName,FixedtmpArray);
     // parameters
-    ParametersType tmpArray = curTransform->GetParameters();
+    const ParametersType & tmpArray = curTransform->GetParameters();
     std::string paramsName(transformName);
     paramsName += transformParamsName;
     this->WriteParameters(paramsName,tmpArray);
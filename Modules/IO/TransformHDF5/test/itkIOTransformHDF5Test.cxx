@@ -34,10 +34,11 @@
 #include "itkDisplacementFieldTransform.h"
 #include "itkGaussianExponentialDiffeomorphicTransform.h"
 #include "itkGaussianSmoothingOnUpdateDisplacementFieldTransform.h"
+#include "itkImageRegionIterator.h"
 #include "itkMath.h"
 
 template<typename TParametersValueType, typename DisplacementTransformType >
-static int ReadWriteTest(const char * const fileName, const bool isRealDisplacementField )
+static int ReadWriteTest(const char * const fileName, const bool isRealDisplacementField, const bool useCompression = false )
 {
   // First make a DisplacementField wiht known values
   const double aNumberThatCanNotBeRepresentedInFloatingPoint = 1e-5 + 1e-7 + 1e-9 +1e-13;
@@ -65,9 +66,16 @@ static int ReadWriteTest(const char * const fileName, const bool isRealDisplacem
     knownField->SetOrigin (origin);
     knownField->Allocate();
 
-    typename DisplacementTransformType::OutputVectorType zeroVector;
-    zeroVector.Fill( 0.0 );
-    knownField->FillBuffer( zeroVector );
+    // Values exactly representable in single precision
+    itk::ImageRegionIterator<FieldType> fieldIt( knownField, region );
+    double value = 0.0;
+    for( fieldIt.GoToBegin(); !fieldIt.IsAtEnd(); ++fieldIt )
+      {
+      typename DisplacementTransformType::OutputVectorType vector;
+      vector.Fill( value );
+      fieldIt.Set( vector );
+      value += 0.25;
+      }
 
     displacementTransform->SetDisplacementField( knownField );
     }
@@ -90,6 +98,7 @@ static int ReadWriteTest(const char * const fileName, const bool isRealDisplacem
   typedef itk::TransformFileWriterTemplate<TParametersValueType> TransformWriterType;
   typename TransformWriterType::Pointer writer = TransformWriterType::New();
   writer->SetFileName( fileName );
+  writer->SetUseCompression( useCompression );
   writer->SetTransformIO( transformIO );
   if( writer->GetTransformIO() != transformIO.GetPointer() )
     {
@@ -171,6 +180,22 @@ static int ReadWriteTest(const char * const fileName, const bool isRealDisplacem
       << requiredOrigin << std::endl;
       return EXIT_FAILURE;
       }
+    const typename DisplacementTransformType::ParametersType & readParameters = readDisplacementTransform->GetParameters();
+    const typename DisplacementTransformType::ParametersType & knownParameters = displacementTransform->GetParameters();
+    if( readParameters.GetSize() != knownParameters.GetSize() )
+      {
+      std::cerr << "Error invalid number of parameters restored from disk" << std::endl;
+      return EXIT_FAILURE;
+      }
+    for( unsigned int i = 0; i < knownParameters.GetSize(); i++ )
+      {
+      if( itk::Math::NotExactlyEquals( readParameters[i], knownParameters[i] ) )
+        {
+        std::cerr << "Error invalid parameter " << i << " restored from disk: "
+                  << readParameters[i] << " != " << knownParameters[i] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
     }
   return EXIT_SUCCESS;
 }
@@ -326,6 +351,8 @@ static int oneTest(const char *const goodname,const char *const badname)
   error_sum += ReadWriteTest< float, itk::DisplacementFieldTransform<float, 3> >(goodname, true);
   error_sum += ReadWriteTest< double, itk::DisplacementFieldTransform<double, 2> >(goodname, true);
   error_sum += ReadWriteTest< double, itk::DisplacementFieldTransform<double, 3> >(goodname, true);
+  error_sum += ReadWriteTest< float, itk::DisplacementFieldTransform<float, 3> >(goodname, true, true);
+  error_sum += ReadWriteTest< double, itk::DisplacementFieldTransform<double, 3> >(goodname, true, true);
 
   error_sum += ReadWriteTest< float, itk::BSplineSmoothingOnUpdateDisplacementFieldTransform<float,2> >(goodname, true);
   error_sum += ReadWriteTest< float, itk::BSplineSmoothingOnUpdateDisplacementFieldTransform<float,3> >(goodname, true);
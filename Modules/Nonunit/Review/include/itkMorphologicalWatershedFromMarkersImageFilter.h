@@ -19,6 +19,12 @@
 #define itkMorphologicalWatershedFromMarkersImageFilter_h
 
 #include "itkImageToImageFilter.h"
+#include "itkBucketQueue.h"
+#include "itkIndexedDAryHeap.h"
+#include "itkMorphologicalWatershedFromMarkersImageFilterThreader.h"
+#include "itkMetaProgrammingLibrary.h"
+
+#include <utility>
 
 namespace itk
 {
@@ -59,6 +65,14 @@ namespace itk
  * the markers. The labels of the output image are the label of the marker
  * image.
  *
+ * The pixels are flooded in the order of a hierarchical queue: a
+ * BucketQueue for the 8 and 16 bit integer images, else an IndexedDAryHeap
+ * which keeps the pixels of a same level in first in, first out order.
+ * With several threads, the neighborhoods of the pixels of a same level are
+ * examined in parallel by a MorphologicalWatershedFromMarkersImageFilterThreader
+ * and committed in the order of the queue, so the output is the same as
+ * with a single thread.
+ *
  * The morphological watershed transform algorithm is described in
  * Chapter 9.2 of Pierre Soille's book "Morphological Image Analysis:
  * Principles and Applications", Second Edition, Springer, 2003.
@@ -172,13 +186,70 @@ protected:
    * \sa ProcessObject::EnlargeOutputRequestedRegion() */
   void EnlargeOutputRequestedRegion( DataObject *itkNotUsed(output) ) ITK_OVERRIDE;
 
-  /** The filter is single threaded. */
+  /** The initialization is single threaded; the flooding is threaded with
+   * several threads. */
   void GenerateData() ITK_OVERRIDE;
 
 private:
   MorphologicalWatershedFromMarkersImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
+  /** Hierarchical queue of the pixels of the images which are not 8 or 16
+   * bit integer images, with the interface of BucketQueue. */
+  class HeapQueue
+  {
+  public:
+    HeapQueue() : m_NumberOfPushes( 0 ) {}
+
+    void SetKeyRange( InputImagePixelType, InputImagePixelType ) {}
+
+    bool Empty() const
+    {
+      return m_Heap.Empty();
+    }
+
+    /** Each pixel must be in the queue at most once. */
+    void Push( InputImagePixelType key, OffsetValueType offset )
+    {
+      m_Heap.Push( static_cast< IdentifierType >( offset ), ElementType( key, m_NumberOfPushes++ ) );
+    }
+
+    OffsetValueType Front() const
+    {
+      return static_cast< OffsetValueType >( m_Heap.TopIdentifier() );
+    }
+
+    InputImagePixelType FrontKey() const
+    {
+      return m_Heap.Top().first;
+    }
+
+    void Pop()
+    {
+      m_Heap.Pop();
+    }
+
+  private:
+    // the number of pushes breaks the ties in first in, first out order
+    typedef std::pair< InputImagePixelType, SizeValueType > ElementType;
+
+    IndexedDAryHeap< ElementType > m_Heap;
+    SizeValueType                  m_NumberOfPushes;
+  };
+
+  /** The queue is indexed by the offsets of the pixels in the output. */
+  typedef typename mpl::If< NumericTraits< InputImagePixelType >::IsInteger && sizeof( InputImagePixelType ) <= 2,
+                            BucketQueue< OffsetValueType, InputImagePixelType >,
+                            HeapQueue >::Type HierarchicalQueueType;
+
+  /** Status of the pixels in the flooding with watershed lines. */
+  typedef Image< unsigned char, ImageDimension > StatusImageType;
+
+  typedef MorphologicalWatershedFromMarkersImageFilterThreader< Self > ThreaderType;
+  friend class MorphologicalWatershedFromMarkersImageFilterThreader< Self >;
+
+  typename ThreaderType::Pointer m_Threader;
+
   bool m_FullyConnected;
 
   bool m_MarkWatershedLine;
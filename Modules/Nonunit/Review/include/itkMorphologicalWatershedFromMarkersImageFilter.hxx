@@ -19,7 +19,6 @@
 #define itkMorphologicalWatershedFromMarkersImageFilter_hxx
 
 #include <algorithm>
-#include <queue>
 #include <list>
 #include "itkMorphologicalWatershedFromMarkersImageFilter.h"
 #include "itkProgressReporter.h"
@@ -48,6 +47,7 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
   this->SetNumberOfRequiredInputs(2);
   m_FullyConnected = false;
   m_MarkWatershedLine = true;
+  m_Threader = ThreaderType::New();
 }
 
 template< typename TInputImage, typename TLabelImage >
@@ -126,9 +126,14 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
     }
 
   // FAH (in french: File d'Attente Hierarchique)
-  typedef std::queue< IndexType >                    QueueType;
-  typedef std::map< InputImagePixelType, QueueType > MapType;
-  MapType fah;
+  HierarchicalQueueType fah;
+  fah.SetKeyRange( NumericTraits< InputImagePixelType >::NonpositiveMin(),
+                   NumericTraits< InputImagePixelType >::max() );
+
+  // the flooding is threaded on the buffers, which must share the offsets
+  // of the pixels
+  const bool useThreader = this->GetNumberOfThreads() > 1
+    && inputImage->GetBufferedRegion() == outputImage->GetBufferedRegion();
 
   // the radius which will be used for all the shaped iterators
   Size< ImageDimension > radius;
@@ -179,7 +184,6 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
 
     // create a temporary image to store the state of each pixel (processed or
     // not)
-    typedef Image< bool, ImageDimension > StatusImageType;
     typename StatusImageType::Pointer statusImage = StatusImageType::New();
     statusImage->SetRegions( markerImage->GetLargestPossibleRegion() );
     statusImage->Allocate();
@@ -233,8 +237,8 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
             {
             // this neighbor is a background pixel and is not already
             // processed; add its index to fah
-            fah[niIt.Get()].push( markerIt.GetIndex()
-                                  + nmIt.GetNeighborhoodOffset() );
+            fah.Push( niIt.Get(), outputImage->ComputeOffset( markerIt.GetIndex()
+                                                              + nmIt.GetNeighborhoodOffset() ) );
             // mark it as already in the fah to avoid adding it several times
             nsIt.Set(true);
             }
@@ -258,24 +262,25 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
     // end of init stage
 
     // flooding
-    // init all the iterators
-    outputIt.GoToBegin();
-    statusIt.GoToBegin();
-    inputIt.GoToBegin();
-
-    // and start flooding
-    while ( !fah.empty() )
+    if ( useThreader )
+      {
+      m_Threader->Run( this, fah, inputImage, outputImage, statusImage, progress );
+      }
+    else
       {
-      // store the current vars
-      InputImagePixelType currentValue = fah.begin()->first;
-      QueueType           currentQueue = fah.begin()->second;
-      // and remove them from the fah
-      fah.erase( fah.begin() );
+      // init all the iterators
+      outputIt.GoToBegin();
+      statusIt.GoToBegin();
+      inputIt.GoToBegin();
 
-      while ( !currentQueue.empty() )
+      // and start flooding
+      while ( !fah.Empty() )
         {
-        IndexType idx = currentQueue.front();
-        currentQueue.pop();
+        // store the current vars
+        InputImagePixelType currentValue = fah.FrontKey();
+        IndexType           idx = outputImage->ComputeIndex( fah.Front() );
+        // and remove them from the fah
+        fah.Pop();
 
         // move the iterators to the right place
         OffsetType shift = idx - outputIt.GetIndex();
@@ -312,18 +317,12 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
             {
             if ( !nsIt.Get() )
               {
-              // the pixel is not yet processed. add it to the fah
+              // the pixel is not yet processed. add it to the fah, at the
+              // current level if it is lower
               InputImagePixelType GrayVal = niIt.Get();
-              if ( GrayVal <= currentValue )
-                {
-                currentQueue.push( inputIt.GetIndex()
-                                   + niIt.GetNeighborhoodOffset() );
-                }
-              else
-                {
-                fah[GrayVal].push( inputIt.GetIndex()
-                                   + niIt.GetNeighborhoodOffset() );
-                }
+              fah.Push( std::max( GrayVal, currentValue ),
+                        outputImage->ComputeOffset( inputIt.GetIndex()
+                                                    + niIt.GetNeighborhoodOffset() ) );
               // mark it as already in the fah
               nsIt.Set(true);
               }
@@ -378,7 +377,7 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
         if ( haveBgNeighbor )
           {
           // there is a background pixel in the neighborhood; add to fah
-          fah[inputIt.GetCenterPixel()].push( markerIt.GetIndex() );
+          fah.Push( inputIt.GetCenterPixel(), outputImage->ComputeOffset( markerIt.GetIndex() ) );
           }
         else
           {
@@ -396,23 +395,24 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
     // end of init stage
 
     // flooding
-    // init all the iterators
-    outputIt.GoToBegin();
-    inputIt.GoToBegin();
-
-    // and start flooding
-    while ( !fah.empty() )
+    if ( useThreader )
+      {
+      m_Threader->Run( this, fah, inputImage, outputImage, ITK_NULLPTR, progress );
+      }
+    else
       {
-      // store the current vars
-      InputImagePixelType currentValue = fah.begin()->first;
-      QueueType           currentQueue = fah.begin()->second;
-      // and remove them from the fah
-      fah.erase( fah.begin() );
+      // init all the iterators
+      outputIt.GoToBegin();
+      inputIt.GoToBegin();
 
-      while ( !currentQueue.empty() )
+      // and start flooding
+      while ( !fah.Empty() )
         {
-        IndexType idx = currentQueue.front();
-        currentQueue.pop();
+        // store the current vars
+        InputImagePixelType currentValue = fah.FrontKey();
+        IndexType           idx = outputImage->ComputeIndex( fah.Front() );
+        // and remove them from the fah
+        fah.Pop();
 
         // move the iterators to the right place
         OffsetType shift = idx - outputIt.GetIndex();
@@ -432,16 +432,9 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
             // current label
             noIt.Set(currentMarker);
             InputImagePixelType GrayVal = niIt.Get();
-            if ( GrayVal <= currentValue )
-              {
-              currentQueue.push( inputIt.GetIndex()
-                                 + noIt.GetNeighborhoodOffset() );
-              }
-            else
-              {
-              fah[GrayVal].push( inputIt.GetIndex()
-                                 + noIt.GetNeighborhoodOffset() );
-              }
+            fah.Push( std::max( GrayVal, currentValue ),
+                      outputImage->ComputeOffset( inputIt.GetIndex()
+                                                  + noIt.GetNeighborhoodOffset() ) );
             progress.CompletedPixel();
             }
           }
@@ -0,0 +1,154 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMorphologicalWatershedFromMarkersImageFilterThreader_h
+#define itkMorphologicalWatershedFromMarkersImageFilterThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+#include "itkProgressReporter.h"
+
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+
+/** \class MorphologicalWatershedFromMarkersImageFilterThreader
+ * \brief Threaded flooding of MorphologicalWatershedFromMarkersImageFilter.
+ *
+ * The pixels are popped from the hierarchical queue in batches of pixels
+ * of the same level. The neighborhoods of the pixels of a batch are
+ * examined in parallel: each pixel gets the label of its labeled
+ * neighbors and the list of the neighbors it would push into the queue.
+ * The batch is then committed in the order of the queue: a neighbor is
+ * pushed by the first pixel which claims it, and with watershed lines,
+ * the pixels next to another pixel of the batch get their label again
+ * from the labels committed before them. The pixels are thus labeled and
+ * pushed exactly as by the sequential flooding, so the output does not
+ * depend on the number of threads.
+ *
+ * \sa MorphologicalWatershedFromMarkersImageFilter
+ * \ingroup ITKReview
+ */
+template< typename TAssociate >
+class MorphologicalWatershedFromMarkersImageFilterThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MorphologicalWatershedFromMarkersImageFilterThreader              Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate > Superclass;
+  typedef SmartPointer< Self >                                              Pointer;
+  typedef SmartPointer< const Self >                                        ConstPointer;
+
+  itkTypeMacro( MorphologicalWatershedFromMarkersImageFilterThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+  typedef DomainType                         IndexRangeType;
+
+  typedef typename TAssociate::InputImageType        InputImageType;
+  typedef typename TAssociate::InputImagePixelType   InputImagePixelType;
+  typedef typename TAssociate::LabelImageType        LabelImageType;
+  typedef typename TAssociate::LabelImagePixelType   LabelImagePixelType;
+  typedef typename TAssociate::StatusImageType       StatusImageType;
+  typedef typename TAssociate::HierarchicalQueueType HierarchicalQueueType;
+  typedef typename TAssociate::IndexType             IndexType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TAssociate::ImageDimension);
+
+  /** Flood \c output from the pixels of \c queue. \c status is the status
+   * image of the flooding with watershed lines, or null without them. */
+  void Run( AssociateType * associate,
+            HierarchicalQueueType & queue,
+            const InputImageType * input,
+            LabelImageType * output,
+            StatusImageType * status,
+            ProgressReporter & progress );
+
+protected:
+  MorphologicalWatershedFromMarkersImageFilterThreader();
+  virtual ~MorphologicalWatershedFromMarkersImageFilterThreader() {}
+
+  /** Allocate the per thread lists of pushes. */
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  /** Examine the neighborhoods of the pixels of a range of the batch. */
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+  MorphologicalWatershedFromMarkersImageFilterThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  /** Status of the pixels in the flooding with watershed lines. */
+  enum { Free = 0, Queued = 1, InBatch = 2 };
+
+  /** Flags of the pixels of the batch. */
+  enum { Collision = 1, NextToBatch = 2 };
+
+  /** The largest number of pixels popped at once from the queue, and the
+   * smallest number of pixels of the batch examined by each thread. */
+  enum { MaximumBatchSize = 1 << 15, MinimumPixelsPerThread = 1 << 10 };
+
+  typedef std::pair< OffsetValueType, InputImagePixelType > PushType;
+  typedef std::vector< PushType >                           PushListType;
+
+  /** Examine the pixels of \c range, with the lists of \c threadId. */
+  void ExamineRange( const IndexRangeType & range, ThreadIdType threadId );
+
+  /** Commit the batch in order. */
+  void CommitBatch( HierarchicalQueueType & queue, ProgressReporter & progress );
+
+  /** Whether the neighbor \c k of the pixel at \c index is in the image. */
+  bool IsInside( const IndexType & index, unsigned int k ) const;
+
+  /** Whether the pixel at \c index has all its neighbors in the image. */
+  bool IsInterior( const IndexType & index ) const;
+
+  /** Get the label of the labeled neighbors of \c offset; return true if
+   * they have different labels. */
+  bool FindMarker( OffsetValueType offset, LabelImagePixelType & marker ) const;
+
+  const InputImagePixelType *    m_Input;
+  LabelImagePixelType *          m_Output;
+  unsigned char *                m_Status;
+  const LabelImageType *         m_OutputImage;
+  IndexType                      m_StartIndex;
+  IndexType                      m_LastIndex;
+  std::vector< IndexType >       m_NeighborIndexOffsets;
+  std::vector< OffsetValueType > m_NeighborOffsets;
+  InputImagePixelType            m_CurrentValue;
+
+  std::vector< OffsetValueType >     m_Batch;
+  std::vector< LabelImagePixelType > m_Markers;
+  std::vector< unsigned char >       m_Flags;
+  std::vector< unsigned char >       m_NumberOfPushes;
+  std::vector< PushListType >        m_Pushes;
+  std::vector< IndexRangeType >      m_Subranges;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMorphologicalWatershedFromMarkersImageFilterThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,376 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMorphologicalWatershedFromMarkersImageFilterThreader_hxx
+#define itkMorphologicalWatershedFromMarkersImageFilterThreader_hxx
+
+#include "itkMorphologicalWatershedFromMarkersImageFilterThreader.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template< typename TAssociate >
+MorphologicalWatershedFromMarkersImageFilterThreader< TAssociate >
+::MorphologicalWatershedFromMarkersImageFilterThreader() :
+  m_Input( ITK_NULLPTR ),
+  m_Output( ITK_NULLPTR ),
+  m_Status( ITK_NULLPTR ),
+  m_OutputImage( ITK_NULLPTR ),
+  m_CurrentValue( NumericTraits< InputImagePixelType >::ZeroValue() )
+{
+}
+
+template< typename TAssociate >
+void
+MorphologicalWatershedFromMarkersImageFilterThreader< TAssociate >
+::Run( AssociateType * associate,
+       HierarchicalQueueType & queue,
+       const InputImageType * input,
+       LabelImageType * output,
+       StatusImageType * status,
+       ProgressReporter & progress )
+{
+  this->m_Associate = associate;
+  m_Input = input->GetBufferPointer();
+  m_Output = output->GetBufferPointer();
+  m_Status = status ? status->GetBufferPointer() : ITK_NULLPTR;
+  m_OutputImage = output;
+
+  const typename LabelImageType::RegionType & region = output->GetBufferedRegion();
+  m_StartIndex = region.GetIndex();
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    m_LastIndex[d] = m_StartIndex[d] + static_cast< IndexValueType >( region.GetSize()[d] ) - 1;
+    }
+
+  // the neighbors in the order of the active list of the shaped iterators
+  // of the sequential flooding, which is the raster order of the 3x3x...
+  // neighborhood
+  m_NeighborIndexOffsets.clear();
+  m_NeighborOffsets.clear();
+  const OffsetValueType *offsetTable = output->GetOffsetTable();
+  SizeValueType neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    neighborhoodSize *= 3;
+    }
+  for ( SizeValueType n = 0; n < neighborhoodSize; ++n )
+    {
+    IndexType       shift;
+    OffsetValueType offset = 0;
+    unsigned int    nonZero = 0;
+    SizeValueType   rest = n;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      shift[d] = static_cast< IndexValueType >( rest % 3 ) - 1;
+      rest /= 3;
+      offset += shift[d] * offsetTable[d];
+      if ( shift[d] != 0 )
+        {
+        ++nonZero;
+        }
+      }
+    if ( nonZero == 0 || ( nonZero > 1 && !associate->m_FullyConnected ) )
+      {
+      continue;
+      }
+    m_NeighborIndexOffsets.push_back( shift );
+    m_NeighborOffsets.push_back( offset );
+    }
+
+  const ThreadIdType numberOfThreads = associate->GetNumberOfThreads();
+  while ( !queue.Empty() )
+    {
+    // pop the pixels of the lowest level
+    m_CurrentValue = queue.FrontKey();
+    m_Batch.clear();
+    while ( !queue.Empty() && queue.FrontKey() == m_CurrentValue
+            && m_Batch.size() < static_cast< SizeValueType >( MaximumBatchSize ) )
+      {
+      m_Batch.push_back( queue.Front() );
+      queue.Pop();
+      }
+
+    const SizeValueType batchSize = m_Batch.size();
+    m_Markers.resize( batchSize );
+    m_Flags.resize( batchSize );
+    m_NumberOfPushes.resize( batchSize );
+    if ( m_Status )
+      {
+      for ( SizeValueType i = 0; i < batchSize; ++i )
+        {
+        m_Status[m_Batch[i]] = InBatch;
+        }
+      }
+
+    IndexRangeType range;
+    range[0] = 0;
+    range[1] = batchSize - 1;
+    const ThreadIdType threads = static_cast< ThreadIdType >(
+      std::min< SizeValueType >( numberOfThreads, batchSize / MinimumPixelsPerThread ) );
+    if ( threads > 1 )
+      {
+      this->SetMaximumNumberOfThreads( threads );
+      this->Execute( associate, range );
+      }
+    else
+      {
+      // a small batch is not worth starting the threads
+      m_Pushes.resize( 1 );
+      m_Pushes[0].clear();
+      m_Subranges.resize( 1 );
+      this->ExamineRange( range, 0 );
+      }
+
+    this->CommitBatch( queue, progress );
+    }
+}
+
+template< typename TAssociate >
+void
+MorphologicalWatershedFromMarkersImageFilterThreader< TAssociate >
+::BeforeThreadedExecution()
+{
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  m_Pushes.resize( numberOfThreads );
+  for ( ThreadIdType i = 0; i < numberOfThreads; ++i )
+    {
+    m_Pushes[i].clear();
+    }
+  m_Subranges.resize( numberOfThreads );
+}
+
+template< typename TAssociate >
+void
+MorphologicalWatershedFromMarkersImageFilterThreader< TAssociate >
+::ThreadedExecution( const IndexRangeType & subrange, const ThreadIdType threadId )
+{
+  this->ExamineRange( subrange, threadId );
+}
+
+template< typename TAssociate >
+bool
+MorphologicalWatershedFromMarkersImageFilterThreader< TAssociate >
+::IsInside( const IndexType & index, unsigned int k ) const
+{
+  const IndexType & shift = m_NeighborIndexOffsets[k];
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const IndexValueType i = index[d] + shift[d];
+    if ( i < m_StartIndex[d] || i > m_LastIndex[d] )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TAssociate >
+bool
+MorphologicalWatershedFromMarkersImageFilterThreader< TAssociate >
+::IsInterior( const IndexType & index ) const
+{
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    if ( index[d] <= m_StartIndex[d] || index[d] >= m_LastIndex[d] )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TAssociate >
+bool
+MorphologicalWatershedFromMarkersImageFilterThreader< TAssociate >
+::FindMarker( OffsetValueType offset, LabelImagePixelType & marker ) const
+{
+  const LabelImagePixelType wsLabel = NumericTraits< LabelImagePixelType >::ZeroValue();
+  const IndexType           index = m_OutputImage->ComputeIndex( offset );
+  const bool                interior = this->IsInterior( index );
+
+  marker = wsLabel;
+  for ( unsigned int k = 0; k < m_NeighborOffsets.size(); ++k )
+    {
+    if ( !interior && !this->IsInside( index, k ) )
+      {
+      continue;
+      }
+    const LabelImagePixelType o = m_Output[offset + m_NeighborOffsets[k]];
+    if ( o != wsLabel )
+      {
+      if ( marker != wsLabel && o != marker )
+        {
+        return true;
+        }
+      marker = o;
+      }
+    }
+  return false;
+}
+
+template< typename TAssociate >
+void
+MorphologicalWatershedFromMarkersImageFilterThreader< TAssociate >
+::ExamineRange( const IndexRangeType & range, ThreadIdType threadId )
+{
+  const LabelImagePixelType wsLabel = NumericTraits< LabelImagePixelType >::ZeroValue();
+  const unsigned int        numberOfNeighbors = static_cast< unsigned int >( m_NeighborOffsets.size() );
+  PushListType &            pushes = m_Pushes[threadId];
+
+  m_Subranges[threadId] = range;
+  for ( IndexValueType i = range[0]; i <= range[1]; ++i )
+    {
+    const OffsetValueType offset = m_Batch[i];
+    const IndexType       index = m_OutputImage->ComputeIndex( offset );
+    const bool            interior = this->IsInterior( index );
+    LabelImagePixelType   marker = wsLabel;
+    unsigned char         flags = 0;
+    unsigned char         numberOfPushes = 0;
+
+    for ( unsigned int k = 0; k < numberOfNeighbors; ++k )
+      {
+      if ( !interior && !this->IsInside( index, k ) )
+        {
+        continue;
+        }
+      const OffsetValueType n = offset + m_NeighborOffsets[k];
+      bool                  push;
+      if ( m_Status )
+        {
+        // the pixels of the batch are not labeled yet: their label is
+        // searched again when the batch is committed
+        const unsigned char s = m_Status[n];
+        if ( s == InBatch )
+          {
+          flags |= NextToBatch;
+          }
+        else if ( !( flags & Collision ) )
+          {
+          const LabelImagePixelType o = m_Output[n];
+          if ( o != wsLabel )
+            {
+            if ( marker != wsLabel && o != marker )
+              {
+              flags |= Collision;
+              }
+            else
+              {
+              marker = o;
+              }
+            }
+          }
+        push = ( s == Free );
+        }
+      else
+        {
+        push = ( m_Output[n] == wsLabel );
+        }
+      if ( push )
+        {
+        pushes.push_back( PushType( n, std::max( m_Input[n], m_CurrentValue ) ) );
+        ++numberOfPushes;
+        }
+      }
+    m_Markers[i] = marker;
+    m_Flags[i] = flags;
+    m_NumberOfPushes[i] = numberOfPushes;
+    }
+}
+
+template< typename TAssociate >
+void
+MorphologicalWatershedFromMarkersImageFilterThreader< TAssociate >
+::CommitBatch( HierarchicalQueueType & queue, ProgressReporter & progress )
+{
+  const LabelImagePixelType wsLabel = NumericTraits< LabelImagePixelType >::ZeroValue();
+
+  // the subranges of the threads, in the order of the batch
+  std::vector< ThreadIdType > threadOrder( m_Subranges.size() );
+  for ( ThreadIdType t = 0; t < threadOrder.size(); ++t )
+    {
+    threadOrder[t] = t;
+    }
+  for ( SizeValueType j = 1; j < threadOrder.size(); ++j )
+    {
+    for ( SizeValueType k = j; k > 0 && m_Subranges[threadOrder[k]][0] < m_Subranges[threadOrder[k - 1]][0]; --k )
+      {
+      std::swap( threadOrder[k], threadOrder[k - 1] );
+      }
+    }
+
+  for ( SizeValueType j = 0; j < threadOrder.size(); ++j )
+    {
+    const IndexRangeType & range = m_Subranges[threadOrder[j]];
+    const PushListType &   pushes = m_Pushes[threadOrder[j]];
+    SizeValueType          p = 0;
+    for ( IndexValueType i = range[0]; i <= range[1]; ++i )
+      {
+      const OffsetValueType offset = m_Batch[i];
+      const SizeValueType   end = p + m_NumberOfPushes[i];
+      if ( m_Status )
+        {
+        // Meyer's algorithm: label the pixel if it has a single label in its
+        // neighborhood, and push its unprocessed neighbors
+        LabelImagePixelType marker = m_Markers[i];
+        bool                collision = ( m_Flags[i] & Collision ) != 0;
+        if ( m_Flags[i] & NextToBatch )
+          {
+          collision = this->FindMarker( offset, marker );
+          }
+        if ( !collision )
+          {
+          m_Output[offset] = marker;
+          for ( ; p < end; ++p )
+            {
+            const OffsetValueType n = pushes[p].first;
+            if ( m_Status[n] == Free )
+              {
+              queue.Push( pushes[p].second, n );
+              m_Status[n] = Queued;
+              }
+            }
+          }
+        m_Status[offset] = Queued;
+        progress.CompletedPixel();
+        }
+      else
+        {
+        // Beucher's algorithm: propagate the label of the pixel to its
+        // unlabeled neighbors
+        const LabelImagePixelType currentMarker = m_Output[offset];
+        for ( ; p < end; ++p )
+          {
+          const OffsetValueType n = pushes[p].first;
+          if ( m_Output[n] == wsLabel )
+            {
+            m_Output[n] = currentMarker;
+            queue.Push( pushes[p].second, n );
+            progress.CompletedPixel();
+            }
+          }
+        }
+      p = end;
+      }
+    }
+}
+
+} // end namespace itk
+
+#endif
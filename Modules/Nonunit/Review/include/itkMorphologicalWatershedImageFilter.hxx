@@ -110,6 +110,7 @@ MorphologicalWatershedImageFilter< TInputImage, TOutputImage >
   wshed->SetMarkerImage( label->GetOutput() );
   wshed->SetFullyConnected(m_FullyConnected);
   wshed->SetMarkWatershedLine(m_MarkWatershedLine);
+  wshed->SetNumberOfThreads( this->GetNumberOfThreads() );
 
   if ( m_Level != NumericTraits< InputImagePixelType >::ZeroValue() )
     {
@@ -0,0 +1,264 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMorphologicalWatershedFromMarkersImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+#include <queue>
+
+namespace
+{
+
+// Check the labels of a watershed: the markers keep their labels, each
+// labeled pixel is connected to a marker of its label through pixels of
+// the same label, and the watershed line, if any, separates the labels
+// which are not both given by the markers. Without the line, every pixel
+// is labeled.
+template< typename TLabelImage >
+bool
+CheckLabels( const TLabelImage * markers, const TLabelImage * output, bool fullyConnected, bool markWatershedLine )
+{
+  const unsigned int Dimension = TLabelImage::ImageDimension;
+  typedef typename TLabelImage::IndexType  IndexType;
+  typedef typename TLabelImage::OffsetType OffsetType;
+  typedef typename TLabelImage::PixelType  LabelType;
+
+  std::vector< OffsetType > neighbors;
+  unsigned int neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    neighborhoodSize *= 3;
+    }
+  for ( unsigned int n = 0; n < neighborhoodSize; ++n )
+    {
+    OffsetType   offset;
+    unsigned int nonZero = 0;
+    unsigned int rest = n;
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      offset[d] = static_cast< typename OffsetType::OffsetValueType >( rest % 3 ) - 1;
+      rest /= 3;
+      if ( offset[d] != 0 )
+        {
+        ++nonZero;
+        }
+      }
+    if ( nonZero == 1 || ( nonZero > 1 && fullyConnected ) )
+      {
+      neighbors.push_back( offset );
+      }
+    }
+
+  const typename TLabelImage::RegionType region = output->GetLargestPossibleRegion();
+  std::vector< bool >     reached( region.GetNumberOfPixels(), false );
+  std::queue< IndexType > front;
+
+  itk::ImageRegionConstIteratorWithIndex< TLabelImage > mit( markers, region );
+  for ( ; !mit.IsAtEnd(); ++mit )
+    {
+    if ( mit.Get() != 0 )
+      {
+      if ( output->GetPixel( mit.GetIndex() ) != mit.Get() )
+        {
+        std::cerr << "The marker at " << mit.GetIndex() << " has the label "
+                  << output->GetPixel( mit.GetIndex() ) << " instead of " << mit.Get() << std::endl;
+        return false;
+        }
+      reached[output->ComputeOffset( mit.GetIndex() )] = true;
+      front.push( mit.GetIndex() );
+      }
+    }
+
+  // flood the regions from the markers
+  while ( !front.empty() )
+    {
+    const IndexType index = front.front();
+    front.pop();
+    const LabelType label = output->GetPixel( index );
+    for ( unsigned int k = 0; k < neighbors.size(); ++k )
+      {
+      const IndexType neighbor = index + neighbors[k];
+      if ( !region.IsInside( neighbor ) )
+        {
+        continue;
+        }
+      const LabelType neighborLabel = output->GetPixel( neighbor );
+      if ( neighborLabel == label && !reached[output->ComputeOffset( neighbor )] )
+        {
+        reached[output->ComputeOffset( neighbor )] = true;
+        front.push( neighbor );
+        }
+      else if ( markWatershedLine && neighborLabel != 0 && neighborLabel != label
+                && ( markers->GetPixel( index ) == 0 || markers->GetPixel( neighbor ) == 0 ) )
+        {
+        std::cerr << "The labels " << label << " at " << index << " and " << neighborLabel
+                  << " at " << neighbor << " are not separated by the watershed line" << std::endl;
+        return false;
+        }
+      }
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< TLabelImage > it( output, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() == 0 ? !markWatershedLine : !reached[output->ComputeOffset( it.GetIndex() )] )
+      {
+      std::cerr << "The pixel at " << it.GetIndex() << ( it.Get() == 0 ? " is not labeled"
+                                                                      : " is not connected to its marker" )
+                << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// Check the watershed of a quantized noisy image with a single thread, and
+// compare it with the watershed computed with several threads, for the 4
+// combinations of the options.
+template< typename TInputImage >
+int
+MorphologicalWatershedFromMarkersImageFilterThreadedTest( unsigned int sizeValue, double step )
+{
+  const unsigned int Dimension = TInputImage::ImageDimension;
+  typedef typename TInputImage::PixelType                        PixelType;
+  typedef itk::Image< unsigned short, Dimension >                LabelImageType;
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+  typename TInputImage::SizeType size;
+  size.Fill( sizeValue );
+
+  typename TInputImage::Pointer input = TInputImage::New();
+  input->SetRegions( size );
+  input->Allocate();
+
+  typename LabelImageType::Pointer markers = LabelImageType::New();
+  markers->SetRegions( size );
+  markers->Allocate();
+  markers->FillBuffer( 0 );
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  // large plateaus give large batches of pixels of a same level
+  itk::ImageRegionIterator< TInputImage > it( input, input->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TInputImage::IndexType index = it.GetIndex();
+    double value = 50.0 + generator->GetUniformVariate( 0.0, 20.0 );
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      value += 30.0 * std::sin( index[d] * 0.15 * ( d + 1 ) );
+      }
+    it.Set( static_cast< PixelType >( step * std::floor( value / step ) ) );
+    }
+
+  const unsigned int numberOfMarkers = sizeValue / 2;
+  for ( unsigned int i = 0; i < numberOfMarkers; ++i )
+    {
+    typename LabelImageType::IndexType index;
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      index[d] = generator->GetIntegerVariate( sizeValue - 1 );
+      }
+    markers->SetPixel( index, static_cast< unsigned short >( 1 + i % 5 ) );
+    }
+
+  typedef itk::MorphologicalWatershedFromMarkersImageFilter< TInputImage, LabelImageType > FilterType;
+
+  for ( unsigned int options = 0; options < 4; ++options )
+    {
+    const bool markWatershedLine = ( options & 1 ) != 0;
+    const bool fullyConnected = ( options & 2 ) != 0;
+
+    typename FilterType::Pointer reference = FilterType::New();
+    reference->SetInput( input );
+    reference->SetMarkerImage( markers );
+    reference->SetMarkWatershedLine( markWatershedLine );
+    reference->SetFullyConnected( fullyConnected );
+    reference->SetNumberOfThreads( 1 );
+    TRY_EXPECT_NO_EXCEPTION( reference->Update() );
+
+    if ( !CheckLabels< LabelImageType >( markers, reference->GetOutput(), fullyConnected, markWatershedLine ) )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Dimension: " << Dimension
+                << ", MarkWatershedLine: " << markWatershedLine
+                << ", FullyConnected: " << fullyConnected << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    for ( itk::ThreadIdType threads = 2; threads <= 4; ++threads )
+      {
+      typename FilterType::Pointer filter = FilterType::New();
+      filter->SetInput( input );
+      filter->SetMarkerImage( markers );
+      filter->SetMarkWatershedLine( markWatershedLine );
+      filter->SetFullyConnected( fullyConnected );
+      filter->SetNumberOfThreads( threads );
+      TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+      itk::ImageRegionIterator< LabelImageType > rit( reference->GetOutput(),
+                                                      reference->GetOutput()->GetLargestPossibleRegion() );
+      itk::ImageRegionIterator< LabelImageType > oit( filter->GetOutput(),
+                                                      filter->GetOutput()->GetLargestPossibleRegion() );
+      for ( ; !rit.IsAtEnd(); ++rit, ++oit )
+        {
+        if ( rit.Get() != oit.Get() )
+          {
+          std::cerr << "Test failed!" << std::endl;
+          std::cerr << "Dimension: " << Dimension
+                    << ", MarkWatershedLine: " << markWatershedLine
+                    << ", FullyConnected: " << fullyConnected
+                    << ", threads: " << threads << std::endl;
+          std::cerr << "Label at " << rit.GetIndex() << " is " << oit.Get()
+                    << " instead of " << rit.Get() << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+int itkMorphologicalWatershedFromMarkersImageFilterThreadedTest( int, char *[] )
+{
+  typedef itk::Image< unsigned char, 2 > UCharImageType;
+  typedef itk::Image< float, 2 >         FloatImageType;
+  typedef itk::Image< short, 3 >         ShortImageType;
+
+  typedef itk::MorphologicalWatershedFromMarkersImageFilter< UCharImageType, UCharImageType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, MorphologicalWatershedFromMarkersImageFilter, ImageToImageFilter );
+
+  if ( MorphologicalWatershedFromMarkersImageFilterThreadedTest< UCharImageType >( 256, 8.0 ) == EXIT_FAILURE
+       || MorphologicalWatershedFromMarkersImageFilterThreadedTest< FloatImageType >( 200, 4.0 ) == EXIT_FAILURE
+       || MorphologicalWatershedFromMarkersImageFilterThreadedTest< ShortImageType >( 40, 8.0 ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
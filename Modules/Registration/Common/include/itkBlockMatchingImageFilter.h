@@ -23,6 +23,9 @@
 #include "itkPointSet.h"
 #include "itkVector.h"
 #include "itkDefaultDynamicMeshTraits.h"
+#include "itkAutoPointer.h"
+#include "itkVnlFFTCommon.h"
+#include <vector>
 
 
 namespace itk
@@ -56,6 +59,16 @@ namespace itk
  * matching, Proc. SPIE Vis. Comm. and Image Proc., vol. 1001, pp. 942-951,
  * 1988.].
  *
+ * For each feature point, the fixed image region swept by the search and
+ * the moving block are copied into contiguous buffers. The sums and sums
+ * of squares of the fixed blocks are obtained for all candidate positions
+ * at once with separable running box sums, and the moving block is
+ * centered once. The cross term of all the candidates is a correlation of
+ * the fixed region with the centered moving block: it is computed with
+ * FFTs when the search is large enough for them to be cheaper than the
+ * direct sums over the blocks. A constant block, detected exactly, has a
+ * similarity of zero. Feature points are processed in parallel.
+ *
  * \author Andriy Kot, Center for Real-Time Computing, Old Dominion University,
  * Norfolk, VA
  *
@@ -185,12 +198,33 @@ protected:
    * control to ThreadedGenerateData(). */
   static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
 
+  /** FFT used to correlate the search region with the moving block. */
+  typedef Image< SimilaritiesValue, ImageDimension >             CorrelationImageType;
+  typedef VnlFFTCommon::VnlFFTTransform< CorrelationImageType >  FFTTransformType;
+  typedef typename FFTTransformType::ComplexType                 ComplexType;
+
   /** Internal structure used for passing image data into the threading library
     */
   struct ThreadStruct {
     Pointer Filter;
   };
 
+  /** Copy the pixels of \c region into \c buffer, first dimension fastest.
+   * Pixels outside the buffered region of \c image are replaced by the
+   * nearest pixel inside it. */
+  template< typename TImage >
+  static void CopyRegionToBuffer( const TImage * image, const ImageRegionType & region, SimilaritiesValue * buffer );
+
+  /** Compute the sum of \c values over every box of extent \c boxSize
+   * that fits in an array of extent \c size. */
+  static void ComputeBoxSums( const SimilaritiesValue * values, const ImageSizeType & size,
+                              const ImageSizeType & boxSize, SimilaritiesValue * sums );
+
+  /** Offsets of the first element of each row, along the first dimension,
+   * of an array of extent \c size stored in an array of extent \c layout. */
+  static void ComputeRowOffsets( const ImageSizeType & size, const ImageSizeType & layout,
+                                 std::vector< SizeValueType > & offsets );
+
 private:
   BlockMatchingImageFilter( const BlockMatchingImageFilter & ) ITK_DELETE_FUNCTION;
   void operator=( const BlockMatchingImageFilter & ) ITK_DELETE_FUNCTION;
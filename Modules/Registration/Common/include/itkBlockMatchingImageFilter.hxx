@@ -19,9 +19,11 @@
 #define itkBlockMatchingImageFilter_hxx
 
 #include "itkBlockMatchingImageFilter.h"
-#include "itkImageRegionConstIterator.h"
-#include "itkConstNeighborhoodIterator.h"
+#include "itkImageScanlineConstIterator.h"
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 
 namespace itk
@@ -218,6 +220,185 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
   return ITK_THREAD_RETURN_VALUE;
 }
 
+
+template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
+template< typename TImage >
+void
+BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements, TSimilarities >
+::CopyRegionToBuffer( const TImage * image, const ImageRegionType & region, SimilaritiesValue * buffer )
+{
+  // The part of the region inside the buffered region is copied line by
+  // line. The rest is then filled by replicating the copied border slices,
+  // which clamps the indices like the ZeroFluxNeumannBoundaryCondition of
+  // the neighborhood iterators used previously.
+  const ImageRegionType & bufferedRegion = image->GetBufferedRegion();
+  const ImageIndexType    bufferedStart = bufferedRegion.GetIndex();
+  const ImageIndexType    bufferedEnd = bufferedRegion.GetUpperIndex();
+  const ImageIndexType    regionStart = region.GetIndex();
+  const ImageSizeType &   regionSize = region.GetSize();
+
+  ImageIndexType insideStart;
+  ImageSizeType  insideSize;
+  IndexValueType first[ ImageDimension ];
+  IndexValueType last[ ImageDimension ];
+  SizeValueType  strides[ ImageDimension ];
+  SizeValueType  numberOfPixels = 1;
+  bool           clamped = false;
+  for ( unsigned d = 0; d < ImageDimension; d++ )
+    {
+    const IndexValueType regionEnd = regionStart[ d ] + static_cast< IndexValueType >( regionSize[ d ] ) - 1;
+    insideStart[ d ] = std::min( std::max( regionStart[ d ], bufferedStart[ d ] ), bufferedEnd[ d ] );
+    const IndexValueType insideEnd = std::min( std::max( regionEnd, bufferedStart[ d ] ), bufferedEnd[ d ] );
+    insideSize[ d ] = static_cast< SizeValueType >( insideEnd - insideStart[ d ] + 1 );
+
+    // a region entirely outside of the buffered region along d is filled
+    // from a single slice, stored at its nearest end
+    first[ d ] = std::min( std::max( insideStart[ d ] - regionStart[ d ], IndexValueType( 0 ) ),
+                           static_cast< IndexValueType >( regionSize[ d ] ) - 1 );
+    last[ d ] = first[ d ] + static_cast< IndexValueType >( insideSize[ d ] ) - 1;
+    clamped = clamped || first[ d ] != 0 || last[ d ] != regionEnd - regionStart[ d ];
+
+    strides[ d ] = numberOfPixels;
+    numberOfPixels *= regionSize[ d ];
+    }
+
+  typedef ImageScanlineConstIterator< TImage > IteratorType;
+  IteratorType it( image, ImageRegionType( insideStart, insideSize ) );
+  while ( !it.IsAtEnd() )
+    {
+    const ImageIndexType & index = it.GetIndex();
+    SizeValueType offset = 0;
+    for ( unsigned d = 0; d < ImageDimension; d++ )
+      {
+      offset += static_cast< SizeValueType >( index[ d ] - insideStart[ d ] + first[ d ] ) * strides[ d ];
+      }
+    SimilaritiesValue *out = buffer + offset;
+    while ( !it.IsAtEndOfLine() )
+      {
+      *out++ = static_cast< SimilaritiesValue >( it.Get() );
+      ++it;
+      }
+    it.NextLine();
+    }
+
+  if ( !clamped )
+    {
+    return;
+    }
+
+  // Replicate along each dimension in turn: the slices read along d are
+  // complete along the dimensions already processed.
+  for ( unsigned d = 0; d < ImageDimension; d++ )
+    {
+    if ( first[ d ] == 0 && last[ d ] == static_cast< IndexValueType >( regionSize[ d ] ) - 1 )
+      {
+      continue;
+      }
+    for ( SizeValueType n = 0; n < numberOfPixels; n++ )
+      {
+      const IndexValueType coordinate = static_cast< IndexValueType >( ( n / strides[ d ] ) % regionSize[ d ] );
+      if ( coordinate < first[ d ] )
+        {
+        buffer[ n ] = buffer[ n + static_cast< SizeValueType >( first[ d ] - coordinate ) * strides[ d ] ];
+        }
+      else if ( coordinate > last[ d ] )
+        {
+        buffer[ n ] = buffer[ n - static_cast< SizeValueType >( coordinate - last[ d ] ) * strides[ d ] ];
+        }
+      }
+    }
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
+void
+BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements, TSimilarities >
+::ComputeBoxSums( const SimilaritiesValue * values, const ImageSizeType & size,
+                  const ImageSizeType & boxSize, SimilaritiesValue * sums )
+{
+  // Separable running box sums. Each pass shrinks the extent along one
+  // dimension, so after the last pass the buffers hold one sum per box
+  // position that fits in 'size'.
+  SizeValueType numberOfValues = 1;
+  for ( unsigned d = 0; d < ImageDimension; d++ )
+    {
+    numberOfValues *= size[ d ];
+    }
+  std::vector< SimilaritiesValue > inputSums( values, values + numberOfValues );
+
+  ImageSizeType extent = size;
+  std::vector< SimilaritiesValue > outputSums;
+  for ( unsigned d = 0; d < ImageDimension; d++ )
+    {
+    const SizeValueType width = boxSize[ d ];
+
+    // strides of the input and output along dimension d
+    SizeValueType stride = 1;
+    for ( unsigned k = 0; k < d; k++ )
+      {
+      stride *= extent[ k ];
+      }
+    SizeValueType outer = 1;
+    for ( unsigned k = d + 1; k < ImageDimension; k++ )
+      {
+      outer *= extent[ k ];
+      }
+    const SizeValueType inputLength = extent[ d ];
+    const SizeValueType outputLength = inputLength - width + 1;
+
+    outputSums.resize( stride * outputLength * outer );
+    for ( SizeValueType o = 0; o < outer; o++ )
+      {
+      for ( SizeValueType s = 0; s < stride; s++ )
+        {
+        const SimilaritiesValue *in = &( inputSums[ o * inputLength * stride + s ] );
+        SimilaritiesValue *out = &( outputSums[ o * outputLength * stride + s ] );
+
+        SimilaritiesValue sum = NumericTraits< SimilaritiesValue >::ZeroValue();
+        for ( SizeValueType i = 0; i < width; i++ )
+          {
+          sum += in[ i * stride ];
+          }
+        out[ 0 ] = sum;
+        for ( SizeValueType i = 1; i < outputLength; i++ )
+          {
+          sum += in[ ( i + width - 1 ) * stride ] - in[ ( i - 1 ) * stride ];
+          out[ i * stride ] = sum;
+          }
+        }
+      }
+    extent[ d ] = outputLength;
+    inputSums.swap( outputSums );
+    }
+
+  std::copy( inputSums.begin(), inputSums.end(), sums );
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
+void
+BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements, TSimilarities >
+::ComputeRowOffsets( const ImageSizeType & size, const ImageSizeType & layout, std::vector< SizeValueType > & offsets )
+{
+  SizeValueType numberOfRows = 1;
+  for ( unsigned i = 1; i < ImageDimension; i++ )
+    {
+    numberOfRows *= size[ i ];
+    }
+  offsets.resize( numberOfRows );
+  for ( SizeValueType row = 0; row < numberOfRows; row++ )
+    {
+    SizeValueType rowIndex = row;
+    SizeValueType offset = 0;
+    SizeValueType stride = layout[ 0 ];
+    for ( unsigned i = 1; i < ImageDimension; i++ )
+      {
+      offset += ( rowIndex % size[ i ] ) * stride;
+      rowIndex /= size[ i ];
+      stride *= layout[ i ];
+      }
+    offsets[ row ] = offset;
+    }
+}
+
 template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
 void
 BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements, TSimilarities >
@@ -237,20 +418,89 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
     count += this->m_PointsCount % threadCount;
     }
 
-  // start constructing window region and center region (single voxel)
-  ImageRegionType window;
-  ImageRegionType center;
+  // The search for each feature point works on contiguous copies of the
+  // moving block and of the fixed region swept by the block. The fixed
+  // values are shifted by their mean over that region, which leaves the
+  // similarity unchanged and keeps the box sums of squares from losing
+  // significant digits to a large intensity offset.
+  ImageSizeType blockSize;
   ImageSizeType windowSize;
-  windowSize.Fill( 1 );
-  center.SetSize( windowSize ); // size of center region is 1
-  windowSize += m_SearchRadius + m_SearchRadius;
-  window.SetSize( windowSize ); // size of window region is 1+2*m_BlockHalfWindow
-
-  // start constructing block iterator
+  ImageSizeType searchSize;
+  ImageSizeType paddedSize;
   SizeValueType numberOfVoxelInBlock = 1;
-  for ( unsigned i = 0; i < ImageSizeType::Dimension; i++ )
+  SizeValueType numberOfVoxelInSearch = 1;
+  SizeValueType numberOfVoxelInWindow = 1;
+  SizeValueType numberOfVoxelInPadded = 1;
+  for ( unsigned i = 0; i < ImageDimension; i++ )
+    {
+    blockSize[ i ] = m_BlockRadius[ i ] + 1 + m_BlockRadius[ i ];
+    windowSize[ i ] = m_SearchRadius[ i ] + 1 + m_SearchRadius[ i ];
+    searchSize[ i ] = windowSize[ i ] + blockSize[ i ] - 1;
+    paddedSize[ i ] = searchSize[ i ];
+    while ( !VnlFFTCommon::IsDimensionSizeLegal( paddedSize[ i ] ) )
+      {
+      ++paddedSize[ i ];
+      }
+    numberOfVoxelInBlock *= blockSize[ i ];
+    numberOfVoxelInWindow *= windowSize[ i ];
+    numberOfVoxelInSearch *= searchSize[ i ];
+    numberOfVoxelInPadded *= paddedSize[ i ];
+    }
+
+  // The cross term of all the candidates is the correlation of the fixed
+  // region with the centered moving block. The FFTs transform both at once,
+  // as the real and imaginary parts of a padded signal, and are used when
+  // the two transforms cost less than the direct sums over the blocks.
+  const double fftCost = 5.0 * numberOfVoxelInPadded * std::log( static_cast< double >( numberOfVoxelInPadded ) ) / std::log( 2.0 );
+  const bool useFFT = fftCost < static_cast< double >( numberOfVoxelInBlock ) * numberOfVoxelInWindow;
+
+  std::vector< SizeValueType > blockRowOffsets;
+  this->ComputeRowOffsets( blockSize, searchSize, blockRowOffsets );
+  const SizeValueType blockRowLength = blockSize[ 0 ];
+  const SizeValueType numberOfBlockRows = blockRowOffsets.size();
+
+  std::vector< SimilaritiesValue > searchBuffer( numberOfVoxelInSearch );
+  std::vector< SimilaritiesValue > blockBuffer( numberOfVoxelInBlock );
+  std::vector< SimilaritiesValue > squaresBuffer( numberOfVoxelInSearch );
+  std::vector< SimilaritiesValue > differencesBuffer( numberOfVoxelInSearch );
+  std::vector< SimilaritiesValue > fixedSums( numberOfVoxelInWindow );
+  std::vector< SimilaritiesValue > fixedSumsOfSquares( numberOfVoxelInWindow );
+  std::vector< SimilaritiesValue > fixedVariations( numberOfVoxelInWindow );
+  std::vector< SimilaritiesValue > variationSums( numberOfVoxelInWindow );
+  std::vector< SimilaritiesValue > crossTerms( numberOfVoxelInWindow );
+
+  AutoPointer< FFTTransformType > fft;
+  std::vector< ComplexType >      fftSignal;
+  std::vector< ComplexType >      fftProduct;
+  std::vector< SizeValueType >    mirroredIndices;
+  std::vector< SizeValueType >    searchRowsInPadded;
+  std::vector< SizeValueType >    blockRowsInPadded;
+  std::vector< SizeValueType >    windowRowsInPadded;
+  if ( useFFT )
     {
-    numberOfVoxelInBlock *= m_BlockRadius[ i ] + 1 + m_BlockRadius[ i ];
+    fft.TakeOwnership( new FFTTransformType( paddedSize ) );
+    fftSignal.resize( numberOfVoxelInPadded );
+    fftProduct.resize( numberOfVoxelInPadded );
+    this->ComputeRowOffsets( searchSize, paddedSize, searchRowsInPadded );
+    this->ComputeRowOffsets( blockSize, paddedSize, blockRowsInPadded );
+    this->ComputeRowOffsets( windowSize, paddedSize, windowRowsInPadded );
+
+    // index of the frequency -k for each frequency k
+    mirroredIndices.resize( numberOfVoxelInPadded );
+    for ( SizeValueType k = 0; k < numberOfVoxelInPadded; k++ )
+      {
+      SizeValueType remainder = k;
+      SizeValueType mirrored = 0;
+      SizeValueType stride = 1;
+      for ( unsigned i = 0; i < ImageDimension; i++ )
+        {
+        const SizeValueType coordinate = remainder % paddedSize[ i ];
+        remainder /= paddedSize[ i ];
+        mirrored += ( ( paddedSize[ i ] - coordinate ) % paddedSize[ i ] ) * stride;
+        stride *= paddedSize[ i ];
+        }
+      mirroredIndices[ k ] = mirrored;
+      }
     }
 
   // loop thru feature points
@@ -268,57 +518,194 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
     // New point location
     DisplacementsVector displacement;
 
-    // set centers of window and center regions to current location
-    ImageIndexType start = fixedIndex - this->m_SearchRadius;
-    window.SetIndex( start );
-    center.SetIndex( movingIndex );
+    // gather the fixed region swept by the block over the search window and
+    // the moving block centered on the feature point
+    const ImageIndexType windowStart = fixedIndex - this->m_SearchRadius;
+    this->CopyRegionToBuffer( fixedImage.GetPointer(),
+                              ImageRegionType( windowStart - this->m_BlockRadius, searchSize ),
+                              &( searchBuffer[ 0 ] ) );
+    this->CopyRegionToBuffer( movingImage.GetPointer(),
+                              ImageRegionType( movingIndex - this->m_BlockRadius, blockSize ),
+                              &( blockBuffer[ 0 ] ) );
+
+    // a constant block has no correlation with anything: it is detected
+    // exactly rather than from a variance that rounding may leave non zero
+    SimilaritiesValue movingSum = NumericTraits< SimilaritiesValue >::ZeroValue();
+    bool movingIsConstant = true;
+    for ( SizeValueType i = 0; i < numberOfVoxelInBlock; i++ )
+      {
+      movingSum += blockBuffer[ i ];
+      movingIsConstant = movingIsConstant && blockBuffer[ i ] == blockBuffer[ 0 ];
+      }
+    const SimilaritiesValue movingMean = movingSum / numberOfVoxelInBlock;
+    SimilaritiesValue movingVariance = NumericTraits< SimilaritiesValue >::ZeroValue();
+    for ( SizeValueType i = 0; i < numberOfVoxelInBlock; i++ )
+      {
+      blockBuffer[ i ] -= movingMean;
+      movingVariance += blockBuffer[ i ] * blockBuffer[ i ];
+      }
 
-    // iterate over neighborhoods in region window, for each neighborhood: iterate over voxels in blockRadius
-    ConstNeighborhoodIterator< FixedImageType > windowIterator( m_BlockRadius, fixedImage, window );
+    if ( !movingIsConstant )
+      {
+      // A fixed block is constant when no two neighbor voxels of the block
+      // differ. The differences along each dimension are counted with box
+      // sums one voxel shorter along that dimension.
+      std::fill( variationSums.begin(), variationSums.end(), NumericTraits< SimilaritiesValue >::ZeroValue() );
+      SizeValueType stride = 1;
+      for ( unsigned d = 0; d < ImageDimension; d++ )
+        {
+        if ( blockSize[ d ] > 1 )
+          {
+          ImageSizeType variationSize = searchSize;
+          ImageSizeType variationBoxSize = blockSize;
+          --variationSize[ d ];
+          --variationBoxSize[ d ];
+          SizeValueType n = 0;
+          for ( SizeValueType i = 0; i < numberOfVoxelInSearch; i++ )
+            {
+            if ( ( i / stride ) % searchSize[ d ] + 1 < searchSize[ d ] )
+              {
+              differencesBuffer[ n++ ] = ( searchBuffer[ i ] != searchBuffer[ i + stride ] ) ? 1 : 0;
+              }
+            }
+          this->ComputeBoxSums( &( differencesBuffer[ 0 ] ), variationSize, variationBoxSize, &( fixedVariations[ 0 ] ) );
+          for ( SizeValueType c = 0; c < numberOfVoxelInWindow; c++ )
+            {
+            variationSums[ c ] += fixedVariations[ c ];
+            }
+          }
+        stride *= searchSize[ d ];
+        }
 
-    // iterate over voxels in neighborhood of current feature point
-    ConstNeighborhoodIterator< MovingImageType > centerIterator( m_BlockRadius, movingImage, center );
-    centerIterator.GoToBegin();
+      SimilaritiesValue searchSum = NumericTraits< SimilaritiesValue >::ZeroValue();
+      for ( SizeValueType i = 0; i < numberOfVoxelInSearch; i++ )
+        {
+        searchSum += searchBuffer[ i ];
+        }
+      const SimilaritiesValue searchMean = searchSum / numberOfVoxelInSearch;
+      for ( SizeValueType i = 0; i < numberOfVoxelInSearch; i++ )
+        {
+        searchBuffer[ i ] -= searchMean;
+        squaresBuffer[ i ] = searchBuffer[ i ] * searchBuffer[ i ];
+        }
+      this->ComputeBoxSums( &( searchBuffer[ 0 ] ), searchSize, blockSize, &( fixedSums[ 0 ] ) );
+      this->ComputeBoxSums( &( squaresBuffer[ 0 ] ), searchSize, blockSize, &( fixedSumsOfSquares[ 0 ] ) );
 
-    // iterate over neighborhoods in region window
-    for ( windowIterator.GoToBegin(); !windowIterator.IsAtEnd(); ++windowIterator )
-      {
-      SimilaritiesValue fixedSum = NumericTraits< SimilaritiesValue >::ZeroValue();
-      SimilaritiesValue fixedSumOfSquares = NumericTraits< SimilaritiesValue >::ZeroValue();
-      SimilaritiesValue movingSum = NumericTraits< SimilaritiesValue >::ZeroValue();
-      SimilaritiesValue movingSumOfSquares = NumericTraits< SimilaritiesValue >::ZeroValue();
-      SimilaritiesValue covariance = NumericTraits< SimilaritiesValue >::ZeroValue();
-
-      // iterate over voxels in blockRadius
-      for ( SizeValueType i = 0; i < numberOfVoxelInBlock; i++ ) // windowIterator.Size() == numberOfVoxelInBlock
+      // The moving block sums to zero, so the cross term does not depend
+      // on the means of the fixed blocks.
+      if ( useFFT )
+        {
+        std::fill( fftSignal.begin(), fftSignal.end(), ComplexType( 0 ) );
+        for ( SizeValueType row = 0; row < searchRowsInPadded.size(); row++ )
+          {
+          const SimilaritiesValue *in = &( searchBuffer[ row * searchSize[ 0 ] ] );
+          ComplexType *out = &( fftSignal[ searchRowsInPadded[ row ] ] );
+          for ( SizeValueType i = 0; i < searchSize[ 0 ]; i++ )
+            {
+            out[ i ] = ComplexType( in[ i ], 0 );
+            }
+          }
+        for ( SizeValueType row = 0; row < numberOfBlockRows; row++ )
+          {
+          const SimilaritiesValue *in = &( blockBuffer[ row * blockRowLength ] );
+          ComplexType *out = &( fftSignal[ blockRowsInPadded[ row ] ] );
+          for ( SizeValueType i = 0; i < blockRowLength; i++ )
+            {
+            out[ i ] = ComplexType( out[ i ].real(), in[ i ] );
+            }
+          }
+        fft->transform( &( fftSignal[ 0 ] ), -1 );
+
+        // Separate the transforms F and M of the real and imaginary parts,
+        // and multiply F by the conjugate of M.
+        const ComplexType half( 0.5, 0 );
+        const ComplexType minusHalfI( 0, -0.5 );
+        for ( SizeValueType k = 0; k < numberOfVoxelInPadded; k++ )
+          {
+          const ComplexType z = fftSignal[ k ];
+          const ComplexType zMirrored = std::conj( fftSignal[ mirroredIndices[ k ] ] );
+          const ComplexType fixedTransform = half * ( z + zMirrored );
+          const ComplexType movingTransform = minusHalfI * ( z - zMirrored );
+          fftProduct[ k ] = fixedTransform * std::conj( movingTransform );
+          }
+        fft->transform( &( fftProduct[ 0 ] ), 1 );
+
+        for ( SizeValueType row = 0; row < windowRowsInPadded.size(); row++ )
+          {
+          const ComplexType *in = &( fftProduct[ windowRowsInPadded[ row ] ] );
+          SimilaritiesValue *out = &( crossTerms[ row * windowSize[ 0 ] ] );
+          for ( SizeValueType i = 0; i < windowSize[ 0 ]; i++ )
+            {
+            out[ i ] = in[ i ].real() / numberOfVoxelInPadded;
+            }
+          }
+        }
+      else
         {
-        const SimilaritiesValue fixedValue = windowIterator.GetPixel( i );
-        const SimilaritiesValue movingValue = centerIterator.GetPixel( i );
-        movingSum += movingValue;
-        fixedSum += fixedValue;
-        movingSumOfSquares += movingValue * movingValue;
-        fixedSumOfSquares += fixedValue * fixedValue;
-        covariance += fixedValue * movingValue;
+        SizeValueType c = 0;
+        for ( SizeValueType windowRow = 0; windowRow < numberOfVoxelInWindow / windowSize[ 0 ]; windowRow++ )
+          {
+          // origin of the first block of the row in the search buffer
+          SizeValueType rowIndex = windowRow;
+          SizeValueType origin = 0;
+          SizeValueType searchStride = searchSize[ 0 ];
+          for ( unsigned i = 1; i < ImageDimension; i++ )
+            {
+            origin += ( rowIndex % windowSize[ i ] ) * searchStride;
+            rowIndex /= windowSize[ i ];
+            searchStride *= searchSize[ i ];
+            }
+          for ( SizeValueType w = 0; w < windowSize[ 0 ]; w++, c++ )
+            {
+            SimilaritiesValue crossTerm = NumericTraits< SimilaritiesValue >::ZeroValue();
+            const SimilaritiesValue *movingValue = &( blockBuffer[ 0 ] );
+            for ( SizeValueType row = 0; row < numberOfBlockRows; row++ )
+              {
+              const SimilaritiesValue *fixedValue = &( searchBuffer[ origin + w + blockRowOffsets[ row ] ] );
+              for ( SizeValueType i = 0; i < blockRowLength; i++ )
+                {
+                crossTerm += fixedValue[ i ] * movingValue[ i ];
+                }
+              movingValue += blockRowLength;
+              }
+            crossTerms[ c ] = crossTerm;
+            }
+          }
         }
-      const SimilaritiesValue fixedMean = fixedSum / numberOfVoxelInBlock;
-      const SimilaritiesValue movingMean = movingSum / numberOfVoxelInBlock;
-      const SimilaritiesValue fixedVariance = fixedSumOfSquares - numberOfVoxelInBlock * fixedMean * fixedMean;
-      const SimilaritiesValue movingVariance = movingSumOfSquares - numberOfVoxelInBlock * movingMean * movingMean;
-      covariance -= numberOfVoxelInBlock * fixedMean * movingMean;
+      }
 
+    // iterate over block positions in the search window, first dimension fastest
+    typename ImageIndexType::OffsetType windowOffset;
+    windowOffset.Fill( 0 );
+    for ( SizeValueType c = 0; c < numberOfVoxelInWindow; c++ )
+      {
       SimilaritiesValue sim = NumericTraits< SimilaritiesValue >::ZeroValue();
-      if ( fixedVariance * movingVariance )
+      if ( !movingIsConstant && variationSums[ c ] > 0 )
         {
-        sim = ( covariance * covariance ) / ( fixedVariance * movingVariance );
+        const SimilaritiesValue fixedVariance = fixedSumsOfSquares[ c ] - fixedSums[ c ] * fixedSums[ c ] / numberOfVoxelInBlock;
+        if ( fixedVariance > 0 && movingVariance > 0 )
+          {
+          sim = ( crossTerms[ c ] * crossTerms[ c ] ) / ( fixedVariance * movingVariance );
+          }
         }
 
       if ( sim >= similarity )
         {
         FeaturePointsPhysicalCoordinates newLocation;
-        fixedImage->TransformIndexToPhysicalPoint( windowIterator.GetIndex(), newLocation );
+        fixedImage->TransformIndexToPhysicalPoint( windowStart + windowOffset, newLocation );
         displacement = newLocation - originalLocation;
         similarity = sim;
         }
+
+      // advance to the next block position
+      for ( unsigned i = 0; i < ImageDimension; i++ )
+        {
+        if ( ++windowOffset[ i ] < static_cast< IndexValueType >( windowSize[ i ] ) )
+          {
+          break;
+          }
+        windowOffset[ i ] = 0;
+        }
       }
     this->m_DisplacementsVectorsArray[ idx ] = displacement;
     this->m_SimilaritiesValuesArray[ idx ] = similarity;
@@ -23,6 +23,7 @@ itk_module(ITKRegistrationCommon
     ITKFiniteDifference
     ITKDisplacementField
     ITKStatistics
+    ITKFFT
   TEST_DEPENDS
     ITKTestKernel
     ITKDistanceMap
@@ -0,0 +1,288 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBlockMatchingImageFilter.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <cmath>
+
+/* Compare BlockMatchingImageFilter against a direct evaluation of the
+ * normalized correlation with neighborhood iterators, as the filter did
+ * before the search used contiguous buffers and running box sums. Feature
+ * points are placed in textured areas, at the image border and in constant
+ * areas, where the similarity must be exactly zero. */
+namespace
+{
+
+const unsigned int Dimension = 3;
+typedef itk::Image< double, Dimension >                ImageType;
+typedef itk::BlockMatchingImageFilter< ImageType >     BlockMatchingFilterType;
+typedef BlockMatchingFilterType::FeaturePointsType     PointSetType;
+typedef BlockMatchingFilterType::SimilaritiesValue     SimilaritiesValue;
+typedef ImageType::IndexType                           IndexType;
+typedef ImageType::SizeType                            RadiusType;
+
+// Value of the test pattern. The first columns are constant with an
+// integer value, the last ones constant with a value that is not exactly
+// representable, and the rest is textured. The large mean of the texture
+// makes sumOfSquares - n * mean^2 lose most of its significant digits.
+double
+PatternValue( const IndexType & index, const IndexType & shift )
+{
+  const double x = static_cast< double >( index[0] - shift[0] );
+  const double y = static_cast< double >( index[1] - shift[1] );
+  const double z = static_cast< double >( index[2] - shift[2] );
+  if ( x < 6 )
+    {
+    return 100.0;
+    }
+  if ( x >= 20 )
+    {
+    return 3000.1;
+    }
+  const unsigned int hash = static_cast< unsigned int >( ( x + 7 ) * 73856093 ) ^ static_cast< unsigned int >( ( y + 7 ) * 19349663 )
+                            ^ static_cast< unsigned int >( ( z + 7 ) * 83492791 );
+  return 3000.0 + 10.3 * std::sin( 0.7 * x + 0.3 * y ) * std::cos( 0.5 * z ) + 0.37 * ( hash % 1000 ) / 1000.0;
+}
+
+ImageType::Pointer
+MakeImage( const IndexType & shift )
+{
+  ImageType::SizeType size;
+  size[0] = 30;
+  size[1] = 20;
+  size[2] = 16;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    it.Set( PatternValue( it.GetIndex(), shift ) );
+    }
+  return image;
+}
+
+// similarity of the moving block centered on movingIndex with the fixed
+// block centered on fixedIndex, computed as in the former implementation
+SimilaritiesValue
+ReferenceSimilarity( const ImageType * fixedImage, const ImageType * movingImage, const RadiusType & blockRadius,
+                     const IndexType & fixedIndex, const IndexType & movingIndex )
+{
+  RadiusType centerSize;
+  centerSize.Fill( 1 );
+  ImageType::RegionType fixedCenter( fixedIndex, centerSize );
+  ImageType::RegionType movingCenter( movingIndex, centerSize );
+  itk::ConstNeighborhoodIterator< ImageType > fixedIterator( blockRadius, fixedImage, fixedCenter );
+  itk::ConstNeighborhoodIterator< ImageType > movingIterator( blockRadius, movingImage, movingCenter );
+  fixedIterator.GoToBegin();
+  movingIterator.GoToBegin();
+
+  const itk::SizeValueType numberOfVoxelInBlock = fixedIterator.Size();
+  SimilaritiesValue fixedSum = 0.0;
+  SimilaritiesValue fixedSumOfSquares = 0.0;
+  SimilaritiesValue movingSum = 0.0;
+  SimilaritiesValue movingSumOfSquares = 0.0;
+  SimilaritiesValue covariance = 0.0;
+  for ( itk::SizeValueType i = 0; i < numberOfVoxelInBlock; i++ )
+    {
+    const SimilaritiesValue fixedValue = fixedIterator.GetPixel( i );
+    const SimilaritiesValue movingValue = movingIterator.GetPixel( i );
+    movingSum += movingValue;
+    fixedSum += fixedValue;
+    movingSumOfSquares += movingValue * movingValue;
+    fixedSumOfSquares += fixedValue * fixedValue;
+    covariance += fixedValue * movingValue;
+    }
+  const SimilaritiesValue fixedMean = fixedSum / numberOfVoxelInBlock;
+  const SimilaritiesValue movingMean = movingSum / numberOfVoxelInBlock;
+  const SimilaritiesValue fixedVariance = fixedSumOfSquares - numberOfVoxelInBlock * fixedMean * fixedMean;
+  const SimilaritiesValue movingVariance = movingSumOfSquares - numberOfVoxelInBlock * movingMean * movingMean;
+  covariance -= numberOfVoxelInBlock * fixedMean * movingMean;
+
+  SimilaritiesValue sim = 0.0;
+  if ( fixedVariance * movingVariance > 0 )
+    {
+    sim = ( covariance * covariance ) / ( fixedVariance * movingVariance );
+    }
+  return sim;
+}
+
+BlockMatchingFilterType::Pointer
+Match( const ImageType * fixedImage, const ImageType * movingImage, const PointSetType * points,
+       const RadiusType & blockRadius, const RadiusType & searchRadius, itk::ThreadIdType numberOfThreads )
+{
+  BlockMatchingFilterType::Pointer filter = BlockMatchingFilterType::New();
+  filter->SetFixedImage( fixedImage );
+  filter->SetMovingImage( movingImage );
+  filter->SetFeaturePoints( points );
+  filter->SetBlockRadius( blockRadius );
+  filter->SetSearchRadius( searchRadius );
+  filter->SetNumberOfThreads( numberOfThreads );
+  filter->Update();
+  return filter;
+}
+
+// Match the points with 1 and 4 threads and compare with an exhaustive
+// search evaluated with the reference similarity
+int
+CheckMatches( const ImageType * fixedImage, const ImageType * movingImage, const PointSetType * points,
+              const bool * inConstantMovingBlock, const RadiusType & blockRadius, const RadiusType & searchRadius )
+{
+  const double tolerance = 1e-9;
+
+  BlockMatchingFilterType::Pointer filter = Match( fixedImage, movingImage, points, blockRadius, searchRadius, 1 );
+  BlockMatchingFilterType::Pointer threadedFilter = Match( fixedImage, movingImage, points, blockRadius, searchRadius, 4 );
+
+  int status = EXIT_SUCCESS;
+  for ( unsigned int p = 0; p < points->GetNumberOfPoints(); p++ )
+    {
+    const BlockMatchingFilterType::DisplacementsVector displacement = filter->GetDisplacements()->GetPointData()->GetElement( p );
+    const SimilaritiesValue similarity = filter->GetSimilarities()->GetPointData()->GetElement( p );
+
+    if ( displacement != threadedFilter->GetDisplacements()->GetPointData()->GetElement( p )
+         || similarity != threadedFilter->GetSimilarities()->GetPointData()->GetElement( p ) )
+      {
+      std::cerr << "Point " << p << ": the results with 1 and 4 threads differ" << std::endl;
+      status = EXIT_FAILURE;
+      }
+
+    IndexType pointIndex;
+    fixedImage->TransformPhysicalPointToIndex( points->GetPoint( p ), pointIndex );
+
+    if ( inConstantMovingBlock[p] )
+      {
+      if ( similarity != 0.0 )
+        {
+        std::cerr << "Point " << p << ": similarity " << similarity << " of a constant block is not 0" << std::endl;
+        status = EXIT_FAILURE;
+        }
+      continue;
+      }
+
+    // exhaustive reference search
+    SimilaritiesValue referenceSimilarity = 0.0;
+    itk::Offset< Dimension > offset;
+    for ( offset[2] = -static_cast< int >( searchRadius[2] ); offset[2] <= static_cast< int >( searchRadius[2] ); offset[2]++ )
+      {
+      for ( offset[1] = -static_cast< int >( searchRadius[1] ); offset[1] <= static_cast< int >( searchRadius[1] ); offset[1]++ )
+        {
+        for ( offset[0] = -static_cast< int >( searchRadius[0] ); offset[0] <= static_cast< int >( searchRadius[0] ); offset[0]++ )
+          {
+          const SimilaritiesValue sim =
+            ReferenceSimilarity( fixedImage, movingImage, blockRadius, pointIndex + offset, pointIndex );
+          referenceSimilarity = std::max( referenceSimilarity, sim );
+          }
+        }
+      }
+
+    // the chosen candidate must be one of the best reference candidates
+    IndexType matchedIndex;
+    PointSetType::PointType matchedPoint = points->GetPoint( p ) + displacement;
+    fixedImage->TransformPhysicalPointToIndex( matchedPoint, matchedIndex );
+    const SimilaritiesValue matchedReferenceSimilarity =
+      ReferenceSimilarity( fixedImage, movingImage, blockRadius, matchedIndex, pointIndex );
+
+    if ( std::fabs( similarity - referenceSimilarity ) > tolerance
+         || std::fabs( matchedReferenceSimilarity - referenceSimilarity ) > tolerance )
+      {
+      std::cerr << "Point " << p << " at " << pointIndex << ": matched " << matchedIndex
+                << " with similarity " << similarity << " (reference " << matchedReferenceSimilarity
+                << "), best reference similarity " << referenceSimilarity << std::endl;
+      status = EXIT_FAILURE;
+      }
+    }
+  return status;
+}
+
+} // end anonymous namespace
+
+int itkBlockMatchingImageFilterReferenceTest( int, char *[] )
+{
+  IndexType noShift;
+  noShift.Fill( 0 );
+  IndexType shift;
+  shift[0] = 2;
+  shift[1] = 1;
+  shift[2] = 0;
+  ImageType::Pointer fixedImage = MakeImage( noShift );
+  ImageType::Pointer movingImage = MakeImage( shift );
+
+  // textured points, border points, and points in or next to the constant areas
+  const int coordinates[][ Dimension ] = {
+    { 12, 10, 8 }, { 15, 7, 5 }, { 10, 14, 11 },
+    { 9, 0, 0 }, { 16, 19, 15 }, { 11, 1, 14 },
+    { 2, 10, 8 }, { 0, 0, 0 }, { 5, 10, 8 }, { 7, 5, 5 }, { 9, 12, 3 },
+    { 26, 10, 8 }, { 29, 19, 15 }, { 21, 6, 9 }, { 19, 13, 4 } };
+  const unsigned int numberOfPoints = sizeof( coordinates ) / sizeof( coordinates[0] );
+  const bool inConstantMovingBlock[] = {
+    false, false, false,
+    false, false, false,
+    true, true, false, false, false,
+    true, true, false, false };
+
+  PointSetType::Pointer points = PointSetType::New();
+  for ( unsigned int p = 0; p < numberOfPoints; p++ )
+    {
+    PointSetType::PointType point;
+    for ( unsigned int d = 0; d < Dimension; d++ )
+      {
+      point[d] = coordinates[p][d];
+      }
+    points->SetPoint( p, point );
+    }
+
+  // The neighborhood iterators of the reference can only be centered up to
+  // the block radius outside of the image, so the search radius does not
+  // exceed it. The cross term of the small search is summed directly over
+  // the blocks, the one of the large search is computed with FFTs.
+  RadiusType blockRadius;
+  blockRadius[0] = 3;
+  blockRadius[1] = 2;
+  blockRadius[2] = 2;
+  RadiusType searchRadius;
+  searchRadius[0] = 3;
+  searchRadius[1] = 2;
+  searchRadius[2] = 1;
+  int status = CheckMatches( fixedImage, movingImage, points, inConstantMovingBlock, blockRadius, searchRadius );
+
+  blockRadius[0] = 5;
+  blockRadius[1] = 5;
+  blockRadius[2] = 4;
+  searchRadius = blockRadius;
+  const bool inLargeConstantMovingBlock[] = {
+    false, false, false,
+    false, false, false,
+    true, true, false, false, false,
+    false, true, false, false };
+  if ( CheckMatches( fixedImage, movingImage, points, inLargeConstantMovingBlock, blockRadius, searchRadius ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test finished." << std::endl;
+    }
+  else
+    {
+    std::cerr << "Test failed!" << std::endl;
+    }
+  return status;
+}
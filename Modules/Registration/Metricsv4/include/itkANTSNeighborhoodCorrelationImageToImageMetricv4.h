@@ -51,9 +51,11 @@ namespace itk {
  * the evaluation up considerably and works well in practice. This assumption
  * is the main differentiation of this approach from a more generic one.
  *
- * 2) The evaluation uses on-the-fly queues with multi-threading and a sliding
- * neighborhood window. This is described in the above paper and specifically
- * optimized for dense registration.
+ * 2) For dense registration, the neighborhood sums are computed with
+ * multi-threaded separable box sums, so each point of the virtual domain
+ * is evaluated once and the cost does not depend on the radius. With
+ * sampling, the sums are obtained with a scanning neighborhood window as
+ * described in the above paper.
  *
  *  Example of usage:
  *
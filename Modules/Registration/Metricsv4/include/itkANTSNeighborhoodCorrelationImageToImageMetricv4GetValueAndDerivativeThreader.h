@@ -24,6 +24,8 @@
 #include "itkConstNeighborhoodIterator.h"
 
 #include <deque>
+#include <vector>
+#include <algorithm>
 
 namespace itk
 {
@@ -40,10 +42,11 @@ struct IdentityHelper
 
 /** \class ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader
  * \brief Threading implementation for ANTS CC metric \c ANTSNeighborhoodCorrelationImageToImageMetricv4 .
- * Supports both dense and sparse threading ways. The dense threader iterates over the whole image domain
- * in order and use a neighborhood scanning window to compute the local cross correlation metric and
- * its derivative incrementally inside the window. The sparse threader uses a sampled point set partitioner to
- * computer local cross correlation only at the sampled positions.
+ * Supports both dense and sparse threading ways. The dense threader evaluates the images once at each point
+ * of its sub region padded by the radius, and computes the window sums needed by the local cross correlation
+ * metric and its derivative with separable box sums, so its cost does not depend on the radius.
+ * The sparse threader uses a sampled point set partitioner to
+ * computer local cross correlation only at the sampled positions, with a scanning window.
  *
  * This threader class is designed to host the dense and sparse threader under the same name so most computation
  * routine functions and interior member variables can be shared. This eliminates the need to duplicate codes
@@ -101,6 +104,11 @@ public:
   typedef std::deque<QueueRealType>                    SumQueueType;
   typedef ConstNeighborhoodIterator<VirtualImageType>  ScanIteratorType;
 
+  /** Number of window sums used by the local correlation: the number of
+   * valid points, the sums of the fixed and moving values, of their squares,
+   * and of their product, in this order. */
+  itkStaticConstMacro(NumberOfWindowSums, unsigned int, 6);
+
   // one ScanMemType for each thread
   typedef struct ScanMemType {
     // queues used in the scanning
@@ -275,9 +283,23 @@ protected:
     const ScanParametersType &scanParameters,
     const ThreadIdType threadId) const;
 
+  /** Compute the local correlation terms at \c index from the window sums
+   * ordered as described for NumberOfWindowSums. */
+  bool ComputeInformationFromWindowSums(
+    const VirtualIndexType & index, const QueueRealType sums[],
+    ScanMemType &scanMem ) const;
+
+  /** Evaluate the images at every point of \c planeRegion, which is a single
+   * slice along the last dimension, and box sum the values within the plane.
+   * \c planeSums holds NumberOfWindowSums consecutive arrays of the size of
+   * the plane. */
+  void ComputePlaneWindowSums( const ImageRegionType & planeRegion,
+    QueueRealType * planeSums, std::vector< QueueRealType > & scratch ) const;
+
+  /** Compute the local correlation and its derivative from the terms
+   * stored in \c scanMem. */
   void ComputeMovingTransformDerivative(
-    const ScanIteratorType &scanIt, ScanMemType &scanMem,
-    const ScanParametersType &scanParameters, DerivativeType &deriv,
+    ScanMemType &scanMem, DerivativeType &deriv,
     MeasureType &local_cc, const ThreadIdType threadId) const;
 
 private:
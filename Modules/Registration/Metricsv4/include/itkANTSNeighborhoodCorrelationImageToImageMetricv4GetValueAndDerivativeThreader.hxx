@@ -38,36 +38,184 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TD
     itkExceptionMacro("Dynamic casting of associate pointer failed.");
     }
 
-  VirtualPointType     virtualPoint;
-  MeasureType          metricValueResult = NumericTraits< MeasureType >::ZeroValue();
-  MeasureType          metricValueSum = NumericTraits< MeasureType >::ZeroValue();
-  bool                 pointIsValid;
-  ScanIteratorType     scanIt;
-  ScanParametersType   scanParameters;
+  /* The window sums of all the points of the sub region are computed with
+   * separable box sums. The fixed and moving values of each point of the
+   * sub region padded by the radius are evaluated once per plane, i.e. a
+   * slice orthogonal to the last dimension. Each plane is box summed within
+   * itself, and the 2*radius+1 planes covering a window along the last
+   * dimension are kept in a ring. Their sum is updated by adding the plane
+   * entering the window and subtracting the plane leaving it, so the cost
+   * per point does not depend on the radius. */
+  const unsigned int lastDimension = TImageToImageMetric::VirtualImageDimension - 1;
+  const RadiusType radius = this->m_ANTSAssociate->GetRadius();
+  const ImageRegionType & virtualRegion = this->m_ANTSAssociate->GetVirtualRegion();
+
+  ImageRegionType planeRegion = virtualImageSubRegion;
+  planeRegion.PadByRadius( radius );
+  planeRegion.Crop( virtualRegion );
+  const IndexValueType firstPlane = planeRegion.GetIndex( lastDimension );
+  const IndexValueType lastPlane = firstPlane + static_cast< IndexValueType >( planeRegion.GetSize( lastDimension ) ) - 1;
+  planeRegion.SetSize( lastDimension, 1 );
+
+  const SizeValueType numberOfPlanePixels = planeRegion.GetNumberOfPixels();
+  const SizeValueType numberOfRingPlanes = 2 * radius[lastDimension] + 1;
+  std::vector< QueueRealType > ring( numberOfRingPlanes * NumberOfWindowSums * numberOfPlanePixels );
+  std::vector< QueueRealType > window( NumberOfWindowSums * numberOfPlanePixels,
+                                       NumericTraits< QueueRealType >::ZeroValue() );
+  std::vector< QueueRealType > scratch;
+
+  // offset, within a plane, of the first point of the sub region
+  OffsetValueType subRegionPlaneOffset = 0;
+  OffsetValueType planeStride = 1;
+  for( unsigned int d = 0; d < lastDimension; ++d )
+    {
+    subRegionPlaneOffset += ( virtualImageSubRegion.GetIndex( d ) - planeRegion.GetIndex( d ) ) * planeStride;
+    planeStride *= planeRegion.GetSize( d );
+    }
+
+  /* The scan memory is filled by ComputeInformationFromWindowSums at each
+   * valid point, before its use by ComputeMovingTransformDerivative. */
   ScanMemType          scanMem;
 
+  MeasureType          metricValueResult = NumericTraits< MeasureType >::ZeroValue();
+  MeasureType          metricValueSum = NumericTraits< MeasureType >::ZeroValue();
   DerivativeType & localDerivativeResult = this->m_GetValueAndDerivativePerThreadVariables[threadId].LocalDerivatives;
 
-  /* Create an iterator over the virtual sub region */
-  // this->m_ANTSAssociate->InitializeScanning( virtualImageSubRegion, scanIt, scanMem, scanParameters );
-  this->InitializeScanning( virtualImageSubRegion, scanIt, scanMem, scanParameters );
+  IndexValueType lastComputedPlane = firstPlane - 1;
+  IndexValueType windowBeginPlane = firstPlane;
+  const IndexValueType subRegionFirstPlane = virtualImageSubRegion.GetIndex( lastDimension );
+  const IndexValueType subRegionLastPlane = subRegionFirstPlane
+    + static_cast< IndexValueType >( virtualImageSubRegion.GetSize( lastDimension ) ) - 1;
+  for( IndexValueType plane = subRegionFirstPlane; plane <= subRegionLastPlane; ++plane )
+    {
+    const IndexValueType windowFirstPlane = std::max( plane - static_cast< IndexValueType >( radius[lastDimension] ), firstPlane );
+    const IndexValueType windowLastPlane = std::min( plane + static_cast< IndexValueType >( radius[lastDimension] ), lastPlane );
+    /* The leaving planes are subtracted before their place in the ring is
+     * taken by the entering planes. */
+    while( windowBeginPlane < windowFirstPlane )
+      {
+      const QueueRealType * planeSums = &( ring[( ( windowBeginPlane - firstPlane ) % numberOfRingPlanes ) * NumberOfWindowSums * numberOfPlanePixels] );
+      for( SizeValueType i = 0; i < window.size(); ++i )
+        {
+        window[i] -= planeSums[i];
+        }
+      ++windowBeginPlane;
+      }
+    while( lastComputedPlane < windowLastPlane )
+      {
+      ++lastComputedPlane;
+      planeRegion.SetIndex( lastDimension, lastComputedPlane );
+      QueueRealType * planeSums = &( ring[( ( lastComputedPlane - firstPlane ) % numberOfRingPlanes ) * NumberOfWindowSums * numberOfPlanePixels] );
+      this->ComputePlaneWindowSums( planeRegion, planeSums, scratch );
+      for( SizeValueType i = 0; i < window.size(); ++i )
+        {
+        window[i] += planeSums[i];
+        }
+      }
 
-  /* Iterate over the sub region */
-  scanIt.GoToBegin();
-  while (!scanIt.IsAtEnd())
+    /* Iterate over the points of this plane of the sub region */
+    ImageRegionType subRegionPlane = virtualImageSubRegion;
+    subRegionPlane.SetIndex( lastDimension, plane );
+    subRegionPlane.SetSize( lastDimension, 1 );
+    VirtualIndexType index = subRegionPlane.GetIndex();
+    for( SizeValueType n = 0, numberOfPoints = subRegionPlane.GetNumberOfPixels(); n < numberOfPoints; ++n )
+      {
+      OffsetValueType pixelOffset = subRegionPlaneOffset;
+      OffsetValueType stride = 1;
+      for( unsigned int d = 0; d < lastDimension; ++d )
+        {
+        pixelOffset += ( index[d] - subRegionPlane.GetIndex( d ) ) * stride;
+        stride *= planeRegion.GetSize( d );
+        }
+
+      QueueRealType sums[NumberOfWindowSums];
+      for( unsigned int q = 0; q < NumberOfWindowSums; ++q )
+        {
+        sums[q] = window[q * numberOfPlanePixels + pixelOffset];
+        }
+
+      bool pointIsValid = false;
+      try
+        {
+        pointIsValid = this->ComputeInformationFromWindowSums( index, sums, scanMem );
+        if( pointIsValid )
+          {
+          this->ComputeMovingTransformDerivative( scanMem, localDerivativeResult, metricValueResult, threadId );
+          }
+        }
+      catch (ExceptionObject & exc)
+        {
+        //NOTE: there must be a cleaner way to do this:
+        std::string msg("Caught exception: \n");
+        msg += exc.what();
+        ExceptionObject err(__FILE__, __LINE__, msg);
+        throw err;
+        }
+
+      /* Assign the results */
+      if ( pointIsValid )
+        {
+        this->m_GetValueAndDerivativePerThreadVariables[threadId].NumberOfValidPoints++;
+        metricValueSum -= metricValueResult;
+        /* Store the result. This depends on what type of
+         * transform is being used. */
+        if( this->GetComputeDerivative() )
+          {
+          this->StorePointDerivativeResult( index, threadId );
+          }
+        }
+
+      // next index, first dimension fastest
+      for( unsigned int d = 0; d < lastDimension; ++d )
+        {
+        if( ++index[d] < subRegionPlane.GetIndex( d ) + static_cast< IndexValueType >( subRegionPlane.GetSize( d ) ) )
+          {
+          break;
+          }
+        index[d] = subRegionPlane.GetIndex( d );
+        }
+      }
+    }
+
+  /* Store metric value result for this thread. */
+  this->m_GetValueAndDerivativePerThreadVariables[threadId].Measure = metricValueSum;
+}
+
+template < typename TDomainPartitioner, typename TImageToImageMetric, typename TNeighborhoodCorrelationMetric >
+void
+ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TNeighborhoodCorrelationMetric >
+::ComputePlaneWindowSums( const ImageRegionType & planeRegion, QueueRealType * planeSums,
+                          std::vector< QueueRealType > & scratch ) const
+{
+  const unsigned int lastDimension = TImageToImageMetric::VirtualImageDimension - 1;
+  const SizeValueType numberOfPlanePixels = planeRegion.GetNumberOfPixels();
+
+  QueueRealType * count          = planeSums;
+  QueueRealType * sumFixed       = planeSums + numberOfPlanePixels;
+  QueueRealType * sumMoving      = planeSums + 2 * numberOfPlanePixels;
+  QueueRealType * sumFixed2      = planeSums + 3 * numberOfPlanePixels;
+  QueueRealType * sumMoving2     = planeSums + 4 * numberOfPlanePixels;
+  QueueRealType * sumFixedMoving = planeSums + 5 * numberOfPlanePixels;
+
+  /* Evaluate the images once at every point of the plane */
+  VirtualIndexType index = planeRegion.GetIndex();
+  for( SizeValueType n = 0; n < numberOfPlanePixels; ++n )
     {
-    /* Get the virtual point */
-    this->m_ANTSAssociate->TransformVirtualIndexToPhysicalPoint( scanIt.GetIndex(), virtualPoint );
+    VirtualPointType        virtualPoint;
+    FixedImagePointType     mappedFixedPoint;
+    FixedImagePixelType     fixedImageValue;
+    MovingImagePointType    mappedMovingPoint;
+    MovingImagePixelType    movingImageValue;
+    bool pointIsValid;
+
+    this->m_ANTSAssociate->TransformVirtualIndexToPhysicalPoint(index, virtualPoint);
 
-    /* Call the user method in derived classes to do the specific
-     * calculations for value and derivative. */
     try
       {
-      this->UpdateQueues(scanIt, scanMem, scanParameters, threadId);
-      pointIsValid = this->ComputeInformationFromQueues(scanIt, scanMem, scanParameters, threadId);
-      if( pointIsValid )
+      pointIsValid = this->m_ANTSAssociate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, fixedImageValue );
+      if ( pointIsValid )
         {
-        this->ComputeMovingTransformDerivative(scanIt, scanMem, scanParameters, localDerivativeResult, metricValueResult, threadId );
+        pointIsValid = this->m_ANTSAssociate->TransformAndEvaluateMovingPoint( virtualPoint, mappedMovingPoint, movingImageValue );
         }
       }
     catch (ExceptionObject & exc)
@@ -79,25 +227,72 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TD
       throw err;
       }
 
-    /* Assign the results */
     if ( pointIsValid )
       {
-      this->m_GetValueAndDerivativePerThreadVariables[threadId].NumberOfValidPoints++;
-      metricValueSum -= metricValueResult;
-      /* Store the result. This depends on what type of
-       * transform is being used. */
-      if( this->GetComputeDerivative() )
+      count[n]          = NumericTraits<QueueRealType>::OneValue();
+      sumFixed[n]       = fixedImageValue;
+      sumMoving[n]      = movingImageValue;
+      sumFixed2[n]      = fixedImageValue  * fixedImageValue;
+      sumMoving2[n]     = movingImageValue * movingImageValue;
+      sumFixedMoving[n] = fixedImageValue * movingImageValue;
+      }
+    else
+      {
+      count[n] = sumFixed[n] = sumMoving[n] = sumFixed2[n] = sumMoving2[n] = sumFixedMoving[n] =
+        NumericTraits<QueueRealType>::ZeroValue();
+      }
+
+    for( unsigned int d = 0; d < lastDimension; ++d )
+      {
+      if( ++index[d] < planeRegion.GetIndex( d ) + static_cast< IndexValueType >( planeRegion.GetSize( d ) ) )
         {
-        this->StorePointDerivativeResult( scanIt.GetIndex(), threadId );
+        break;
         }
+      index[d] = planeRegion.GetIndex( d );
       }
-
-    //next index
-    ++scanIt;
     }
 
-  /* Store metric value result for this thread. */
-  this->m_GetValueAndDerivativePerThreadVariables[threadId].Measure = metricValueSum;
+  /* Running box sums along each in-plane dimension. Windows are truncated
+   * at the border of the plane, which is cropped to the virtual region. */
+  const RadiusType radius = this->m_ANTSAssociate->GetRadius();
+  SizeValueType stride = 1;
+  for( unsigned int d = 0; d < lastDimension; ++d )
+    {
+    const SizeValueType length = planeRegion.GetSize( d );
+    const SizeValueType numberOfLines = numberOfPlanePixels / length;
+    const OffsetValueType r = static_cast< OffsetValueType >( radius[d] );
+    scratch.resize( length );
+    for( SizeValueType line = 0; line < numberOfLines; ++line )
+      {
+      const SizeValueType lineStart = ( line / stride ) * stride * length + ( line % stride );
+      for( unsigned int q = 0; q < NumberOfWindowSums; ++q )
+        {
+        QueueRealType * values = planeSums + q * numberOfPlanePixels + lineStart;
+        QueueRealType sum = NumericTraits< QueueRealType >::ZeroValue();
+        for( OffsetValueType i = 0; i < std::min( r, static_cast< OffsetValueType >( length ) ); ++i )
+          {
+          sum += values[i * stride];
+          }
+        for( OffsetValueType i = 0; i < static_cast< OffsetValueType >( length ); ++i )
+          {
+          if( i + r < static_cast< OffsetValueType >( length ) )
+            {
+            sum += values[( i + r ) * stride];
+            }
+          if( i - r - 1 >= 0 )
+            {
+            sum -= values[( i - r - 1 ) * stride];
+            }
+          scratch[i] = sum;
+          }
+        for( SizeValueType i = 0; i < length; ++i )
+          {
+          values[i * stride] = scratch[i];
+          }
+        }
+      }
+    stride *= length;
+    }
 }
 
 template < typename TDomainPartitioner, typename TImageToImageMetric, typename TNeighborhoodCorrelationMetric >
@@ -397,6 +592,37 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TD
    ++itFixedMoving;
    }
 
+ QueueRealType sums[NumberOfWindowSums];
+ sums[0] = count;
+ sums[1] = sumFixed;
+ sums[2] = sumMoving;
+ sums[3] = sumFixed2;
+ sums[4] = sumMoving2;
+ sums[5] = sumFixedMoving;
+
+ return this->ComputeInformationFromWindowSums( scanIt.GetIndex(), sums, scanMem );
+}
+
+template < typename TDomainPartitioner, typename TImageToImageMetric, typename TNeighborhoodCorrelationMetric >
+bool
+ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TNeighborhoodCorrelationMetric >
+::ComputeInformationFromWindowSums( const VirtualIndexType & oindex, const QueueRealType sums[], ScanMemType &scanMem ) const
+{
+ typedef InternalComputationValueType LocalRealType;
+
+ const LocalRealType count          = sums[0];
+ const LocalRealType sumFixed       = sums[1];
+ const LocalRealType sumMoving      = sums[2];
+ const LocalRealType sumFixed2      = sums[3];
+ const LocalRealType sumMoving2     = sums[4];
+ const LocalRealType sumFixedMoving = sums[5];
+
+ if (count <= NumericTraits<LocalRealType>::ZeroValue())
+   {
+   // no points available in the window, perhaps out of image region
+   return false;
+   }
+
  LocalRealType fixedMean  = sumFixed  / count;
  LocalRealType movingMean = sumMoving / count;
 
@@ -404,8 +630,6 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TD
  LocalRealType sMovingMoving = sumMoving2 - movingMean * sumMoving - movingMean * sumMoving + count * movingMean * movingMean;
  LocalRealType sFixedMoving  = sumFixedMoving - movingMean * sumFixed - fixedMean * sumMoving + count * movingMean * fixedMean;
 
- typename VirtualImageType::IndexType oindex = scanIt.GetIndex();
-
  VirtualPointType        virtualPoint;
  FixedImagePointType     mappedFixedPoint;
  FixedImagePixelType     fixedImageValue;
@@ -467,7 +691,7 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TD
 template < typename TDomainPartitioner, typename TImageToImageMetric, typename TNeighborhoodCorrelationMetric >
 void
 ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TNeighborhoodCorrelationMetric >
-::ComputeMovingTransformDerivative( const ScanIteratorType &, ScanMemType &scanMem, const ScanParametersType &, DerivativeType &deriv, MeasureType &localCC, const ThreadIdType threadId) const
+::ComputeMovingTransformDerivative( ScanMemType &scanMem, DerivativeType &deriv, MeasureType &localCC, const ThreadIdType threadId) const
 {
   MovingImageGradientType derivWRTImage;
   localCC = NumericTraits<MeasureType>::OneValue();
@@ -569,7 +793,7 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TD
     pointIsValid = this->ComputeInformationFromQueues(scanIt, scanMem, scanParameters, threadId);
     if( pointIsValid )
       {
-      this->ComputeMovingTransformDerivative(scanIt, scanMem, scanParameters, localDerivativeResult, metricValueResult, threadId );
+      this->ComputeMovingTransformDerivative( scanMem, localDerivativeResult, metricValueResult, threadId );
       }
     }
   catch (ExceptionObject & exc)
@@ -20,6 +20,7 @@
 
 #include "itkImageToImageMetricv4.h"
 #include "itkMattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include "itkMattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader.h"
 #include "itkPoint.h"
 #include "itkIndex.h"
 #include "itkBSplineDerivativeKernelFunction.h"
@@ -64,10 +65,10 @@ namespace itk
  * \warning Local-support transforms are not yet supported. If used,
  * an exception is thrown during Initialize().
  *
- * \note The per-iteration post-processing code is not multi-threaded, but could be
- * readily be made so for a small performance gain.
- * See GetValueCommonAfterThreadedExecution(), GetValueAndDerivative()
- * and threader::AfterThreadedExecution().
+ * The per-thread joint PDFs are reduced in parallel over the fixed image
+ * histogram bins, see MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader.
+ * The remaining per-iteration post-processing in ComputeResults() is not
+ * multi-threaded.
  *
  * The algorithm and much of the code was copied from the previous
  * Mattes MI metric, i.e. itkMattesMutualInformationImageToImageMetric.
@@ -201,6 +202,10 @@ protected:
   typedef MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerPartitioner, Superclass, Self >
     MattesMutualInformationSparseGetValueAndDerivativeThreaderType;
 
+  friend class MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader< Self >;
+  typedef MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader< Self >
+    MattesMutualInformationReduceJointPDFThreaderType;
+
   void PrintSelf(std::ostream& os, Indent indent) const ITK_OVERRIDE;
 
   typedef typename JointPDFType::IndexType             JointPDFIndexType;
@@ -222,6 +227,18 @@ protected:
 
   OffsetValueType ComputeSingleFixedImageParzenWindowIndex( const FixedImagePixelType & value ) const;
 
+  /** Compute the weights of the four moving image histogram bins affected
+   * by a single sample with the cubic BSpline Parzen window, and optionally
+   * the weights of its derivative, in one branch-free pass.
+   * \c windowOffset is the distance of the sample from the lowest
+   * bin of the window plus one, i.e. a value in [0,1]. This is equivalent to
+   * evaluating m_CubicBSplineKernel and m_CubicBSplineDerivativeKernel at
+   * -1-windowOffset, -windowOffset, 1-windowOffset and 2-windowOffset.
+   * Pass a null \c derivativeWeights to skip the derivative weights. */
+  void ComputeMovingImageParzenWindowWeights( PDFValueType windowOffset,
+                                              PDFValueType weights[4],
+                                              PDFValueType * derivativeWeights ) const;
+
   /** Variables to define the marginal and joint histograms. */
   SizeValueType m_NumberOfHistogramBins;
   PDFValueType  m_MovingImageNormalizedMin;
@@ -243,8 +260,10 @@ protected:
 
   mutable PRatioArrayType           m_PRatioArray;
 
-  /** Helper array for storing per-parameter linearized index to
-   * retrieve the pRatio during evaluation with local-support transform. */
+  /** Helper array for storing the linearized joint PDF index of each
+   * virtual domain point, to retrieve the pRatio during evaluation with
+   * local-support transform. All the local parameters of a point share the
+   * same index, so it is stored once per point rather than per parameter. */
   mutable std::vector<OffsetValueType>   m_JointPdfIndex1DArray;
 
   /** The moving image marginal PDF. */
@@ -336,6 +355,9 @@ private:
     typename JointPDFDerivativesType::Pointer m_ParentJointPDFDerivatives;
   };
 
+  /** Threader used to reduce the per-thread joint PDFs. */
+  typename MattesMutualInformationReduceJointPDFThreaderType::Pointer m_ReduceJointPDFThreader;
+
   std::vector<DerivativeBufferManager>      m_ThreaderDerivativeManager;
   SimpleFastMutexLock                       m_JointPDFDerivativesLock;
   typename JointPDFDerivativesType::Pointer m_JointPDFDerivatives;
@@ -59,6 +59,7 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
   this->m_SparseGetValueAndDerivativeThreader = MattesMutualInformationSparseGetValueAndDerivativeThreaderType::New();
   this->m_CubicBSplineKernel = CubicBSplineFunctionType::New();
   this->m_CubicBSplineDerivativeKernel = CubicBSplineDerivativeFunctionType::New();
+  this->m_ReduceJointPDFThreader = MattesMutualInformationReduceJointPDFThreaderType::New();
 }
 
 template <typename TFixedImage, typename TMovingImage, typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
@@ -316,16 +317,21 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
     {
     if( this->HasLocalSupport() )
       {
-      for( SizeValueType i = 0, derivativeSize = this->m_DerivativeResult->Size(); i < derivativeSize; ++i )
+      const SizeValueType numberOfLocalParameters = this->GetNumberOfLocalParameters();
+      SizeValueType i = 0;
+      for( SizeValueType point = 0, numberOfPoints = this->m_JointPdfIndex1DArray.size(); point < numberOfPoints; ++point )
         {
-        for( SizeValueType bin = 0; bin < 4; ++bin )
+        // Increment the m_JointPdfIndex1DArray index by bin in order to recover
+        // the pRatio at the moving indecies used for each portion of the derivative.
+        const PRatioType * const pRatioPtr = &( this->m_PRatioArray[this->m_JointPdfIndex1DArray[point]] );
+        for( SizeValueType localParameter = 0; localParameter < numberOfLocalParameters; ++localParameter, ++i )
           {
-          // Increment the m_JointPdfIndex1DArray index by bin in order to recover
-          // the pRatio at the moving indecies used for each portion of the derivative.
-          // Note: in old v3 metric ComputeDerivatives, derivativeContribution is subtracted in global case,
-          // but added in "local" (implicit) case. These operations have been switched to minimize the metric.
-          const SizeValueType pRatioIndex = this->m_JointPdfIndex1DArray[i] + bin;
-          (*(this->m_DerivativeResult))[i] -= m_LocalDerivativeByParzenBin[bin][i] * this->m_PRatioArray[pRatioIndex];
+          for( SizeValueType bin = 0; bin < 4; ++bin )
+            {
+            // Note: in old v3 metric ComputeDerivatives, derivativeContribution is subtracted in global case,
+            // but added in "local" (implicit) case. These operations have been switched to minimize the metric.
+            (*(this->m_DerivativeResult))[i] -= m_LocalDerivativeByParzenBin[bin][i] * pRatioPtr[bin];
+            }
           }
         }
       }
@@ -341,34 +347,14 @@ void
 MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
 ::GetValueCommonAfterThreadedExecution()
 {
-  const ThreadIdType localNumberOfThreadsUsed = this->GetNumberOfThreadsUsed();
-
-  const SizeValueType numberOfVoxels = this->m_NumberOfHistogramBins* this->m_NumberOfHistogramBins;
-  JointPDFValueType * const pdfPtrStart = this->m_ThreaderJointPDF[0]->GetBufferPointer();
-
-  for( unsigned int t = 1; t < localNumberOfThreadsUsed; ++t )
-    {
-    JointPDFValueType *             pdfPtr = pdfPtrStart;
-    JointPDFValueType const *       tPdfPtr = this->m_ThreaderJointPDF[t]->GetBufferPointer();
-    JointPDFValueType const * const tPdfPtrEnd = tPdfPtr + numberOfVoxels;
-    while( tPdfPtr < tPdfPtrEnd )
-      {
-      *( pdfPtr++ ) += *( tPdfPtr++ );
-      }
-    for( SizeValueType i = 0; i < this->m_NumberOfHistogramBins; ++i )
-      {
-      this->m_ThreaderFixedImageMarginalPDF[0][i] += this->m_ThreaderFixedImageMarginalPDF[t][i];
-      }
-    }
-
-  // Sum of this threads domain into the this->m_JointPDFSum that covers that part of the domain.
-  JointPDFValueType const * pdfPtr = pdfPtrStart;
-  CompensatedSummation< PDFValueType > jointPDFSum;
-  for( SizeValueType i = 0; i < numberOfVoxels; ++i )
-    {
-    jointPDFSum += *( pdfPtr++ );
-    }
-  this->m_JointPDFSum = jointPDFSum.GetSum();
+  // Reduce the per-thread joint PDFs and fixed image marginal PDFs into
+  // those of thread 0, in parallel over the fixed image histogram bins.
+  // This also computes this->m_JointPDFSum.
+  typename MattesMutualInformationReduceJointPDFThreaderType::DomainType fixedImageBinRange;
+  fixedImageBinRange[0] = 0;
+  fixedImageBinRange[1] = this->m_NumberOfHistogramBins - 1;
+  this->m_ReduceJointPDFThreader->SetMaximumNumberOfThreads( this->GetMaximumNumberOfThreads() );
+  this->m_ReduceJointPDFThreader->Execute( this, fixedImageBinRange );
 }
 
 
@@ -410,6 +396,43 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
   return pindex;
 }
 
+template <typename TFixedImage, typename TMovingImage, typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+void
+MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::ComputeMovingImageParzenWindowWeights( PDFValueType windowOffset,
+                                         PDFValueType weights[4],
+                                         PDFValueType * derivativeWeights ) const
+{
+  // Guard against round-off at the extreme intensities, where the window
+  // index has been clamped to a valid bin.
+  windowOffset = std::min( std::max( windowOffset, NumericTraits< PDFValueType >::ZeroValue() ),
+                           NumericTraits< PDFValueType >::OneValue() );
+
+  // These are the uniform cubic BSpline basis functions, i.e. the cubic BSpline
+  // kernel evaluated on each of its four polynomial pieces.
+  const PDFValueType t = windowOffset;
+  const PDFValueType t2 = t * t;
+  const PDFValueType t3 = t2 * t;
+  const PDFValueType s = NumericTraits< PDFValueType >::OneValue() - t;
+  const PDFValueType s2 = s * s;
+  const PDFValueType sixth = static_cast< PDFValueType >( 1.0 / 6.0 );
+
+  weights[0] = sixth * s2 * s;
+  weights[1] = sixth * ( static_cast< PDFValueType >( 4.0 ) - static_cast< PDFValueType >( 6.0 ) * t2
+                         + static_cast< PDFValueType >( 3.0 ) * t3 );
+  weights[2] = sixth * ( static_cast< PDFValueType >( 4.0 ) - static_cast< PDFValueType >( 6.0 ) * s2
+                         + static_cast< PDFValueType >( 3.0 ) * s2 * s );
+  weights[3] = sixth * t3;
+
+  if( derivativeWeights != ITK_NULLPTR )
+    {
+    derivativeWeights[0] = static_cast< PDFValueType >( 0.5 ) * s2;
+    derivativeWeights[1] = static_cast< PDFValueType >( 2.0 ) * t - static_cast< PDFValueType >( 1.5 ) * t2;
+    derivativeWeights[2] = static_cast< PDFValueType >( -2.0 ) * s + static_cast< PDFValueType >( 1.5 ) * s2;
+    derivativeWeights[3] = static_cast< PDFValueType >( -0.5 ) * t2;
+    }
+}
+
 template <typename TFixedImage, typename TMovingImage, typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
 void
 MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
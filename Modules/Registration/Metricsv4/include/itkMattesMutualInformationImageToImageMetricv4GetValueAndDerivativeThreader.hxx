@@ -154,7 +154,9 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   if(  this->m_MattesAssociate->GetComputeDerivative() && this->m_MattesAssociate->HasLocalSupport() )
     {
     this->m_MattesAssociate->m_PRatioArray.assign( this->m_MattesAssociate->m_NumberOfHistogramBins * this->m_MattesAssociate->m_NumberOfHistogramBins, 0.0);
-    this->m_MattesAssociate->m_JointPdfIndex1DArray.assign( this->m_MattesAssociate->GetNumberOfParameters(), 0 );
+    // One entry per virtual domain point, shared by all its local parameters.
+    this->m_MattesAssociate->m_JointPdfIndex1DArray.assign(
+      this->m_MattesAssociate->GetNumberOfParameters() / this->GetCachedNumberOfLocalParameters(), 0 );
     // Don't need this with local-support
     this->m_MattesAssociate->m_JointPDFDerivatives = ITK_NULLPTR;
     // This always has four entries because the parzen window size is fixed.
@@ -247,7 +249,7 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
                 const MovingImagePixelType &       movingImageValue,
                 const MovingImageGradientType &    movingImageGradient,
                 MeasureType &,
-                DerivativeType &,
+                DerivativeType &                   localDerivativeReturn,
                 const ThreadIdType                 threadId) const
 {
   const bool doComputeDerivative = this->m_MattesAssociate->GetComputeDerivative();
@@ -284,7 +286,6 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     }
   // Move the pointer to the first affected bin
   OffsetValueType pdfMovingIndex = static_cast<OffsetValueType>( movingImageParzenWindowIndex ) - 1;
-  const OffsetValueType pdfMovingIndexMax = static_cast<OffsetValueType>( movingImageParzenWindowIndex ) + 2;
 
   const OffsetValueType fixedImageParzenWindowIndex = this->m_MattesAssociate->ComputeSingleFixedImageParzenWindowIndex( fixedImageValue );
 
@@ -304,7 +305,12 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     * zero-th (column) dimension and the fixed image bins corresponds
     * to the first (row) dimension.
     */
-  PDFValueType movingImageParzenWindowArg = static_cast<PDFValueType>( pdfMovingIndex ) - static_cast<PDFValueType>( movingImageParzenWindowTerm );
+  PDFValueType parzenWindowWeights[4];
+  PDFValueType parzenWindowDerivativeWeights[4];
+  this->m_MattesAssociate->ComputeMovingImageParzenWindowWeights(
+    movingImageParzenWindowTerm - static_cast<PDFValueType>( movingImageParzenWindowIndex ),
+    parzenWindowWeights,
+    doComputeDerivative ? parzenWindowDerivativeWeights : ITK_NULLPTR );
 
   // Pointer to affected bin to be updated
   JointPDFValueType *pdfPtr = this->m_MattesAssociate->m_ThreaderJointPDF[threadId]->GetBufferPointer()
@@ -318,11 +324,7 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     {
     const OffsetValueType jointPdfIndex1D = pdfMovingIndex + (fixedImageParzenWindowIndex * this->m_MattesAssociate->m_NumberOfHistogramBins);
     localDerivativeOffset = this->m_MattesAssociate->ComputeParameterOffsetFromVirtualIndex( virtualIndex, this->GetCachedNumberOfLocalParameters() );
-    for (NumberOfParametersType i=0, numLocalParameters = this->GetCachedNumberOfLocalParameters();
-      i < numLocalParameters; ++i)
-      {
-      this->m_MattesAssociate->m_JointPdfIndex1DArray[localDerivativeOffset + i] = jointPdfIndex1D;
-      }
+    this->m_MattesAssociate->m_JointPdfIndex1DArray[localDerivativeOffset / this->GetCachedNumberOfLocalParameters()] = jointPdfIndex1D;
     }
 
   // Compute the transform Jacobian.
@@ -337,19 +339,32 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
                                                               jacobianPositional);
     }
 
-  SizeValueType movingParzenBin = 0;
-
   const bool transformIsDisplacement = this->m_MattesAssociate->m_MovingTransform->GetTransformCategory() == MovingTransformType::DisplacementField;
-  while( pdfMovingIndex <= pdfMovingIndexMax )
+
+  // The inner product of the Jacobian and the moving image gradient does
+  // not depend on the Parzen window bin, so compute it once per point.
+  // The local derivative container of this thread is unused otherwise.
+  const NumberOfParametersType numberOfLocalParameters = this->GetCachedNumberOfLocalParameters();
+  if( doComputeDerivative && !transformIsDisplacement )
+    {
+    for( NumberOfParametersType mu = 0; mu < numberOfLocalParameters; ++mu )
+      {
+      PDFValueType innerProduct = 0.0;
+      for( SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim )
+        {
+        innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+        }
+      localDerivativeReturn[mu] = innerProduct;
+      }
+    }
+
+  for( SizeValueType movingParzenBin = 0; movingParzenBin < 4; ++movingParzenBin, ++pdfMovingIndex )
     {
-    const PDFValueType val = static_cast<PDFValueType>( this->m_MattesAssociate->m_CubicBSplineKernel ->Evaluate( movingImageParzenWindowArg) );
-    *( pdfPtr++ ) += val;
+    *( pdfPtr++ ) += parzenWindowWeights[movingParzenBin];
 
     if( doComputeDerivative )
       {
-      // Compute the cubicBSplineDerivative for later repeated use.
-      const PDFValueType cubicBSplineDerivativeValue = this->m_MattesAssociate->m_CubicBSplineDerivativeKernel->Evaluate(movingImageParzenWindowArg);
-
+      const PDFValueType cubicBSplineDerivativeValue = parzenWindowDerivativeWeights[movingParzenBin];
 
       if( transformIsDisplacement )
         {
@@ -375,25 +390,13 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
 
         PDFValueType * derivativeContributionPtr =
           this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].GetNextElementAndAddOffset(ThisIndexOffset);
-        for( NumberOfParametersType mu = 0, maxElement = this->GetCachedNumberOfLocalParameters(); mu < maxElement;
-             ++mu )
+        for( NumberOfParametersType mu = 0; mu < numberOfLocalParameters; ++mu )
           {
-          PDFValueType innerProduct = 0.0;
-          for( SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim )
-            {
-            innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
-            }
-
-          *(derivativeContributionPtr) = innerProduct * cubicBSplineDerivativeValue;
-          ++derivativeContributionPtr;
+          derivativeContributionPtr[mu] = localDerivativeReturn[mu] * cubicBSplineDerivativeValue;
           }
         this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].CheckAndReduceIfNecessary();
         }
       }
-
-    movingImageParzenWindowArg += 1.0;
-    ++pdfMovingIndex;
-    ++movingParzenBin;
     }
 
   // have to do this here since we're returning false
@@ -443,34 +446,11 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
 
   /* Porting: This code is from
    * MattesMutualInformationImageToImageMetric::GetValueAndDerivativeThreadPostProcess */
-  /* Post-processing that is common the GetValue and GetValueAndDerivative */
+  /* Post-processing that is common the GetValue and GetValueAndDerivative.
+   * This also applies the normalization factor to the joint PDF derivatives
+   * of global-support transforms. */
   this->m_MattesAssociate->GetValueCommonAfterThreadedExecution();
 
-  if( this->m_MattesAssociate->GetComputeDerivative() && ( !this->m_MattesAssociate->HasLocalSupport() ) )
-    {
-    // This entire block of code is used to accumulate the per-thread buffers
-    // into 1 thread.
-    // For this thread, how many histogram elements are there?
-    const NumberOfParametersType rowSize = this->GetCachedNumberOfLocalParameters()
-      * this->m_MattesAssociate->m_NumberOfHistogramBins;
-    const SizeValueType histogramTotalElementsSize = rowSize
-      * this->m_MattesAssociate->m_NumberOfHistogramBins;
-
-    // NOTE:  Negative 1 so that accumulators can all be positive accumulators
-    const PDFValueType nFactor = -1.0
-      / ( this->m_MattesAssociate->m_MovingImageBinSize * this->m_MattesAssociate->GetNumberOfValidPoints() );
-
-    JointPDFDerivativesValueType *const accumulatorPdfDPtrStart =
-      this->m_MattesAssociate->m_JointPDFDerivatives->GetBufferPointer();
-    JointPDFDerivativesValueType *             accumulatorPdfDPtr = accumulatorPdfDPtrStart;
-    JointPDFDerivativesValueType const * const tempThreadPdfDPtrEnd = accumulatorPdfDPtrStart
-      + histogramTotalElementsSize;
-    while( accumulatorPdfDPtr < tempThreadPdfDPtrEnd )
-      {
-      *( accumulatorPdfDPtr++ ) *= nFactor;
-      }
-    }
-
   // Collect and compute results.
   // Value and derivative are stored in member vars.
   this->m_MattesAssociate->ComputeResults();
@@ -0,0 +1,109 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader_h
+#define itkMattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+#include "itkCompensatedSummation.h"
+#include "itkMath.h"
+
+namespace itk
+{
+
+/** \class MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader
+ * \brief Reduces the per-thread joint PDFs of
+ * MattesMutualInformationImageToImageMetricv4 in parallel.
+ *
+ * The domain is the range of fixed image histogram bins, i.e. the rows of
+ * the joint PDF. Each thread sums the rows it owns over all the per-thread
+ * joint PDF images and fixed image marginal PDFs into the ones of thread 0,
+ * so the reduction no longer walks the thread buffers one after another.
+ * The partial sums of the joint PDF are accumulated per thread and combined
+ * in AfterThreadedExecution().
+ *
+ * When derivatives of a global-support transform are requested, the rows of
+ * the joint PDF derivatives are also scaled by the normalization factor.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template < typename TMattesMutualInformationMetric >
+class MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TMattesMutualInformationMetric >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader                    Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TMattesMutualInformationMetric > Superclass;
+  typedef SmartPointer< Self >                                                                  Pointer;
+  typedef SmartPointer< const Self >                                                            ConstPointer;
+
+  itkTypeMacro( MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef typename TMattesMutualInformationMetric::PDFValueType                 PDFValueType;
+  typedef typename TMattesMutualInformationMetric::JointPDFValueType            JointPDFValueType;
+  typedef typename TMattesMutualInformationMetric::JointPDFDerivativesValueType JointPDFDerivativesValueType;
+
+protected:
+  MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader();
+  virtual ~MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader();
+
+  /** Allocate the per-thread partial sums. */
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  /** Reduce the rows of the joint PDF in \c subdomain. */
+  virtual void ThreadedExecution( const DomainType & subdomain,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  /** Collect the partial sums into the associate's m_JointPDFSum. */
+  virtual void AfterThreadedExecution() ITK_OVERRIDE;
+
+private:
+  MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  struct ReduceJointPDFPerThreadStruct
+    {
+    CompensatedSummation< PDFValueType > JointPDFSum;
+    };
+  itkPadStruct( ITK_CACHE_LINE_ALIGNMENT, ReduceJointPDFPerThreadStruct,
+                                            PaddedReduceJointPDFPerThreadStruct);
+  itkAlignedTypedef( ITK_CACHE_LINE_ALIGNMENT, PaddedReduceJointPDFPerThreadStruct,
+                                               AlignedReduceJointPDFPerThreadStruct );
+  AlignedReduceJointPDFPerThreadStruct * m_ReduceJointPDFPerThreadVariables;
+
+  /** Number of per-thread buffers filled by the metric threader. */
+  ThreadIdType m_NumberOfBuffersToReduce;
+
+  /** Scale applied to the joint PDF derivatives, zero when they are not
+   * reduced by this threader. */
+  PDFValueType m_JointPDFDerivativesScale;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader.hxx"
+#endif
+
+#endif
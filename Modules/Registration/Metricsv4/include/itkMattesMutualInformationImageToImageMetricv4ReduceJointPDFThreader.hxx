@@ -0,0 +1,126 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader_hxx
+#define itkMattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader_hxx
+
+#include "itkMattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader.h"
+
+namespace itk
+{
+
+template< typename TMattesMutualInformationMetric >
+MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader< TMattesMutualInformationMetric >
+::MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader() :
+  m_ReduceJointPDFPerThreadVariables( ITK_NULLPTR ),
+  m_NumberOfBuffersToReduce( 0 ),
+  m_JointPDFDerivativesScale( 0.0 )
+{}
+
+template< typename TMattesMutualInformationMetric >
+MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader< TMattesMutualInformationMetric >
+::~MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader()
+{
+  delete[] this->m_ReduceJointPDFPerThreadVariables;
+}
+
+template< typename TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader< TMattesMutualInformationMetric >
+::BeforeThreadedExecution()
+{
+  const ThreadIdType numThreadsUsed = this->GetNumberOfThreadsUsed();
+  delete[] this->m_ReduceJointPDFPerThreadVariables;
+  this->m_ReduceJointPDFPerThreadVariables = new AlignedReduceJointPDFPerThreadStruct[ numThreadsUsed ];
+
+  this->m_NumberOfBuffersToReduce = this->m_Associate->GetNumberOfThreadsUsed();
+
+  this->m_JointPDFDerivativesScale = NumericTraits< PDFValueType >::ZeroValue();
+  if( this->m_Associate->GetComputeDerivative() && ( !this->m_Associate->HasLocalSupport() ) )
+    {
+    // NOTE:  Negative 1 so that accumulators can all be positive accumulators
+    this->m_JointPDFDerivativesScale = -1.0
+      / ( this->m_Associate->m_MovingImageBinSize * this->m_Associate->GetNumberOfValidPoints() );
+    }
+}
+
+template< typename TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader< TMattesMutualInformationMetric >
+::ThreadedExecution( const DomainType & subdomain, const ThreadIdType threadId )
+{
+  const SizeValueType numberOfBins = this->m_Associate->m_NumberOfHistogramBins;
+  const SizeValueType rowBegin = subdomain[0];
+  const SizeValueType rowEnd = subdomain[1] + 1;
+  const SizeValueType rowOffset = rowBegin * numberOfBins;
+  const SizeValueType numberOfElements = ( rowEnd - rowBegin ) * numberOfBins;
+
+  JointPDFValueType * const pdfPtrStart = this->m_Associate->m_ThreaderJointPDF[0]->GetBufferPointer() + rowOffset;
+  std::vector<PDFValueType> & fixedMarginalPDF = this->m_Associate->m_ThreaderFixedImageMarginalPDF[0];
+
+  for( ThreadIdType t = 1; t < this->m_NumberOfBuffersToReduce; ++t )
+    {
+    JointPDFValueType *             pdfPtr = pdfPtrStart;
+    JointPDFValueType const *       tPdfPtr = this->m_Associate->m_ThreaderJointPDF[t]->GetBufferPointer() + rowOffset;
+    JointPDFValueType const * const tPdfPtrEnd = tPdfPtr + numberOfElements;
+    while( tPdfPtr < tPdfPtrEnd )
+      {
+      *( pdfPtr++ ) += *( tPdfPtr++ );
+      }
+    const std::vector<PDFValueType> & tFixedMarginalPDF = this->m_Associate->m_ThreaderFixedImageMarginalPDF[t];
+    for( SizeValueType i = rowBegin; i < rowEnd; ++i )
+      {
+      fixedMarginalPDF[i] += tFixedMarginalPDF[i];
+      }
+    }
+
+  CompensatedSummation< PDFValueType > & jointPDFSum = this->m_ReduceJointPDFPerThreadVariables[threadId].JointPDFSum;
+  JointPDFValueType const * pdfPtr = pdfPtrStart;
+  for( SizeValueType i = 0; i < numberOfElements; ++i )
+    {
+    jointPDFSum += *( pdfPtr++ );
+    }
+
+  if( Math::NotExactlyEquals( this->m_JointPDFDerivativesScale, NumericTraits< PDFValueType >::ZeroValue() ) )
+    {
+    const SizeValueType rowSize = this->m_Associate->m_JointPDFDerivatives->GetOffsetTable()[2];
+    JointPDFDerivativesValueType *             derivPtr = this->m_Associate->m_JointPDFDerivatives->GetBufferPointer()
+      + rowBegin * rowSize;
+    JointPDFDerivativesValueType const * const derivPtrEnd = derivPtr + ( rowEnd - rowBegin ) * rowSize;
+    while( derivPtr < derivPtrEnd )
+      {
+      *( derivPtr++ ) *= this->m_JointPDFDerivativesScale;
+      }
+    }
+}
+
+template< typename TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4ReduceJointPDFThreader< TMattesMutualInformationMetric >
+::AfterThreadedExecution()
+{
+  CompensatedSummation< PDFValueType > jointPDFSum;
+  for( ThreadIdType threadId = 0; threadId < this->GetNumberOfThreadsUsed(); ++threadId )
+    {
+    jointPDFSum += this->m_ReduceJointPDFPerThreadVariables[threadId].JointPDFSum.GetSum();
+    }
+  this->m_Associate->m_JointPDFSum = jointPDFSum.GetSum();
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,357 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkANTSNeighborhoodCorrelationImageToImageMetricv4.h"
+#include "itkTranslationTransform.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkCentralDifferenceImageFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+/**
+ *  This test checks the value and derivative of the ANTS neighborhood
+ *  correlation metric computed with one and several threads, and against a
+ *  reference that scans the whole neighborhood of every point, as the metric
+ *  did before it used box sums. The neighborhoods are truncated at the border
+ *  of the virtual domain, and the transforms map part of the domain outside
+ *  the moving image, so the windows near the borders have fewer valid points.
+ */
+
+namespace
+{
+
+const unsigned int Dimension = 3;
+typedef itk::Image< double, Dimension >   ImageType;
+typedef itk::Array< double >              DerivativeType;
+
+ImageType::Pointer
+itkANTSNeighborhoodCorrelationImageToImageMetricv4ThreadsTestCreateImage( const double shiftX, const double shiftZ )
+{
+  ImageType::SizeType size;
+  size[0] = 20;
+  size[1] = 17;
+  size[2] = 14;
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 1.5;
+  spacing[2] = 2.0;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetSpacing( spacing );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+    const double x = point[0] - shiftX;
+    const double y = point[1];
+    const double z = point[2] - shiftZ;
+    it.Set( 100.0 + 40.0 * std::sin( x / 3.0 ) * std::cos( y / 4.0 ) + 30.0 * std::sin( z / 5.0 + x / 7.0 ) );
+    }
+  return image;
+}
+
+/** Evaluation of the metric value and derivative by a scan of the
+ *  neighborhood of every point. */
+template< typename TTransform >
+void
+itkANTSNeighborhoodCorrelationImageToImageMetricv4ThreadsTestReference( const ImageType * fixedImage,
+                                                                         const ImageType * movingImage,
+                                                                         const TTransform * transform,
+                                                                         const ImageType::SizeType & radius,
+                                                                         double & value,
+                                                                         DerivativeType & derivative )
+{
+  typedef itk::LinearInterpolateImageFunction< ImageType, double >  InterpolatorType;
+  typedef itk::CentralDifferenceImageFunction< ImageType, double >  GradientCalculatorType;
+  typedef typename TTransform::JacobianType                          JacobianType;
+
+  InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  interpolator->SetInputImage( movingImage );
+  GradientCalculatorType::Pointer gradientCalculator = GradientCalculatorType::New();
+  gradientCalculator->UseImageDirectionOn();
+  gradientCalculator->SetInputImage( movingImage );
+
+  const ImageType::RegionType region = fixedImage->GetLargestPossibleRegion();
+  const bool localSupport = transform->GetTransformCategory() == TTransform::DisplacementField;
+  const unsigned int numberOfLocalParameters = transform->GetNumberOfLocalParameters();
+
+  // Moving image values, and whether they are valid, at every virtual point
+  std::vector< double > movingValues( region.GetNumberOfPixels(), 0.0 );
+  std::vector< bool >   valid( region.GetNumberOfPixels(), false );
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( fixedImage, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    ImageType::PointType virtualPoint;
+    fixedImage->TransformIndexToPhysicalPoint( it.GetIndex(), virtualPoint );
+    const ImageType::PointType movingPoint = transform->TransformPoint( virtualPoint );
+    const itk::OffsetValueType offset = fixedImage->ComputeOffset( it.GetIndex() );
+    valid[offset] = interpolator->IsInsideBuffer( movingPoint );
+    if( valid[offset] )
+      {
+      movingValues[offset] = interpolator->Evaluate( movingPoint );
+      }
+    }
+
+  derivative.SetSize( transform->GetNumberOfParameters() );
+  derivative.Fill( 0.0 );
+  double sum = 0.0;
+  itk::SizeValueType numberOfValidPoints = 0;
+  JacobianType jacobian;
+  const double epsilon = itk::NumericTraits< double >::epsilon();
+
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    const itk::OffsetValueType centerOffset = fixedImage->ComputeOffset( index );
+    if( !valid[centerOffset] )
+      {
+      continue;
+      }
+
+    ImageType::RegionType window;
+    for( unsigned int d = 0; d < Dimension; ++d )
+      {
+      window.SetIndex( d, index[d] - static_cast< itk::OffsetValueType >( radius[d] ) );
+      window.SetSize( d, 2 * radius[d] + 1 );
+      }
+    window.Crop( region );
+
+    double count = 0.0;
+    double sumFixed = 0.0;
+    double sumMoving = 0.0;
+    double sumFixed2 = 0.0;
+    double sumMoving2 = 0.0;
+    double sumFixedMoving = 0.0;
+    itk::ImageRegionConstIteratorWithIndex< ImageType > wit( fixedImage, window );
+    for( wit.GoToBegin(); !wit.IsAtEnd(); ++wit )
+      {
+      const itk::OffsetValueType offset = fixedImage->ComputeOffset( wit.GetIndex() );
+      if( !valid[offset] )
+        {
+        continue;
+        }
+      const double f = wit.Get();
+      const double m = movingValues[offset];
+      count += 1.0;
+      sumFixed += f;
+      sumMoving += m;
+      sumFixed2 += f * f;
+      sumMoving2 += m * m;
+      sumFixedMoving += f * m;
+      }
+
+    const double fixedMean = sumFixed / count;
+    const double movingMean = sumMoving / count;
+    const double sFixedFixed = sumFixed2 - 2.0 * fixedMean * sumFixed + count * fixedMean * fixedMean;
+    const double sMovingMoving = sumMoving2 - 2.0 * movingMean * sumMoving + count * movingMean * movingMean;
+    const double sFixedMoving = sumFixedMoving - movingMean * sumFixed - fixedMean * sumMoving
+      + count * movingMean * fixedMean;
+    const double sFixedFixed_sMovingMoving = sFixedFixed * sMovingMoving;
+
+    double localCC = 1.0;
+    if( std::fabs( sFixedFixed_sMovingMoving ) > epsilon )
+      {
+      localCC = sFixedMoving * sFixedMoving / sFixedFixed_sMovingMoving;
+      }
+    sum -= localCC;
+    ++numberOfValidPoints;
+
+    if( !( sFixedFixed > epsilon && sMovingMoving > epsilon ) )
+      {
+      continue;
+      }
+
+    ImageType::PointType virtualPoint;
+    fixedImage->TransformIndexToPhysicalPoint( index, virtualPoint );
+    const GradientCalculatorType::OutputType movingGradient =
+      gradientCalculator->Evaluate( transform->TransformPoint( virtualPoint ) );
+    const double fixedA = it.Get() - fixedMean;
+    const double movingA = movingValues[centerOffset] - movingMean;
+
+    double derivativeWRTImage[Dimension];
+    for( unsigned int d = 0; d < Dimension; ++d )
+      {
+      derivativeWRTImage[d] = 2.0 * sFixedMoving / sFixedFixed_sMovingMoving
+        * ( fixedA - sFixedMoving / sMovingMoving * movingA ) * movingGradient[d];
+      }
+
+    transform->ComputeJacobianWithRespectToParameters( virtualPoint, jacobian );
+    const itk::SizeValueType parameterOffset = localSupport ? centerOffset * numberOfLocalParameters : 0;
+    for( unsigned int par = 0; par < numberOfLocalParameters; ++par )
+      {
+      double pointDerivative = 0.0;
+      for( unsigned int d = 0; d < Dimension; ++d )
+        {
+        pointDerivative += derivativeWRTImage[d] * jacobian( d, par );
+        }
+      derivative[parameterOffset + par] += pointDerivative;
+      }
+    }
+
+  value = sum / numberOfValidPoints;
+  if( !localSupport )
+    {
+    derivative /= numberOfValidPoints;
+    }
+}
+
+template< typename TTransform >
+bool
+itkANTSNeighborhoodCorrelationImageToImageMetricv4ThreadsTestRun( const ImageType * fixedImage,
+                                                                   const ImageType * movingImage,
+                                                                   TTransform * transform,
+                                                                   const ImageType::SizeType & radius,
+                                                                   const char * name )
+{
+  typedef itk::ANTSNeighborhoodCorrelationImageToImageMetricv4< ImageType, ImageType > MetricType;
+
+  double referenceValue;
+  DerivativeType referenceDerivative;
+  itkANTSNeighborhoodCorrelationImageToImageMetricv4ThreadsTestReference( fixedImage, movingImage, transform,
+                                                                           radius, referenceValue,
+                                                                           referenceDerivative );
+  const double referenceDerivativeMagnitude = referenceDerivative.inf_norm();
+
+  double singleThreadValue = 0.0;
+  DerivativeType singleThreadDerivative;
+  bool passed = true;
+
+  for( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 8; ++numberOfThreads )
+    {
+    typename MetricType::Pointer metric = MetricType::New();
+    metric->SetFixedImage( fixedImage );
+    metric->SetMovingImage( movingImage );
+    metric->SetMovingTransform( transform );
+    metric->SetRadius( radius );
+    metric->SetUseMovingImageGradientFilter( false );
+    metric->SetUseFixedImageGradientFilter( false );
+    metric->SetMaximumNumberOfThreads( numberOfThreads );
+    metric->Initialize();
+
+    typename MetricType::MeasureType value;
+    typename MetricType::DerivativeType derivative;
+    metric->GetValueAndDerivative( value, derivative );
+
+    if( numberOfThreads == 1 )
+      {
+      singleThreadValue = value;
+      singleThreadDerivative = derivative;
+      }
+
+    // The window sums are accumulated in a different order, so only rounding
+    // differences are allowed.
+    const double valueTolerance = 1e-9 * std::abs( referenceValue );
+    const double derivativeTolerance = 1e-7 * referenceDerivativeMagnitude;
+
+    if( std::abs( value - referenceValue ) > valueTolerance
+        || std::abs( value - singleThreadValue ) > valueTolerance )
+      {
+      std::cerr << name << " with " << numberOfThreads << " threads: value " << value
+                << " instead of " << referenceValue << " (reference) and "
+                << singleThreadValue << " (1 thread)" << std::endl;
+      passed = false;
+      }
+    if( derivative.GetSize() != referenceDerivative.GetSize() )
+      {
+      std::cerr << name << " with " << numberOfThreads << " threads: derivative has "
+                << derivative.GetSize() << " elements instead of " << referenceDerivative.GetSize() << std::endl;
+      passed = false;
+      continue;
+      }
+    for( unsigned int i = 0; i < derivative.GetSize(); ++i )
+      {
+      if( std::abs( derivative[i] - referenceDerivative[i] ) > derivativeTolerance
+          || std::abs( derivative[i] - singleThreadDerivative[i] ) > derivativeTolerance )
+        {
+        std::cerr << name << " with " << numberOfThreads << " threads: derivative[" << i << "] "
+                  << derivative[i] << " instead of " << referenceDerivative[i] << " (reference) and "
+                  << singleThreadDerivative[i] << " (1 thread)" << std::endl;
+        passed = false;
+        break;
+        }
+      }
+    }
+
+  std::cout << name << ": value " << referenceValue << ", derivative magnitude "
+            << referenceDerivativeMagnitude << std::endl;
+  return passed;
+}
+
+} // end anonymous namespace
+
+int itkANTSNeighborhoodCorrelationImageToImageMetricv4ThreadsTest( int, char *[] )
+{
+  ImageType::Pointer fixedImage = itkANTSNeighborhoodCorrelationImageToImageMetricv4ThreadsTestCreateImage( 0.0, 0.0 );
+  ImageType::Pointer movingImage = itkANTSNeighborhoodCorrelationImageToImageMetricv4ThreadsTestCreateImage( 1.5, -3.0 );
+
+  ImageType::SizeType radius;
+  radius[0] = 2;
+  radius[1] = 1;
+  radius[2] = 3;
+
+  bool passed = true;
+
+  typedef itk::TranslationTransform< double, Dimension > TranslationTransformType;
+  TranslationTransformType::Pointer translation = TranslationTransformType::New();
+  TranslationTransformType::OutputVectorType offset;
+  offset[0] = 2.3;
+  offset[1] = -0.4;
+  offset[2] = -3.5;
+  translation->Translate( offset );
+  passed &= itkANTSNeighborhoodCorrelationImageToImageMetricv4ThreadsTestRun( fixedImage.GetPointer(),
+                                                                              movingImage.GetPointer(),
+                                                                              translation.GetPointer(),
+                                                                              radius, "Translation" );
+
+  typedef itk::DisplacementFieldTransform< double, Dimension > DisplacementTransformType;
+  typedef DisplacementTransformType::DisplacementFieldType     FieldType;
+  FieldType::Pointer field = FieldType::New();
+  field->CopyInformation( fixedImage );
+  field->SetRegions( fixedImage->GetLargestPossibleRegion() );
+  field->Allocate();
+  itk::ImageRegionIteratorWithIndex< FieldType > fieldIt( field, field->GetLargestPossibleRegion() );
+  for( fieldIt.GoToBegin(); !fieldIt.IsAtEnd(); ++fieldIt )
+    {
+    FieldType::PointType point;
+    field->TransformIndexToPhysicalPoint( fieldIt.GetIndex(), point );
+    FieldType::PixelType displacement;
+    displacement[0] = 1.5 + std::sin( point[2] / 6.0 );
+    displacement[1] = 0.5 * std::cos( point[0] / 5.0 );
+    displacement[2] = -2.5 + std::sin( point[1] / 4.0 );
+    fieldIt.Set( displacement );
+    }
+  DisplacementTransformType::Pointer displacementTransform = DisplacementTransformType::New();
+  displacementTransform->SetDisplacementField( field );
+  passed &= itkANTSNeighborhoodCorrelationImageToImageMetricv4ThreadsTestRun( fixedImage.GetPointer(),
+                                                                              movingImage.GetPointer(),
+                                                                              displacementTransform.GetPointer(),
+                                                                              radius, "Displacement field" );
+
+  if( !passed )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,403 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkTranslationTransform.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkCentralDifferenceImageFunction.h"
+#include "itkBSplineKernelFunction.h"
+#include "itkBSplineDerivativeKernelFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+/**
+ *  This test checks the value and derivative of the Mattes mutual information
+ *  metric computed with one and several threads, and against a serial
+ *  evaluation that uses the cubic BSpline kernels one sample and one bin at a
+ *  time, as the metric did before its Parzen window weights were computed in
+ *  closed form and its joint PDFs were reduced in parallel.
+ *
+ *  Both a global-support (translation) and a local-support (displacement
+ *  field) transform are used, mapping part of the fixed image outside the
+ *  moving image.
+ */
+
+namespace
+{
+
+const unsigned int Dimension = 2;
+typedef itk::Image< double, Dimension >   ImageType;
+typedef itk::Array< double >              DerivativeType;
+
+ImageType::Pointer
+itkMattesMutualInformationImageToImageMetricv4ThreadsTestCreateImage( const double shiftX, const double shiftY )
+{
+  ImageType::SizeType size;
+  size[0] = 48;
+  size[1] = 40;
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.5;
+  spacing[1] = 1.0;
+
+  ImageType::PointType origin;
+  origin[0] = -3.0;
+  origin[1] = 2.0;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetSpacing( spacing );
+  image->SetOrigin( origin );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+    const double x = point[0] - shiftX;
+    const double y = point[1] - shiftY;
+    it.Set( 100.0 + 50.0 * std::sin( x / 7.0 ) * std::cos( y / 5.0 ) + 0.5 * x );
+    }
+  return image;
+}
+
+/** Serial per-sample evaluation of the metric value and derivative. */
+template< typename TTransform >
+void
+itkMattesMutualInformationImageToImageMetricv4ThreadsTestReference( const ImageType * fixedImage,
+                                                                     const ImageType * movingImage,
+                                                                     const TTransform * transform,
+                                                                     const unsigned int numberOfBins,
+                                                                     double & value,
+                                                                     DerivativeType & derivative )
+{
+  typedef itk::BSplineKernelFunction< 3, double >                        KernelType;
+  typedef itk::BSplineDerivativeKernelFunction< 3, double >              DerivativeKernelType;
+  typedef itk::LinearInterpolateImageFunction< ImageType, double >       InterpolatorType;
+  typedef itk::CentralDifferenceImageFunction< ImageType, double >       GradientCalculatorType;
+  typedef typename TTransform::JacobianType                               JacobianType;
+
+  typename KernelType::Pointer kernel = KernelType::New();
+  typename DerivativeKernelType::Pointer derivativeKernel = DerivativeKernelType::New();
+  InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  interpolator->SetInputImage( movingImage );
+  GradientCalculatorType::Pointer gradientCalculator = GradientCalculatorType::New();
+  gradientCalculator->UseImageDirectionOn();
+  gradientCalculator->SetInputImage( movingImage );
+
+  double fixedMin = itk::NumericTraits< double >::max();
+  double fixedMax = itk::NumericTraits< double >::NonpositiveMin();
+  itk::ImageRegionConstIteratorWithIndex< ImageType > fi( fixedImage, fixedImage->GetBufferedRegion() );
+  for( fi.GoToBegin(); !fi.IsAtEnd(); ++fi )
+    {
+    fixedMin = std::min( fixedMin, fi.Get() );
+    fixedMax = std::max( fixedMax, fi.Get() );
+    }
+  double movingMin = itk::NumericTraits< double >::max();
+  double movingMax = itk::NumericTraits< double >::NonpositiveMin();
+  itk::ImageRegionConstIteratorWithIndex< ImageType > mi( movingImage, movingImage->GetBufferedRegion() );
+  for( mi.GoToBegin(); !mi.IsAtEnd(); ++mi )
+    {
+    movingMin = std::min( movingMin, mi.Get() );
+    movingMax = std::max( movingMax, mi.Get() );
+    }
+
+  const double fixedBinSize = ( fixedMax - fixedMin ) / ( numberOfBins - 4 );
+  const double fixedNormalizedMin = fixedMin / fixedBinSize - 2.0;
+  const double movingBinSize = ( movingMax - movingMin ) / ( numberOfBins - 4 );
+  const double movingNormalizedMin = movingMin / movingBinSize - 2.0;
+  const long lastBin = static_cast< long >( numberOfBins ) - 3;
+
+  const bool localSupport = transform->GetTransformCategory() == TTransform::DisplacementField;
+  const unsigned int numberOfLocalParameters = transform->GetNumberOfLocalParameters();
+
+  std::vector< double > jointPDF( numberOfBins * numberOfBins, 0.0 );
+  std::vector< double > fixedMarginalPDF( numberOfBins, 0.0 );
+  std::vector< double > jointPDFDerivatives;
+  if( !localSupport )
+    {
+    jointPDFDerivatives.assign( numberOfBins * numberOfBins * numberOfLocalParameters, 0.0 );
+    }
+  // Local-support contributions, four Parzen bins per parameter of each sample
+  std::vector< itk::SizeValueType > sampleParameterOffsets;
+  std::vector< itk::SizeValueType > sampleJointPDFIndices;
+  std::vector< double >             sampleContributions;
+
+  itk::SizeValueType numberOfValidPoints = 0;
+  JacobianType jacobian;
+
+  for( fi.GoToBegin(); !fi.IsAtEnd(); ++fi )
+    {
+    ImageType::PointType virtualPoint;
+    fixedImage->TransformIndexToPhysicalPoint( fi.GetIndex(), virtualPoint );
+    const ImageType::PointType movingPoint = transform->TransformPoint( virtualPoint );
+    if( !interpolator->IsInsideBuffer( movingPoint ) )
+      {
+      continue;
+      }
+    const double fixedValue = fi.Get();
+    const double movingValue = interpolator->Evaluate( movingPoint );
+    const GradientCalculatorType::OutputType movingGradient = gradientCalculator->Evaluate( movingPoint );
+
+    const double movingTerm = movingValue / movingBinSize - movingNormalizedMin;
+    const long movingIndex = std::min( std::max( static_cast< long >( movingTerm ), 2L ), lastBin );
+    const double fixedTerm = fixedValue / fixedBinSize - fixedNormalizedMin;
+    const long fixedIndex = std::min( std::max( static_cast< long >( fixedTerm ), 2L ), lastBin );
+
+    fixedMarginalPDF[fixedIndex] += 1.0;
+
+    transform->ComputeJacobianWithRespectToParameters( virtualPoint, jacobian );
+    std::vector< double > innerProducts( numberOfLocalParameters, 0.0 );
+    for( unsigned int mu = 0; mu < numberOfLocalParameters; ++mu )
+      {
+      for( unsigned int dim = 0; dim < Dimension; ++dim )
+        {
+        innerProducts[mu] += jacobian[dim][mu] * movingGradient[dim];
+        }
+      }
+
+    if( localSupport )
+      {
+      sampleParameterOffsets.push_back( fixedImage->ComputeOffset( fi.GetIndex() ) * numberOfLocalParameters );
+      sampleJointPDFIndices.push_back( fixedIndex * numberOfBins + movingIndex - 1 );
+      }
+    for( long bin = movingIndex - 1; bin <= movingIndex + 2; ++bin )
+      {
+      const double arg = static_cast< double >( bin ) - movingTerm;
+      jointPDF[fixedIndex * numberOfBins + bin] += kernel->Evaluate( arg );
+      const double derivativeWeight = derivativeKernel->Evaluate( arg );
+      for( unsigned int mu = 0; mu < numberOfLocalParameters; ++mu )
+        {
+        if( localSupport )
+          {
+          sampleContributions.push_back( innerProducts[mu] * derivativeWeight );
+          }
+        else
+          {
+          jointPDFDerivatives[( fixedIndex * numberOfBins + bin ) * numberOfLocalParameters + mu] +=
+            innerProducts[mu] * derivativeWeight;
+          }
+        }
+      }
+    ++numberOfValidPoints;
+    }
+
+  double jointPDFSum = 0.0;
+  double fixedMass = 0.0;
+  for( unsigned int i = 0; i < numberOfBins * numberOfBins; ++i )
+    {
+    jointPDFSum += jointPDF[i];
+    }
+  for( unsigned int i = 0; i < numberOfBins; ++i )
+    {
+    fixedMass += fixedMarginalPDF[i];
+    }
+  std::vector< double > movingMarginalPDF( numberOfBins, 0.0 );
+  for( unsigned int i = 0; i < numberOfBins; ++i )
+    {
+    fixedMarginalPDF[i] /= fixedMass;
+    for( unsigned int j = 0; j < numberOfBins; ++j )
+      {
+      jointPDF[i * numberOfBins + j] /= jointPDFSum;
+      movingMarginalPDF[j] += jointPDF[i * numberOfBins + j];
+      }
+    }
+
+  const double nFactor = 1.0 / ( movingBinSize * numberOfValidPoints );
+  const double closeToZero = std::numeric_limits< double >::epsilon();
+  std::vector< double > pRatios( numberOfBins * numberOfBins, 0.0 );
+  derivative.SetSize( transform->GetNumberOfParameters() );
+  derivative.Fill( 0.0 );
+  double sum = 0.0;
+  for( unsigned int i = 0; i < numberOfBins; ++i )
+    {
+    for( unsigned int j = 0; j < numberOfBins; ++j )
+      {
+      const double jointPDFValue = jointPDF[i * numberOfBins + j];
+      if( !( jointPDFValue > closeToZero && movingMarginalPDF[j] > closeToZero ) )
+        {
+        continue;
+        }
+      const double pRatio = std::log( jointPDFValue / movingMarginalPDF[j] );
+      if( fixedMarginalPDF[i] > closeToZero )
+        {
+        sum += jointPDFValue * ( pRatio - std::log( fixedMarginalPDF[i] ) );
+        }
+      pRatios[i * numberOfBins + j] = pRatio;
+      if( !localSupport )
+        {
+        for( unsigned int mu = 0; mu < numberOfLocalParameters; ++mu )
+          {
+          derivative[mu] -= nFactor * jointPDFDerivatives[( i * numberOfBins + j ) * numberOfLocalParameters + mu] * pRatio;
+          }
+        }
+      }
+    }
+  if( localSupport )
+    {
+    for( itk::SizeValueType sample = 0; sample < sampleParameterOffsets.size(); ++sample )
+      {
+      for( unsigned int bin = 0; bin < 4; ++bin )
+        {
+        const double pRatio = pRatios[sampleJointPDFIndices[sample] + bin] * nFactor;
+        for( unsigned int mu = 0; mu < numberOfLocalParameters; ++mu )
+          {
+          derivative[sampleParameterOffsets[sample] + mu] -=
+            sampleContributions[( sample * 4 + bin ) * numberOfLocalParameters + mu] * pRatio;
+          }
+        }
+      }
+    }
+  value = -sum;
+}
+
+template< typename TTransform >
+bool
+itkMattesMutualInformationImageToImageMetricv4ThreadsTestRun( const ImageType * fixedImage,
+                                                               const ImageType * movingImage,
+                                                               TTransform * transform,
+                                                               const char * name )
+{
+  typedef itk::MattesMutualInformationImageToImageMetricv4< ImageType, ImageType > MetricType;
+
+  const unsigned int numberOfBins = 24;
+
+  double referenceValue;
+  DerivativeType referenceDerivative;
+  itkMattesMutualInformationImageToImageMetricv4ThreadsTestReference( fixedImage, movingImage, transform,
+                                                                       numberOfBins, referenceValue,
+                                                                       referenceDerivative );
+  const double referenceDerivativeMagnitude = referenceDerivative.inf_norm();
+
+  double singleThreadValue = 0.0;
+  DerivativeType singleThreadDerivative;
+  bool passed = true;
+
+  for( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 8; ++numberOfThreads )
+    {
+    typename MetricType::Pointer metric = MetricType::New();
+    metric->SetFixedImage( fixedImage );
+    metric->SetMovingImage( movingImage );
+    metric->SetMovingTransform( transform );
+    metric->SetNumberOfHistogramBins( numberOfBins );
+    metric->SetUseMovingImageGradientFilter( false );
+    metric->SetUseFixedImageGradientFilter( false );
+    metric->SetMaximumNumberOfThreads( numberOfThreads );
+    metric->Initialize();
+
+    typename MetricType::MeasureType value;
+    typename MetricType::DerivativeType derivative;
+    metric->GetValueAndDerivative( value, derivative );
+
+    if( numberOfThreads == 1 )
+      {
+      singleThreadValue = value;
+      singleThreadDerivative = derivative;
+      }
+
+    // The thread buffers are summed in a different order, so only rounding
+    // differences are allowed.
+    const double valueTolerance = 1e-10 * std::abs( referenceValue );
+    const double derivativeTolerance = 1e-8 * referenceDerivativeMagnitude;
+
+    if( std::abs( value - referenceValue ) > valueTolerance
+        || std::abs( value - singleThreadValue ) > valueTolerance )
+      {
+      std::cerr << name << " with " << numberOfThreads << " threads: value " << value
+                << " instead of " << referenceValue << " (reference) and "
+                << singleThreadValue << " (1 thread)" << std::endl;
+      passed = false;
+      }
+    if( derivative.GetSize() != referenceDerivative.GetSize() )
+      {
+      std::cerr << name << " with " << numberOfThreads << " threads: derivative has "
+                << derivative.GetSize() << " elements instead of " << referenceDerivative.GetSize() << std::endl;
+      passed = false;
+      continue;
+      }
+    for( unsigned int i = 0; i < derivative.GetSize(); ++i )
+      {
+      if( std::abs( derivative[i] - referenceDerivative[i] ) > derivativeTolerance
+          || std::abs( derivative[i] - singleThreadDerivative[i] ) > derivativeTolerance )
+        {
+        std::cerr << name << " with " << numberOfThreads << " threads: derivative[" << i << "] "
+                  << derivative[i] << " instead of " << referenceDerivative[i] << " (reference) and "
+                  << singleThreadDerivative[i] << " (1 thread)" << std::endl;
+        passed = false;
+        break;
+        }
+      }
+    }
+
+  std::cout << name << ": value " << referenceValue << ", derivative magnitude "
+            << referenceDerivativeMagnitude << std::endl;
+  return passed;
+}
+
+} // end anonymous namespace
+
+int itkMattesMutualInformationImageToImageMetricv4ThreadsTest( int, char *[] )
+{
+  ImageType::Pointer fixedImage = itkMattesMutualInformationImageToImageMetricv4ThreadsTestCreateImage( 0.0, 0.0 );
+  ImageType::Pointer movingImage = itkMattesMutualInformationImageToImageMetricv4ThreadsTestCreateImage( 4.5, -2.5 );
+
+  bool passed = true;
+
+  typedef itk::TranslationTransform< double, Dimension > TranslationTransformType;
+  TranslationTransformType::Pointer translation = TranslationTransformType::New();
+  TranslationTransformType::OutputVectorType offset;
+  offset[0] = 3.2;
+  offset[1] = -1.7;
+  translation->Translate( offset );
+  passed &= itkMattesMutualInformationImageToImageMetricv4ThreadsTestRun( fixedImage.GetPointer(),
+                                                                          movingImage.GetPointer(),
+                                                                          translation.GetPointer(),
+                                                                          "Translation" );
+
+  typedef itk::DisplacementFieldTransform< double, Dimension > DisplacementTransformType;
+  typedef DisplacementTransformType::DisplacementFieldType     FieldType;
+  FieldType::Pointer field = FieldType::New();
+  field->CopyInformation( fixedImage );
+  field->SetRegions( fixedImage->GetLargestPossibleRegion() );
+  field->Allocate();
+  itk::ImageRegionIteratorWithIndex< FieldType > fieldIt( field, field->GetLargestPossibleRegion() );
+  for( fieldIt.GoToBegin(); !fieldIt.IsAtEnd(); ++fieldIt )
+    {
+    FieldType::PointType point;
+    field->TransformIndexToPhysicalPoint( fieldIt.GetIndex(), point );
+    FieldType::PixelType displacement;
+    displacement[0] = 3.0 + 1.5 * std::sin( point[1] / 6.0 );
+    displacement[1] = -2.0 + std::cos( point[0] / 9.0 );
+    fieldIt.Set( displacement );
+    }
+  DisplacementTransformType::Pointer displacementTransform = DisplacementTransformType::New();
+  displacementTransform->SetDisplacementField( field );
+  passed &= itkMattesMutualInformationImageToImageMetricv4ThreadsTestRun( fixedImage.GetPointer(),
+                                                                          movingImage.GetPointer(),
+                                                                          displacementTransform.GetPointer(),
+                                                                          "Displacement field" );
+
+  if( !passed )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 
 #include "itkImageMaskSpatialObject.h"
 #include "itkDisplacementFieldTransform.h"
+#include "itkDisplacementFieldGaussianSmoother.h"
 
 namespace itk
 {
@@ -220,6 +221,7 @@ protected:
 
   virtual DisplacementFieldPointer ScaleUpdateField( const DisplacementFieldType * );
   virtual DisplacementFieldPointer GaussianSmoothDisplacementField( const DisplacementFieldType *, const RealType );
+  virtual void GaussianSmoothDisplacementFieldInPlace( DisplacementFieldType *, const RealType );
   virtual DisplacementFieldPointer InvertDisplacementField( const DisplacementFieldType *, const DisplacementFieldType * = ITK_NULLPTR );
 
   RealType                                                        m_LearningRate;
@@ -240,6 +242,9 @@ private:
 
   RealType                                                        m_GaussianSmoothingVarianceForTheUpdateField;
   RealType                                                        m_GaussianSmoothingVarianceForTheTotalField;
+
+  typedef DisplacementFieldGaussianSmoother<DisplacementFieldType> GaussianSmootherType;
+  typename GaussianSmootherType::Pointer                          m_GaussianSmoother;
 };
 } // end namespace itk
 
@@ -21,13 +21,12 @@
 #include "itkSyNImageRegistrationMethod.h"
 
 #include "itkComposeDisplacementFieldsImageFilter.h"
-#include "itkGaussianOperator.h"
+#include "itkImageDuplicator.h"
 #include "itkImageMaskSpatialObject.h"
 #include "itkImportImageFilter.h"
 #include "itkInvertDisplacementFieldImageFilter.h"
 #include "itkIterationReporter.h"
 #include "itkMultiplyImageFilter.h"
-#include "itkVectorNeighborhoodOperatorImageFilter.h"
 #include "itkWindowConvergenceMonitoringFunction.h"
 
 namespace itk
@@ -52,6 +51,7 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
   this->m_AverageMidPointGradients = false;
   this->m_FixedToMiddleTransform = ITK_NULLPTR;
   this->m_MovingToMiddleTransform = ITK_NULLPTR;
+  this->m_GaussianSmoother = GaussianSmootherType::New();
 }
 
 template<typename TFixedImage, typename TMovingImage, typename TOutputTransform, typename TVirtualImage, typename TPointSet>
@@ -213,16 +213,21 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
     fixedComposer->SetWarpingField( this->m_FixedToMiddleTransform->GetDisplacementField() );
     fixedComposer->Update();
 
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
-      fixedComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField );
+    // The composed field is only used here, so it is smoothed in place.
+    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = fixedComposer->GetOutput();
+    fixedToMiddleSmoothTotalFieldTmp->DisconnectPipeline();
+    this->GaussianSmoothDisplacementFieldInPlace( fixedToMiddleSmoothTotalFieldTmp,
+      this->m_GaussianSmoothingVarianceForTheTotalField );
 
     typename ComposerType::Pointer movingComposer = ComposerType::New();
     movingComposer->SetDisplacementField( movingToMiddleSmoothUpdateField );
     movingComposer->SetWarpingField( this->m_MovingToMiddleTransform->GetDisplacementField() );
     movingComposer->Update();
 
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
-      movingComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField );
+    DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = movingComposer->GetOutput();
+    movingToMiddleSmoothTotalFieldTmp->DisconnectPipeline();
+    this->GaussianSmoothDisplacementFieldInPlace( movingToMiddleSmoothTotalFieldTmp,
+      this->m_GaussianSmoothingVarianceForTheTotalField );
 
     // Iteratively estimate the inverse fields.
 
@@ -264,10 +269,10 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
       fixedImages, fixedPointSets, fixedTransform, movingImages, movingPointSets, movingTransform,
       fixedImageMasks, movingImageMasks, value );
 
-  DisplacementFieldPointer updateField = this->GaussianSmoothDisplacementField( metricGradientField,
+  this->GaussianSmoothDisplacementFieldInPlace( metricGradientField,
     this->m_GaussianSmoothingVarianceForTheUpdateField );
 
-  DisplacementFieldPointer scaledUpdateField = this->ScaleUpdateField( updateField );
+  DisplacementFieldPointer scaledUpdateField = this->ScaleUpdateField( metricGradientField );
 
   return scaledUpdateField;
 }
@@ -648,84 +653,26 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
 
   DisplacementFieldPointer smoothField = duplicator->GetModifiableOutput();
 
-  if( variance <= 0.0 )
-    {
-    return smoothField;
-    }
-
-  typedef GaussianOperator<RealType, ImageDimension> GaussianSmoothingOperatorType;
-  GaussianSmoothingOperatorType gaussianSmoothingOperator;
-
-  typedef VectorNeighborhoodOperatorImageFilter<DisplacementFieldType, DisplacementFieldType> GaussianSmoothingSmootherType;
-  typename GaussianSmoothingSmootherType::Pointer smoother = GaussianSmoothingSmootherType::New();
-
-  for( SizeValueType d = 0; d < ImageDimension; d++ )
-    {
-    // smooth along this dimension
-    gaussianSmoothingOperator.SetDirection( d );
-    gaussianSmoothingOperator.SetVariance( variance );
-    gaussianSmoothingOperator.SetMaximumError( 0.001 );
-    gaussianSmoothingOperator.SetMaximumKernelWidth( smoothField->GetRequestedRegion().GetSize()[d] );
-    gaussianSmoothingOperator.CreateDirectional();
-
-    // todo: make sure we only smooth within the buffered region
-    smoother->SetOperator( gaussianSmoothingOperator );
-    smoother->SetInput( smoothField );
-    try
-      {
-      smoother->Update();
-      }
-    catch( ExceptionObject & exc )
-      {
-      std::string msg( "Caught exception: " );
-      msg += exc.what();
-      itkExceptionMacro( << msg );
-      }
-
-    smoothField = smoother->GetOutput();
-    smoothField->Update();
-    smoothField->DisconnectPipeline();
-    }
-
-  const DisplacementVectorType zeroVector( 0.0 );
-
-  //make sure boundary does not move
-  RealType weight1 = 1.0;
-  if( variance < 0.5 )
-    {
-    weight1 = 1.0 - 1.0 * ( variance / 0.5 );
-    }
-  RealType weight2 = 1.0 - weight1;
+  this->GaussianSmoothDisplacementFieldInPlace( smoothField, variance );
 
-  const typename DisplacementFieldType::RegionType region = field->GetLargestPossibleRegion();
-  const typename DisplacementFieldType::SizeType size = region.GetSize();
-  const typename DisplacementFieldType::IndexType startIndex = region.GetIndex();
+  return smoothField;
+}
 
-  ImageRegionConstIteratorWithIndex<DisplacementFieldType> ItF( field, field->GetLargestPossibleRegion() );
-  ImageRegionIteratorWithIndex<DisplacementFieldType> ItS( smoothField, smoothField->GetLargestPossibleRegion() );
-  for( ItF.GoToBegin(), ItS.GoToBegin(); !ItF.IsAtEnd(); ++ItF, ++ItS )
+template<typename TFixedImage, typename TMovingImage, typename TOutputTransform, typename TVirtualImage, typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>
+::GaussianSmoothDisplacementFieldInPlace( DisplacementFieldType * field, const RealType variance )
+{
+  if( variance <= 0.0 )
     {
-    typename DisplacementFieldType::IndexType index = ItF.GetIndex();
-    bool isOnBoundary = false;
-    for ( unsigned int d = 0; d < ImageDimension; d++ )
-      {
-      if( index[d] == startIndex[d] || index[d] == static_cast<IndexValueType>( size[d] ) - startIndex[d] - 1 )
-        {
-        isOnBoundary = true;
-        break;
-        }
-      }
-    if( isOnBoundary )
-      {
-      ItS.Set( zeroVector );
-      }
-    else
-      {
-      ItS.Set( ItS.Get() * weight1 + ItF.Get() * weight2 );
-      }
+    return;
     }
 
-  return smoothField;
+  // The smoother keeps its line buffers between calls, so smoothing the
+  // fields at each iteration does not allocate.
+  this->m_GaussianSmoother->SetVariance( variance );
+  this->m_GaussianSmoother->SetMaximumError( 0.001 );
+  this->m_GaussianSmoother->SmoothInPlace( field );
 }
 
 /*
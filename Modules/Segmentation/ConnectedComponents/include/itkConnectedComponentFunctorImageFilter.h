@@ -162,6 +162,12 @@ protected:
    * Standard pipeline method.
    */
   void GenerateData() ITK_OVERRIDE;
+
+  /** The whole image is labeled at once. */
+  virtual bool CanStream() const ITK_OVERRIDE
+  {
+    return false;
+  }
 };
 } // end namespace itk
 
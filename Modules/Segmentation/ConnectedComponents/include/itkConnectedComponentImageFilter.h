@@ -43,7 +43,16 @@ namespace itk
  * component image filter which did not produce consecutive labels or
  * impose any particular ordering.
  *
- * After the filter is executed, ObjectCount holds the number of connected components.
+ * After the filter is executed, ObjectCount holds the number of connected
+ * components, and GetSizeOfObjectsInPixels() their number of pixels.
+ *
+ * With more than one stream division, the filter streams its input in slabs
+ * along the last dimension. The slabs are labeled one by one, and only the
+ * last plane of the previous slab and a table of the components of the
+ * slabs are kept to join the components across the slabs. The requested
+ * output is then labeled slab by slab from that table. Neither the input nor
+ * the output need to fit in memory when the output is streamed, e.g. by an
+ * ImageFileWriter, and the labels are the same as without streaming.
  *
  * \sa ImageToImageFilter
  *
@@ -138,6 +147,30 @@ public:
   // only set after completion
   itkGetConstReferenceMacro(ObjectCount, LabelType);
 
+  /**
+   * Set/Get the number of slabs, along the last dimension, in which the
+   * input is streamed. Default is 1, which labels the whole image at once
+   * with several threads.
+   */
+  itkSetClampMacro(NumberOfStreamDivisions, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(NumberOfStreamDivisions, unsigned int);
+
+  /** Type used for the sizes of the objects. */
+  typedef std::vector< SizeValueType > ObjectSizeInPixelsContainerType;
+
+  /**
+   * Get the number of pixels of each object, in the order of the labels,
+   * as RelabelComponentImageFilter::GetSizeOfObjectsInPixels() without the
+   * sort. This information is only valid after the filter has executed.
+   * It can be passed to
+   * RelabelComponentImageFilter::SetSizeOfInputObjectsInPixels() to
+   * skip the counting of the pixels.
+   */
+  const ObjectSizeInPixelsContainerType & GetSizeOfObjectsInPixels() const
+  {
+    return m_SizeOfObjectsInPixels;
+  }
+
   // Concept checking -- input and output dimensions must be the same
   itkConceptMacro( SameDimension,
                    ( Concept::SameDimension< itkGetStaticConstMacro(InputImageDimension),
@@ -168,6 +201,7 @@ protected:
     m_FullyConnected = false;
     m_ObjectCount = 0;
     m_BackgroundValue = NumericTraits< OutputImagePixelType >::ZeroValue();
+    m_NumberOfStreamDivisions = 1;
   }
 
   virtual ~ConnectedComponentImageFilter() {}
@@ -176,6 +210,8 @@ protected:
   /**
    * Standard pipeline methods.
    */
+  void GenerateData() ITK_OVERRIDE;
+
   void BeforeThreadedGenerateData() ITK_OVERRIDE;
 
   void AfterThreadedGenerateData() ITK_OVERRIDE;
@@ -193,6 +229,13 @@ protected:
    * \sa ProcessObject::EnlargeOutputRequestedRegion() */
   void EnlargeOutputRequestedRegion( DataObject * itkNotUsed(output) ) ITK_OVERRIDE;
 
+  /** Whether the filter can stream its input. Subclasses which label the
+   * whole image in their GenerateData() return false. */
+  virtual bool CanStream() const
+  {
+    return ImageDimension > 1;
+  }
+
   bool m_FullyConnected;
 
 private:
@@ -247,10 +290,29 @@ public:
 
   void CompareLines(lineEncoding & current, const lineEncoding & Neighbour);
 
+  void LinkLine(LineMapType & LineMap, SizeValueType ThisIdx, const OffsetVec & LineOffsets);
+
   void FillOutput(const LineMapType & LineMap,
                   ProgressReporter & progress);
 
-  void SetupLineOffsets(OffsetVec & LineOffsets);
+  void SetupLineOffsets(OffsetVec & LineOffsets, const OutSizeType & OutSize);
+
+  // streaming support
+  bool IsStreamed() const
+  {
+    return m_NumberOfStreamDivisions > 1 && this->CanStream();
+  }
+
+  unsigned int GetNumberOfStreamSlabs() const;
+
+  RegionType GetStreamSlab(unsigned int slab) const;
+
+  SizeValueType LabelSlab(const RegionType & slab, LineMapType & LineMap,
+                          ProgressReporter & progress);
+
+  void ScanSlabs(ProgressReporter & progress);
+
+  void StreamedGenerateData();
 
   void Wait()
   {
@@ -267,6 +329,13 @@ public:
   typename Barrier::Pointer m_Barrier;
 
   typename TInputImage::ConstPointer m_Input;
+
+  unsigned int                    m_NumberOfStreamDivisions;
+  std::vector< LabelType >        m_SlabFirstComponent;
+  std::vector< LabelType >        m_ComponentLabels;
+  ObjectSizeInPixelsContainerType m_SizeOfObjectsInPixels;
+  TimeStamp                       m_ComponentLabelsTime;
+  RegionType                      m_ComponentLabelsRegion;
 #if !defined( ITK_WRAPPING_PARSER )
   LineMapType m_LineMap;
 #endif
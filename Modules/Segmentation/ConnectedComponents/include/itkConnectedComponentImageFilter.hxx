@@ -38,15 +38,37 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   // call the superclass' implementation of this method
   Superclass::GenerateInputRequestedRegion();
 
-  // We need all the input.
   InputImagePointer input = const_cast< InputImageType * >( this->GetInput() );
   if ( !input )
     {
     return;
     }
+  MaskImagePointer mask = const_cast< MaskImageType * >( this->GetMaskImage() );
+
+  if ( this->IsStreamed() )
+    {
+    // the slabs are streamed by the filter itself; only request the first
+    // slab of the output
+    const IndexValueType first = this->GetOutput()->GetRequestedRegion().GetIndex()[ImageDimension - 1];
+    for ( unsigned int i = 0; i < this->GetNumberOfStreamSlabs(); ++i )
+      {
+      const RegionType slab = this->GetStreamSlab(i);
+      if ( slab.GetIndex()[ImageDimension - 1] + static_cast< IndexValueType >( slab.GetSize()[ImageDimension - 1] ) > first )
+        {
+        input->SetRequestedRegion(slab);
+        if ( mask )
+          {
+          mask->SetRequestedRegion(slab);
+          }
+        break;
+        }
+      }
+    return;
+    }
+
+  // We need all the input.
   input->SetRequestedRegion( input->GetLargestPossibleRegion() );
 
-  MaskImagePointer mask = const_cast< MaskImageType * >( this->GetMaskImage() );
   if ( mask )
     {
     mask->SetRequestedRegion( input->GetLargestPossibleRegion() );
@@ -58,10 +80,59 @@ void
 ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 ::EnlargeOutputRequestedRegion(DataObject *)
 {
+  if ( this->IsStreamed() )
+    {
+    // produce whole slabs
+    const RegionType & requested = this->GetOutput()->GetRequestedRegion();
+    const IndexValueType first = requested.GetIndex()[ImageDimension - 1];
+    const IndexValueType last = first + static_cast< IndexValueType >( requested.GetSize()[ImageDimension - 1] ) - 1;
+    RegionType region;
+    bool       empty = true;
+    for ( unsigned int i = 0; i < this->GetNumberOfStreamSlabs(); ++i )
+      {
+      const RegionType slab = this->GetStreamSlab(i);
+      const IndexValueType slabFirst = slab.GetIndex()[ImageDimension - 1];
+      const IndexValueType slabLast = slabFirst + static_cast< IndexValueType >( slab.GetSize()[ImageDimension - 1] ) - 1;
+      if ( slabLast < first || slabFirst > last )
+        {
+        continue;
+        }
+      if ( empty )
+        {
+        region = slab;
+        empty = false;
+        }
+      else
+        {
+        region.SetSize( ImageDimension - 1, slabLast - region.GetIndex()[ImageDimension - 1] + 1 );
+        }
+      }
+    if ( !empty )
+      {
+      this->GetOutput()->SetRequestedRegion(region);
+      return;
+      }
+    }
   this->GetOutput()
   ->SetRequestedRegion( this->GetOutput()->GetLargestPossibleRegion() );
 }
 
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+void
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::GenerateData()
+{
+  if ( this->IsStreamed() )
+    {
+    this->StreamedGenerateData();
+    }
+  else
+    {
+    m_SizeOfObjectsInPixels.clear();
+    Superclass::GenerateData();
+    }
+}
+
 template< typename TInputImage, typename TOutputImage, typename TMaskImage >
 void
 ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
@@ -153,7 +224,7 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   LineIdType lineId = firstLineIdForThread;
 
   OffsetVec LineOffsets;
-  SetupLineOffsets(LineOffsets);
+  SetupLineOffsets( LineOffsets, output->GetRequestedRegion().GetSize() );
 
   LineIdType nbOfLabels = 0;
   for ( inLineIt.GoToBegin();
@@ -257,26 +328,7 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 
   for ( SizeValueType ThisIdx = firstLineIdForThread; ThisIdx < lastLineIdForThread; ++ThisIdx )
     {
-    if ( !m_LineMap[ThisIdx].empty() )
-      {
-      for ( typename OffsetVec::const_iterator I = LineOffsets.begin();
-            I != LineOffsets.end(); ++I )
-        {
-        const OffsetValueType NeighIdx = ( *I ) + ThisIdx;
-        // check if the neighbor is in the map
-        if ( NeighIdx >= 0 && NeighIdx < static_cast<OffsetValueType>( linecount ) && !m_LineMap[NeighIdx].empty() )
-          {
-          // Now check whether they are really neighbors
-          const bool areNeighbors =
-            CheckNeighbors(m_LineMap[ThisIdx][0].where, m_LineMap[NeighIdx][0].where);
-          if ( areNeighbors )
-            {
-            // Compare the two lines
-            CompareLines(m_LineMap[ThisIdx], m_LineMap[NeighIdx]);
-            }
-          }
-        }
-      }
+    this->LinkLine(m_LineMap, ThisIdx, LineOffsets);
     }
 
   // wait for the other threads to complete that part
@@ -290,26 +342,7 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
             ThisIdx < m_FirstLineIdToJoin[threadId * 2] + nbOfLineIdToJoin;
             ++ThisIdx )
         {
-        if ( !m_LineMap[ThisIdx].empty() )
-          {
-          for ( typename OffsetVec::const_iterator I = LineOffsets.begin();
-                I != LineOffsets.end(); ++I )
-            {
-            const OffsetValueType NeighIdx = ( *I ) + ThisIdx;
-            // check if the neighbor is in the map
-            if ( NeighIdx >= 0 && NeighIdx < static_cast<OffsetValueType>( linecount ) && !m_LineMap[NeighIdx].empty() )
-              {
-              // Now check whether they are really neighbors
-              const bool areNeighbors =
-                CheckNeighbors(m_LineMap[ThisIdx][0].where, m_LineMap[NeighIdx][0].where);
-              if ( areNeighbors )
-                {
-                // Compare the two lines
-                CompareLines(m_LineMap[ThisIdx], m_LineMap[NeighIdx]);
-                }
-              }
-            }
-          }
+        this->LinkLine(m_LineMap, ThisIdx, LineOffsets);
         }
       }
 
@@ -406,6 +439,25 @@ void
 ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 ::AfterThreadedGenerateData()
 {
+  // count the pixels of the objects, in the order of their labels
+  UnionFindType objectSizes( m_UnionFind.size(), 0 );
+  for ( typename LineMapType::const_iterator lIt = m_LineMap.begin(); lIt != m_LineMap.end(); ++lIt )
+    {
+    for ( typename lineEncoding::const_iterator cIt = lIt->begin(); cIt != lIt->end(); ++cIt )
+      {
+      objectSizes[LookupSet(cIt->label)] += cIt->length;
+      }
+    }
+  m_SizeOfObjectsInPixels.clear();
+  m_SizeOfObjectsInPixels.reserve( m_ObjectCount );
+  for ( SizeValueType I = 1; I < m_UnionFind.size(); I++ )
+    {
+    if ( m_UnionFind[I] == I )
+      {
+      m_SizeOfObjectsInPixels.push_back( objectSizes[I] );
+      }
+    }
+
   m_NumberOfLabels.clear();
   m_Barrier = ITK_NULLPTR;
   m_LineMap.clear();
@@ -415,14 +467,13 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 template< typename TInputImage, typename TOutputImage, typename TMaskImage >
 void
 ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
-::SetupLineOffsets(OffsetVec & LineOffsets)
+::SetupLineOffsets(OffsetVec & LineOffsets, const OutSizeType & OutSize)
 {
   // Create a neighborhood so that we can generate a table of offsets
   // to "previous" line indexes
   // We are going to mis-use the neighborhood iterators to compute the
   // offset for us. All this messing around produces an array of
   // offsets that will be used to index the map
-  typename TOutputImage::Pointer output = this->GetOutput();
   typedef Image< OffsetValueType, TOutputImage::ImageDimension - 1 >  PretendImageType;
   typedef typename PretendImageType::RegionType::SizeType             PretendSizeType;
   typedef typename PretendImageType::RegionType::IndexType            PretendIndexType;
@@ -434,8 +485,6 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   typename PretendImageType::RegionType LineRegion;
   //LineRegion = PretendImageType::RegionType::New();
 
-  OutSizeType OutSize = output->GetRequestedRegion().GetSize();
-
   PretendSizeType PretendSize;
   // The first dimension has been collapsed
   for ( unsigned int i = 0; i < PretendSize.GetSizeDimension(); i++ )
@@ -471,6 +520,34 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   // LineOffsets is the thing we wanted.
 }
 
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+void
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::LinkLine(LineMapType & LineMap, SizeValueType ThisIdx, const OffsetVec & LineOffsets)
+{
+  if ( LineMap[ThisIdx].empty() )
+    {
+    return;
+    }
+  for ( typename OffsetVec::const_iterator I = LineOffsets.begin();
+        I != LineOffsets.end(); ++I )
+    {
+    const OffsetValueType NeighIdx = ( *I ) + ThisIdx;
+    // check if the neighbor is in the map
+    if ( NeighIdx >= 0 && NeighIdx < static_cast<OffsetValueType>( LineMap.size() ) && !LineMap[NeighIdx].empty() )
+      {
+      // Now check whether they are really neighbors
+      const bool areNeighbors =
+        CheckNeighbors(LineMap[ThisIdx][0].where, LineMap[NeighIdx][0].where);
+      if ( areNeighbors )
+        {
+        // Compare the two lines
+        CompareLines(LineMap[ThisIdx], LineMap[NeighIdx]);
+        }
+      }
+    }
+}
+
 template< typename TInputImage, typename TOutputImage, typename TMaskImage >
 bool
 ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
@@ -650,6 +727,340 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
     }
 }
 
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+unsigned int
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::GetNumberOfStreamSlabs() const
+{
+  const SizeValueType size = this->GetOutput()->GetLargestPossibleRegion().GetSize()[ImageDimension - 1];
+
+  return static_cast< unsigned int >( std::min< SizeValueType >( m_NumberOfStreamDivisions, size ) );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+typename ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >::RegionType
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::GetStreamSlab(unsigned int slab) const
+{
+  // split the last dimension in slabs of about the same size
+  RegionType region = this->GetOutput()->GetLargestPossibleRegion();
+  const SizeValueType size = region.GetSize()[ImageDimension - 1];
+  const SizeValueType numberOfSlabs = this->GetNumberOfStreamSlabs();
+  const SizeValueType begin = slab * size / numberOfSlabs;
+  const SizeValueType end = ( slab + 1 ) * size / numberOfSlabs;
+
+  region.SetIndex( ImageDimension - 1, region.GetIndex()[ImageDimension - 1] + static_cast< IndexValueType >( begin ) );
+  region.SetSize( ImageDimension - 1, end - begin );
+  return region;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+SizeValueType
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::LabelSlab(const RegionType & slab, LineMapType & LineMap, ProgressReporter & progress)
+{
+  // bring the slab of the inputs in memory
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  input->SetRequestedRegion(slab);
+  input->PropagateRequestedRegion();
+  input->UpdateOutputData();
+
+  MaskImageType *mask = const_cast< MaskImageType * >( this->GetMaskImage() );
+  if ( mask )
+    {
+    mask->SetRequestedRegion(slab);
+    mask->PropagateRequestedRegion();
+    mask->UpdateOutputData();
+    }
+
+  // run length encode the lines of the slab. The pixels outside of the
+  // mask are background, as with the MaskImageFilter of the threaded
+  // implementation
+  typedef ImageLinearConstIteratorWithIndex< InputImageType > InputLineIteratorType;
+  typedef ImageLinearConstIteratorWithIndex< MaskImageType >  MaskLineIteratorType;
+  InputLineIteratorType inLineIt(input, slab);
+  inLineIt.SetDirection(0);
+  MaskLineIteratorType maskLineIt;
+  if ( mask )
+    {
+    maskLineIt = MaskLineIteratorType(mask, slab);
+    maskLineIt.SetDirection(0);
+    maskLineIt.GoToBegin();
+    }
+
+  const SizeValueType linecount = slab.GetNumberOfPixels() / slab.GetSize()[0];
+  LineMap.assign( linecount, lineEncoding() );
+
+  SizeValueType nbOfLabels = 0;
+  SizeValueType lineId = 0;
+  for ( inLineIt.GoToBegin();
+        !inLineIt.IsAtEnd();
+        inLineIt.NextLine(), ++lineId )
+    {
+    inLineIt.GoToBeginOfLine();
+    if ( mask )
+      {
+      maskLineIt.GoToBeginOfLine();
+      }
+    lineEncoding & ThisLine = LineMap[lineId];
+    bool inRun = false;
+    while ( !inLineIt.IsAtEndOfLine() )
+      {
+      const InputPixelType PVal = inLineIt.Get();
+      bool foreground = PVal != NumericTraits< InputPixelType >::ZeroValue( PVal );
+      if ( mask )
+        {
+        const MaskPixelType MVal = maskLineIt.Get();
+        foreground = foreground && MVal != NumericTraits< MaskPixelType >::ZeroValue( MVal );
+        ++maskLineIt;
+        }
+      if ( !foreground )
+        {
+        inRun = false;
+        }
+      else if ( inRun )
+        {
+        ++ThisLine.back().length;
+        }
+      else
+        {
+        // We've hit the start of a run
+        runLength thisRun;
+        thisRun.length = 1;
+        thisRun.where = inLineIt.GetIndex();
+        thisRun.label = ++nbOfLabels;
+        ThisLine.push_back(thisRun);
+        inRun = true;
+        }
+      ++inLineIt;
+      }
+    if ( mask )
+      {
+      maskLineIt.NextLine();
+      }
+    progress.CompletedPixel();
+    }
+
+  // join the runs of the slab
+  InitUnion(nbOfLabels);
+  for ( LabelType label = 1; label <= nbOfLabels; ++label )
+    {
+    InsertSet(label);
+    }
+  OffsetVec LineOffsets;
+  SetupLineOffsets( LineOffsets, slab.GetSize() );
+  for ( SizeValueType ThisIdx = 0; ThisIdx < linecount; ++ThisIdx )
+    {
+    this->LinkLine(LineMap, ThisIdx, LineOffsets);
+    }
+
+  // relabel the runs with the components of the slab, numbered from 0 in
+  // the order of their first run
+  UnionFindType component( nbOfLabels + 1 );
+  SizeValueType nbOfComponents = 0;
+  for ( LabelType label = 1; label <= nbOfLabels; ++label )
+    {
+    if ( m_UnionFind[label] == label )
+      {
+      component[label] = nbOfComponents++;
+      }
+    }
+  for ( typename LineMapType::iterator LineIt = LineMap.begin(); LineIt != LineMap.end(); ++LineIt )
+    {
+    for ( typename lineEncoding::iterator cIt = LineIt->begin(); cIt != LineIt->end(); ++cIt )
+      {
+      cIt->label = component[LookupSet(cIt->label)];
+      }
+    }
+  UnionFindType().swap(m_UnionFind);
+
+  return nbOfComponents;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+void
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::ScanSlabs(ProgressReporter & progress)
+{
+  const unsigned int numberOfSlabs = this->GetNumberOfStreamSlabs();
+
+  // the components of the slabs are numbered one after the other, and
+  // joined in a union find structure through the planes between the slabs
+  UnionFindType                   components;
+  ObjectSizeInPixelsContainerType componentSizes;
+  m_SlabFirstComponent.assign( numberOfSlabs, 0 );
+
+  // the offsets of the lines in the last plane of a slab followed by the
+  // first plane of the next one
+  OutSizeType PlanesSize = this->GetOutput()->GetLargestPossibleRegion().GetSize();
+  PlanesSize[ImageDimension - 1] = 2;
+  OffsetVec PlaneOffsets;
+  SetupLineOffsets(PlaneOffsets, PlanesSize);
+
+  LineMapType LineMap;
+  LineMapType Planes;
+  for ( unsigned int i = 0; i < numberOfSlabs; ++i )
+    {
+    const RegionType    slab = this->GetStreamSlab(i);
+    const SizeValueType nbOfComponents = this->LabelSlab(slab, LineMap, progress);
+    const LabelType     first = components.size();
+
+    m_SlabFirstComponent[i] = first;
+    for ( SizeValueType c = 0; c < nbOfComponents; ++c )
+      {
+      components.push_back(first + c);
+      componentSizes.push_back(0);
+      }
+    for ( typename LineMapType::iterator LineIt = LineMap.begin(); LineIt != LineMap.end(); ++LineIt )
+      {
+      for ( typename lineEncoding::iterator cIt = LineIt->begin(); cIt != LineIt->end(); ++cIt )
+        {
+        cIt->label += first;
+        componentSizes[cIt->label] += cIt->length;
+        }
+      }
+
+    const SizeValueType planeLineCount = LineMap.size() / slab.GetSize()[ImageDimension - 1];
+    if ( i > 0 )
+      {
+      // join the components of the last plane of the previous slab and of
+      // the first plane of this slab. The union find functions work on
+      // m_UnionFind, so it holds the components while they are joined.
+      Planes.insert( Planes.end(), LineMap.begin(), LineMap.begin() + planeLineCount );
+      m_UnionFind.swap(components);
+      for ( SizeValueType ThisIdx = planeLineCount; ThisIdx < 2 * planeLineCount; ++ThisIdx )
+        {
+        this->LinkLine(Planes, ThisIdx, PlaneOffsets);
+        }
+      m_UnionFind.swap(components);
+      }
+
+    // only keep the last plane of the slab
+    Planes.assign( LineMap.end() - planeLineCount, LineMap.end() );
+    }
+
+  // a component is never joined to a component after it, so a single pass
+  // finds the first component of each object
+  const SizeValueType nbOfComponents = components.size();
+  for ( SizeValueType c = 0; c < nbOfComponents; ++c )
+    {
+    components[c] = components[components[c]];
+    }
+
+  // number the objects as CreateConsecutive() does
+  UnionFindType objects( nbOfComponents );
+  m_ComponentLabels.assign( nbOfComponents, 0 );
+  m_SizeOfObjectsInPixels.clear();
+  SizeValueType CLab = 0;
+  for ( SizeValueType c = 0; c < nbOfComponents; ++c )
+    {
+    if ( components[c] == c )
+      {
+      if ( CLab == static_cast< SizeValueType >( m_BackgroundValue ) )
+        {
+        ++CLab;
+        }
+      objects[c] = m_SizeOfObjectsInPixels.size();
+      m_SizeOfObjectsInPixels.push_back(0);
+      m_ComponentLabels[c] = CLab;
+      ++CLab;
+      }
+    const LabelType root = components[c];
+    m_ComponentLabels[c] = m_ComponentLabels[root];
+    m_SizeOfObjectsInPixels[objects[root]] += componentSizes[c];
+    }
+  m_ObjectCount = m_SizeOfObjectsInPixels.size();
+
+  if ( m_ObjectCount > static_cast< SizeValueType >(
+         NumericTraits< OutputPixelType >::max() ) )
+    {
+    itkExceptionMacro(
+      << "Number of objects greater than maximum of output pixel type ");
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+void
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::StreamedGenerateData()
+{
+  this->AllocateOutputs();
+
+  typename TOutputImage::Pointer output = this->GetOutput();
+  const RegionType & requested = output->GetRequestedRegion();
+
+  // the components of the slabs are found again only if the inputs or the
+  // parameters changed since the last scan
+  const InputImageType *input = this->GetInput();
+  const MaskImageType * mask = this->GetMaskImage();
+  ModifiedTimeType inputTime = input->GetSource() ? input->GetPipelineMTime() : input->GetMTime();
+  if ( mask )
+    {
+    inputTime = std::max( inputTime, mask->GetSource() ? mask->GetPipelineMTime() : mask->GetMTime() );
+    }
+  const bool scan = m_ComponentLabelsTime.GetMTime() < std::max( inputTime, this->GetMTime() )
+                    || m_ComponentLabelsRegion != output->GetLargestPossibleRegion();
+
+  const SizeValueType xsize = requested.GetSize()[0];
+  SizeValueType linecount = requested.GetNumberOfPixels() / xsize;
+  if ( scan )
+    {
+    linecount += output->GetLargestPossibleRegion().GetNumberOfPixels() / xsize;
+    }
+  ProgressReporter progress(this, 0, linecount);
+
+  if ( scan )
+    {
+    this->ScanSlabs(progress);
+    m_ComponentLabelsRegion = output->GetLargestPossibleRegion();
+    m_ComponentLabelsTime.Modified();
+    }
+
+  // label the slabs of the requested region
+  const IndexValueType first = requested.GetIndex()[ImageDimension - 1];
+  const IndexValueType last = first + static_cast< IndexValueType >( requested.GetSize()[ImageDimension - 1] ) - 1;
+  LineMapType LineMap;
+  for ( unsigned int i = 0; i < this->GetNumberOfStreamSlabs(); ++i )
+    {
+    const RegionType slab = this->GetStreamSlab(i);
+    if ( slab.GetIndex()[ImageDimension - 1] < first || slab.GetIndex()[ImageDimension - 1] > last )
+      {
+      continue;
+      }
+    this->LabelSlab(slab, LineMap, progress);
+    const LabelType firstComponent = m_SlabFirstComponent[i];
+
+    ImageRegionIterator< OutputImageType > oit(output, slab);
+    ImageRegionIterator< OutputImageType > fstart = oit;
+    fstart.GoToBegin();
+    ImageRegionIterator< OutputImageType > fend = oit;
+    fend.GoToEnd();
+    for ( typename LineMapType::const_iterator LineIt = LineMap.begin(); LineIt != LineMap.end(); ++LineIt )
+      {
+      for ( typename lineEncoding::const_iterator cIt = LineIt->begin(); cIt != LineIt->end(); ++cIt )
+        {
+        const OutputPixelType lab = static_cast< OutputPixelType >( m_ComponentLabels[firstComponent + cIt->label] );
+        oit.SetIndex(cIt->where);
+        // initialize the non labelled pixels
+        for (; fstart != oit; ++fstart )
+          {
+          fstart.Set(m_BackgroundValue);
+          }
+        for ( SizeValueType j = 0; j < (SizeValueType) cIt->length; ++j, ++oit )
+          {
+          oit.Set(lab);
+          }
+        fstart = oit;
+        }
+      }
+    // fill the rest of the slab with background value
+    for (; fstart != fend; ++fstart )
+      {
+      fstart.Set(m_BackgroundValue);
+      }
+    }
+}
+
 template< typename TInputImage, typename TOutputImage, typename TMaskImage >
 void
 ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
@@ -659,6 +1070,7 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 
   os << indent << "FullyConnected: "  << m_FullyConnected << std::endl;
   os << indent << "ObjectCount: "  << m_ObjectCount << std::endl;
+  os << indent << "NumberOfStreamDivisions: "  << m_NumberOfStreamDivisions << std::endl;
   os << indent << "BackgroundValue: "
      << static_cast< typename NumericTraits< OutputImagePixelType >::PrintType >( m_BackgroundValue ) << std::endl;
 }
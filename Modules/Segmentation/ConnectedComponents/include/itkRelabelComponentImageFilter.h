@@ -20,6 +20,8 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkImage.h"
+#include "itkRelabelComponentImageFilterThreader.h"
+#include "itksys/hash_map.hxx"
 #include <vector>
 
 namespace itk
@@ -67,9 +69,16 @@ namespace itk
  * controlled via methods in the superclass,
  * InPlaceImageFilter::InPlaceOn() and InPlaceImageFilter::InPlaceOff().
  *
+ * The pixels of the objects are counted by several threads, in tables
+ * indexed by the labels when the labels are small enough, and in hash
+ * maps otherwise. The objects are sorted with a histogram of their sizes,
+ * in a time linear in the number of objects, and the output is relabeled
+ * by several threads. When the input comes from a
+ * ConnectedComponentImageFilter, the counting can be skipped by passing
+ * its object sizes to SetSizeOfInputObjectsInPixels().
+ *
  * \sa ConnectedComponentImageFilter, BinaryThresholdImageFilter, ThresholdImageFilter
  *
- * \ingroup SingleThreaded
  * \ingroup ITKConnectedComponents
  *
  * \wiki
@@ -177,6 +186,24 @@ public:
   itkGetConstMacro(SortByObjectSize, bool);
   itkBooleanMacro(SortByObjectSize);
 
+  /** Set the size in pixels of each object of the input, in the order of
+   * the labels, so that the input is not read to count them: label #1 has
+   * sizes[0] pixels, label #2 has sizes[1] pixels, etc. It is typically
+   * ConnectedComponentImageFilter::GetSizeOfObjectsInPixels(), with a
+   * background value of 0, once the connected component filter has been
+   * updated. The sizes must match the input; they are not updated when
+   * the input changes. An empty container, the default, makes the filter
+   * count the pixels. */
+  void SetSizeOfInputObjectsInPixels(const ObjectSizeInPixelsContainerType & sizes)
+  {
+    this->m_SizeOfInputObjectsInPixels = sizes;
+    this->Modified();
+  }
+  const ObjectSizeInPixelsContainerType & GetSizeOfInputObjectsInPixels() const
+  {
+    return this->m_SizeOfInputObjectsInPixels;
+  }
+
   /** Get the size of each object in pixels. This information is only
    * valid after the filter has executed.  Size of the background is
    * not calculated.  Size of object #1 is
@@ -251,14 +278,21 @@ protected:
   RelabelComponentImageFilter():
     m_NumberOfObjects(0), m_NumberOfObjectsToPrint(10),
     m_OriginalNumberOfObjects(0), m_MinimumObjectSize(0),
-    m_SortByObjectSize(true)
+    m_SortByObjectSize(true),
+    m_Threader(ThreaderType::New()),
+    m_DenseRelabelMap(true), m_MaximumLabel(0)
   { this->InPlaceOff(); }
   virtual ~RelabelComponentImageFilter() {}
 
-  /**
-   * Standard pipeline method.
-   */
-  void GenerateData() ITK_OVERRIDE;
+  /** Count the pixels of the objects, sort them and build the table of the
+   * new labels. */
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  /** Relabel the output. */
+  void ThreadedGenerateData(const RegionType & outputRegionForThread,
+                            ThreadIdType threadId) ITK_OVERRIDE;
+
+  void AfterThreadedGenerateData() ITK_OVERRIDE;
 
   /** RelabelComponentImageFilter needs the entire input. Therefore
    * it must provide an implementation GenerateInputRequestedRegion().
@@ -306,6 +340,16 @@ private:
   RelabelComponentImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
+  typedef RelabelComponentImageFilterThreader< Self > ThreaderType;
+  friend class RelabelComponentImageFilterThreader< Self >;
+
+  typedef std::vector< RelabelComponentObjectType > ObjectContainerType;
+  typedef itksys::hash_map< LabelType, LabelType >  RelabelMapType;
+
+  /** Sort the objects, given in increasing label order, by decreasing
+   * size. The objects of the same size keep their order. */
+  static void SortObjectsBySize(ObjectContainerType & objects);
+
   LabelType      m_NumberOfObjects;
   LabelType      m_NumberOfObjectsToPrint;
   LabelType      m_OriginalNumberOfObjects;
@@ -314,6 +358,13 @@ private:
 
   ObjectSizeInPixelsContainerType         m_SizeOfObjectsInPixels;
   ObjectSizeInPhysicalUnitsContainerType  m_SizeOfObjectsInPhysicalUnits;
+  ObjectSizeInPixelsContainerType         m_SizeOfInputObjectsInPixels;
+
+  typename ThreaderType::Pointer m_Threader;
+  bool                           m_DenseRelabelMap;
+  LabelType                      m_MaximumLabel;
+  std::vector< LabelType >       m_DenseRelabelTable;
+  RelabelMapType                 m_SparseRelabelTable;
 };
 } // end namespace itk
 
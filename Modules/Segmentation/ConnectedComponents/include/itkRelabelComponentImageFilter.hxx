@@ -22,8 +22,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
-#include "itksys/hash_map.hxx"
-#include <map>
+#include <algorithm>
 
 namespace itk
 {
@@ -46,132 +45,97 @@ RelabelComponentImageFilter< TInputImage, TOutputImage >
 template< typename TInputImage, typename TOutputImage >
 void
 RelabelComponentImageFilter< TInputImage, TOutputImage >
-::GenerateData()
+::BeforeThreadedGenerateData()
 {
-  SizeValueType i;
-
-  // Use a map to keep track of the size of each object.  Object
-  // number -> ObjectType (which has Object number and the two sizes)
-  typedef itksys::hash_map< LabelType, RelabelComponentObjectType > MapType;
-  MapType sizeMap;
-  typename MapType::iterator mapIt;
-  typedef typename MapType::value_type MapValueType;
-
-  // Get the input and the output
   typename TInputImage::ConstPointer input = this->GetInput();
-  typename TOutputImage::Pointer output = this->GetOutput();
-
-  // Setup a progress reporter.  We have 2 stages to the algorithm so
-  // use the total number of pixels accessed. We walk the entire input
-  // in the first pass, then walk just the output requested region in
-  // the second pass.
-  ProgressReporter progress( this, 0,
-                             input->GetRequestedRegion().GetNumberOfPixels()
-                             + output->GetRequestedRegion().GetNumberOfPixels() );
 
   // Calculate the size of pixel
   float physicalPixelSize = 1.0;
-  for ( i = 0; i < TInputImage::ImageDimension; ++i )
+  for ( unsigned int d = 0; d < TInputImage::ImageDimension; ++d )
     {
-    physicalPixelSize *= input->GetSpacing()[i];
+    physicalPixelSize *= input->GetSpacing()[d];
     }
 
-  RelabelComponentObjectType initialSize;
-  initialSize.m_SizeInPixels = 1;
-  initialSize.m_SizeInPhysicalUnits = physicalPixelSize;
-
-  // First pass: walk the entire input image and determine what
-  // labels are used and the number of pixels used in each label.
-  //
-
-  // walk the input
-  ImageRegionConstIterator< InputImageType > it( input, input->GetRequestedRegion() );
-  it.GoToBegin();
-
-  while ( !it.IsAtEnd() )
+  // First pass: determine what labels are used and the number of pixels
+  // used in each label, unless they were given by the user. The objects
+  // are listed in increasing label order.
+  ObjectContainerType objects;
+  if ( !m_SizeOfInputObjectsInPixels.empty() )
     {
-    // Get the input pixel value
-    const LabelType inputValue = static_cast< LabelType >( it.Get() );
-
-    // if the input pixel is not the background
-    if ( inputValue != NumericTraits< LabelType >::ZeroValue() )
+    for ( SizeValueType i = 0; i < m_SizeOfInputObjectsInPixels.size(); ++i )
       {
-      // Does this label already exist
-      mapIt = sizeMap.find(inputValue);
-      if ( mapIt == sizeMap.end() )
+      if ( m_SizeOfInputObjectsInPixels[i] > 0 )
         {
-        // label is not currently in the map
-        initialSize.m_ObjectNumber = inputValue;
-        sizeMap.insert( MapValueType(inputValue, initialSize) );
-        }
-      else
-        {
-        // label is already in the map, update the values
-        ( *mapIt ).second.m_SizeInPixels++;
-        ( *mapIt ).second.m_SizeInPhysicalUnits += physicalPixelSize;
+        RelabelComponentObjectType object;
+        object.m_ObjectNumber = static_cast< LabelType >( i + 1 );
+        object.m_SizeInPixels = m_SizeOfInputObjectsInPixels[i];
+        objects.push_back( object );
         }
       }
-
-    // increment the iterators
-    ++it;
-    progress.CompletedPixel();
+    m_DenseRelabelMap = true;
+    m_MaximumLabel = static_cast< LabelType >( m_SizeOfInputObjectsInPixels.size() );
     }
+  else
+    {
+    m_Threader->CountObjects( this, input, objects );
+    m_DenseRelabelMap = m_Threader->GetDense();
+    m_MaximumLabel = m_Threader->GetMaximumLabel();
+    }
+  this->UpdateProgress( 0.5f );
 
-  // Now we need to reorder the labels. Use the m_ObjectSortingOrder
-  // to determine how to sort the objects. Define a map for converting
-  // input labels to output labels.
-  //
-  typedef std::vector< RelabelComponentObjectType > VectorType;
-  VectorType sizeVector;
-  typename VectorType::iterator vit;
-
-  typedef std::map< LabelType, LabelType >    RelabelMapType;
-  typedef typename RelabelMapType::value_type RelabelMapValueType;
-  RelabelMapType relabelMap;
-
-  // copy the original object map to a vector so we can sort it
-  for ( mapIt = sizeMap.begin(); mapIt != sizeMap.end(); ++mapIt )
+  for ( typename ObjectContainerType::iterator vit = objects.begin(); vit != objects.end(); ++vit )
     {
-    sizeVector.push_back( ( *mapIt ).second );
+    vit->m_SizeInPhysicalUnits = vit->m_SizeInPixels * physicalPixelSize;
     }
 
   // Sort the objects by size by default, unless m_SortByObjectSize
   // is set to false.
   if ( m_SortByObjectSize )
     {
-    std::sort(  sizeVector.begin(),
-                sizeVector.end(),
-                RelabelComponentSizeInPixelsComparator() );
+    SortObjectsBySize( objects );
     }
 
   // create a lookup table to map the input label to the output label.
   // cache the object sizes for later access by the user
-  m_NumberOfObjects = static_cast<LabelType>( sizeVector.size() );
-  m_OriginalNumberOfObjects = static_cast<LabelType>( sizeVector.size() );
+  m_NumberOfObjects = static_cast<LabelType>( objects.size() );
+  m_OriginalNumberOfObjects = static_cast<LabelType>( objects.size() );
   m_SizeOfObjectsInPixels.clear();
   m_SizeOfObjectsInPixels.resize(m_NumberOfObjects);
   m_SizeOfObjectsInPhysicalUnits.clear();
   m_SizeOfObjectsInPhysicalUnits.resize(m_NumberOfObjects);
+  if ( m_DenseRelabelMap )
+    {
+    m_DenseRelabelTable.assign( m_MaximumLabel + 1, NumericTraits< LabelType >::ZeroValue() );
+    }
   int NumberOfObjectsRemoved = 0;
-  for ( i = 0, vit = sizeVector.begin(); vit != sizeVector.end(); ++vit, ++i )
+  SizeValueType i = 0;
+  for ( typename ObjectContainerType::const_iterator vit = objects.begin(); vit != objects.end(); ++vit, ++i )
     {
     // if we find an object smaller than the minimum size, we
     // terminate the loop.
-    if ( m_MinimumObjectSize > 0 && ( *vit ).m_SizeInPixels < m_MinimumObjectSize )
+    LabelType outputLabel = NumericTraits< LabelType >::ZeroValue();
+    if ( m_MinimumObjectSize > 0 && vit->m_SizeInPixels < m_MinimumObjectSize )
       {
       // map small objects to the background
       NumberOfObjectsRemoved++;
-      relabelMap.insert( RelabelMapValueType( ( *vit ).m_ObjectNumber, 0 ) );
       }
     else
       {
       // map for input labels to output labels (Note we use i+1 in the
       // map since index 0 is the background)
-      relabelMap.insert( RelabelMapValueType( ( *vit ).m_ObjectNumber, i + 1 ) );
+      outputLabel = static_cast< LabelType >( i + 1 );
 
       // cache object sizes for later access by the user
-      m_SizeOfObjectsInPixels[i] = ( *vit ).m_SizeInPixels;
-      m_SizeOfObjectsInPhysicalUnits[i] = ( *vit ).m_SizeInPhysicalUnits;
+      m_SizeOfObjectsInPixels[i] = vit->m_SizeInPixels;
+      m_SizeOfObjectsInPhysicalUnits[i] = vit->m_SizeInPhysicalUnits;
+      }
+    if ( m_DenseRelabelMap )
+      {
+      m_DenseRelabelTable[vit->m_ObjectNumber] = outputLabel;
+      }
+    else
+      {
+      m_SparseRelabelTable[vit->m_ObjectNumber] = outputLabel;
       }
     }
 
@@ -183,39 +147,53 @@ RelabelComponentImageFilter< TInputImage, TOutputImage >
     m_SizeOfObjectsInPixels.resize(m_NumberOfObjects);
     m_SizeOfObjectsInPhysicalUnits.resize(m_NumberOfObjects);
     }
+}
 
+template< typename TInputImage, typename TOutputImage >
+void
+RelabelComponentImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const RegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
   // Second pass: walk just the output requested region and relabel
-  // the necessary pixels.
-  //
-
-  // Allocate the output
-  this->AllocateOutputs();
+  // the necessary pixels. This may be a subset of the input image.
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels(), 100, 0.5f, 0.5f );
 
-  // Remap the labels.  Note we only walk the region of the output
-  // that was requested.  This may be a subset of the input image.
-  OutputPixelType                        outputValue;
-  ImageRegionIterator< OutputImageType > oit;
-  oit = ImageRegionIterator< OutputImageType >( output,
-                                                output->GetRequestedRegion() );
-  it = ImageRegionConstIterator< InputImageType >( input,
-                                                   output->GetRequestedRegion() );
+  ImageRegionConstIterator< InputImageType > it( this->GetInput(), outputRegionForThread );
+  ImageRegionIterator< OutputImageType >     oit( this->GetOutput(), outputRegionForThread );
 
-  it.GoToBegin();
-  oit.GoToBegin();
+  // the labels come in runs: look the label up once per run
+  LabelType       inputLabel = NumericTraits< LabelType >::ZeroValue();
+  OutputPixelType outputValue = static_cast< OutputPixelType >( inputLabel );
   while ( !oit.IsAtEnd() )
     {
     const LabelType inputValue = static_cast< LabelType >( it.Get() );
 
-    if ( inputValue != NumericTraits< LabelType >::ZeroValue() )
-      {
-      // lookup the mapped label
-      outputValue = static_cast< OutputPixelType >( relabelMap[inputValue] );
-      oit.Set(outputValue);
-      }
-    else
+    if ( inputValue != inputLabel )
       {
-      oit.Set(inputValue);
+      inputLabel = inputValue;
+
+      // lookup the mapped label, the labels not found are mapped to
+      // the background
+      LabelType outputLabel = NumericTraits< LabelType >::ZeroValue();
+      if ( m_DenseRelabelMap )
+        {
+        if ( inputValue <= m_MaximumLabel )
+          {
+          outputLabel = m_DenseRelabelTable[inputValue];
+          }
+        }
+      else
+        {
+        typename RelabelMapType::const_iterator mapIt = m_SparseRelabelTable.find( inputValue );
+        if ( mapIt != m_SparseRelabelTable.end() )
+          {
+          outputLabel = mapIt->second;
+          }
+        }
+      outputValue = static_cast< OutputPixelType >( outputLabel );
       }
+    oit.Set(outputValue);
 
     // increment the iterators
     ++it;
@@ -224,6 +202,62 @@ RelabelComponentImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< typename TInputImage, typename TOutputImage >
+void
+RelabelComponentImageFilter< TInputImage, TOutputImage >
+::AfterThreadedGenerateData()
+{
+  std::vector< LabelType >().swap( m_DenseRelabelTable );
+  RelabelMapType().swap( m_SparseRelabelTable );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+RelabelComponentImageFilter< TInputImage, TOutputImage >
+::SortObjectsBySize(ObjectContainerType & objects)
+{
+  // The objects are in increasing label order, so a stable counting sort
+  // on the sizes keeps the order of RelabelComponentSizeInPixelsComparator.
+  // Most of the objects are smaller than the number of objects and are
+  // counted in a histogram of their sizes; the few larger objects are
+  // sorted by comparison and placed first.
+  const SizeValueType numberOfObjects = objects.size();
+
+  ObjectContainerType          sorted;
+  std::vector< SizeValueType > histogram( numberOfObjects + 1, 0 );
+  for ( typename ObjectContainerType::const_iterator vit = objects.begin(); vit != objects.end(); ++vit )
+    {
+    if ( vit->m_SizeInPixels <= numberOfObjects )
+      {
+      ++histogram[vit->m_SizeInPixels];
+      }
+    else
+      {
+      sorted.push_back( *vit );
+      }
+    }
+  std::sort( sorted.begin(), sorted.end(), RelabelComponentSizeInPixelsComparator() );
+
+  // the first position of each size, from the largest to the smallest
+  SizeValueType position = sorted.size();
+  for ( SizeValueType size = numberOfObjects; size > 0; --size )
+    {
+    const SizeValueType count = histogram[size];
+    histogram[size] = position;
+    position += count;
+    }
+
+  sorted.resize( numberOfObjects );
+  for ( typename ObjectContainerType::const_iterator vit = objects.begin(); vit != objects.end(); ++vit )
+    {
+    if ( vit->m_SizeInPixels <= numberOfObjects )
+      {
+      sorted[histogram[vit->m_SizeInPixels]++] = *vit;
+      }
+    }
+  objects.swap( sorted );
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 RelabelComponentImageFilter< TInputImage, TOutputImage >
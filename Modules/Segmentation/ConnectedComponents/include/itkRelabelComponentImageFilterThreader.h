@@ -0,0 +1,127 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRelabelComponentImageFilterThreader_h
+#define itkRelabelComponentImageFilterThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedImageRegionPartitioner.h"
+#include "itksys/hash_map.hxx"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class RelabelComponentImageFilterThreader
+ * \brief Counts the pixels of the objects of the input of
+ * RelabelComponentImageFilter.
+ *
+ * A first execution finds the largest label of the input. The pixels of
+ * each label are then counted by each thread in a table indexed by the
+ * labels, or in a hash map when the tables of all the threads would hold
+ * more entries than the image has pixels. The tables of the threads are
+ * merged at the end.
+ *
+ * \ingroup ITKConnectedComponents
+ */
+template< typename TRelabelComponentImageFilter >
+class RelabelComponentImageFilterThreader
+  : public DomainThreader< ThreadedImageRegionPartitioner< TRelabelComponentImageFilter::ImageDimension >,
+                           TRelabelComponentImageFilter >
+{
+public:
+  /** Standard class typedefs. */
+  typedef RelabelComponentImageFilterThreader                                  Self;
+  typedef DomainThreader< ThreadedImageRegionPartitioner< TRelabelComponentImageFilter::ImageDimension >,
+                          TRelabelComponentImageFilter >                       Superclass;
+  typedef SmartPointer< Self >                                                 Pointer;
+  typedef SmartPointer< const Self >                                           ConstPointer;
+
+  itkTypeMacro( RelabelComponentImageFilterThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef typename TRelabelComponentImageFilter::InputImageType             InputImageType;
+  typedef typename TRelabelComponentImageFilter::LabelType                  LabelType;
+  typedef typename TRelabelComponentImageFilter::ObjectSizeType             ObjectSizeType;
+  typedef typename TRelabelComponentImageFilter::RelabelComponentObjectType ObjectType;
+  typedef std::vector< ObjectType >                                         ObjectContainerType;
+
+  /** Count the pixels of the objects of \c input, and append the objects
+   * to \c objects in increasing label order. Only the sizes in pixels are
+   * set. */
+  void CountObjects( AssociateType *associate, const InputImageType *input, ObjectContainerType & objects );
+
+  /** Whether the labels of the last counted input were counted in tables
+   * indexed by the labels. */
+  bool GetDense() const
+  {
+    return m_Dense;
+  }
+
+  /** The largest label of the last counted input. */
+  LabelType GetMaximumLabel() const
+  {
+    return m_MaximumLabel;
+  }
+
+protected:
+  RelabelComponentImageFilterThreader();
+  virtual ~RelabelComponentImageFilterThreader() {}
+
+  /** Allocate the tables of the threads. */
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  /** Find the largest label, or count the labels, of \c subdomain. */
+  virtual void ThreadedExecution( const DomainType & subdomain,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+  RelabelComponentImageFilterThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  typedef std::vector< ObjectSizeType >                 DenseTableType;
+  typedef itksys::hash_map< LabelType, ObjectSizeType > SparseTableType;
+
+  struct ObjectNumberLess
+  {
+    bool operator()( const ObjectType & a, const ObjectType & b ) const
+    {
+      return a.m_ObjectNumber < b.m_ObjectNumber;
+    }
+  };
+
+  bool                           m_CountPass;
+  bool                           m_Dense;
+  LabelType                      m_MaximumLabel;
+  const InputImageType *         m_Input;
+  std::vector< LabelType >       m_MaximumLabels;
+  std::vector< DenseTableType >  m_DenseTables;
+  std::vector< SparseTableType > m_SparseTables;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkRelabelComponentImageFilterThreader.hxx"
+#endif
+
+#endif
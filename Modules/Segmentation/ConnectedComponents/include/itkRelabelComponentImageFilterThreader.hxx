@@ -0,0 +1,191 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRelabelComponentImageFilterThreader_hxx
+#define itkRelabelComponentImageFilterThreader_hxx
+
+#include "itkRelabelComponentImageFilterThreader.h"
+#include "itkImageRegionConstIterator.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template< typename TRelabelComponentImageFilter >
+RelabelComponentImageFilterThreader< TRelabelComponentImageFilter >
+::RelabelComponentImageFilterThreader() :
+  m_CountPass( false ),
+  m_Dense( true ),
+  m_MaximumLabel( 0 ),
+  m_Input( ITK_NULLPTR )
+{
+}
+
+template< typename TRelabelComponentImageFilter >
+void
+RelabelComponentImageFilterThreader< TRelabelComponentImageFilter >
+::CountObjects( AssociateType *associate, const InputImageType *input, ObjectContainerType & objects )
+{
+  const DomainType & region = input->GetRequestedRegion();
+  m_Input = input;
+  this->SetMaximumNumberOfThreads( associate->GetNumberOfThreads() );
+
+  // find the largest label
+  m_CountPass = false;
+  this->Execute( associate, region );
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  m_MaximumLabel = *std::max_element( m_MaximumLabels.begin(), m_MaximumLabels.end() );
+
+  // the tables of the threads are indexed by the labels if they do not hold
+  // more entries than the image has pixels
+  m_Dense = m_MaximumLabel < region.GetNumberOfPixels() / numberOfThreads;
+
+  // count the labels
+  m_CountPass = true;
+  this->Execute( associate, region );
+
+  if ( m_Dense )
+    {
+    DenseTableType & sizes = m_DenseTables[0];
+    for ( ThreadIdType i = 1; i < m_DenseTables.size(); ++i )
+      {
+      const DenseTableType & threadSizes = m_DenseTables[i];
+      for ( SizeValueType label = 1; label < sizes.size(); ++label )
+        {
+        sizes[label] += threadSizes[label];
+        }
+      DenseTableType().swap( m_DenseTables[i] );
+      }
+    for ( SizeValueType label = 1; label < sizes.size(); ++label )
+      {
+      if ( sizes[label] > 0 )
+        {
+        ObjectType object;
+        object.m_ObjectNumber = static_cast< LabelType >( label );
+        object.m_SizeInPixels = sizes[label];
+        object.m_SizeInPhysicalUnits = 0.0f;
+        objects.push_back( object );
+        }
+      }
+    m_DenseTables.clear();
+    }
+  else
+    {
+    SparseTableType & sizes = m_SparseTables[0];
+    for ( ThreadIdType i = 1; i < m_SparseTables.size(); ++i )
+      {
+      for ( typename SparseTableType::const_iterator it = m_SparseTables[i].begin(); it != m_SparseTables[i].end(); ++it )
+        {
+        sizes[it->first] += it->second;
+        }
+      SparseTableType().swap( m_SparseTables[i] );
+      }
+    const SizeValueType first = objects.size();
+    for ( typename SparseTableType::const_iterator it = sizes.begin(); it != sizes.end(); ++it )
+      {
+      ObjectType object;
+      object.m_ObjectNumber = it->first;
+      object.m_SizeInPixels = it->second;
+      object.m_SizeInPhysicalUnits = 0.0f;
+      objects.push_back( object );
+      }
+    std::sort( objects.begin() + first, objects.end(), ObjectNumberLess() );
+    m_SparseTables.clear();
+    }
+  m_Input = ITK_NULLPTR;
+}
+
+template< typename TRelabelComponentImageFilter >
+void
+RelabelComponentImageFilterThreader< TRelabelComponentImageFilter >
+::BeforeThreadedExecution()
+{
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  if ( !m_CountPass )
+    {
+    m_MaximumLabels.assign( numberOfThreads, NumericTraits< LabelType >::ZeroValue() );
+    }
+  else if ( m_Dense )
+    {
+    m_DenseTables.resize( numberOfThreads );
+    for ( ThreadIdType i = 0; i < numberOfThreads; ++i )
+      {
+      m_DenseTables[i].assign( m_MaximumLabel + 1, 0 );
+      }
+    }
+  else
+    {
+    m_SparseTables.resize( numberOfThreads );
+    }
+}
+
+template< typename TRelabelComponentImageFilter >
+void
+RelabelComponentImageFilterThreader< TRelabelComponentImageFilter >
+::ThreadedExecution( const DomainType & subdomain, const ThreadIdType threadId )
+{
+  const LabelType background = NumericTraits< LabelType >::ZeroValue();
+  ImageRegionConstIterator< InputImageType > it( m_Input, subdomain );
+
+  if ( !m_CountPass )
+    {
+    LabelType maximumLabel = background;
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      maximumLabel = std::max( maximumLabel, static_cast< LabelType >( it.Get() ) );
+      }
+    m_MaximumLabels[threadId] = maximumLabel;
+    }
+  else if ( m_Dense )
+    {
+    DenseTableType & sizes = m_DenseTables[threadId];
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      ++sizes[static_cast< LabelType >( it.Get() )];
+      }
+    }
+  else
+    {
+    // the labels come in runs: count the runs before looking them up
+    SparseTableType & sizes = m_SparseTables[threadId];
+    LabelType         label = background;
+    ObjectSizeType    run = 0;
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      const LabelType value = static_cast< LabelType >( it.Get() );
+      if ( value != label )
+        {
+        if ( label != background )
+          {
+          sizes[label] += run;
+          }
+        label = value;
+        run = 0;
+        }
+      ++run;
+      }
+    if ( label != background )
+      {
+      sizes[label] += run;
+      }
+    }
+}
+
+} // end namespace itk
+
+#endif
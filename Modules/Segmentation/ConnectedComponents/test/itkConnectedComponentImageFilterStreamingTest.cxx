@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConnectedComponentImageFilter.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+// Label a random binary image, optionally masked, with and without
+// streaming, and compare the labels and the sizes of the objects.
+template< unsigned int VDimension >
+int
+ConnectedComponentImageFilterStreamingTest( unsigned int sizeValue, double foreground, bool useMask )
+{
+  typedef itk::Image< float, VDimension >                        RandomImageType;
+  typedef itk::Image< unsigned char, VDimension >                BinaryImageType;
+  typedef itk::Image< unsigned int, VDimension >                 LabelImageType;
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+  typename RandomImageType::SizeType size;
+  size.Fill( sizeValue );
+  size[0] += 7;
+
+  typename RandomImageType::Pointer random = RandomImageType::New();
+  random->SetRegions( size );
+  random->Allocate();
+
+  typename BinaryImageType::Pointer mask = BinaryImageType::New();
+  mask->SetRegions( size );
+  mask->Allocate();
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 42 );
+  itk::ImageRegionIterator< RandomImageType > rit( random, random->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< BinaryImageType > mit( mask, mask->GetLargestPossibleRegion() );
+  for ( ; !rit.IsAtEnd(); ++rit, ++mit )
+    {
+    rit.Set( static_cast< float >( generator->GetVariateWithClosedRange() ) );
+    mit.Set( generator->GetVariateWithClosedRange() < 0.9 ? 1 : 0 );
+    }
+
+  // the binary image is produced by a filter, so that it can be streamed
+  typedef itk::BinaryThresholdImageFilter< RandomImageType, BinaryImageType > ThresholdType;
+  typename ThresholdType::Pointer threshold = ThresholdType::New();
+  threshold->SetInput( random );
+  threshold->SetUpperThreshold( static_cast< float >( foreground ) );
+  threshold->SetInsideValue( 1 );
+  threshold->SetOutsideValue( 0 );
+
+  typedef itk::ConnectedComponentImageFilter< BinaryImageType, LabelImageType, BinaryImageType > FilterType;
+  typedef itk::StreamingImageFilter< LabelImageType, LabelImageType >                            StreamerType;
+
+  for ( unsigned int fullyConnected = 0; fullyConnected < 2; ++fullyConnected )
+    {
+    typename FilterType::Pointer reference = FilterType::New();
+    reference->SetInput( threshold->GetOutput() );
+    if ( useMask )
+      {
+      reference->SetMaskImage( mask );
+      }
+    reference->SetFullyConnected( fullyConnected );
+    TRY_EXPECT_NO_EXCEPTION( reference->Update() );
+
+    const unsigned int divisions[] = { 2, 5, sizeValue + 3 };
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      // a threshold filter which has not produced the whole image yet
+      typename ThresholdType::Pointer streamedThreshold = ThresholdType::New();
+      streamedThreshold->SetInput( random );
+      streamedThreshold->SetUpperThreshold( static_cast< float >( foreground ) );
+      streamedThreshold->SetInsideValue( 1 );
+      streamedThreshold->SetOutsideValue( 0 );
+
+      typename FilterType::Pointer filter = FilterType::New();
+      filter->SetInput( streamedThreshold->GetOutput() );
+      if ( useMask )
+        {
+        filter->SetMaskImage( mask );
+        }
+      filter->SetFullyConnected( fullyConnected );
+      filter->SetNumberOfStreamDivisions( divisions[d] );
+      TEST_SET_GET_VALUE( divisions[d], filter->GetNumberOfStreamDivisions() );
+
+      // stream the output in pieces which are not aligned on the slabs
+      typename StreamerType::Pointer streamer = StreamerType::New();
+      streamer->SetInput( filter->GetOutput() );
+      streamer->SetNumberOfStreamDivisions( 3 );
+      TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+
+      if ( streamedThreshold->GetOutput()->GetBufferedRegion()
+           == streamedThreshold->GetOutput()->GetLargestPossibleRegion() )
+        {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "The input was not streamed." << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      if ( filter->GetObjectCount() != reference->GetObjectCount() )
+        {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Dimension: " << VDimension << ", FullyConnected: " << fullyConnected
+                  << ", divisions: " << divisions[d] << std::endl;
+        std::cerr << "ObjectCount is " << filter->GetObjectCount()
+                  << " instead of " << reference->GetObjectCount() << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      std::vector< itk::SizeValueType > sizes( reference->GetObjectCount(), 0 );
+      itk::ImageRegionIterator< LabelImageType > it( reference->GetOutput(),
+                                                     reference->GetOutput()->GetLargestPossibleRegion() );
+      itk::ImageRegionIterator< LabelImageType > sit( streamer->GetOutput(),
+                                                      streamer->GetOutput()->GetLargestPossibleRegion() );
+      for ( ; !it.IsAtEnd(); ++it, ++sit )
+        {
+        if ( it.Get() != sit.Get() )
+          {
+          std::cerr << "Test failed!" << std::endl;
+          std::cerr << "Dimension: " << VDimension << ", FullyConnected: " << fullyConnected
+                    << ", divisions: " << divisions[d] << std::endl;
+          std::cerr << "Label at " << it.GetIndex() << " is " << sit.Get()
+                    << " instead of " << it.Get() << std::endl;
+          return EXIT_FAILURE;
+          }
+        if ( it.Get() != 0 )
+          {
+          ++sizes[it.Get() - 1];
+          }
+        }
+      if ( sizes != filter->GetSizeOfObjectsInPixels() )
+        {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Wrong sizes of the objects." << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+int itkConnectedComponentImageFilterStreamingTest( int, char *[] )
+{
+  typedef itk::Image< unsigned char, 3 >                                   ImageType;
+  typedef itk::ConnectedComponentImageFilter< ImageType, ImageType >       FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, ConnectedComponentImageFilter, ImageToImageFilter );
+  TEST_SET_GET_VALUE( 1, filter->GetNumberOfStreamDivisions() );
+
+  if ( ConnectedComponentImageFilterStreamingTest< 2 >( 173, 0.55, false ) == EXIT_FAILURE
+       || ConnectedComponentImageFilterStreamingTest< 3 >( 31, 0.35, false ) == EXIT_FAILURE
+       || ConnectedComponentImageFilterStreamingTest< 3 >( 29, 0.4, true ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,340 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRelabelComponentImageFilter.h"
+#include "itkConnectedComponentImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <map>
+
+namespace
+{
+
+typedef itk::Image< unsigned char, 2 >              BinaryImageType;
+typedef itk::Image< unsigned int, 2 >               LabelImageType;
+typedef itk::Image< unsigned long, 2 >              LargeLabelImageType;
+typedef std::pair< itk::SizeValueType, unsigned long > ObjectType; // (size, label)
+
+// sort by decreasing size, then by increasing label
+bool LargerObject( const ObjectType & a, const ObjectType & b )
+{
+  if ( a.first != b.first )
+    {
+    return a.first > b.first;
+    }
+  return a.second < b.second;
+}
+
+// Relabel the image as RelabelComponentImageFilter does, with a map and a
+// comparison sort.
+template< typename TImage >
+void
+ReferenceRelabel( const TImage *input, LabelImageType *output, bool sort, itk::SizeValueType minimumSize,
+                  std::vector< itk::SizeValueType > & sizes )
+{
+  std::map< unsigned long, itk::SizeValueType > counts;
+  itk::ImageRegionConstIterator< TImage > it( input, input->GetLargestPossibleRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != 0 )
+      {
+      ++counts[it.Get()];
+      }
+    }
+
+  std::vector< ObjectType > objects;
+  for ( std::map< unsigned long, itk::SizeValueType >::const_iterator mit = counts.begin(); mit != counts.end(); ++mit )
+    {
+    objects.push_back( ObjectType( mit->second, mit->first ) );
+    }
+  if ( sort )
+    {
+    std::sort( objects.begin(), objects.end(), LargerObject );
+    }
+
+  std::map< unsigned long, unsigned int > relabel;
+  sizes.assign( objects.size(), 0 );
+  itk::SizeValueType removed = 0;
+  for ( unsigned int i = 0; i < objects.size(); ++i )
+    {
+    if ( minimumSize > 0 && objects[i].first < minimumSize )
+      {
+      relabel[objects[i].second] = 0;
+      ++removed;
+      }
+    else
+      {
+      relabel[objects[i].second] = i + 1;
+      sizes[i] = objects[i].first;
+      }
+    }
+  sizes.resize( objects.size() - removed );
+
+  itk::ImageRegionIterator< LabelImageType > oit( output, output->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++oit )
+    {
+    oit.Set( it.Get() == 0 ? 0 : relabel[it.Get()] );
+    }
+}
+
+// Check the properties of a relabeling, independently of the reference:
+// each object keeps its pixels under a single label, no object is smaller
+// than the minimum size, and the sizes don't increase when the objects are
+// sorted. The objects which are kept are labeled 1..N with their sizes,
+// except when small objects are removed without sorting: the labels are
+// then the ranks of the objects in the input, as in the original filter.
+template< typename TImage >
+bool
+CheckRelabelProperties( const TImage *input, const LabelImageType *output,
+                        const std::vector< itk::SizeValueType > & sizes, bool sort,
+                        itk::SizeValueType minimumSize )
+{
+  std::map< unsigned long, unsigned int >       labels;
+  std::map< unsigned int, itk::SizeValueType > counts;
+  itk::ImageRegionConstIterator< TImage >         it( input, input->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< LabelImageType > oit( output, input->GetLargestPossibleRegion() );
+  for ( ; !it.IsAtEnd(); ++it, ++oit )
+    {
+    if ( it.Get() == 0 )
+      {
+      if ( oit.Get() != 0 )
+        {
+        std::cerr << "The background has the label " << oit.Get() << " at " << oit.GetIndex() << std::endl;
+        return false;
+        }
+      continue;
+      }
+    std::map< unsigned long, unsigned int >::const_iterator lit = labels.find( it.Get() );
+    if ( lit == labels.end() )
+      {
+      labels[it.Get()] = oit.Get();
+      }
+    else if ( lit->second != oit.Get() )
+      {
+      std::cerr << "The object " << it.Get() << " is split between the labels " << lit->second
+                << " and " << oit.Get() << std::endl;
+      return false;
+      }
+    if ( oit.Get() != 0 )
+      {
+      ++counts[oit.Get()];
+      }
+    }
+
+  const bool consecutive = sort || minimumSize == 0;
+  if ( consecutive && counts.size() != sizes.size() )
+    {
+    std::cerr << counts.size() << " labels for " << sizes.size() << " objects" << std::endl;
+    return false;
+    }
+  itk::SizeValueType previousSize = 0;
+  for ( std::map< unsigned int, itk::SizeValueType >::const_iterator cit = counts.begin(); cit != counts.end(); ++cit )
+    {
+    if ( cit->second < minimumSize
+         || ( consecutive && ( cit->first > sizes.size() || sizes[cit->first - 1] != cit->second ) )
+         || ( sort && cit != counts.begin() && cit->second > previousSize ) )
+      {
+      std::cerr << "The label " << cit->first << " has " << cit->second << " pixels" << std::endl;
+      return false;
+      }
+    previousSize = cit->second;
+    }
+  return true;
+}
+
+template< typename TImage >
+int
+CheckRelabel( const TImage *input, const itk::ConnectedComponentImageFilter< BinaryImageType, LabelImageType > *labeler )
+{
+  typedef itk::RelabelComponentImageFilter< TImage, LabelImageType > FilterType;
+
+  LabelImageType::Pointer expected = LabelImageType::New();
+  expected->CopyInformation( input );
+  expected->SetRegions( input->GetLargestPossibleRegion() );
+  expected->Allocate();
+
+  const double pixelSize = input->GetSpacing()[0] * input->GetSpacing()[1];
+
+  for ( unsigned int sort = 0; sort < 2; ++sort )
+    {
+    for ( itk::SizeValueType minimumSize = 0; minimumSize < 5; minimumSize += 4 )
+      {
+      std::vector< itk::SizeValueType > expectedSizes;
+      ReferenceRelabel( input, expected, sort, minimumSize, expectedSizes );
+
+      for ( unsigned int fused = 0; fused < 2; ++fused )
+        {
+        for ( itk::ThreadIdType threads = 1; threads <= 4; ++threads )
+          {
+          typename FilterType::Pointer relabel = FilterType::New();
+          relabel->SetInput( input );
+          relabel->SetSortByObjectSize( sort );
+          relabel->SetMinimumObjectSize( minimumSize );
+          relabel->SetNumberOfThreads( threads );
+          if ( fused )
+            {
+            relabel->SetSizeOfInputObjectsInPixels( labeler->GetSizeOfObjectsInPixels() );
+            }
+          TRY_EXPECT_NO_EXCEPTION( relabel->Update() );
+
+          itk::ImageRegionConstIterator< LabelImageType > eit( expected, expected->GetLargestPossibleRegion() );
+          itk::ImageRegionConstIterator< LabelImageType > oit( relabel->GetOutput(),
+                                                               expected->GetLargestPossibleRegion() );
+          for ( ; !eit.IsAtEnd(); ++eit, ++oit )
+            {
+            if ( eit.Get() != oit.Get() )
+              {
+              std::cerr << "Test failed!" << std::endl;
+              std::cerr << "Label " << oit.Get() << " instead of " << eit.Get() << " at " << eit.GetIndex()
+                        << " with sort " << sort << ", minimum size " << minimumSize << ", fused " << fused
+                        << " and " << threads << " threads." << std::endl;
+              return EXIT_FAILURE;
+              }
+            }
+
+          if ( !CheckRelabelProperties( input, relabel->GetOutput(), relabel->GetSizeOfObjectsInPixels(), sort,
+                                        minimumSize ) )
+            {
+            std::cerr << "Test failed!" << std::endl;
+            std::cerr << "Wrong relabeling with sort " << sort << ", minimum size " << minimumSize
+                      << ", fused " << fused << " and " << threads << " threads." << std::endl;
+            return EXIT_FAILURE;
+            }
+
+          if ( relabel->GetSizeOfObjectsInPixels() != expectedSizes
+               || relabel->GetNumberOfObjects() != expectedSizes.size() )
+            {
+            std::cerr << "Test failed!" << std::endl;
+            std::cerr << "Wrong object sizes with sort " << sort << ", minimum size " << minimumSize
+                      << ", fused " << fused << " and " << threads << " threads." << std::endl;
+            return EXIT_FAILURE;
+            }
+          for ( unsigned int i = 0; i < expectedSizes.size(); ++i )
+            {
+            if ( relabel->GetSizeOfObjectsInPhysicalUnits()[i] != static_cast< float >( expectedSizes[i] * pixelSize ) )
+              {
+              std::cerr << "Test failed!" << std::endl;
+              std::cerr << "Wrong physical size of object " << i + 1 << ": "
+                        << relabel->GetSizeOfObjectsInPhysicalUnits()[i] << " instead of "
+                        << expectedSizes[i] * pixelSize << std::endl;
+              return EXIT_FAILURE;
+              }
+            }
+          }
+
+        // the sizes cannot be given for labels that are not consecutive
+        if ( labeler == ITK_NULLPTR )
+          {
+          break;
+          }
+        }
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+// Compare the relabeling of the connected components of a random binary
+// image, with several threads, with their sizes given by the connected
+// component filter, and with large labels counted in hash maps, to a
+// sequential relabeling.
+int RelabelComponentImageFilterThreadedTest( double foreground )
+{
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+  BinaryImageType::SizeType size;
+  size[0] = 113;
+  size[1] = 97;
+  BinaryImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 0.25;
+
+  BinaryImageType::Pointer binary = BinaryImageType::New();
+  binary->SetRegions( size );
+  binary->SetSpacing( spacing );
+  binary->Allocate();
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 7 );
+  for ( itk::ImageRegionIterator< BinaryImageType > bit( binary, binary->GetLargestPossibleRegion() );
+        !bit.IsAtEnd(); ++bit )
+    {
+    bit.Set( generator->GetVariateWithClosedRange() < foreground ? 1 : 0 );
+    }
+
+  typedef itk::ConnectedComponentImageFilter< BinaryImageType, LabelImageType > LabelerType;
+  LabelerType::Pointer labeler = LabelerType::New();
+  labeler->SetInput( binary );
+  TRY_EXPECT_NO_EXCEPTION( labeler->Update() );
+
+  // the connected component filter counts its objects in all its modes
+  LabelerType::Pointer sequentialLabeler = LabelerType::New();
+  sequentialLabeler->SetInput( binary );
+  sequentialLabeler->SetNumberOfThreads( 1 );
+  TRY_EXPECT_NO_EXCEPTION( sequentialLabeler->Update() );
+  if ( labeler->GetSizeOfObjectsInPixels().size() != labeler->GetObjectCount()
+       || sequentialLabeler->GetSizeOfObjectsInPixels() != labeler->GetSizeOfObjectsInPixels() )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Wrong object sizes from ConnectedComponentImageFilter." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << labeler->GetObjectCount() << " objects." << std::endl;
+
+  if ( CheckRelabel< LabelImageType >( labeler->GetOutput(), labeler ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // labels larger than the number of pixels are counted in hash maps
+  LargeLabelImageType::Pointer large = LargeLabelImageType::New();
+  large->CopyInformation( labeler->GetOutput() );
+  large->SetRegions( labeler->GetOutput()->GetLargestPossibleRegion() );
+  large->Allocate();
+  itk::ImageRegionConstIterator< LabelImageType > lit( labeler->GetOutput(), large->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< LargeLabelImageType > git( large, large->GetLargestPossibleRegion() );
+  for ( ; !lit.IsAtEnd(); ++lit, ++git )
+    {
+    git.Set( lit.Get() == 0 ? 0 : 1000003UL * ( 10007UL - lit.Get() ) );
+    }
+
+  if ( CheckRelabel< LargeLabelImageType >( large, ITK_NULLPTR ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+int itkRelabelComponentImageFilterThreadedTest( int, char* [] )
+{
+  // a few large objects, larger than the number of objects, are sorted
+  // apart from the histogram of the sizes of the small ones
+  if ( RelabelComponentImageFilterThreadedTest( 0.45 ) == EXIT_FAILURE
+       || RelabelComponentImageFilterThreadedTest( 0.65 ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
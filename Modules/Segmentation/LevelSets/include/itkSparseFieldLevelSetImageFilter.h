@@ -24,6 +24,7 @@
 #include "itkObjectStore.h"
 #include <vector>
 #include "itkNeighborhoodIterator.h"
+#include "itkSparseFieldLevelSetImageFilterThreader.h"
 
 namespace itk
 {
@@ -210,6 +211,15 @@ private:
  * initializes, it will subtract the IsoSurfaceValue from all values, in the
  * input, shifting the isosurface of interest to zero in the output.
  *
+ * \par MULTITHREADING
+ * The change of the active layer, which is where most of the time of an
+ * iteration is spent, is calculated in several threads: the active layer is
+ * split into contiguous ranges of nodes, each evaluated with its own global
+ * data of the difference function, and the time steps of the threads are
+ * combined with ResolveTimeStep. The update of the layers remains
+ * sequential, in the order of the active layer. With a single thread, or
+ * when the active layer is small, the filter behaves exactly as before.
+ *
  * \par IMPORTANT!
  *  Read the documentation for FiniteDifferenceImageFilter before attempting to
  *  use this filter.  The solver requires that you specify a
@@ -370,6 +380,13 @@ protected:
    *  indices to be applied in the current iteration. */
   TimeStepType CalculateChange() ITK_OVERRIDE;
 
+  /** Calculates the change at the nodes [begin, end) of the snapshot of the
+   *  active layer taken by CalculateChange, and stores it at the same
+   *  positions of the update buffer.  Called concurrently by the threads,
+   *  each with its own global data of the difference function. */
+  void CalculateChangeOfNodes(SizeValueType begin, SizeValueType end,
+                              void *globalData);
+
   /** Initializes a layer of the sparse field using a previously initialized
    * layer. Builds the list of nodes in m_Layer[to] using m_Layer[from].
    * Marks values in the m_StatusImage. */
@@ -480,6 +497,10 @@ protected:
    *  CalculateChange. */
   UpdateBufferType m_UpdateBuffer;
 
+  /** The nodes of the active layer, in the order of the layer, while the
+   *  change is calculated. */
+  std::vector< const LayerNodeType * > m_ActiveLayerNodes;
+
   /** The RMS change calculated from each update.  Can be used by a subclass to
    *  determine halting criteria.  Valid only for the previous iteration, not
    *  during the current iteration.  Calculated in ApplyUpdate. */
@@ -498,6 +519,11 @@ private:
   SparseFieldLevelSetImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
+  typedef SparseFieldLevelSetImageFilterThreader< Self > CalculateChangeThreaderType;
+  friend class SparseFieldLevelSetImageFilterThreader< Self >;
+
+  typename CalculateChangeThreaderType::Pointer m_CalculateChangeThreader;
+
   /** This flag is true when methods need to check boundary conditions and
       false when methods do not need to check for boundary conditions. */
   bool m_BoundsCheckingActive;
@@ -140,6 +140,7 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
 {
   m_LayerNodeStore = LayerNodeStorageType::New();
   m_LayerNodeStore->SetGrowthStrategyToExponential();
+  m_CalculateChangeThreader = CalculateChangeThreaderType::New();
   this->SetRMSChange( static_cast< double >( m_ValueZero ) );
 }
 
@@ -901,6 +902,66 @@ typename
 SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >::TimeStepType
 SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
 ::CalculateChange()
+{
+  // Below this number of active layer nodes per thread, the overhead of
+  // the threads outweighs the evaluation of the difference function.
+  const SizeValueType minimumNumberOfNodesPerThread = 256;
+
+  const typename Superclass::FiniteDifferenceFunctionType::Pointer df =
+    this->GetDifferenceFunction();
+  TimeStepType timeStep;
+
+  // Take a snapshot of the active layer so that it can be split among the
+  // threads.  The update values are stored at the positions of their nodes
+  // in the layer, which is the order expected by UpdateActiveLayerValues.
+  m_ActiveLayerNodes.clear();
+  m_ActiveLayerNodes.reserve( m_Layers[0]->Size() );
+  for ( typename LayerType::ConstIterator layerIt = m_Layers[0]->Begin();
+        layerIt != m_Layers[0]->End(); ++layerIt )
+    {
+    m_ActiveLayerNodes.push_back( layerIt.GetPointer() );
+    }
+  const SizeValueType numberOfNodes = static_cast< SizeValueType >( m_ActiveLayerNodes.size() );
+
+  m_UpdateBuffer.clear();
+  m_UpdateBuffer.resize(numberOfNodes);
+
+  const SizeValueType maximumNumberOfThreads =
+    std::min( static_cast< SizeValueType >( this->GetNumberOfThreads() ),
+              numberOfNodes / minimumNumberOfNodesPerThread );
+
+  if ( maximumNumberOfThreads > 1 )
+    {
+    typename CalculateChangeThreaderType::DomainType completeDomain;
+    completeDomain[0] = 0;
+    completeDomain[1] = numberOfNodes - 1;
+    m_CalculateChangeThreader->SetMaximumNumberOfThreads( static_cast< ThreadIdType >( maximumNumberOfThreads ) );
+    m_CalculateChangeThreader->Execute(this, completeDomain);
+    timeStep = m_CalculateChangeThreader->GetTimeStep();
+    }
+  else
+    {
+    void *globalData = df->GetGlobalDataPointer();
+
+    this->CalculateChangeOfNodes(0, numberOfNodes, globalData);
+
+    // Ask the finite difference function to compute the time step for
+    // this iteration.  We give it the global data pointer to use, then
+    // ask it to free the global data memory.
+    timeStep = df->ComputeGlobalTimeStep(globalData);
+
+    df->ReleaseGlobalDataPointer(globalData);
+    }
+
+  m_ActiveLayerNodes.clear();
+
+  return timeStep;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::CalculateChangeOfNodes(SizeValueType begin, SizeValueType end, void *globalData)
 {
   const typename Superclass::FiniteDifferenceFunctionType::Pointer df =
     this->GetDifferenceFunction();
@@ -919,28 +980,21 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
     MIN_NORM *= minSpacing;
     }
 
-  void *globalData = df->GetGlobalDataPointer();
-
-  typename LayerType::ConstIterator layerIt;
   NeighborhoodIterator< OutputImageType > outputIt( df->GetRadius(),
                                                     this->m_OutputImage, this->m_OutputImage->GetRequestedRegion() );
-  TimeStepType timeStep;
 
   if ( m_BoundsCheckingActive == false )
     {
     outputIt.NeedToUseBoundaryConditionOff();
     }
 
-  m_UpdateBuffer.clear();
-  m_UpdateBuffer.reserve( m_Layers[0]->Size() );
-
   // Calculates the update values for the active layer indices in this
-  // iteration.  Iterates through the active layer index list, applying
+  // range.  Iterates through the active layer index list, applying
   // the level set function to the output image (level set image) at each
   // index.  Update values are stored in the update buffer.
-  for ( layerIt = m_Layers[0]->Begin(); layerIt != m_Layers[0]->End(); ++layerIt )
+  for ( SizeValueType n = begin; n < end; ++n )
     {
-    outputIt.SetLocation(layerIt->m_Value);
+    outputIt.SetLocation(m_ActiveLayerNodes[n]->m_Value);
 
     // Calculate the offset to the surface from the center of this
     // neighborhood.  This is used by some level set functions in sampling a
@@ -993,22 +1047,13 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
         offset[i] = ( offset[i] * centerValue ) / ( norm_grad_phi_squared + MIN_NORM );
         }
 
-      m_UpdateBuffer.push_back( df->ComputeUpdate(outputIt, globalData, offset) );
+      m_UpdateBuffer[n] = df->ComputeUpdate(outputIt, globalData, offset);
       }
     else // Don't do interpolation
       {
-      m_UpdateBuffer.push_back( df->ComputeUpdate(outputIt, globalData) );
+      m_UpdateBuffer[n] = df->ComputeUpdate(outputIt, globalData);
       }
     }
-
-  // Ask the finite difference function to compute the time step for
-  // this iteration.  We give it the global data pointer to use, then
-  // ask it to free the global data memory.
-  timeStep = df->ComputeGlobalTimeStep(globalData);
-
-  df->ReleaseGlobalDataPointer(globalData);
-
-  return timeStep;
 }
 
 template< typename TInputImage, typename TOutputImage >
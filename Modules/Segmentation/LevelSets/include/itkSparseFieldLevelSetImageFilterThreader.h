@@ -0,0 +1,101 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSparseFieldLevelSetImageFilterThreader_h
+#define itkSparseFieldLevelSetImageFilterThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class SparseFieldLevelSetImageFilterThreader
+ * \brief Calculates the change of the active layer of
+ * SparseFieldLevelSetImageFilter in several threads.
+ *
+ * The domain is the range of positions in the snapshot of the active layer
+ * taken by the filter at the beginning of CalculateChange. Each thread
+ * evaluates the difference function at its own sub-range with its own
+ * global data, and writes the changes at the same positions of the update
+ * buffer, so that the buffer is filled in the order of the active layer
+ * without any merging. The time steps of the threads are combined with
+ * FiniteDifferenceImageFilter::ResolveTimeStep.
+ *
+ * \ingroup ITKLevelSets
+ */
+template< typename TSparseFieldLevelSetImageFilter >
+class SparseFieldLevelSetImageFilterThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TSparseFieldLevelSetImageFilter >
+{
+public:
+  /** Standard class typedefs. */
+  typedef SparseFieldLevelSetImageFilterThreader Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner,
+                          TSparseFieldLevelSetImageFilter >  Superclass;
+  typedef SmartPointer< Self >                    Pointer;
+  typedef SmartPointer< const Self >              ConstPointer;
+
+  itkTypeMacro( SparseFieldLevelSetImageFilterThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef typename TSparseFieldLevelSetImageFilter::TimeStepType TimeStepType;
+
+  /** The time step resolved from the time steps of the threads in the last
+   * execution. */
+  TimeStepType GetTimeStep() const
+  {
+    return m_TimeStep;
+  }
+
+protected:
+  SparseFieldLevelSetImageFilterThreader();
+  virtual ~SparseFieldLevelSetImageFilterThreader() {}
+
+  /** Get the global data of the difference function for each thread. */
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  /** Calculate the change of the nodes of \c subdomain. */
+  virtual void ThreadedExecution( const DomainType & subdomain,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  /** Compute the time step of each thread, release the global data and
+   * resolve the time step of the iteration. */
+  virtual void AfterThreadedExecution() ITK_OVERRIDE;
+
+private:
+  SparseFieldLevelSetImageFilterThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  std::vector< void * >        m_GlobalData;
+  std::vector< SizeValueType > m_NumberOfNodes;
+  TimeStepType                 m_TimeStep;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSparseFieldLevelSetImageFilterThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,97 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSparseFieldLevelSetImageFilterThreader_hxx
+#define itkSparseFieldLevelSetImageFilterThreader_hxx
+
+#include "itkSparseFieldLevelSetImageFilterThreader.h"
+#include "itkMath.h"
+
+namespace itk
+{
+
+template< typename TSparseFieldLevelSetImageFilter >
+SparseFieldLevelSetImageFilterThreader< TSparseFieldLevelSetImageFilter >
+::SparseFieldLevelSetImageFilterThreader() :
+  m_TimeStep( NumericTraits< TimeStepType >::ZeroValue() )
+{
+}
+
+template< typename TSparseFieldLevelSetImageFilter >
+void
+SparseFieldLevelSetImageFilterThreader< TSparseFieldLevelSetImageFilter >
+::BeforeThreadedExecution()
+{
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  const typename AssociateType::FiniteDifferenceFunctionType::Pointer df =
+    this->m_Associate->GetDifferenceFunction();
+
+  m_GlobalData.resize( numberOfThreads );
+  m_NumberOfNodes.assign( numberOfThreads, 0 );
+  for ( ThreadIdType i = 0; i < numberOfThreads; ++i )
+    {
+    m_GlobalData[i] = df->GetGlobalDataPointer();
+    }
+}
+
+template< typename TSparseFieldLevelSetImageFilter >
+void
+SparseFieldLevelSetImageFilterThreader< TSparseFieldLevelSetImageFilter >
+::ThreadedExecution( const DomainType & subdomain, const ThreadIdType threadId )
+{
+  m_NumberOfNodes[threadId] = subdomain[1] - subdomain[0] + 1;
+  this->m_Associate->CalculateChangeOfNodes( subdomain[0], subdomain[1] + 1, m_GlobalData[threadId] );
+}
+
+template< typename TSparseFieldLevelSetImageFilter >
+void
+SparseFieldLevelSetImageFilterThreader< TSparseFieldLevelSetImageFilter >
+::AfterThreadedExecution()
+{
+  const typename AssociateType::FiniteDifferenceFunctionType::Pointer df =
+    this->m_Associate->GetDifferenceFunction();
+  const ThreadIdType numberOfThreads = static_cast< ThreadIdType >( m_GlobalData.size() );
+
+  std::vector< TimeStepType > timeStepList( numberOfThreads );
+  std::vector< bool >         valid( numberOfThreads, false );
+  bool                        anyValid = false;
+  for ( ThreadIdType i = 0; i < numberOfThreads; ++i )
+    {
+    timeStepList[i] = df->ComputeGlobalTimeStep( m_GlobalData[i] );
+    df->ReleaseGlobalDataPointer( m_GlobalData[i] );
+
+    // A thread whose nodes do not move does not constrain the time step; the
+    // level set functions return a zero time step in that case.
+    valid[i] = m_NumberOfNodes[i] > 0
+               && Math::NotExactlyEquals( timeStepList[i], NumericTraits< TimeStepType >::ZeroValue() );
+    anyValid = anyValid || valid[i];
+    }
+  m_GlobalData.clear();
+
+  if ( anyValid )
+    {
+    m_TimeStep = this->m_Associate->ResolveTimeStep( timeStepList, valid );
+    }
+  else
+    {
+    m_TimeStep = NumericTraits< TimeStepType >::ZeroValue();
+    }
+}
+
+} // end namespace itk
+
+#endif
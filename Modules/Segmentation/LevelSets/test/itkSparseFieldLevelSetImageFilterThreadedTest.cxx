@@ -0,0 +1,294 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkThresholdSegmentationLevelSetImageFilter.h"
+#include "itkGeodesicActiveContourLevelSetImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include <cmath>
+
+/* Runs level set filters built on SparseFieldLevelSetImageFilter with one
+ * and with several threads. The change of the active layer is calculated
+ * in several threads; the threshold segmentation, whose time step does not
+ * depend on how the active layer is split, must give the same result, and
+ * the geodesic active contour a very close one. With a uniform speed and no
+ * curvature, the sphere segmented with several threads must stay a sphere
+ * and move by the same distance inward and outward. */
+
+namespace
+{
+
+const unsigned int Dimension = 3;
+typedef itk::Image< float, Dimension > ImageType;
+
+ImageType::Pointer
+CreateImage( unsigned int size )
+{
+  ImageType::RegionType region;
+  ImageType::SizeType   imageSize;
+  imageSize.Fill( size );
+  region.SetSize( imageSize );
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  return image;
+}
+
+// A signed distance to a sphere, negative inside.
+ImageType::Pointer
+CreateInitialLevelSet( unsigned int size, double radius )
+{
+  ImageType::Pointer image = CreateImage( size );
+
+  itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    double distance = 0.0;
+    for ( unsigned int i = 0; i < Dimension; ++i )
+      {
+      const double x = it.GetIndex()[i] - 0.5 * size;
+      distance += x * x;
+      }
+    it.Set( static_cast< float >( std::sqrt( distance ) - radius ) );
+    }
+  return image;
+}
+
+// A diamond, brightest at the center.
+ImageType::Pointer
+CreateFeatureImage( unsigned int size )
+{
+  ImageType::Pointer image = CreateImage( size );
+
+  itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    float value = 0.0f;
+    for ( unsigned int i = 0; i < Dimension; ++i )
+      {
+      const itk::IndexValueType x = it.GetIndex()[i];
+      value += ( x < static_cast< itk::IndexValueType >( size / 2 ) ) ? x : size - x;
+      }
+    it.Set( value );
+    }
+  return image;
+}
+
+double
+MaximumDifference( const ImageType *a, const ImageType *b )
+{
+  itk::ImageRegionConstIterator< ImageType > itA( a, a->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > itB( b, b->GetLargestPossibleRegion() );
+  double difference = 0.0;
+  for ( ; !itA.IsAtEnd(); ++itA, ++itB )
+    {
+    difference = std::max( difference, static_cast< double >( std::abs( itA.Get() - itB.Get() ) ) );
+    }
+  return difference;
+}
+
+template< typename TFilter >
+void
+Configure( TFilter * )
+{
+}
+
+void
+Configure( itk::ThresholdSegmentationLevelSetImageFilter< ImageType, ImageType > *filter )
+{
+  filter->SetLowerThreshold( 40 );
+  filter->SetUpperThreshold( 96 );
+  filter->SetCurvatureScaling( 1.0 );
+}
+
+void
+Configure( itk::GeodesicActiveContourLevelSetImageFilter< ImageType, ImageType > *filter )
+{
+  filter->SetPropagationScaling( 1.0 );
+  filter->SetCurvatureScaling( 1.0 );
+  filter->SetAdvectionScaling( 1.0 );
+}
+
+template< typename TFilter >
+ImageType::Pointer
+Segment( const ImageType *initial, const ImageType *feature, itk::ThreadIdType numberOfThreads,
+         unsigned int & elapsedIterations )
+{
+  typename TFilter::Pointer filter = TFilter::New();
+  filter->SetInput( initial );
+  filter->SetFeatureImage( feature );
+  filter->SetNumberOfIterations( 20 );
+  filter->SetMaximumRMSError( 0.0 );
+  filter->SetNumberOfThreads( numberOfThreads );
+  Configure( filter.GetPointer() );
+  filter->Update();
+
+  elapsedIterations = filter->GetElapsedIterations();
+  ImageType::Pointer output = filter->GetOutput();
+  output->DisconnectPipeline();
+  return output;
+}
+
+template< typename TFilter >
+bool
+CompareThreads( const char *name, const ImageType *initial, const ImageType *feature, double tolerance )
+{
+  bool passed = true;
+
+  unsigned int       referenceIterations = 0;
+  ImageType::Pointer reference = Segment< TFilter >( initial, feature, 1, referenceIterations );
+
+  for ( itk::ThreadIdType threads = 2; threads <= 4; ++threads )
+    {
+    unsigned int       iterations = 0;
+    ImageType::Pointer output = Segment< TFilter >( initial, feature, threads, iterations );
+    const double       difference = MaximumDifference( reference, output );
+
+    std::cout << name << " with " << threads << " threads: " << iterations
+              << " iterations, maximum difference " << difference << std::endl;
+    if ( iterations != referenceIterations || difference > tolerance )
+      {
+      std::cerr << name << " with " << threads << " threads differs from one thread: "
+                << iterations << " iterations instead of " << referenceIterations
+                << ", maximum difference " << difference << " (tolerance " << tolerance << ")"
+                << std::endl;
+      passed = false;
+      }
+    }
+  return passed;
+}
+
+// The distances to the center of the image of the pixels within half a
+// pixel of the zero set.
+void
+ZeroSetRadii( const ImageType *levelSet, unsigned int size, double & minimum, double & maximum, double & mean )
+{
+  minimum = itk::NumericTraits< double >::max();
+  maximum = 0.0;
+  mean = 0.0;
+  unsigned int count = 0;
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( levelSet, levelSet->GetLargestPossibleRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    if ( std::abs( it.Get() ) < 0.5f )
+      {
+      double distance = 0.0;
+      for ( unsigned int i = 0; i < Dimension; ++i )
+        {
+        const double x = it.GetIndex()[i] - 0.5 * size;
+        distance += x * x;
+        }
+      distance = std::sqrt( distance );
+      minimum = std::min( minimum, distance );
+      maximum = std::max( maximum, distance );
+      mean += distance;
+      ++count;
+      }
+    }
+  mean /= std::max( count, 1u );
+}
+
+// The feature is within the thresholds everywhere, so the positive region
+// of the threshold segmentation, outside of the sphere, expands; with
+// ReverseExpansionDirection the sphere expands.
+bool
+CheckUniformPropagation( const ImageType *initial, unsigned int size, double radius )
+{
+  typedef itk::ThresholdSegmentationLevelSetImageFilter< ImageType, ImageType > FilterType;
+
+  ImageType::Pointer feature = CreateImage( size );
+  feature->FillBuffer( 68.0f );
+
+  bool   passed = true;
+  double shifts[2];
+  for ( unsigned int reverse = 0; reverse < 2; ++reverse )
+    {
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput( initial );
+    filter->SetFeatureImage( feature );
+    filter->SetLowerThreshold( 40 );
+    filter->SetUpperThreshold( 96 );
+    filter->SetCurvatureScaling( 0.0 );
+    filter->SetReverseExpansionDirection( reverse );
+    filter->SetNumberOfIterations( 20 );
+    filter->SetMaximumRMSError( 0.0 );
+    filter->SetNumberOfThreads( 4 );
+    filter->Update();
+
+    double minimum;
+    double maximum;
+    double mean;
+    ZeroSetRadii( filter->GetOutput(), size, minimum, maximum, mean );
+    shifts[reverse] = mean - radius;
+    std::cout << "Uniform propagation, ReverseExpansionDirection " << reverse << ": radius from "
+              << minimum << " to " << maximum << std::endl;
+    if ( maximum - minimum > 1.5 || ( reverse ? shifts[reverse] < 2.0 : shifts[reverse] > -2.0 ) )
+      {
+      std::cerr << "The sphere moved to a radius from " << minimum << " to " << maximum
+                << " with ReverseExpansionDirection " << reverse << std::endl;
+      passed = false;
+      }
+    }
+  if ( std::abs( shifts[0] + shifts[1] ) > 0.5 )
+    {
+    std::cerr << "The sphere moved by " << shifts[0] << " inward and by " << shifts[1] << " outward" << std::endl;
+    passed = false;
+    }
+  return passed;
+}
+
+} // end namespace
+
+int itkSparseFieldLevelSetImageFilterThreadedTest( int, char *[] )
+{
+  const unsigned int size = 64;
+
+  // The sphere has enough active nodes to be split among four threads.
+  ImageType::Pointer initial = CreateInitialLevelSet( size, 18.0 );
+  ImageType::Pointer feature = CreateFeatureImage( size );
+
+  bool passed = true;
+
+  typedef itk::ThresholdSegmentationLevelSetImageFilter< ImageType, ImageType > ThresholdFilterType;
+  passed &= CompareThreads< ThresholdFilterType >( "ThresholdSegmentation", initial, feature, 0.0 );
+
+  // The geodesic active contour has an advection term, so the time steps of
+  // the threads may be slightly larger than the time step of a single
+  // thread.
+  ImageType::Pointer speed = CreateImage( size );
+  itk::ImageRegionIterator< ImageType >      speedIt( speed, speed->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > featureIt( feature, feature->GetLargestPossibleRegion() );
+  for ( ; !speedIt.IsAtEnd(); ++speedIt, ++featureIt )
+    {
+    speedIt.Set( 1.0f / ( 1.0f + 0.01f * featureIt.Get() * featureIt.Get() ) );
+    }
+
+  typedef itk::GeodesicActiveContourLevelSetImageFilter< ImageType, ImageType > GeodesicFilterType;
+  passed &= CompareThreads< GeodesicFilterType >( "GeodesicActiveContour", initial, speed, 1e-3 );
+
+  passed &= CheckUniformPropagation( initial, size, 18.0 );
+
+  if ( !passed )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -83,6 +83,9 @@ public:
   typedef typename Superclass::HeavisideConstPointer HeavisideConstPointer;
 
   typedef typename Superclass::LevelSetDataType LevelSetDataType;
+  typedef typename Superclass::LevelSetInputIndexBlockType LevelSetInputIndexBlockType;
+  typedef typename Superclass::LevelSetDataBlockType       LevelSetDataBlockType;
+  typedef typename Superclass::LevelSetOutputRealBlockType LevelSetOutputRealBlockType;
 
   itkStaticConstMacro(ImageDimension, unsigned int, InputImageType::ImageDimension);
 
@@ -133,6 +136,14 @@ protected:
    *  \f$ \omega_i( p ) \f$. */
   virtual LevelSetOutputRealType Value( const LevelSetInputIndexType& iP, const LevelSetDataType& iData ) ITK_OVERRIDE;
 
+  /** Adds the weighted term contribution at each location of the block,
+   *  calling this class' Value( iP, iData ) without virtual dispatch unless
+   *  it is overridden. \sa LevelSetEquationTermBase::AccumulateTermValues */
+  virtual LevelSetOutputRealType AccumulateValues( const LevelSetInputIndexBlockType& iP,
+                                                   const LevelSetDataBlockType& iData,
+                                                   const SizeValueType& iNumberOfPoints,
+                                                   LevelSetOutputRealBlockType& ioValues ) ITK_OVERRIDE;
+
   LevelSetOutputRealType  m_NeighborhoodScales[ImageDimension];
 
   CurvatureImagePointer m_CurvatureImage;
@@ -140,6 +151,8 @@ protected:
   bool m_UseCurvatureImage;
 
 private:
+  friend class LevelSetEquationTermBase< TInput, TLevelSetContainer >;
+
   LevelSetEquationCurvatureTerm( const Self& ) ITK_DELETE_FUNCTION;
   void operator = ( const Self& ) ITK_DELETE_FUNCTION;
 };
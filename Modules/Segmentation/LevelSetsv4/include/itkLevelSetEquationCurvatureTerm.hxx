@@ -124,5 +124,16 @@ LevelSetEquationCurvatureTerm< TInput, TLevelSetContainer, TCurvatureImage >
     }
 }
 
+template< typename TInput, typename TLevelSetContainer, typename TCurvatureImage >
+typename LevelSetEquationCurvatureTerm< TInput, TLevelSetContainer, TCurvatureImage >::LevelSetOutputRealType
+LevelSetEquationCurvatureTerm< TInput, TLevelSetContainer, TCurvatureImage >
+::AccumulateValues( const LevelSetInputIndexBlockType& iP,
+                    const LevelSetDataBlockType& iData,
+                    const SizeValueType& iNumberOfPoints,
+                    LevelSetOutputRealBlockType& ioValues )
+{
+  return this->AccumulateTermValues( this, iP, iData, iNumberOfPoints, ioValues );
+}
+
 }
 #endif
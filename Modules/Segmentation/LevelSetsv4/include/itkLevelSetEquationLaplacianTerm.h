@@ -81,6 +81,9 @@ public:
   typedef typename Superclass::HeavisideConstPointer HeavisideConstPointer;
 
   typedef typename Superclass::LevelSetDataType LevelSetDataType;
+  typedef typename Superclass::LevelSetInputIndexBlockType LevelSetInputIndexBlockType;
+  typedef typename Superclass::LevelSetDataBlockType       LevelSetDataBlockType;
+  typedef typename Superclass::LevelSetOutputRealBlockType LevelSetOutputRealBlockType;
 
   itkStaticConstMacro(ImageDimension, unsigned int, InputImageType::ImageDimension);
 
@@ -123,7 +126,17 @@ protected:
   virtual LevelSetOutputRealType Value( const LevelSetInputIndexType& iP,
                                         const LevelSetDataType& iData ) ITK_OVERRIDE;
 
+  /** Adds the weighted term contribution at each location of the block,
+   *  calling this class' Value( iP, iData ) without virtual dispatch unless
+   *  it is overridden. \sa LevelSetEquationTermBase::AccumulateTermValues */
+  virtual LevelSetOutputRealType AccumulateValues( const LevelSetInputIndexBlockType& iP,
+                                                   const LevelSetDataBlockType& iData,
+                                                   const SizeValueType& iNumberOfPoints,
+                                                   LevelSetOutputRealBlockType& ioValues ) ITK_OVERRIDE;
+
 private:
+  friend class LevelSetEquationTermBase< TInput, TLevelSetContainer >;
+
   LevelSetEquationLaplacianTerm( const Self& ) ITK_DELETE_FUNCTION;
   void operator = ( const Self& ) ITK_DELETE_FUNCTION;
 };
@@ -104,6 +104,17 @@ LevelSetEquationLaplacianTerm< TInput, TLevelSetContainer >
   return laplacian;
 }
 
+template< typename TInput, typename TLevelSetContainer >
+typename LevelSetEquationLaplacianTerm< TInput, TLevelSetContainer >::LevelSetOutputRealType
+LevelSetEquationLaplacianTerm< TInput, TLevelSetContainer >
+::AccumulateValues( const LevelSetInputIndexBlockType& iP,
+                    const LevelSetDataBlockType& iData,
+                    const SizeValueType& iNumberOfPoints,
+                    LevelSetOutputRealBlockType& ioValues )
+{
+  return this->AccumulateTermValues( this, iP, iData, iNumberOfPoints, ioValues );
+}
+
 }
 
 #endif
@@ -79,6 +79,9 @@ public:
   typedef typename Superclass::LevelSetHessianType        LevelSetHessianType;
   typedef typename Superclass::LevelSetIdentifierType     LevelSetIdentifierType;
   typedef typename Superclass::LevelSetDataType           LevelSetDataType;
+  typedef typename Superclass::LevelSetInputIndexBlockType LevelSetInputIndexBlockType;
+  typedef typename Superclass::LevelSetDataBlockType       LevelSetDataBlockType;
+  typedef typename Superclass::LevelSetOutputRealBlockType LevelSetOutputRealBlockType;
 
   typedef typename Superclass::HeavisideType         HeavisideType;
   typedef typename Superclass::HeavisideConstPointer HeavisideConstPointer;
@@ -132,7 +135,17 @@ protected:
   virtual LevelSetOutputRealType Value( const LevelSetInputIndexType& iP,
                                         const LevelSetDataType& iData ) ITK_OVERRIDE;
 
+  /** Adds the weighted term contribution at each location of the block,
+   *  calling this class' Value( iP, iData ) without virtual dispatch unless
+   *  it is overridden. \sa LevelSetEquationTermBase::AccumulateTermValues */
+  virtual LevelSetOutputRealType AccumulateValues( const LevelSetInputIndexBlockType& iP,
+                                                   const LevelSetDataBlockType& iData,
+                                                   const SizeValueType& iNumberOfPoints,
+                                                   LevelSetOutputRealBlockType& ioValues ) ITK_OVERRIDE;
+
 private:
+  friend class LevelSetEquationTermBase< TInput, TLevelSetContainer >;
+
   LevelSetEquationPropagationTerm( const Self& ) ITK_DELETE_FUNCTION;
   void operator = ( const Self& ) ITK_DELETE_FUNCTION;
 };
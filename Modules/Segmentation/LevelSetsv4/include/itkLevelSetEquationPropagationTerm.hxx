@@ -141,6 +141,17 @@ LevelSetEquationPropagationTerm< TInput, TLevelSetContainer, TPropagationImage >
   return propagation_gradient;
 }
 
+template< typename TInput, typename TLevelSetContainer, typename TPropagationImage >
+typename LevelSetEquationPropagationTerm< TInput, TLevelSetContainer, TPropagationImage >::LevelSetOutputRealType
+LevelSetEquationPropagationTerm< TInput, TLevelSetContainer, TPropagationImage >
+::AccumulateValues( const LevelSetInputIndexBlockType& iP,
+                    const LevelSetDataBlockType& iData,
+                    const SizeValueType& iNumberOfPoints,
+                    LevelSetOutputRealBlockType& ioValues )
+{
+  return this->AccumulateTermValues( this, iP, iData, iNumberOfPoints, ioValues );
+}
+
 }
 
 #endif
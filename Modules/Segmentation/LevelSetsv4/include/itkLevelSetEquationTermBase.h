@@ -23,6 +23,8 @@
 #include "itkHeavisideStepFunctionBase.h"
 #include "itksys/hash_set.hxx"
 
+#include <vector>
+
 namespace itk
 {
 /**
@@ -78,6 +80,12 @@ public:
   typedef typename LevelSetContainerType::LevelSetDataType
                                                           LevelSetDataType;
 
+  /** Contiguous blocks of locations, of their cached characteristics, and of
+   *  term contributions, used to evaluate the term over many locations at once */
+  typedef std::vector< LevelSetInputIndexType >           LevelSetInputIndexBlockType;
+  typedef std::vector< LevelSetDataType >                 LevelSetDataBlockType;
+  typedef std::vector< LevelSetOutputRealType >           LevelSetOutputRealBlockType;
+
   typedef typename LevelSetContainerType::DomainMapImageFilterType  DomainMapImageFilterType;
   typedef typename LevelSetContainerType::CacheImageType            CacheImageType;
 
@@ -110,6 +118,16 @@ public:
   virtual LevelSetOutputRealType Evaluate( const LevelSetInputIndexType& iP,
                                            const LevelSetDataType& iData );
 
+  /** Adds the weighted term contribution \f$ \alpha_i \cdot \omega_i( p ) \f$
+   *  at the first iNumberOfPoints locations of iP to the corresponding
+   *  elements of ioValues, using the characteristics cached in iData.
+   *  Returns the largest absolute contribution of the block.
+   */
+  LevelSetOutputRealType Evaluate( const LevelSetInputIndexBlockType& iP,
+                                   const LevelSetDataBlockType& iData,
+                                   const SizeValueType& iNumberOfPoints,
+                                   LevelSetOutputRealBlockType& ioValues );
+
   /** \todo to be documented. */
   virtual void Initialize( const LevelSetInputIndexType& iP ) = 0;
 
@@ -153,6 +171,30 @@ protected:
   virtual LevelSetOutputRealType Value( const LevelSetInputIndexType& iP,
                                         const LevelSetDataType& iData ) = 0;
 
+  /** Adds \f$ \alpha_i \cdot \omega_i( p ) \f$ at the first iNumberOfPoints
+   *  locations of iP to ioValues and returns the largest absolute
+   *  contribution. The default implementation calls Value( iP, iData ) for
+   *  each location; terms whose contribution only depends on the cached
+   *  characteristics may override it with a loop free of virtual calls.
+   */
+  virtual LevelSetOutputRealType AccumulateValues( const LevelSetInputIndexBlockType& iP,
+                                                   const LevelSetDataBlockType& iData,
+                                                   const SizeValueType& iNumberOfPoints,
+                                                   LevelSetOutputRealBlockType& ioValues );
+
+  /** Implementation of AccumulateValues for the terms of type TTerm, which
+   *  must declare this class as a friend. When iTerm is exactly of type TTerm,
+   *  TTerm::Value( iP, iData ) is called without virtual dispatch; otherwise
+   *  the default implementation is used so that subclasses of TTerm
+   *  overriding Value are honored.
+   */
+  template< typename TTerm >
+  LevelSetOutputRealType AccumulateTermValues( TTerm* iTerm,
+                                               const LevelSetInputIndexBlockType& iP,
+                                               const LevelSetDataBlockType& iData,
+                                               const SizeValueType& iNumberOfPoints,
+                                               LevelSetOutputRealBlockType& ioValues );
+
   /** Input image */
   InputImagePointer        m_Input;
 
@@ -23,6 +23,9 @@
 #include "itkNumericTraits.h"
 #include "itkMath.h"
 
+#include <algorithm>
+#include <typeinfo>
+
 namespace itk
 {
 // ----------------------------------------------------------------------------
@@ -110,6 +113,83 @@ LevelSetEquationTermBase< TInputImage, TLevelSetContainer >
 }
 // ----------------------------------------------------------------------------
 
+// ----------------------------------------------------------------------------
+template< typename TInputImage, typename TLevelSetContainer >
+typename
+LevelSetEquationTermBase< TInputImage, TLevelSetContainer >
+::LevelSetOutputRealType
+LevelSetEquationTermBase< TInputImage, TLevelSetContainer >
+::Evaluate( const LevelSetInputIndexBlockType& iP,
+            const LevelSetDataBlockType& iData,
+            const SizeValueType& iNumberOfPoints,
+            LevelSetOutputRealBlockType& ioValues )
+{
+  if( itk::Math::abs( this->m_Coefficient ) > NumericTraits< LevelSetOutputRealType >::epsilon() )
+    {
+    return this->AccumulateValues( iP, iData, iNumberOfPoints, ioValues );
+    }
+  else
+    {
+    return NumericTraits< LevelSetOutputRealType >::ZeroValue();
+    }
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+template< typename TInputImage, typename TLevelSetContainer >
+typename
+LevelSetEquationTermBase< TInputImage, TLevelSetContainer >
+::LevelSetOutputRealType
+LevelSetEquationTermBase< TInputImage, TLevelSetContainer >
+::AccumulateValues( const LevelSetInputIndexBlockType& iP,
+                    const LevelSetDataBlockType& iData,
+                    const SizeValueType& iNumberOfPoints,
+                    LevelSetOutputRealBlockType& ioValues )
+{
+  LevelSetOutputRealType maxValue = NumericTraits< LevelSetOutputRealType >::ZeroValue();
+
+  for( SizeValueType i = 0; i < iNumberOfPoints; ++i )
+    {
+    const LevelSetOutputRealType value = this->m_Coefficient * this->Value( iP[i], iData[i] );
+    maxValue = std::max( itk::Math::abs( value ), maxValue );
+    ioValues[i] += value;
+    }
+
+  return maxValue;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+template< typename TInputImage, typename TLevelSetContainer >
+template< typename TTerm >
+typename
+LevelSetEquationTermBase< TInputImage, TLevelSetContainer >
+::LevelSetOutputRealType
+LevelSetEquationTermBase< TInputImage, TLevelSetContainer >
+::AccumulateTermValues( TTerm* iTerm,
+                        const LevelSetInputIndexBlockType& iP,
+                        const LevelSetDataBlockType& iData,
+                        const SizeValueType& iNumberOfPoints,
+                        LevelSetOutputRealBlockType& ioValues )
+{
+  if( typeid( *iTerm ) != typeid( TTerm ) )
+    {
+    return Self::AccumulateValues( iP, iData, iNumberOfPoints, ioValues );
+    }
+
+  LevelSetOutputRealType maxValue = NumericTraits< LevelSetOutputRealType >::ZeroValue();
+
+  for( SizeValueType i = 0; i < iNumberOfPoints; ++i )
+    {
+    const LevelSetOutputRealType value = this->m_Coefficient * iTerm->TTerm::Value( iP[i], iData[i] );
+    maxValue = std::max( itk::Math::abs( value ), maxValue );
+    ioValues[i] += value;
+    }
+
+  return maxValue;
+}
+// ----------------------------------------------------------------------------
+
 // ----------------------------------------------------------------------------
 template< typename TInputImage, typename TLevelSetContainer >
 void
@@ -26,6 +26,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace itk
 {
@@ -79,6 +80,14 @@ public:
                                                                        TermType;
   typedef typename TermType::Pointer                                   TermPointer;
 
+  typedef typename TermType::LevelSetInputIndexBlockType  LevelSetInputIndexBlockType;
+  typedef typename TermType::LevelSetDataBlockType        LevelSetDataBlockType;
+  typedef typename TermType::LevelSetOutputRealBlockType  LevelSetOutputRealBlockType;
+
+  /** Number of locations the evolution threaders evaluate together with the
+   *  block versions of ComputeRequiredData and Evaluate */
+  itkStaticConstMacro( EvaluationBlockSize, unsigned int, 64 );
+
   /** Set/Get the input image to be segmented. */
   itkSetObjectMacro( Input, InputImageType );
   itkGetModifiableObjectMacro(Input, InputImageType );
@@ -127,6 +136,23 @@ public:
   void ComputeRequiredData( const LevelSetInputIndexType& iP,
                             LevelSetDataType& ioData );
 
+  /** Evaluate the terms at the first iNumberOfPoints locations of iP, whose
+   *  characteristics have been cached in iData by ComputeRequiredData. Each
+   *  term is applied to the whole block before the next one, and the sums
+   *  are written in oValues, which must hold at least iNumberOfPoints
+   *  elements. The result at each location is the one of Evaluate( iP, iData ). */
+  void Evaluate( const LevelSetInputIndexBlockType& iP,
+                 const LevelSetDataBlockType& iData,
+                 const SizeValueType& iNumberOfPoints,
+                 LevelSetOutputRealBlockType& oValues );
+
+  /** Compute the characteristics required by the terms at the first
+   *  iNumberOfPoints locations of iP. The elements of ioData are reset first,
+   *  so that the same block can be reused from one call to the next. */
+  void ComputeRequiredData( const LevelSetInputIndexBlockType& iP,
+                            const SizeValueType& iNumberOfPoints,
+                            LevelSetDataBlockType& ioData );
+
 protected:
 
   typedef std::map< TermIdType, TermPointer >           MapTermContainerType;
@@ -285,6 +311,35 @@ protected:
   typedef typename TermType::RequiredDataType RequiredDataType;
   RequiredDataType  m_RequiredData;
 
+  /** Characteristics of the level set that may be required by the terms */
+  enum CharacteristicType
+    {
+    ValueCharacteristic = 0,
+    GradientCharacteristic,
+    HessianCharacteristic,
+    LaplacianCharacteristic,
+    GradientNormCharacteristic,
+    MeanCurvatureCharacteristic,
+    ForwardGradientCharacteristic,
+    BackwardGradientCharacteristic
+    };
+
+  typedef std::vector< CharacteristicType > RequiredCharacteristicContainerType;
+
+  /** m_RequiredData translated once, so that the characteristics are not
+   *  looked up by name at each location */
+  RequiredCharacteristicContainerType m_RequiredCharacteristics;
+
+  /** Add the data required by iTerm to m_RequiredData and
+   *  m_RequiredCharacteristics */
+  void AddRequiredData( const TermType* iTerm );
+
+  /** Compute one characteristic of iLevelSet at iP */
+  static void ComputeCharacteristic( const LevelSetType* iLevelSet,
+                                     const CharacteristicType& iCharacteristic,
+                                     const LevelSetInputIndexType& iP,
+                                     LevelSetDataType& ioData );
+
   MapTermContainerType  m_Container;
 
   typedef std::map< TermIdType, LevelSetOutputRealType >  MapCFLContainerType;
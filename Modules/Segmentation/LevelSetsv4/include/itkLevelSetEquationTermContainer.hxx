@@ -23,6 +23,8 @@
 #include "itkLevelSetEquationTermContainer.h"
 #include "itkObject.h"
 
+#include <algorithm>
+
 namespace itk
 {
 // ----------------------------------------------------------------------------
@@ -116,16 +118,7 @@ LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
     m_TermContribution[iId] = NumericTraits< LevelSetOutputPixelType >::ZeroValue();
     m_NameContainer[ iTerm->GetTermName() ] = iTerm;
 
-    RequiredDataType termRequiredData = iTerm->GetRequiredData();
-
-    typename RequiredDataType::const_iterator dIt   = termRequiredData.begin();
-    typename RequiredDataType::const_iterator dEnd  = termRequiredData.end();
-
-    while( dIt != dEnd )
-      {
-      m_RequiredData.insert( *dIt );
-      ++dIt;
-      }
+    this->AddRequiredData( iTerm );
 
     this->Modified();
     }
@@ -176,16 +169,7 @@ LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
     m_TermContribution[ id ] = NumericTraits< LevelSetOutputPixelType >::ZeroValue();
     m_NameContainer[ iTerm->GetTermName() ] = iTerm;
 
-    RequiredDataType termRequiredData = iTerm->GetRequiredData();
-
-    typename RequiredDataType::const_iterator dIt = termRequiredData.begin();
-    typename RequiredDataType::const_iterator dEnd = termRequiredData.end();
-
-    while( dIt != dEnd )
-      {
-      m_RequiredData.insert( *dIt );
-      ++dIt;
-      }
+    this->AddRequiredData( iTerm );
 
     this->Modified();
     }
@@ -385,51 +369,172 @@ LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
 template< typename TInputImage, typename TLevelSetContainer >
 void
 LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
-::ComputeRequiredData( const LevelSetInputIndexType& iP, LevelSetDataType& ioData )
+::Evaluate( const LevelSetInputIndexBlockType& iP,
+            const LevelSetDataBlockType& iData,
+            const SizeValueType& iNumberOfPoints,
+            LevelSetOutputRealBlockType& oValues )
 {
-  typename RequiredDataType::const_iterator dIt = m_RequiredData.begin();
-  typename RequiredDataType::const_iterator dEnd = m_RequiredData.end();
+  std::fill( oValues.begin(), oValues.begin() + iNumberOfPoints,
+             NumericTraits< LevelSetOutputRealType >::ZeroValue() );
 
-  MapTermContainerIteratorType tIt = m_Container.begin();
+  MapTermContainerIteratorType term_it  = m_Container.begin();
+  MapTermContainerIteratorType term_end = m_Container.end();
+
+  MapCFLContainerIterator cfl_it = m_TermContribution.begin();
+
+  while( term_it != term_end )
+    {
+    LevelSetOutputRealType max_val =
+      ( term_it->second )->Evaluate( iP, iData, iNumberOfPoints, oValues );
+
+    cfl_it->second = std::max( max_val, cfl_it->second );
+
+    ++term_it;
+    ++cfl_it;
+    }
+}
+
+// ----------------------------------------------------------------------------
+template< typename TInputImage, typename TLevelSetContainer >
+void
+LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
+::AddRequiredData( const TermType* iTerm )
+{
+  const RequiredDataType & termRequiredData = iTerm->GetRequiredData();
 
-  LevelSetPointer levelset = ( tIt->second )->GetModifiableCurrentLevelSetPointer();
+  typename RequiredDataType::const_iterator dIt = termRequiredData.begin();
+  typename RequiredDataType::const_iterator dEnd = termRequiredData.end();
 
   while( dIt != dEnd )
     {
-    if( *dIt == "Value" )
-      {
-      levelset->Evaluate( iP, ioData );
-      }
-    if( *dIt == "Gradient" )
-      {
-      levelset->EvaluateGradient( iP, ioData );
-      }
-    if( *dIt == "Hessian" )
-      {
-      levelset->EvaluateHessian( iP, ioData );
-      }
-    if( *dIt == "Laplacian" )
-      {
-      levelset->EvaluateLaplacian( iP, ioData );
-      }
-    if( *dIt == "GradientNorm" )
-      {
-      levelset->EvaluateGradientNorm( iP, ioData );
-      }
-    if( *dIt == "MeanCurvature" )
-      {
-      levelset->EvaluateMeanCurvature( iP, ioData );
-      }
-    if( *dIt == "ForwardGradient" )
+    m_RequiredData.insert( *dIt );
+    ++dIt;
+    }
+
+  // Characteristics are computed in the order of CharacteristicType, so that
+  // the ones others depend on are available first.
+  static const char * const names[] =
+    {
+    "Value", "Gradient", "Hessian", "Laplacian", "GradientNorm",
+    "MeanCurvature", "ForwardGradient", "BackwardGradient"
+    };
+
+  m_RequiredCharacteristics.clear();
+  for( unsigned int c = ValueCharacteristic; c <= BackwardGradientCharacteristic; ++c )
+    {
+    if( m_RequiredData.find( names[c] ) != m_RequiredData.end() )
       {
-      levelset->EvaluateForwardGradient( iP, ioData );
+      m_RequiredCharacteristics.push_back( static_cast< CharacteristicType >( c ) );
       }
-    if( *dIt == "BackwardGradient" )
+    }
+}
+
+// ----------------------------------------------------------------------------
+template< typename TInputImage, typename TLevelSetContainer >
+void
+LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
+::ComputeCharacteristic( const LevelSetType* iLevelSet,
+                         const CharacteristicType& iCharacteristic,
+                         const LevelSetInputIndexType& iP,
+                         LevelSetDataType& ioData )
+{
+  switch( iCharacteristic )
+    {
+    case ValueCharacteristic:
+      iLevelSet->Evaluate( iP, ioData );
+      break;
+    case GradientCharacteristic:
+      iLevelSet->EvaluateGradient( iP, ioData );
+      break;
+    case HessianCharacteristic:
+      iLevelSet->EvaluateHessian( iP, ioData );
+      break;
+    case LaplacianCharacteristic:
+      iLevelSet->EvaluateLaplacian( iP, ioData );
+      break;
+    case GradientNormCharacteristic:
+      iLevelSet->EvaluateGradientNorm( iP, ioData );
+      break;
+    case MeanCurvatureCharacteristic:
+      iLevelSet->EvaluateMeanCurvature( iP, ioData );
+      break;
+    case ForwardGradientCharacteristic:
+      iLevelSet->EvaluateForwardGradient( iP, ioData );
+      break;
+    case BackwardGradientCharacteristic:
+      iLevelSet->EvaluateBackwardGradient( iP, ioData );
+      break;
+    // here add new characteristics
+    }
+}
+
+// ----------------------------------------------------------------------------
+template< typename TInputImage, typename TLevelSetContainer >
+void
+LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
+::ComputeRequiredData( const LevelSetInputIndexType& iP, LevelSetDataType& ioData )
+{
+  MapTermContainerIteratorType tIt = m_Container.begin();
+
+  const LevelSetType * levelset = ( tIt->second )->GetModifiableCurrentLevelSetPointer();
+
+  typename RequiredCharacteristicContainerType::const_iterator cIt = m_RequiredCharacteristics.begin();
+  typename RequiredCharacteristicContainerType::const_iterator cEnd = m_RequiredCharacteristics.end();
+
+  while( cIt != cEnd )
+    {
+    ComputeCharacteristic( levelset, *cIt, iP, ioData );
+    ++cIt;
+    }
+}
+
+// ----------------------------------------------------------------------------
+template< typename TInputImage, typename TLevelSetContainer >
+void
+LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
+::ComputeRequiredData( const LevelSetInputIndexBlockType& iP,
+                       const SizeValueType& iNumberOfPoints,
+                       LevelSetDataBlockType& ioData )
+{
+  // Bring the elements back to the state of a newly constructed
+  // LevelSetDataType, since some characteristics are accumulated in place.
+  const LevelSetOutputRealType zero = NumericTraits< LevelSetOutputRealType >::ZeroValue();
+
+  for( SizeValueType i = 0; i < iNumberOfPoints; ++i )
+    {
+    LevelSetDataType & data = ioData[i];
+    data.Value.m_Value = NumericTraits< LevelSetOutputPixelType >::ZeroValue();
+    data.Value.m_Computed = false;
+    data.Gradient.m_Value.Fill( zero );
+    data.Gradient.m_Computed = false;
+    data.Hessian.m_Value.Fill( zero );
+    data.Hessian.m_Computed = false;
+    data.Laplacian.m_Value = zero;
+    data.Laplacian.m_Computed = false;
+    data.GradientNorm.m_Value = zero;
+    data.GradientNorm.m_Computed = false;
+    data.MeanCurvature.m_Value = zero;
+    data.MeanCurvature.m_Computed = false;
+    data.ForwardGradient.m_Value.Fill( zero );
+    data.ForwardGradient.m_Computed = false;
+    data.BackwardGradient.m_Value.Fill( zero );
+    data.BackwardGradient.m_Computed = false;
+    }
+
+  MapTermContainerIteratorType tIt = m_Container.begin();
+
+  const LevelSetType * levelset = ( tIt->second )->GetModifiableCurrentLevelSetPointer();
+
+  typename RequiredCharacteristicContainerType::const_iterator cIt = m_RequiredCharacteristics.begin();
+  typename RequiredCharacteristicContainerType::const_iterator cEnd = m_RequiredCharacteristics.end();
+
+  while( cIt != cEnd )
+    {
+    for( SizeValueType i = 0; i < iNumberOfPoints; ++i )
       {
-      levelset->EvaluateBackwardGradient( iP, ioData );
+      ComputeCharacteristic( levelset, *cIt, iP[i], ioData[i] );
       }
-    // here add new characteristics
-    ++dIt;
+    ++cIt;
     }
 }
 
@@ -289,7 +289,7 @@ LevelSetEvolution< TEquationContainer, WhitakerSparseLevelSetImage< TOutput, VDi
   while( this->m_LevelSetContainerIteratorToProcessWhenThreading != this->m_LevelSetContainer->End() )
     {
     typename LevelSetType::ConstPointer levelSet = this->m_LevelSetContainerIteratorToProcessWhenThreading->GetLevelSet();
-    const LevelSetLayerType zeroLayer = levelSet->GetLayer( 0 );
+    const LevelSetLayerType & zeroLayer = levelSet->GetLayer( 0 );
     typename LevelSetType::LayerConstIterator layerBegin = zeroLayer.begin();
     typename LevelSetType::LayerConstIterator layerEnd = zeroLayer.end();
     typename SplitLevelSetPartitionerType::DomainType completeDomain( layerBegin, layerEnd );
@@ -339,6 +339,12 @@ void
 LevelSetEvolution< TEquationContainer, WhitakerSparseLevelSetImage< TOutput, VDimension > >
 ::UpdateLevelSets()
 {
+  // The level sets are updated one after the other. When a point changes
+  // layer, the update calls UpdatePixel on the terms of the level set
+  // equation, and terms such as LevelSetEquationChanAndVeseExternalTerm
+  // evaluate the other level sets at that point. Updating level sets in
+  // parallel would read layers and label maps while they are rewritten,
+  // and each update relies on the previous level sets being up to date.
   typename LevelSetContainerType::Iterator it = this->m_LevelSetContainer->Begin();
   while( it != this->m_LevelSetContainer->End() )
     {
@@ -31,7 +31,9 @@ namespace itk
 /** \class LevelSetEvolutionComputeIterationThreader
  * \brief Thread the ComputeIteration method.
  *
- * Thread the \c ComputeIteration method of the LevelSetEvolution class
+ * Thread the \c ComputeIteration method of the LevelSetEvolution class.
+ * Each thread evaluates the equation terms over blocks of
+ * LevelSetEquationTermContainer::EvaluationBlockSize consecutive locations.
  *
  * \ingroup ITKLevelSetsv4
  */
@@ -78,6 +80,10 @@ public:
   typedef typename LevelSetEvolutionType::EquationContainerType  EquationContainerType;
   typedef typename LevelSetEvolutionType::TermContainerType      TermContainerType;
 
+  typedef typename TermContainerType::LevelSetInputIndexBlockType LevelSetInputIndexBlockType;
+  typedef typename TermContainerType::LevelSetDataBlockType       LevelSetDataBlockType;
+  typedef typename TermContainerType::LevelSetOutputRealBlockType LevelSetOutputRealBlockType;
+
 protected:
   LevelSetEvolutionComputeIterationThreader();
 
@@ -130,6 +136,10 @@ public:
   typedef typename LevelSetEvolutionType::EquationContainerType  EquationContainerType;
   typedef typename LevelSetEvolutionType::TermContainerType      TermContainerType;
 
+  typedef typename TermContainerType::LevelSetInputIndexBlockType LevelSetInputIndexBlockType;
+  typedef typename TermContainerType::LevelSetDataBlockType       LevelSetDataBlockType;
+  typedef typename TermContainerType::LevelSetOutputRealBlockType LevelSetOutputRealBlockType;
+
 protected:
   LevelSetEvolutionComputeIterationThreader();
 
@@ -181,6 +191,10 @@ public:
   typedef typename LevelSetEvolutionType::TermContainerType      TermContainerType;
   typedef typename LevelSetEvolutionType::NodePairType           NodePairType;
 
+  typedef typename TermContainerType::LevelSetInputIndexBlockType LevelSetInputIndexBlockType;
+  typedef typename TermContainerType::LevelSetDataBlockType       LevelSetDataBlockType;
+  typedef typename TermContainerType::LevelSetOutputRealBlockType LevelSetOutputRealBlockType;
+
 protected:
   LevelSetEvolutionComputeIterationThreader();
 
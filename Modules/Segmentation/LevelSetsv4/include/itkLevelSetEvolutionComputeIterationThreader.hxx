@@ -51,6 +51,13 @@ LevelSetEvolutionComputeIterationThreader< LevelSetDenseImage< TImage >, Threade
   ImageRegionConstIteratorWithIndex< LevelSetImageType > imageIt( levelSetImage, subRegion );
   imageIt.GoToBegin();
 
+  // The terms are evaluated over blocks of consecutive pixels, reusing the
+  // same buffers from one block to the next.
+  const SizeValueType blockSize = TermContainerType::EvaluationBlockSize;
+  LevelSetInputIndexBlockType inputIndices( blockSize );
+  LevelSetDataBlockType characteristics( blockSize );
+  LevelSetOutputRealBlockType updates( blockSize );
+
   if( this->m_Associate->m_LevelSetContainer->HasDomainMap() )
     {
     const IdListType * idList = this->m_Associate->m_IdListToProcessWhenThreading;
@@ -73,16 +80,22 @@ LevelSetEvolutionComputeIterationThreader< LevelSetDenseImage< TImage >, Threade
 
     while( !imageIt.IsAtEnd() )
       {
-      const IndexType levelSetIndex = imageIt.GetIndex();
-      const IndexType inputIndex = imageIt.GetIndex() + offset;
+      SizeValueType numberOfPoints = 0;
+      while( !imageIt.IsAtEnd() && numberOfPoints < blockSize )
+        {
+        inputIndices[numberOfPoints] = imageIt.GetIndex() + offset;
+        ++numberOfPoints;
+        ++imageIt;
+        }
       for( idListIdx = 0; idListIdx < numberOfLevelSets; ++idListIdx )
         {
-        LevelSetDataType characteristics;
-        termContainers[idListIdx]->ComputeRequiredData( inputIndex, characteristics );
-        LevelSetOutputRealType temp_update = termContainers[idListIdx]->Evaluate( inputIndex, characteristics );
-        levelSetUpdateImages[idListIdx]->SetPixel( levelSetIndex, temp_update );
+        termContainers[idListIdx]->ComputeRequiredData( inputIndices, numberOfPoints, characteristics );
+        termContainers[idListIdx]->Evaluate( inputIndices, characteristics, numberOfPoints, updates );
+        for( SizeValueType ii = 0; ii < numberOfPoints; ++ii )
+          {
+          levelSetUpdateImages[idListIdx]->SetPixel( inputIndices[ii] - offset, updates[ii] );
+          }
         }
-      ++imageIt;
       }
     }
   else
@@ -99,13 +112,19 @@ LevelSetEvolutionComputeIterationThreader< LevelSetDenseImage< TImage >, Threade
     imageIt.GoToBegin();
     while( !imageIt.IsAtEnd() )
       {
-      const IndexType levelSetIndex = imageIt.GetIndex();
-      const IndexType inputIndex = imageIt.GetIndex() + offset;
-      LevelSetDataType characteristics;
-      termContainer->ComputeRequiredData( inputIndex, characteristics );
-      LevelSetOutputRealType temp_update = termContainer->Evaluate( inputIndex, characteristics );
-      levelSetUpdateImage->SetPixel( levelSetIndex, temp_update );
-      ++imageIt;
+      SizeValueType numberOfPoints = 0;
+      while( !imageIt.IsAtEnd() && numberOfPoints < blockSize )
+        {
+        inputIndices[numberOfPoints] = imageIt.GetIndex() + offset;
+        ++numberOfPoints;
+        ++imageIt;
+        }
+      termContainer->ComputeRequiredData( inputIndices, numberOfPoints, characteristics );
+      termContainer->Evaluate( inputIndices, characteristics, numberOfPoints, updates );
+      for( SizeValueType ii = 0; ii < numberOfPoints; ++ii )
+        {
+        levelSetUpdateImage->SetPixel( inputIndices[ii] - offset, updates[ii] );
+        }
       }
     }
 }
@@ -130,34 +149,48 @@ LevelSetEvolutionComputeIterationThreader<
 {
   typename InputImageType::ConstPointer inputImage = this->m_Associate->m_EquationContainer->GetInput();
 
+  // The terms are evaluated over blocks of consecutive pixels, reusing the
+  // same buffers from one block to the next.
+  const SizeValueType blockSize = TermContainerType::EvaluationBlockSize;
+  LevelSetInputIndexBlockType inputIndices( blockSize );
+  LevelSetDataBlockType characteristics( blockSize );
+  LevelSetOutputRealBlockType updates( blockSize );
+
   typename DomainType::IteratorType mapIt = imageSubDomain.Begin();
   while( mapIt != imageSubDomain.End() )
     {
     ImageRegionConstIteratorWithIndex< InputImageType > it( inputImage, *(mapIt->second.GetRegion()) );
-    it.GoToBegin();
 
-    while( !it.IsAtEnd() )
-      {
-      const IdListType idList = *(mapIt->second.GetIdList());
+    const IdListType & idList = *(mapIt->second.GetIdList());
 
-      //itkAssertInDebugOrThrowInReleaseMacro( !idList.empty() );
+    //itkAssertInDebugOrThrowInReleaseMacro( !idList.empty() );
 
-      for( IdListConstIterator idListIt = idList.begin(); idListIt != idList.end(); ++idListIt )
-        {
-        typename LevelSetType::Pointer levelSetUpdate = this->m_Associate->m_UpdateBuffer->GetLevelSet( *idListIt - 1 );
+    for( IdListConstIterator idListIt = idList.begin(); idListIt != idList.end(); ++idListIt )
+      {
+      typename LevelSetType::Pointer levelSetUpdate = this->m_Associate->m_UpdateBuffer->GetLevelSet( *idListIt - 1 );
 
-        OffsetType offset = levelSetUpdate->GetDomainOffset();
-        IndexType levelSetIndex = it.GetIndex() - offset;
+      OffsetType offset = levelSetUpdate->GetDomainOffset();
 
-        LevelSetDataType characteristics;
-        typename TermContainerType::Pointer termContainer = this->m_Associate->m_EquationContainer->GetEquation( *idListIt - 1 );
-        termContainer->ComputeRequiredData( it.GetIndex(), characteristics );
-        LevelSetOutputRealType tempUpdate = termContainer->Evaluate( it.GetIndex(), characteristics );
+      typename TermContainerType::Pointer termContainer = this->m_Associate->m_EquationContainer->GetEquation( *idListIt - 1 );
+      LevelSetImageType * levelSetImage = levelSetUpdate->GetModifiableImage();
 
-        LevelSetImageType * levelSetImage = levelSetUpdate->GetModifiableImage();
-        levelSetImage->SetPixel( levelSetIndex, tempUpdate );
+      it.GoToBegin();
+      while( !it.IsAtEnd() )
+        {
+        SizeValueType numberOfPoints = 0;
+        while( !it.IsAtEnd() && numberOfPoints < blockSize )
+          {
+          inputIndices[numberOfPoints] = it.GetIndex();
+          ++numberOfPoints;
+          ++it;
+          }
+        termContainer->ComputeRequiredData( inputIndices, numberOfPoints, characteristics );
+        termContainer->Evaluate( inputIndices, characteristics, numberOfPoints, updates );
+        for( SizeValueType ii = 0; ii < numberOfPoints; ++ii )
+          {
+          levelSetImage->SetPixel( inputIndices[ii] - offset, updates[ii] );
+          }
         }
-      ++it;
       }
     ++mapIt;
     }
@@ -206,23 +239,35 @@ LevelSetEvolutionComputeIterationThreader<
 
   typename TermContainerType::Pointer termContainer = this->m_Associate->m_EquationContainer->GetEquation( levelSetId );
 
+  // The terms are evaluated over blocks of consecutive nodes, reusing the
+  // same buffers from one block to the next.
+  const SizeValueType blockSize = TermContainerType::EvaluationBlockSize;
+  LevelSetInputIndexBlockType inputIndices( blockSize );
+  LevelSetDataBlockType characteristics( blockSize );
+  LevelSetOutputRealBlockType updates( blockSize );
+
   typename LevelSetType::LayerConstIterator listIt = iteratorSubRange.Begin();
 
   while( listIt != iteratorSubRange.End() )
     {
-    const LevelSetInputType levelsetIndex = listIt->first;
-    LevelSetInputType inputIndex = listIt->first + offset;
-
-    LevelSetDataType characteristics;
-
-    termContainer->ComputeRequiredData( inputIndex, characteristics );
+    SizeValueType numberOfPoints = 0;
+    while( listIt != iteratorSubRange.End() && numberOfPoints < blockSize )
+      {
+      inputIndices[numberOfPoints] = listIt->first + offset;
+      ++numberOfPoints;
+      ++listIt;
+      }
 
-    const LevelSetOutputType temp_update =
-        static_cast< LevelSetOutputType >( termContainer->Evaluate( inputIndex, characteristics ) );
+    termContainer->ComputeRequiredData( inputIndices, numberOfPoints, characteristics );
+    termContainer->Evaluate( inputIndices, characteristics, numberOfPoints, updates );
 
-    this->m_NodePairsPerThread[threadId].push_back( NodePairType( levelsetIndex, temp_update ) );
+    for( SizeValueType ii = 0; ii < numberOfPoints; ++ii )
+      {
+      const LevelSetInputType levelsetIndex = inputIndices[ii] - offset;
+      const LevelSetOutputType temp_update = static_cast< LevelSetOutputType >( updates[ii] );
 
-    ++listIt;
+      this->m_NodePairsPerThread[threadId].push_back( NodePairType( levelsetIndex, temp_update ) );
+      }
     }
 }
 
@@ -238,13 +283,15 @@ LevelSetEvolutionComputeIterationThreader<
   LevelSetIdentifierType levelSetId = it->GetIdentifier();
   typename LevelSetEvolutionType::LevelSetLayerType * levelSetLayerUpdateBuffer = this->m_Associate->m_UpdateBuffer[ levelSetId ];
 
+  // The threads process consecutive ranges of the zero layer, so the pairs
+  // arrive in the order of the buffer and are appended at its end.
   const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
   for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
     {
     typename std::vector< NodePairType >::const_iterator pairIt = this->m_NodePairsPerThread[ii].begin();
     while( pairIt != this->m_NodePairsPerThread[ii].end() )
       {
-      levelSetLayerUpdateBuffer->insert( *pairIt );
+      levelSetLayerUpdateBuffer->insert( levelSetLayerUpdateBuffer->end(), *pairIt );
       ++pairIt;
       }
     }
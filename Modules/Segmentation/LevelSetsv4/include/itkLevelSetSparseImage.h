@@ -25,6 +25,8 @@
 #include "itkLabelObject.h"
 #include "itkLabelMap.h"
 
+#include <vector>
+
 namespace itk
 {
 /**
@@ -34,6 +36,14 @@ namespace itk
  *  \tparam TImage Input image type of the level set function
  *  \todo Think about using image iterators instead of GetPixel()
  *
+ *  The lines of the label map are also kept in an array sorted by their
+ *  starting index, so that the status of a location outside the layers is
+ *  found by a binary search instead of a traversal of the lines of the label
+ *  objects. The array is rebuilt by SetLabelMap(), Graft() and
+ *  UpdateStatusLines(). It is not used once the modifiable label map has been
+ *  handed out, since its label objects may then be edited, nor once the label
+ *  map has been modified, until it is rebuilt.
+ *
  *  \ingroup ITKLevelSetsv4
  */
 template< typename TOutput, unsigned int VDimension >
@@ -92,9 +102,19 @@ public:
   /** Set a layer map with id to the given layer pointer */
   void SetLayer( LayerIdType value, const LayerType& layer );
 
-  /** Set/Get the label map for computing the sparse representation */
+  /** Set/Get the label map for computing the sparse representation. Getting
+   * the modifiable label map disables the sorted lines until they are
+   * rebuilt. */
   virtual void SetLabelMap( LabelMapType* labelMap );
-  itkGetModifiableObjectMacro(LabelMap, LabelMapType );
+  virtual LabelMapType * GetModifiableLabelMap();
+  itkGetConstObjectMacro(LabelMap, LabelMapType );
+#if !defined ( ITK_FUTURE_LEGACY_REMOVE )
+  virtual LabelMapType * GetLabelMap();
+#endif
+
+  /** Rebuild the sorted lines of the label map, after its label objects were
+   * modified */
+  void UpdateStatusLines();
 
   /** Graft data object as level set object */
   virtual void Graft( const DataObject* data ) ITK_OVERRIDE;
@@ -107,10 +127,30 @@ protected:
   LevelSetSparseImage();
   virtual ~LevelSetSparseImage();
 
+  /** A line of the label map, with the status of its label */
+  struct StatusLineType
+    {
+    InputType             m_Index;
+    LabelObjectLengthType m_Length;
+    LayerIdType           m_Status;
+    };
+  typedef std::vector< StatusLineType > StatusLineContainerType;
+
   LayerMapType      m_Layers;
   LabelMapPointer   m_LabelMap;
   LayerIdListType   m_InternalLabelList;
 
+  /** Find the status of mapIndex, an index of the label map, in the sorted
+   * lines. Return false if the lines are out of date. */
+  bool FindStatus( const InputType& mapIndex, LayerIdType& status ) const;
+
+  /** Evaluate the level set at mapIndex, an index of the label map, from its
+   * status: the value of the node in the layer of that status, or the status
+   * itself outside the layers. Return false if the lines are out of date, or
+   * do not agree with the layers, in which case the layers and the label map
+   * must be searched. */
+  bool EvaluateFromStatus( const InputType& mapIndex, OutputType& value ) const;
+
   /** Initialize the sparse field layers */
   virtual void InitializeLayers() = 0;
 
@@ -127,6 +167,40 @@ protected:
 private:
   LevelSetSparseImage( const Self& ) ITK_DELETE_FUNCTION;
   void operator = ( const Self& ) ITK_DELETE_FUNCTION;
+
+  /** Orders the lines of the label map along the last dimension first, so
+   * that the lines of a row are contiguous and sorted by their first
+   * index. */
+  struct StatusLineLess
+    {
+    bool operator()( const StatusLineType& line, const InputType& index ) const
+      {
+      return Less( line.m_Index, index );
+      }
+    bool operator()( const InputType& index, const StatusLineType& line ) const
+      {
+      return Less( index, line.m_Index );
+      }
+    bool operator()( const StatusLineType& a, const StatusLineType& b ) const
+      {
+      return Less( a.m_Index, b.m_Index );
+      }
+    static bool Less( const InputType& a, const InputType& b )
+      {
+      for( unsigned int dim = VDimension - 1; dim > 0; --dim )
+        {
+        if( a[dim] != b[dim] )
+          {
+          return a[dim] < b[dim];
+          }
+        }
+      return a[0] < b[0];
+      }
+    };
+
+  StatusLineContainerType m_StatusLines;
+  ModifiedTimeType        m_StatusLinesMTime;
+  bool                    m_StatusLinesValid;
 };
 
 }
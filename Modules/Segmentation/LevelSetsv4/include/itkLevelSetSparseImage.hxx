@@ -21,12 +21,16 @@
 
 #include "itkLevelSetSparseImage.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
 template< typename TOutput, unsigned int VDimension >
 LevelSetSparseImage< TOutput, VDimension >
-::LevelSetSparseImage()
+::LevelSetSparseImage() :
+  m_StatusLinesMTime( 0 ),
+  m_StatusLinesValid( false )
 {}
 
 
@@ -42,6 +46,11 @@ LevelSetSparseImage< TOutput, VDimension >
 ::Status( const InputType& inputIndex ) const
 {
   InputType mapIndex = inputIndex - this->m_DomainOffset;
+  LayerIdType status;
+  if( this->FindStatus( mapIndex, status ) )
+    {
+    return status;
+    }
   return this->m_LabelMap->GetPixel( mapIndex );
 }
 
@@ -52,6 +61,7 @@ LevelSetSparseImage< TOutput, VDimension >
 ::SetLabelMap( LabelMapType* labelMap )
 {
   this->m_LabelMap = labelMap;
+  this->UpdateStatusLines();
 
   typedef typename LabelMapType::SpacingType SpacingType;
 
@@ -66,6 +76,28 @@ LevelSetSparseImage< TOutput, VDimension >
 }
 
 
+template< typename TOutput, unsigned int VDimension >
+typename LevelSetSparseImage< TOutput, VDimension >::LabelMapType *
+LevelSetSparseImage< TOutput, VDimension >
+::GetModifiableLabelMap()
+{
+  // the label objects may be edited without modifying the label map
+  this->m_StatusLinesValid = false;
+  return this->m_LabelMap.GetPointer();
+}
+
+
+#if !defined ( ITK_FUTURE_LEGACY_REMOVE )
+template< typename TOutput, unsigned int VDimension >
+typename LevelSetSparseImage< TOutput, VDimension >::LabelMapType *
+LevelSetSparseImage< TOutput, VDimension >
+::GetLabelMap()
+{
+  return this->GetModifiableLabelMap();
+}
+#endif
+
+
 template< typename TOutput, unsigned int VDimension >
 bool
 LevelSetSparseImage< TOutput, VDimension >
@@ -102,6 +134,142 @@ LevelSetSparseImage< TOutput, VDimension >
     LayerMapType newLayers( levelSet->m_Layers );
     std::swap( m_Layers, newLayers );
     }
+  this->UpdateStatusLines();
+}
+
+
+template< typename TOutput, unsigned int VDimension >
+void
+LevelSetSparseImage< TOutput, VDimension >
+::UpdateStatusLines()
+{
+  this->m_StatusLines.clear();
+  this->m_StatusLinesMTime = 0;
+  this->m_StatusLinesValid = false;
+
+  if( this->m_LabelMap.IsNull() )
+    {
+    return;
+    }
+
+  typename LabelMapType::ConstIterator labelObjectIt( this->m_LabelMap );
+  while( !labelObjectIt.IsAtEnd() )
+    {
+    const LabelObjectType * labelObject = labelObjectIt.GetLabelObject();
+    typename LabelObjectType::ConstLineIterator lineIt( labelObject );
+    while( !lineIt.IsAtEnd() )
+      {
+      StatusLineType statusLine;
+      statusLine.m_Index = lineIt.GetLine().GetIndex();
+      statusLine.m_Length = lineIt.GetLine().GetLength();
+      statusLine.m_Status = labelObject->GetLabel();
+      this->m_StatusLines.push_back( statusLine );
+      ++lineIt;
+      }
+    ++labelObjectIt;
+    }
+  std::sort( this->m_StatusLines.begin(), this->m_StatusLines.end(), StatusLineLess() );
+
+  // merge the overlapping lines of a label, which are allowed in a label
+  // object that was not optimized, so that a location is covered by the last
+  // line starting at or before it
+  typename StatusLineContainerType::iterator outIt = this->m_StatusLines.begin();
+  typename StatusLineContainerType::const_iterator inIt = this->m_StatusLines.begin();
+  while( inIt != this->m_StatusLines.end() )
+    {
+    bool sameRow = ( outIt != inIt ) && ( outIt->m_Status == inIt->m_Status );
+    for( unsigned int dim = 1; sameRow && dim < VDimension; ++dim )
+      {
+      sameRow = ( outIt->m_Index[dim] == inIt->m_Index[dim] );
+      }
+    const IndexValueType outEnd = outIt->m_Index[0] + static_cast< IndexValueType >( outIt->m_Length );
+    if( sameRow && inIt->m_Index[0] <= outEnd )
+      {
+      const IndexValueType inEnd = inIt->m_Index[0] + static_cast< IndexValueType >( inIt->m_Length );
+      if( inEnd > outEnd )
+        {
+        outIt->m_Length = static_cast< LabelObjectLengthType >( inEnd - outIt->m_Index[0] );
+        }
+      }
+    else
+      {
+      if( outIt != inIt )
+        {
+        ++outIt;
+        *outIt = *inIt;
+        }
+      }
+    ++inIt;
+    }
+  if( !this->m_StatusLines.empty() )
+    {
+    this->m_StatusLines.erase( outIt + 1, this->m_StatusLines.end() );
+    }
+
+  this->m_StatusLinesMTime = this->m_LabelMap->GetMTime();
+  this->m_StatusLinesValid = true;
+}
+
+
+template< typename TOutput, unsigned int VDimension >
+bool
+LevelSetSparseImage< TOutput, VDimension >
+::FindStatus( const InputType& mapIndex, LayerIdType& status ) const
+{
+  if( !this->m_StatusLinesValid || this->m_LabelMap->GetMTime() != this->m_StatusLinesMTime )
+    {
+    return false;
+    }
+
+  // the last line starting at or before mapIndex
+  typename StatusLineContainerType::const_iterator it =
+    std::upper_bound( this->m_StatusLines.begin(), this->m_StatusLines.end(), mapIndex, StatusLineLess() );
+
+  status = this->m_LabelMap->GetBackgroundValue();
+  if( it != this->m_StatusLines.begin() )
+    {
+    --it;
+    for( unsigned int dim = 1; dim < VDimension; ++dim )
+      {
+      if( it->m_Index[dim] != mapIndex[dim] )
+        {
+        return true;
+        }
+      }
+    if( mapIndex[0] < it->m_Index[0] + static_cast< IndexValueType >( it->m_Length ) )
+      {
+      status = it->m_Status;
+      }
+    }
+  return true;
+}
+
+
+template< typename TOutput, unsigned int VDimension >
+bool
+LevelSetSparseImage< TOutput, VDimension >
+::EvaluateFromStatus( const InputType& mapIndex, OutputType& value ) const
+{
+  LayerIdType status;
+  if( !this->FindStatus( mapIndex, status ) )
+    {
+    return false;
+    }
+
+  const LayerMapConstIterator layerIt = this->m_Layers.find( status );
+  if( layerIt == this->m_Layers.end() )
+    {
+    value = static_cast< OutputType >( status );
+    return true;
+    }
+
+  const LayerConstIterator it = ( layerIt->second ).find( mapIndex );
+  if( it == ( layerIt->second ).end() )
+    {
+    return false;
+    }
+  value = it->second;
+  return true;
 }
 
 
@@ -156,6 +324,7 @@ LevelSetSparseImage< TOutput, VDimension >
   Superclass::Initialize();
 
   this->m_LabelMap = ITK_NULLPTR;
+  this->UpdateStatusLines();
   this->InitializeLayers();
   this->InitializeInternalLabelList();
 }
@@ -46,6 +46,13 @@ ShiSparseLevelSetImage< VDimension >
 ::Evaluate( const InputType& inputIndex ) const
 {
   InputType mapIndex = inputIndex - this->m_DomainOffset;
+
+  OutputType value;
+  if( this->EvaluateFromStatus( mapIndex, value ) )
+    {
+    return value;
+    }
+
   LayerMapConstIterator layerIt = this->m_Layers.begin();
 
   while( layerIt != this->m_Layers.end() )
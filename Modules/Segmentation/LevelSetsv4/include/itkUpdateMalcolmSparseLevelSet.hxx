@@ -67,6 +67,10 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
   this->m_InternalImage = labelMapToLabelImageFilter->GetOutput();
   this->m_InternalImage->DisconnectPipeline();
 
+  // the terms are evaluated on the input level set while its label map is
+  // unchanged: rebuild the sorted lines disabled by handing out the label map
+  this->m_InputLevelSet->UpdateStatusLines();
+
   this->FillUpdateContainer();
 
   if( this->m_IsUsingUnPhasedPropagation )
@@ -127,6 +131,9 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 
   LevelSetLabelMapPointer outputLabelMap = this->m_OutputLevelSet->GetModifiableLabelMap( );
   outputLabelMap->Graft( labelImageToLabelMapFilter->GetOutput() );
+  // the label map is shared with the input level set, whose sorted status
+  // lines are now out of date
+  outputLabelMap->Modified();
 }
 
 template< unsigned int VDimension,
@@ -69,6 +69,10 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   this->m_InternalImage = labelMapToLabelImageFilter->GetOutput();
   this->m_InternalImage->DisconnectPipeline();
 
+  // the terms are evaluated on the input level set while its label map is
+  // unchanged: rebuild the sorted lines disabled by handing out the label map
+  this->m_InputLevelSet->UpdateStatusLines();
+
   // neighborhood iterator
   ZeroFluxNeumannBoundaryCondition< LabelImageType > spNBC;
 
@@ -192,6 +196,9 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
 
   LevelSetLabelMapPointer outputLabelMap = this->m_OutputLevelSet->GetModifiableLabelMap( );
   outputLabelMap->Graft( labelImageToLabelMapFilter->GetOutput() );
+  // the label map is shared with the input level set, whose sorted status
+  // lines are now out of date
+  outputLabelMap->Modified();
 }
 
 template< unsigned int VDimension, typename TEquationContainer >
@@ -98,7 +98,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
   // Here, we are adding all pairs of indices and levelset values to a map
   for( LevelSetLayerIdType status = LevelSetType::MinusOneLayer(); status < LevelSetType::PlusTwoLayer(); ++status )
     {
-    const LevelSetLayerType layer = this->m_InputLevelSet->GetLayer( status );
+    const LevelSetLayerType & layer = this->m_InputLevelSet->GetLayer( status );
 
     LevelSetLayerConstIterator it = layer.begin();
     while( it != layer.end() )
@@ -154,7 +154,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
     ++it;
     }
 
-  LevelSetLayerType layerPlus2 = this->m_InputLevelSet->GetLayer( LevelSetType::PlusTwoLayer() );
+  const LevelSetLayerType & layerPlus2 = this->m_InputLevelSet->GetLayer( LevelSetType::PlusTwoLayer() );
 
   it = layerPlus2.begin();
   while( it != layerPlus2.end() )
@@ -195,6 +195,9 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
   labelImageToLabelMapFilter->Update();
 
   this->m_OutputLevelSet->GetModifiableLabelMap( )->Graft( labelImageToLabelMapFilter->GetOutput() );
+  // the label map is shared with the input level set, whose sorted status
+  // lines are now out of date
+  this->m_OutputLevelSet->GetModifiableLabelMap( )->Modified();
   this->m_TempPhi.clear();
 }
 
@@ -46,6 +46,13 @@ WhitakerSparseLevelSetImage< TOutput, VDimension >
 ::Evaluate( const InputType& inputIndex ) const
 {
   InputType mapIndex = inputIndex - this->m_DomainOffset;
+
+  OutputType value;
+  if( this->EvaluateFromStatus( mapIndex, value ) )
+    {
+    return value;
+    }
+
   LayerMapConstIterator layerIt = this->m_Layers.begin();
 
   OutputType rval = static_cast<OutputType>(ZeroLayer());
@@ -23,6 +23,48 @@
 #include "itkSinRegularizedHeavisideStepFunction.h"
 #include "itkBinaryImageToLevelSetImageAdaptor.h"
 
+namespace itk
+{
+/** \class LevelSetEquationTermContainerTestLaplacianTerm
+ *  Laplacian term with an overridden Value, which the block evaluation
+ *  must call like the evaluation at a single location.
+ */
+template< typename TInput, typename TLevelSetContainer >
+class LevelSetEquationTermContainerTestLaplacianTerm :
+    public LevelSetEquationLaplacianTerm< TInput, TLevelSetContainer >
+{
+public:
+  typedef LevelSetEquationTermContainerTestLaplacianTerm         Self;
+  typedef SmartPointer< Self >                                   Pointer;
+  typedef LevelSetEquationLaplacianTerm< TInput, TLevelSetContainer >
+                                                                 Superclass;
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::LevelSetOutputRealType LevelSetOutputRealType;
+  typedef typename Superclass::LevelSetInputIndexType LevelSetInputIndexType;
+  typedef typename Superclass::LevelSetDataType       LevelSetDataType;
+
+protected:
+  LevelSetEquationTermContainerTestLaplacianTerm() {}
+
+  virtual LevelSetOutputRealType Value( const LevelSetInputIndexType& iP ) ITK_OVERRIDE
+    {
+    return Superclass::Value( iP ) + 1.0;
+    }
+
+  virtual LevelSetOutputRealType Value( const LevelSetInputIndexType& iP,
+                                        const LevelSetDataType& iData ) ITK_OVERRIDE
+    {
+    return Superclass::Value( iP, iData ) + 1.0;
+    }
+
+private:
+  LevelSetEquationTermContainerTestLaplacianTerm( const Self& ) ITK_DELETE_FUNCTION;
+  void operator = ( const Self& ) ITK_DELETE_FUNCTION;
+};
+}
+
 int itkLevelSetEquationTermContainerTest( int argc, char* argv[] )
 {
   if( argc < 2 )
@@ -53,6 +95,9 @@ int itkLevelSetEquationTermContainerTest( int argc, char* argv[] )
   typedef itk::LevelSetEquationChanAndVeseInternalTerm< InputImageType, LevelSetContainerType >
                                                                            ChanAndVeseInternalTermType;
 
+  typedef itk::LevelSetEquationTermContainerTestLaplacianTerm< InputImageType, LevelSetContainerType >
+                                                                           DerivedLaplacianTermType;
+
   typedef std::list< IdentifierType >                       IdListType;
   typedef itk::Image< IdListType, Dimension >               IdListImageType;
   typedef itk::Image< short, Dimension >                    CacheImageType;
@@ -159,6 +204,11 @@ int itkLevelSetEquationTermContainerTest( int argc, char* argv[] )
   term1->SetCoefficient( 1.0 );
   std::cout << "CV internal term created" << std::endl;
 
+  DerivedLaplacianTermType::Pointer term2 = DerivedLaplacianTermType::New();
+  term2->SetInput( binary );
+  term2->SetCoefficient( 1.0 );
+  std::cout << "Derived Laplacian term created" << std::endl;
+
   TermContainerType::Pointer termContainer0 = TermContainerType::New();
   termContainer0->SetInput( binary );
   termContainer0->SetCurrentLevelSetId( 0 );
@@ -166,8 +216,63 @@ int itkLevelSetEquationTermContainerTest( int argc, char* argv[] )
 
   termContainer0->AddTerm( 0, term0 );
   termContainer0->AddTerm( 1, term1 );
+  termContainer0->AddTerm( 2, term2 );
 
   std::cout << "Term container 0 created" << std::endl;
 
+  termContainer0->InitializeParameters();
+
+  InputIteratorType it( binary, binary->GetLargestPossibleRegion() );
+  it.GoToBegin();
+  while( !it.IsAtEnd() )
+    {
+    termContainer0->Initialize( it.GetIndex() );
+    ++it;
+    }
+  termContainer0->Update();
+
+  // The terms evaluated over blocks of locations must give the same values
+  // as the terms evaluated one location at a time.
+  typedef TermContainerType::LevelSetInputIndexBlockType  InputIndexBlockType;
+  typedef TermContainerType::LevelSetDataBlockType        DataBlockType;
+  typedef TermContainerType::LevelSetOutputRealBlockType  OutputRealBlockType;
+  typedef TermContainerType::LevelSetDataType             LevelSetDataType;
+
+  const itk::SizeValueType blockSize = TermContainerType::EvaluationBlockSize;
+  InputIndexBlockType indices( blockSize );
+  DataBlockType characteristics( blockSize );
+  OutputRealBlockType values( blockSize );
+
+  it.GoToBegin();
+  while( !it.IsAtEnd() )
+    {
+    itk::SizeValueType numberOfPoints = 0;
+    while( !it.IsAtEnd() && numberOfPoints < blockSize )
+      {
+      indices[numberOfPoints] = it.GetIndex();
+      ++numberOfPoints;
+      ++it;
+      }
+
+    termContainer0->ComputeRequiredData( indices, numberOfPoints, characteristics );
+    termContainer0->Evaluate( indices, characteristics, numberOfPoints, values );
+
+    for( itk::SizeValueType i = 0; i < numberOfPoints; ++i )
+      {
+      LevelSetDataType data;
+      termContainer0->ComputeRequiredData( indices[i], data );
+      const LevelSetOutputRealType expected = termContainer0->Evaluate( indices[i], data );
+
+      if( itk::Math::NotExactlyEquals( values[i], expected ) )
+        {
+        std::cerr << "Block evaluation at " << indices[i] << " is " << values[i]
+                  << " instead of " << expected << std::endl;
+        std::cerr << "Test failed!" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  std::cout << "Block evaluation checked" << std::endl;
+
   return EXIT_SUCCESS;
 }
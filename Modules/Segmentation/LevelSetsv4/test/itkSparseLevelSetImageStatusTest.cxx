@@ -0,0 +1,208 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBinaryImageToLevelSetImageAdaptor.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+
+/* Checks the status and the values of the sparse level sets, which are found
+ * in the sorted lines of their label map, against the layers and the label
+ * map themselves, before and after the label map or one of its label objects
+ * is modified. */
+
+namespace
+{
+
+const unsigned int Dimension = 3;
+typedef itk::Image< unsigned char, Dimension > BinaryImageType;
+
+BinaryImageType::Pointer
+CreateBinaryImage()
+{
+  BinaryImageType::SizeType size;
+  size.Fill( 24 );
+  BinaryImageType::RegionType region;
+  region.SetSize( size );
+
+  BinaryImageType::Pointer binary = BinaryImageType::New();
+  binary->SetRegions( region );
+  binary->Allocate();
+
+  // a hollow ball, and a box touching the border of the image
+  itk::ImageRegionIteratorWithIndex< BinaryImageType > it( binary, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const BinaryImageType::IndexType index = it.GetIndex();
+    double distance = 0.0;
+    for( unsigned int dim = 0; dim < Dimension; ++dim )
+      {
+      distance += ( index[dim] - 10.0 ) * ( index[dim] - 10.0 );
+      }
+    distance = std::sqrt( distance );
+    const bool ball = distance < 7.0 && distance > 3.0;
+    const bool box = index[0] >= 18 && index[1] >= 3 && index[1] < 12 && index[2] < 8;
+    it.Set( ( ball || box ) ? 1 : 0 );
+    }
+  return binary;
+}
+
+template< typename TLevelSet >
+bool
+CheckLevelSet( const TLevelSet *levelSet, const std::vector< typename TLevelSet::LayerIdType > & layerIds,
+               const BinaryImageType *binary, const char *name )
+{
+  typedef typename TLevelSet::LayerType LayerType;
+
+  const typename TLevelSet::LabelMapType *labelMap = levelSet->GetLabelMap();
+
+  itk::ImageRegionConstIteratorWithIndex< BinaryImageType > it( binary, binary->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TLevelSet::InputType index = it.GetIndex();
+
+    const typename TLevelSet::LayerIdType expectedStatus = labelMap->GetPixel( index );
+    typename TLevelSet::OutputType expectedValue = static_cast< typename TLevelSet::OutputType >( expectedStatus );
+    for( size_t i = 0; i < layerIds.size(); ++i )
+      {
+      const LayerType & layer = levelSet->GetLayer( layerIds[i] );
+      typename LayerType::const_iterator nodeIt = layer.find( index );
+      if( nodeIt != layer.end() )
+        {
+        expectedValue = nodeIt->second;
+        break;
+        }
+      }
+
+    if( levelSet->Status( index ) != expectedStatus )
+      {
+      std::cerr << name << ": status at " << index << " is "
+                << static_cast< int >( levelSet->Status( index ) ) << " instead of "
+                << static_cast< int >( expectedStatus ) << std::endl;
+      return false;
+      }
+    if( itk::Math::NotExactlyEquals( levelSet->Evaluate( index ), expectedValue ) )
+      {
+      std::cerr << name << ": value at " << index << " is " << levelSet->Evaluate( index )
+                << " instead of " << expectedValue << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TLevelSet >
+bool
+CheckSparseLevelSet( BinaryImageType *binary, const std::vector< typename TLevelSet::LayerIdType > & layerIds,
+                     typename TLevelSet::LayerIdType insideStatus, const char *name )
+{
+  typedef itk::BinaryImageToLevelSetImageAdaptor< BinaryImageType, TLevelSet > AdaptorType;
+  typename AdaptorType::Pointer adaptor = AdaptorType::New();
+  adaptor->SetInputImage( binary );
+  adaptor->Initialize();
+
+  typename TLevelSet::Pointer levelSet = adaptor->GetModifiableLevelSet();
+  if( !CheckLevelSet( levelSet.GetPointer(), layerIds, binary, name ) )
+    {
+    return false;
+    }
+
+  // modify the label map: its sorted lines are then out of date, and the
+  // label map itself must be used
+  typename TLevelSet::InputType index;
+  index.Fill( 23 );
+  levelSet->GetModifiableLabelMap()->SetPixel( index, insideStatus );
+  if( levelSet->Status( index ) != insideStatus )
+    {
+    std::cerr << name << ": the status of the modified label map is not used" << std::endl;
+    return false;
+    }
+  if( !CheckLevelSet( levelSet.GetPointer(), layerIds, binary, name ) )
+    {
+    return false;
+    }
+
+  // setting the label map again sorts its lines
+  levelSet->SetLabelMap( levelSet->GetModifiableLabelMap() );
+  if( !CheckLevelSet( levelSet.GetPointer(), layerIds, binary, name ) )
+    {
+    return false;
+    }
+
+  // modify a label object of the modifiable label map, which does not
+  // modify the label map itself: the sorted lines must not be used anymore
+  index[0] = 23;
+  index[1] = 0;
+  index[2] = 23;
+  const typename TLevelSet::LayerIdType backgroundStatus = levelSet->Status( index );
+  levelSet->GetModifiableLabelMap()->GetLabelObject( insideStatus )->AddIndex( index );
+  if( levelSet->Status( index ) != insideStatus || backgroundStatus == insideStatus )
+    {
+    std::cerr << name << ": the status of the modified label object is not used" << std::endl;
+    return false;
+    }
+  if( !CheckLevelSet( levelSet.GetPointer(), layerIds, binary, name ) )
+    {
+    return false;
+    }
+
+  // rebuilding the lines takes the modified label object into account
+  levelSet->UpdateStatusLines();
+  if( levelSet->Status( index ) != insideStatus )
+    {
+    std::cerr << name << ": the rebuilt lines do not contain the modified label object" << std::endl;
+    return false;
+    }
+  return CheckLevelSet( levelSet.GetPointer(), layerIds, binary, name );
+}
+
+} // end namespace
+
+int itkSparseLevelSetImageStatusTest( int , char* [] )
+{
+  BinaryImageType::Pointer binary = CreateBinaryImage();
+
+  bool passed = true;
+
+  typedef itk::WhitakerSparseLevelSetImage< double, Dimension > WhitakerType;
+  std::vector< WhitakerType::LayerIdType > whitakerLayers;
+  for( WhitakerType::LayerIdType id = WhitakerType::MinusTwoLayer(); id <= WhitakerType::PlusTwoLayer(); ++id )
+    {
+    whitakerLayers.push_back( id );
+    }
+  passed &= CheckSparseLevelSet< WhitakerType >( binary, whitakerLayers, WhitakerType::MinusThreeLayer(), "Whitaker" );
+
+  typedef itk::ShiSparseLevelSetImage< Dimension > ShiType;
+  std::vector< ShiType::LayerIdType > shiLayers;
+  shiLayers.push_back( ShiType::MinusOneLayer() );
+  shiLayers.push_back( ShiType::PlusOneLayer() );
+  passed &= CheckSparseLevelSet< ShiType >( binary, shiLayers, ShiType::MinusThreeLayer(), "Shi" );
+
+  typedef itk::MalcolmSparseLevelSetImage< Dimension > MalcolmType;
+  std::vector< MalcolmType::LayerIdType > malcolmLayers;
+  malcolmLayers.push_back( MalcolmType::ZeroLayer() );
+  passed &= CheckSparseLevelSet< MalcolmType >( binary, malcolmLayers, MalcolmType::MinusOneLayer(), "Malcolm" );
+
+  if( !passed )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
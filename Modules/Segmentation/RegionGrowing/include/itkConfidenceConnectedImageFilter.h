@@ -52,6 +52,11 @@ namespace itk
  * NOTE: the lower and upper threshold are restricted to lie within the
  * valid numeric limits of the input data pixel type. Also, the limits
  * may be adjusted to contain the seed point's intensity.
+ *
+ * The segmentations are grown by
+ * FloodFilledImageFunctionConditionalThreader, with the threads of the
+ * filter.
+ *
  * \ingroup RegionGrowingSegmentation
  * \ingroup ITKRegionGrowing
  *
@@ -25,7 +25,7 @@
 #include "itkMeanImageFunction.h"
 #include "itkSumOfSquaresImageFunction.h"
 #include "itkBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkFloodFilledImageFunctionConditionalThreader.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -138,11 +138,8 @@ void
 ConfidenceConnectedImageFilter< TInputImage, TOutputImage >
 ::GenerateData()
 {
-  typedef BinaryThresholdImageFunction< InputImageType, double >  FunctionType;
-  typedef BinaryThresholdImageFunction< OutputImageType, double > SecondFunctionType;
-
-  typedef FloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType >           IteratorType;
-  typedef FloodFilledImageFunctionConditionalConstIterator< InputImageType, SecondFunctionType > SecondIteratorType;
+  typedef BinaryThresholdImageFunction< InputImageType, double >                       FunctionType;
+  typedef FloodFilledImageFunctionConditionalThreader< OutputImageType, FunctionType > FillerType;
 
   unsigned int loop;
 
@@ -302,20 +299,15 @@ ConfidenceConnectedImageFilter< TInputImage, TOutputImage >
     << "\nLower intensity = " << lower << ", Upper intensity = " << upper << "\nmean = " << m_Mean
     << " , std::sqrt(variance) = " << std::sqrt(m_Variance) );
 
-  // Segment the image, the iterator walks the output image (so Set()
+  // Segment the image, the flood fill walks the output image (so it
   // writes into the output image), starting at the seed point.  As
-  // the iterator walks, if the corresponding pixel in the input image
-  // (accessed via the "function" assigned to the iterator) is within
+  // the fill walks, if the corresponding pixel in the input image
+  // (accessed via the "function" assigned to the filler) is within
   // the [lower, upper] bounds prescribed, the pixel is added to the
   // output segmentation and its neighbors become candidates for the
-  // iterator to walk.
-  IteratorType it = IteratorType (outputImage, function, m_Seeds);
-  it.GoToBegin();
-  while ( !it.IsAtEnd() )
-    {
-    it.Set(m_ReplaceValue);
-    ++it;
-    }
+  // fill to walk.
+  typename FillerType::Pointer filler = FillerType::New();
+  filler->Fill( this, outputImage, function, m_Seeds, m_ReplaceValue );
 
   ProgressReporter progress(this, 0, region.GetNumberOfPixels() * m_NumberOfIterations);
 
@@ -324,28 +316,26 @@ ConfidenceConnectedImageFilter< TInputImage, TOutputImage >
     // Now that we have an initial segmentation, let's recalculate the
     // statistics.  Since we have already labelled the output, we visit
     // pixels in the input image that have been set in the output image.
-    // Essentially, we flip the iterator around, so we walk the input
-    // image (so Get() will get pixel values from the input) and constrain
-    // iterator such it only visits pixels that were set in the output.
-    typename SecondFunctionType::Pointer secondFunction = SecondFunctionType::New();
-    secondFunction->SetInputImage (outputImage);
-    secondFunction->ThresholdBetween(m_ReplaceValue, m_ReplaceValue);
-
+    // The output only holds the region grown from the seeds, so a scan
+    // of the bounding region of the filled pixels visits the same pixels
+    // as a flood fill of the pixels set in the output.
     typename NumericTraits< typename InputImageType::PixelType >::RealType sum, sumOfSquares;
     sum = NumericTraits< InputRealType >::ZeroValue();
     sumOfSquares = NumericTraits< InputRealType >::ZeroValue();
     typename TOutputImage::SizeValueType numberOfSamples = 0;
 
-    SecondIteratorType sit =
-      SecondIteratorType (inputImage, secondFunction, m_Seeds);
-    sit.GoToBegin();
-    while ( !sit.IsAtEnd() )
+    const OutputImageRegionType filledRegion = filler->GetFilledRegion();
+    ImageRegionConstIterator< InputImageType > sit( inputImage, filledRegion );
+    ImageRegionConstIterator< OutputImageType > oit( outputImage, filledRegion );
+    for ( ; !oit.IsAtEnd(); ++sit, ++oit )
       {
-      const InputRealType value = static_cast< InputRealType >( sit.Get() );
-      sum += value;
-      sumOfSquares += value * value;
-      ++numberOfSamples;
-      ++sit;
+      if ( Math::ExactlyEquals( oit.Get(), m_ReplaceValue ) )
+        {
+        const InputRealType value = static_cast< InputRealType >( sit.Get() );
+        sum += value;
+        sumOfSquares += value * value;
+        ++numberOfSamples;
+        }
       }
     m_Mean      = sum / double(numberOfSamples);
     m_Variance  = ( sumOfSquares - ( sum * sum / double(numberOfSamples) ) ) / ( double(numberOfSamples) - 1.0 );
@@ -405,17 +395,17 @@ ConfidenceConnectedImageFilter< TInputImage, TOutputImage >
     // upper] bounds prescribed, the pixel is added to the output
     // segmentation and its neighbors become candidates for the
     // iterator to walk.
-    outputImage->FillBuffer (NumericTraits< OutputImagePixelType >::ZeroValue());
-    IteratorType thirdIt = IteratorType (outputImage, function, m_Seeds);
-    thirdIt.GoToBegin();
+    // Only the bounding region of the previous segmentation needs to be
+    // cleared.
+    ImageRegionIterator< OutputImageType > cit( outputImage, filledRegion );
+    for ( ; !cit.IsAtEnd(); ++cit )
+      {
+      cit.Set( NumericTraits< OutputImagePixelType >::ZeroValue() );
+      }
     try
       {
-      while ( !thirdIt.IsAtEnd() )
-        {
-        thirdIt.Set(m_ReplaceValue);
-        ++thirdIt;
-        progress.CompletedPixel();  // potential exception thrown here
-        }
+      // potential exception thrown by the progress
+      filler->Fill( this, outputImage, function, m_Seeds, m_ReplaceValue, &progress );
       }
     catch ( ProcessAborted & )
       {
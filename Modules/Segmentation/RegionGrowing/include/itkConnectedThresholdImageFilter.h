@@ -30,6 +30,9 @@ namespace itk
  * connected to an initial Seed AND lie within a Lower and Upper
  * threshold range.
  *
+ * The region is grown by FloodFilledImageFunctionConditionalThreader,
+ * with the threads of the filter.
+ *
  * \ingroup RegionGrowingSegmentation
  * \ingroup ITKRegionGrowing
  */
@@ -20,10 +20,8 @@
 
 #include "itkConnectedThresholdImageFilter.h"
 #include "itkBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkFloodFilledImageFunctionConditionalThreader.h"
 #include "itkProgressReporter.h"
-
-#include "itkShapedFloodFilledImageFunctionConditionalIterator.h"
 #include "itkMath.h"
 
 namespace itk
@@ -294,38 +292,14 @@ ConnectedThresholdImageFilter< TInputImage, TOutputImage >
 
   ProgressReporter progress( this, 0, region.GetNumberOfPixels() );
 
-  if ( this->m_Connectivity == FaceConnectivity )
-    {
-    typedef FloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType > IteratorType;
-    IteratorType it (outputImage, function, m_Seeds);
-    it.GoToBegin();
-
-    while ( !it.IsAtEnd() )
-      {
-      it.Set(m_ReplaceValue);
-      ++it;
-      progress.CompletedPixel();  // potential exception thrown here
-      }
-    }
-  else if ( this->m_Connectivity == FullConnectivity )
-    {
-    // use the fully connected iterator here. The fully connected iterator
-    // below is a superset of the above. However, it is reported to be 20%
-    // slower. Hence we use this "if" block to use the old iterator when
-    // we don't need full connectivity.
-
-    typedef ShapedFloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType > IteratorType;
-    IteratorType it (outputImage, function, m_Seeds);
-    it.FullyConnectedOn();
-    it.GoToBegin();
-
-    while ( !it.IsAtEnd() )
-      {
-      it.Set(m_ReplaceValue);
-      ++it;
-      progress.CompletedPixel();  // potential exception thrown here
-      }
-    }
+  // The threaded flood fill visits the pixels of
+  // FloodFilledImageFunctionConditionalIterator, or of
+  // ShapedFloodFilledImageFunctionConditionalIterator with full
+  // connectivity.
+  typedef FloodFilledImageFunctionConditionalThreader< OutputImageType, FunctionType > FillerType;
+  typename FillerType::Pointer filler = FillerType::New();
+  filler->SetFullyConnected( this->m_Connectivity == FullConnectivity );
+  filler->Fill( this, outputImage, function, m_Seeds, m_ReplaceValue, &progress );
 }
 } // end namespace itk
 
@@ -29,6 +29,9 @@ namespace itk
  * are connected to an initial Seed AND whose neighbors all lie within a
  * Lower and Upper threshold range.
  *
+ * The region is grown by FloodFilledImageFunctionConditionalThreader,
+ * with the threads of the filter.
+ *
  * \ingroup RegionGrowingSegmentation
  * \ingroup ITKRegionGrowing
  */
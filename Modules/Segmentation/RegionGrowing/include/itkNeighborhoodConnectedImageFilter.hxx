@@ -20,7 +20,7 @@
 
 #include "itkNeighborhoodConnectedImageFilter.h"
 #include "itkNeighborhoodBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkFloodFilledImageFunctionConditionalThreader.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -126,22 +126,21 @@ NeighborhoodConnectedImageFilter< TInputImage, TOutputImage >
   outputImage->FillBuffer (NumericTraits< OutputImagePixelType >::ZeroValue());
 
   typedef NeighborhoodBinaryThresholdImageFunction< InputImageType >                   FunctionType;
-  typedef FloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType > IteratorType;
+  typedef FloodFilledImageFunctionConditionalThreader< OutputImageType, FunctionType > FillerType;
 
   typename FunctionType::Pointer function = FunctionType::New();
   function->SetInputImage (inputImage);
   function->ThresholdBetween (m_Lower, m_Upper);
   function->SetRadius (m_Radius);
-  IteratorType it = IteratorType (outputImage, function, m_Seeds);
 
   ProgressReporter progress( this, 0,
                              outputImage->GetRequestedRegion().GetNumberOfPixels() );
-  while ( !it.IsAtEnd() )
-    {
-    it.Set(m_ReplaceValue);
-    ++it;
-    progress.CompletedPixel();
-    }
+
+  // the seeds are part of the region even if their neighborhood is not
+  // within the thresholds
+  typename FillerType::Pointer filler = FillerType::New();
+  filler->IncludeSeedsOn();
+  filler->Fill( this, outputImage, function, m_Seeds, m_ReplaceValue, &progress );
 }
 } // end namespace itk
 
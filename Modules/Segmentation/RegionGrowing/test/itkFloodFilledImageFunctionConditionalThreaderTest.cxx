@@ -0,0 +1,367 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConnectedThresholdImageFilter.h"
+#include "itkNeighborhoodConnectedImageFilter.h"
+#include "itkConfidenceConnectedImageFilter.h"
+#include "itkBinaryThresholdImageFunction.h"
+#include "itkNeighborhoodBinaryThresholdImageFunction.h"
+#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkFloodFilledImageFunctionConditionalThreader.h"
+#include "itkShapedFloodFilledImageFunctionConditionalIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace
+{
+
+typedef itk::Image< short, 3 >         InputImageType;
+typedef itk::Image< unsigned char, 3 > OutputImageType;
+typedef std::vector< InputImageType::IndexType > SeedContainerType;
+
+const unsigned char ReplaceValue = 3;
+
+// Fill the pixels visited by a flood filled iterator, as the filters
+// did before the threaded flood fill.
+template< typename TIterator >
+void
+IteratorFill( TIterator & it, bool goToBegin )
+{
+  if ( goToBegin )
+    {
+    it.GoToBegin();
+    }
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    it.Set( ReplaceValue );
+    }
+}
+
+OutputImageType::Pointer
+NewOutput( const InputImageType *input )
+{
+  OutputImageType::Pointer output = OutputImageType::New();
+  output->CopyInformation( input );
+  output->SetRegions( input->GetLargestPossibleRegion() );
+  output->Allocate( true );
+  return output;
+}
+
+// Fill the pixels with values in [lower, upper] connected to the seeds by
+// their faces, breadth first.
+OutputImageType::Pointer
+BreadthFirstFill( const InputImageType *input, const SeedContainerType & seeds, short lower, short upper )
+{
+  OutputImageType::Pointer output = NewOutput( input );
+  const InputImageType::RegionType region = input->GetLargestPossibleRegion();
+
+  std::queue< InputImageType::IndexType > front;
+  for ( unsigned int i = 0; i < seeds.size(); ++i )
+    {
+    if ( region.IsInside( seeds[i] ) && input->GetPixel( seeds[i] ) >= lower && input->GetPixel( seeds[i] ) <= upper
+         && output->GetPixel( seeds[i] ) == 0 )
+      {
+      output->SetPixel( seeds[i], ReplaceValue );
+      front.push( seeds[i] );
+      }
+    }
+  while ( !front.empty() )
+    {
+    const InputImageType::IndexType index = front.front();
+    front.pop();
+    for ( unsigned int n = 0; n < 2 * InputImageType::ImageDimension; ++n )
+      {
+      InputImageType::IndexType neighbor = index;
+      neighbor[n / 2] += ( n % 2 ) ? 1 : -1;
+      if ( region.IsInside( neighbor ) && output->GetPixel( neighbor ) == 0
+           && input->GetPixel( neighbor ) >= lower && input->GetPixel( neighbor ) <= upper )
+        {
+        output->SetPixel( neighbor, ReplaceValue );
+        front.push( neighbor );
+        }
+      }
+    }
+  return output;
+}
+
+bool
+SameImages( const OutputImageType *expected, const OutputImageType *output, const char *what, itk::ThreadIdType threads )
+{
+  itk::ImageRegionConstIterator< OutputImageType > eit( expected, expected->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< OutputImageType > oit( output, expected->GetLargestPossibleRegion() );
+  itk::SizeValueType filled = 0;
+  for ( ; !eit.IsAtEnd(); ++eit, ++oit )
+    {
+    if ( eit.Get() != oit.Get() )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << what << " with " << threads << " threads: " << static_cast< int >( oit.Get() )
+                << " instead of " << static_cast< int >( eit.Get() ) << " at " << eit.GetIndex() << std::endl;
+      return false;
+      }
+    filled += ( eit.Get() != 0 );
+    }
+  std::cout << what << " with " << threads << " threads: " << filled << " pixels." << std::endl;
+  return true;
+}
+
+}
+
+// Compare the regions grown by the threaded flood fill to the regions
+// visited by the flood filled iterators, on a smooth noisy image large
+// enough for the fronts of the fill to be examined by several threads.
+int itkFloodFilledImageFunctionConditionalThreaderTest( int, char* [] )
+{
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+  InputImageType::SizeType size;
+  size[0] = 71;
+  size[1] = 64;
+  size[2] = 57;
+
+  InputImageType::Pointer input = InputImageType::New();
+  input->SetRegions( size );
+  input->Allocate();
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+  for ( itk::ImageRegionIteratorWithIndex< InputImageType > it( input, input->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    const InputImageType::IndexType & index = it.GetIndex();
+    const double value = 100.0 * std::sin( 0.15 * index[0] ) * std::cos( 0.11 * index[1] )
+                         + 40.0 * std::sin( 0.07 * index[2] + 0.05 * index[0] )
+                         + 30.0 * generator->GetVariateWithClosedRange();
+    it.Set( static_cast< short >( value ) );
+    }
+
+  SeedContainerType seeds;
+  InputImageType::IndexType seed;
+  seed[0] = 10; seed[1] = 0; seed[2] = 20;
+  seeds.push_back( seed );
+  seed[0] = 60; seed[1] = 50; seed[2] = 5;
+  seeds.push_back( seed );
+  seed[0] = 200; seed[1] = 0; seed[2] = 0; // outside the image
+  seeds.push_back( seed );
+
+  const short lower = -40;
+  const short upper = 90;
+
+  // ConnectedThresholdImageFilter with face and full connectivity
+  typedef itk::BinaryThresholdImageFunction< InputImageType, double > ThresholdFunctionType;
+  ThresholdFunctionType::Pointer thresholdFunction = ThresholdFunctionType::New();
+  thresholdFunction->SetInputImage( input );
+  thresholdFunction->ThresholdBetween( lower, upper );
+
+  typedef itk::ConnectedThresholdImageFilter< InputImageType, OutputImageType > ConnectedThresholdType;
+  for ( unsigned int full = 0; full < 2; ++full )
+    {
+    OutputImageType::Pointer expected = NewOutput( input );
+    if ( full )
+      {
+      typedef itk::ShapedFloodFilledImageFunctionConditionalIterator< OutputImageType, ThresholdFunctionType > IteratorType;
+      IteratorType it( expected, thresholdFunction, seeds );
+      it.FullyConnectedOn();
+      IteratorFill( it, true );
+      }
+    else
+      {
+      typedef itk::FloodFilledImageFunctionConditionalIterator< OutputImageType, ThresholdFunctionType > IteratorType;
+      IteratorType it( expected, thresholdFunction, seeds );
+      IteratorFill( it, true );
+      if ( !SameImages( BreadthFirstFill( input, seeds, lower, upper ), expected, "FloodFilledIterator", 1 ) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+
+    for ( itk::ThreadIdType threads = 1; threads <= 4; threads += 3 )
+      {
+      ConnectedThresholdType::Pointer filter = ConnectedThresholdType::New();
+      filter->SetInput( input );
+      for ( unsigned int i = 0; i < seeds.size(); ++i )
+        {
+        filter->AddSeed( seeds[i] );
+        }
+      filter->SetLower( lower );
+      filter->SetUpper( upper );
+      filter->SetReplaceValue( ReplaceValue );
+      filter->SetConnectivity( full ? ConnectedThresholdType::FullConnectivity
+                                    : ConnectedThresholdType::FaceConnectivity );
+      filter->SetNumberOfThreads( threads );
+      TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+      if ( !SameImages( expected, filter->GetOutput(),
+                        full ? "ConnectedThreshold, full connectivity" : "ConnectedThreshold", threads ) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // The threader counts each filled pixel once, even when several threads
+  // reach it, and bounds the filled pixels with its filled region
+  typedef itk::FloodFilledImageFunctionConditionalThreader< OutputImageType, ThresholdFunctionType > ThreaderType;
+  SeedContainerType narrowSeeds;
+  seed[0] = 35; seed[1] = 32; seed[2] = 28;
+  while ( seed[0] < 70 && ( input->GetPixel( seed ) < 60 || input->GetPixel( seed ) > upper ) )
+    {
+    ++seed[0];
+    }
+  narrowSeeds.push_back( seed );
+  for ( unsigned int test = 0; test < 4; ++test )
+    {
+    const itk::ThreadIdType threads = ( test % 2 ) ? 4 : 1;
+    if ( test >= 2 )
+      {
+      // a narrower band from a single seed, which fills a smaller region
+      thresholdFunction->ThresholdBetween( 60, upper );
+      }
+    OutputImageType::Pointer output = NewOutput( input );
+    ConnectedThresholdType::Pointer owner = ConnectedThresholdType::New();
+    owner->SetNumberOfThreads( threads );
+    ThreaderType::Pointer threader = ThreaderType::New();
+    threader->FullyConnectedOn();
+    threader->Fill( owner, output, thresholdFunction, ( test >= 2 ) ? narrowSeeds : seeds, ReplaceValue );
+
+    itk::SizeValueType filled = 0;
+    OutputImageType::IndexType minimum = output->GetLargestPossibleRegion().GetUpperIndex();
+    OutputImageType::IndexType maximum = output->GetLargestPossibleRegion().GetIndex();
+    for ( itk::ImageRegionConstIteratorWithIndex< OutputImageType > oit( output, output->GetLargestPossibleRegion() );
+          !oit.IsAtEnd(); ++oit )
+      {
+      if ( oit.Get() == ReplaceValue )
+        {
+        ++filled;
+        for ( unsigned int d = 0; d < 3; ++d )
+          {
+          minimum[d] = std::min( minimum[d], oit.GetIndex()[d] );
+          maximum[d] = std::max( maximum[d], oit.GetIndex()[d] );
+          }
+        }
+      }
+    OutputImageType::RegionType filledRegion;
+    filledRegion.SetIndex( minimum );
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      filledRegion.SetSize( d, maximum[d] - minimum[d] + 1 );
+      }
+    if ( threader->GetNumberOfFilledPixels() != filled || threader->GetFilledRegion() != filledRegion )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Threader with " << threads << " threads: " << threader->GetNumberOfFilledPixels()
+                << " pixels in " << threader->GetFilledRegion() << " instead of " << filled
+                << " pixels in " << filledRegion << std::endl;
+      return EXIT_FAILURE;
+      }
+    std::cout << "Threader with " << threads << " threads: " << filled << " pixels in a region of size "
+              << filledRegion.GetSize() << "." << std::endl;
+    }
+  thresholdFunction->ThresholdBetween( lower, upper );
+
+  // NeighborhoodConnectedImageFilter, with a seed outside the thresholds
+  typedef itk::NeighborhoodBinaryThresholdImageFunction< InputImageType > NeighborhoodFunctionType;
+  NeighborhoodFunctionType::Pointer neighborhoodFunction = NeighborhoodFunctionType::New();
+  NeighborhoodFunctionType::InputSizeType radius;
+  radius.Fill( 1 );
+  neighborhoodFunction->SetInputImage( input );
+  neighborhoodFunction->ThresholdBetween( lower, upper );
+  neighborhoodFunction->SetRadius( radius );
+
+  SeedContainerType neighborhoodSeeds = seeds;
+  seed[0] = 3; seed[1] = 40; seed[2] = 40;
+  while ( neighborhoodFunction->EvaluateAtIndex( seed ) )
+    {
+    ++seed[0];
+    }
+  neighborhoodSeeds.push_back( seed );
+
+  OutputImageType::Pointer expected = NewOutput( input );
+  typedef itk::FloodFilledImageFunctionConditionalIterator< OutputImageType, NeighborhoodFunctionType > IteratorType;
+  IteratorType it( expected, neighborhoodFunction, neighborhoodSeeds );
+  IteratorFill( it, false );
+
+  typedef itk::NeighborhoodConnectedImageFilter< InputImageType, OutputImageType > NeighborhoodConnectedType;
+  for ( itk::ThreadIdType threads = 1; threads <= 4; threads += 3 )
+    {
+    NeighborhoodConnectedType::Pointer filter = NeighborhoodConnectedType::New();
+    filter->SetInput( input );
+    for ( unsigned int i = 0; i < neighborhoodSeeds.size(); ++i )
+      {
+      filter->AddSeed( neighborhoodSeeds[i] );
+      }
+    filter->SetLower( lower );
+    filter->SetUpper( upper );
+    filter->SetRadius( radius );
+    filter->SetReplaceValue( ReplaceValue );
+    filter->SetNumberOfThreads( threads );
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    if ( !SameImages( expected, filter->GetOutput(), "NeighborhoodConnected", threads ) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // ConfidenceConnectedImageFilter fills the pixels connected to the
+  // seeds within its last interval, which contains the values of the
+  // filled pixels, and does not depend on the number of threads
+  typedef itk::ConfidenceConnectedImageFilter< InputImageType, OutputImageType > ConfidenceConnectedType;
+  OutputImageType::Pointer confidenceExpected;
+  for ( itk::ThreadIdType threads = 1; threads <= 4; threads += 3 )
+    {
+    ConfidenceConnectedType::Pointer filter = ConfidenceConnectedType::New();
+    filter->SetInput( input );
+    for ( unsigned int i = 0; i < seeds.size(); ++i )
+      {
+      filter->AddSeed( seeds[i] );
+      }
+    filter->SetInitialNeighborhoodRadius( 2 );
+    filter->SetMultiplier( 2.0 );
+    filter->SetNumberOfIterations( 3 );
+    filter->SetReplaceValue( ReplaceValue );
+    filter->SetNumberOfThreads( threads );
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    if ( confidenceExpected.IsNull() )
+      {
+      short minimum = itk::NumericTraits< short >::max();
+      short maximum = itk::NumericTraits< short >::NonpositiveMin();
+      itk::ImageRegionConstIterator< InputImageType >  iit( input, input->GetLargestPossibleRegion() );
+      itk::ImageRegionConstIterator< OutputImageType > oit( filter->GetOutput(), input->GetLargestPossibleRegion() );
+      for ( ; !iit.IsAtEnd(); ++iit, ++oit )
+        {
+        if ( oit.Get() == ReplaceValue )
+          {
+          minimum = std::min( minimum, iit.Get() );
+          maximum = std::max( maximum, iit.Get() );
+          }
+        }
+      confidenceExpected = BreadthFirstFill( input, seeds, minimum, maximum );
+      }
+    if ( !SameImages( confidenceExpected, filter->GetOutput(), "ConfidenceConnected", threads ) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}